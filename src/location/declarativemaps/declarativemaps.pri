@@ -23,6 +23,9 @@ PRIVATE_HEADERS += \
            declarativemaps/qdeclarativeroutemapitem_p.h \
            declarativemaps/qdeclarativegeomapparameter_p.h \
            declarativemaps/qgeomapitemgeometry_p.h \
+           declarativemaps/qgeomapitemgeometrybuilder_p.h \
+           declarativemaps/qgeomapitembatch_p.h \
+           declarativemaps/qgeomapquickitemanimator_p.h \
            declarativemaps/qdeclarativegeomapcopyrightsnotice_p.h \
            declarativemaps/locationvaluetypehelper_p.h \
            declarativemaps/qquickgeomapgesturearea_p.h \
@@ -49,6 +52,9 @@ SOURCES += \
            declarativemaps/qdeclarativeroutemapitem.cpp \
            declarativemaps/qdeclarativegeomapparameter.cpp \
            declarativemaps/qgeomapitemgeometry.cpp \
+           declarativemaps/qgeomapitemgeometrybuilder.cpp \
+           declarativemaps/qgeomapitembatch.cpp \
+           declarativemaps/qgeomapquickitemanimator.cpp \
            declarativemaps/qdeclarativegeomapcopyrightsnotice.cpp \
            declarativemaps/error_messages.cpp \
            declarativemaps/locationvaluetypehelper.cpp \
@@ -115,3 +115,68 @@ QGeoCircle parseCircle(const QJSValue &value, bool *ok)
 
     return c;
 }
+
+/*
+    Paths can be exchanged with QML as a packed buffer of latitude, longitude pairs of
+    64-bit floats, either an ArrayBuffer or a Float64Array, which avoids creating a
+    JavaScript object per coordinate.
+*/
+bool isPackedCoordinates(const QJSValue &value)
+{
+    // Both ArrayBuffer and the typed arrays have a byteLength, plain arrays and objects don't
+    return value.isObject() && !value.isArray() && value.hasProperty(QStringLiteral("byteLength"));
+}
+
+QList<QGeoCoordinate> parsePackedCoordinates(const QJSValue &value, bool *ok)
+{
+    QList<QGeoCoordinate> path;
+    *ok = false;
+
+    if (!isPackedCoordinates(value))
+        return path;
+
+    QByteArray data;
+    if (value.hasProperty(QStringLiteral("BYTES_PER_ELEMENT"))) {
+        // a typed array view: only Float64Array is supported
+        if (value.property(QStringLiteral("BYTES_PER_ELEMENT")).toInt() != int(sizeof(double)))
+            return path;
+        const QByteArray buffer = value.property(QStringLiteral("buffer")).toVariant().toByteArray();
+        const int offset = value.property(QStringLiteral("byteOffset")).toInt();
+        const int length = value.property(QStringLiteral("byteLength")).toInt();
+        if (offset < 0 || length < 0 || offset + length > buffer.size())
+            return path;
+        data = buffer.mid(offset, length);
+    } else {
+        data = value.toVariant().toByteArray();
+    }
+
+    if (data.size() % (2 * sizeof(double)))
+        return path;
+
+    const int count = data.size() / int(2 * sizeof(double));
+    path.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        double latLon[2];
+        memcpy(latLon, data.constData() + i * sizeof(latLon), sizeof(latLon));
+        const QGeoCoordinate c(latLon[0], latLon[1]);
+        if (!c.isValid()) {
+            path.clear();
+            return path;
+        }
+        path.append(c);
+    }
+
+    *ok = true;
+    return path;
+}
+
+QByteArray packCoordinates(const QList<QGeoCoordinate> &path)
+{
+    QByteArray data(path.size() * int(2 * sizeof(double)), Qt::Uninitialized);
+    double *latLon = reinterpret_cast<double *>(data.data());
+    for (const QGeoCoordinate &c : path) {
+        *latLon++ = c.latitude();
+        *latLon++ = c.longitude();
+    }
+    return data;
+}
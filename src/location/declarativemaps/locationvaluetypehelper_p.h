@@ -48,6 +48,7 @@
 // We mean it.
 //
 
+#include <QByteArray>
 #include <QJSValue>
 #include <QGeoCoordinate>
 #include <QGeoRectangle>
@@ -57,4 +58,8 @@ QGeoCoordinate parseCoordinate(const QJSValue &value, bool *ok);
 QGeoRectangle parseRectangle(const QJSValue &value, bool *ok);
 QGeoCircle parseCircle(const QJSValue &value, bool *ok);
 
+bool isPackedCoordinates(const QJSValue &value);
+QList<QGeoCoordinate> parsePackedCoordinates(const QJSValue &value, bool *ok);
+QByteArray packCoordinates(const QList<QGeoCoordinate> &path);
+
 #endif
@@ -39,11 +39,16 @@
 
 #include "qwebmercator_p.h"
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeoclipregion_p.h>
 
 #include <qmath.h>
 #include <algorithm>
 
 #include <QtCore/QScopedValueRollback>
+#include <QtGui/QVector4D>
+#include <QtQuick/QQuickWindow>
+#include <QtQuick/QSGRendererInterface>
 #include <QPen>
 #include <QPainter>
 #include <QtGui/private/qtriangulator_p.h>
@@ -129,23 +134,125 @@ QT_BEGIN_NAMESPACE
 */
 
 static const int CircleSamples = 128;
+static const int MinimumCircleSamples = 16;
 
 struct Vertex
 {
     QVector2D position;
 };
 
+namespace {
+
+struct SinCos
+{
+    double sin;
+    double cos;
+};
+
+/* The sines and cosines of the sample azimuths, for every power of two
+   sample count from MinimumCircleSamples to CircleSamples */
+class CircleSampleTables
+{
+public:
+    CircleSampleTables()
+    {
+        for (int steps = MinimumCircleSamples; steps <= CircleSamples; steps *= 2) {
+            QVector<SinCos> table(steps);
+            for (int i = 0; i < steps; ++i) {
+                const double azimuthRad = 2 * M_PI * i / steps;
+                table[i].sin = std::sin(azimuthRad);
+                table[i].cos = std::cos(azimuthRad);
+            }
+            tables_.append(table);
+        }
+    }
+
+    const SinCos *table(int steps) const
+    {
+        for (const QVector<SinCos> &table : tables_) {
+            if (table.size() == steps)
+                return table.constData();
+        }
+        return 0;
+    }
+
+private:
+    QVector<QVector<SinCos> > tables_;
+};
+
+}
+
+Q_GLOBAL_STATIC(CircleSampleTables, circleSampleTables)
+
+/*
+ * Whether a circle is small, and far enough from the poles and the date line,
+ * to be laid out directly in map projection. Web Mercator is conformal, so
+ * such a circle projects to a circle, off by about ratio * tan(latitude)
+ * relative to its radius.
+ */
+static bool isSmallCircle(const QGeoCoordinate &center, qreal distance)
+{
+    const double ratio = distance / QLocationUtils::earthMeanRadius();
+    const double latRad = QLocationUtils::radians(center.latitude());
+    if (!(ratio <= 0.01 && ratio * std::tan(qAbs(latRad)) <= 1e-3))
+        return false;
+    const double lonSpan = QLocationUtils::degrees(ratio / std::cos(latRad));
+    return qAbs(center.longitude()) + lonSpan < 180.0;
+}
+
+/*
+ * Lays out the samples of a small circle in map projection, around the
+ * projections of its northernmost and southernmost points. Only the sample
+ * counts in circleSampleTables() are supported.
+ */
+static void calculateProjectedPeripheralPoints(QVector<QDoubleVector2D> &path,
+                                               const QGeoProjection &projection,
+                                               const QGeoCoordinate &center,
+                                               qreal distance,
+                                               int steps,
+                                               QDoubleVector2D &projectedCenter,
+                                               double &projectedRadius)
+{
+    const QDoubleVector2D north = projection.geoToMapProjection(center.atDistanceAndAzimuth(distance, 0));
+    const QDoubleVector2D south = projection.geoToMapProjection(center.atDistanceAndAzimuth(distance, 180));
+    projectedCenter = QDoubleVector2D(projection.geoToMapProjection(center).x(), (north.y() + south.y()) / 2);
+    projectedRadius = qAbs(south.y() - north.y()) / 2;
+
+    const SinCos *table = circleSampleTables()->table(steps);
+    Q_ASSERT(table);
+    path.reserve(steps);
+    path.resize(0);
+    // Azimuths run clockwise from the north, y grows southwards
+    for (int i = 0; i < steps; ++i)
+        path << QDoubleVector2D(projectedCenter.x() + projectedRadius * table[i].sin,
+                                projectedCenter.y() - projectedRadius * table[i].cos);
+}
+
 QGeoMapCircleGeometry::QGeoMapCircleGeometry()
+:   ellipse_(false)
+{
+}
+
+/*!
+    \internal
+
+    Triangulates the circle like a polygon.
+*/
+void QGeoMapCircleGeometry::updatePolygonPoints(const QGeoMap &map, const QVector<QDoubleVector2D> &circlePath)
 {
+    ellipse_ = false;
+    updateSourcePoints(map, circlePath);
+    updateScreenPoints(map);
 }
 
 /*!
     \internal
 */
-void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D> &circlePath, const QGeoMap &map)
+void QGeoMapCircleGeometry::updateScreenPointsInvert(const QVector<QDoubleVector2D> &circlePath, const QGeoMap &map)
 {
     // Not checking for !screenDirty anymore, as everything is now recalculated.
     clear();
+    ellipse_ = false;
     if (map.viewportWidth() == 0 || map.viewportHeight() == 0 || circlePath.size() < 3) // a circle requires at least 3 points;
         return;
 
@@ -171,33 +278,34 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
     QDoubleVector2D br = map.geoProjection().geoToWrappedMapProjection(QGeoCoordinate(bottomLati,rightLongi));
     QDoubleVector2D bl = map.geoProjection().geoToWrappedMapProjection(QGeoCoordinate(bottomLati,leftLongi));
 
-    QList<QDoubleVector2D> fill;
+    QVector<QDoubleVector2D> fill;
     fill << tl << tr << br << bl;
 
-    QList<QDoubleVector2D> hole;
+    QVector<QDoubleVector2D> hole;
+    hole.reserve(circlePath.size());
     for (const QDoubleVector2D &c: circlePath)
         hole << map.geoProjection().wrapMapProjection(c);
 
     c2t::clip2tri clipper;
-    clipper.addSubjectPath(QClipperUtils::qListToPath(fill), true);
-    clipper.addClipPolygon(QClipperUtils::qListToPath(hole));
+    clipper.addSubjectPath(QClipperUtils::qVectorToPath(fill), true);
+    clipper.addClipPolygon(QClipperUtils::qVectorToPath(hole));
     Paths difference = clipper.execute(c2t::clip2tri::Difference, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
 
     // 2)
     QDoubleVector2D lb = map.geoProjection().geoToWrappedMapProjection(srcOrigin_);
-    QList<QList<QDoubleVector2D> > clippedPaths;
-    const QList<QDoubleVector2D> &visibleRegion = map.geoProjection().visibleRegion();
+    QVector<QVector<QDoubleVector2D> > clippedPaths;
+    const QVector<QDoubleVector2D> &visibleRegion = map.geoProjection().visibleRegion();
     if (visibleRegion.size()) {
         clipper.clearClipper();
         for (const Path &p: difference)
             clipper.addSubjectPath(p, true);
-        clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
+        clipper.addClipPolygon(QClipperUtils::qVectorToPath(visibleRegion));
         Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
-        clippedPaths = QClipperUtils::pathsToQList(res);
+        clippedPaths = QClipperUtils::pathsToQVector(res);
 
         // 2.1) update srcOrigin_ with the point with minimum X/Y
         lb = QDoubleVector2D(qInf(), qInf());
-        for (const QList<QDoubleVector2D> &path: clippedPaths) {
+        for (const QVector<QDoubleVector2D> &path: clippedPaths) {
             for (const QDoubleVector2D &p: path) {
                 if (p.x() < lb.x() || (p.x() == lb.x() && p.y() < lb.y())) {
                     lb = p;
@@ -212,17 +320,18 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
         lb.setX(qMax(tl.x(), lb.x()));
         srcOrigin_ = map.geoProjection().mapProjectionToGeo(map.geoProjection().unwrapMapProjection(lb));
     } else {
-        clippedPaths = QClipperUtils::pathsToQList(difference);
+        clippedPaths = QClipperUtils::pathsToQVector(difference);
     }
 
     //3)
     QDoubleVector2D origin = map.geoProjection().wrappedMapProjectionToItemPosition(lb);
 
     QPainterPath ppi;
-    for (const QList<QDoubleVector2D> &path: clippedPaths) {
+    for (const QVector<QDoubleVector2D> &path: clippedPaths) {
+        const QVector<QDoubleVector2D> &positions = itemPositions(map, path);
         QDoubleVector2D lastAddedPoint;
         for (int i = 0; i < path.size(); ++i) {
-            QDoubleVector2D point = map.geoProjection().wrappedMapProjectionToItemPosition(path.at(i));
+            const QDoubleVector2D &point = positions.at(i);
             //point = point - origin; // Do this using ppi.translate()
 
             if (i == 0) {
@@ -262,6 +371,50 @@ void QGeoMapCircleGeometry::updateScreenPointsInvert(const QList<QDoubleVector2D
     sourceBounds_ = screenBounds_;
 }
 
+/*!
+    \internal
+
+    Sets up the bounding square of a circle, given by its \a center and
+    \a radius in map projection, for MapEllipseNode to draw. Only valid while
+    the map is not tilted: the projection to the screen then only scales and
+    rotates, so the circle stays a circle and needs neither clipping nor
+    triangulation.
+*/
+void QGeoMapCircleGeometry::updateScreenPointsEllipse(const QGeoMap &map, const QDoubleVector2D &center, double radius)
+{
+    clear();
+    ellipse_ = true;
+    if (map.viewportWidth() == 0 || map.viewportHeight() == 0)
+        return;
+
+    const QGeoProjection &projection = map.geoProjection();
+    const QDoubleVector2D wrappedCenter = projection.wrapMapProjection(center);
+    const QDoubleVector2D wrappedLeftBound = wrappedCenter - QDoubleVector2D(radius, 0);
+    const QDoubleVector2D wrappedBottomRight = wrappedCenter + QDoubleVector2D(radius, radius);
+    if (projection.projectableClipRegion().classify(QDoubleVector2D(wrappedLeftBound.x(), wrappedCenter.y() - radius),
+                                                    wrappedBottomRight) == QGeoClipRegion::Outside)
+        return;
+
+    srcOrigin_ = projection.mapProjectionToGeo(projection.unwrapMapProjection(wrappedLeftBound));
+
+    const QDoubleVector2D origin = projection.wrappedMapProjectionToItemPosition(wrappedLeftBound);
+    const QDoubleVector2D screenCenter = projection.wrappedMapProjectionToItemPosition(wrappedCenter) - origin;
+    const double screenRadius = screenCenter.length();
+    if (!qIsFinite(screenRadius) || screenRadius <= 0.0)
+        return;
+
+    sourceBounds_ = QRectF(screenCenter.x() - screenRadius, screenCenter.y() - screenRadius,
+                           2 * screenRadius, 2 * screenRadius);
+    firstPointOffset_ = -1 * sourceBounds_.topLeft();
+    screenBounds_ = QRectF(0, 0, 2 * screenRadius, 2 * screenRadius);
+    screenOutline_ = QPainterPath();
+    screenOutline_.addEllipse(screenBounds_);
+
+    screenVertices_ << screenBounds_.topLeft() << screenBounds_.topRight()
+                    << screenBounds_.bottomLeft() << screenBounds_.bottomRight();
+    screenIndices_ << 0 << 1 << 2 << 2 << 1 << 3;
+}
+
 bool QDeclarativeCircleMapItem::crossEarthPole(const QGeoCoordinate &center, qreal distance)
 {
     qreal poleLat = 90;
@@ -275,7 +428,7 @@ bool QDeclarativeCircleMapItem::crossEarthPole(const QGeoCoordinate &center, qre
     return false;
 }
 
-void QDeclarativeCircleMapItem::calculatePeripheralPoints(QList<QGeoCoordinate> &path,
+void QDeclarativeCircleMapItem::calculatePeripheralPoints(QVector<QGeoCoordinate> &path,
                                       const QGeoCoordinate &center,
                                       qreal distance,
                                       int steps,
@@ -287,6 +440,8 @@ void QDeclarativeCircleMapItem::calculatePeripheralPoints(QList<QGeoCoordinate>
 
     // pre-calculations
     steps = qMax(steps, 3);
+    const SinCos *table = circleSampleTables()->table(steps);
+    path.reserve(path.size() + steps);
     qreal centerLon = center.longitude();
     qreal minLon = centerLon;
     qreal latRad = QLocationUtils::radians(center.latitude());
@@ -301,9 +456,11 @@ void QDeclarativeCircleMapItem::calculatePeripheralPoints(QList<QGeoCoordinate>
     int idx = 0;
     for (int i = 0; i < steps; ++i) {
         qreal azimuthRad = 2 * M_PI * i / steps;
+        const qreal sinAzimuth = table ? table[i].sin : std::sin(azimuthRad);
+        const qreal cosAzimuth = table ? table[i].cos : std::cos(azimuthRad);
         qreal resultLatRad = std::asin(sinLatRad_x_cosRatio
-                                   + cosLatRad_x_sinRatio * std::cos(azimuthRad));
-        qreal resultLonRad = lonRad + std::atan2(std::sin(azimuthRad) * cosLatRad_x_sinRatio,
+                                   + cosLatRad_x_sinRatio * cosAzimuth);
+        qreal resultLonRad = lonRad + std::atan2(sinAzimuth * cosLatRad_x_sinRatio,
                                        cosRatio - sinLatRad * std::sin(resultLatRad));
         qreal lat2 = QLocationUtils::degrees(resultLatRad);
         qreal lon2 = QLocationUtils::wrapLong(QLocationUtils::degrees(resultLonRad));
@@ -323,8 +480,8 @@ void QDeclarativeCircleMapItem::calculatePeripheralPoints(QList<QGeoCoordinate>
 }
 
 QDeclarativeCircleMapItem::QDeclarativeCircleMapItem(QQuickItem *parent)
-:   QDeclarativeGeoMapItemBase(parent), border_(this), color_(Qt::transparent), dirtyMaterial_(true),
-    updatingGeometry_(false)
+:   QDeclarativeGeoMapItemBase(parent), border_(this), color_(Qt::transparent), projectedCircle_(false),
+    projectedRadius_(0.0), ellipseNode_(false), dirtyMaterial_(true), updatingGeometry_(false)
 {
     setFlag(ItemHasContents, true);
     QObject::connect(&border_, SIGNAL(colorChanged(QColor)),
@@ -461,21 +618,55 @@ QSGNode *QDeclarativeCircleMapItem::updateMapItemPaintNode(QSGNode *oldNode, Upd
 {
     Q_UNUSED(data);
 
-    MapPolygonNode *node = static_cast<MapPolygonNode *>(oldNode);
-
-    if (!node)
-        node = new MapPolygonNode();
+    if (oldNode && ellipseNode_ != geometry_.isEllipse()) {
+        delete oldNode;
+        oldNode = 0;
+    }
+    ellipseNode_ = geometry_.isEllipse();
+
+    const bool dirty = geometry_.isScreenDirty() || borderGeometry_.isScreenDirty() || dirtyMaterial_ || !oldNode;
+    QSGNode *result = oldNode;
+    if (ellipseNode_) {
+        MapEllipseNode *node = static_cast<MapEllipseNode *>(oldNode);
+        if (!node)
+            node = new MapEllipseNode();
+        if (dirty)
+            node->update(color_, border_.color(), &geometry_, &borderGeometry_);
+        result = node;
+    } else {
+        MapPolygonNode *node = static_cast<MapPolygonNode *>(oldNode);
+        if (!node)
+            node = new MapPolygonNode();
+        if (dirty)
+            node->update(color_, border_.color(), &geometry_, &borderGeometry_);
+        result = node;
+    }
 
-    //TODO: update only material
-    if (geometry_.isScreenDirty() || borderGeometry_.isScreenDirty() || dirtyMaterial_) {
-        node->update(color_, border_.color(), &geometry_, &borderGeometry_);
+    if (dirty) {
         geometry_.setPreserveGeometry(false);
         borderGeometry_.setPreserveGeometry(false);
         geometry_.markClean();
         borderGeometry_.markClean();
         dirtyMaterial_ = false;
     }
-    return node;
+    return result;
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeCircleMapItem::updateMapItemBatch(QGeoMapItemBatch *batch)
+{
+    // An ellipse is only a bounding square without MapEllipseNode. Batched circles are
+    // triangulated, see canDrawEllipse(), this only covers the frame switching over.
+    if (geometry_.isEllipse()) {
+        geometry_.setPreserveGeometry(false);
+        geometry_.markClean();
+    } else {
+        addToMapItemBatch(batch, geometry_, color_, QSGGeometry::DrawTriangles);
+    }
+    addToMapItemBatch(batch, borderGeometry_, border_.color(), QSGGeometry::DrawTriangleStrip);
+    dirtyMaterial_ = false;
 }
 
 /*!
@@ -489,7 +680,15 @@ void QDeclarativeCircleMapItem::updatePolish()
     QScopedValueRollback<bool> rollback(updatingGeometry_);
     updatingGeometry_ = true;
 
-    QList<QDoubleVector2D> circlePath = circlePath_;
+    // The sample count follows the zoom level
+    if (circlePath_.size() != circleSamples())
+        updateCirclePath();
+
+    const bool ellipse = canDrawEllipse();
+    if (ellipse != geometry_.isEllipse())
+        geometry_.markSourceDirty();
+
+    QVector<QDoubleVector2D> circlePath = circlePath_;
 
     int pathCount = circlePath.size();
     bool preserve = preserveCircleGeometry(circlePath, circle_.center(), circle_.radius());
@@ -499,12 +698,13 @@ void QDeclarativeCircleMapItem::updatePolish()
     geometry_.setPreserveGeometry(preserve, leftBound_);
 
     bool invertedCircle = false;
-    if (crossEarthPole(circle_.center(), circle_.radius()) && circlePath.size() == pathCount) {
+    if (ellipse) {
+        geometry_.updateScreenPointsEllipse(*map(), projectedCenter_, projectedRadius_);
+    } else if (crossEarthPole(circle_.center(), circle_.radius()) && circlePath.size() == pathCount) {
         geometry_.updateScreenPointsInvert(circlePath, *map()); // invert fill area for really huge circles
         invertedCircle = true;
     } else {
-        geometry_.updateSourcePoints(*map(), circlePath);
-        geometry_.updateScreenPoints(*map());
+        geometry_.updatePolygonPoints(*map(), circlePath);
     }
 
     borderGeometry_.clear();
@@ -512,14 +712,11 @@ void QDeclarativeCircleMapItem::updatePolish()
     geoms << &geometry_;
 
     if (border_.color() != Qt::transparent && border_.width() > 0) {
-        QList<QDoubleVector2D> closedPath = circlePath;
+        QVector<QWorldPoint> closedPath;
+        QWorldPoint::fromMercator(invertedCircle ? circlePath_ : circlePath, &closedPath);
         closedPath << closedPath.first();
-
-        if (invertedCircle) {
-            closedPath = circlePath_;
-            closedPath << closedPath.first();
+        if (invertedCircle)
             std::reverse(closedPath.begin(), closedPath.end());
-        }
 
         borderGeometry_.setPreserveGeometry(true, leftBound_);
         borderGeometry_.setPreserveGeometry(preserve, leftBound_);
@@ -531,7 +728,7 @@ void QDeclarativeCircleMapItem::updatePolish()
         borderGeometry_.srcPointTypes_.clear();
 
         QDoubleVector2D borderLeftBoundWrapped;
-        QList<QList<QDoubleVector2D > > clippedPaths = borderGeometry_.clipPath(*map(), closedPath, borderLeftBoundWrapped);
+        const QVector<QVector<QWorldPoint> > &clippedPaths = borderGeometry_.clipPath(*map(), closedPath, borderLeftBoundWrapped);
         if (clippedPaths.size()) {
             borderLeftBoundWrapped = map()->geoProjection().geoToWrappedMapProjection(geometryOrigin);
             borderGeometry_.pathToScreen(*map(), clippedPaths, borderLeftBoundWrapped);
@@ -562,16 +759,55 @@ void QDeclarativeCircleMapItem::afterViewportChanged(const QGeoMapViewportChange
 
 /*!
     \internal
+
+    Returns the number of samples that keep the chords of the circle within a
+    quarter of a pixel of it at the current zoom level.
+*/
+int QDeclarativeCircleMapItem::circleSamples()
+{
+    const double latRad = QLocationUtils::radians(circle_.center().latitude());
+    const double radiusPixels = circle_.radius() * map()->geoProjection().mapWidth()
+            / (2 * M_PI * QLocationUtils::earthMeanRadius() * qMax(std::cos(latRad), 1e-6));
+    // n chords stray r * (1 - cos(pi / n)) from the circle
+    int samples = MinimumCircleSamples;
+    while (samples < CircleSamples && radiusPixels * (1 - std::cos(M_PI / samples)) > 0.25)
+        samples *= 2;
+    return samples;
+}
+
+/*!
+    \internal
+
+    Whether the fill can be drawn by MapEllipseNode instead of being
+    triangulated.
 */
+bool QDeclarativeCircleMapItem::canDrawEllipse()
+{
+    return projectedCircle_ && map()->cameraData().tilt() == 0.0
+            && !quickMap()->batchMapItems()
+            && window() && window()->rendererInterface()->graphicsApi() == QSGRendererInterface::OpenGL;
+}
+
 void QDeclarativeCircleMapItem::updateCirclePath()
 {
     if (!map())
         return;
-    QList<QGeoCoordinate> path;
-    calculatePeripheralPoints(path, circle_.center(), circle_.radius(), CircleSamples, leftBound_);
-    circlePath_.clear();
-    for (const QGeoCoordinate &c : path)
-        circlePath_ << map()->geoProjection().geoToMapProjection(c);
+
+    const int samples = circleSamples();
+    projectedCircle_ = isSmallCircle(circle_.center(), circle_.radius());
+    if (projectedCircle_) {
+        const QGeoProjection &projection = map()->geoProjection();
+        calculateProjectedPeripheralPoints(circlePath_, projection, circle_.center(), circle_.radius(),
+                                           samples, projectedCenter_, projectedRadius_);
+        leftBound_ = projection.mapProjectionToGeo(QDoubleVector2D(projectedCenter_.x() - projectedRadius_,
+                                                                   projectedCenter_.y()));
+        return;
+    }
+
+    QVector<QGeoCoordinate> path;
+    calculatePeripheralPoints(path, circle_.center(), circle_.radius(), samples, leftBound_);
+    circlePath_.resize(path.size());
+    map()->geoProjection().geoToMapProjection(path.constData(), circlePath_.data(), path.size());
 }
 
 /*!
@@ -611,7 +847,7 @@ void QDeclarativeCircleMapItem::geometryChanged(const QRectF &newGeometry, const
     // call to this function.
 }
 
-bool QDeclarativeCircleMapItem::preserveCircleGeometry (QList<QDoubleVector2D> &path,
+bool QDeclarativeCircleMapItem::preserveCircleGeometry (QVector<QDoubleVector2D> &path,
                                     const QGeoCoordinate &center, qreal distance)
 {
     // if circle crosses north/south pole, then don't preserve circular shape,
@@ -640,7 +876,7 @@ bool QDeclarativeCircleMapItem::preserveCircleGeometry (QList<QDoubleVector2D> &
  *  |    ____    |
  *   \__/    \__/
  */
-void QDeclarativeCircleMapItem::updateCirclePathForRendering(QList<QDoubleVector2D> &path,
+void QDeclarativeCircleMapItem::updateCirclePathForRendering(QVector<QDoubleVector2D> &path,
                                                              const QGeoCoordinate &center,
                                                              qreal distance)
 {
@@ -701,4 +937,170 @@ void QDeclarativeCircleMapItem::updateCirclePathForRendering(QList<QDoubleVector
 
 //////////////////////////////////////////////////////////////////////
 
+class MapEllipseShader : public QSGMaterialShader
+{
+public:
+    MapEllipseShader()
+    :   matrixId_(-1), opacityId_(-1), colorId_(-1), pixelSizeId_(-1)
+    {
+    }
+
+    const char *vertexShader() const Q_DECL_OVERRIDE
+    {
+        return "attribute highp vec4 vertex;\n"
+               "attribute highp vec2 coord;\n"
+               "uniform highp mat4 matrix;\n"
+               "varying highp vec2 ellipseCoord;\n"
+               "void main() {\n"
+               "    ellipseCoord = coord;\n"
+               "    gl_Position = matrix * vertex;\n"
+               "}";
+    }
+
+    const char *fragmentShader() const Q_DECL_OVERRIDE
+    {
+        // Covering the edge over one pixel smooths it like multisampling would
+        return "uniform lowp vec4 color;\n"
+               "uniform lowp float opacity;\n"
+               "uniform highp float pixelSize;\n"
+               "varying highp vec2 ellipseCoord;\n"
+               "void main() {\n"
+               "    lowp float coverage = clamp((1.0 - length(ellipseCoord)) / pixelSize + 0.5, 0.0, 1.0);\n"
+               "    gl_FragColor = color * (opacity * coverage);\n"
+               "}";
+    }
+
+    char const *const *attributeNames() const Q_DECL_OVERRIDE
+    {
+        static char const *const names[] = { "vertex", "coord", 0 };
+        return names;
+    }
+
+    void updateState(const RenderState &state, QSGMaterial *newMaterial, QSGMaterial *oldMaterial) Q_DECL_OVERRIDE
+    {
+        Q_UNUSED(oldMaterial);
+        if (state.isMatrixDirty())
+            program()->setUniformValue(matrixId_, state.combinedMatrix());
+        if (state.isOpacityDirty())
+            program()->setUniformValue(opacityId_, state.opacity());
+
+        const MapEllipseMaterial *material = static_cast<MapEllipseMaterial *>(newMaterial);
+        const QColor &c = material->color;
+        program()->setUniformValue(colorId_, QVector4D(c.redF() * c.alphaF(), c.greenF() * c.alphaF(),
+                                                       c.blueF() * c.alphaF(), c.alphaF()));
+        program()->setUniformValue(pixelSizeId_, material->radius > 0.0f ? 1.0f / material->radius : 1.0f);
+    }
+
+protected:
+    void initialize() Q_DECL_OVERRIDE
+    {
+        matrixId_ = program()->uniformLocation("matrix");
+        opacityId_ = program()->uniformLocation("opacity");
+        colorId_ = program()->uniformLocation("color");
+        pixelSizeId_ = program()->uniformLocation("pixelSize");
+    }
+
+private:
+    int matrixId_;
+    int opacityId_;
+    int colorId_;
+    int pixelSizeId_;
+};
+
+MapEllipseMaterial::MapEllipseMaterial()
+:   radius(0.0f)
+{
+    setFlag(Blending);
+}
+
+QSGMaterialType *MapEllipseMaterial::type() const
+{
+    static QSGMaterialType type;
+    return &type;
+}
+
+QSGMaterialShader *MapEllipseMaterial::createShader() const
+{
+    return new MapEllipseShader;
+}
+
+int MapEllipseMaterial::compare(const QSGMaterial *other) const
+{
+    const MapEllipseMaterial *o = static_cast<const MapEllipseMaterial *>(other);
+    if (color.rgba() != o->color.rgba())
+        return color.rgba() < o->color.rgba() ? -1 : 1;
+    if (radius != o->radius)
+        return radius < o->radius ? -1 : 1;
+    return 0;
+}
+
+/*!
+    \internal
+*/
+MapEllipseNode::MapEllipseNode()
+:   border_(new MapPolylineNode()),
+    geometry_(QSGGeometry::defaultAttributes_TexturedPoint2D(), 0),
+    blocked_(true)
+{
+    geometry_.setDrawingMode(QSGGeometry::DrawTriangleStrip);
+    QSGGeometryNode::setMaterial(&fill_material_);
+    QSGGeometryNode::setGeometry(&geometry_);
+
+    appendChildNode(border_);
+}
+
+MapEllipseNode::~MapEllipseNode()
+{
+}
+
+/*!
+    \internal
+*/
+bool MapEllipseNode::isSubtreeBlocked() const
+{
+    return blocked_;
+}
+
+/*!
+    \internal
+
+    Draws the circle inscribed in the bounding square set up by
+    QGeoMapCircleGeometry::updateScreenPointsEllipse(), the fragments outside
+    of it are left transparent.
+*/
+void MapEllipseNode::update(const QColor &fillColor, const QColor &borderColor,
+                            const QGeoMapItemGeometry *fillShape,
+                            const QGeoMapItemGeometry *borderShape)
+{
+    border_->update(borderColor, borderShape);
+
+    // Same blocking as in MapPolygonNode::update()
+    if (fillShape->size() == 0) {
+        blocked_ = (borderShape->size() == 0);
+        if (blocked_)
+            return;
+        geometry_.allocate(0);
+    } else {
+        blocked_ = false;
+        const QRectF bounds = fillShape->screenBoundingBox();
+        const QPointF center = bounds.center();
+        const qreal radius = bounds.width() / 2;
+        geometry_.allocate(4);
+        QSGGeometry::TexturedPoint2D *vertices = geometry_.vertexDataAsTexturedPoint2D();
+        for (int i = 0; i < 4; ++i) {
+            const QVector2D p = fillShape->vertex(i);
+            vertices[i].set(p.x(), p.y(), (p.x() - center.x()) / radius, (p.y() - center.y()) / radius);
+        }
+    }
+    markDirty(DirtyGeometry);
+
+    const float radius = float(fillShape->screenBoundingBox().width() / 2);
+    if (fillColor != fill_material_.color || radius != fill_material_.radius) {
+        fill_material_.color = fillColor;
+        fill_material_.radius = radius;
+        setMaterial(&fill_material_);
+        markDirty(DirtyMaterial);
+    }
+}
+
 QT_END_NAMESPACE
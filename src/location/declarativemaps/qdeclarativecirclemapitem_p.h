@@ -54,6 +54,7 @@
 #include <QtLocation/private/qdeclarativepolygonmapitem_p.h>
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
+#include <QSGMaterial>
 #include <QtPositioning/QGeoCircle>
 
 QT_BEGIN_NAMESPACE
@@ -63,7 +64,15 @@ class QGeoMapCircleGeometry : public QGeoMapPolygonGeometry
 public:
     QGeoMapCircleGeometry();
 
-    void updateScreenPointsInvert(const QList<QDoubleVector2D> &circlePath, const QGeoMap &map);
+    // True when the screen vertices are the bounding square of a circle to be drawn by MapEllipseNode
+    inline bool isEllipse() const { return ellipse_; }
+
+    void updatePolygonPoints(const QGeoMap &map, const QVector<QDoubleVector2D> &circlePath);
+    void updateScreenPointsInvert(const QVector<QDoubleVector2D> &circlePath, const QGeoMap &map);
+    void updateScreenPointsEllipse(const QGeoMap &map, const QDoubleVector2D &center, double radius);
+
+private:
+    bool ellipse_;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeCircleMapItem : public QDeclarativeGeoMapItemBase
@@ -80,6 +89,7 @@ public:
 
     virtual void setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map) Q_DECL_OVERRIDE;
     virtual QSGNode *updateMapItemPaintNode(QSGNode *, UpdatePaintNodeData *) Q_DECL_OVERRIDE;
+    void updateMapItemBatch(QGeoMapItemBatch *batch) Q_DECL_OVERRIDE;
 
     QGeoCoordinate center();
     void setCenter(const QGeoCoordinate &center);
@@ -97,9 +107,9 @@ public:
     QGeoMap::ItemType itemType() const Q_DECL_OVERRIDE;
 
     static bool crossEarthPole(const QGeoCoordinate &center, qreal distance);
-    static void calculatePeripheralPoints(QList<QGeoCoordinate> &path, const QGeoCoordinate &center,
+    static void calculatePeripheralPoints(QVector<QGeoCoordinate> &path, const QGeoCoordinate &center,
                                    qreal distance, int steps, QGeoCoordinate &leftBound);
-    bool preserveCircleGeometry(QList<QDoubleVector2D> &path, const QGeoCoordinate &center,
+    bool preserveCircleGeometry(QVector<QDoubleVector2D> &path, const QGeoCoordinate &center,
                                 qreal distance);
 
 Q_SIGNALS:
@@ -116,16 +126,23 @@ protected Q_SLOTS:
     virtual void afterViewportChanged(const QGeoMapViewportChangeEvent &event) Q_DECL_OVERRIDE;
 
 private:
+    int circleSamples();
+    bool canDrawEllipse();
     void updateCirclePath();
-    void updateCirclePathForRendering(QList<QDoubleVector2D> &path, const QGeoCoordinate &center,
+    void updateCirclePathForRendering(QVector<QDoubleVector2D> &path, const QGeoCoordinate &center,
                                       qreal distance);
 
 private:
     QGeoCircle circle_;
     QDeclarativeMapLineProperties border_;
     QColor color_;
-    QList<QDoubleVector2D> circlePath_;
+    QVector<QDoubleVector2D> circlePath_;
     QGeoCoordinate leftBound_;
+    // Set when circlePath_ was laid out as a circle in map projection
+    bool projectedCircle_;
+    QDoubleVector2D projectedCenter_;
+    double projectedRadius_;
+    bool ellipseNode_;
     bool dirtyMaterial_;
     QGeoMapCircleGeometry geometry_;
     QGeoMapPolylineGeometry borderGeometry_;
@@ -134,6 +151,38 @@ private:
 
 //////////////////////////////////////////////////////////////////////
 
+class MapEllipseMaterial : public QSGMaterial
+{
+public:
+    MapEllipseMaterial();
+
+    QSGMaterialType *type() const Q_DECL_OVERRIDE;
+    QSGMaterialShader *createShader() const Q_DECL_OVERRIDE;
+    int compare(const QSGMaterial *other) const Q_DECL_OVERRIDE;
+
+    QColor color;
+    float radius;
+};
+
+class MapEllipseNode : public QSGGeometryNode
+{
+public:
+    MapEllipseNode();
+    ~MapEllipseNode();
+
+    void update(const QColor &fillColor, const QColor &borderColor,
+                const QGeoMapItemGeometry *fillShape,
+                const QGeoMapItemGeometry *borderShape);
+
+    bool isSubtreeBlocked() const;
+
+private:
+    MapEllipseMaterial fill_material_;
+    MapPolylineNode *border_;
+    QSGGeometry geometry_;
+    bool blocked_;
+};
+
 QT_END_NAMESPACE
 
 QML_DECLARE_TYPE(QDeclarativeCircleMapItem)
@@ -43,6 +43,8 @@
 #include "qgeocameracapabilities_p.h"
 #include "qgeomap_p.h"
 #include "qdeclarativegeomapparameter_p.h"
+#include "qgeomapitembatch_p.h"
+#include "qgeomapquickitemanimator_p.h"
 #include <QtPositioning/QGeoCircle>
 #include <QtPositioning/QGeoRectangle>
 #include <QtPositioning/QGeoPath>
@@ -168,6 +170,7 @@ QDeclarativeGeoMap::QDeclarativeGeoMap(QQuickItem *parent)
         m_activeMapType(0),
         m_gestureArea(new QQuickGeoMapGestureArea(this)),
         m_map(0),
+        m_mapItemBatchesChanged(false),
         m_error(QGeoServiceProvider::NoError),
         m_color(QColor::fromRgbF(0.9, 0.9, 0.9)),
         m_componentCompleted(false),
@@ -535,20 +538,42 @@ QSGNode *QDeclarativeGeoMap::updatePaintNode(QSGNode *oldNode, UpdatePaintNodeDa
     }
 
     QSGRectangleNode *root = static_cast<QSGRectangleNode *>(oldNode);
-    if (!root)
+    if (!root) {
         root = window()->createRectangleNode();
+        root->appendChildNode(new QSGNode); // map content
+        root->appendChildNode(new QSGNode); // batched map items
+        m_mapItemBatchesChanged = true;
+    }
 
     root->setRect(boundingRect());
     root->setColor(m_color);
 
-    QSGNode *content = root->childCount() ? root->firstChild() : 0;
+    QSGNode *contentParent = root->firstChild();
+    QSGNode *content = contentParent->childCount() ? contentParent->firstChild() : 0;
     content = m_map->updateSceneGraph(content, window());
-    if (content && root->childCount() == 0)
-        root->appendChildNode(content);
+    if (content && contentParent->childCount() == 0)
+        contentParent->appendChildNode(content);
+
+    if (m_mapItemBatchesChanged)
+        updateMapItemBatchNodes(root->lastChild());
 
     return root;
 }
 
+/*!
+ * \internal
+ */
+void QDeclarativeGeoMap::updateMapItemBatchNodes(QSGNode *parent)
+{
+    while (QSGNode *node = parent->firstChild()) {
+        parent->removeChildNode(node);
+        delete node;
+    }
+    for (const QSharedPointer<QGeoMapItemBatch> &batch : qAsConst(m_mapItemBatches))
+        parent->appendChildNode(new QGeoMapItemBatchNode(batch));
+    m_mapItemBatchesChanged = false;
+}
+
 /*!
     \qmlproperty Plugin QtLocation::Map::plugin
 
@@ -1271,7 +1296,7 @@ QGeoShape QDeclarativeGeoMap::visibleRegion() const
     if (!m_map || !width() || !height())
         return m_visibleRegion;
 
-    const QList<QDoubleVector2D> &visibleRegion = m_map->geoProjection().visibleRegion();
+    const QVector<QDoubleVector2D> &visibleRegion = m_map->geoProjection().visibleRegion();
     QGeoPath path;
     for (int i = 0; i < visibleRegion.size(); ++i) {
          const QDoubleVector2D &c = visibleRegion.at(i);
@@ -1341,6 +1366,81 @@ QColor QDeclarativeGeoMap::color() const
     return m_color;
 }
 
+/*!
+    \qmlproperty bool QtLocation::Map::batchMapItems
+
+    This property holds whether the map draws its MapPolygon, MapRectangle,
+    MapCircle and MapPolyline items in batches. All the items of one type are
+    then drawn by a single scene graph node, which keeps maps with thousands
+    of small items fast to render.
+
+    Batched items are drawn above the map and below any other map item, one
+    type after the other. Within a type, the drawing order of the items is not
+    defined, and transformations of the items other than their position are
+    ignored.
+
+    The default value is false.
+
+    \since Qt Location 5.9.6
+*/
+void QDeclarativeGeoMap::setBatchMapItems(bool batch)
+{
+    if (batch == batchMapItems())
+        return;
+
+    m_mapItemBatches.clear();
+    if (batch) {
+        m_mapItemBatches << QSharedPointer<QGeoMapItemBatch>(new QGeoMapItemBatch(QGeoMap::MapPolygon))
+                         << QSharedPointer<QGeoMapItemBatch>(new QGeoMapItemBatch(QGeoMap::MapRectangle))
+                         << QSharedPointer<QGeoMapItemBatch>(new QGeoMapItemBatch(QGeoMap::MapCircle))
+                         << QSharedPointer<QGeoMapItemBatch>(new QGeoMapItemBatch(QGeoMap::MapPolyline));
+    }
+    m_mapItemBatchesChanged = true;
+    update();
+
+    // Items move between their own nodes and the batches on their next sync. Some
+    // also build their geometry differently when batched.
+    for (const QPointer<QDeclarativeGeoMapItemBase> &item : qAsConst(m_mapItems)) {
+        if (item)
+            item->polishAndUpdate();
+    }
+
+    emit batchMapItemsChanged();
+}
+
+bool QDeclarativeGeoMap::batchMapItems() const
+{
+    return !m_mapItemBatches.isEmpty();
+}
+
+/*!
+    \internal
+
+    Returns the batch drawing the items of \a itemType, or null when they draw
+    themselves. Only to be called in the scene graph sync.
+*/
+QSharedPointer<QGeoMapItemBatch> QDeclarativeGeoMap::mapItemBatch(QGeoMap::ItemType itemType) const
+{
+    for (const QSharedPointer<QGeoMapItemBatch> &batch : m_mapItemBatches) {
+        if (batch->itemType() == itemType)
+            return batch;
+    }
+    return QSharedPointer<QGeoMapItemBatch>();
+}
+
+/*!
+    \internal
+
+    Returns the animator moving the MapQuickItems of this map, creating it on
+    first use.
+*/
+QGeoMapQuickItemAnimator *QDeclarativeGeoMap::quickItemAnimator()
+{
+    if (!m_quickItemAnimator)
+        m_quickItemAnimator = new QGeoMapQuickItemAnimator(this);
+    return m_quickItemAnimator;
+}
+
 /*!
     \qmlproperty bool QtLocation::Map::mapReady
 
@@ -58,6 +58,7 @@
 #include <QtQuick/QQuickItem>
 #include <QtCore/QList>
 #include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
 #include <QtGui/QColor>
 #include <QtPositioning/qgeorectangle.h>
 #include <QtLocation/private/qgeomap_p.h>
@@ -69,6 +70,8 @@ class QDeclarativeGeoServiceProvider;
 class QDeclarativeGeoMapType;
 class QDeclarativeGeoMapCopyrightNotice;
 class QDeclarativeGeoMapParameter;
+class QGeoMapItemBatch;
+class QGeoMapQuickItemAnimator;
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMap : public QQuickItem
 {
@@ -101,6 +104,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMap : public QQuickItem
     Q_PROPERTY(bool copyrightsVisible READ copyrightsVisible WRITE setCopyrightsVisible NOTIFY copyrightsVisibleChanged)
     Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
     Q_PROPERTY(bool mapReady READ mapReady NOTIFY mapReadyChanged)
+    Q_PROPERTY(bool batchMapItems READ batchMapItems WRITE setBatchMapItems NOTIFY batchMapItemsChanged)
     Q_INTERFACES(QQmlParserStatus)
 
 public:
@@ -156,6 +160,11 @@ public:
 
     bool mapReady() const;
 
+    void setBatchMapItems(bool batch);
+    bool batchMapItems() const;
+    QSharedPointer<QGeoMapItemBatch> mapItemBatch(QGeoMap::ItemType itemType) const;
+    QGeoMapQuickItemAnimator *quickItemAnimator();
+
     QQmlListProperty<QDeclarativeGeoMapType> supportedMapTypes();
 
     Q_INVOKABLE void removeMapItem(QDeclarativeGeoMapItemBase *item);
@@ -212,6 +221,7 @@ Q_SIGNALS:
     void copyrightsChanged(const QImage &copyrightsImage);
     void copyrightsChanged(const QString &copyrightsHtml);
     void mapReadyChanged(bool ready);
+    void batchMapItemsChanged();
 
 protected:
     void mousePressEvent(QMouseEvent *event) Q_DECL_OVERRIDE ;
@@ -252,6 +262,7 @@ private:
     bool isInteractive();
     void attachCopyrightNotice(bool initialVisibility);
     void detachCopyrightNotice(bool currentVisibility);
+    void updateMapItemBatchNodes(QSGNode *parent);
 
 private:
     QDeclarativeGeoServiceProvider *m_plugin;
@@ -264,6 +275,9 @@ private:
     QPointer<QDeclarativeGeoMapCopyrightNotice> m_copyrights;
     QList<QPointer<QDeclarativeGeoMapItemBase> > m_mapItems;
     QList<QPointer<QDeclarativeGeoMapItemGroup> > m_mapItemGroups;
+    QList<QSharedPointer<QGeoMapItemBatch> > m_mapItemBatches;
+    bool m_mapItemBatchesChanged;
+    QGeoMapQuickItemAnimator *m_quickItemAnimator = nullptr;
     QString m_errorString;
     QGeoServiceProvider::Error m_error;
     QGeoRectangle m_visibleRegion;
@@ -297,6 +311,7 @@ private:
     friend class QDeclarativeGeoMapItemView;
     friend class QQuickGeoMapGestureArea;
     friend class QDeclarativeGeoMapCopyrightNotice;
+    friend class QGeoMapQuickItemAnimator;
     Q_DISABLE_COPY(QDeclarativeGeoMap)
 };
 
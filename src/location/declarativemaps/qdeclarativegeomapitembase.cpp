@@ -36,6 +36,8 @@
 
 #include "qdeclarativegeomapitembase_p.h"
 #include "qgeocameradata_p.h"
+#include "qgeomapitembatch_p.h"
+#include "qgeomapitemgeometry_p.h"
 #include <QtLocation/private/qgeomap_p.h>
 #include <QtQml/QQmlInfo>
 #include <QtQuick/QSGOpacityNode>
@@ -89,6 +91,8 @@ QDeclarativeGeoMapItemBase::QDeclarativeGeoMapItemBase(QQuickItem *parent)
     if (parentGroup_)
         connect(qobject_cast<QDeclarativeGeoMapItemGroup *>(parent), &QQuickItem::opacityChanged,
                 this, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged);
+    // A batched item has no node of its own to apply the opacity to
+    connect(this, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged, this, &QQuickItem::update);
 }
 
 QDeclarativeGeoMapItemBase::~QDeclarativeGeoMapItemBase()
@@ -96,6 +100,7 @@ QDeclarativeGeoMapItemBase::~QDeclarativeGeoMapItemBase()
     disconnect(this, SLOT(afterChildrenChanged()));
     if (quickMap_)
         quickMap_->removeMapItem(this);
+    releaseBatch();
 }
 
 /*!
@@ -137,6 +142,7 @@ void QDeclarativeGeoMapItemBase::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *m
 
     quickMap_ = quickMap;
     map_ = map;
+    releaseBatch();
 
     if (map_ && quickMap_) {
         connect(map_, SIGNAL(cameraDataChanged(QGeoCameraData)),
@@ -237,6 +243,24 @@ QSGNode *QDeclarativeGeoMapItemBase::updatePaintNode(QSGNode *oldNode, UpdatePai
         if (oldNode)
             delete oldNode;
         oldNode = 0;
+        releaseBatch();
+        return 0;
+    }
+
+    const QSharedPointer<QGeoMapItemBatch> batch = quickMap_->mapItemBatch(itemType());
+    if (batch != batch_) {
+        releaseBatch();
+        batch_ = batch;
+    }
+
+    if (batch_) {
+        // Drawn by the batch node of the map instead
+        delete oldNode;
+        const qreal opacity = zoomLevelOpacity() * mapItemOpacity();
+        batch_->beginItem(this, mapToItem(quickMap_, QPointF()), opacity);
+        if (opacity > 0.0 && QQuickItemPrivate::get(this)->effectiveVisible)
+            updateMapItemBatch(batch_.data());
+        batch_->endItem();
         return 0;
     }
 
@@ -268,6 +292,64 @@ QSGNode *QDeclarativeGeoMapItemBase::updateMapItemPaintNode(QSGNode *oldNode, Up
     return 0;
 }
 
+/*!
+    \internal
+
+    Adds the triangles of the item to \a batch, when the map batches items of
+    this type.
+*/
+void QDeclarativeGeoMapItemBase::updateMapItemBatch(QGeoMapItemBatch *batch)
+{
+    Q_UNUSED(batch);
+}
+
+/*!
+    \internal
+
+    Adds \a geometry to \a batch, drawn with \a color and \a drawingMode, and
+    marks it as up to date like building a node of its own does.
+*/
+void QDeclarativeGeoMapItemBase::addToMapItemBatch(QGeoMapItemBatch *batch, QGeoMapItemGeometry &geometry,
+                                                   const QColor &color, QSGGeometry::DrawingMode drawingMode)
+{
+    batch->addGeometry(geometry, color, drawingMode);
+    geometry.setPreserveGeometry(false);
+    geometry.markClean();
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapItemBase::itemChange(ItemChange change, const ItemChangeData &value)
+{
+    // Batched items are drawn by the map, which does not follow their visibility
+    if (change == ItemVisibleHasChanged && batch_)
+        update();
+    QQuickItem::itemChange(change, value);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapItemBase::geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry)
+{
+    // Nor their position
+    if (batch_ && newGeometry.topLeft() != oldGeometry.topLeft())
+        update();
+    QQuickItem::geometryChanged(newGeometry, oldGeometry);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapItemBase::releaseBatch()
+{
+    if (batch_) {
+        batch_->removeItem(this);
+        batch_.clear();
+    }
+}
+
 qreal QDeclarativeGeoMapItemBase::mapItemOpacity() const
 {
     if (parentGroup_)
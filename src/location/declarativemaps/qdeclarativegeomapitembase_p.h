@@ -50,7 +50,9 @@
 
 #include <QtLocation/private/qlocationglobal_p.h>
 
+#include <QtCore/QSharedPointer>
 #include <QtQuick/QQuickItem>
+#include <QtQuick/QSGGeometry>
 #include <QtPositioning/QGeoShape>
 
 #include <QtLocation/private/qdeclarativegeomap_p.h>
@@ -59,6 +61,9 @@
 
 QT_BEGIN_NAMESPACE
 
+class QGeoMapItemBatch;
+class QGeoMapItemGeometry;
+
 class Q_LOCATION_PRIVATE_EXPORT QGeoMapViewportChangeEvent
 {
 public:
@@ -95,6 +100,7 @@ public:
 
     QSGNode *updatePaintNode(QSGNode *, UpdatePaintNodeData *);
     virtual QSGNode *updateMapItemPaintNode(QSGNode *, UpdatePaintNodeData *);
+    virtual void updateMapItemBatch(QGeoMapItemBatch *batch);
 
     virtual QGeoMap::ItemType itemType() const = 0;
     qreal mapItemOpacity() const;
@@ -110,12 +116,18 @@ protected Q_SLOTS:
 protected:
     float zoomLevelOpacity() const;
     bool childMouseEventFilter(QQuickItem *item, QEvent *event);
+    void itemChange(ItemChange change, const ItemChangeData &value) Q_DECL_OVERRIDE;
+    void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) Q_DECL_OVERRIDE;
     bool isPolishScheduled() const;
+    void addToMapItemBatch(QGeoMapItemBatch *batch, QGeoMapItemGeometry &geometry,
+                           const QColor &color, QSGGeometry::DrawingMode drawingMode);
 
 private Q_SLOTS:
     void baseCameraDataChanged(const QGeoCameraData &camera);
 
 private:
+    void releaseBatch();
+
     QGeoMap *map_;
     QDeclarativeGeoMap *quickMap_;
 
@@ -124,6 +136,9 @@ private:
 
     QDeclarativeGeoMapItemGroup *parentGroup_;
 
+    // The batch drawing this item, only set in the scene graph sync
+    QSharedPointer<QGeoMapItemBatch> batch_;
+
     friend class QDeclarativeGeoMap;
 };
 
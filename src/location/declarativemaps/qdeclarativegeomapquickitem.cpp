@@ -42,6 +42,8 @@
 #include <QtPositioning/private/qdoublevector2d_p.h>
 #include <QtQuick/private/qquickmousearea_p.h>
 #include <QtLocation/private/qgeomap_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include "qgeomapquickitemanimator_p.h"
 
 #include <QDebug>
 #include <cmath>
@@ -94,6 +96,11 @@ QT_BEGIN_NAMESPACE
     and (possibly) scaling of the original item, as well as a transformation
     from longitude and latitude to screen position.
 
+    Items moved by setting their \l coordinate with a
+    \l coordinateAnimationDuration are animated by the map, all of them in
+    one pass per frame. This is much cheaper than a Behavior with a
+    CoordinateAnimation on each item when many items move at once.
+
     \section2 Limitations
 
     \note Due to an implementation detail, items placed inside a
@@ -133,7 +140,8 @@ void QMapQuickItemMatrix4x4::applyTo(QMatrix4x4 *matrix) const
 
 QDeclarativeGeoMapQuickItem::QDeclarativeGeoMapQuickItem(QQuickItem *parent)
 :   QDeclarativeGeoMapItemBase(parent), zoomLevel_(0.0),
-    mapAndSourceItemSet_(false), updatingGeometry_(false), matrix_(nullptr)
+    mapAndSourceItemSet_(false), updatingGeometry_(false), matrix_(nullptr),
+    coordinateAnimationDuration_(0), animationSlot_(-1)
 {
     setFlag(ItemHasContents, true);
     opacityContainer_ = new QQuickItem(this);
@@ -142,7 +150,11 @@ QDeclarativeGeoMapQuickItem::QDeclarativeGeoMapQuickItem(QQuickItem *parent)
     setFiltersChildMouseEvents(true);
 }
 
-QDeclarativeGeoMapQuickItem::~QDeclarativeGeoMapQuickItem() {}
+QDeclarativeGeoMapQuickItem::~QDeclarativeGeoMapQuickItem()
+{
+    if (animationSlot_ >= 0 && quickMap())
+        quickMap()->quickItemAnimator()->remove(this);
+}
 
 /*!
     \qmlproperty coordinate MapQuickItem::coordinate
@@ -158,23 +170,75 @@ QDeclarativeGeoMapQuickItem::~QDeclarativeGeoMapQuickItem() {}
     \image api-mapquickitem-anchor.png
 */
 void QDeclarativeGeoMapQuickItem::setCoordinate(const QGeoCoordinate &coordinate)
+{
+    moveToCoordinate(coordinate, coordinateAnimationDuration_ > 0);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativeGeoMapQuickItem::moveToCoordinate(const QGeoCoordinate &coordinate, bool animated)
 {
     if (coordinate_ == coordinate)
         return;
 
+    if (animated && quickMap() && map() && coordinate_.isValid() && coordinate.isValid())
+        quickMap()->quickItemAnimator()->animate(this, coordinate_, coordinate, coordinateAnimationDuration_);
+    else if (animationSlot_ >= 0)
+        quickMap()->quickItemAnimator()->remove(this);
+
     coordinate_ = coordinate;
     geoshape_.setTopLeft(coordinate_);
     geoshape_.setBottomRight(coordinate_);
     // TODO: Handle zoomLevel != 0.0
-    polishAndUpdate();
+    if (animationSlot_ < 0)
+        polishAndUpdate();
     emit coordinateChanged();
 }
 
+/*!
+    \internal
+
+    Returns the coordinate the item is drawn at, which trails coordinate()
+    while the item moves.
+*/
+QGeoCoordinate QDeclarativeGeoMapQuickItem::displayedCoordinate()
+{
+    if (animationSlot_ < 0)
+        return coordinate_;
+    return map()->geoProjection().mapProjectionToGeo(quickMap()->quickItemAnimator()->position(this));
+}
+
+/*!
+    \internal
+
+    Places the item for a frame of its animation. Items that need a
+    transformation are polished instead.
+*/
+void QDeclarativeGeoMapQuickItem::setAnimatedPosition(const QDoubleVector2D &itemPosition, bool projectable)
+{
+    if (!mapAndSourceItemSet_ || zoomLevel_ != 0.0 || !projectable) {
+        polishAndUpdate();
+        return;
+    }
+
+    QScopedValueRollback<bool> rollback(updatingGeometry_);
+    updatingGeometry_ = true;
+
+    if (matrix_)
+        matrix_->setMatrix(QMatrix4x4());
+    setPosition(itemPosition.toPointF() - anchorPoint_);
+}
+
 /*!
     \internal
 */
 void QDeclarativeGeoMapQuickItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
 {
+    // An item leaving its map stops where it is going
+    if (animationSlot_ >= 0 && quickMap != this->quickMap())
+        this->quickMap()->quickItemAnimator()->remove(this);
+
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
     if (map && quickMap) {
         connect(map, SIGNAL(cameraDataChanged(QGeoCameraData)),
@@ -224,8 +288,9 @@ void QDeclarativeGeoMapQuickItem::geometryChanged(const QRectF &newGeometry, con
         newCoordinate = map()->geoProjection().itemPositionToCoordinate(QDoubleVector2D(x(), y()) + QDoubleVector2D(anchorPoint_), false);
     }
 
+    // Dragged items follow the pointer rather than animate
     if (newCoordinate.isValid())
-        setCoordinate(newCoordinate);
+        moveToCoordinate(newCoordinate, false);
 
     // Not calling QDeclarativeGeoMapItemBase::geometryChanged() as it will be called from a nested
     // call to this function.
@@ -336,6 +401,40 @@ qreal QDeclarativeGeoMapQuickItem::zoomLevel() const
     return zoomLevel_;
 }
 
+/*!
+    \qmlproperty int MapQuickItem::coordinateAnimationDuration
+
+    This property holds the duration in milliseconds over which the item
+    moves to a newly set \l coordinate.
+
+    The item moves at a constant speed along a straight line on the map,
+    taking the shorter way around the globe. The coordinate property holds the
+    new coordinate right away, and a coordinate set while the item moves
+    starts a new move from where the item is drawn. Dragging the item moves
+    it without animation.
+
+    All the moving items of a map are advanced together once per frame,
+    without going through the coordinate property, which makes this suitable
+    for animating thousands of items following live position updates.
+
+    The default value is 0, which moves the item immediately.
+
+    \since Qt Location 5.9.6
+*/
+void QDeclarativeGeoMapQuickItem::setCoordinateAnimationDuration(int duration)
+{
+    duration = qMax(duration, 0);
+    if (duration == coordinateAnimationDuration_)
+        return;
+    coordinateAnimationDuration_ = duration;
+    emit coordinateAnimationDurationChanged();
+}
+
+int QDeclarativeGeoMapQuickItem::coordinateAnimationDuration() const
+{
+    return coordinateAnimationDuration_;
+}
+
 const QGeoShape &QDeclarativeGeoMapQuickItem::geoShape() const
 {
     // TODO: return a QGeoRectangle representing the bounding geo rectangle of the quick item
@@ -385,6 +484,8 @@ void QDeclarativeGeoMapQuickItem::updatePolish()
         opacityContainer_->setVisible(true);
     }
 
+    const QGeoCoordinate position = displayedCoordinate();
+
     QScopedValueRollback<bool> rollback(updatingGeometry_);
     updatingGeometry_ = true;
 
@@ -397,22 +498,22 @@ void QDeclarativeGeoMapQuickItem::updatePolish()
             matrix_ = new QMapQuickItemMatrix4x4(this);
             matrix_->appendToItem(opacityContainer_);
         }
-        matrix_->setMatrix(map()->geoProjection().quickItemTransformation(coordinate(), anchorPoint_, zoomLevel_));
+        matrix_->setMatrix(map()->geoProjection().quickItemTransformation(position, anchorPoint_, zoomLevel_));
         setPosition(QPointF(0,0));
     } else {
         // if the coordinate is behind the camera, we use the transformation to get the item out of the way
         if (map()->cameraData().tilt() > 0.0
-            && !map()->geoProjection().isProjectable(map()->geoProjection().geoToWrappedMapProjection(coordinate()))) {
+            && !map()->geoProjection().isProjectable(map()->geoProjection().geoToWrappedMapProjection(position))) {
             if (!matrix_) {
                 matrix_ = new QMapQuickItemMatrix4x4(this);
                 matrix_->appendToItem(opacityContainer_);
             }
-            matrix_->setMatrix(map()->geoProjection().quickItemTransformation(coordinate(), anchorPoint_, map()->cameraData().zoomLevel()));
+            matrix_->setMatrix(map()->geoProjection().quickItemTransformation(position, anchorPoint_, map()->cameraData().zoomLevel()));
             setPosition(QPointF(0,0));
         } else {
             if (matrix_)
                 matrix_->setMatrix(QMatrix4x4());
-            setPositionOnMap(coordinate(), anchorPoint_);
+            setPositionOnMap(position, anchorPoint_);
         }
     }
 }
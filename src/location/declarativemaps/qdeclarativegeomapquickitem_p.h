@@ -56,6 +56,7 @@
 #include <QtLocation/private/qdeclarativegeomap_p.h>
 #include <QtLocation/private/qdeclarativegeomapitembase_p.h>
 #include <QtPositioning/qgeoshape.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -77,6 +78,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoMapQuickItem : public QDeclarativ
     Q_PROPERTY(QPointF anchorPoint READ anchorPoint WRITE setAnchorPoint NOTIFY anchorPointChanged)
     Q_PROPERTY(qreal zoomLevel READ zoomLevel WRITE setZoomLevel NOTIFY zoomLevelChanged)
     Q_PROPERTY(QQuickItem *sourceItem READ sourceItem WRITE setSourceItem NOTIFY sourceItemChanged)
+    Q_PROPERTY(int coordinateAnimationDuration READ coordinateAnimationDuration WRITE setCoordinateAnimationDuration NOTIFY coordinateAnimationDurationChanged)
 
 public:
     explicit QDeclarativeGeoMapQuickItem(QQuickItem *parent = 0);
@@ -96,6 +98,9 @@ public:
     void setZoomLevel(qreal zoomLevel);
     qreal zoomLevel() const;
 
+    void setCoordinateAnimationDuration(int duration);
+    int coordinateAnimationDuration() const;
+
     const QGeoShape &geoShape() const Q_DECL_OVERRIDE;
     QGeoMap::ItemType itemType() const Q_DECL_OVERRIDE;
 
@@ -104,6 +109,7 @@ Q_SIGNALS:
     void sourceItemChanged();
     void anchorPointChanged();
     void zoomLevelChanged();
+    void coordinateAnimationDurationChanged();
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) Q_DECL_OVERRIDE;
@@ -116,6 +122,10 @@ protected Q_SLOTS:
 
 private:
     qreal scaleFactor();
+    void moveToCoordinate(const QGeoCoordinate &coordinate, bool animated);
+    QGeoCoordinate displayedCoordinate();
+    void setAnimatedPosition(const QDoubleVector2D &itemPosition, bool projectable);
+
     QGeoCoordinate dragStartCoordinate_;
     QGeoCoordinate coordinate_;
     QGeoRectangle geoshape_;
@@ -126,8 +136,11 @@ private:
     bool mapAndSourceItemSet_;
     bool updatingGeometry_;
     QMapQuickItemMatrix4x4 *matrix_;
+    int coordinateAnimationDuration_;
+    int animationSlot_; // in the animator of the map, -1 when not moving
 
     friend class QDeclarativeGeoMap;
+    friend class QGeoMapQuickItemAnimator;
 };
 
 QT_END_NAMESPACE
@@ -157,7 +157,10 @@ qreal QDeclarativeGeoRoute::distance() const
     indicates the number of objects and 'path[index starting from zero]' gives
     the actual object.
 
-    \sa QtPositioning::coordinate
+    A Float64Array, or an ArrayBuffer, of latitude and longitude pairs can also
+    be assigned to it.
+
+    \sa QtPositioning::coordinate, geoPath, packedPath
 */
 
 QJSValue QDeclarativeGeoRoute::path() const
@@ -180,21 +183,30 @@ QJSValue QDeclarativeGeoRoute::path() const
 
 void QDeclarativeGeoRoute::setPath(const QJSValue &value)
 {
-    if (!value.isArray())
-        return;
-
     QList<QGeoCoordinate> pathList;
-    quint32 length = value.property(QStringLiteral("length")).toUInt();
-    for (quint32 i = 0; i < length; ++i) {
+    if (isPackedCoordinates(value)) {
         bool ok;
-        QGeoCoordinate c = parseCoordinate(value.property(i), &ok);
-
-        if (!ok || !c.isValid()) {
+        pathList = parsePackedCoordinates(value, &ok);
+        if (!ok) {
             qmlWarning(this) << "Unsupported path type";
             return;
         }
+    } else {
+        if (!value.isArray())
+            return;
+
+        quint32 length = value.property(QStringLiteral("length")).toUInt();
+        for (quint32 i = 0; i < length; ++i) {
+            bool ok;
+            QGeoCoordinate c = parseCoordinate(value.property(i), &ok);
 
-        pathList.append(c);
+            if (!ok || !c.isValid()) {
+                qmlWarning(this) << "Unsupported path type";
+                return;
+            }
+
+            pathList.append(c);
+        }
     }
 
     if (route_.path() == pathList)
@@ -205,6 +217,35 @@ void QDeclarativeGeoRoute::setPath(const QJSValue &value)
     emit pathChanged();
 }
 
+/*!
+    \qmlproperty geopath QtLocation::Route::geoPath
+
+    Read-only property which holds the geographical coordinates of this route
+    as a \l {geopath}. Unlike \l path, reading it does not create a JavaScript
+    object per coordinate. Binding it to \l {MapPolyline::geoPath}{MapPolyline.geoPath}
+    shares the coordinates of the route with the polyline.
+
+    \since Qt Location 5.9.6
+*/
+QGeoPath QDeclarativeGeoRoute::geoPath() const
+{
+    return QGeoPath(route_.path());
+}
+
+/*!
+    \qmlmethod ArrayBuffer QtLocation::Route::packedPath()
+
+    Returns the path of this route as an ArrayBuffer of latitude and longitude
+    pairs stored as 64-bit floating point numbers, suitable for a Float64Array.
+    Such a buffer, or a Float64Array over it, can also be assigned to \l path.
+
+    \since Qt Location 5.9.6
+*/
+QByteArray QDeclarativeGeoRoute::packedPath() const
+{
+    return packCoordinates(route_.path());
+}
+
 /*!
     \qmlproperty list<RouteSegment> QtLocation::Route::segments
 
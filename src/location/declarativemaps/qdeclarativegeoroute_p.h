@@ -54,6 +54,7 @@
 #include <QtCore/QObject>
 #include <QtQml/QQmlListProperty>
 #include <QtLocation/QGeoRoute>
+#include <QtPositioning/QGeoPath>
 
 QT_BEGIN_NAMESPACE
 
@@ -65,6 +66,7 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativeGeoRoute : public QObject
     Q_PROPERTY(int travelTime READ travelTime CONSTANT)
     Q_PROPERTY(qreal distance READ distance CONSTANT)
     Q_PROPERTY(QJSValue path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(QGeoPath geoPath READ geoPath NOTIFY pathChanged)
     Q_PROPERTY(QQmlListProperty<QDeclarativeGeoRouteSegment> segments READ segments CONSTANT)
 
 public:
@@ -78,6 +80,9 @@ public:
 
     QJSValue path() const;
     void setPath(const QJSValue &value);
+    QGeoPath geoPath() const;
+
+    Q_INVOKABLE QByteArray packedPath() const;
 
     QQmlListProperty<QDeclarativeGeoRouteSegment> segments();
 
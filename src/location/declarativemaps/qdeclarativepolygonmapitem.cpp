@@ -143,7 +143,21 @@ QGeoMapPolygonGeometry::QGeoMapPolygonGeometry()
     \internal
 */
 void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
-                                                const QList<QDoubleVector2D> &path)
+                                                const QVector<QDoubleVector2D> &path)
+{
+    if (!sourceDirty_)
+        return;
+
+    QVector<QWorldPoint> worldPath;
+    QWorldPoint::fromMercator(path, &worldPath);
+    updateSourcePoints(map, worldPath);
+}
+
+/*!
+    \internal
+*/
+void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
+                                                const QVector<QWorldPoint> &path)
 {
     if (!sourceDirty_)
         return;
@@ -152,76 +166,77 @@ void QGeoMapPolygonGeometry::updateSourcePoints(const QGeoMap &map,
 
     // build the actual path
     // The approach is the same as described in QGeoMapPolylineGeometry::updateSourcePoints
+    const QGeoProjection &projection = map.geoProjection();
     srcOrigin_ = geoLeftBound_;
-    double unwrapBelowX = 0;
-    QDoubleVector2D leftBoundWrapped = map.geoProjection().wrapMapProjection(map.geoProjection().geoToMapProjection(geoLeftBound_));
-    if (preserveGeometry_)
-        unwrapBelowX = leftBoundWrapped.x();
+    QDoubleVector2D leftBoundWrapped = projection.wrapMapProjection(projection.geoToMapProjection(geoLeftBound_));
+    const QWorldPoint leftBound = QWorldPoint::fromMercator(leftBoundWrapped);
 
-    QList<QDoubleVector2D> wrappedPath;
+    // Same buffer reuse as in QGeoMapPolylineGeometry::clipPath
+    QVector<QWorldPoint> &wrappedPath = wrappedPath_;
+    if (clippedPaths_.size() == 1 && clippedPaths_.at(0).capacity() > wrappedPath.capacity())
+        wrappedPath.swap(clippedPaths_[0]);
     wrappedPath.reserve(path.size());
-    QDoubleVector2D wrappedLeftBound(qInf(), qInf());
+    wrappedPath.resize(path.size());
+    clippedPaths_.resize(0);
+    QWorldPoint wrappedLeftBound(std::numeric_limits<qint64>::max(), std::numeric_limits<qint64>::max());
     // 1)
-    for (int i = 0; i < path.size(); ++i) {
-        const QDoubleVector2D &coord = path.at(i);
-        QDoubleVector2D wrappedProjection = map.geoProjection().wrapMapProjection(coord);
-
-        // We can get NaN if the map isn't set up correctly, or the projection
+    projection.wrapMapProjection(path.constData(), wrappedPath.data(), path.size());
+    for (QWorldPoint &wrappedProjection : wrappedPath) {
+        // We can get invalid points if the map isn't set up correctly, or the projection
         // is faulty -- probably best thing to do is abort
-        if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
+        if (!wrappedProjection.isValid())
             return;
 
-        const bool isPointLessThanUnwrapBelowX = (wrappedProjection.x() < leftBoundWrapped.x());
         // unwrap x to preserve geometry if moved to border of map
-        if (preserveGeometry_ && isPointLessThanUnwrapBelowX) {
-            double distance = wrappedProjection.x() - unwrapBelowX;
-            if (distance < 0.0)
-                distance += 1.0;
-            wrappedProjection.setX(unwrapBelowX + distance);
-        }
+        if (preserveGeometry_ && wrappedProjection.x() < leftBound.x())
+            wrappedProjection.setX(wrappedProjection.x() + QWorldPoint::worldSize());
         if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y())) {
             wrappedLeftBound = wrappedProjection;
         }
-        wrappedPath.append(wrappedProjection);
     }
 
     // 2)
-    QList<QList<QDoubleVector2D> > clippedPaths;
-    const QList<QDoubleVector2D> &visibleRegion = map.geoProjection().projectableRegion();
-    if (visibleRegion.size()) {
-        c2t::clip2tri clipper;
-        clipper.addSubjectPath(QClipperUtils::qListToPath(wrappedPath), true);
-        clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
-        Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
-        clippedPaths = QClipperUtils::pathsToQList(res);
+    QVector<QVector<QWorldPoint> > &clippedPaths = clippedPaths_;
+    const QGeoClipRegion &clipRegion = projection.projectableClipRegion();
+    const QGeoClipRegion::Containment containment = clipRegion.classify(wrappedPath);
+    if (containment == QGeoClipRegion::Outside) {
+        return; // nothing visible, same as when clipping leaves nothing
+    } else if (containment == QGeoClipRegion::Intersecting) {
+        clipRegion.clipPolygon(wrappedPath, &clippedPaths);
 
         // 2.1) update srcOrigin_ and leftBoundWrapped with the point with minimum X
-        QDoubleVector2D lb(qInf(), qInf());
-        for (const QList<QDoubleVector2D> &path: clippedPaths)
-            for (const QDoubleVector2D &p: path)
+        QWorldPoint lb(std::numeric_limits<qint64>::max(), std::numeric_limits<qint64>::max());
+        for (const QVector<QWorldPoint> &path: clippedPaths)
+            for (const QWorldPoint &p: path)
                 if (p.x() < lb.x() || (p.x() == lb.x() && p.y() < lb.y()))
                     // y-minimization needed to find the same point on polygon and border
                     lb = p;
 
-        if (qIsInf(lb.x())) // e.g., when the polygon is clipped entirely
+        if (lb.x() == std::numeric_limits<qint64>::max()) // e.g., when the polygon is clipped entirely
             return;
 
-        // 2.2) Prevent the conversion to and from clipper from introducing negative offsets which
+        // 2.2) Prevent rounding the crossings from introducing negative offsets which
         //      in turn will make the geometry wrap around.
         lb.setX(qMax(wrappedLeftBound.x(), lb.x()));
-        leftBoundWrapped = lb;
-        srcOrigin_ = map.geoProjection().mapProjectionToGeo(map.geoProjection().unwrapMapProjection(lb));
+        leftBoundWrapped = lb.toMercator();
+        srcOrigin_ = projection.mapProjectionToGeo(projection.unwrapMapProjection(leftBoundWrapped));
     } else {
-        clippedPaths.append(wrappedPath);
+        // Entirely inside: the origin is the westernmost point, as 2.1) would find it
+        if (!clipRegion.isEmpty()) {
+            leftBoundWrapped = wrappedLeftBound.toMercator();
+            srcOrigin_ = projection.mapProjectionToGeo(projection.unwrapMapProjection(leftBoundWrapped));
+        }
+        clippedPaths.resize(1);
+        clippedPaths[0].swap(wrappedPath);
     }
 
     // 3)
-    QDoubleVector2D origin = map.geoProjection().wrappedMapProjectionToItemPosition(leftBoundWrapped);
-    for (const QList<QDoubleVector2D> &path: clippedPaths) {
+    QDoubleVector2D origin = projection.wrappedMapProjectionToItemPosition(leftBoundWrapped);
+    for (const QVector<QWorldPoint> &path: clippedPaths) {
+        const QVector<QDoubleVector2D> &positions = itemPositions(map, path);
         QDoubleVector2D lastAddedPoint;
         for (int i = 0; i < path.size(); ++i) {
-            QDoubleVector2D point = map.geoProjection().wrappedMapProjectionToItemPosition(path.at(i));
-            point = point - origin; // (0,0) if point == geoLeftBound_
+            QDoubleVector2D point = positions.at(i) - origin; // (0,0) if point == geoLeftBound_
 
             if (i == 0) {
                 srcPath_.moveTo(point.toPointF());
@@ -312,9 +327,38 @@ void QGeoMapPolygonGeometry::updateScreenPoints(const QGeoMap &map)
     screenBounds_ = ppi.boundingRect();
 }
 
+QGeoMapPolygonGeometryTask::QGeoMapPolygonGeometryTask(const QSharedPointer<QGeoMapSnapshot> &snapshot,
+                                                       const QVector<QWorldPoint> &path,
+                                                       const QGeoCoordinate &pathLeftBound,
+                                                       qreal borderWidth)
+:   QGeoMapItemGeometryTask(snapshot), path_(path), pathLeftBound_(pathLeftBound), borderWidth_(borderWidth),
+    sourceLeft_(0.0), sourceRight_(0.0)
+{
+}
+
+void QGeoMapPolygonGeometryTask::build()
+{
+    if (path_.isEmpty())
+        return;
+    qint64 left = std::numeric_limits<qint64>::max();
+    qint64 right = std::numeric_limits<qint64>::min();
+    for (const QWorldPoint &p : qAsConst(path_)) {
+        if (!p.isValid())
+            continue;
+        left = qMin(left, p.x());
+        right = qMax(right, p.x());
+    }
+    if (left <= right) {
+        sourceLeft_ = double(left) / double(QWorldPoint::worldSize());
+        sourceRight_ = double(right) / double(QWorldPoint::worldSize());
+    }
+    bounds_ = QDeclarativePolygonMapItem::buildGeometry(map(), path_, pathLeftBound_, borderWidth_,
+                                                        geometry_, borderGeometry_);
+}
+
 QDeclarativePolygonMapItem::QDeclarativePolygonMapItem(QQuickItem *parent)
 :   QDeclarativeGeoMapItemBase(parent), border_(this), color_(Qt::transparent), dirtyMaterial_(true),
-    updatingGeometry_(false)
+    updatingGeometry_(false), asynchronous_(false)
 {
     setFlag(ItemHasContents, true);
     QObject::connect(&border_, SIGNAL(colorChanged(QColor)),
@@ -361,6 +405,7 @@ QDeclarativeMapLineProperties *QDeclarativePolygonMapItem::border()
 void QDeclarativePolygonMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map)
 {
     QDeclarativeGeoMapItemBase::setMap(quickMap,map);
+    geometryTask_.clear(); // built for the previous map
     if (map) {
         regenerateCache();
         geometry_.markSourceDirty();
@@ -376,7 +421,10 @@ void QDeclarativePolygonMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *m
     define the polygon.
     Having less than 3 different coordinates in the path results in undefined behavior.
 
-    \sa addCoordinate, removeCoordinate
+    A Float64Array, or an ArrayBuffer, of latitude and longitude pairs can
+    also be assigned to it.
+
+    \sa addCoordinate, removeCoordinate, geoPath, packedPath
 */
 QJSValue QDeclarativePolygonMapItem::path() const
 {
@@ -398,6 +446,17 @@ QJSValue QDeclarativePolygonMapItem::path() const
 
 void QDeclarativePolygonMapItem::setPath(const QJSValue &value)
 {
+    if (isPackedCoordinates(value)) {
+        bool ok;
+        const QList<QGeoCoordinate> pathList = parsePackedCoordinates(value, &ok);
+        if (!ok) {
+            qmlWarning(this) << "Unsupported path type";
+            return;
+        }
+        setPathFromGeoList(pathList);
+        return;
+    }
+
     if (!value.isArray())
         return;
 
@@ -415,12 +474,27 @@ void QDeclarativePolygonMapItem::setPath(const QJSValue &value)
         pathList.append(c);
     }
 
+    setPathFromGeoList(pathList);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolygonMapItem::setPathFromGeoList(const QList<QGeoCoordinate> &path)
+{
     // Equivalent to QDeclarativePolylineMapItem::setPathFromGeoList
-    if (geopath_.path() == pathList)
+    if (geopath_.path() == path)
         return;
 
-    geopath_.setPath(pathList);
+    geopath_.setPath(path);
+    pathUpdated();
+}
 
+/*!
+    \internal
+*/
+void QDeclarativePolygonMapItem::pathUpdated()
+{
     regenerateCache();
     geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
     borderGeometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
@@ -428,6 +502,45 @@ void QDeclarativePolygonMapItem::setPath(const QJSValue &value)
     emit pathChanged();
 }
 
+/*!
+    \qmlproperty geopath MapPolygon::geoPath
+
+    This property holds the path of the polygon as a \l {geopath}.
+
+    Reading or writing it does not convert each coordinate to or from a
+    JavaScript object, and assigning the geopath of another item shares its
+    coordinates instead of copying them.
+
+    \since Qt Location 5.9.6
+*/
+QGeoPath QDeclarativePolygonMapItem::geoPath() const
+{
+    return geopath_;
+}
+
+void QDeclarativePolygonMapItem::setGeoPath(const QGeoPath &path)
+{
+    if (geopath_.path() == path.path())
+        return;
+
+    geopath_ = path;
+    pathUpdated();
+}
+
+/*!
+    \qmlmethod ArrayBuffer MapPolygon::packedPath()
+
+    Returns the path as an ArrayBuffer of latitude and longitude pairs stored as
+    64-bit floating point numbers, suitable for a Float64Array. Such a buffer,
+    or a Float64Array over it, can also be assigned to \l path.
+
+    \since Qt Location 5.9.6
+*/
+QByteArray QDeclarativePolygonMapItem::packedPath() const
+{
+    return packCoordinates(geopath_.path());
+}
+
 /*!
     \qmlmethod void MapPolygon::addCoordinate(coordinate)
 
@@ -497,6 +610,37 @@ void QDeclarativePolygonMapItem::setColor(const QColor &color)
     emit colorChanged(color_);
 }
 
+/*!
+    \qmlproperty bool MapPolygon::asynchronous
+
+    This property holds whether the geometry of the polygon is built on a
+    worker thread. Projecting, clipping and triangulating large polygons is
+    then kept off the GUI thread, at the cost of the polygon being shown a few
+    frames later. While the camera zooms, rotates or tilts, the polygon keeps
+    its previous geometry until the camera settles long enough for a build to
+    finish.
+
+    The default value is false.
+
+    \since Qt Location 5.9.6
+*/
+bool QDeclarativePolygonMapItem::asynchronous() const
+{
+    return asynchronous_;
+}
+
+void QDeclarativePolygonMapItem::setAsynchronous(bool asynchronous)
+{
+    if (asynchronous_ == asynchronous)
+        return;
+
+    asynchronous_ = asynchronous;
+    if (!asynchronous_)
+        geometryTask_.clear();
+    markSourceDirtyAndUpdate();
+    emit asynchronousChanged();
+}
+
 /*!
     \internal
 */
@@ -509,7 +653,7 @@ QSGNode *QDeclarativePolygonMapItem::updateMapItemPaintNode(QSGNode *oldNode, Up
         node = new MapPolygonNode();
 
     //TODO: update only material
-    if (geometry_.isScreenDirty() || borderGeometry_.isScreenDirty() || dirtyMaterial_) {
+    if (geometry_.isScreenDirty() || borderGeometry_.isScreenDirty() || dirtyMaterial_ || !oldNode) {
         node->update(color_, border_.color(), &geometry_, &borderGeometry_);
         geometry_.setPreserveGeometry(false);
         borderGeometry_.setPreserveGeometry(false);
@@ -523,52 +667,152 @@ QSGNode *QDeclarativePolygonMapItem::updateMapItemPaintNode(QSGNode *oldNode, Up
 /*!
     \internal
 */
-void QDeclarativePolygonMapItem::updatePolish()
+void QDeclarativePolygonMapItem::updateMapItemBatch(QGeoMapItemBatch *batch)
 {
-    if (!map() || geopath_.path().length() == 0)
-        return;
+    addToMapItemBatch(batch, geometry_, color_, QSGGeometry::DrawTriangles);
+    addToMapItemBatch(batch, borderGeometry_, border_.color(), QSGGeometry::DrawTriangleStrip);
+    dirtyMaterial_ = false;
+}
 
-    QScopedValueRollback<bool> rollback(updatingGeometry_);
-    updatingGeometry_ = true;
+/*!
+    \internal
 
-    geometry_.updateSourcePoints(*map(), geopathProjected_);
-    geometry_.updateScreenPoints(*map());
+    Builds the fill and border geometries of a polygon against \a map, and
+    returns their combined bounds. This only touches its arguments, so that it
+    can run on a worker thread against a QGeoMapSnapshot.
+*/
+QRectF QDeclarativePolygonMapItem::buildGeometry(const QGeoMap &map, const QVector<QWorldPoint> &path,
+                                                 const QGeoCoordinate &pathLeftBound, qreal borderWidth,
+                                                 QGeoMapPolygonGeometry &geometry, QGeoMapPolylineGeometry &borderGeometry)
+{
+    geometry.updateSourcePoints(map, path);
+    geometry.updateScreenPoints(map);
 
     QList<QGeoMapItemGeometry *> geoms;
-    geoms << &geometry_;
-    borderGeometry_.clear();
+    geoms << &geometry;
+    borderGeometry.clear();
 
-    if (border_.color() != Qt::transparent && border_.width() > 0) {
-        QList<QDoubleVector2D> closedPath = geopathProjected_;
+    if (borderWidth > 0) {
+        QVector<QWorldPoint> closedPath = path;
         closedPath << closedPath.first();
 
-        borderGeometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
+        borderGeometry.setPreserveGeometry(true, pathLeftBound);
 
-        const QGeoCoordinate &geometryOrigin = geometry_.origin();
+        const QGeoCoordinate &geometryOrigin = geometry.origin();
 
-        borderGeometry_.srcPoints_.clear();
-        borderGeometry_.srcPointTypes_.clear();
+        borderGeometry.srcPoints_.clear();
+        borderGeometry.srcPointTypes_.clear();
 
         QDoubleVector2D borderLeftBoundWrapped;
-        QList<QList<QDoubleVector2D > > clippedPaths = borderGeometry_.clipPath(*map(), closedPath, borderLeftBoundWrapped);
+        const QVector<QVector<QWorldPoint> > &clippedPaths = borderGeometry.clipPath(map, closedPath, borderLeftBoundWrapped);
         if (clippedPaths.size()) {
-            borderLeftBoundWrapped = map()->geoProjection().geoToWrappedMapProjection(geometryOrigin);
-            borderGeometry_.pathToScreen(*map(), clippedPaths, borderLeftBoundWrapped);
-            borderGeometry_.updateScreenPoints(*map(), border_.width());
+            borderLeftBoundWrapped = map.geoProjection().geoToWrappedMapProjection(geometryOrigin);
+            borderGeometry.pathToScreen(map, clippedPaths, borderLeftBoundWrapped);
+            borderGeometry.updateScreenPoints(map, borderWidth);
 
-            geoms << &borderGeometry_;
+            geoms << &borderGeometry;
         } else {
-            borderGeometry_.clear();
+            borderGeometry.clear();
         }
     }
 
-    QRectF combined = QGeoMapItemGeometry::translateToCommonOrigin(geoms);
-    setWidth(combined.width());
-    setHeight(combined.height());
+    return QGeoMapItemGeometry::translateToCommonOrigin(geoms);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolygonMapItem::applyGeometry(const QRectF &bounds)
+{
+    setWidth(bounds.width());
+    setHeight(bounds.height());
 
     setPositionOnMap(geometry_.origin(), -1 * geometry_.sourceBoundingBox().topLeft());
 }
 
+/*!
+    \internal
+*/
+void QDeclarativePolygonMapItem::updatePolish()
+{
+    if (!map() || geopath_.path().length() == 0)
+        return;
+
+    QScopedValueRollback<bool> rollback(updatingGeometry_);
+    updatingGeometry_ = true;
+
+    if (asynchronous_) {
+        updateGeometryAsynchronously();
+        return;
+    }
+
+    const qreal borderWidth = (border_.color() != Qt::transparent) ? border_.width() : 0;
+    const QRectF bounds = buildGeometry(*map(), geopathProjected_, geopath_.boundingGeoRectangle().topLeft(),
+                                        borderWidth, geometry_, borderGeometry_);
+    applyGeometry(bounds);
+}
+
+/*!
+    \internal
+
+    Picks up the geometry of a finished task, and starts a new task when the
+    source changed since. At most one task per item is in flight, changes made
+    meanwhile are folded into the next one.
+*/
+void QDeclarativePolygonMapItem::updateGeometryAsynchronously()
+{
+    if (geometryTask_) {
+        if (!geometryTask_->isFinished())
+            return; // handleGeometryTaskFinished() polishes again
+
+        QSharedPointer<QGeoMapPolygonGeometryTask> task;
+        task.swap(geometryTask_);
+        if (task->map().isValidFor(*map(), task->sourceLeft_, task->sourceRight_)) {
+            // The item geometries were marked clean when the task started, dirty ones changed since
+            const bool changed = geometry_.isSourceDirty() || borderGeometry_.isSourceDirty();
+            geometry_ = task->geometry_;
+            borderGeometry_ = task->borderGeometry_;
+            if (changed) {
+                geometry_.markSourceDirty();
+                borderGeometry_.markSourceDirty();
+            }
+            applyGeometry(task->bounds_);
+            update();
+        } else {
+            // Built for a camera that is gone, build again for the current one
+            geometry_.markSourceDirty();
+            borderGeometry_.markSourceDirty();
+        }
+    }
+
+    if (!geometry_.isSourceDirty() && !borderGeometry_.isSourceDirty())
+        return;
+
+    const qreal borderWidth = (border_.color() != Qt::transparent) ? border_.width() : 0;
+    QGeoMapItemGeometryBuilder *builder = QGeoMapItemGeometryBuilder::instance();
+    // The task is released on the GUI thread, where it lives, even if a worker drops it last
+    geometryTask_ = QSharedPointer<QGeoMapPolygonGeometryTask>(
+                new QGeoMapPolygonGeometryTask(builder->snapshot(*map()), geopathProjected_,
+                                               geopath_.boundingGeoRectangle().topLeft(), borderWidth),
+                &QObject::deleteLater);
+    geometryTask_->geometry_ = geometry_;
+    geometryTask_->borderGeometry_ = borderGeometry_;
+    geometry_.markClean();
+    borderGeometry_.markClean();
+    connect(geometryTask_.data(), &QGeoMapItemGeometryTask::finished,
+            this, &QDeclarativePolygonMapItem::handleGeometryTaskFinished, Qt::QueuedConnection);
+    builder->start(geometryTask_);
+}
+
+/*!
+    \internal
+*/
+void QDeclarativePolygonMapItem::handleGeometryTaskFinished()
+{
+    if (geometryTask_ && geometryTask_->isFinished())
+        polishAndUpdate();
+}
+
 void QDeclarativePolygonMapItem::markSourceDirtyAndUpdate()
 {
     geometry_.markSourceDirty();
@@ -598,10 +842,11 @@ void QDeclarativePolygonMapItem::regenerateCache()
 {
     if (!map())
         return;
-    geopathProjected_.clear();
-    geopathProjected_.reserve(geopath_.path().size());
-    for (const QGeoCoordinate &c : geopath_.path())
-        geopathProjected_ << map()->geoProjection().geoToMapProjection(c);
+    // Projected once per path change, the geometry then works on the world points
+    const QVector<QGeoCoordinate> path = geopath_.path().toVector();
+    QVector<QDoubleVector2D> projected(path.size());
+    map()->geoProjection().geoToMapProjection(path.constData(), projected.data(), path.size());
+    QWorldPoint::fromMercator(projected, &geopathProjected_);
 }
 
 /*!
@@ -611,7 +856,10 @@ void QDeclarativePolygonMapItem::updateCache()
 {
     if (!map())
         return;
-    geopathProjected_ << map()->geoProjection().geoToMapProjection(geopath_.path().last());
+    // Same conversion as regenerateCache(), for results independent of how the path was built
+    QDoubleVector2D projected;
+    map()->geoProjection().geoToMapProjection(&geopath_.path().last(), &projected, 1);
+    geopathProjected_ << QWorldPoint::fromMercator(projected);
 }
 
 /*!
@@ -53,12 +53,14 @@
 #include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
 #include <QtLocation/private/qgeomapitemgeometry_p.h>
 
+#include <QtLocation/private/qgeomapitemgeometrybuilder_p.h>
 #include <QSGGeometryNode>
 #include <QSGFlatColorMaterial>
 
 QT_BEGIN_NAMESPACE
 
 class MapPolygonNode;
+class QDeclarativePolygonMapItem;
 
 class QGeoMapPolygonGeometry : public QGeoMapItemGeometry
 {
@@ -68,13 +70,48 @@ public:
     inline void setAssumeSimple(bool value) { assumeSimple_ = value; }
 
     void updateSourcePoints(const QGeoMap &map,
-                            const QList<QDoubleVector2D> &path);
+                            const QVector<QDoubleVector2D> &path);
+    void updateSourcePoints(const QGeoMap &map,
+                            const QVector<QWorldPoint> &path);
 
     void updateScreenPoints(const QGeoMap &map);
 
 protected:
     QPainterPath srcPath_;
     bool assumeSimple_;
+
+private:
+    // scratch buffers reused by every updateSourcePoints()
+    QVector<QWorldPoint> wrappedPath_;
+    QVector<QVector<QWorldPoint> > clippedPaths_;
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapPolygonGeometryTask : public QGeoMapItemGeometryTask
+{
+public:
+    // A borderWidth of 0 builds no border
+    QGeoMapPolygonGeometryTask(const QSharedPointer<QGeoMapSnapshot> &snapshot,
+                               const QVector<QWorldPoint> &path,
+                               const QGeoCoordinate &pathLeftBound,
+                               qreal borderWidth);
+
+protected:
+    void build() Q_DECL_OVERRIDE;
+
+private:
+    QVector<QWorldPoint> path_;
+    QGeoCoordinate pathLeftBound_;
+    qreal borderWidth_;
+
+    // Unwrapped map projection extent of path_
+    double sourceLeft_;
+    double sourceRight_;
+
+    QGeoMapPolygonGeometry geometry_;
+    QGeoMapPolylineGeometry borderGeometry_;
+    QRectF bounds_;
+
+    friend class QDeclarativePolygonMapItem;
 };
 
 class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolygonMapItem : public QDeclarativeGeoMapItemBase
@@ -82,8 +119,10 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolygonMapItem : public QDeclarative
     Q_OBJECT
 
     Q_PROPERTY(QJSValue path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(QGeoPath geoPath READ geoPath WRITE setGeoPath NOTIFY pathChanged)
     Q_PROPERTY(QColor color READ color WRITE setColor NOTIFY colorChanged)
     Q_PROPERTY(QDeclarativeMapLineProperties *border READ border CONSTANT)
+    Q_PROPERTY(bool asynchronous READ asynchronous WRITE setAsynchronous NOTIFY asynchronousChanged)
 
 public:
     explicit QDeclarativePolygonMapItem(QQuickItem *parent = 0);
@@ -92,18 +131,26 @@ public:
     virtual void setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map) Q_DECL_OVERRIDE;
     //from QuickItem
     virtual QSGNode *updateMapItemPaintNode(QSGNode *, UpdatePaintNodeData *) Q_DECL_OVERRIDE;
+    void updateMapItemBatch(QGeoMapItemBatch *batch) Q_DECL_OVERRIDE;
 
     Q_INVOKABLE void addCoordinate(const QGeoCoordinate &coordinate);
     Q_INVOKABLE void removeCoordinate(const QGeoCoordinate &coordinate);
+    Q_INVOKABLE QByteArray packedPath() const;
 
     QJSValue path() const;
     void setPath(const QJSValue &value);
 
+    QGeoPath geoPath() const;
+    void setGeoPath(const QGeoPath &path);
+
     QColor color() const;
     void setColor(const QColor &color);
 
     QDeclarativeMapLineProperties *border();
 
+    bool asynchronous() const;
+    void setAsynchronous(bool asynchronous);
+
     bool contains(const QPointF &point) const Q_DECL_OVERRIDE;
     const QGeoShape &geoShape() const Q_DECL_OVERRIDE;
     QGeoMap::ItemType itemType() const Q_DECL_OVERRIDE;
@@ -111,6 +158,7 @@ public:
 Q_SIGNALS:
     void pathChanged();
     void colorChanged(const QColor &color);
+    void asynchronousChanged();
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) Q_DECL_OVERRIDE;
@@ -119,20 +167,32 @@ protected:
 protected Q_SLOTS:
     void markSourceDirtyAndUpdate();
     void handleBorderUpdated();
+    void handleGeometryTaskFinished();
     virtual void afterViewportChanged(const QGeoMapViewportChangeEvent &event) Q_DECL_OVERRIDE;
 
 private:
+    void setPathFromGeoList(const QList<QGeoCoordinate> &path);
+    void pathUpdated();
     void regenerateCache();
     void updateCache();
+    void updateGeometryAsynchronously();
+    void applyGeometry(const QRectF &bounds);
+    static QRectF buildGeometry(const QGeoMap &map, const QVector<QWorldPoint> &path,
+                                const QGeoCoordinate &pathLeftBound, qreal borderWidth,
+                                QGeoMapPolygonGeometry &geometry, QGeoMapPolylineGeometry &borderGeometry);
 
     QGeoPath geopath_;
-    QList<QDoubleVector2D> geopathProjected_;
+    QVector<QWorldPoint> geopathProjected_;
     QDeclarativeMapLineProperties border_;
     QColor color_;
     bool dirtyMaterial_;
     QGeoMapPolygonGeometry geometry_;
     QGeoMapPolylineGeometry borderGeometry_;
     bool updatingGeometry_;
+    bool asynchronous_;
+    QSharedPointer<QGeoMapPolygonGeometryTask> geometryTask_;
+
+    friend class QGeoMapPolygonGeometryTask;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -42,6 +42,8 @@
 #include <QtLocation/private/qgeomap_p.h>
 
 #include <QtCore/QScopedValueRollback>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/qmath.h>
 #include <QtQml/QQmlInfo>
 #include <QtQml/private/qqmlengine_p.h>
 #include <QPainter>
@@ -89,6 +91,12 @@ QT_BEGIN_NAMESPACE
     of vertices. This means that the per frame cost of having a polyline on
     the Map grows in direct proportion to the number of points in the polyline.
 
+    Coordinates appended with \l addCoordinate only extend the existing geometry
+    of the polyline, instead of projecting, clipping and stroking the whole path
+    again, as long as the map is not moved in the meantime and the new coordinates
+    do not need clipping. This keeps long live tracks cheap to update. Use
+    \l maximumPathLength to keep only the most recent part of such a track.
+
     Like the other map objects, MapPolyline is normally drawn without a smooth
     appearance. Setting the \l {Item::opacity}{opacity} property will force the object to
     be blended, which decreases performance considerably depending on the hardware in use.
@@ -174,71 +182,91 @@ struct Vertex
     QVector2D position;
 };
 
+namespace {
+
+// Number of source points stroked together; appends only re-stroke the last, open chunk.
+const int StrokeChunkSize = 128;
+
+} // namespace
+
 QGeoMapPolylineGeometry::QGeoMapPolylineGeometry()
+    : srcPathClipped_(false), srcPathLength_(0), unwrapBelowX_(std::numeric_limits<qint64>::min()), lastPointForced_(false),
+      strokeDirtyFrom_(0), strokeHeadDirty_(false)
 {
 }
 
-QList<QList<QDoubleVector2D> > QGeoMapPolylineGeometry::clipPath(const QGeoMap &map,
-                                                           const QList<QDoubleVector2D> &path,
-                                                           QDoubleVector2D &leftBoundWrapped)
+const QVector<QVector<QWorldPoint> > &QGeoMapPolylineGeometry::clipPath(const QGeoMap &map,
+                                                                      const QVector<QWorldPoint> &path,
+                                                                      QDoubleVector2D &leftBoundWrapped)
 {
     /*
      * Approach:
-     * 1) project coordinates to wrapped web mercator, and do unwrapBelowX
+     * 1) wrap the world points, and do unwrapBelowX
      * 2) if the scene is tilted, clip the geometry against the visible region (this may generate multiple polygons)
      * 2.1) recalculate the origin and geoLeftBound to prevent these parameters from ending in unprojectable areas
-     * 2.2) ensure the left bound does not wrap around due to QGeoCoordinate <-> clipper conversions
+     * 2.2) ensure the left bound does not wrap around due to QGeoCoordinate <-> world point conversions
      */
 
     srcOrigin_ = geoLeftBound_;
-
-    double unwrapBelowX = 0;
-    leftBoundWrapped = map.geoProjection().wrapMapProjection(map.geoProjection().geoToMapProjection(geoLeftBound_));
-    if (preserveGeometry_)
-        unwrapBelowX = leftBoundWrapped.x();
-
-    QList<QDoubleVector2D> wrappedPath;
+    srcPathClipped_ = false;
+
+    const QGeoProjection &projection = map.geoProjection();
+    leftBoundWrapped = projection.wrapMapProjection(projection.geoToMapProjection(geoLeftBound_));
+    const QWorldPoint leftBound = QWorldPoint::fromMercator(leftBoundWrapped);
+    unwrapBelowX_ = preserveGeometry_ ? leftBound.x() : std::numeric_limits<qint64>::min();
+
+    // wrappedPath_ and clippedPaths_ are kept across updates. An unclipped path is swapped
+    // into clippedPaths_, take its buffer back. Reserving before resizing keeps the capacity.
+    QVector<QWorldPoint> &wrappedPath = wrappedPath_;
+    if (clippedPaths_.size() == 1 && clippedPaths_.at(0).capacity() > wrappedPath.capacity())
+        wrappedPath.swap(clippedPaths_[0]);
     wrappedPath.reserve(path.size());
-    QDoubleVector2D wrappedLeftBound(qInf(), qInf());
+    wrappedPath.resize(path.size());
+    clippedPaths_.resize(0);
+    QWorldPoint wrappedLeftBound(std::numeric_limits<qint64>::max(), std::numeric_limits<qint64>::max());
     // 1)
-    for (int i = 0; i < path.size(); ++i) {
-        const QDoubleVector2D &coord = path.at(i);
-        QDoubleVector2D wrappedProjection = map.geoProjection().wrapMapProjection(coord);
-
-        // We can get NaN if the map isn't set up correctly, or the projection
+    projection.wrapMapProjection(path.constData(), wrappedPath.data(), path.size());
+    for (QWorldPoint &wrappedProjection : wrappedPath) {
+        // We can get invalid points if the map isn't set up correctly, or the projection
         // is faulty -- probably best thing to do is abort
-        if (!qIsFinite(wrappedProjection.x()) || !qIsFinite(wrappedProjection.y()))
-            return QList<QList<QDoubleVector2D> >();
+        if (!wrappedProjection.isValid())
+            return clippedPaths_;
 
-        const bool isPointLessThanUnwrapBelowX = (wrappedProjection.x() < leftBoundWrapped.x());
         // unwrap x to preserve geometry if moved to border of map
-        if (preserveGeometry_ && isPointLessThanUnwrapBelowX) {
-            double distance = wrappedProjection.x() - unwrapBelowX;
-            if (distance < 0.0)
-                distance += 1.0;
-            wrappedProjection.setX(unwrapBelowX + distance);
-        }
+        if (preserveGeometry_ && wrappedProjection.x() < leftBound.x())
+            wrappedProjection.setX(wrappedProjection.x() + QWorldPoint::worldSize());
         if (wrappedProjection.x() < wrappedLeftBound.x() || (wrappedProjection.x() == wrappedLeftBound.x() && wrappedProjection.y() < wrappedLeftBound.y())) {
             wrappedLeftBound = wrappedProjection;
         }
-        wrappedPath.append(wrappedProjection);
     }
 
     // 2)
-    QList<QList<QDoubleVector2D> > clippedPaths;
-    const QList<QDoubleVector2D> &visibleRegion = map.geoProjection().projectableRegion();
-    if (visibleRegion.size()) {
-        c2t::clip2tri clipper;
-        clipper.addSubjectPath(QClipperUtils::qListToPath(wrappedPath), false);
-        clipper.addClipPolygon(QClipperUtils::qListToPath(visibleRegion));
-        Paths res = clipper.execute(c2t::clip2tri::Intersection);
-        clippedPaths = QClipperUtils::pathsToQList(res);
+    QVector<QVector<QWorldPoint> > &clippedPaths = clippedPaths_;
+    const QGeoClipRegion &clipRegion = projection.projectableClipRegion();
+    // Items entirely inside or outside of the region are decided from their bounds, only
+    // those crossing its border are clipped.
+    const QGeoClipRegion::Containment containment = clipRegion.classify(wrappedPath);
+    if (clipRegion.isEmpty()) {
+        clippedPaths.resize(1);
+        clippedPaths[0].swap(wrappedPath);
+    } else if (containment == QGeoClipRegion::Inside) {
+        // Nothing to clip: keep the path as it is so that its vertices still match the input,
+        // and use its westernmost point as origin, as 2.1) and 2.2) would.
+        leftBoundWrapped = wrappedLeftBound.toMercator();
+        clippedPaths.resize(1);
+        clippedPaths[0].swap(wrappedPath);
+    } else if (containment == QGeoClipRegion::Outside) {
+        srcPathClipped_ = true;
+        return clippedPaths;
+    } else {
+        srcPathClipped_ = true;
+        clipRegion.clipPolyline(wrappedPath, &clippedPaths);
 
         // 2.1) update srcOrigin_ and leftBoundWrapped with the point with minimum X
-        QDoubleVector2D lb(qInf(), qInf());
-        for (const QList<QDoubleVector2D> &path: clippedPaths) {
-            for (const QDoubleVector2D &p: path) {
-                if (p == leftBoundWrapped) {
+        QWorldPoint lb(std::numeric_limits<qint64>::max(), std::numeric_limits<qint64>::max());
+        for (const QVector<QWorldPoint> &path: clippedPaths) {
+            for (const QWorldPoint &p: path) {
+                if (p == leftBound) {
                     lb = p;
                     break;
                 } else if (p.x() < lb.x() || (p.x() == lb.x() && p.y() < lb.y())) {
@@ -247,22 +275,22 @@ QList<QList<QDoubleVector2D> > QGeoMapPolylineGeometry::clipPath(const QGeoMap &
                 }
             }
         }
-        if (qIsInf(lb.x()))
-            return QList<QList<QDoubleVector2D> >();
+        if (lb.x() == std::numeric_limits<qint64>::max()) {
+            clippedPaths.resize(0);
+            return clippedPaths;
+        }
 
-        // 2.2) Prevent the conversion to and from clipper from introducing negative offsets which
+        // 2.2) Prevent rounding the crossings from introducing negative offsets which
         //      in turn will make the geometry wrap around.
         lb.setX(qMax(wrappedLeftBound.x(), lb.x()));
-        leftBoundWrapped = lb;
-    } else {
-        clippedPaths.append(wrappedPath);
+        leftBoundWrapped = lb.toMercator();
     }
 
     return clippedPaths;
 }
 
 void QGeoMapPolylineGeometry::pathToScreen(const QGeoMap &map,
-                                           const QList<QList<QDoubleVector2D> > &clippedPaths,
+                                           const QVector<QVector<QWorldPoint> > &clippedPaths,
                                            const QDoubleVector2D &leftBoundWrapped)
 {
     // 3) project the resulting geometry to screen position and calculate screen bounds
@@ -271,43 +299,73 @@ void QGeoMapPolylineGeometry::pathToScreen(const QGeoMap &map,
     double maxX = -qInf();
     double maxY = -qInf();
 
+    srcPointIndices_.clear();
+    srcPointIndices_.reserve(srcPointTypes_.capacity());
+    strokeChunks_.clear();
+    strokeDirtyFrom_ = 0;
+    strokeHeadDirty_ = false;
+
     srcOrigin_ = map.geoProjection().mapProjectionToGeo(map.geoProjection().unwrapMapProjection(leftBoundWrapped));
     QDoubleVector2D origin = map.geoProjection().wrappedMapProjectionToItemPosition(leftBoundWrapped);
-    for (const QList<QDoubleVector2D> &path: clippedPaths) {
-        QDoubleVector2D lastAddedPoint;
+    srcOriginPosition_ = origin;
+    for (const QVector<QWorldPoint> &path: clippedPaths) {
+        const QVector<QDoubleVector2D> &positions = itemPositions(map, path);
         for (int i = 0; i < path.size(); ++i) {
-            QDoubleVector2D point = map.geoProjection().wrappedMapProjectionToItemPosition(path.at(i));
-
-            point = point - origin; // (0,0) if point == geoLeftBound_
+            QDoubleVector2D point = positions.at(i) - origin; // (0,0) if point == geoLeftBound_
 
             minX = qMin(point.x(), minX);
             minY = qMin(point.y(), minY);
             maxX = qMax(point.x(), maxX);
             maxY = qMax(point.y(), maxY);
 
-            if (i == 0) {
-                srcPoints_ << point.x() << point.y();
-                srcPointTypes_ << QPainterPath::MoveToElement;
-                lastAddedPoint = point;
-            } else {
-                if ((point - lastAddedPoint).manhattanLength() > 3 ||
-                        i == path.size() - 1) {
-                    srcPoints_ << point.x() << point.y();
-                    srcPointTypes_ << QPainterPath::LineToElement;
-                    lastAddedPoint = point;
-                }
-            }
+            appendSourcePoint(point, i, i == 0);
         }
     }
 
+    // Source points can only be matched to path indices if the path went through unclipped
+    if (srcPathClipped_ || clippedPaths.size() != 1)
+        srcPointIndices_.clear();
+    srcPathLength_ = srcPointIndices_.isEmpty() ? 0 : clippedPaths.first().size();
+
     sourceBounds_ = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
 }
 
+/*!
+    \internal
+*/
+void QGeoMapPolylineGeometry::appendSourcePoint(const QDoubleVector2D &point, int pathIndex, bool moveTo)
+{
+    if (moveTo) {
+        srcPoints_ << point.x() << point.y();
+        srcPointTypes_ << QPainterPath::MoveToElement;
+        srcPointIndices_ << pathIndex;
+        lastAddedPoint_ = point;
+        lastPointForced_ = false;
+        return;
+    }
+
+    // Points closer than 3 pixels to the last kept one are dropped, except for the last point of
+    // the path. Such a point is replaced as soon as another one is appended after it.
+    if (lastPointForced_) {
+        srcPoints_.resize(srcPoints_.size() - 2);
+        srcPointTypes_.removeLast();
+        srcPointIndices_.removeLast();
+    }
+
+    lastPointForced_ = (point - lastAddedPoint_).manhattanLength() <= 3;
+    if (!lastPointForced_)
+        lastAddedPoint_ = point;
+
+    srcPoints_ << point.x() << point.y();
+    srcPointTypes_ << QPainterPath::LineToElement;
+    srcPointIndices_ << pathIndex;
+}
+
 /*!
     \internal
 */
 void QGeoMapPolylineGeometry::updateSourcePoints(const QGeoMap &map,
-                                                 const QList<QDoubleVector2D> &path,
+                                                 const QVector<QWorldPoint> &path,
                                                  const QGeoCoordinate geoLeftBound)
 {
     if (!sourceDirty_)
@@ -323,19 +381,154 @@ void QGeoMapPolylineGeometry::updateSourcePoints(const QGeoMap &map,
 
     /*
      * Approach:
-     * 1) project coordinates to wrapped web mercator, and do unwrapBelowX
+     * 1) wrap the world points of the path, and do unwrapBelowX
      * 2) if the scene is tilted, clip the geometry against the visible region (this may generate multiple polygons)
      * 3) project the resulting geometry to screen position and calculate screen bounds
+     *
+     * The path stays in integer world coordinates until 3), which converts each point once.
      */
 
     QDoubleVector2D leftBoundWrapped;
     // 1, 2)
-    const QList<QList<QDoubleVector2D> > &clippedPaths = clipPath(map, path, leftBoundWrapped);
+    const QVector<QVector<QWorldPoint> > &clippedPaths = clipPath(map, path, leftBoundWrapped);
 
     // 3)
     pathToScreen(map, clippedPaths, leftBoundWrapped);
 }
 
+/*!
+    \internal
+
+    Applies the removal of \a removed points from the front of \a path and the addition of
+    \a added points to its end since the last update, without rebuilding the whole geometry.
+    \a path is the projected path after these changes.
+
+    Returns false if the change cannot be applied incrementally, because the geometry is
+    already dirty, the path had to be clipped, or one of the new points would need clipping
+    or change how the path is unwrapped. The geometry is left untouched in that case.
+*/
+bool QGeoMapPolylineGeometry::updateSourcePointsIncrementally(const QGeoMap &map,
+                                                              const QVector<QWorldPoint> &path,
+                                                              int removed, int added)
+{
+    if (sourceDirty_ || srcPointIndices_.isEmpty() || removed < 0 || added < 0
+            || removed >= srcPathLength_ || srcPathLength_ - removed + added != path.size())
+        return false;
+
+    const QGeoProjection &projection = map.geoProjection();
+    const QGeoClipRegion &clipRegion = projection.projectableClipRegion();
+    qint64 unwrapBelowX = unwrapBelowX_;
+
+    // Same as clipPath() and pathToScreen(), for a single point that must not need clipping
+    auto toSourcePoint = [&](const QWorldPoint &coord, bool extendLeftBound, QDoubleVector2D *point) -> bool {
+        QWorldPoint wrappedProjection;
+        projection.wrapMapProjection(&coord, &wrappedProjection, 1);
+        if (!wrappedProjection.isValid())
+            return false;
+        if (wrappedProjection.x() < unwrapBelowX) {
+            // A point slightly west of the left bound extends it, as a new bounding box would
+            if (extendLeftBound && unwrapBelowX - wrappedProjection.x() < QWorldPoint::worldSize() / 2)
+                unwrapBelowX = wrappedProjection.x();
+            else
+                wrappedProjection.setX(wrappedProjection.x() + QWorldPoint::worldSize());
+        }
+        if (!clipRegion.isEmpty() && !clipRegion.contains(wrappedProjection))
+            return false;
+        projection.wrappedMapProjectionToItemPosition(&wrappedProjection, point, 1);
+        *point -= srcOriginPosition_;
+        return true;
+    };
+
+    // Project everything first, so that nothing changes if a full update is needed
+    QDoubleVector2D head;
+    if (removed > 0 && !toSourcePoint(path.first(), false, &head))
+        return false;
+
+    QVector<QDoubleVector2D> tail;
+    tail.reserve(added);
+    for (int i = path.size() - added; i < path.size(); ++i) {
+        QDoubleVector2D point;
+        if (!toSourcePoint(path.at(i), true, &point))
+            return false;
+        tail << point;
+    }
+    unwrapBelowX_ = unwrapBelowX;
+
+    if (removed > 0) {
+        // srcPointIndices_[0] is 0, so at least one point is dropped
+        int drop = 0;
+        while (srcPointIndices_.at(drop) < removed)
+            ++drop;
+        if (srcPointIndices_.at(drop) != removed) {
+            // The new first point of the path was decimated, put it back
+            --drop;
+            srcPoints_[2 * drop] = head.x();
+            srcPoints_[2 * drop + 1] = head.y();
+            srcPointIndices_[drop] = removed;
+        }
+
+        srcPoints_.remove(0, 2 * drop);
+        srcPointTypes_.remove(0, drop);
+        srcPointIndices_.remove(0, drop);
+        srcPointTypes_[0] = QPainterPath::MoveToElement;
+        for (int &index : srcPointIndices_)
+            index -= removed;
+        if (srcPointTypes_.size() == 1) {
+            lastAddedPoint_ = head;
+            lastPointForced_ = false;
+        }
+
+        for (StrokeChunk &chunk : strokeChunks_) {
+            chunk.first -= drop;
+            chunk.last -= drop;
+        }
+        while (!strokeChunks_.isEmpty() && strokeChunks_.first().last < 1)
+            strokeChunks_.removeFirst();
+        if (!strokeChunks_.isEmpty()) {
+            strokeChunks_.first().first = 0;
+            strokeHeadDirty_ = true;
+        }
+        if (strokeDirtyFrom_ >= 0)
+            strokeDirtyFrom_ = qMax(0, strokeDirtyFrom_ - drop);
+
+        // The bounds can only shrink, recompute them from what is left
+        double minX = qInf();
+        double minY = qInf();
+        double maxX = -qInf();
+        double maxY = -qInf();
+        for (int i = 0; i < srcPoints_.size(); i += 2) {
+            minX = qMin(srcPoints_.at(i), minX);
+            minY = qMin(srcPoints_.at(i + 1), minY);
+            maxX = qMax(srcPoints_.at(i), maxX);
+            maxY = qMax(srcPoints_.at(i + 1), maxY);
+        }
+        sourceBounds_ = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+    }
+
+    if (added > 0) {
+        // A forced last point gets replaced by the first new one
+        const int firstChanged = srcPointTypes_.size() - (lastPointForced_ ? 1 : 0);
+        double minX = sourceBounds_.left();
+        double minY = sourceBounds_.top();
+        double maxX = sourceBounds_.right();
+        double maxY = sourceBounds_.bottom();
+        for (int i = 0; i < tail.size(); ++i) {
+            const QDoubleVector2D &point = tail.at(i);
+            minX = qMin(point.x(), minX);
+            minY = qMin(point.y(), minY);
+            maxX = qMax(point.x(), maxX);
+            maxY = qMax(point.y(), maxY);
+            appendSourcePoint(point, path.size() - added + i, false);
+        }
+        sourceBounds_ = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+        strokeDirtyFrom_ = strokeDirtyFrom_ < 0 ? firstChanged : qMin(strokeDirtyFrom_, firstChanged);
+    }
+
+    srcPathLength_ = path.size();
+    screenDirty_ = true;
+    return true;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 /*!
@@ -350,34 +543,148 @@ void QGeoMapPolylineGeometry::updateScreenPoints(const QGeoMap &map,
     QPointF origin = map.geoProjection().coordinateToItemPosition(srcOrigin_, false).toPointF();
 
     if (!qIsFinite(origin.x()) || !qIsFinite(origin.y()) || srcPointTypes_.size() < 2) { // the line might have been clipped away.
+        strokeChunks_.clear();
+        strokeDirtyFrom_ = 0;
+        strokeHeadDirty_ = false;
         clear();
         return;
     }
 
-    // Create the viewport rect in the same coordinate system
-    // as the actual points
-    QRectF viewport(0, 0, map.viewportWidth(), map.viewportHeight());
-    viewport.adjust(-strokeWidth, -strokeWidth, strokeWidth, strokeWidth);
-    viewport.translate(-1 * origin);
-
     // The geometry has already been clipped against the visible region projection in wrapped mercator space.
-    QVector<qreal> points = srcPoints_;
-    QVector<QPainterPath::ElementType> types = srcPointTypes_;
+    // It is stroked in chunks of StrokeChunkSize points overlapping by one, so that changes at
+    // either end of the path only need the chunks there to be stroked again. A chunk also
+    // depends on the points next to it, see strokeChunk().
+    if (strokeDirtyFrom_ < 0 && !strokeHeadDirty_)
+        strokeDirtyFrom_ = 0;
+
+    if (strokeHeadDirty_) {
+        for (int i = 0; i < qMin(2, strokeChunks_.size()); ++i)
+            strokeChunk(strokeChunks_[i], strokeWidth);
+    }
 
-    QVectorPath vp(points.data(), types.size(), types.data());
-    QTriangulatingStroker ts;
-    // viewport is not used in the call below.
-    ts.process(vp, QPen(QBrush(Qt::black), strokeWidth), viewport, QPainter::Qt4CompatiblePainting);
+    if (strokeDirtyFrom_ >= 0) {
+        // Also drop the last chunk if it is not full, so that appends keep filling it
+        while (!strokeChunks_.isEmpty()
+               && (strokeChunks_.last().last + 1 >= strokeDirtyFrom_
+                   || strokeChunks_.last().last - strokeChunks_.last().first + 1 < StrokeChunkSize)) {
+            strokeChunks_.removeLast();
+        }
+
+        const int count = srcPointTypes_.size();
+        int first = strokeChunks_.isEmpty() ? 0 : strokeChunks_.last().last;
+        if (first + 1 < count && srcPointTypes_.at(first + 1) == QPainterPath::MoveToElement)
+            ++first;
+        while (first < count - 1) {
+            StrokeChunk chunk;
+            chunk.first = first;
+            chunk.last = qMin(first + StrokeChunkSize - 1, count - 1);
+            // don't end a chunk on the start of the next subpath
+            if (srcPointTypes_.at(chunk.last) == QPainterPath::MoveToElement && chunk.last - 1 > chunk.first)
+                --chunk.last;
+            strokeChunk(chunk, strokeWidth);
+            strokeChunks_.append(chunk);
+
+            first = chunk.last;
+            if (first + 1 < count && srcPointTypes_.at(first + 1) == QPainterPath::MoveToElement)
+                ++first;
+        }
+    }
+    strokeDirtyFrom_ = -1;
+    strokeHeadDirty_ = false;
 
     clear();
 
+    int vertexCount = 0;
+    for (const StrokeChunk &chunk : qAsConst(strokeChunks_))
+        vertexCount += chunk.vertices.size() + 2;
+
     // Nothing is on the screen
-    if (ts.vertexCount() == 0)
+    if (vertexCount == 2 * strokeChunks_.size())
         return;
 
+    screenVertices_.reserve(vertexCount);
+
+    QRectF bb;
+    for (const StrokeChunk &chunk : qAsConst(strokeChunks_)) {
+        if (chunk.vertices.isEmpty())
+            continue;
+
+        // Join the triangle strips of consecutive chunks with degenerate triangles
+        if (!screenVertices_.isEmpty())
+            screenVertices_ << screenVertices_.last() << chunk.vertices.first();
+        screenVertices_ += chunk.vertices;
+
+        bb.setLeft(qMin(bb.left(), chunk.bounds.left()));
+        bb.setRight(qMax(bb.right(), chunk.bounds.right()));
+        bb.setTop(qMin(bb.top(), chunk.bounds.top()));
+        bb.setBottom(qMax(bb.bottom(), chunk.bounds.bottom()));
+    }
+
+    screenBounds_ = bb;
+    this->translate( -1 * sourceBounds_.topLeft());
+}
+
+/*!
+    \internal
+*/
+void QGeoMapPolylineGeometry::strokeChunk(StrokeChunk &chunk, qreal strokeWidth) const
+{
+    // A chunk is stroked together with the segments joining it to its neighbours, so that
+    // its ends get the same joins as a line stroked in one piece. Flat caps keep these
+    // segments from sticking out of the neighbours; the square caps of the actual ends of
+    // the line are made by extending it by half the width.
+    const int pathCount = srcPointTypes_.size();
+    const bool joinsPrevious = srcPointTypes_.at(chunk.first) != QPainterPath::MoveToElement;
+    const bool joinsNext = chunk.last + 1 < pathCount
+            && srcPointTypes_.at(chunk.last + 1) != QPainterPath::MoveToElement;
+    const int from = chunk.first - (joinsPrevious ? 1 : 0);
+    const int count = chunk.last + (joinsNext ? 1 : 0) - from + 1;
+
+    QVarLengthArray<qreal, 2 * (StrokeChunkSize + 2)> points(2 * count);
+    QVarLengthArray<QPainterPath::ElementType, StrokeChunkSize + 2> types(count);
+    for (int i = 0; i < count; ++i) {
+        points[2 * i] = srcPoints_.at(2 * (from + i));
+        points[2 * i + 1] = srcPoints_.at(2 * (from + i) + 1);
+        types[i] = srcPointTypes_.at(from + i);
+    }
+    types[0] = QPainterPath::MoveToElement;
+
+    const qreal halfWidth = strokeWidth / 2;
+    auto extend = [&](int end, int inner) {
+        const qreal dx = points[2 * end] - points[2 * inner];
+        const qreal dy = points[2 * end + 1] - points[2 * inner + 1];
+        const qreal length = qSqrt(dx * dx + dy * dy);
+        if (length <= 0)
+            return;
+        points[2 * end] += dx * halfWidth / length;
+        points[2 * end + 1] += dy * halfWidth / length;
+    };
+    for (int start = 0; start < count; ) {
+        int end = start + 1;
+        while (end < count && types[end] != QPainterPath::MoveToElement)
+            ++end;
+        --end;
+        if (end > start) {
+            if (start > 0 || !joinsPrevious)
+                extend(start, start + 1);
+            if (end < count - 1 || !joinsNext)
+                extend(end, end - 1);
+        }
+        start = end + 1;
+    }
+
+    QVectorPath vp(points.constData(), count, types.constData());
+    QTriangulatingStroker ts;
+    // viewport is not used in the call below.
+    ts.process(vp, QPen(QBrush(Qt::black), strokeWidth, Qt::SolidLine, Qt::FlatCap), QRectF(),
+               QPainter::Qt4CompatiblePainting);
+
+    chunk.vertices.clear();
+    chunk.bounds = QRectF();
+
     // QTriangulatingStroker#vertexCount is actually the length of the array,
     // not the number of vertices
-    screenVertices_.reserve(ts.vertexCount());
+    chunk.vertices.reserve(ts.vertexCount() / 2);
 
     QRectF bb;
 
@@ -385,7 +692,7 @@ void QGeoMapPolylineGeometry::updateScreenPoints(const QGeoMap &map,
     const float *vs = ts.vertices();
     for (int i = 0; i < (ts.vertexCount()/2*2); i += 2) {
         pt = QPointF(vs[i], vs[i + 1]);
-        screenVertices_ << pt;
+        chunk.vertices << pt;
 
         if (!qIsFinite(pt.x()) || !qIsFinite(pt.y()))
             break;
@@ -405,12 +712,12 @@ void QGeoMapPolylineGeometry::updateScreenPoints(const QGeoMap &map,
         }
     }
 
-    screenBounds_ = bb;
-    this->translate( -1 * sourceBounds_.topLeft());
+    chunk.bounds = bb;
 }
 
 QDeclarativePolylineMapItem::QDeclarativePolylineMapItem(QQuickItem *parent)
-:   QDeclarativeGeoMapItemBase(parent), line_(this), dirtyMaterial_(true), updatingGeometry_(false)
+:   QDeclarativeGeoMapItemBase(parent), line_(this), dirtyMaterial_(true), updatingGeometry_(false),
+    maximumPathLength_(0), pendingRemoved_(0), pendingAdded_(0)
 {
     setFlag(ItemHasContents, true);
     QObject::connect(&line_, SIGNAL(colorChanged(QColor)),
@@ -451,6 +758,11 @@ void QDeclarativePolylineMapItem::setMap(QDeclarativeGeoMap *quickMap, QGeoMap *
 
     This property holds the ordered list of coordinates which
     define the polyline.
+
+    A Float64Array, or an ArrayBuffer, of latitude and longitude pairs can
+    also be assigned to it.
+
+    \sa geoPath, packedPath
 */
 
 QJSValue QDeclarativePolylineMapItem::path() const
@@ -473,6 +785,17 @@ QJSValue QDeclarativePolylineMapItem::path() const
 
 void QDeclarativePolylineMapItem::setPath(const QJSValue &value)
 {
+    if (isPackedCoordinates(value)) {
+        bool ok;
+        const QList<QGeoCoordinate> pathList = parsePackedCoordinates(value, &ok);
+        if (!ok) {
+            qmlWarning(this) << "Unsupported path type";
+            return;
+        }
+        setPathFromGeoList(pathList);
+        return;
+    }
+
     if (!value.isArray())
         return;
 
@@ -493,15 +816,73 @@ void QDeclarativePolylineMapItem::setPath(const QJSValue &value)
     setPathFromGeoList(pathList);
 }
 
+/*!
+    \qmlproperty geopath MapPolyline::geoPath
+
+    This property holds the path of the polyline as a \l {geopath}.
+
+    Unlike \l path, reading or writing it does not convert each coordinate
+    to or from a JavaScript object, and assigning the geopath of another item,
+    such as \l {QtLocation::Route::geoPath}{Route.geoPath}, shares its
+    coordinates instead of copying them.
+
+    \since Qt Location 5.9.6
+*/
+QGeoPath QDeclarativePolylineMapItem::geoPath() const
+{
+    return geopath_;
+}
+
+void QDeclarativePolylineMapItem::setGeoPath(const QGeoPath &path)
+{
+    if (maximumPathLength_ > 0 && path.path().length() > maximumPathLength_) {
+        setPathFromGeoList(path.path());
+        return;
+    }
+    if (geopath_.path() == path.path())
+        return;
+
+    geopath_ = path;
+
+    regenerateCache();
+    geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
+    markSourceDirtyAndUpdate();
+    emit pathChanged();
+}
+
+/*!
+    \qmlmethod ArrayBuffer MapPolyline::packedPath()
+
+    Returns the path as an ArrayBuffer of latitude and longitude pairs stored as
+    64-bit floating point numbers, suitable for a Float64Array. Such a buffer,
+    or a Float64Array over it, can also be assigned to \l path. This is much
+    faster than exchanging long paths as arrays of coordinates.
+
+    \code
+    var latLon = new Float64Array(mapPolyline.packedPath())
+    latLon[0] += 0.5
+    mapPolyline.path = latLon
+    \endcode
+
+    \since Qt Location 5.9.6
+*/
+QByteArray QDeclarativePolylineMapItem::packedPath() const
+{
+    return packCoordinates(geopath_.path());
+}
+
 /*!
     \internal
 */
 void QDeclarativePolylineMapItem::setPathFromGeoList(const QList<QGeoCoordinate> &path)
 {
-    if (geopath_.path() == path)
+    // Only the most recent coordinates are kept, as in addCoordinate()
+    const int excess = maximumPathLength_ > 0 ? path.length() - maximumPathLength_ : 0;
+    const QList<QGeoCoordinate> kept = excess > 0 ? path.mid(excess) : path;
+    if (geopath_.path() == kept)
         return;
 
-    geopath_.setPath(path);
+    geopath_.setPath(kept);
 
     regenerateCache();
     geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
@@ -538,8 +919,17 @@ void QDeclarativePolylineMapItem::addCoordinate(const QGeoCoordinate &coordinate
     geopath_.addCoordinate(coordinate);
 
     updateCache();
-    geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
-    markSourceDirtyAndUpdate();
+    const int removed = trimPath();
+
+    if (map() && !geometry_.isSourceDirty()) {
+        // extend the current geometry in updatePolish() rather than rebuilding it
+        pendingRemoved_ += removed;
+        ++pendingAdded_;
+        polishAndUpdate();
+    } else {
+        geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
+        markSourceDirtyAndUpdate();
+    }
     emit pathChanged();
 }
 
@@ -558,6 +948,7 @@ void QDeclarativePolylineMapItem::insertCoordinate(int index, const QGeoCoordina
         return;
 
     geopath_.insertCoordinate(index, coordinate);
+    trimPath();
 
     regenerateCache();
     geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
@@ -682,6 +1073,37 @@ QDeclarativeMapLineProperties *QDeclarativePolylineMapItem::line()
     return &line_;
 }
 
+/*!
+    \qmlproperty int MapPolyline::maximumPathLength
+
+    This property holds the maximum number of coordinates kept in the \l path.
+    When \l addCoordinate makes the path longer than this, the oldest coordinates are
+    removed from its start, so that the polyline shows a rolling track of the most recent
+    positions. Paths assigned or grown in other ways are shortened the same way, as is the
+    current path when this property is set to a value smaller than \l pathLength().
+
+    The default value is 0, which means the path length is not limited.
+
+    \since Qt Location 5.9.6
+*/
+int QDeclarativePolylineMapItem::maximumPathLength() const
+{
+    return maximumPathLength_;
+}
+
+void QDeclarativePolylineMapItem::setMaximumPathLength(int length)
+{
+    length = qMax(0, length);
+    if (maximumPathLength_ == length)
+        return;
+
+    maximumPathLength_ = length;
+    emit maximumPathLengthChanged();
+
+    if (maximumPathLength_ > 0 && geopath_.path().length() > maximumPathLength_)
+        setPathFromGeoList(geopath_.path());
+}
+
 /*!
     \internal
 */
@@ -730,10 +1152,11 @@ void QDeclarativePolylineMapItem::regenerateCache()
 {
     if (!map())
         return;
-    geopathProjected_.clear();
-    geopathProjected_.reserve(geopath_.path().size());
-    for (const QGeoCoordinate &c : geopath_.path())
-        geopathProjected_ << map()->geoProjection().geoToMapProjection(c);
+    // Projected once per path change, the geometry then works on the world points
+    const QVector<QGeoCoordinate> path = geopath_.path().toVector();
+    QVector<QDoubleVector2D> projected(path.size());
+    map()->geoProjection().geoToMapProjection(path.constData(), projected.data(), path.size());
+    QWorldPoint::fromMercator(projected, &geopathProjected_);
 }
 
 /*!
@@ -743,7 +1166,30 @@ void QDeclarativePolylineMapItem::updateCache()
 {
     if (!map())
         return;
-    geopathProjected_ << map()->geoProjection().geoToMapProjection(geopath_.path().last());
+    // Same conversion as regenerateCache(), for results independent of how the path was built
+    QDoubleVector2D projected;
+    map()->geoProjection().geoToMapProjection(&geopath_.path().last(), &projected, 1);
+    geopathProjected_ << QWorldPoint::fromMercator(projected);
+}
+
+/*!
+    \internal
+
+    Removes coordinates from the start of the path until it is no longer than
+    maximumPathLength, and returns how many were removed.
+*/
+int QDeclarativePolylineMapItem::trimPath()
+{
+    int removed = 0;
+    while (maximumPathLength_ > 0 && geopath_.path().length() > maximumPathLength_) {
+        geopath_.removeCoordinate(0);
+        ++removed;
+    }
+    /* the projected cache is contiguous, drop the whole prefix in one go */
+    const int projectedRemoved = qMin(removed, geopathProjected_.size());
+    if (projectedRemoved > 0)
+        geopathProjected_.erase(geopathProjected_.begin(), geopathProjected_.begin() + projectedRemoved);
+    return removed;
 }
 
 /*!
@@ -751,12 +1197,20 @@ void QDeclarativePolylineMapItem::updateCache()
 */
 void QDeclarativePolylineMapItem::updatePolish()
 {
+    const int removed = pendingRemoved_;
+    const int added = pendingAdded_;
+    pendingRemoved_ = pendingAdded_ = 0;
+
     if (!map() || geopath_.path().length() == 0)
         return;
 
     QScopedValueRollback<bool> rollback(updatingGeometry_);
     updatingGeometry_ = true;
 
+    if ((removed || added) && !geometry_.updateSourcePointsIncrementally(*map(), geopathProjected_, removed, added)) {
+        geometry_.setPreserveGeometry(true, geopath_.boundingGeoRectangle().topLeft());
+        geometry_.markSourceDirty();
+    }
     geometry_.updateSourcePoints(*map(), geopathProjected_, geopath_.boundingGeoRectangle().topLeft());
     geometry_.updateScreenPoints(*map(), line_.width());
 
@@ -795,6 +1249,15 @@ QSGNode *QDeclarativePolylineMapItem::updateMapItemPaintNode(QSGNode *oldNode, U
     return node;
 }
 
+/*!
+    \internal
+*/
+void QDeclarativePolylineMapItem::updateMapItemBatch(QGeoMapItemBatch *batch)
+{
+    addToMapItemBatch(batch, geometry_, line_.color(), QSGGeometry::DrawTriangleStrip);
+    dirtyMaterial_ = false;
+}
+
 bool QDeclarativePolylineMapItem::contains(const QPointF &point) const
 {
     QVector<QPointF> vertices = geometry_.vertices();
@@ -85,31 +85,64 @@ private:
     QColor color_;
 };
 
-class QGeoMapPolylineGeometry : public QGeoMapItemGeometry
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapPolylineGeometry : public QGeoMapItemGeometry
 {
 public:
     QGeoMapPolylineGeometry();
 
     void updateSourcePoints(const QGeoMap &map,
-                            const QList<QDoubleVector2D> &path,
+                            const QVector<QWorldPoint> &path,
                             const QGeoCoordinate geoLeftBound);
 
+    bool updateSourcePointsIncrementally(const QGeoMap &map,
+                                         const QVector<QWorldPoint> &path,
+                                         int removed, int added);
+
     void updateScreenPoints(const QGeoMap &map,
                             qreal strokeWidth);
 
 protected:
-    QList<QList<QDoubleVector2D> > clipPath(const QGeoMap &map,
-                    const QList<QDoubleVector2D> &path,
+    const QVector<QVector<QWorldPoint> > &clipPath(const QGeoMap &map,
+                    const QVector<QWorldPoint> &path,
                     QDoubleVector2D &leftBoundWrapped);
 
     void pathToScreen(const QGeoMap &map,
-                      const QList<QList<QDoubleVector2D> > &clippedPaths,
+                      const QVector<QVector<QWorldPoint> > &clippedPaths,
                       const QDoubleVector2D &leftBoundWrapped);
 
 private:
+    struct StrokeChunk
+    {
+        int first;
+        int last;
+        QVector<QPointF> vertices;
+        QRectF bounds;
+    };
+
+    void appendSourcePoint(const QDoubleVector2D &point, int pathIndex, bool moveTo);
+    void strokeChunk(StrokeChunk &chunk, qreal strokeWidth) const;
+
     QVector<qreal> srcPoints_;
     QVector<QPainterPath::ElementType> srcPointTypes_;
 
+    // scratch buffers reused by every clipPath()
+    QVector<QWorldPoint> wrappedPath_;
+    QVector<QVector<QWorldPoint> > clippedPaths_;
+
+    // State kept from the last full update so that appends and trims at the
+    // ends of an unclipped path can be applied without rebuilding it.
+    QVector<int> srcPointIndices_;
+    bool srcPathClipped_;
+    int srcPathLength_;
+    qint64 unwrapBelowX_;
+    QDoubleVector2D srcOriginPosition_;
+    QDoubleVector2D lastAddedPoint_;
+    bool lastPointForced_;
+
+    QVector<StrokeChunk> strokeChunks_;
+    int strokeDirtyFrom_;
+    bool strokeHeadDirty_;
+
     friend class QDeclarativeCircleMapItem;
     friend class QDeclarativePolygonMapItem;
     friend class QDeclarativeRectangleMapItem;
@@ -120,7 +153,9 @@ class Q_LOCATION_PRIVATE_EXPORT QDeclarativePolylineMapItem : public QDeclarativ
     Q_OBJECT
 
     Q_PROPERTY(QJSValue path READ path WRITE setPath NOTIFY pathChanged)
+    Q_PROPERTY(QGeoPath geoPath READ geoPath WRITE setGeoPath NOTIFY pathChanged)
     Q_PROPERTY(QDeclarativeMapLineProperties *line READ line CONSTANT)
+    Q_PROPERTY(int maximumPathLength READ maximumPathLength WRITE setMaximumPathLength NOTIFY maximumPathLengthChanged)
 
 public:
     explicit QDeclarativePolylineMapItem(QQuickItem *parent = 0);
@@ -129,6 +164,7 @@ public:
     virtual void setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map) Q_DECL_OVERRIDE;
        //from QuickItem
     virtual QSGNode *updateMapItemPaintNode(QSGNode *, UpdatePaintNodeData *) Q_DECL_OVERRIDE;
+    void updateMapItemBatch(QGeoMapItemBatch *batch) Q_DECL_OVERRIDE;
 
     Q_INVOKABLE int pathLength() const;
     Q_INVOKABLE void addCoordinate(const QGeoCoordinate &coordinate);
@@ -138,18 +174,26 @@ public:
     Q_INVOKABLE bool containsCoordinate(const QGeoCoordinate &coordinate);
     Q_INVOKABLE void removeCoordinate(const QGeoCoordinate &coordinate);
     Q_INVOKABLE void removeCoordinate(int index);
+    Q_INVOKABLE QByteArray packedPath() const;
 
     QJSValue path() const;
     virtual void setPath(const QJSValue &value);
 
+    QGeoPath geoPath() const;
+    virtual void setGeoPath(const QGeoPath &path);
+
     bool contains(const QPointF &point) const Q_DECL_OVERRIDE;
     const QGeoShape &geoShape() const Q_DECL_OVERRIDE;
     QGeoMap::ItemType itemType() const Q_DECL_OVERRIDE;
 
     QDeclarativeMapLineProperties *line();
 
+    int maximumPathLength() const;
+    void setMaximumPathLength(int length);
+
 Q_SIGNALS:
     void pathChanged();
+    void maximumPathLengthChanged();
 
 protected:
     void geometryChanged(const QRectF &newGeometry, const QRectF &oldGeometry) Q_DECL_OVERRIDE;
@@ -164,14 +208,18 @@ protected Q_SLOTS:
 private:
     void regenerateCache();
     void updateCache();
+    int trimPath();
 
     QGeoPath geopath_;
-    QList<QDoubleVector2D> geopathProjected_;
+    QVector<QWorldPoint> geopathProjected_;
     QDeclarativeMapLineProperties line_;
     QColor color_;
     bool dirtyMaterial_;
     QGeoMapPolylineGeometry geometry_;
     bool updatingGeometry_;
+    int maximumPathLength_;
+    int pendingRemoved_;
+    int pendingAdded_;
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -256,7 +256,7 @@ QSGNode *QDeclarativeRectangleMapItem::updateMapItemPaintNode(QSGNode *oldNode,
     }
 
     //TODO: update only material
-    if (geometry_.isScreenDirty() || borderGeometry_.isScreenDirty() || dirtyMaterial_) {
+    if (geometry_.isScreenDirty() || borderGeometry_.isScreenDirty() || dirtyMaterial_ || !oldNode) {
         node->update(color_, border_.color(), &geometry_, &borderGeometry_);
         geometry_.setPreserveGeometry(false);
         borderGeometry_.setPreserveGeometry(false);
@@ -267,6 +267,16 @@ QSGNode *QDeclarativeRectangleMapItem::updateMapItemPaintNode(QSGNode *oldNode,
     return node;
 }
 
+/*!
+    \internal
+*/
+void QDeclarativeRectangleMapItem::updateMapItemBatch(QGeoMapItemBatch *batch)
+{
+    addToMapItemBatch(batch, geometry_, color_, QSGGeometry::DrawTriangles);
+    addToMapItemBatch(batch, borderGeometry_, border_.color(), QSGGeometry::DrawTriangleStrip);
+    dirtyMaterial_ = false;
+}
+
 /*!
     \internal
 */
@@ -279,7 +289,7 @@ void QDeclarativeRectangleMapItem::updatePolish()
     updatingGeometry_ = true;
 
     geometry_.setPreserveGeometry(true, rectangle_.topLeft());
-    geometry_.updateSourcePoints(*map(), pathMercator_);
+    geometry_.updateSourcePoints(*map(), pathWorld_);
     geometry_.updateScreenPoints(*map());
 
     QList<QGeoMapItemGeometry *> geoms;
@@ -287,7 +297,7 @@ void QDeclarativeRectangleMapItem::updatePolish()
     borderGeometry_.clear();
 
     if (border_.color() != Qt::transparent && border_.width() > 0) {
-        QList<QDoubleVector2D> closedPath = pathMercator_;
+        QVector<QWorldPoint> closedPath = pathWorld_;
         closedPath << closedPath.first();
 
         borderGeometry_.setPreserveGeometry(true, rectangle_.topLeft());
@@ -297,7 +307,7 @@ void QDeclarativeRectangleMapItem::updatePolish()
         borderGeometry_.srcPointTypes_.clear();
 
         QDoubleVector2D borderLeftBoundWrapped;
-        QList<QList<QDoubleVector2D > > clippedPaths = borderGeometry_.clipPath(*map(), closedPath, borderLeftBoundWrapped);
+        const QVector<QVector<QWorldPoint> > &clippedPaths = borderGeometry_.clipPath(*map(), closedPath, borderLeftBoundWrapped);
         if (clippedPaths.size()) {
             borderLeftBoundWrapped = map()->geoProjection().geoToWrappedMapProjection(geometryOrigin);
             borderGeometry_.pathToScreen(*map(), clippedPaths, borderLeftBoundWrapped);
@@ -354,13 +364,15 @@ void QDeclarativeRectangleMapItem::updatePath()
 {
     if (!map())
         return;
-    pathMercator_.clear();
-    pathMercator_ << map()->geoProjection().geoToMapProjection(rectangle_.topLeft());
-    pathMercator_ << map()->geoProjection().geoToMapProjection(
-                         QGeoCoordinate(rectangle_.topLeft().latitude(), rectangle_.bottomRight().longitude()));
-    pathMercator_ << map()->geoProjection().geoToMapProjection(rectangle_.bottomRight());
-    pathMercator_ << map()->geoProjection().geoToMapProjection(
-                         QGeoCoordinate(rectangle_.bottomRight().latitude(), rectangle_.topLeft().longitude()));
+    const QGeoProjection &projection = map()->geoProjection();
+    pathWorld_.clear();
+    pathWorld_.reserve(4);
+    pathWorld_ << QWorldPoint::fromMercator(projection.geoToMapProjection(rectangle_.topLeft()));
+    pathWorld_ << QWorldPoint::fromMercator(projection.geoToMapProjection(
+                         QGeoCoordinate(rectangle_.topLeft().latitude(), rectangle_.bottomRight().longitude())));
+    pathWorld_ << QWorldPoint::fromMercator(projection.geoToMapProjection(rectangle_.bottomRight()));
+    pathWorld_ << QWorldPoint::fromMercator(projection.geoToMapProjection(
+                         QGeoCoordinate(rectangle_.bottomRight().latitude(), rectangle_.topLeft().longitude())));
 }
 
 /*!
@@ -76,6 +76,7 @@ public:
     virtual void setMap(QDeclarativeGeoMap *quickMap, QGeoMap *map) Q_DECL_OVERRIDE;
     //from QuickItem
     virtual QSGNode *updateMapItemPaintNode(QSGNode *, UpdatePaintNodeData *) Q_DECL_OVERRIDE;
+    void updateMapItemBatch(QGeoMapItemBatch *batch) Q_DECL_OVERRIDE;
 
     QGeoCoordinate topLeft();
     void setTopLeft(const QGeoCoordinate &center);
@@ -114,7 +115,7 @@ private:
     QGeoMapPolygonGeometry geometry_;
     QGeoMapPolylineGeometry borderGeometry_;
     bool updatingGeometry_;
-    QList<QDoubleVector2D> pathMercator_;
+    QVector<QWorldPoint> pathWorld_;
 };
 
 //////////////////////////////////////////////////////////////////////
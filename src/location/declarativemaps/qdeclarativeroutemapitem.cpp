@@ -145,4 +145,16 @@ void QDeclarativeRouteMapItem::setPath(const QJSValue &value)
                << "Please use the route property instead.";
 }
 
+/*!
+   \internal
+
+   Used to disable the geoPath property on the RouteMapItem
+ */
+void QDeclarativeRouteMapItem::setGeoPath(const QGeoPath &path)
+{
+    Q_UNUSED(path);
+    qWarning() << "Can not set the path on QDeclarativeRouteMapItem."
+               << "Please use the route property instead.";
+}
+
 QT_END_NAMESPACE
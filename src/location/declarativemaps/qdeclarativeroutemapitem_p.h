@@ -80,6 +80,7 @@ private slots:
 
 protected:
     void setPath(const QJSValue &value) Q_DECL_OVERRIDE;
+    void setGeoPath(const QGeoPath &path) Q_DECL_OVERRIDE;
 
 private:
     QDeclarativeGeoRoute *route_;
@@ -0,0 +1,269 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapitembatch_p.h"
+#include "qgeomapitemgeometry_p.h"
+
+#include <algorithm>
+#include <cstring>
+
+QT_BEGIN_NAMESPACE
+
+QGeoMapItemBatch::QGeoMapItemBatch(QGeoMap::ItemType itemType)
+    : itemType_(itemType), unusedVertices_(0), dirtyBegin_(0), dirtyEnd_(0), resized_(false),
+      item_(0), opacity_(1.0)
+{
+}
+
+QGeoMapItemBatch::~QGeoMapItemBatch()
+{
+}
+
+QGeoMap::ItemType QGeoMapItemBatch::itemType() const
+{
+    return itemType_;
+}
+
+/*!
+    \internal
+
+    Starts collecting the triangles of \a item, whose geometry is translated
+    by \a offset into map coordinates. The colors of the item are multiplied
+    by \a opacity.
+*/
+void QGeoMapItemBatch::beginItem(const void *item, const QPointF &offset, qreal opacity)
+{
+    item_ = item;
+    offset_ = offset;
+    opacity_ = opacity;
+    itemVertices_.resize(0);
+}
+
+/*!
+    \internal
+
+    Adds the screen triangles of \a geometry, drawn with \a drawingMode, to
+    the current item. Strips are unrolled to triangles so that all the items
+    share one draw call.
+*/
+void QGeoMapItemBatch::addGeometry(const QGeoMapItemGeometry &geometry, const QColor &color,
+                                   QSGGeometry::DrawingMode drawingMode)
+{
+    const qreal alpha = color.alphaF() * opacity_;
+    if (geometry.size() == 0 || alpha <= 0.0)
+        return;
+
+    // QSGVertexColorMaterial expects premultiplied colors
+    const uchar r = uchar(qRound(color.redF() * alpha * 255));
+    const uchar g = uchar(qRound(color.greenF() * alpha * 255));
+    const uchar b = uchar(qRound(color.blueF() * alpha * 255));
+    const uchar a = uchar(qRound(alpha * 255));
+
+    const QVector<QPointF> vertices = geometry.vertices();
+    const QVector<quint32> indices = geometry.indices();
+    const bool indexed = geometry.isIndexed();
+    const int count = indexed ? indices.size() : vertices.size();
+
+    auto appendVertex = [&](int i) {
+        const QPointF &p = vertices.at(indexed ? int(indices.at(i)) : i);
+        QSGGeometry::ColoredPoint2D v;
+        v.set(p.x() + offset_.x(), p.y() + offset_.y(), r, g, b, a);
+        itemVertices_.append(v);
+    };
+
+    if (drawingMode == QSGGeometry::DrawTriangleStrip) {
+        itemVertices_.reserve(itemVertices_.size() + 3 * qMax(0, count - 2));
+        for (int i = 2; i < count; ++i) {
+            appendVertex(i - 2);
+            appendVertex(i - 1);
+            appendVertex(i);
+        }
+    } else {
+        itemVertices_.reserve(itemVertices_.size() + count);
+        for (int i = 0; i < count; ++i)
+            appendVertex(i);
+    }
+}
+
+/*!
+    \internal
+
+    Stores the triangles collected since beginItem(). They overwrite the
+    range of the item when their count did not change, and are appended
+    otherwise.
+*/
+void QGeoMapItemBatch::endItem()
+{
+    QMutexLocker locker(&mutex_);
+
+    const int count = itemVertices_.size();
+    QHash<const void *, Range>::iterator it = ranges_.find(item_);
+    if (it != ranges_.end() && it->count == count) {
+        std::copy(itemVertices_.constBegin(), itemVertices_.constEnd(), vertices_.begin() + it->offset);
+        markDirty(it->offset, it->offset + count);
+    } else {
+        if (it != ranges_.end()) {
+            releaseRange(*it);
+            ranges_.erase(it);
+        }
+        if (count > 0) {
+            const Range range = { vertices_.size(), count };
+            ranges_.insert(item_, range);
+            vertices_ += itemVertices_;
+            resized_ = true;
+        }
+        if (unusedVertices_ > vertices_.size() / 2)
+            compact();
+    }
+
+    item_ = 0;
+}
+
+void QGeoMapItemBatch::removeItem(const void *item)
+{
+    QMutexLocker locker(&mutex_);
+
+    QHash<const void *, Range>::iterator it = ranges_.find(item);
+    if (it == ranges_.end())
+        return;
+
+    releaseRange(*it);
+    ranges_.erase(it);
+    if (unusedVertices_ > vertices_.size() / 2)
+        compact();
+}
+
+/*!
+    \internal
+
+    Copies the changes since the last call into \a geometry. Returns false if
+    there were none.
+*/
+bool QGeoMapItemBatch::updateGeometry(QSGGeometry *geometry)
+{
+    QMutexLocker locker(&mutex_);
+
+    if (resized_ || geometry->vertexCount() != vertices_.size()) {
+        geometry->allocate(vertices_.size());
+        std::memcpy(geometry->vertexDataAsColoredPoint2D(), vertices_.constData(),
+                    vertices_.size() * sizeof(QSGGeometry::ColoredPoint2D));
+    } else if (dirtyEnd_ > dirtyBegin_) {
+        std::memcpy(geometry->vertexDataAsColoredPoint2D() + dirtyBegin_, vertices_.constData() + dirtyBegin_,
+                    (dirtyEnd_ - dirtyBegin_) * sizeof(QSGGeometry::ColoredPoint2D));
+    } else {
+        return false;
+    }
+
+    resized_ = false;
+    dirtyBegin_ = dirtyEnd_ = 0;
+    geometry->markVertexDataDirty();
+    return true;
+}
+
+/* Degenerates the triangles of a range, so that they draw nothing until the
+   next compaction */
+void QGeoMapItemBatch::releaseRange(const Range &range)
+{
+    QSGGeometry::ColoredPoint2D empty;
+    empty.set(0, 0, 0, 0, 0, 0);
+    std::fill(vertices_.begin() + range.offset, vertices_.begin() + range.offset + range.count, empty);
+    markDirty(range.offset, range.offset + range.count);
+    unusedVertices_ += range.count;
+}
+
+void QGeoMapItemBatch::markDirty(int begin, int end)
+{
+    if (dirtyEnd_ > dirtyBegin_) {
+        dirtyBegin_ = qMin(dirtyBegin_, begin);
+        dirtyEnd_ = qMax(dirtyEnd_, end);
+    } else {
+        dirtyBegin_ = begin;
+        dirtyEnd_ = end;
+    }
+}
+
+/* Drops the released ranges, keeping the items in their drawing order */
+void QGeoMapItemBatch::compact()
+{
+    QVector<QPair<int, const void *> > order;
+    order.reserve(ranges_.size());
+    for (QHash<const void *, Range>::const_iterator it = ranges_.constBegin(); it != ranges_.constEnd(); ++it)
+        order.append(qMakePair(it->offset, it.key()));
+    std::sort(order.begin(), order.end());
+
+    QVector<QSGGeometry::ColoredPoint2D> vertices;
+    vertices.reserve(vertices_.size() - unusedVertices_);
+    for (const QPair<int, const void *> &entry : qAsConst(order)) {
+        Range &range = ranges_[entry.second];
+        const int offset = vertices.size();
+        vertices.resize(offset + range.count);
+        std::copy(vertices_.constBegin() + range.offset, vertices_.constBegin() + range.offset + range.count,
+                  vertices.begin() + offset);
+        range.offset = offset;
+    }
+
+    vertices_.swap(vertices);
+    unusedVertices_ = 0;
+    resized_ = true;
+}
+
+QGeoMapItemBatchNode::QGeoMapItemBatchNode(const QSharedPointer<QGeoMapItemBatch> &batch)
+    : batch_(batch), geometry_(QSGGeometry::defaultAttributes_ColoredPoint2D(), 0)
+{
+    geometry_.setDrawingMode(QSGGeometry::DrawTriangles);
+    geometry_.setVertexDataPattern(QSGGeometry::DynamicPattern);
+    setGeometry(&geometry_);
+    setMaterial(&material_);
+    setFlag(UsePreprocess);
+}
+
+QGeoMapItemBatchNode::~QGeoMapItemBatchNode()
+{
+}
+
+/*!
+    \internal
+
+    Runs after all the items were synchronized, so changes made by items in
+    any order are uploaded in the same frame.
+*/
+void QGeoMapItemBatchNode::preprocess()
+{
+    if (batch_->updateGeometry(&geometry_))
+        markDirty(DirtyGeometry);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,134 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2017 The Qt Company Ltd.
+ ** Contact: http://www.qt.io/licensing/
+ **
+ ** This file is part of the QtLocation module of the Qt Toolkit.
+ **
+ ** $QT_BEGIN_LICENSE:LGPL3$
+ ** Commercial License Usage
+ ** Licensees holding valid commercial Qt licenses may use this file in
+ ** accordance with the commercial license agreement provided with the
+ ** Software or, alternatively, in accordance with the terms contained in
+ ** a written agreement between you and The Qt Company. For licensing terms
+ ** and conditions see http://www.qt.io/terms-conditions. For further
+ ** information use the contact form at http://www.qt.io/contact-us.
+ **
+ ** GNU Lesser General Public License Usage
+ ** Alternatively, this file may be used under the terms of the GNU Lesser
+ ** General Public License version 3 as published by the Free Software
+ ** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+ ** packaging of this file. Please review the following information to
+ ** ensure the GNU Lesser General Public License version 3 requirements
+ ** will be met: https://www.gnu.org/licenses/lgpl.html.
+ **
+ ** GNU General Public License Usage
+ ** Alternatively, this file may be used under the terms of the GNU
+ ** General Public License version 2.0 or later as published by the Free
+ ** Software Foundation and appearing in the file LICENSE.GPL included in
+ ** the packaging of this file. Please review the following information to
+ ** ensure the GNU General Public License version 2.0 requirements will be
+ ** met: http://www.gnu.org/licenses/gpl-2.0.html.
+ **
+ ** $QT_END_LICENSE$
+ **
+ ****************************************************************************/
+
+#ifndef QGEOMAPITEMBATCH_P_H
+#define QGEOMAPITEMBATCH_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPointF>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QVector>
+#include <QtGui/QColor>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGVertexColorMaterial>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoMapItemGeometry;
+
+/* The triangles of all the map items of one type on a map, with per-vertex
+   colors. Each item owns a sub-range of the vertex buffer, so that a change
+   only rewrites that range. Items add themselves while the scene graph is
+   synchronized, QGeoMapItemBatchNode picks the changes up before rendering. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapItemBatch
+{
+public:
+    explicit QGeoMapItemBatch(QGeoMap::ItemType itemType);
+    ~QGeoMapItemBatch();
+
+    QGeoMap::ItemType itemType() const;
+
+    // Called on the render thread while the GUI thread is blocked
+    void beginItem(const void *item, const QPointF &offset, qreal opacity);
+    void addGeometry(const QGeoMapItemGeometry &geometry, const QColor &color,
+                     QSGGeometry::DrawingMode drawingMode);
+    void endItem();
+
+    void removeItem(const void *item);
+
+    bool updateGeometry(QSGGeometry *geometry);
+
+private:
+    Q_DISABLE_COPY(QGeoMapItemBatch)
+
+    struct Range
+    {
+        int offset;
+        int count;
+    };
+
+    void releaseRange(const Range &range);
+    void markDirty(int begin, int end);
+    void compact();
+
+    const QGeoMap::ItemType itemType_;
+
+    QMutex mutex_;
+    QHash<const void *, Range> ranges_;
+    QVector<QSGGeometry::ColoredPoint2D> vertices_;
+    int unusedVertices_;
+    int dirtyBegin_;
+    int dirtyEnd_;
+    bool resized_;
+
+    // The item between beginItem() and endItem()
+    const void *item_;
+    QPointF offset_;
+    qreal opacity_;
+    QVector<QSGGeometry::ColoredPoint2D> itemVertices_;
+};
+
+class QGeoMapItemBatchNode : public QSGGeometryNode
+{
+public:
+    explicit QGeoMapItemBatchNode(const QSharedPointer<QGeoMapItemBatch> &batch);
+    ~QGeoMapItemBatchNode();
+
+    void preprocess() Q_DECL_OVERRIDE;
+
+private:
+    QSharedPointer<QGeoMapItemBatch> batch_;
+    QSGVertexColorMaterial material_;
+    QSGGeometry geometry_;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPITEMBATCH_P_H
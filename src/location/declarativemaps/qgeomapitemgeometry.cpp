@@ -115,6 +115,26 @@ QRectF QGeoMapItemGeometry::translateToCommonOrigin(const QList<QGeoMapItemGeome
     return brects.boundingRect();
 }
 
+/*!
+    \internal
+*/
+const QVector<QDoubleVector2D> &QGeoMapItemGeometry::itemPositions(const QGeoMap &map, const QVector<QDoubleVector2D> &wrappedPath)
+{
+    itemPositions_.resize(wrappedPath.size());
+    map.geoProjection().wrappedMapProjectionToItemPosition(wrappedPath.constData(), itemPositions_.data(), wrappedPath.size());
+    return itemPositions_;
+}
+
+/*!
+    \internal
+*/
+const QVector<QDoubleVector2D> &QGeoMapItemGeometry::itemPositions(const QGeoMap &map, const QVector<QWorldPoint> &wrappedPath)
+{
+    itemPositions_.resize(wrappedPath.size());
+    map.geoProjection().wrappedMapProjectionToItemPosition(wrappedPath.constData(), itemPositions_.data(), wrappedPath.size());
+    return itemPositions_;
+}
+
 /*!
     \internal
 */
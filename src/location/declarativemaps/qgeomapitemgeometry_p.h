@@ -49,6 +49,8 @@
 //
 
 #include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qworldpoint_p.h>
 
 #include <QPainterPath>
 #include <QPointF>
@@ -63,7 +65,7 @@ QT_BEGIN_NAMESPACE
 class QSGGeometry;
 class QGeoMap;
 
-class QGeoMapItemGeometry
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapItemGeometry
 {
 public:
     QGeoMapItemGeometry();
@@ -126,6 +128,10 @@ public:
 
 
 protected:
+    // Item positions of a wrapped path, converted in one batch into a reused buffer
+    const QVector<QDoubleVector2D> &itemPositions(const QGeoMap &map, const QVector<QDoubleVector2D> &wrappedPath);
+    const QVector<QDoubleVector2D> &itemPositions(const QGeoMap &map, const QVector<QWorldPoint> &wrappedPath);
+
     bool sourceDirty_;
     bool screenDirty_;
     bool clipToViewport_;
@@ -143,6 +149,8 @@ protected:
 
     QVector<QPointF> screenVertices_;
     QVector<quint32> screenIndices_;
+
+    QVector<QDoubleVector2D> itemPositions_;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,277 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapitemgeometrybuilder_p.h"
+#include <QtLocation/private/qgeomap_p_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtCore/QRunnable>
+#include <QtCore/qnumeric.h>
+#include <QtCore/QThread>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoMapSnapshotPrivate : public QGeoMapPrivate
+{
+    Q_DECLARE_PUBLIC(QGeoMapSnapshot)
+public:
+    QGeoMapSnapshotPrivate(const QGeoCameraData &cameraData, const QSize &viewportSize);
+
+protected:
+    void changeViewportSize(const QSize &) Q_DECL_OVERRIDE {}
+    void changeCameraData(const QGeoCameraData &) Q_DECL_OVERRIDE {}
+    void changeActiveMapType(const QGeoMapType) Q_DECL_OVERRIDE {}
+};
+
+QGeoMapSnapshotPrivate::QGeoMapSnapshotPrivate(const QGeoCameraData &cameraData, const QSize &viewportSize)
+    : QGeoMapPrivate(0, new QGeoProjectionWebMercator)
+{
+    m_viewportSize = viewportSize;
+    m_cameraData = cameraData;
+    m_geoProjection->setViewportSize(viewportSize);
+    m_geoProjection->setCameraData(cameraData);
+    // The regions are computed lazily, do it now rather than concurrently in the workers
+    m_geoProjection->visibleClipRegion();
+    m_geoProjection->projectableClipRegion();
+}
+
+/*!
+    \internal
+    \class QGeoMapSnapshot
+
+    QGeoMapSnapshot is a map that is never drawn, holding the camera and
+    viewport of another map at one point in time. It is created on the GUI
+    thread and then only read, so map item geometries can be built against it
+    on worker threads.
+*/
+QGeoMapSnapshot::QGeoMapSnapshot(const QGeoMap &map)
+    : QGeoMap(*new QGeoMapSnapshotPrivate(map.cameraData(), map.viewportSize()))
+{
+}
+
+QGeoMapSnapshot::QGeoMapSnapshot(const QGeoCameraData &cameraData, const QSize &viewportSize)
+    : QGeoMap(*new QGeoMapSnapshotPrivate(cameraData, viewportSize))
+{
+}
+
+QGeoMapSnapshot::~QGeoMapSnapshot()
+{
+}
+
+/*!
+    \internal
+    Returns whether \a map still has the camera and viewport of the snapshot.
+*/
+bool QGeoMapSnapshot::isCurrent(const QGeoMap &map) const
+{
+    return map.viewportSize() == viewportSize() && map.cameraData() == cameraData();
+}
+
+// The shift wrapMapProjection() applies to \a x for a camera centered on \a centerX
+static double wrapOffset(double x, double centerX)
+{
+    if (centerX < 0.5 && x - centerX > 0.5)
+        return -1.0;
+    if (centerX > 0.5 && x - centerX < -0.5)
+        return 1.0;
+    return 0.0;
+}
+
+static void regionBounds(const QVector<QDoubleVector2D> &region, QDoubleVector2D *topLeft, QDoubleVector2D *bottomRight)
+{
+    *topLeft = QDoubleVector2D(qInf(), qInf());
+    *bottomRight = QDoubleVector2D(-qInf(), -qInf());
+    for (const QDoubleVector2D &p : region) {
+        topLeft->setX(qMin(topLeft->x(), p.x()));
+        topLeft->setY(qMin(topLeft->y(), p.y()));
+        bottomRight->setX(qMax(bottomRight->x(), p.x()));
+        bottomRight->setY(qMax(bottomRight->y(), p.y()));
+    }
+}
+
+/*!
+    \internal
+    Returns whether geometry built against the snapshot can still be shown on
+    \a map, the geometry source spanning \a left to \a right in unwrapped
+    map projection. Without tilt a pan only moves the items, as long as the
+    source wraps the same way around both centers and the projectable region
+    of the snapshot still covers the viewport of \a map.
+*/
+bool QGeoMapSnapshot::isValidFor(const QGeoMap &map, double left, double right) const
+{
+    if (isCurrent(map))
+        return true;
+
+    const QGeoCameraData current = map.cameraData();
+    const QGeoCameraData snapshot = cameraData();
+    if (map.viewportSize() != viewportSize()
+            || current.zoomLevel() != snapshot.zoomLevel()
+            || current.bearing() != snapshot.bearing()
+            || current.tilt() != snapshot.tilt()
+            || current.roll() != snapshot.roll()
+            || current.fieldOfView() != snapshot.fieldOfView()
+            || snapshot.tilt() != 0.0) {
+        return false;
+    }
+
+    if (current.center() != snapshot.center()) {
+        const double currentX = map.geoProjection().geoToMapProjection(current.center()).x();
+        const double snapshotX = geoProjection().geoToMapProjection(snapshot.center()).x();
+        // A source straddling the wrapping seam of either center is only valid for the same center
+        const double offset = wrapOffset(left, snapshotX);
+        if (wrapOffset(right, snapshotX) != offset
+                || wrapOffset(left, currentX) != offset
+                || wrapOffset(right, currentX) != offset) {
+            return false;
+        }
+    }
+
+    // Untilted, the projectable region is a rectangle and the visible region lies on its borders
+    // when the map edges are in view, so compare bounds rather than classify()
+    const QVector<QDoubleVector2D> visibleRegion = map.geoProjection().visibleRegion();
+    if (visibleRegion.isEmpty())
+        return true;
+    QDoubleVector2D clipTopLeft, clipBottomRight, visibleTopLeft, visibleBottomRight;
+    regionBounds(geoProjection().projectableClipRegion().region(), &clipTopLeft, &clipBottomRight);
+    regionBounds(visibleRegion, &visibleTopLeft, &visibleBottomRight);
+    return visibleTopLeft.x() >= clipTopLeft.x() && visibleTopLeft.y() >= clipTopLeft.y()
+            && visibleBottomRight.x() <= clipBottomRight.x() && visibleBottomRight.y() <= clipBottomRight.y();
+}
+
+QSGNode *QGeoMapSnapshot::updateSceneGraph(QSGNode *node, QQuickWindow *window)
+{
+    Q_UNUSED(window)
+    return node;
+}
+
+/*!
+    \internal
+    \class QGeoMapItemGeometryTask
+
+    Builds the geometry of one map item on a worker thread. Subclasses copy
+    what they need from the item when created, build() fills their results,
+    and finished() is then emitted for the item to pick them up.
+*/
+QGeoMapItemGeometryTask::QGeoMapItemGeometryTask(const QSharedPointer<QGeoMapSnapshot> &snapshot)
+    : snapshot_(snapshot)
+{
+}
+
+QGeoMapItemGeometryTask::~QGeoMapItemGeometryTask()
+{
+}
+
+class QGeoMapItemGeometryRunner : public QRunnable
+{
+public:
+    explicit QGeoMapItemGeometryRunner(const QSharedPointer<QGeoMapItemGeometryTask> &task)
+        : task_(task)
+    {
+    }
+
+    void run() Q_DECL_OVERRIDE
+    {
+        task_->build();
+        task_->finished_.storeRelease(1);
+        emit task_->finished();
+    }
+
+private:
+    QSharedPointer<QGeoMapItemGeometryTask> task_;
+};
+
+/*!
+    \internal
+    \class QGeoMapItemGeometryBuilder
+
+    Runs QGeoMapItemGeometryTasks on a thread pool of its own, so that slow
+    geometries do not hold up other users of the global pool.
+*/
+QGeoMapItemGeometryBuilder::QGeoMapItemGeometryBuilder()
+{
+    // Leave a core to the GUI and render threads
+    pool_.setMaxThreadCount(qMax(1, QThread::idealThreadCount() - 1));
+}
+
+QGeoMapItemGeometryBuilder::~QGeoMapItemGeometryBuilder()
+{
+    pool_.waitForDone();
+}
+
+Q_GLOBAL_STATIC(QGeoMapItemGeometryBuilder, geometryBuilder)
+
+QGeoMapItemGeometryBuilder *QGeoMapItemGeometryBuilder::instance()
+{
+    return geometryBuilder();
+}
+
+/*!
+    \internal
+    Returns a snapshot of the current camera of \a map. Items of the same map
+    share it for as long as the camera does not change.
+*/
+QSharedPointer<QGeoMapSnapshot> QGeoMapItemGeometryBuilder::snapshot(const QGeoMap &map)
+{
+    // The map is tracked too, another map may later be allocated at the same address
+    const SnapshotEntry entry = snapshots_.value(&map);
+    QSharedPointer<QGeoMapSnapshot> snapshot = entry.snapshot.toStrongRef();
+    if (entry.map && snapshot && snapshot->isCurrent(map))
+        return snapshot;
+
+    // Snapshots are deleted on the GUI thread, whichever thread releases them last
+    snapshot = QSharedPointer<QGeoMapSnapshot>(new QGeoMapSnapshot(map), &QObject::deleteLater);
+    for (auto it = snapshots_.begin(); it != snapshots_.end(); ) {
+        if (it.value().map.isNull() || it.value().snapshot.isNull())
+            it = snapshots_.erase(it);
+        else
+            ++it;
+    }
+    SnapshotEntry &inserted = snapshots_[&map];
+    inserted.map = &map;
+    inserted.snapshot = snapshot;
+    return snapshot;
+}
+
+void QGeoMapItemGeometryBuilder::start(const QSharedPointer<QGeoMapItemGeometryTask> &task)
+{
+    pool_.start(new QGeoMapItemGeometryRunner(task));
+}
+
+bool QGeoMapItemGeometryBuilder::waitForDone(int msecs)
+{
+    return pool_.waitForDone(msecs);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,134 @@
+/****************************************************************************
+ **
+ ** Copyright (C) 2017 The Qt Company Ltd.
+ ** Contact: http://www.qt.io/licensing/
+ **
+ ** This file is part of the QtLocation module of the Qt Toolkit.
+ **
+ ** $QT_BEGIN_LICENSE:LGPL3$
+ ** Commercial License Usage
+ ** Licensees holding valid commercial Qt licenses may use this file in
+ ** accordance with the commercial license agreement provided with the
+ ** Software or, alternatively, in accordance with the terms contained in
+ ** a written agreement between you and The Qt Company. For licensing terms
+ ** and conditions see http://www.qt.io/terms-conditions. For further
+ ** information use the contact form at http://www.qt.io/contact-us.
+ **
+ ** GNU Lesser General Public License Usage
+ ** Alternatively, this file may be used under the terms of the GNU Lesser
+ ** General Public License version 3 as published by the Free Software
+ ** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+ ** packaging of this file. Please review the following information to
+ ** ensure the GNU Lesser General Public License version 3 requirements
+ ** will be met: https://www.gnu.org/licenses/lgpl.html.
+ **
+ ** GNU General Public License Usage
+ ** Alternatively, this file may be used under the terms of the GNU
+ ** General Public License version 2.0 or later as published by the Free
+ ** Software Foundation and appearing in the file LICENSE.GPL included in
+ ** the packaging of this file. Please review the following information to
+ ** ensure the GNU General Public License version 2.0 requirements will be
+ ** met: http://www.gnu.org/licenses/gpl-2.0.html.
+ **
+ ** $QT_END_LICENSE$
+ **
+ ****************************************************************************/
+
+#ifndef QGEOMAPITEMGEOMETRYBUILDER_P_H
+#define QGEOMAPITEMGEOMETRYBUILDER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeomap_p.h>
+#include <QtCore/QAtomicInt>
+#include <QtCore/QHash>
+#include <QtCore/QPointer>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QThreadPool>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoMapSnapshotPrivate;
+
+/* A frozen copy of the camera and viewport of a map. Its projection is fully
+   set up on creation, so worker threads can build geometry against it. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapSnapshot : public QGeoMap
+{
+    Q_DECLARE_PRIVATE(QGeoMapSnapshot)
+
+public:
+    explicit QGeoMapSnapshot(const QGeoMap &map);
+    QGeoMapSnapshot(const QGeoCameraData &cameraData, const QSize &viewportSize);
+    ~QGeoMapSnapshot();
+
+    bool isCurrent(const QGeoMap &map) const;
+    bool isValidFor(const QGeoMap &map, double left, double right) const;
+
+protected:
+    QSGNode *updateSceneGraph(QSGNode *node, QQuickWindow *window) Q_DECL_OVERRIDE;
+
+private:
+    Q_DISABLE_COPY(QGeoMapSnapshot)
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapItemGeometryTask : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit QGeoMapItemGeometryTask(const QSharedPointer<QGeoMapSnapshot> &snapshot);
+    ~QGeoMapItemGeometryTask();
+
+    const QGeoMapSnapshot &map() const { return *snapshot_; }
+    bool isFinished() const { return finished_.loadAcquire() != 0; }
+
+Q_SIGNALS:
+    void finished();
+
+protected:
+    /* Called on a worker thread, must only touch the task and the snapshot */
+    virtual void build() = 0;
+
+private:
+    QSharedPointer<QGeoMapSnapshot> snapshot_;
+    QAtomicInt finished_;
+
+    friend class QGeoMapItemGeometryRunner;
+};
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapItemGeometryBuilder
+{
+public:
+    QGeoMapItemGeometryBuilder();
+    ~QGeoMapItemGeometryBuilder();
+
+    static QGeoMapItemGeometryBuilder *instance();
+
+    QSharedPointer<QGeoMapSnapshot> snapshot(const QGeoMap &map);
+    void start(const QSharedPointer<QGeoMapItemGeometryTask> &task);
+    bool waitForDone(int msecs = -1);
+
+private:
+    QThreadPool pool_;
+    struct SnapshotEntry {
+        QPointer<const QGeoMap> map;
+        QWeakPointer<QGeoMapSnapshot> snapshot;
+    };
+    QHash<const QGeoMap *, SnapshotEntry> snapshots_;
+
+    Q_DISABLE_COPY(QGeoMapItemGeometryBuilder)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPITEMGEOMETRYBUILDER_P_H
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeomapquickitemanimator_p.h"
+#include "qdeclarativegeomap_p.h"
+#include "qdeclarativegeomapquickitem_p.h"
+#include <QtLocation/private/qgeoprojection_p.h>
+
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+QGeoMapQuickItemAnimator::QGeoMapQuickItemAnimator(QDeclarativeGeoMap *map)
+    : QAbstractAnimation(map), map_(map)
+{
+}
+
+QGeoMapQuickItemAnimator::~QGeoMapQuickItemAnimator()
+{
+    for (QDeclarativeGeoMapQuickItem *item : qAsConst(items_))
+        item->animationSlot_ = -1;
+}
+
+// Runs until the last track has finished
+int QGeoMapQuickItemAnimator::duration() const
+{
+    return -1;
+}
+
+void QGeoMapQuickItemAnimator::animate(QDeclarativeGeoMapQuickItem *item, const QGeoCoordinate &from,
+                                       const QGeoCoordinate &to, int duration)
+{
+    const QGeoProjection &projection = map_->m_map->geoProjection();
+
+    // A moving item carries on from where it is drawn
+    int slot = item->animationSlot_;
+    const QDoubleVector2D origin = slot >= 0 ? current_.at(slot) : projection.geoToMapProjection(from);
+
+    // The shorter way around, which may cross the dateline
+    QDoubleVector2D delta = projection.geoToMapProjection(to) - origin;
+    if (delta.x() > 0.5)
+        delta.setX(delta.x() - 1.0);
+    else if (delta.x() < -0.5)
+        delta.setX(delta.x() + 1.0);
+
+    const bool running = state() == QAbstractAnimation::Running;
+    if (slot < 0) {
+        slot = items_.size();
+        item->animationSlot_ = slot;
+        items_.append(item);
+        from_.append(origin);
+        delta_.append(delta);
+        start_.append(0);
+        duration_.append(1);
+        current_.append(origin);
+    }
+
+    from_[slot] = origin;
+    delta_[slot] = delta;
+    start_[slot] = running ? currentTime() : 0;
+    duration_[slot] = qMax(duration, 1);
+    current_[slot] = origin;
+
+    if (!running)
+        start();
+}
+
+void QGeoMapQuickItemAnimator::remove(QDeclarativeGeoMapQuickItem *item)
+{
+    if (item->animationSlot_ < 0)
+        return;
+
+    removeAt(item->animationSlot_);
+    if (items_.isEmpty())
+        stop();
+}
+
+QDoubleVector2D QGeoMapQuickItemAnimator::position(const QDeclarativeGeoMapQuickItem *item) const
+{
+    return current_.at(item->animationSlot_);
+}
+
+int QGeoMapQuickItemAnimator::count() const
+{
+    return items_.size();
+}
+
+void QGeoMapQuickItemAnimator::updateCurrentTime(int currentTime)
+{
+    const int count = items_.size();
+    if (!count || !map_->m_map) {
+        stop();
+        return;
+    }
+
+    const QGeoProjection &projection = map_->m_map->geoProjection();
+    wrapped_.resize(count);
+    itemPositions_.resize(count);
+
+    for (int i = 0; i < count; ++i) {
+        const double progress = qMin(double(currentTime - start_.at(i)) / duration_.at(i), 1.0);
+        QDoubleVector2D position = from_.at(i) + delta_.at(i) * progress;
+        position.setX(position.x() - std::floor(position.x()));
+        current_[i] = position;
+        wrapped_[i] = projection.wrapMapProjection(position);
+    }
+
+    projection.wrappedMapProjectionToItemPosition(wrapped_.constData(), itemPositions_.data(), count);
+
+    // Only a tilted camera can put items behind it
+    const bool tilted = map_->m_map->cameraData().tilt() > 0.0;
+    for (int i = 0; i < count; ++i) {
+        const bool projectable = !tilted || projection.isProjectable(wrapped_.at(i));
+        items_.at(i)->setAnimatedPosition(itemPositions_.at(i), projectable);
+    }
+
+    // Back to front, so that the track moved into a freed slot has been looked at already
+    for (int i = count - 1; i >= 0; --i) {
+        if (currentTime - start_.at(i) >= duration_.at(i))
+            removeAt(i);
+    }
+
+    if (items_.isEmpty())
+        stop();
+}
+
+void QGeoMapQuickItemAnimator::removeAt(int slot)
+{
+    const int last = items_.size() - 1;
+    items_.at(slot)->animationSlot_ = -1;
+    if (slot != last) {
+        items_[slot] = items_.at(last);
+        items_.at(slot)->animationSlot_ = slot;
+        from_[slot] = from_.at(last);
+        delta_[slot] = delta_.at(last);
+        start_[slot] = start_.at(last);
+        duration_[slot] = duration_.at(last);
+        current_[slot] = current_.at(last);
+    }
+
+    items_.removeLast();
+    from_.removeLast();
+    delta_.removeLast();
+    start_.removeLast();
+    duration_.removeLast();
+    current_.removeLast();
+}
+
+QT_END_NAMESPACE
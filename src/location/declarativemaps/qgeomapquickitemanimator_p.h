@@ -0,0 +1,109 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOMAPQUICKITEMANIMATOR_P_H
+#define QGEOMAPQUICKITEMANIMATOR_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtCore/QAbstractAnimation>
+#include <QtCore/QVector>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QDeclarativeGeoMap;
+class QDeclarativeGeoMapQuickItem;
+
+/* Moves the MapQuickItems of a map towards their coordinates. The tracks are
+   kept in map projection space and all advanced in one pass per frame, then
+   projected to item positions in one batch. Items are placed directly, only
+   those needing a transformation are polished. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoMapQuickItemAnimator : public QAbstractAnimation
+{
+    Q_OBJECT
+public:
+    explicit QGeoMapQuickItemAnimator(QDeclarativeGeoMap *map);
+    ~QGeoMapQuickItemAnimator();
+
+    int duration() const Q_DECL_OVERRIDE;
+
+    // Starts moving item from where it is drawn to coordinate
+    void animate(QDeclarativeGeoMapQuickItem *item, const QGeoCoordinate &from,
+                 const QGeoCoordinate &to, int duration);
+    void remove(QDeclarativeGeoMapQuickItem *item);
+
+    // Where item is drawn, in map projection space
+    QDoubleVector2D position(const QDeclarativeGeoMapQuickItem *item) const;
+    int count() const;
+
+protected:
+    void updateCurrentTime(int currentTime) Q_DECL_OVERRIDE;
+
+private:
+    Q_DISABLE_COPY(QGeoMapQuickItemAnimator)
+
+    void removeAt(int slot);
+
+    QDeclarativeGeoMap *map_;
+
+    // One track per animated item, the item knows its slot
+    QVector<QDeclarativeGeoMapQuickItem *> items_;
+    QVector<QDoubleVector2D> from_;
+    QVector<QDoubleVector2D> delta_;
+    QVector<int> start_;
+    QVector<int> duration_;
+    QVector<QDoubleVector2D> current_;
+
+    // Scratch buffers of the frame
+    QVector<QDoubleVector2D> wrapped_;
+    QVector<QDoubleVector2D> itemPositions_;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOMAPQUICKITEMANIMATOR_P_H
@@ -10,6 +10,11 @@ PUBLIC_HEADERS += \
                     maps/qgeomaneuver.h \
                     maps/qgeoroute.h \
                     maps/qgeoroutereply.h \
+                    maps/qgeoroutematchreply.h \
+                    maps/qgeoroutematchrequest.h \
+                    maps/qgeoroutematrixreply.h \
+                    maps/qgeoroutematrixrequest.h \
+                    maps/qgeorouteprogresstracker.h \
                     maps/qgeorouterequest.h \
                     maps/qgeoroutesegment.h \
                     maps/qgeoroutingmanagerengine.h \
@@ -27,7 +32,9 @@ PRIVATE_HEADERS += \
                     maps/qgeocodingmanager_p.h \
                     maps/qgeomaneuver_p.h \
                     maps/qgeotiledmapscene_p.h \
+                    maps/qgeotileatlas_p.h \
                     maps/qgeotilerequestmanager_p.h \
+                    maps/qgeotileprefetchjob_p.h \
                     maps/qgeomap_p.h \
                     maps/qgeomap_p_p.h \
                     maps/qgeotiledmap_p.h \
@@ -44,13 +51,20 @@ PRIVATE_HEADERS += \
                     maps/qgeomaptype_p_p.h \
                     maps/qgeoroute_p.h \
                     maps/qgeoroutereply_p.h \
+                    maps/qgeoroutematchreply_p.h \
+                    maps/qgeoroutematchrequest_p.h \
+                    maps/qgeoroutematrixreply_p.h \
+                    maps/qgeoroutematrixrequest_p.h \
+                    maps/qgeorouteprogresstracker_p.h \
                     maps/qgeorouterequest_p.h \
                     maps/qgeoroutesegment_p.h \
                     maps/qgeoroutingmanagerengine_p.h \
+                    maps/qgeoroutingmanagerengineextension_p.h \
                     maps/qgeoroutingmanager_p.h \
                     maps/qgeoserviceprovider_p.h \
                     maps/qabstractgeotilecache_p.h \
                     maps/qgeofiletilecache_p.h \
+                    maps/qgeofiletilecachewriter_p.h \
                     maps/qgeotiledmapreply_p.h \
                     maps/qgeotiledmapreply_p_p.h \
                     maps/qgeotilespec_p.h \
@@ -60,6 +74,7 @@ PRIVATE_HEADERS += \
                     maps/qgeorouteparserosrmv5_p.h \
                     maps/qgeorouteparserosrmv4_p.h \
                     maps/qgeoprojection_p.h \
+                    maps/qgeoclipregion_p.h \
                     maps/qcache3q_p.h
 
 SOURCES += \
@@ -71,6 +86,7 @@ SOURCES += \
             maps/qgeocodingmanagerengine.cpp \
             maps/qgeomaneuver.cpp \
             maps/qgeotilerequestmanager.cpp \
+            maps/qgeotileprefetchjob.cpp \
             maps/qgeomap.cpp \
             maps/qgeomappingmanager.cpp \
             maps/qgeomappingmanagerengine.cpp \
@@ -79,6 +95,11 @@ SOURCES += \
             maps/qgeomaptype.cpp \
             maps/qgeoroute.cpp \
             maps/qgeoroutereply.cpp \
+            maps/qgeoroutematchreply.cpp \
+            maps/qgeoroutematchrequest.cpp \
+            maps/qgeoroutematrixreply.cpp \
+            maps/qgeoroutematrixrequest.cpp \
+            maps/qgeorouteprogresstracker.cpp \
             maps/qgeorouterequest.cpp \
             maps/qgeoroutesegment.cpp \
             maps/qgeoroutingmanager.cpp \
@@ -87,12 +108,15 @@ SOURCES += \
             maps/qgeoserviceproviderfactory.cpp \
             maps/qabstractgeotilecache.cpp \
             maps/qgeofiletilecache.cpp \
+            maps/qgeofiletilecachewriter.cpp \
             maps/qgeotiledmapreply.cpp \
             maps/qgeotilespec.cpp \
             maps/qgeotiledmap.cpp \
             maps/qgeotiledmapscene.cpp \
+            maps/qgeotileatlas.cpp \
             maps/qgeorouteparser.cpp \
             maps/qgeorouteparserosrmv5.cpp \
             maps/qgeorouteparserosrmv4.cpp \
             maps/qgeomapparameter.cpp \
-            maps/qgeoprojection.cpp
+            maps/qgeoprojection.cpp \
+            maps/qgeoclipregion.cpp
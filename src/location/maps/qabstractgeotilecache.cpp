@@ -44,6 +44,7 @@
 #include <QMetaType>
 #include <QPixmap>
 #include <QDebug>
+#include <QLocale>
 
 Q_DECLARE_METATYPE(QList<QGeoTileSpec>)
 Q_DECLARE_METATYPE(QSet<QGeoTileSpec>)
@@ -57,12 +58,121 @@ QGeoTileTexture::~QGeoTileTexture()
 {
 }
 
+// Without explicit expiry, a tile is considered fresh for a tenth of its age, as suggested
+// by RFC 7234, up to this many seconds.
+static const qint64 maxHeuristicFreshness = 7 * 24 * 3600;
+
+bool QGeoTileFreshness::isValid() const
+{
+    return !etag.isEmpty() || lastModified.isValid() || expires.isValid();
+}
+
+/*
+    Returns whether the tile has to be revalidated with the server. Tiles
+    without a known expiry never become stale.
+*/
+bool QGeoTileFreshness::isStale(const QDateTime &now) const
+{
+    return expires.isValid() && expires <= now;
+}
+
+bool QGeoTileFreshness::operator==(const QGeoTileFreshness &other) const
+{
+    return etag == other.etag && lastModified == other.lastModified && expires == other.expires;
+}
+
+/*
+    Returns the headers turning a tile request into a conditional one.
+*/
+QList<QGeoTileFreshness::RawHeaderPair> QGeoTileFreshness::conditionalHeaders() const
+{
+    QList<RawHeaderPair> headers;
+    if (!etag.isEmpty())
+        headers.append(qMakePair(QByteArrayLiteral("If-None-Match"), etag));
+    if (lastModified.isValid())
+        headers.append(qMakePair(QByteArrayLiteral("If-Modified-Since"), toHttpDate(lastModified)));
+    return headers;
+}
+
+/*
+    Extracts validators and expiry from the \a headers of a response
+    \a received at the given time.
+*/
+QGeoTileFreshness QGeoTileFreshness::fromHttpHeaders(const QList<RawHeaderPair> &headers, const QDateTime &received)
+{
+    QGeoTileFreshness freshness;
+    QDateTime date;
+    QDateTime expiresHeader;
+    bool hasExpiresHeader = false;
+    qint64 maxAge = -1;
+    qint64 age = 0;
+
+    for (const RawHeaderPair &header : headers) {
+        const QByteArray name = header.first.toLower();
+        const QByteArray value = header.second.trimmed();
+        if (name == "etag") {
+            freshness.etag = value;
+        } else if (name == "last-modified") {
+            freshness.lastModified = fromHttpDate(value);
+        } else if (name == "date") {
+            date = fromHttpDate(value);
+        } else if (name == "age") {
+            age = qMax<qint64>(0, value.toLongLong());
+        } else if (name == "expires") {
+            hasExpiresHeader = true;
+            expiresHeader = fromHttpDate(value);
+        } else if (name == "cache-control") {
+            for (const QByteArray &directive : value.split(',')) {
+                const QByteArray d = directive.trimmed().toLower();
+                if (d == "no-cache" || d == "no-store")
+                    maxAge = 0;
+                else if (d.startsWith("max-age=") && maxAge != 0)
+                    maxAge = qMax<qint64>(0, d.mid(8).toLongLong());
+            }
+        }
+    }
+
+    if (maxAge >= 0) {
+        freshness.expires = received.addSecs(maxAge - age);
+    } else if (hasExpiresHeader) {
+        // Invalid dates, such as "0", mean already expired. The lifetime is taken relative
+        // to the server clock, when available.
+        if (!expiresHeader.isValid())
+            freshness.expires = received;
+        else if (date.isValid())
+            freshness.expires = received.addSecs(date.secsTo(expiresHeader) - age);
+        else
+            freshness.expires = expiresHeader;
+    } else if (freshness.lastModified.isValid()) {
+        const QDateTime now = date.isValid() ? date : received;
+        const qint64 lifetime = qMin(freshness.lastModified.secsTo(now) / 10, maxHeuristicFreshness);
+        freshness.expires = received.addSecs(qMax<qint64>(0, lifetime - age));
+    }
+
+    return freshness;
+}
+
+QDateTime QGeoTileFreshness::fromHttpDate(const QByteArray &value)
+{
+    // RFC 7231 preferred format, e.g. Sun, 06 Nov 1994 08:49:37 GMT
+    QDateTime dateTime = QLocale::c().toDateTime(QString::fromLatin1(value.trimmed()),
+                                                 QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'"));
+    dateTime.setTimeSpec(Qt::UTC);
+    return dateTime;
+}
+
+QByteArray QGeoTileFreshness::toHttpDate(const QDateTime &dateTime)
+{
+    return QLocale::c().toString(dateTime.toUTC(), QStringLiteral("ddd, dd MMM yyyy hh:mm:ss 'GMT'")).toLatin1();
+}
+
 QAbstractGeoTileCache::QAbstractGeoTileCache(QObject *parent)
     : QObject(parent)
 {
     qRegisterMetaType<QGeoTileSpec>();
     qRegisterMetaType<QList<QGeoTileSpec> >();
     qRegisterMetaType<QSet<QGeoTileSpec> >();
+    qRegisterMetaType<QGeoTileFreshness>();
 }
 
 QAbstractGeoTileCache::~QAbstractGeoTileCache()
@@ -78,6 +188,57 @@ void QAbstractGeoTileCache::handleError(const QGeoTileSpec &, const QString &err
     qWarning() << "tile request error " << error;
 }
 
+/*
+    Returns the texture for \a spec if it can be served without touching the
+    disk, or a null pointer otherwise. The default implementation never
+    returns a texture.
+*/
+QSharedPointer<QGeoTileTexture> QAbstractGeoTileCache::getFromMemory(const QGeoTileSpec &spec)
+{
+    Q_UNUSED(spec);
+    return QSharedPointer<QGeoTileTexture>();
+}
+
+/*
+    Returns whether the tile \a spec is stored in any of the cache \a areas,
+    without loading it. The default implementation always returns false.
+*/
+bool QAbstractGeoTileCache::contains(const QGeoTileSpec &spec, CacheAreas areas) const
+{
+    Q_UNUSED(spec);
+    Q_UNUSED(areas);
+    return false;
+}
+
+/*
+    Returns the freshness information stored with the tile \a spec, if any.
+    The default implementation stores none.
+*/
+QGeoTileFreshness QAbstractGeoTileCache::freshness(const QGeoTileSpec &spec)
+{
+    Q_UNUSED(spec);
+    return QGeoTileFreshness();
+}
+
+void QAbstractGeoTileCache::setFreshness(const QGeoTileSpec &spec, const QGeoTileFreshness &freshness)
+{
+    Q_UNUSED(spec);
+    Q_UNUSED(freshness);
+}
+
+/*
+    Starts loading the first of \a specs found on disk without blocking, and
+    returns whether a lookup was started. loadedFromDisk() is then emitted with
+    \a key and the texture, or a null pointer if none of the tiles could be
+    loaded. The default implementation has no disk to look up.
+*/
+bool QAbstractGeoTileCache::loadFromDisk(const QGeoTileSpec &key, const QList<QGeoTileSpec> &specs)
+{
+    Q_UNUSED(key);
+    Q_UNUSED(specs);
+    return false;
+}
+
 void QAbstractGeoTileCache::setMaxDiskUsage(int diskUsage)
 {
     Q_UNUSED(diskUsage);
@@ -59,6 +59,8 @@
 #include "qgeotilespec_p.h"
 
 #include <QImage>
+#include <QDateTime>
+#include <QPair>
 
 QT_BEGIN_NAMESPACE
 
@@ -83,6 +85,29 @@ public:
     bool textureBound;
 };
 
+/* HTTP validators and expiry of a cached tile */
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileFreshness
+{
+public:
+    typedef QPair<QByteArray, QByteArray> RawHeaderPair;
+
+    bool isValid() const;
+    bool isStale(const QDateTime &now = QDateTime::currentDateTimeUtc()) const;
+    bool operator==(const QGeoTileFreshness &other) const;
+    bool operator!=(const QGeoTileFreshness &other) const { return !(*this == other); }
+
+    QList<RawHeaderPair> conditionalHeaders() const;
+    static QGeoTileFreshness fromHttpHeaders(const QList<RawHeaderPair> &headers,
+                                             const QDateTime &received = QDateTime::currentDateTimeUtc());
+
+    static QDateTime fromHttpDate(const QByteArray &value);
+    static QByteArray toHttpDate(const QDateTime &dateTime);
+
+    QByteArray etag;
+    QDateTime lastModified;
+    QDateTime expires;
+};
+
 class Q_LOCATION_PRIVATE_EXPORT QAbstractGeoTileCache : public QObject
 {
     Q_OBJECT
@@ -123,6 +148,11 @@ public:
     virtual CostStrategy costStrategyTexture() const = 0;
 
     virtual QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) = 0;
+    virtual QSharedPointer<QGeoTileTexture> getFromMemory(const QGeoTileSpec &spec);
+    virtual bool contains(const QGeoTileSpec &spec, CacheAreas areas = AllCaches) const;
+    virtual QGeoTileFreshness freshness(const QGeoTileSpec &spec);
+    virtual void setFreshness(const QGeoTileSpec &spec, const QGeoTileFreshness &freshness);
+    virtual bool loadFromDisk(const QGeoTileSpec &key, const QList<QGeoTileSpec> &specs);
 
     virtual void insert(const QGeoTileSpec &spec,
                 const QByteArray &bytes,
@@ -134,6 +164,9 @@ public:
     static QString baseCacheDirectory();
     static QString baseLocationCacheDirectory();
 
+Q_SIGNALS:
+    void loadedFromDisk(const QGeoTileSpec &key, const QSharedPointer<QGeoTileTexture> &texture);
+
 protected:
     QAbstractGeoTileCache(QObject *parent = 0);
     virtual void printStats() = 0;
@@ -145,4 +178,6 @@ Q_DECLARE_OPERATORS_FOR_FLAGS(QAbstractGeoTileCache::CacheAreas)
 
 QT_END_NAMESPACE
 
+Q_DECLARE_METATYPE(QGeoTileFreshness)
+
 #endif // QABSTRACTGEOTILECACHE_P_H
@@ -160,6 +160,8 @@ public:
     bool insert(const Key &key, QSharedPointer<T> object, int cost = 1);
     QSharedPointer<T> object(const Key &key) const;
     QSharedPointer<T> operator[](const Key &key) const;
+    bool contains(const Key &key) const;
+    QSharedPointer<T> peek(const Key &key) const;
 
     void remove(const Key &key, bool force = false);
     QList<Key> keys() const;
@@ -472,6 +474,24 @@ inline QSharedPointer<T> QCache3Q<Key,T,EvPolicy>::operator[](const Key &key) co
     return object(key);
 }
 
+// Unlike object(), this does not count as an access to the entry
+template <class Key, class T, class EvPolicy>
+inline bool QCache3Q<Key,T,EvPolicy>::contains(const Key &key) const
+{
+    Node *n = lookup_.value(key, 0);
+    return n && n->q != q1_evicted_;
+}
+
+// Like object(), without counting as an access to the entry
+template <class Key, class T, class EvPolicy>
+inline QSharedPointer<T> QCache3Q<Key,T,EvPolicy>::peek(const Key &key) const
+{
+    Node *n = lookup_.value(key, 0);
+    if (!n || n->q == q1_evicted_)
+        return QSharedPointer<T>();
+    return n->v;
+}
+
 QT_END_NAMESPACE
 
 #endif // QCACHE3Q_H
@@ -0,0 +1,513 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoclipregion_p.h"
+#include <QtPositioning/private/qclipperutils_p.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+/* Differences of world points are taken before converting them, so that they stay exact */
+inline QDoubleVector2D delta(const QDoubleVector2D &from, const QDoubleVector2D &to)
+{
+    return to - from;
+}
+
+inline QDoubleVector2D delta(const QWorldPoint &from, const QWorldPoint &to)
+{
+    return QDoubleVector2D(double(to.x() - from.x()), double(to.y() - from.y()));
+}
+
+inline QDoubleVector2D interpolate(const QDoubleVector2D &p, const QDoubleVector2D &q, double t)
+{
+    return p + (q - p) * t;
+}
+
+inline QWorldPoint interpolate(const QWorldPoint &p, const QWorldPoint &q, double t)
+{
+    const QDoubleVector2D offset = delta(p, q) * t;
+    return QWorldPoint(p.x() + std::llround(offset.x()), p.y() + std::llround(offset.y()));
+}
+
+template <typename Point>
+inline double cross(const Point &a, const Point &b, const Point &p)
+{
+    const QDoubleVector2D ab = delta(a, b);
+    const QDoubleVector2D ap = delta(a, p);
+    return ab.x() * ap.y() - ab.y() * ap.x();
+}
+
+/* Point where the segment from p to q crosses the edge, given the sides of p and q */
+template <typename Point>
+inline Point crossing(const Point &p, const Point &q, double sideP, double sideQ)
+{
+    return interpolate(p, q, sideP / (sideP - sideQ));
+}
+
+/*
+ * The clipping algorithms, shared by mercator and world points. Only the
+ * classification handles non-convex regions, clipping them is left to Clipper.
+ */
+template <typename Point>
+struct Region
+{
+    const QVector<Point> &vertices;
+    Point topLeft;
+    Point bottomRight;
+    double orientation;
+    bool convex;
+
+    /* Positive on the inner side of the edge starting at the given vertex, only meaningful for convex regions */
+    double side(int edge, const Point &point) const
+    {
+        const int next = edge + 1 < vertices.size() ? edge + 1 : 0;
+        return orientation * cross(vertices.at(edge), vertices.at(next), point);
+    }
+
+    bool contains(const Point &point) const;
+    QGeoClipRegion::Containment classify(const Point &boxTopLeft, const Point &boxBottomRight) const;
+    QGeoClipRegion::Containment classify(const QVector<Point> &points) const;
+    void clipPolygon(const QVector<Point> &polygon, QVector<QVector<Point> > *clipped) const;
+    void clipPolyline(const QVector<Point> &polyline, QVector<QVector<Point> > *clipped) const;
+};
+
+template <typename Point>
+bool Region<Point>::contains(const Point &point) const
+{
+    if (vertices.isEmpty()
+            || point.x() < topLeft.x() || point.x() > bottomRight.x()
+            || point.y() < topLeft.y() || point.y() > bottomRight.y())
+        return false;
+
+    if (convex) {
+        for (int i = 0; i < vertices.size(); ++i) {
+            if (side(i, point) <= 0.0)
+                return false;
+        }
+        return true;
+    }
+
+    /* even-odd crossing test */
+    bool inside = false;
+    for (int i = 0, j = vertices.size() - 1; i < vertices.size(); j = i++) {
+        const Point &a = vertices.at(i);
+        const Point &b = vertices.at(j);
+        const QDoubleVector2D ab = delta(a, b);
+        const QDoubleVector2D ap = delta(a, point);
+        if ((a.y() > point.y()) != (b.y() > point.y()) && ap.x() < ab.x() * ap.y() / ab.y())
+            inside = !inside;
+    }
+    return inside;
+}
+
+template <typename Point>
+QGeoClipRegion::Containment Region<Point>::classify(const Point &boxTopLeft, const Point &boxBottomRight) const
+{
+    if (vertices.isEmpty())
+        return QGeoClipRegion::Inside;
+    if (boxBottomRight.x() < topLeft.x() || boxTopLeft.x() > bottomRight.x()
+            || boxBottomRight.y() < topLeft.y() || boxTopLeft.y() > bottomRight.y())
+        return QGeoClipRegion::Outside;
+    if (!convex)
+        return QGeoClipRegion::Intersecting;
+
+    const Point corners[4] = {
+        boxTopLeft,
+        Point(boxBottomRight.x(), boxTopLeft.y()),
+        boxBottomRight,
+        Point(boxTopLeft.x(), boxBottomRight.y())
+    };
+    bool inside = true;
+    for (int i = 0; i < vertices.size(); ++i) {
+        int outside = 0;
+        for (const Point &c : corners) {
+            if (side(i, c) <= 0.0)
+                ++outside;
+        }
+        if (outside == 4)
+            return QGeoClipRegion::Outside; // the edge separates the rectangle from the region
+        if (outside)
+            inside = false;
+    }
+    return inside ? QGeoClipRegion::Inside : QGeoClipRegion::Intersecting;
+}
+
+template <typename Point>
+QGeoClipRegion::Containment Region<Point>::classify(const QVector<Point> &points) const
+{
+    if (points.isEmpty())
+        return QGeoClipRegion::Outside;
+    if (vertices.isEmpty())
+        return QGeoClipRegion::Inside;
+
+    Point boxTopLeft = points.first();
+    Point boxBottomRight = points.first();
+    for (const Point &p : points) {
+        boxTopLeft.setX(qMin(boxTopLeft.x(), p.x()));
+        boxTopLeft.setY(qMin(boxTopLeft.y(), p.y()));
+        boxBottomRight.setX(qMax(boxBottomRight.x(), p.x()));
+        boxBottomRight.setY(qMax(boxBottomRight.y(), p.y()));
+    }
+    const QGeoClipRegion::Containment boxContainment = classify(boxTopLeft, boxBottomRight);
+    if (boxContainment != QGeoClipRegion::Intersecting || !convex || vertices.size() > 64)
+        return boxContainment;
+
+    /* Bit i stays set while all the points are outside of edge i */
+    quint64 allOutside = vertices.size() == 64 ? ~quint64(0) : (quint64(1) << vertices.size()) - 1;
+    bool allInside = true;
+    for (const Point &p : points) {
+        bool pointInside = true;
+        for (int i = 0; i < vertices.size(); ++i) {
+            if (side(i, p) <= 0.0)
+                pointInside = false;
+            else
+                allOutside &= ~(quint64(1) << i);
+        }
+        allInside = allInside && pointInside;
+        if (!allInside && !allOutside)
+            return QGeoClipRegion::Intersecting;
+    }
+    if (allOutside)
+        return QGeoClipRegion::Outside;
+    return allInside ? QGeoClipRegion::Inside : QGeoClipRegion::Intersecting;
+}
+
+template <typename Point>
+void Region<Point>::clipPolygon(const QVector<Point> &polygon, QVector<QVector<Point> > *clipped) const
+{
+    Q_ASSERT(convex);
+
+    /* Sutherland-Hodgman, ping-ponging between the output buffer and a local one */
+    clipped->resize(1);
+    QVector<Point> &output = (*clipped)[0];
+    QVector<Point> input = polygon;
+    for (int edge = 0; edge < vertices.size() && !input.isEmpty(); ++edge) {
+        output.reserve(input.size() + 1);
+        output.resize(0);
+        Point previous = input.last();
+        double previousSide = side(edge, previous);
+        for (const Point &current : qAsConst(input)) {
+            const double currentSide = side(edge, current);
+            if (currentSide >= 0.0) {
+                if (previousSide < 0.0)
+                    output.append(crossing(previous, current, previousSide, currentSide));
+                output.append(current);
+            } else if (previousSide >= 0.0) {
+                output.append(crossing(previous, current, previousSide, currentSide));
+            }
+            previous = current;
+            previousSide = currentSide;
+        }
+        input.swap(output);
+    }
+    output.swap(input);
+    if (output.size() < 3)
+        clipped->resize(0);
+}
+
+template <typename Point>
+void Region<Point>::clipPolyline(const QVector<Point> &polyline, QVector<QVector<Point> > *clipped) const
+{
+    Q_ASSERT(convex);
+
+    /* Cyrus-Beck, segment by segment. A part stays open while segments end inside the region. */
+    clipped->resize(0);
+    bool open = false;
+    for (int i = 0; i + 1 < polyline.size(); ++i) {
+        const Point &p = polyline.at(i);
+        const Point &q = polyline.at(i + 1);
+        double enter = 0.0;
+        double exit = 1.0;
+        for (int edge = 0; edge < vertices.size() && enter <= exit; ++edge) {
+            const double sideP = side(edge, p);
+            const double sideQ = side(edge, q);
+            if (sideP < 0.0 && sideQ < 0.0)
+                exit = -1.0;
+            else if (sideP < 0.0)
+                enter = qMax(enter, sideP / (sideP - sideQ));
+            else if (sideQ < 0.0)
+                exit = qMin(exit, sideP / (sideP - sideQ));
+        }
+        if (enter > exit) {
+            open = false;
+            continue;
+        }
+
+        if (!open || enter > 0.0) {
+            clipped->append(QVector<Point>());
+            clipped->last().append(enter > 0.0 ? interpolate(p, q, enter) : p);
+        }
+        clipped->last().append(exit < 1.0 ? interpolate(p, q, exit) : q);
+        open = exit >= 1.0;
+    }
+}
+
+} // namespace
+
+/*!
+    \internal
+    \class QGeoClipRegion
+
+    QGeoClipRegion holds a region of the wrapped mercator space, such as the
+    projectable region of a tilted camera, together with what is needed to
+    clip geometries against it quickly. The projection rebuilds it once per
+    camera change, so that all the map items share it.
+
+    Geometries can first be classified by their bounding box, and only those
+    intersecting the border of the region need to be clipped. Convex regions
+    are clipped with Sutherland-Hodgman for polygons and Cyrus-Beck for
+    polylines, other regions go through Clipper.
+
+    Every operation also exists for QWorldPoint geometries, which are clipped
+    without leaving fixed point. Their crossings with the region are rounded
+    to the nearest world point.
+*/
+QGeoClipRegion::QGeoClipRegion()
+    : m_orientation(1.0), m_convex(false)
+{
+}
+
+void QGeoClipRegion::setRegion(const QVector<QDoubleVector2D> &region)
+{
+    m_region = region;
+    m_worldRegion.clear();
+    m_convex = false;
+    m_orientation = 1.0;
+    if (m_region.size() < 3) {
+        m_region.clear();
+        return;
+    }
+
+    double minX = qInf(), minY = qInf(), maxX = -qInf(), maxY = -qInf();
+    double area = 0.0;
+    int turn = 0;
+    bool convex = true;
+    const int size = m_region.size();
+    for (int i = 0; i < size; ++i) {
+        const QDoubleVector2D &a = m_region.at(i);
+        const QDoubleVector2D &b = m_region.at((i + 1) % size);
+        const QDoubleVector2D &c = m_region.at((i + 2) % size);
+        minX = qMin(minX, a.x());
+        minY = qMin(minY, a.y());
+        maxX = qMax(maxX, a.x());
+        maxY = qMax(maxY, a.y());
+        area += a.x() * b.y() - b.x() * a.y();
+
+        const double z = cross(a, b, c);
+        if (z != 0.0) {
+            const int t = z > 0.0 ? 1 : -1;
+            if (turn && t != turn)
+                convex = false;
+            turn = t;
+        }
+    }
+    m_topLeft = QDoubleVector2D(minX, minY);
+    m_bottomRight = QDoubleVector2D(maxX, maxY);
+    m_orientation = area < 0.0 ? -1.0 : 1.0;
+    m_convex = convex && area != 0.0;
+
+    QWorldPoint::fromMercator(m_region, &m_worldRegion);
+    m_worldTopLeft = QWorldPoint::fromMercator(m_topLeft);
+    m_worldBottomRight = QWorldPoint::fromMercator(m_bottomRight);
+}
+
+/*!
+    \internal
+    Returns whether \a point lies strictly inside the region. Points on the
+    border are not contained, they are left for the clipper to decide.
+*/
+bool QGeoClipRegion::contains(const QDoubleVector2D &point) const
+{
+    const Region<QDoubleVector2D> region = { m_region, m_topLeft, m_bottomRight, m_orientation, m_convex };
+    return region.contains(point);
+}
+
+/*!
+    \internal
+    Classifies the rectangle from \a topLeft to \a bottomRight. An empty
+    region does not clip anything, so everything is inside it.
+*/
+QGeoClipRegion::Containment QGeoClipRegion::classify(const QDoubleVector2D &topLeft,
+                                                     const QDoubleVector2D &bottomRight) const
+{
+    const Region<QDoubleVector2D> region = { m_region, m_topLeft, m_bottomRight, m_orientation, m_convex };
+    return region.classify(topLeft, bottomRight);
+}
+
+/*!
+    \internal
+    Classifies the geometry made of \a points, first by its bounding box and,
+    when that is not enough, point by point.
+*/
+QGeoClipRegion::Containment QGeoClipRegion::classify(const QVector<QDoubleVector2D> &points) const
+{
+    const Region<QDoubleVector2D> region = { m_region, m_topLeft, m_bottomRight, m_orientation, m_convex };
+    return region.classify(points);
+}
+
+/*!
+    \internal
+    Clips the closed \a polygon against the region into \a clipped. A convex
+    region yields at most one polygon, whose parts may be joined along the
+    border of the region.
+*/
+void QGeoClipRegion::clipPolygon(const QVector<QDoubleVector2D> &polygon,
+                                 QVector<QVector<QDoubleVector2D> > *clipped) const
+{
+    if (m_region.isEmpty()) {
+        clipped->resize(1);
+        (*clipped)[0] = polygon;
+        return;
+    }
+
+    if (!m_convex) {
+        c2t::clip2tri clipper;
+        clipper.addSubjectPath(QClipperUtils::qVectorToPath(polygon), true);
+        clipper.addClipPolygon(QClipperUtils::qVectorToPath(m_region));
+        Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
+        QClipperUtils::pathsToQVector(res, clipped);
+        return;
+    }
+
+    const Region<QDoubleVector2D> region = { m_region, m_topLeft, m_bottomRight, m_orientation, m_convex };
+    region.clipPolygon(polygon, clipped);
+}
+
+/*!
+    \internal
+    Clips the open \a polyline against the region into \a clipped, one path
+    per part of the polyline inside the region.
+*/
+void QGeoClipRegion::clipPolyline(const QVector<QDoubleVector2D> &polyline,
+                                  QVector<QVector<QDoubleVector2D> > *clipped) const
+{
+    if (m_region.isEmpty()) {
+        clipped->resize(1);
+        (*clipped)[0] = polyline;
+        return;
+    }
+
+    if (!m_convex) {
+        c2t::clip2tri clipper;
+        clipper.addSubjectPath(QClipperUtils::qVectorToPath(polyline), false);
+        clipper.addClipPolygon(QClipperUtils::qVectorToPath(m_region));
+        Paths res = clipper.execute(c2t::clip2tri::Intersection);
+        QClipperUtils::pathsToQVector(res, clipped);
+        return;
+    }
+
+    const Region<QDoubleVector2D> region = { m_region, m_topLeft, m_bottomRight, m_orientation, m_convex };
+    region.clipPolyline(polyline, clipped);
+}
+
+/*!
+    \internal
+*/
+bool QGeoClipRegion::contains(const QWorldPoint &point) const
+{
+    const Region<QWorldPoint> region = { m_worldRegion, m_worldTopLeft, m_worldBottomRight, m_orientation, m_convex };
+    return region.contains(point);
+}
+
+/*!
+    \internal
+*/
+QGeoClipRegion::Containment QGeoClipRegion::classify(const QVector<QWorldPoint> &points) const
+{
+    const Region<QWorldPoint> region = { m_worldRegion, m_worldTopLeft, m_worldBottomRight, m_orientation, m_convex };
+    return region.classify(points);
+}
+
+/*!
+    \internal
+*/
+void QGeoClipRegion::clipPolygon(const QVector<QWorldPoint> &polygon,
+                                 QVector<QVector<QWorldPoint> > *clipped) const
+{
+    if (m_region.isEmpty()) {
+        clipped->resize(1);
+        (*clipped)[0] = polygon;
+        return;
+    }
+
+    if (!m_convex) {
+        Path subject;
+        Path clip;
+        QClipperUtils::worldPathToPath(polygon, &subject);
+        QClipperUtils::worldPathToPath(m_worldRegion, &clip);
+        c2t::clip2tri clipper;
+        clipper.addSubjectPath(subject, true);
+        clipper.addClipPolygon(clip);
+        Paths res = clipper.execute(c2t::clip2tri::Intersection, QtClipperLib::pftEvenOdd, QtClipperLib::pftEvenOdd);
+        QClipperUtils::pathsToWorldPaths(res, clipped);
+        return;
+    }
+
+    const Region<QWorldPoint> region = { m_worldRegion, m_worldTopLeft, m_worldBottomRight, m_orientation, m_convex };
+    region.clipPolygon(polygon, clipped);
+}
+
+/*!
+    \internal
+*/
+void QGeoClipRegion::clipPolyline(const QVector<QWorldPoint> &polyline,
+                                  QVector<QVector<QWorldPoint> > *clipped) const
+{
+    if (m_region.isEmpty()) {
+        clipped->resize(1);
+        (*clipped)[0] = polyline;
+        return;
+    }
+
+    if (!m_convex) {
+        Path subject;
+        Path clip;
+        QClipperUtils::worldPathToPath(polyline, &subject);
+        QClipperUtils::worldPathToPath(m_worldRegion, &clip);
+        c2t::clip2tri clipper;
+        clipper.addSubjectPath(subject, false);
+        clipper.addClipPolygon(clip);
+        Paths res = clipper.execute(c2t::clip2tri::Intersection);
+        QClipperUtils::pathsToWorldPaths(res, clipped);
+        return;
+    }
+
+    const Region<QWorldPoint> region = { m_worldRegion, m_worldTopLeft, m_worldBottomRight, m_orientation, m_convex };
+    region.clipPolyline(polyline, clipped);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,104 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOCLIPREGION_P_H
+#define QGEOCLIPREGION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qworldpoint_p.h>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoClipRegion
+{
+public:
+    enum Containment {
+        Outside,
+        Inside,
+        Intersecting
+    };
+
+    QGeoClipRegion();
+
+    void setRegion(const QVector<QDoubleVector2D> &region);
+    const QVector<QDoubleVector2D> &region() const { return m_region; }
+    bool isEmpty() const { return m_region.isEmpty(); }
+    bool isConvex() const { return m_convex; }
+
+    bool contains(const QDoubleVector2D &point) const;
+    Containment classify(const QDoubleVector2D &topLeft, const QDoubleVector2D &bottomRight) const;
+    Containment classify(const QVector<QDoubleVector2D> &points) const;
+
+    void clipPolygon(const QVector<QDoubleVector2D> &polygon,
+                     QVector<QVector<QDoubleVector2D> > *clipped) const;
+    void clipPolyline(const QVector<QDoubleVector2D> &polyline,
+                      QVector<QVector<QDoubleVector2D> > *clipped) const;
+
+    // Same as above for world points, against the region rounded to world points
+    bool contains(const QWorldPoint &point) const;
+    Containment classify(const QVector<QWorldPoint> &points) const;
+    void clipPolygon(const QVector<QWorldPoint> &polygon,
+                     QVector<QVector<QWorldPoint> > *clipped) const;
+    void clipPolyline(const QVector<QWorldPoint> &polyline,
+                      QVector<QVector<QWorldPoint> > *clipped) const;
+
+private:
+    QVector<QDoubleVector2D> m_region;
+    QDoubleVector2D m_topLeft;
+    QDoubleVector2D m_bottomRight;
+    QVector<QWorldPoint> m_worldRegion;
+    QWorldPoint m_worldTopLeft;
+    QWorldPoint m_worldBottomRight;
+    double m_orientation;
+    bool m_convex;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOCLIPREGION_P_H
@@ -34,15 +34,18 @@
 **
 ****************************************************************************/
 #include "qgeofiletilecache_p.h"
+#include "qgeofiletilecachewriter_p.h"
 
 #include "qgeotilespec_p.h"
 
 #include "qgeomappingmanager_p.h"
 
 #include <QDir>
+#include <QDataStream>
 #include <QStandardPaths>
 #include <QMetaType>
 #include <QPixmap>
+#include <QRunnable>
 #include <QDebug>
 
 Q_DECLARE_METATYPE(QList<QGeoTileSpec>)
@@ -65,6 +68,13 @@ public:
     QString format;
 };
 
+/* A tile already decoded to the pixel format textures are created from */
+class QGeoCachedTileDecoded
+{
+public:
+    QImage image;
+};
+
 void QCache3QTileEvictionPolicy::aboutToBeRemoved(const QGeoTileSpec &key, QSharedPointer<QGeoCachedTileDisk> obj)
 {
     Q_UNUSED(key);
@@ -79,6 +89,137 @@ void QCache3QTileEvictionPolicy::aboutToBeEvicted(const QGeoTileSpec &key, QShar
     // leave the pointer set if it's a real eviction
 }
 
+// Freshness information is kept next to the tile, in a file that is not mistaken for a tile
+static QString freshnessFilename(const QString &tileFilename)
+{
+    return tileFilename + QLatin1String(".freshness");
+}
+
+// Decoded tiles are kept next to the tile as well, compressed with zlib
+static QString decodedFilename(const QString &tileFilename)
+{
+    return tileFilename + QLatin1String(".decoded");
+}
+
+static const quint32 DecodedTileMagic = 0x51475444; // "QGTD"
+
+static QByteArray writeDecodedTile(const QImage &image)
+{
+    const QByteArray pixels = QByteArray::fromRawData(reinterpret_cast<const char *>(image.constBits()),
+                                                      image.bytesPerLine() * image.height());
+    QByteArray bytes;
+    QDataStream stream(&bytes, QIODevice::WriteOnly);
+    stream << DecodedTileMagic << qint32(image.width()) << qint32(image.height())
+           << qint32(image.format()) << qint32(image.bytesPerLine()) << qCompress(pixels, 1);
+    return bytes;
+}
+
+static QImage readDecodedTile(const QByteArray &bytes)
+{
+    if (bytes.isEmpty())
+        return QImage();
+
+    QDataStream stream(bytes);
+    quint32 magic = 0;
+    qint32 width = 0, height = 0, format = 0, bytesPerLine = 0;
+    QByteArray compressed;
+    stream >> magic >> width >> height >> format >> bytesPerLine >> compressed;
+    if (stream.status() != QDataStream::Ok || magic != DecodedTileMagic
+            || (format != QImage::Format_RGB32 && format != QImage::Format_ARGB32_Premultiplied)) {
+        return QImage();
+    }
+
+    const QByteArray pixels = qUncompress(compressed);
+    QImage image(width, height, QImage::Format(format));
+    if (image.isNull() || image.bytesPerLine() != bytesPerLine || pixels.size() != bytesPerLine * height)
+        return QImage();
+    memcpy(image.bits(), pixels.constData(), pixels.size());
+    return image;
+}
+
+static QGeoTileFreshness readFreshness(const QByteArray &bytes)
+{
+    QGeoTileFreshness freshness;
+    const QList<QByteArray> lines = bytes.split('\n');
+    if (lines.size() < 3)
+        return freshness;
+
+    bool ok = false;
+    freshness.etag = lines.at(0);
+    const qint64 lastModified = lines.at(1).toLongLong(&ok);
+    if (ok)
+        freshness.lastModified = QDateTime::fromMSecsSinceEpoch(lastModified, Qt::UTC);
+    const qint64 expires = lines.at(2).toLongLong(&ok);
+    if (ok)
+        freshness.expires = QDateTime::fromMSecsSinceEpoch(expires, Qt::UTC);
+    return freshness;
+}
+
+static QByteArray freshnessData(const QGeoTileFreshness &freshness)
+{
+    QByteArray bytes = freshness.etag + '\n';
+    if (freshness.lastModified.isValid())
+        bytes += QByteArray::number(freshness.lastModified.toMSecsSinceEpoch());
+    bytes += '\n';
+    if (freshness.expires.isValid())
+        bytes += QByteArray::number(freshness.expires.toMSecsSinceEpoch());
+    bytes += '\n';
+    return bytes;
+}
+
+/* Looks up tiles on the writer thread for loadFromDisk(). It only reads files,
+ * the caches are updated by diskTileLoaded() on the thread of the cache. */
+class QGeoFileTileCacheLoadJob : public QRunnable
+{
+public:
+    QGeoFileTileCacheLoadJob(QGeoFileTileCache *cache, const QGeoTileSpec &key, bool decoding)
+        : cache_(cache), key_(key), decoding_(decoding) {}
+
+    void run() Q_DECL_OVERRIDE;
+
+    QList<QPair<QGeoTileSpec, QString> > candidates;
+
+private:
+    void finish(const QGeoTileSpec &spec, const QImage &image,
+                const QByteArray &bytes, const QByteArray &decoded, int tileSize);
+
+    QGeoFileTileCache *cache_; // outlives the job, see QGeoFileTileCacheWriter::stop()
+    QGeoTileSpec key_;
+    bool decoding_;
+};
+
+void QGeoFileTileCacheLoadJob::run()
+{
+    for (const QPair<QGeoTileSpec, QString> &candidate : qAsConst(candidates)) {
+        if (decoding_) {
+            const QByteArray decoded = cache_->readFromDisk(decodedFilename(candidate.second));
+            const QImage image = readDecodedTile(decoded);
+            if (!image.isNull()) {
+                finish(candidate.first, image, QByteArray(), decoded, QFileInfo(candidate.second).size());
+                return;
+            }
+        }
+
+        const QByteArray bytes = cache_->readFromDisk(candidate.second);
+        QImage image;
+        if (!image.loadFromData(bytes))
+            continue;
+        if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
+            image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        finish(candidate.first, image, bytes, decoding_ ? writeDecodedTile(image) : QByteArray(), bytes.size());
+        return;
+    }
+    finish(QGeoTileSpec(), QImage(), QByteArray(), QByteArray(), 0);
+}
+
+void QGeoFileTileCacheLoadJob::finish(const QGeoTileSpec &spec, const QImage &image,
+                                      const QByteArray &bytes, const QByteArray &decoded, int tileSize)
+{
+    QMetaObject::invokeMethod(cache_, "diskTileLoaded", Qt::QueuedConnection,
+                              Q_ARG(QGeoTileSpec, key_), Q_ARG(QGeoTileSpec, spec), Q_ARG(QImage, image),
+                              Q_ARG(QByteArray, bytes), Q_ARG(QByteArray, decoded), Q_ARG(int, tileSize));
+}
+
 QGeoCachedTileDisk::~QGeoCachedTileDisk()
 {
     if (cache)
@@ -86,7 +227,8 @@ QGeoCachedTileDisk::~QGeoCachedTileDisk()
 }
 
 QGeoFileTileCache::QGeoFileTileCache(const QString &directory, QObject *parent)
-    : QAbstractGeoTileCache(parent), directory_(directory), minTextureUsage_(0), extraTextureUsage_(0)
+    : QAbstractGeoTileCache(parent), directory_(directory), writer_(new QGeoFileTileCacheWriter)
+    ,minTextureUsage_(0), extraTextureUsage_(0)
     ,costStrategyDisk_(ByteSize), costStrategyMemory_(ByteSize), costStrategyTexture_(ByteSize)
     ,isDiskCostSet_(false), isMemoryCostSet_(false), isTextureCostSet_(false)
 {
@@ -119,6 +261,7 @@ void QGeoFileTileCache::init()
     }
 
     QDir::root().mkpath(directory_);
+    writer_->start(QThread::LowPriority);
 
     // default values
     if (!isDiskCostSet_) { // If setMaxDiskUsage has not been called yet
@@ -229,12 +372,16 @@ QGeoFileTileCache::~QGeoFileTileCache()
         file.close();
     }
 #endif
+    // nothing is evicted past this point, see QCache3QTileEvictionPolicy::aboutToBeRemoved
+    writer_->stop();
+    delete writer_;
 }
 
 void QGeoFileTileCache::printStats()
 {
     textureCache_.printStats();
     memoryCache_.printStats();
+    decodedCache_.printStats();
     diskCache_.printStats();
 }
 
@@ -299,11 +446,33 @@ int QGeoFileTileCache::textureUsage() const
     return textureCache_.totalCost();
 }
 
+/*
+    Sets the size of the cache of decoded tiles, counted with the memory
+    cost strategy. This cache is disabled until a size is set, and once
+    enabled decoded tiles are stored on disk as well.
+*/
+void QGeoFileTileCache::setMaxDecodedUsage(int decodedUsage)
+{
+    decodedCache_.setMaxCost(decodedUsage);
+}
+
+int QGeoFileTileCache::maxDecodedUsage() const
+{
+    return decodedCache_.maxCost();
+}
+
+int QGeoFileTileCache::decodedUsage() const
+{
+    return decodedCache_.totalCost();
+}
+
 void QGeoFileTileCache::clearAll()
 {
     textureCache_.clear();
+    decodedCache_.clear();
     memoryCache_.clear();
     diskCache_.clear();
+    writer_->discard();
     QDir dir(directory_);
     dir.setNameFilters(QStringList() << QLatin1String("*-*-*-*.*"));
     dir.setFilter(QDir::Files);
@@ -323,20 +492,32 @@ void QGeoFileTileCache::clearMapId(const int mapId)
     for (const QGeoTileSpec &k : textureCache_.keys())
         if (k.mapId() == mapId)
             textureCache_.remove(k);
+    for (const QGeoTileSpec &k : decodedCache_.keys())
+        if (k.mapId() == mapId)
+            decodedCache_.remove(k);
 
     // TODO: It seems the cache leaves residues, like some tiles do not get picked up.
     // After the above calls, files that shouldnt be left behind are still on disk.
     // Do an additional pass and make sure what has to be deleted gets deleted.
+    writer_->flush();
     QDir dir(directory_);
     QStringList formats;
     formats << QLatin1String("*.*");
     QStringList files = dir.entryList(formats, QDir::Files);
     qWarning() << "Old tile data detected. Cache eviction left out "<< files.size() << "tiles";
-    for (const QString &tileFileName : files) {
+    const QString freshnessSuffix = freshnessFilename(QString());
+    const QString decodedSuffix = decodedFilename(QString());
+    for (const QString &fileName : files) {
+        // The sidecars go with their tile, as in evictFromDiskCache()
+        QString tileFileName = fileName;
+        if (tileFileName.endsWith(freshnessSuffix))
+            tileFileName.chop(freshnessSuffix.size());
+        else if (tileFileName.endsWith(decodedSuffix))
+            tileFileName.chop(decodedSuffix.size());
         QGeoTileSpec spec = filenameToTileSpec(tileFileName);
-        if (spec.mapId() != mapId)
+        if (spec.zoom() == -1 || spec.mapId() != mapId)
             continue;
-        QFile::remove(dir.filePath(tileFileName));
+        QFile::remove(dir.filePath(fileName));
     }
 }
 
@@ -378,6 +559,49 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::get(const QGeoTileSpec &spec)
     return getFromDisk(spec);
 }
 
+bool QGeoFileTileCache::contains(const QGeoTileSpec &spec, CacheAreas areas) const
+{
+    if ((areas & QAbstractGeoTileCache::MemoryCache)
+            && (textureCache_.contains(spec) || decodedCache_.contains(spec) || memoryCache_.contains(spec))) {
+        return true;
+    }
+    return (areas & QAbstractGeoTileCache::DiskCache) && diskCache_.contains(spec);
+}
+
+/*
+    Returns the freshness of the tile \a spec stored on disk. Tiles only in
+    memory have none, as they are not worth revalidating. The freshness is
+    read along with the tile in getFromDisk(), this neither touches the disk
+    nor counts as an access to the tile.
+*/
+QGeoTileFreshness QGeoFileTileCache::freshness(const QGeoTileSpec &spec)
+{
+    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.peek(spec);
+    if (!td)
+        return QGeoTileFreshness();
+    return td->freshness;
+}
+
+/*
+    Updates the freshness of the tile \a spec stored on disk, without
+    rewriting the tile itself.
+*/
+void QGeoFileTileCache::setFreshness(const QGeoTileSpec &spec, const QGeoTileFreshness &freshness)
+{
+    QSharedPointer<QGeoCachedTileDisk> td = diskCache_.peek(spec);
+    if (!td)
+        return;
+
+    if (td->freshnessLoaded && td->freshness == freshness)
+        return;
+    td->freshness = freshness;
+    td->freshnessLoaded = true;
+    if (freshness.isValid())
+        writer_->write(freshnessFilename(td->filename), freshnessData(freshness));
+    else
+        writer_->remove(freshnessFilename(td->filename));
+}
+
 void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
                            const QByteArray &bytes,
                            const QString &format,
@@ -386,6 +610,9 @@ void QGeoFileTileCache::insert(const QGeoTileSpec &spec,
     if (bytes.isEmpty())
         return;
 
+    // the decoded copy is out of date, the one on disk goes with the old tile
+    decodedCache_.remove(spec);
+
     if (areas & QAbstractGeoTileCache::DiskCache) {
         QString filename = tileSpecToFilename(spec, format, directory_);
         addToDiskCache(spec, filename, bytes);
@@ -467,7 +694,10 @@ QGeoTileSpec QGeoFileTileCache::filenameToTileSpecDefault(const QString &filenam
 
 void QGeoFileTileCache::evictFromDiskCache(QGeoCachedTileDisk *td)
 {
-    QFile::remove(td->filename);
+    td->cache->writer_->remove(td->filename);
+    td->cache->writer_->remove(freshnessFilename(td->filename));
+    // Also when decoding is disabled, an earlier run may have left a decoded copy
+    td->cache->writer_->remove(decodedFilename(td->filename));
 }
 
 void QGeoFileTileCache::evictFromMemoryCache(QGeoCachedTileMemory * /* tm  */)
@@ -481,10 +711,15 @@ QSharedPointer<QGeoCachedTileDisk> QGeoFileTileCache::addToDiskCache(const QGeoT
     td->filename = filename;
     td->cache = this;
 
+    // A decoded copy left by an earlier run counts against the budget, whether decoding is enabled or not
+    QFileInfo decoded(decodedFilename(filename));
+    if (decoded.exists())
+        td->decodedSize = decoded.size();
+
     int cost = 1;
     if (costStrategyDisk_ == ByteSize) {
         QFileInfo fi(filename);
-        cost = fi.size();
+        cost = fi.size() + td->decodedSize;
     }
     diskCache_.insert(spec, td, cost);
     return td;
@@ -496,16 +731,15 @@ bool QGeoFileTileCache::addToDiskCache(const QGeoTileSpec &spec, const QString &
     td->spec = spec;
     td->filename = filename;
     td->cache = this;
+    td->freshnessLoaded = true; // a new tile has none until setFreshness()
 
     int cost = 1;
     if (costStrategyDisk_ == ByteSize)
         cost = bytes.size();
 
+    // The index is updated right away, the file is written by writer_
     if (diskCache_.insert(spec, td, cost)) {
-        QFile file(filename);
-        file.open(QIODevice::WriteOnly);
-        file.write(bytes);
-        file.close();
+        writer_->write(filename, bytes);
         return true;
     }
     return false;
@@ -542,12 +776,30 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::addToTextureCache(const QGeoT
     return tt;
 }
 
+void QGeoFileTileCache::addToDecodedCache(const QGeoTileSpec &spec, const QImage &image)
+{
+    if (decodedCache_.maxCost() <= 0)
+        return;
+
+    QSharedPointer<QGeoCachedTileDecoded> tdec(new QGeoCachedTileDecoded);
+    tdec->image = image;
+
+    int cost = 1;
+    if (costStrategyMemory_ == ByteSize)
+        cost = image.width() * image.height() * image.depth() / 8;
+    decodedCache_.insert(spec, tdec, cost);
+}
+
 QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileSpec &spec)
 {
     QSharedPointer<QGeoTileTexture> tt = textureCache_.object(spec);
     if (tt)
         return tt;
 
+    QSharedPointer<QGeoCachedTileDecoded> tdec = decodedCache_.object(spec);
+    if (tdec)
+        return addToTextureCache(spec, tdec->image);
+
     QSharedPointer<QGeoCachedTileMemory> tm = memoryCache_.object(spec);
     if (tm) {
         QImage image;
@@ -555,6 +807,11 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromMemory(const QGeoTileS
             handleError(spec, QLatin1String("Problem with tile image"));
             return QSharedPointer<QGeoTileTexture>(0);
         }
+        if (decodedCache_.maxCost() > 0) {
+            if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
+                image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+            addToDecodedCache(spec, image);
+        }
         QSharedPointer<QGeoTileTexture> tt = addToTextureCache(spec, image);
         if (tt)
             return tt;
@@ -566,11 +823,29 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
 {
     QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
     if (td) {
+        if (!td->freshnessLoaded) {
+            td->freshness = readFreshness(readFromDisk(freshnessFilename(td->filename)));
+            td->freshnessLoaded = true;
+        }
+
+        const bool decoding = decodedCache_.maxCost() > 0;
+        if (decoding) {
+            const QByteArray decoded = readFromDisk(decodedFilename(td->filename));
+            const QImage image = readDecodedTile(decoded);
+            if (!image.isNull()) {
+                // left by an earlier run, account for it now
+                if (!td->decodedSize) {
+                    td->decodedSize = decoded.size();
+                    if (costStrategyDisk_ == ByteSize)
+                        diskCache_.insert(spec, td, QFileInfo(td->filename).size() + td->decodedSize);
+                }
+                addToDecodedCache(spec, image);
+                return addToTextureCache(spec, image);
+            }
+        }
+
         const QString format = QFileInfo(td->filename).suffix();
-        QFile file(td->filename);
-        file.open(QIODevice::ReadOnly);
-        QByteArray bytes = file.readAll();
-        file.close();
+        QByteArray bytes = readFromDisk(td->filename);
 
         QImage image;
         // Some tiles from the servers could be valid images but the tile fetcher
@@ -593,6 +868,17 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
         if (image.format() != QImage::Format_RGB32 && image.format() != QImage::Format_ARGB32_Premultiplied)
             image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
 
+        if (decoding) {
+            const QByteArray decoded = writeDecodedTile(image);
+            const int cost = costStrategyDisk_ == ByteSize ? bytes.size() + decoded.size() : 1;
+            td->decodedSize = decoded.size();
+            if (diskCache_.insert(spec, td, cost))
+                writer_->write(decodedFilename(td->filename), decoded);
+            else
+                td->decodedSize = 0;
+            addToDecodedCache(spec, image);
+        }
+
         addToMemoryCache(spec, bytes, format);
         QSharedPointer<QGeoTileTexture> tt = addToTextureCache(td->spec, image);
         if (tt)
@@ -602,6 +888,70 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCache::getFromDisk(const QGeoTileSpe
     return QSharedPointer<QGeoTileTexture>();
 }
 
+/*
+    Starts reading the first of \a specs stored on disk on the writer thread,
+    and returns false if none of them is. The texture is added to the memory
+    caches before loadedFromDisk() is emitted.
+*/
+bool QGeoFileTileCache::loadFromDisk(const QGeoTileSpec &key, const QList<QGeoTileSpec> &specs)
+{
+    QGeoFileTileCacheLoadJob *job = new QGeoFileTileCacheLoadJob(this, key, decodedCache_.maxCost() > 0);
+    for (const QGeoTileSpec &spec : specs) {
+        QSharedPointer<QGeoCachedTileDisk> td = diskCache_.peek(spec);
+        if (td)
+            job->candidates.append(qMakePair(spec, td->filename));
+    }
+    if (job->candidates.isEmpty()) {
+        delete job;
+        return false;
+    }
+    writer_->post(job);
+    return true;
+}
+
+void QGeoFileTileCache::diskTileLoaded(const QGeoTileSpec &key, const QGeoTileSpec &spec, const QImage &image,
+                                       const QByteArray &bytes, const QByteArray &decoded, int tileSize)
+{
+    QSharedPointer<QGeoTileTexture> tt;
+    if (!image.isNull() && !isTileBogus(bytes)) {
+        tt = textureCache_.object(spec);
+        if (!tt) {
+            QSharedPointer<QGeoCachedTileDisk> td = diskCache_.object(spec);
+            const bool decoding = decodedCache_.maxCost() > 0;
+            if (td && decoding && !decoded.isEmpty() && !td->decodedSize) {
+                // Same accounting as getFromDisk(), for a decoded copy either found or to be written
+                const int cost = costStrategyDisk_ == ByteSize ? tileSize + decoded.size() : 1;
+                td->decodedSize = decoded.size();
+                if (!diskCache_.insert(spec, td, cost))
+                    td->decodedSize = 0;
+                else if (!bytes.isEmpty())
+                    writer_->write(decodedFilename(td->filename), decoded);
+            }
+            if (td && !bytes.isEmpty())
+                addToMemoryCache(spec, bytes, QFileInfo(td->filename).suffix());
+            if (decoding)
+                addToDecodedCache(spec, image);
+            tt = addToTextureCache(spec, image);
+        }
+    }
+    emit loadedFromDisk(key, tt);
+}
+
+/*
+    Reads a cache file, or the bytes still waiting to be written to it.
+*/
+QByteArray QGeoFileTileCache::readFromDisk(const QString &filename) const
+{
+    QByteArray bytes;
+    if (writer_->queued(filename, &bytes))
+        return bytes;
+
+    QFile file(filename);
+    if (file.open(QIODevice::ReadOnly))
+        bytes = file.readAll();
+    return bytes;
+}
+
 bool QGeoFileTileCache::isTileBogus(const QByteArray &bytes) const
 {
     if (bytes.size() == 7 && bytes == QByteArrayLiteral("NoRetry"))
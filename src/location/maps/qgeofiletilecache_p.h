@@ -68,7 +68,10 @@ class QGeoMappingManager;
 
 class QGeoTile;
 class QGeoCachedTileMemory;
+class QGeoCachedTileDecoded;
 class QGeoFileTileCache;
+class QGeoFileTileCacheWriter;
+class QGeoFileTileCacheLoadJob;
 
 class QPixmap;
 class QThread;
@@ -78,11 +81,15 @@ class QThread;
 class QGeoCachedTileDisk
 {
 public:
+    QGeoCachedTileDisk() : freshnessLoaded(false), decodedSize(0), cache(0) {}
     ~QGeoCachedTileDisk();
 
     QGeoTileSpec spec;
     QString filename;
     QString format;
+    QGeoTileFreshness freshness; // read from disk along with the tile
+    bool freshnessLoaded;
+    int decodedSize; // size of the decoded copy stored next to the tile, if any
     QGeoFileTileCache *cache;
 };
 
@@ -115,6 +122,11 @@ public:
     int maxTextureUsage() const Q_DECL_OVERRIDE;
     int minTextureUsage() const Q_DECL_OVERRIDE;
     int textureUsage() const Q_DECL_OVERRIDE;
+
+    void setMaxDecodedUsage(int decodedUsage);
+    int maxDecodedUsage() const;
+    int decodedUsage() const;
+
     void clearAll() Q_DECL_OVERRIDE;
     void clearMapId(const int mapId);
     void setCostStrategyDisk(CostStrategy costStrategy) Q_DECL_OVERRIDE;
@@ -126,6 +138,11 @@ public:
 
 
     QSharedPointer<QGeoTileTexture> get(const QGeoTileSpec &spec) Q_DECL_OVERRIDE;
+    QSharedPointer<QGeoTileTexture> getFromMemory(const QGeoTileSpec &spec) Q_DECL_OVERRIDE;
+    bool contains(const QGeoTileSpec &spec, CacheAreas areas = AllCaches) const Q_DECL_OVERRIDE;
+    QGeoTileFreshness freshness(const QGeoTileSpec &spec) Q_DECL_OVERRIDE;
+    void setFreshness(const QGeoTileSpec &spec, const QGeoTileFreshness &freshness) Q_DECL_OVERRIDE;
+    bool loadFromDisk(const QGeoTileSpec &key, const QList<QGeoTileSpec> &specs) Q_DECL_OVERRIDE;
 
     // can be called without a specific tileCache pointer
     static void evictFromDiskCache(QGeoCachedTileDisk *td);
@@ -150,8 +167,9 @@ protected:
     bool addToDiskCache(const QGeoTileSpec &spec, const QString &filename, const QByteArray &bytes);
     void addToMemoryCache(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
     QSharedPointer<QGeoTileTexture> addToTextureCache(const QGeoTileSpec &spec, const QImage &image);
-    QSharedPointer<QGeoTileTexture> getFromMemory(const QGeoTileSpec &spec);
+    void addToDecodedCache(const QGeoTileSpec &spec, const QImage &image);
     QSharedPointer<QGeoTileTexture> getFromDisk(const QGeoTileSpec &spec);
+    QByteArray readFromDisk(const QString &filename) const;
 
     virtual bool isTileBogus(const QByteArray &bytes) const;
     virtual QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const;
@@ -160,8 +178,10 @@ protected:
     QCache3Q<QGeoTileSpec, QGeoCachedTileDisk, QCache3QTileEvictionPolicy > diskCache_;
     QCache3Q<QGeoTileSpec, QGeoCachedTileMemory > memoryCache_;
     QCache3Q<QGeoTileSpec, QGeoTileTexture > textureCache_;
+    QCache3Q<QGeoTileSpec, QGeoCachedTileDecoded > decodedCache_;
 
     QString directory_;
+    QGeoFileTileCacheWriter *writer_;
 
     int minTextureUsage_;
     int extraTextureUsage_;
@@ -171,6 +191,13 @@ protected:
     bool isDiskCostSet_;
     bool isMemoryCostSet_;
     bool isTextureCostSet_;
+
+private Q_SLOTS:
+    void diskTileLoaded(const QGeoTileSpec &key, const QGeoTileSpec &spec, const QImage &image,
+                        const QByteArray &bytes, const QByteArray &decoded, int tileSize);
+
+private:
+    friend class QGeoFileTileCacheLoadJob;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,298 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeofiletilecachewriter_p.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QSet>
+
+#if defined(Q_OS_UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QGeoFileTileCacheWriter::QGeoFileTileCacheWriter(QObject *parent)
+    : QThread(parent), queuedBytes_(0), maxQueuedBytes_(8 * 1024 * 1024), stop_(false),
+      syncWrites_(false)
+{
+}
+
+QGeoFileTileCacheWriter::~QGeoFileTileCacheWriter()
+{
+    stop();
+}
+
+void QGeoFileTileCacheWriter::write(const QString &filename, const QByteArray &bytes)
+{
+    Operation op;
+    op.bytes = bytes;
+    op.remove = false;
+    enqueue(filename, op);
+}
+
+void QGeoFileTileCacheWriter::remove(const QString &filename)
+{
+    Operation op;
+    op.remove = true;
+    enqueue(filename, op);
+}
+
+void QGeoFileTileCacheWriter::enqueue(const QString &filename, const Operation &op)
+{
+    QMutexLocker locker(&mutex_);
+
+    // Back-pressure: whoever delivers tiles waits for the disk once too much is queued
+    while (queuedBytes_ > 0 && queuedBytes_ + op.bytes.size() > maxQueuedBytes_
+           && isRunning() && !stop_) {
+        drained_.wait(&mutex_);
+    }
+
+    // Only the last operation on a file matters, earlier ones are dropped
+    QMap<QString, Operation>::iterator it = queue_.find(filename);
+    if (it != queue_.end()) {
+        queuedBytes_ -= it->bytes.size();
+        *it = op;
+    } else {
+        queue_.insert(filename, op);
+    }
+    queuedBytes_ += op.bytes.size();
+    wake_.wakeOne();
+}
+
+bool QGeoFileTileCacheWriter::queued(const QString &filename, QByteArray *bytes) const
+{
+    QMutexLocker locker(&mutex_);
+    QMap<QString, Operation>::const_iterator it = queue_.constFind(filename);
+    if (it == queue_.constEnd()) {
+        it = inFlight_.constFind(filename);
+        if (it == inFlight_.constEnd())
+            return false;
+    }
+    if (bytes)
+        *bytes = it->remove ? QByteArray() : it->bytes;
+    return true;
+}
+
+void QGeoFileTileCacheWriter::post(QRunnable *job)
+{
+    {
+        QMutexLocker locker(&mutex_);
+        if (isRunning() && !stop_) {
+            jobs_.append(job);
+            wake_.wakeOne();
+            return;
+        }
+    }
+    job->run();
+    if (job->autoDelete())
+        delete job;
+}
+
+/*
+    Blocks until all the operations queued so far are on disk.
+*/
+void QGeoFileTileCacheWriter::flush()
+{
+    QMutexLocker locker(&mutex_);
+    if (!isRunning()) {
+        while (!queue_.isEmpty())
+            processBatch(locker);
+        return;
+    }
+    while (!queue_.isEmpty() || !inFlight_.isEmpty())
+        drained_.wait(&mutex_);
+}
+
+/*
+    Drops the queued operations and waits for the batch being written.
+*/
+void QGeoFileTileCacheWriter::discard()
+{
+    QMutexLocker locker(&mutex_);
+    for (QMap<QString, Operation>::const_iterator it = queue_.constBegin(); it != queue_.constEnd(); ++it)
+        queuedBytes_ -= it->bytes.size();
+    queue_.clear();
+    while (!inFlight_.isEmpty())
+        drained_.wait(&mutex_);
+    drained_.wakeAll();
+}
+
+void QGeoFileTileCacheWriter::stop()
+{
+    {
+        QMutexLocker locker(&mutex_);
+        stop_ = true;
+        wake_.wakeOne();
+        drained_.wakeAll();
+    }
+    wait();
+    flush(); // in case the thread was never started
+
+    QMutexLocker locker(&mutex_);
+    for (QRunnable *job : qAsConst(jobs_)) {
+        if (job->autoDelete())
+            delete job;
+    }
+    jobs_.clear();
+}
+
+void QGeoFileTileCacheWriter::setMaxQueuedBytes(qint64 maxQueuedBytes)
+{
+    QMutexLocker locker(&mutex_);
+    maxQueuedBytes_ = maxQueuedBytes;
+    drained_.wakeAll();
+}
+
+qint64 QGeoFileTileCacheWriter::maxQueuedBytes() const
+{
+    QMutexLocker locker(&mutex_);
+    return maxQueuedBytes_;
+}
+
+qint64 QGeoFileTileCacheWriter::queuedBytes() const
+{
+    QMutexLocker locker(&mutex_);
+    return queuedBytes_;
+}
+
+void QGeoFileTileCacheWriter::setSyncWrites(bool syncWrites)
+{
+    QMutexLocker locker(&mutex_);
+    syncWrites_ = syncWrites;
+}
+
+bool QGeoFileTileCacheWriter::syncWrites() const
+{
+    QMutexLocker locker(&mutex_);
+    return syncWrites_;
+}
+
+void QGeoFileTileCacheWriter::run()
+{
+    QMutexLocker locker(&mutex_);
+    forever {
+        while (queue_.isEmpty() && jobs_.isEmpty() && !stop_)
+            wake_.wait(&mutex_);
+        if (!jobs_.isEmpty() && !stop_) {
+            // Someone is waiting for a read, a batch of writes can wait
+            QRunnable *job = jobs_.takeFirst();
+            locker.unlock();
+            job->run();
+            if (job->autoDelete())
+                delete job;
+            locker.relock();
+            continue;
+        }
+        if (queue_.isEmpty())
+            return;
+        processBatch(locker);
+    }
+}
+
+/*
+    Writes everything queued, with the mutex released. Readers still find the
+    batch in inFlight_ until it is complete.
+*/
+void QGeoFileTileCacheWriter::processBatch(QMutexLocker &locker)
+{
+    inFlight_.swap(queue_);
+    const bool sync = syncWrites_;
+    locker.unlock();
+
+    // The queue is sorted by file name, so files sharing a directory are
+    // handled together and every directory is synced once
+    QSet<QString> directories;
+    QString directory;
+    for (QMap<QString, Operation>::const_iterator it = inFlight_.constBegin(); it != inFlight_.constEnd(); ++it) {
+        if (it->remove) {
+            QFile::remove(it.key());
+        } else {
+            QFile file(it.key());
+            if (file.open(QIODevice::WriteOnly)) {
+                file.write(it->bytes);
+                if (sync && file.flush())
+                    syncFile(file.handle());
+            }
+        }
+
+        if (sync) {
+            const QString path = QFileInfo(it.key()).path();
+            if (path != directory) {
+                directory = path;
+                directories.insert(directory);
+            }
+        }
+    }
+    for (const QString &path : qAsConst(directories))
+        syncDirectory(path);
+
+    locker.relock();
+    for (QMap<QString, Operation>::const_iterator it = inFlight_.constBegin(); it != inFlight_.constEnd(); ++it)
+        queuedBytes_ -= it->bytes.size();
+    inFlight_.clear();
+    drained_.wakeAll();
+}
+
+void QGeoFileTileCacheWriter::syncFile(int fd)
+{
+#if defined(Q_OS_LINUX)
+    ::fdatasync(fd);
+#elif defined(Q_OS_UNIX)
+    ::fsync(fd);
+#else
+    Q_UNUSED(fd);
+#endif
+}
+
+// Makes the directory entries of created and removed files durable
+void QGeoFileTileCacheWriter::syncDirectory(const QString &path)
+{
+#if defined(Q_OS_UNIX)
+    const int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY);
+    if (fd < 0)
+        return;
+    ::fsync(fd);
+    ::close(fd);
+#else
+    Q_UNUSED(path);
+#endif
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,130 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOFILETILECACHEWRITER_P_H
+#define QGEOFILETILECACHEWRITER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QMap>
+#include <QList>
+#include <QByteArray>
+#include <QString>
+
+QT_BEGIN_NAMESPACE
+
+/* Performs the file operations of a QGeoFileTileCache on its own thread.
+ * Operations queued while a batch is on disk are coalesced per file and
+ * written in directory order. Producers block once more than
+ * maxQueuedBytes() are waiting to be written. Reads posted as jobs run
+ * ahead of the pending writes. */
+class QRunnable;
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoFileTileCacheWriter : public QThread
+{
+public:
+    explicit QGeoFileTileCacheWriter(QObject *parent = 0);
+    ~QGeoFileTileCacheWriter();
+
+    void write(const QString &filename, const QByteArray &bytes);
+    void remove(const QString &filename);
+
+    // Returns true if an operation on filename is still pending, with the
+    // bytes to be written, or an empty array if the file is being removed.
+    bool queued(const QString &filename, QByteArray *bytes) const;
+
+    // Runs job on the writer thread, or right away if the thread is not running.
+    // Jobs still waiting when the writer stops are dropped.
+    void post(QRunnable *job);
+
+    void flush();
+    void discard();
+    void stop();
+
+    void setMaxQueuedBytes(qint64 maxQueuedBytes);
+    qint64 maxQueuedBytes() const;
+    qint64 queuedBytes() const;
+
+    // Makes every written file durable before the batch completes, off by default
+    void setSyncWrites(bool syncWrites);
+    bool syncWrites() const;
+
+protected:
+    void run() Q_DECL_OVERRIDE;
+
+private:
+    struct Operation
+    {
+        QByteArray bytes;
+        bool remove;
+    };
+
+    void enqueue(const QString &filename, const Operation &op);
+    void processBatch(QMutexLocker &locker);
+    static void syncFile(int fd);
+    static void syncDirectory(const QString &path);
+
+    mutable QMutex mutex_;
+    QWaitCondition wake_;
+    QWaitCondition drained_;
+    QMap<QString, Operation> queue_;
+    QMap<QString, Operation> inFlight_; // read-only while unlocked
+    QList<QRunnable *> jobs_;
+    qint64 queuedBytes_;
+    qint64 maxQueuedBytes_;
+    bool stop_;
+    bool syncWrites_;
+
+    Q_DISABLE_COPY(QGeoFileTileCacheWriter)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOFILETILECACHEWRITER_P_H
@@ -40,13 +40,14 @@
 #include <QtPositioning/private/qclipperutils_p.h>
 #include <QSize>
 #include <QtGui/QMatrix4x4>
+#include <QtCore/private/qsimd_p.h>
 #include <cmath>
 
 namespace {
     static const double defaultTileSize = 256.0;
     static const QDoubleVector3D xyNormal(0.0, 0.0, 1.0);
     static const QGeoProjectionWebMercator::Plane xyPlane(QDoubleVector3D(0,0,0), QDoubleVector3D(0,0,1));
-    static const QList<QDoubleVector2D> mercatorGeometry = {
+    static const QVector<QDoubleVector2D> mercatorGeometry = {
                                                 QDoubleVector2D(-1.0,0.0),
                                                 QDoubleVector2D( 2.0,0.0),
                                                 QDoubleVector2D( 2.0,1.0),
@@ -63,6 +64,46 @@ static QMatrix4x4 toMatrix4x4(const QDoubleMatrix4x4 &m)
 
 QT_BEGIN_NAMESPACE
 
+// Same as transformation * QDoubleVector3D(point * scale, 0), with the matrix loaded once
+template <typename Point>
+static void transformToItemPositions(const QDoubleMatrix4x4 &transformation, double scale,
+                                     const Point *points, QDoubleVector2D *itemPositions, int count)
+{
+    // Scaling by a power of two is exact, so the scale is folded into the matrix
+    const double *t = transformation.constData(); // column-major
+    const double m[16] = {
+        t[0] * scale, t[1] * scale, t[2], t[3] * scale,
+        t[4] * scale, t[5] * scale, t[6], t[7] * scale,
+        t[8], t[9], t[10], t[11],
+        t[12], t[13], t[14], t[15]
+    };
+#ifdef __SSE2__
+    const __m128d column0 = _mm_loadu_pd(m);
+    const __m128d column1 = _mm_loadu_pd(m + 4);
+    const __m128d column3 = _mm_loadu_pd(m + 12);
+    const __m128d w0 = _mm_set1_pd(m[3]);
+    const __m128d w1 = _mm_set1_pd(m[7]);
+    const __m128d w3 = _mm_set1_pd(m[15]);
+    for (int i = 0; i < count; ++i) {
+        const __m128d x = _mm_set1_pd(double(points[i].x()));
+        const __m128d y = _mm_set1_pd(double(points[i].y()));
+        const __m128d p = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, column0), _mm_mul_pd(y, column1)), column3);
+        const __m128d w = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, w0), _mm_mul_pd(y, w1)), w3);
+        double result[2];
+        _mm_storeu_pd(result, _mm_div_pd(p, w));
+        itemPositions[i] = QDoubleVector2D(result[0], result[1]);
+    }
+#else
+    for (int i = 0; i < count; ++i) {
+        const double x = double(points[i].x());
+        const double y = double(points[i].y());
+        const double w = x * m[3] + y * m[7] + m[15];
+        itemPositions[i] = QDoubleVector2D((x * m[0] + y * m[4] + m[12]) / w,
+                                           (x * m[1] + y * m[5] + m[13]) / w);
+    }
+#endif
+}
+
 QGeoProjection::QGeoProjection()
 {
 
@@ -183,6 +224,27 @@ QDoubleVector2D QGeoProjectionWebMercator::wrapMapProjection(const QDoubleVector
     return QDoubleVector2D(x, projection.y());
 }
 
+// Same as above, in world units
+void QGeoProjectionWebMercator::wrapMapProjection(const QWorldPoint *projections, QWorldPoint *wrappedProjections, int count) const
+{
+    const qint64 world = QWorldPoint::worldSize();
+    const qint64 half = world / 2;
+    const qint64 center = std::llround(m_cameraCenterXMercator * double(world));
+    for (int i = 0; i < count; ++i) {
+        QWorldPoint p = projections[i];
+        if (p.isValid()) {
+            if (center < half) {
+                if (p.x() - center > half)
+                    p.setX(p.x() - world);
+            } else if (center > half) {
+                if (p.x() - center < -half)
+                    p.setX(p.x() + world);
+            }
+        }
+        wrappedProjections[i] = p;
+    }
+}
+
 QDoubleVector2D QGeoProjectionWebMercator::unwrapMapProjection(const QDoubleVector2D &wrappedProjection) const
 {
     double x = wrappedProjection.x();
@@ -198,6 +260,21 @@ QDoubleVector2D QGeoProjectionWebMercator::wrappedMapProjectionToItemPosition(co
     return (m_transformation * wrappedProjection).toVector2D();
 }
 
+void QGeoProjectionWebMercator::geoToMapProjection(const QGeoCoordinate *coordinates, QDoubleVector2D *projections, int count) const
+{
+    QWebMercator::coordToMercator(coordinates, projections, count);
+}
+
+void QGeoProjectionWebMercator::wrappedMapProjectionToItemPosition(const QDoubleVector2D *wrappedProjections, QDoubleVector2D *itemPositions, int count) const
+{
+    transformToItemPositions(m_transformation, 1.0, wrappedProjections, itemPositions, count);
+}
+
+void QGeoProjectionWebMercator::wrappedMapProjectionToItemPosition(const QWorldPoint *wrappedProjections, QDoubleVector2D *itemPositions, int count) const
+{
+    transformToItemPositions(m_transformation, 1.0 / double(QWorldPoint::worldSize()), wrappedProjections, itemPositions, count);
+}
+
 QDoubleVector2D QGeoProjectionWebMercator::itemPositionToWrappedMapProjection(const QDoubleVector2D &itemPosition) const
 {
     QDoubleVector2D pos = itemPosition;
@@ -320,20 +397,34 @@ bool QGeoProjectionWebMercator::isProjectable(const QDoubleVector2D &wrappedProj
     return true;
 }
 
-QList<QDoubleVector2D> QGeoProjectionWebMercator::visibleRegion() const
+QVector<QDoubleVector2D> QGeoProjectionWebMercator::visibleRegion() const
 {
     if (m_visibleRegionDirty)
         const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
     return m_visibleRegion;
 }
 
-QList<QDoubleVector2D> QGeoProjectionWebMercator::projectableRegion() const
+QVector<QDoubleVector2D> QGeoProjectionWebMercator::projectableRegion() const
 {
     if (m_visibleRegionDirty)
         const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
     return m_projectableRegion;
 }
 
+const QGeoClipRegion &QGeoProjectionWebMercator::visibleClipRegion() const
+{
+    if (m_visibleRegionDirty)
+        const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
+    return m_visibleClipRegion;
+}
+
+const QGeoClipRegion &QGeoProjectionWebMercator::projectableClipRegion() const
+{
+    if (m_visibleRegionDirty)
+        const_cast<QGeoProjectionWebMercator *>(this)->updateVisibleRegion();
+    return m_projectableClipRegion;
+}
+
 QDoubleVector2D QGeoProjectionWebMercator::viewportToWrappedMapProjection(const QDoubleVector2D &itemPosition) const
 {
     double s;
@@ -507,13 +598,13 @@ void QGeoProjectionWebMercator::updateVisibleRegion()
     double leftX = geoToWrappedMapProjection(QGeoCoordinate(0, mapLeftLongitude)).x();
     double rightX = geoToWrappedMapProjection(QGeoCoordinate(0, mapRightLongitude)).x();
 
-    QList<QDoubleVector2D> mapRect;
+    QVector<QDoubleVector2D> mapRect;
     mapRect.push_back(QDoubleVector2D(leftX, 1.0));
     mapRect.push_back(QDoubleVector2D(rightX, 1.0));
     mapRect.push_back(QDoubleVector2D(rightX, 0.0));
     mapRect.push_back(QDoubleVector2D(leftX, 0.0));
 
-    QList<QDoubleVector2D> viewportRect;
+    QVector<QDoubleVector2D> viewportRect;
     viewportRect.push_back(bl);
     viewportRect.push_back(br);
     viewportRect.push_back(tr);
@@ -521,13 +612,13 @@ void QGeoProjectionWebMercator::updateVisibleRegion()
 
     c2t::clip2tri clipper;
     clipper.clearClipper();
-    clipper.addSubjectPath(QClipperUtils::qListToPath(mapRect), true);
-    clipper.addClipPolygon(QClipperUtils::qListToPath(viewportRect));
+    clipper.addSubjectPath(QClipperUtils::qVectorToPath(mapRect), true);
+    clipper.addClipPolygon(QClipperUtils::qVectorToPath(viewportRect));
 
     Paths res = clipper.execute(c2t::clip2tri::Intersection);
     m_visibleRegion.clear();
     if (res.size())
-        m_visibleRegion = QClipperUtils::pathToQList(res[0]); // Intersection between two convex quadrilaterals should always be a single polygon
+        m_visibleRegion = QClipperUtils::pathToQVector(res[0]); // Intersection between two convex quadrilaterals should always be a single polygon
 
     m_projectableRegion.clear();
     mapRect.clear();
@@ -556,7 +647,7 @@ void QGeoProjectionWebMercator::updateVisibleRegion()
         QDoubleVector2D br = nearPlaneXYIntersection.m_point
                             + squareHalfSide * nearPlaneXYIntersection.m_direction;
 
-        QList<QDoubleVector2D> projectableRect;
+        QVector<QDoubleVector2D> projectableRect;
         projectableRect.push_back(bl);
         projectableRect.push_back(br);
         projectableRect.push_back(tr);
@@ -565,15 +656,18 @@ void QGeoProjectionWebMercator::updateVisibleRegion()
 
         c2t::clip2tri clipperProjectable;
         clipperProjectable.clearClipper();
-        clipperProjectable.addSubjectPath(QClipperUtils::qListToPath(mapRect), true);
-        clipperProjectable.addClipPolygon(QClipperUtils::qListToPath(projectableRect));
+        clipperProjectable.addSubjectPath(QClipperUtils::qVectorToPath(mapRect), true);
+        clipperProjectable.addClipPolygon(QClipperUtils::qVectorToPath(projectableRect));
 
         Paths resProjectable = clipperProjectable.execute(c2t::clip2tri::Intersection);
         if (resProjectable.size())
-            m_projectableRegion = QClipperUtils::pathToQList(resProjectable[0]); // Intersection between two convex quadrilaterals should always be a single polygon
+            m_projectableRegion = QClipperUtils::pathToQVector(resProjectable[0]); // Intersection between two convex quadrilaterals should always be a single polygon
         else
             m_projectableRegion = viewportRect;
     }
+
+    m_visibleClipRegion.setRegion(m_visibleRegion);
+    m_projectableClipRegion.setRegion(m_projectableRegion);
 }
 
 /*
@@ -50,7 +50,9 @@
 
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeoclipregion_p.h>
 #include <QtPositioning/private/qdoublematrix4x4_p.h>
+#include <QtCore/QVector>
 
 QT_BEGIN_NAMESPACE
 
@@ -72,8 +74,11 @@ public:
     virtual double mapHeight() const = 0;
 
     virtual bool isProjectable(const QDoubleVector2D &wrappedProjection) const = 0;
-    virtual QList<QDoubleVector2D> visibleRegion() const = 0;
-    virtual QList<QDoubleVector2D> projectableRegion() const = 0;
+    virtual QVector<QDoubleVector2D> visibleRegion() const = 0;
+    virtual QVector<QDoubleVector2D> projectableRegion() const = 0;
+    // Both regions, prepared for clipping, rebuilt once per camera change
+    virtual const QGeoClipRegion &visibleClipRegion() const = 0;
+    virtual const QGeoClipRegion &projectableClipRegion() const = 0;
 
     // Conversion methods for QGeoCoordinate <-> screen.
     // This currently assumes that the "MapProjection" space is [0, 1][0, 1] for every type of possibly supported map projection
@@ -86,6 +91,13 @@ public:
     virtual QDoubleVector2D wrappedMapProjectionToItemPosition(const QDoubleVector2D &wrappedProjection) const = 0;
     virtual QDoubleVector2D itemPositionToWrappedMapProjection(const QDoubleVector2D &itemPosition) const = 0;
 
+    // Batch versions of the conversions above, for the geometry of map items
+    virtual void geoToMapProjection(const QGeoCoordinate *coordinates, QDoubleVector2D *projections, int count) const = 0;
+    virtual void wrappedMapProjectionToItemPosition(const QDoubleVector2D *wrappedProjections, QDoubleVector2D *itemPositions, int count) const = 0;
+    // and on world points, which are passed through by wrapMapProjection() when invalid
+    virtual void wrapMapProjection(const QWorldPoint *projections, QWorldPoint *wrappedProjections, int count) const = 0;
+    virtual void wrappedMapProjectionToItemPosition(const QWorldPoint *wrappedProjections, QDoubleVector2D *itemPositions, int count) const = 0;
+
     // Convenience methods to avoid the chain itemPositionToWrappedProjection(wrapProjection(geoToProjection()))
     virtual QGeoCoordinate itemPositionToCoordinate(const QDoubleVector2D &pos, bool clipToViewport = true) const = 0;
     virtual QDoubleVector2D coordinateToItemPosition(const QGeoCoordinate &coordinate, bool clipToViewport = true) const = 0;
@@ -119,6 +131,11 @@ public:
     QDoubleVector2D wrappedMapProjectionToItemPosition(const QDoubleVector2D &wrappedProjection) const Q_DECL_OVERRIDE;
     QDoubleVector2D itemPositionToWrappedMapProjection(const QDoubleVector2D &itemPosition) const Q_DECL_OVERRIDE;
 
+    void geoToMapProjection(const QGeoCoordinate *coordinates, QDoubleVector2D *projections, int count) const Q_DECL_OVERRIDE;
+    void wrappedMapProjectionToItemPosition(const QDoubleVector2D *wrappedProjections, QDoubleVector2D *itemPositions, int count) const Q_DECL_OVERRIDE;
+    void wrapMapProjection(const QWorldPoint *projections, QWorldPoint *wrappedProjections, int count) const Q_DECL_OVERRIDE;
+    void wrappedMapProjectionToItemPosition(const QWorldPoint *wrappedProjections, QDoubleVector2D *itemPositions, int count) const Q_DECL_OVERRIDE;
+
     QGeoCoordinate itemPositionToCoordinate(const QDoubleVector2D &pos, bool clipToViewport = true) const Q_DECL_OVERRIDE;
     QDoubleVector2D coordinateToItemPosition(const QGeoCoordinate &coordinate, bool clipToViewport = true) const Q_DECL_OVERRIDE;
     QDoubleVector2D geoToWrappedMapProjection(const QGeoCoordinate &coordinate) const Q_DECL_OVERRIDE;
@@ -126,8 +143,10 @@ public:
     QMatrix4x4 quickItemTransformation(const QGeoCoordinate &coordinate, const QPointF &anchorPoint, qreal zoomLevel) const Q_DECL_OVERRIDE;
 
     bool isProjectable(const QDoubleVector2D &wrappedProjection) const Q_DECL_OVERRIDE;
-    QList<QDoubleVector2D> visibleRegion() const Q_DECL_OVERRIDE;
-    QList<QDoubleVector2D> projectableRegion() const Q_DECL_OVERRIDE;
+    QVector<QDoubleVector2D> visibleRegion() const Q_DECL_OVERRIDE;
+    QVector<QDoubleVector2D> projectableRegion() const Q_DECL_OVERRIDE;
+    const QGeoClipRegion &visibleClipRegion() const Q_DECL_OVERRIDE;
+    const QGeoClipRegion &projectableClipRegion() const Q_DECL_OVERRIDE;
     inline QDoubleVector2D viewportToWrappedMapProjection(const QDoubleVector2D &itemPosition) const;
     inline QDoubleVector2D viewportToWrappedMapProjection(const QDoubleVector2D &itemPosition, double &s) const;
 private:
@@ -202,8 +221,10 @@ private:
     double           m_nearPlaneMercator;
     Line2D           m_nearPlaneMapIntersection;
 
-    QList<QDoubleVector2D> m_visibleRegion;
-    QList<QDoubleVector2D> m_projectableRegion;
+    QVector<QDoubleVector2D> m_visibleRegion;
+    QVector<QDoubleVector2D> m_projectableRegion;
+    QGeoClipRegion   m_visibleClipRegion;
+    QGeoClipRegion   m_projectableClipRegion;
     bool             m_visibleRegionDirty;
 
     Q_DISABLE_COPY(QGeoProjectionWebMercator)
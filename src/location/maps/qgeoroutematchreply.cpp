@@ -0,0 +1,300 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutematchreply.h"
+#include "qgeoroutematchreply_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QGeoRouteMatchReply
+    \inmodule QtLocation
+    \ingroup QtLocation-routing
+    \since 5.9.6
+
+    \brief The QGeoRouteMatchReply class manages a map matching operation
+    started by an instance of QGeoRoutingManager.
+
+    The isFinished(), error() and errorString() methods provide information
+    on whether the operation has completed and if it completed successfully.
+
+    The finished() and error(QGeoRouteMatchReply::Error,QString) signals can
+    be used to monitor the progress of the operation. As with QGeoRouteReply,
+    a newly created reply may already be finished, in which case these
+    signals will never be emitted.
+
+    If the operation completes successfully, path() holds the road geometry
+    the track was matched to. matchedCoordinates() and confidences() hold one
+    entry for each position of the request: the position snapped onto the
+    road, and how confident the service provider is about the match, between
+    0 and 1. Positions which could not be matched, for example outliers,
+    have an invalid coordinate and a confidence of 0.
+
+    \sa QGeoRouteMatchRequest
+*/
+
+/*!
+    \enum QGeoRouteMatchReply::Error
+
+    Describes an error which prevented the completion of the operation.
+
+    \value NoError
+        No error has occurred.
+    \value EngineNotSetError
+        The routing manager that was used did not have a QGeoRoutingManagerEngine instance associated with it.
+    \value CommunicationError
+        An error occurred while communicating with the service provider.
+    \value ParseError
+        The response from the service provider was in an unrecognizable format.
+    \value UnsupportedOptionError
+        The requested operation or one of the options for the operation are not
+        supported by the service provider.
+    \value UnknownError
+        An error occurred which does not fit into any of the other categories.
+*/
+
+/*!
+    Constructs a route match reply object based on \a request, with the
+    specified \a parent.
+*/
+QGeoRouteMatchReply::QGeoRouteMatchReply(const QGeoRouteMatchRequest &request, QObject *parent)
+    : QObject(parent),
+      d_ptr(new QGeoRouteMatchReplyPrivate(request))
+{
+}
+
+/*!
+    Constructs a route match reply with a given \a error and \a errorString
+    and the specified \a parent.
+*/
+QGeoRouteMatchReply::QGeoRouteMatchReply(Error error, const QString &errorString, QObject *parent)
+    : QObject(parent),
+      d_ptr(new QGeoRouteMatchReplyPrivate(error, errorString)) {}
+
+/*!
+    Destroys this route match reply object.
+*/
+QGeoRouteMatchReply::~QGeoRouteMatchReply()
+{
+    delete d_ptr;
+}
+
+/*!
+    Sets whether or not this reply has finished to \a finished.
+
+    If \a finished is true, this will cause the finished() signal to be
+    emitted.
+
+    If the operation completed successfully, the results should be set
+    before this function is called. If an error occurred, setError() should
+    be used instead.
+*/
+void QGeoRouteMatchReply::setFinished(bool finished)
+{
+    d_ptr->isFinished = finished;
+    if (d_ptr->isFinished)
+        emit this->finished();
+}
+
+/*!
+    Return true if the operation completed successfully or encountered an
+    error which cause the operation to come to a halt.
+*/
+bool QGeoRouteMatchReply::isFinished() const
+{
+    return d_ptr->isFinished;
+}
+
+/*!
+    Sets the error state of this reply to \a error and the textual
+    representation of the error to \a errorString.
+
+    This will also cause error() and finished() signals to be emitted, in that
+    order.
+*/
+void QGeoRouteMatchReply::setError(QGeoRouteMatchReply::Error error, const QString &errorString)
+{
+    d_ptr->error = error;
+    d_ptr->errorString = errorString;
+    emit this->error(error, errorString);
+    setFinished(true);
+}
+
+/*!
+    Returns the error state of this reply.
+
+    If the result is QGeoRouteMatchReply::NoError then no error has occurred.
+*/
+QGeoRouteMatchReply::Error QGeoRouteMatchReply::error() const
+{
+    return d_ptr->error;
+}
+
+/*!
+    Returns the textual representation of the error state of this reply.
+
+    If no error has occurred this will return an empty string.
+*/
+QString QGeoRouteMatchReply::errorString() const
+{
+    return d_ptr->errorString;
+}
+
+/*!
+    Returns the request which specified the track.
+*/
+QGeoRouteMatchRequest QGeoRouteMatchReply::request() const
+{
+    return d_ptr->request;
+}
+
+/*!
+    Returns the road geometry which the track was matched to.
+*/
+QGeoPath QGeoRouteMatchReply::path() const
+{
+    return d_ptr->path;
+}
+
+/*!
+    Returns the positions of the request snapped onto the road network.
+
+    A position which could not be matched has an invalid coordinate.
+*/
+QList<QGeoCoordinate> QGeoRouteMatchReply::matchedCoordinates() const
+{
+    return d_ptr->matchedCoordinates;
+}
+
+/*!
+    Returns the confidence of the match of each position of the request,
+    between 0 and 1.
+*/
+QVector<qreal> QGeoRouteMatchReply::confidences() const
+{
+    return d_ptr->confidences;
+}
+
+/*!
+    Sets the matched road geometry to \a path.
+*/
+void QGeoRouteMatchReply::setPath(const QGeoPath &path)
+{
+    d_ptr->path = path;
+}
+
+/*!
+    Sets the snapped positions to \a coordinates, one for each position of
+    the request.
+*/
+void QGeoRouteMatchReply::setMatchedCoordinates(const QList<QGeoCoordinate> &coordinates)
+{
+    d_ptr->matchedCoordinates = coordinates;
+}
+
+/*!
+    Sets the match confidences to \a confidences, one for each position of
+    the request.
+*/
+void QGeoRouteMatchReply::setConfidences(const QVector<qreal> &confidences)
+{
+    d_ptr->confidences = confidences;
+}
+
+/*!
+    \fn void QGeoRouteMatchReply::aborted()
+
+    This signal is emitted when the operation has been cancelled.
+
+    \sa abort()
+*/
+
+/*!
+    Cancels the operation immediately.
+
+    This will do nothing if the reply is finished.
+*/
+void QGeoRouteMatchReply::abort()
+{
+    emit aborted();
+}
+
+/*!
+    \fn void QGeoRouteMatchReply::finished()
+
+    This signal is emitted when this reply has finished processing.
+
+    If error() equals QGeoRouteMatchReply::NoError then the processing
+    finished successfully.
+
+    This signal and QGeoRoutingManager::matchFinished() will be
+    emitted at the same time.
+
+    \note Do not delete this reply object in the slot connected to this
+    signal. Use deleteLater() instead.
+*/
+/*!
+    \fn void QGeoRouteMatchReply::error(QGeoRouteMatchReply::Error error, const QString &errorString)
+
+    This signal is emitted when an error has been detected in the processing of
+    this reply. The finished() signal will probably follow.
+
+    The error will be described by the error code \a error. If \a errorString is
+    not empty it will contain a textual description of the error.
+
+    This signal and QGeoRoutingManager::matchError() will be emitted at the
+    same time.
+
+    \note Do not delete this reply object in the slot connected to this
+    signal. Use deleteLater() instead.
+*/
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoRouteMatchReplyPrivate::QGeoRouteMatchReplyPrivate(const QGeoRouteMatchRequest &request)
+    : error(QGeoRouteMatchReply::NoError),
+      isFinished(false),
+      request(request) {}
+
+QGeoRouteMatchReplyPrivate::QGeoRouteMatchReplyPrivate(QGeoRouteMatchReply::Error error, QString errorString)
+    : error(error),
+      errorString(errorString),
+      isFinished(true) {}
+
+QGeoRouteMatchReplyPrivate::~QGeoRouteMatchReplyPrivate() {}
+
+QT_END_NAMESPACE
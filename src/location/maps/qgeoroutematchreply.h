@@ -0,0 +1,102 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEMATCHREPLY_H
+#define QGEOROUTEMATCHREPLY_H
+
+#include <QtLocation/qlocationglobal.h>
+#include <QtPositioning/qgeopath.h>
+
+#include <QtCore/QList>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRouteMatchRequest;
+class QGeoRouteMatchReplyPrivate;
+
+class Q_LOCATION_EXPORT QGeoRouteMatchReply : public QObject
+{
+    Q_OBJECT
+public:
+    enum Error {
+        NoError,
+        EngineNotSetError,
+        CommunicationError,
+        ParseError,
+        UnsupportedOptionError,
+        UnknownError
+    };
+
+    explicit QGeoRouteMatchReply(Error error, const QString &errorString, QObject *parent = Q_NULLPTR);
+    virtual ~QGeoRouteMatchReply();
+
+    bool isFinished() const;
+    Error error() const;
+    QString errorString() const;
+
+    QGeoRouteMatchRequest request() const;
+
+    QGeoPath path() const;
+    QList<QGeoCoordinate> matchedCoordinates() const;
+    QVector<qreal> confidences() const;
+
+    virtual void abort();
+
+Q_SIGNALS:
+    void finished();
+    void aborted();
+    void error(QGeoRouteMatchReply::Error error, const QString &errorString = QString());
+
+protected:
+    explicit QGeoRouteMatchReply(const QGeoRouteMatchRequest &request, QObject *parent = Q_NULLPTR);
+
+    void setError(Error error, const QString &errorString);
+    void setFinished(bool finished);
+
+    void setPath(const QGeoPath &path);
+    void setMatchedCoordinates(const QList<QGeoCoordinate> &coordinates);
+    void setConfidences(const QVector<qreal> &confidences);
+
+private:
+    QGeoRouteMatchReplyPrivate *d_ptr;
+    Q_DISABLE_COPY(QGeoRouteMatchReply)
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,160 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutematchrequest.h"
+#include "qgeoroutematchrequest_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QGeoRouteMatchRequest
+    \inmodule QtLocation
+    \ingroup QtLocation-routing
+    \since 5.9.6
+
+    \brief The QGeoRouteMatchRequest class represents a recorded track which
+    should be snapped onto the road network.
+
+    The positions are typically collected from a QGeoPositionInfoSource, such
+    as QNmeaPositionInfoSource replaying a log. Service providers may use the
+    timestamps and the QGeoPositionInfo::HorizontalAccuracy attribute of the
+    positions to weigh how far a position may be from the road it is matched
+    to.
+
+    \sa QGeoRouteMatchReply, QGeoRoutingManager::matchRoute()
+*/
+
+/*!
+    Constructs a request to match the track given by \a positions.
+*/
+QGeoRouteMatchRequest::QGeoRouteMatchRequest(const QList<QGeoPositionInfo> &positions)
+    : d_ptr(new QGeoRouteMatchRequestPrivate())
+{
+    d_ptr->positions = positions;
+}
+
+/*!
+    Constructs a route match request object from the contents of \a other.
+*/
+QGeoRouteMatchRequest::QGeoRouteMatchRequest(const QGeoRouteMatchRequest &other)
+    : d_ptr(other.d_ptr) {}
+
+/*!
+    Destroys the request.
+*/
+QGeoRouteMatchRequest::~QGeoRouteMatchRequest() {}
+
+/*!
+    Assigns \a other to this route match request object and then returns a
+    reference to this route match request object.
+*/
+QGeoRouteMatchRequest &QGeoRouteMatchRequest::operator= (const QGeoRouteMatchRequest &other)
+{
+    d_ptr = other.d_ptr;
+    return *this;
+}
+
+/*!
+    Returns whether this route match request and \a other are equal.
+*/
+bool QGeoRouteMatchRequest::operator ==(const QGeoRouteMatchRequest &other) const
+{
+    return (d_ptr.constData() == other.d_ptr.constData()) || (*d_ptr.constData() == *other.d_ptr.constData());
+}
+
+/*!
+    Returns whether this route match request and \a other are not equal.
+*/
+bool QGeoRouteMatchRequest::operator !=(const QGeoRouteMatchRequest &other) const
+{
+    return !(*this == other);
+}
+
+/*!
+    Sets the track to match to \a positions, in the order they were recorded.
+*/
+void QGeoRouteMatchRequest::setPositions(const QList<QGeoPositionInfo> &positions)
+{
+    d_ptr->positions = positions;
+}
+
+/*!
+    Returns the track to match.
+*/
+QList<QGeoPositionInfo> QGeoRouteMatchRequest::positions() const
+{
+    return d_ptr->positions;
+}
+
+/*!
+    Sets the travel modes which should be considered to \a travelModes.
+
+    The default value is QGeoRouteRequest::CarTravel.
+*/
+void QGeoRouteMatchRequest::setTravelModes(QGeoRouteRequest::TravelModes travelModes)
+{
+    d_ptr->travelModes = travelModes;
+}
+
+/*!
+    Returns the travel modes which this request specifies should be considered.
+*/
+QGeoRouteRequest::TravelModes QGeoRouteMatchRequest::travelModes() const
+{
+    return d_ptr->travelModes;
+}
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoRouteMatchRequestPrivate::QGeoRouteMatchRequestPrivate()
+    : QSharedData(),
+      travelModes(QGeoRouteRequest::CarTravel) {}
+
+QGeoRouteMatchRequestPrivate::QGeoRouteMatchRequestPrivate(const QGeoRouteMatchRequestPrivate &other)
+    : QSharedData(other),
+      positions(other.positions),
+      travelModes(other.travelModes) {}
+
+QGeoRouteMatchRequestPrivate::~QGeoRouteMatchRequestPrivate() {}
+
+bool QGeoRouteMatchRequestPrivate::operator ==(const QGeoRouteMatchRequestPrivate &other) const
+{
+    return ((positions == other.positions)
+            && (travelModes == other.travelModes));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,335 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutematrixreply.h"
+#include "qgeoroutematrixreply_p.h"
+
+#include <QtCore/qnumeric.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QGeoRouteMatrixReply
+    \inmodule QtLocation
+    \ingroup QtLocation-routing
+    \since 5.9.6
+
+    \brief The QGeoRouteMatrixReply class manages a route matrix operation
+    started by an instance of QGeoRoutingManager.
+
+    The isFinished(), error() and errorString() methods provide information
+    on whether the operation has completed and if it completed successfully.
+
+    The finished() and error(QGeoRouteMatrixReply::Error,QString) signals can
+    be used to monitor the progress of the operation. As with QGeoRouteReply,
+    a newly created reply may already be finished, in which case these
+    signals will never be emitted.
+
+    If the operation completes successfully the results are available as
+    tables of rowCount() by columnCount() values, stored row by row. Rows
+    correspond to QGeoRouteMatrixRequest::sources() and columns to
+    QGeoRouteMatrixRequest::destinations(). A cell for which no route could
+    be found holds NaN.
+
+    \sa QGeoRouteMatrixRequest
+*/
+
+/*!
+    \enum QGeoRouteMatrixReply::Error
+
+    Describes an error which prevented the completion of the operation.
+
+    \value NoError
+        No error has occurred.
+    \value EngineNotSetError
+        The routing manager that was used did not have a QGeoRoutingManagerEngine instance associated with it.
+    \value CommunicationError
+        An error occurred while communicating with the service provider.
+    \value ParseError
+        The response from the service provider was in an unrecognizable format.
+    \value UnsupportedOptionError
+        The requested operation or one of the options for the operation are not
+        supported by the service provider.
+    \value UnknownError
+        An error occurred which does not fit into any of the other categories.
+*/
+
+/*!
+    Constructs a route matrix reply object based on \a request, with the
+    specified \a parent.
+*/
+QGeoRouteMatrixReply::QGeoRouteMatrixReply(const QGeoRouteMatrixRequest &request, QObject *parent)
+    : QObject(parent),
+      d_ptr(new QGeoRouteMatrixReplyPrivate(request))
+{
+}
+
+/*!
+    Constructs a route matrix reply with a given \a error and \a errorString
+    and the specified \a parent.
+*/
+QGeoRouteMatrixReply::QGeoRouteMatrixReply(Error error, const QString &errorString, QObject *parent)
+    : QObject(parent),
+      d_ptr(new QGeoRouteMatrixReplyPrivate(error, errorString)) {}
+
+/*!
+    Destroys this route matrix reply object.
+*/
+QGeoRouteMatrixReply::~QGeoRouteMatrixReply()
+{
+    delete d_ptr;
+}
+
+/*!
+    Sets whether or not this reply has finished to \a finished.
+
+    If \a finished is true, this will cause the finished() signal to be
+    emitted.
+
+    If the operation completed successfully, setDurations() and
+    setDistances() should be called before this function. If an error
+    occurred, setError() should be used instead.
+*/
+void QGeoRouteMatrixReply::setFinished(bool finished)
+{
+    d_ptr->isFinished = finished;
+    if (d_ptr->isFinished)
+        emit this->finished();
+}
+
+/*!
+    Return true if the operation completed successfully or encountered an
+    error which cause the operation to come to a halt.
+*/
+bool QGeoRouteMatrixReply::isFinished() const
+{
+    return d_ptr->isFinished;
+}
+
+/*!
+    Sets the error state of this reply to \a error and the textual
+    representation of the error to \a errorString.
+
+    This will also cause error() and finished() signals to be emitted, in that
+    order.
+*/
+void QGeoRouteMatrixReply::setError(QGeoRouteMatrixReply::Error error, const QString &errorString)
+{
+    d_ptr->error = error;
+    d_ptr->errorString = errorString;
+    emit this->error(error, errorString);
+    setFinished(true);
+}
+
+/*!
+    Returns the error state of this reply.
+
+    If the result is QGeoRouteMatrixReply::NoError then no error has occurred.
+*/
+QGeoRouteMatrixReply::Error QGeoRouteMatrixReply::error() const
+{
+    return d_ptr->error;
+}
+
+/*!
+    Returns the textual representation of the error state of this reply.
+
+    If no error has occurred this will return an empty string.
+*/
+QString QGeoRouteMatrixReply::errorString() const
+{
+    return d_ptr->errorString;
+}
+
+/*!
+    Returns the request which specified the matrix.
+*/
+QGeoRouteMatrixRequest QGeoRouteMatrixReply::request() const
+{
+    return d_ptr->request;
+}
+
+/*!
+    Returns the number of rows of the matrix.
+*/
+int QGeoRouteMatrixReply::rowCount() const
+{
+    return d_ptr->request.rowCount();
+}
+
+/*!
+    Returns the number of columns of the matrix.
+*/
+int QGeoRouteMatrixReply::columnCount() const
+{
+    return d_ptr->request.columnCount();
+}
+
+/*!
+    Returns the travel time in seconds from source \a row to destination
+    \a column.
+
+    NaN is returned if there is no route between the two, if durations were
+    not requested or if the indices are out of range.
+*/
+qreal QGeoRouteMatrixReply::duration(int row, int column) const
+{
+    return d_ptr->cell(d_ptr->durations, row, column);
+}
+
+/*!
+    Returns the travel distance in meters from source \a row to destination
+    \a column.
+
+    NaN is returned if there is no route between the two, if distances were
+    not requested or if the indices are out of range.
+*/
+qreal QGeoRouteMatrixReply::distance(int row, int column) const
+{
+    return d_ptr->cell(d_ptr->distances, row, column);
+}
+
+/*!
+    Returns all travel times in seconds, row by row.
+
+    The result is empty if durations were not requested.
+*/
+QVector<qreal> QGeoRouteMatrixReply::durations() const
+{
+    return d_ptr->durations;
+}
+
+/*!
+    Returns all travel distances in meters, row by row.
+
+    The result is empty if distances were not requested.
+*/
+QVector<qreal> QGeoRouteMatrixReply::distances() const
+{
+    return d_ptr->distances;
+}
+
+/*!
+    Sets the travel times of the reply to \a durations, which must hold
+    rowCount() times columnCount() values stored row by row.
+*/
+void QGeoRouteMatrixReply::setDurations(const QVector<qreal> &durations)
+{
+    d_ptr->durations = durations;
+}
+
+/*!
+    Sets the travel distances of the reply to \a distances, which must hold
+    rowCount() times columnCount() values stored row by row.
+*/
+void QGeoRouteMatrixReply::setDistances(const QVector<qreal> &distances)
+{
+    d_ptr->distances = distances;
+}
+
+/*!
+    \fn void QGeoRouteMatrixReply::aborted()
+
+    This signal is emitted when the operation has been cancelled.
+
+    \sa abort()
+*/
+
+/*!
+    Cancels the operation immediately.
+
+    This will do nothing if the reply is finished.
+*/
+void QGeoRouteMatrixReply::abort()
+{
+    emit aborted();
+}
+
+/*!
+    \fn void QGeoRouteMatrixReply::finished()
+
+    This signal is emitted when this reply has finished processing.
+
+    If error() equals QGeoRouteMatrixReply::NoError then the processing
+    finished successfully.
+
+    This signal and QGeoRoutingManager::matrixFinished() will be
+    emitted at the same time.
+
+    \note Do not delete this reply object in the slot connected to this
+    signal. Use deleteLater() instead.
+*/
+/*!
+    \fn void QGeoRouteMatrixReply::error(QGeoRouteMatrixReply::Error error, const QString &errorString)
+
+    This signal is emitted when an error has been detected in the processing of
+    this reply. The finished() signal will probably follow.
+
+    The error will be described by the error code \a error. If \a errorString is
+    not empty it will contain a textual description of the error.
+
+    This signal and QGeoRoutingManager::matrixError() will be emitted at the
+    same time.
+
+    \note Do not delete this reply object in the slot connected to this
+    signal. Use deleteLater() instead.
+*/
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoRouteMatrixReplyPrivate::QGeoRouteMatrixReplyPrivate(const QGeoRouteMatrixRequest &request)
+    : error(QGeoRouteMatrixReply::NoError),
+      isFinished(false),
+      request(request) {}
+
+QGeoRouteMatrixReplyPrivate::QGeoRouteMatrixReplyPrivate(QGeoRouteMatrixReply::Error error, QString errorString)
+    : error(error),
+      errorString(errorString),
+      isFinished(true) {}
+
+QGeoRouteMatrixReplyPrivate::~QGeoRouteMatrixReplyPrivate() {}
+
+qreal QGeoRouteMatrixReplyPrivate::cell(const QVector<qreal> &table, int row, int column) const
+{
+    const int columns = request.columnCount();
+    if (row < 0 || column < 0 || column >= columns || row >= request.rowCount()
+            || table.size() != request.rowCount() * columns)
+        return qQNaN();
+    return table.at(row * columns + column);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,103 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEMATRIXREPLY_H
+#define QGEOROUTEMATRIXREPLY_H
+
+#include <QtLocation/qlocationglobal.h>
+
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRouteMatrixRequest;
+class QGeoRouteMatrixReplyPrivate;
+
+class Q_LOCATION_EXPORT QGeoRouteMatrixReply : public QObject
+{
+    Q_OBJECT
+public:
+    enum Error {
+        NoError,
+        EngineNotSetError,
+        CommunicationError,
+        ParseError,
+        UnsupportedOptionError,
+        UnknownError
+    };
+
+    explicit QGeoRouteMatrixReply(Error error, const QString &errorString, QObject *parent = Q_NULLPTR);
+    virtual ~QGeoRouteMatrixReply();
+
+    bool isFinished() const;
+    Error error() const;
+    QString errorString() const;
+
+    QGeoRouteMatrixRequest request() const;
+
+    int rowCount() const;
+    int columnCount() const;
+
+    qreal duration(int row, int column) const;
+    qreal distance(int row, int column) const;
+    QVector<qreal> durations() const;
+    QVector<qreal> distances() const;
+
+    virtual void abort();
+
+Q_SIGNALS:
+    void finished();
+    void aborted();
+    void error(QGeoRouteMatrixReply::Error error, const QString &errorString = QString());
+
+protected:
+    explicit QGeoRouteMatrixReply(const QGeoRouteMatrixRequest &request, QObject *parent = Q_NULLPTR);
+
+    void setError(Error error, const QString &errorString);
+    void setFinished(bool finished);
+
+    void setDurations(const QVector<qreal> &durations);
+    void setDistances(const QVector<qreal> &distances);
+
+private:
+    QGeoRouteMatrixReplyPrivate *d_ptr;
+    Q_DISABLE_COPY(QGeoRouteMatrixReply)
+};
+
+QT_END_NAMESPACE
+
+#endif
@@ -0,0 +1,238 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutematrixrequest.h"
+#include "qgeoroutematrixrequest_p.h"
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \class QGeoRouteMatrixRequest
+    \inmodule QtLocation
+    \ingroup QtLocation-routing
+    \since 5.9.6
+
+    \brief The QGeoRouteMatrixRequest class represents the parameters of a
+    request for travel durations and distances between many origins and
+    many destinations.
+
+    A route matrix answers "how long from each of these places to each of
+    those places" without calculating full routes. The result is a table
+    with one row per source and one column per destination, which is
+    typically far cheaper to obtain than the equivalent set of individual
+    route requests.
+
+    If no destinations are set, the sources are also used as destinations
+    and the result is a square matrix.
+
+    \sa QGeoRouteMatrixReply, QGeoRoutingManager::calculateRouteMatrix()
+*/
+
+/*!
+    \enum QGeoRouteMatrixRequest::Annotation
+
+    Defines which values should be calculated for each cell of the matrix.
+
+    \value DurationAnnotation
+        The travel time in seconds.
+
+    \value DistanceAnnotation
+        The travel distance in meters.
+*/
+
+/*!
+    Constructs a request for the matrix between \a sources and
+    \a destinations.
+*/
+QGeoRouteMatrixRequest::QGeoRouteMatrixRequest(const QList<QGeoCoordinate> &sources,
+                                               const QList<QGeoCoordinate> &destinations)
+    : d_ptr(new QGeoRouteMatrixRequestPrivate())
+{
+    d_ptr->sources = sources;
+    d_ptr->destinations = destinations;
+}
+
+/*!
+    Constructs a route matrix request object from the contents of \a other.
+*/
+QGeoRouteMatrixRequest::QGeoRouteMatrixRequest(const QGeoRouteMatrixRequest &other)
+    : d_ptr(other.d_ptr) {}
+
+/*!
+    Destroys the request.
+*/
+QGeoRouteMatrixRequest::~QGeoRouteMatrixRequest() {}
+
+/*!
+    Assigns \a other to this route matrix request object and then returns a
+    reference to this route matrix request object.
+*/
+QGeoRouteMatrixRequest &QGeoRouteMatrixRequest::operator= (const QGeoRouteMatrixRequest &other)
+{
+    d_ptr = other.d_ptr;
+    return *this;
+}
+
+/*!
+    Returns whether this route matrix request and \a other are equal.
+*/
+bool QGeoRouteMatrixRequest::operator ==(const QGeoRouteMatrixRequest &other) const
+{
+    return (d_ptr.constData() == other.d_ptr.constData()) || (*d_ptr.constData() == *other.d_ptr.constData());
+}
+
+/*!
+    Returns whether this route matrix request and \a other are not equal.
+*/
+bool QGeoRouteMatrixRequest::operator !=(const QGeoRouteMatrixRequest &other) const
+{
+    return !(*this == other);
+}
+
+/*!
+    Sets \a sources as the origins of the matrix, one per row.
+*/
+void QGeoRouteMatrixRequest::setSources(const QList<QGeoCoordinate> &sources)
+{
+    d_ptr->sources = sources;
+}
+
+/*!
+    Returns the origins of the matrix.
+*/
+QList<QGeoCoordinate> QGeoRouteMatrixRequest::sources() const
+{
+    return d_ptr->sources;
+}
+
+/*!
+    Sets \a destinations as the targets of the matrix, one per column.
+
+    An empty list means that the sources are used as destinations.
+*/
+void QGeoRouteMatrixRequest::setDestinations(const QList<QGeoCoordinate> &destinations)
+{
+    d_ptr->destinations = destinations;
+}
+
+/*!
+    Returns the targets of the matrix.
+*/
+QList<QGeoCoordinate> QGeoRouteMatrixRequest::destinations() const
+{
+    return d_ptr->destinations;
+}
+
+/*!
+    Returns the number of rows of the resulting matrix, which is the number
+    of sources.
+*/
+int QGeoRouteMatrixRequest::rowCount() const
+{
+    return d_ptr->sources.size();
+}
+
+/*!
+    Returns the number of columns of the resulting matrix, which is the number
+    of destinations, or the number of sources if no destinations are set.
+*/
+int QGeoRouteMatrixRequest::columnCount() const
+{
+    return d_ptr->destinations.isEmpty() ? d_ptr->sources.size() : d_ptr->destinations.size();
+}
+
+/*!
+    Sets the travel modes which should be considered to \a travelModes.
+
+    The default value is QGeoRouteRequest::CarTravel.
+*/
+void QGeoRouteMatrixRequest::setTravelModes(QGeoRouteRequest::TravelModes travelModes)
+{
+    d_ptr->travelModes = travelModes;
+}
+
+/*!
+    Returns the travel modes which this request specifies should be considered.
+*/
+QGeoRouteRequest::TravelModes QGeoRouteMatrixRequest::travelModes() const
+{
+    return d_ptr->travelModes;
+}
+
+/*!
+    Sets the values which should be calculated for each cell to \a annotations.
+
+    The default value is QGeoRouteMatrixRequest::DurationAnnotation.
+*/
+void QGeoRouteMatrixRequest::setAnnotations(QGeoRouteMatrixRequest::Annotations annotations)
+{
+    d_ptr->annotations = annotations;
+}
+
+/*!
+    Returns the values which should be calculated for each cell.
+*/
+QGeoRouteMatrixRequest::Annotations QGeoRouteMatrixRequest::annotations() const
+{
+    return d_ptr->annotations;
+}
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoRouteMatrixRequestPrivate::QGeoRouteMatrixRequestPrivate()
+    : QSharedData(),
+      travelModes(QGeoRouteRequest::CarTravel),
+      annotations(QGeoRouteMatrixRequest::DurationAnnotation) {}
+
+QGeoRouteMatrixRequestPrivate::QGeoRouteMatrixRequestPrivate(const QGeoRouteMatrixRequestPrivate &other)
+    : QSharedData(other),
+      sources(other.sources),
+      destinations(other.destinations),
+      travelModes(other.travelModes),
+      annotations(other.annotations) {}
+
+QGeoRouteMatrixRequestPrivate::~QGeoRouteMatrixRequestPrivate() {}
+
+bool QGeoRouteMatrixRequestPrivate::operator ==(const QGeoRouteMatrixRequestPrivate &other) const
+{
+    return ((sources == other.sources)
+            && (destinations == other.destinations)
+            && (travelModes == other.travelModes)
+            && (annotations == other.annotations));
+}
+
+QT_END_NAMESPACE
@@ -59,6 +59,44 @@ QGeoRouteParserPrivate::~QGeoRouteParserPrivate()
 {
 }
 
+QGeoRouteMatrixReply::Error QGeoRouteParserPrivate::parseMatrixReply(QVector<qreal> &durations, QVector<qreal> &distances, QString &errorString,
+                                                                     const QByteArray &reply, const QGeoRouteMatrixRequest &request) const
+{
+    Q_UNUSED(durations)
+    Q_UNUSED(distances)
+    Q_UNUSED(reply)
+    Q_UNUSED(request)
+    errorString = QStringLiteral("Route matrices are not supported by this API version.");
+    return QGeoRouteMatrixReply::UnsupportedOptionError;
+}
+
+QUrl QGeoRouteParserPrivate::matrixRequestUrl(const QGeoRouteMatrixRequest &request, const QString &prefix) const
+{
+    Q_UNUSED(request)
+    Q_UNUSED(prefix)
+    return QUrl();
+}
+
+QGeoRouteMatchReply::Error QGeoRouteParserPrivate::parseMatchReply(QList<QGeoCoordinate> &path, QList<QGeoCoordinate> &matchedCoordinates,
+                                                                   QVector<qreal> &confidences, QString &errorString,
+                                                                   const QByteArray &reply, int positionCount) const
+{
+    Q_UNUSED(path)
+    Q_UNUSED(matchedCoordinates)
+    Q_UNUSED(confidences)
+    Q_UNUSED(reply)
+    Q_UNUSED(positionCount)
+    errorString = QStringLiteral("Map matching is not supported by this API version.");
+    return QGeoRouteMatchReply::UnsupportedOptionError;
+}
+
+QUrl QGeoRouteParserPrivate::matchRequestUrl(const QList<QGeoPositionInfo> &positions, const QString &prefix) const
+{
+    Q_UNUSED(positions)
+    Q_UNUSED(prefix)
+    return QUrl();
+}
+
 /*
     Public class implementations
 */
@@ -85,6 +123,33 @@ QUrl QGeoRouteParser::requestUrl(const QGeoRouteRequest &request, const QString
     return d->requestUrl(request, prefix);
 }
 
+QGeoRouteMatrixReply::Error QGeoRouteParser::parseMatrixReply(QVector<qreal> &durations, QVector<qreal> &distances, QString &errorString,
+                                                              const QByteArray &reply, const QGeoRouteMatrixRequest &request) const
+{
+    Q_D(const QGeoRouteParser);
+    return d->parseMatrixReply(durations, distances, errorString, reply, request);
+}
+
+QUrl QGeoRouteParser::matrixRequestUrl(const QGeoRouteMatrixRequest &request, const QString &prefix) const
+{
+    Q_D(const QGeoRouteParser);
+    return d->matrixRequestUrl(request, prefix);
+}
+
+QGeoRouteMatchReply::Error QGeoRouteParser::parseMatchReply(QList<QGeoCoordinate> &path, QList<QGeoCoordinate> &matchedCoordinates,
+                                                            QVector<qreal> &confidences, QString &errorString,
+                                                            const QByteArray &reply, int positionCount) const
+{
+    Q_D(const QGeoRouteParser);
+    return d->parseMatchReply(path, matchedCoordinates, confidences, errorString, reply, positionCount);
+}
+
+QUrl QGeoRouteParser::matchRequestUrl(const QList<QGeoPositionInfo> &positions, const QString &prefix) const
+{
+    Q_D(const QGeoRouteParser);
+    return d->matchRequestUrl(positions, prefix);
+}
+
 QT_END_NAMESPACE
 
 
@@ -51,6 +51,10 @@
 #include <QtLocation/private/qlocationglobal_p.h>
 #include <QtLocation/qgeoroutereply.h>
 #include <QtLocation/qgeorouterequest.h>
+#include <QtLocation/qgeoroutematrixreply.h>
+#include <QtLocation/qgeoroutematrixrequest.h>
+#include <QtLocation/qgeoroutematchreply.h>
+#include <QtPositioning/qgeopositioninfo.h>
 #include <QtCore/QByteArray>
 #include <QtCore/QUrl>
 
@@ -66,6 +70,13 @@ public:
     virtual ~QGeoRouteParser();
     QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const;
     QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const;
+    QGeoRouteMatrixReply::Error parseMatrixReply(QVector<qreal> &durations, QVector<qreal> &distances, QString &errorString,
+                                                 const QByteArray &reply, const QGeoRouteMatrixRequest &request) const;
+    QUrl matrixRequestUrl(const QGeoRouteMatrixRequest &request, const QString &prefix) const;
+    QGeoRouteMatchReply::Error parseMatchReply(QList<QGeoCoordinate> &path, QList<QGeoCoordinate> &matchedCoordinates,
+                                               QVector<qreal> &confidences, QString &errorString,
+                                               const QByteArray &reply, int positionCount) const;
+    QUrl matchRequestUrl(const QList<QGeoPositionInfo> &positions, const QString &prefix) const;
 
 protected:
     QGeoRouteParser(QGeoRouteParserPrivate &dd, QObject *parent = Q_NULLPTR);
@@ -52,6 +52,10 @@
 #include <QtCore/QUrl>
 #include <QtLocation/qgeoroutereply.h>
 #include <QtLocation/qgeorouterequest.h>
+#include <QtLocation/qgeoroutematrixreply.h>
+#include <QtLocation/qgeoroutematrixrequest.h>
+#include <QtLocation/qgeoroutematchreply.h>
+#include <QtPositioning/qgeopositioninfo.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -64,6 +68,15 @@ public:
 
     virtual QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const = 0;
     virtual QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const = 0;
+
+    // Route matrices and map matching are optional, the defaults report them as unsupported
+    virtual QGeoRouteMatrixReply::Error parseMatrixReply(QVector<qreal> &durations, QVector<qreal> &distances, QString &errorString,
+                                                         const QByteArray &reply, const QGeoRouteMatrixRequest &request) const;
+    virtual QUrl matrixRequestUrl(const QGeoRouteMatrixRequest &request, const QString &prefix) const;
+    virtual QGeoRouteMatchReply::Error parseMatchReply(QList<QGeoCoordinate> &path, QList<QGeoCoordinate> &matchedCoordinates,
+                                                       QVector<qreal> &confidences, QString &errorString,
+                                                       const QByteArray &reply, int positionCount) const;
+    virtual QUrl matchRequestUrl(const QList<QGeoPositionInfo> &positions, const QString &prefix) const;
 };
 
 QT_END_NAMESPACE
@@ -44,27 +44,37 @@
 #include <QtCore/QJsonObject>
 #include <QtCore/QJsonArray>
 #include <QtCore/QUrlQuery>
+#include <QtCore/QStringList>
+#include <QtCore/qnumeric.h>
 #include <QtPositioning/private/qlocationutils_p.h>
 
 QT_BEGIN_NAMESPACE
 
-static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
+// Decodes an encoded polyline, https://developers.google.com/maps/documentation/utilities/polylinealgorithm
+// OSRM uses a precision of 5 digits for "polyline" and 6 for "polyline6".
+// Positions are accumulated as integers so that long paths do not drift.
+static QList<QGeoCoordinate> decodePolyline(const QString &polylineString, double scale)
 {
     QList<QGeoCoordinate> path;
-    if (polylineString.isEmpty())
-        return path;
+    const ushort *data = polylineString.utf16();
+    const int length = polylineString.length();
 
-    QByteArray data = polylineString.toLatin1();
+    // Every value ends with a chunk that has the continuation bit cleared
+    int values = 0;
+    for (int i = 0; i < length; ++i)
+        values += ((data[i] - 63) & 0x20) == 0;
+    path.reserve(values / 2);
 
     bool parsingLatitude = true;
-
+    int latitude = 0;
+    int longitude = 0;
+    quint32 value = 0;
     int shift = 0;
-    int value = 0;
-
-    QGeoCoordinate coord(0, 0);
 
-    for (int i = 0; i < data.length(); ++i) {
-        unsigned char c = data.at(i) - 63;
+    for (int i = 0; i < length; ++i) {
+        const quint32 c = quint32(data[i]) - 63;
+        if (c > 63 || shift > 30) // not a polyline character, or a value wider than 32 bits
+            return QList<QGeoCoordinate>();
 
         value |= (c & 0x1f) << shift;
         shift += 5;
@@ -73,13 +83,13 @@ static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
         if (c & 0x20)
             continue;
 
-        int diff = (value & 1) ? ~(value >> 1) : (value >> 1);
+        const int diff = (value & 1) ? ~int(value >> 1) : int(value >> 1);
 
         if (parsingLatitude) {
-            coord.setLatitude(coord.latitude() + (double)diff/1e5);
+            latitude += diff;
         } else {
-            coord.setLongitude(coord.longitude() + (double)diff/1e5);
-            path.append(coord);
+            longitude += diff;
+            path.append(QGeoCoordinate(latitude / scale, longitude / scale));
         }
 
         parsingLatitude = !parsingLatitude;
@@ -88,9 +98,35 @@ static QList<QGeoCoordinate> decodePolyline(const QString &polylineString)
         shift = 0;
     }
 
+    // A truncated geometry ends in the middle of a value, or with a latitude alone
+    if (shift != 0 || !parsingLatitude)
+        return QList<QGeoCoordinate>();
+
     return path;
 }
 
+// Decodes a GeoJSON LineString, as returned for geometries=geojson
+static QList<QGeoCoordinate> decodeGeoJson(const QJsonObject &lineString)
+{
+    QList<QGeoCoordinate> path;
+    const QJsonArray coordinates = lineString.value(QLatin1String("coordinates")).toArray();
+    path.reserve(coordinates.size());
+    foreach (const QJsonValue &c, coordinates) {
+        const QJsonArray position = c.toArray();
+        if (position.size() < 2)
+            return QList<QGeoCoordinate>();
+        path.append(QGeoCoordinate(position.at(1).toDouble(), position.at(0).toDouble()));
+    }
+    return path;
+}
+
+static QList<QGeoCoordinate> decodeGeometry(const QJsonValue &geometry, QGeoRouteParserOsrmV5::GeometryFormat format)
+{
+    if (geometry.isObject())
+        return decodeGeoJson(geometry.toObject());
+    return decodePolyline(geometry.toString(), format == QGeoRouteParserOsrmV5::Polyline6Geometry ? 1e6 : 1e5);
+}
+
 static QString cardinalDirection4(QLocationUtils::CardinalDirection direction)
 {
     switch (direction) {
@@ -793,7 +829,7 @@ static QGeoManeuver::InstructionDirection instructionDirection(const QJsonObject
         return QGeoManeuver::NoDirection;
 }
 
-static QGeoRouteSegment parseStep(const QJsonObject &step) {
+static QGeoRouteSegment parseStep(const QJsonObject &step, QGeoRouteParserOsrmV5::GeometryFormat format) {
     // OSRM Instructions documentation: https://github.com/Project-OSRM/osrm-text-instructions/blob/master/instructions.json
     QGeoRouteSegment segment;
     if (!step.value(QLatin1String("maneuver")).isObject())
@@ -818,8 +854,7 @@ static QGeoRouteSegment parseStep(const QJsonObject &step) {
     double longitude = position[0].toDouble();
     QGeoCoordinate coord(latitude, longitude);
 
-    QString geometry = step.value(QLatin1String("geometry")).toString();
-    QList<QGeoCoordinate> path = decodePolyline(geometry);
+    QList<QGeoCoordinate> path = decodeGeometry(step.value(QLatin1String("geometry")), format);
 
     QGeoManeuver geoManeuver;
     geoManeuver.setDirection(instructionDirection(maneuver));
@@ -845,9 +880,20 @@ public:
 
     QGeoRouteReply::Error parseReply(QList<QGeoRoute> &routes, QString &errorString, const QByteArray &reply) const Q_DECL_OVERRIDE;
     QUrl requestUrl(const QGeoRouteRequest &request, const QString &prefix) const Q_DECL_OVERRIDE;
+    QGeoRouteMatrixReply::Error parseMatrixReply(QVector<qreal> &durations, QVector<qreal> &distances, QString &errorString,
+                                                 const QByteArray &reply, const QGeoRouteMatrixRequest &request) const Q_DECL_OVERRIDE;
+    QUrl matrixRequestUrl(const QGeoRouteMatrixRequest &request, const QString &prefix) const Q_DECL_OVERRIDE;
+    QGeoRouteMatchReply::Error parseMatchReply(QList<QGeoCoordinate> &path, QList<QGeoCoordinate> &matchedCoordinates,
+                                               QVector<qreal> &confidences, QString &errorString,
+                                               const QByteArray &reply, int positionCount) const Q_DECL_OVERRIDE;
+    QUrl matchRequestUrl(const QList<QGeoPositionInfo> &positions, const QString &prefix) const Q_DECL_OVERRIDE;
+    void addGeometryQueryItem(QUrlQuery &query) const;
+
+    QGeoRouteParserOsrmV5::GeometryFormat geometryFormat;
 };
 
-QGeoRouteParserOsrmV5Private::QGeoRouteParserOsrmV5Private() : QGeoRouteParserPrivate()
+QGeoRouteParserOsrmV5Private::QGeoRouteParserOsrmV5Private()
+    : QGeoRouteParserPrivate(), geometryFormat(QGeoRouteParserOsrmV5::PolylineGeometry)
 {
 }
 
@@ -906,7 +952,7 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
                         error = true;
                         break;
                     }
-                    QGeoRouteSegment segment = parseStep(s.toObject());
+                    QGeoRouteSegment segment = parseStep(s.toObject(), geometryFormat);
                     if (segment.isValid()) {
                         segments.append(segment);
                     } else {
@@ -920,19 +966,24 @@ QGeoRouteReply::Error QGeoRouteParserOsrmV5Private::parseReply(QList<QGeoRoute>
 
             if (!error) {
                 QList<QGeoCoordinate> path;
-                foreach (const QGeoRouteSegment &s, segments)
-                    path.append(s.path());
-
-                for (int i = segments.size() - 1; i > 0; --i)
-                    segments[i-1].setNextRouteSegment(segments[i]);
+                if (segments.isEmpty()) {
+                    // Requested without steps, only the overview geometry is there
+                    path = decodeGeometry(route.value(QLatin1String("geometry")), geometryFormat);
+                } else {
+                    foreach (const QGeoRouteSegment &s, segments)
+                        path.append(s.path());
+
+                    for (int i = segments.size() - 1; i > 0; --i)
+                        segments[i-1].setNextRouteSegment(segments[i]);
+                }
 
                 QGeoRoute r;
                 r.setDistance(distance);
                 r.setTravelTime(travelTime);
-                if (!path.isEmpty()) {
+                if (!path.isEmpty())
                     r.setPath(path);
+                if (!segments.isEmpty())
                     r.setFirstRouteSegment(segments.first());
-                }
                 //r.setTravelMode(QGeoRouteRequest::CarTravel); // The only one supported by OSRM demo service, but other OSRM servers might do cycle or pedestrian too
                 routes.append(r);
             }
@@ -957,16 +1008,253 @@ QUrl QGeoRouteParserOsrmV5Private::requestUrl(const QGeoRouteRequest &request, c
         ++notFirst;
     }
 
+    // The route path is assembled from the step geometries, so the overview is only
+    // needed when no segments are wanted and the steps can be skipped entirely.
+    const bool steps = request.segmentDetail() != QGeoRouteRequest::NoSegmentData
+            || request.maneuverDetail() != QGeoRouteRequest::NoManeuvers;
+
     QUrl url(routingUrl);
     QUrlQuery query;
-    query.addQueryItem(QStringLiteral("overview"), QStringLiteral("full"));
-    query.addQueryItem(QStringLiteral("steps"), QStringLiteral("true"));
-    query.addQueryItem(QStringLiteral("geometries"), QStringLiteral("polyline"));
+    query.addQueryItem(QStringLiteral("overview"), steps ? QStringLiteral("false") : QStringLiteral("full"));
+    query.addQueryItem(QStringLiteral("steps"), steps ? QStringLiteral("true") : QStringLiteral("false"));
+    addGeometryQueryItem(query);
     query.addQueryItem(QStringLiteral("alternatives"), QStringLiteral("true"));
     url.setQuery(query);
     return url;
 }
 
+static void appendCoordinates(QString &url, const QList<QGeoCoordinate> &coordinates)
+{
+    foreach (const QGeoCoordinate &c, coordinates) {
+        if (!url.endsWith(QLatin1Char('/')))
+            url.append(QLatin1Char(';'));
+        url.append(QString::number(c.longitude(), 'f', 7)).append(QLatin1Char(',')).append(QString::number(c.latitude(), 'f', 7));
+    }
+}
+
+static QString indexList(int from, int count)
+{
+    QString list;
+    for (int i = from; i < from + count; ++i) {
+        if (i != from)
+            list.append(QLatin1Char(';'));
+        list.append(QString::number(i));
+    }
+    return list;
+}
+
+// Reads one "durations" or "distances" table into a row-major vector.
+// OSRM reports unreachable pairs as null, which become NaN.
+static bool parseTable(QVector<qreal> &table, const QJsonValue &value, int rows, int columns)
+{
+    if (!value.isArray())
+        return false;
+    const QJsonArray rowArray = value.toArray();
+    if (rowArray.size() != rows)
+        return false;
+
+    table.clear();
+    table.reserve(rows * columns);
+    foreach (const QJsonValue &r, rowArray) {
+        if (!r.isArray())
+            return false;
+        const QJsonArray row = r.toArray();
+        if (row.size() != columns)
+            return false;
+        foreach (const QJsonValue &v, row) {
+            if (v.isDouble())
+                table.append(v.toDouble());
+            else if (v.isNull())
+                table.append(qQNaN());
+            else
+                return false;
+        }
+    }
+    return true;
+}
+
+QGeoRouteMatrixReply::Error QGeoRouteParserOsrmV5Private::parseMatrixReply(QVector<qreal> &durations, QVector<qreal> &distances, QString &errorString,
+                                                                          const QByteArray &reply, const QGeoRouteMatrixRequest &request) const
+{
+    // OSRM v5 table service, see the specs linked in parseReply()
+    QJsonDocument document = QJsonDocument::fromJson(reply);
+    if (!document.isObject()) {
+        errorString = QStringLiteral("Couldn't parse json.");
+        return QGeoRouteMatrixReply::ParseError;
+    }
+    QJsonObject object = document.object();
+
+    QString status = object.value(QStringLiteral("code")).toString();
+    if (status != QLatin1String("Ok")) {
+        errorString = status;
+        return QGeoRouteMatrixReply::UnknownError;
+    }
+
+    const int rows = request.rowCount();
+    const int columns = request.columnCount();
+    if (request.annotations() & QGeoRouteMatrixRequest::DurationAnnotation) {
+        if (!parseTable(durations, object.value(QLatin1String("durations")), rows, columns)) {
+            errorString = QStringLiteral("Invalid durations table");
+            return QGeoRouteMatrixReply::ParseError;
+        }
+    }
+    if (request.annotations() & QGeoRouteMatrixRequest::DistanceAnnotation) {
+        if (!parseTable(distances, object.value(QLatin1String("distances")), rows, columns)) {
+            errorString = QStringLiteral("Invalid distances table");
+            return QGeoRouteMatrixReply::ParseError;
+        }
+    }
+    return QGeoRouteMatrixReply::NoError;
+}
+
+QUrl QGeoRouteParserOsrmV5Private::matrixRequestUrl(const QGeoRouteMatrixRequest &request, const QString &prefix) const
+{
+    QString tableUrl = prefix;
+    if (!tableUrl.endsWith(QLatin1Char('/')))
+        tableUrl.append(QLatin1Char('/'));
+    const QList<QGeoCoordinate> sources = request.sources();
+    const QList<QGeoCoordinate> destinations = request.destinations();
+    appendCoordinates(tableUrl, sources);
+    appendCoordinates(tableUrl, destinations);
+
+    QUrl url(tableUrl);
+    QUrlQuery query;
+    if (!destinations.isEmpty()) {
+        // Without sources and destinations OSRM computes all-to-all,
+        // which is exactly the square matrix an empty destination list means.
+        query.addQueryItem(QStringLiteral("sources"), indexList(0, sources.size()));
+        query.addQueryItem(QStringLiteral("destinations"), indexList(sources.size(), destinations.size()));
+    }
+    QStringList annotations;
+    if (request.annotations() & QGeoRouteMatrixRequest::DurationAnnotation)
+        annotations.append(QStringLiteral("duration"));
+    if (request.annotations() & QGeoRouteMatrixRequest::DistanceAnnotation)
+        annotations.append(QStringLiteral("distance"));
+    if (!annotations.isEmpty())
+        query.addQueryItem(QStringLiteral("annotations"), annotations.join(QLatin1Char(',')));
+    url.setQuery(query);
+    return url;
+}
+
+void QGeoRouteParserOsrmV5Private::addGeometryQueryItem(QUrlQuery &query) const
+{
+    switch (geometryFormat) {
+    case QGeoRouteParserOsrmV5::PolylineGeometry:
+        query.addQueryItem(QStringLiteral("geometries"), QStringLiteral("polyline"));
+        break;
+    case QGeoRouteParserOsrmV5::Polyline6Geometry:
+        query.addQueryItem(QStringLiteral("geometries"), QStringLiteral("polyline6"));
+        break;
+    case QGeoRouteParserOsrmV5::GeoJsonGeometry:
+        query.addQueryItem(QStringLiteral("geometries"), QStringLiteral("geojson"));
+        break;
+    }
+}
+
+QGeoRouteMatchReply::Error QGeoRouteParserOsrmV5Private::parseMatchReply(QList<QGeoCoordinate> &path, QList<QGeoCoordinate> &matchedCoordinates,
+                                                                         QVector<qreal> &confidences, QString &errorString,
+                                                                         const QByteArray &reply, int positionCount) const
+{
+    // OSRM v5 match service, see the specs linked in parseReply()
+    QJsonDocument document = QJsonDocument::fromJson(reply);
+    if (!document.isObject()) {
+        errorString = QStringLiteral("Couldn't parse json.");
+        return QGeoRouteMatchReply::ParseError;
+    }
+    QJsonObject object = document.object();
+
+    path.clear();
+    matchedCoordinates.clear();
+    confidences.clear();
+
+    QString status = object.value(QStringLiteral("code")).toString();
+    if (status == QLatin1String("NoMatch")) {
+        // Not an error for a track, none of these positions is close to a road
+        for (int i = 0; i < positionCount; ++i)
+            matchedCoordinates.append(QGeoCoordinate());
+        confidences.fill(0, positionCount);
+        return QGeoRouteMatchReply::NoError;
+    }
+    if (status != QLatin1String("Ok")) {
+        errorString = status;
+        return QGeoRouteMatchReply::UnknownError;
+    }
+
+    const QJsonArray tracepoints = object.value(QLatin1String("tracepoints")).toArray();
+    if (tracepoints.size() != positionCount) {
+        errorString = QStringLiteral("Invalid tracepoints");
+        return QGeoRouteMatchReply::ParseError;
+    }
+
+    // The track may be split into several matchings, e.g. at gaps or outliers
+    QVector<qreal> matchingConfidences;
+    foreach (const QJsonValue &m, object.value(QLatin1String("matchings")).toArray()) {
+        const QJsonObject matching = m.toObject();
+        matchingConfidences.append(matching.value(QLatin1String("confidence")).toDouble());
+        path.append(decodeGeometry(matching.value(QLatin1String("geometry")), geometryFormat));
+    }
+
+    confidences.reserve(positionCount);
+    foreach (const QJsonValue &t, tracepoints) {
+        if (!t.isObject()) {
+            matchedCoordinates.append(QGeoCoordinate());
+            confidences.append(0);
+            continue;
+        }
+        const QJsonObject tracepoint = t.toObject();
+        const QJsonArray location = tracepoint.value(QLatin1String("location")).toArray();
+        if (location.size() < 2) {
+            errorString = QStringLiteral("Invalid tracepoint location");
+            return QGeoRouteMatchReply::ParseError;
+        }
+        matchedCoordinates.append(QGeoCoordinate(location.at(1).toDouble(), location.at(0).toDouble()));
+        const int matching = tracepoint.value(QLatin1String("matchings_index")).toInt(-1);
+        confidences.append(matching >= 0 && matching < matchingConfidences.size() ? matchingConfidences.at(matching) : 0);
+    }
+    return QGeoRouteMatchReply::NoError;
+}
+
+QUrl QGeoRouteParserOsrmV5Private::matchRequestUrl(const QList<QGeoPositionInfo> &positions, const QString &prefix) const
+{
+    QString matchUrl = prefix;
+    if (!matchUrl.endsWith(QLatin1Char('/')))
+        matchUrl.append(QLatin1Char('/'));
+
+    QList<QGeoCoordinate> coordinates;
+    QStringList timestamps;
+    QStringList radiuses;
+    bool hasAccuracy = false;
+    bool hasTimestamps = true;
+    qint64 lastTimestamp = 0;
+    foreach (const QGeoPositionInfo &position, positions) {
+        coordinates.append(position.coordinate());
+
+        // OSRM needs increasing timestamps for all positions, or none
+        const qint64 timestamp = position.timestamp().isValid() ? position.timestamp().toMSecsSinceEpoch() / 1000 : -1;
+        hasTimestamps = hasTimestamps && timestamp >= lastTimestamp;
+        lastTimestamp = timestamp;
+        if (hasTimestamps)
+            timestamps.append(QString::number(timestamp));
+
+        // The default standard deviation of OSRM is 5 meters
+        const bool accuracy = position.hasAttribute(QGeoPositionInfo::HorizontalAccuracy);
+        hasAccuracy = hasAccuracy || accuracy;
+        radiuses.append(QString::number(accuracy ? position.attribute(QGeoPositionInfo::HorizontalAccuracy) : 5.0));
+    }
+    appendCoordinates(matchUrl, coordinates);
+
+    QUrl url(matchUrl);
+    QUrlQuery query;
+    query.addQueryItem(QStringLiteral("overview"), QStringLiteral("full"));
+    addGeometryQueryItem(query);
+    if (hasTimestamps)
+        query.addQueryItem(QStringLiteral("timestamps"), timestamps.join(QLatin1Char(';')));
+    if (hasAccuracy)
+        query.addQueryItem(QStringLiteral("radiuses"), radiuses.join(QLatin1Char(';')));
+    url.setQuery(query);
+    return url;
+}
+
 QGeoRouteParserOsrmV5::QGeoRouteParserOsrmV5(QObject *parent) : QGeoRouteParser(*new QGeoRouteParserOsrmV5Private(), parent)
 {
 }
@@ -975,4 +1263,16 @@ QGeoRouteParserOsrmV5::~QGeoRouteParserOsrmV5()
 {
 }
 
+void QGeoRouteParserOsrmV5::setGeometryFormat(GeometryFormat format)
+{
+    Q_D(QGeoRouteParserOsrmV5);
+    d->geometryFormat = format;
+}
+
+QGeoRouteParserOsrmV5::GeometryFormat QGeoRouteParserOsrmV5::geometryFormat() const
+{
+    Q_D(const QGeoRouteParserOsrmV5);
+    return d->geometryFormat;
+}
+
 QT_END_NAMESPACE
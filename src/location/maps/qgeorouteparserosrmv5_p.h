@@ -60,9 +60,18 @@ class Q_LOCATION_PRIVATE_EXPORT QGeoRouteParserOsrmV5 : public QGeoRouteParser
     Q_DECLARE_PRIVATE(QGeoRouteParserOsrmV5)
 
 public:
+    enum GeometryFormat {
+        PolylineGeometry,   // encoded polyline, 5 digits
+        Polyline6Geometry,  // encoded polyline, 6 digits
+        GeoJsonGeometry
+    };
+
     QGeoRouteParserOsrmV5(QObject *parent = Q_NULLPTR);
     virtual ~QGeoRouteParserOsrmV5();
 
+    void setGeometryFormat(GeometryFormat format);
+    GeometryFormat geometryFormat() const;
+
 private:
     Q_DISABLE_COPY(QGeoRouteParserOsrmV5)
 };
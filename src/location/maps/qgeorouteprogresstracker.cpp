@@ -0,0 +1,603 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeorouteprogresstracker.h"
+#include "qgeorouteprogresstracker_p.h"
+#include "qgeoroutesegment.h"
+
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Meters per mercator unit at the given latitude
+double metersPerUnit(double latitude)
+{
+    static const double earthCircumference = 40075016.686;
+    return earthCircumference * qMax(qCos(qDegreesToRadians(latitude)), 1e-6);
+}
+
+}
+
+/*!
+    \class QGeoRouteProgressTracker
+    \inmodule QtLocation
+    \ingroup QtLocation-routing
+    \since 5.9.6
+
+    \brief The QGeoRouteProgressTracker class follows the progress of a
+    position along a QGeoRoute.
+
+    Each position passed to updatePosition(), or emitted by the source(), is
+    matched to the nearest point of the route geometry. The tracker keeps a
+    cursor into the geometry and only searches the searchWindow() edges ahead
+    of it, so following the route costs a constant amount of work per
+    position. When no edge in the window is within offRouteThreshold() of the
+    position, plus its horizontal accuracy if it has one, the whole route is
+    searched through a spatial index. If that fails as well the tracker
+    reports that the position is off the route, and rejoins the route as soon
+    as a later position is close to any part of it again.
+
+    progressChanged() is emitted for every position matched to the route,
+    nextManeuverChanged() when the next maneuver changes and
+    offRouteChanged() when the position leaves or rejoins the route.
+*/
+
+/*!
+    \fn void QGeoRouteProgressTracker::progressChanged()
+
+    This signal is emitted when a position has been matched to the route.
+*/
+
+/*!
+    \fn void QGeoRouteProgressTracker::nextManeuverChanged()
+
+    This signal is emitted when the maneuver returned by nextManeuver()
+    changes.
+*/
+
+/*!
+    \fn void QGeoRouteProgressTracker::offRouteChanged(bool offRoute)
+
+    This signal is emitted when a position leaves the route, with
+    \a offRoute set to true, or when a position rejoins it.
+*/
+
+/*!
+    Constructs a route progress tracker with the given \a parent.
+*/
+QGeoRouteProgressTracker::QGeoRouteProgressTracker(QObject *parent)
+    : QObject(parent),
+      d_ptr(new QGeoRouteProgressTrackerPrivate())
+{
+}
+
+/*!
+    Destroys the tracker.
+*/
+QGeoRouteProgressTracker::~QGeoRouteProgressTracker()
+{
+    delete d_ptr;
+}
+
+/*!
+    Sets the \a route to follow and resets the progress.
+
+    The geometry is taken from the paths of the route segments, so that
+    maneuvers can be placed on it, or from QGeoRoute::path() if the segments
+    have no geometry.
+*/
+void QGeoRouteProgressTracker::setRoute(const QGeoRoute &route)
+{
+    d_ptr->route = route;
+    d_ptr->buildGeometry();
+    reset();
+}
+
+/*!
+    Returns the route being followed.
+*/
+QGeoRoute QGeoRouteProgressTracker::route() const
+{
+    return d_ptr->route;
+}
+
+/*!
+    Sets the \a source whose position updates are followed.
+
+    The tracker does not take ownership of the source, nor start it.
+*/
+void QGeoRouteProgressTracker::setSource(QGeoPositionInfoSource *source)
+{
+    if (d_ptr->source == source)
+        return;
+
+    if (d_ptr->source)
+        d_ptr->source->disconnect(this);
+
+    d_ptr->source = source;
+
+    if (source) {
+        connect(source, SIGNAL(positionUpdated(QGeoPositionInfo)),
+                this, SLOT(updatePosition(QGeoPositionInfo)));
+    }
+}
+
+/*!
+    Returns the source of position updates, or 0 if there is none.
+*/
+QGeoPositionInfoSource *QGeoRouteProgressTracker::source() const
+{
+    return d_ptr->source;
+}
+
+/*!
+    Sets the distance in \a meters a position can be away from the route
+    before it is considered off the route.
+
+    The horizontal accuracy of the position is added to this distance. The
+    default is 30 meters.
+*/
+void QGeoRouteProgressTracker::setOffRouteThreshold(qreal meters)
+{
+    d_ptr->offRouteThreshold = qMax(meters, qreal(0.0));
+}
+
+/*!
+    Returns the distance in meters a position can be away from the route
+    before it is considered off the route.
+*/
+qreal QGeoRouteProgressTracker::offRouteThreshold() const
+{
+    return d_ptr->offRouteThreshold;
+}
+
+/*!
+    Sets the number of route \a edges ahead of the last matched position that
+    are searched before falling back to searching the whole route.
+
+    The default is 32 edges.
+*/
+void QGeoRouteProgressTracker::setSearchWindow(int edges)
+{
+    d_ptr->searchWindow = qMax(edges, 1);
+}
+
+/*!
+    Returns the number of route edges searched ahead of the last matched
+    position.
+*/
+int QGeoRouteProgressTracker::searchWindow() const
+{
+    return d_ptr->searchWindow;
+}
+
+/*!
+    Returns true if the last position was too far away from the route.
+*/
+bool QGeoRouteProgressTracker::isOffRoute() const
+{
+    return d_ptr->offRoute;
+}
+
+/*!
+    Returns the point of the route the last position was matched to, or an
+    invalid coordinate if no position has been matched yet.
+*/
+QGeoCoordinate QGeoRouteProgressTracker::matchedCoordinate() const
+{
+    return d_ptr->matchedCoordinate;
+}
+
+/*!
+    Returns the distance in meters along the route from the matched position
+    to the end of the route.
+*/
+qreal QGeoRouteProgressTracker::distanceRemaining() const
+{
+    if (d_ptr->distances.isEmpty())
+        return 0.0;
+    return d_ptr->distances.last() - d_ptr->distanceTravelled();
+}
+
+/*!
+    Returns the estimated time in seconds from the matched position to the
+    end of the route.
+*/
+qreal QGeoRouteProgressTracker::timeRemaining() const
+{
+    if (d_ptr->times.isEmpty())
+        return 0.0;
+
+    const int edge = d_ptr->edge;
+    const qreal travelled = d_ptr->times.at(edge)
+            + d_ptr->fraction * (d_ptr->times.at(edge + 1) - d_ptr->times.at(edge));
+    return d_ptr->times.last() - travelled;
+}
+
+/*!
+    Returns the next maneuver ahead of the matched position, or an invalid
+    maneuver if there is none.
+*/
+QGeoManeuver QGeoRouteProgressTracker::nextManeuver() const
+{
+    if (d_ptr->nextManeuver < 0 || d_ptr->nextManeuver >= d_ptr->maneuvers.size())
+        return QGeoManeuver();
+    return d_ptr->maneuvers.at(d_ptr->nextManeuver);
+}
+
+/*!
+    Returns the distance in meters along the route from the matched position
+    to the next maneuver, or the distance remaining if there is no next
+    maneuver.
+*/
+qreal QGeoRouteProgressTracker::distanceToNextManeuver() const
+{
+    if (d_ptr->nextManeuver < 0 || d_ptr->nextManeuver >= d_ptr->maneuvers.size())
+        return distanceRemaining();
+
+    const int vertex = d_ptr->maneuverVertices.at(d_ptr->nextManeuver);
+    return d_ptr->distances.at(vertex) - d_ptr->distanceTravelled();
+}
+
+/*!
+    Matches \a position to the route and updates the progress.
+*/
+void QGeoRouteProgressTracker::updatePosition(const QGeoPositionInfo &position)
+{
+    const QGeoCoordinate coordinate = position.coordinate();
+    if (d_ptr->vertices.size() < 2 || !coordinate.isValid())
+        return;
+
+    double tolerance = d_ptr->offRouteThreshold;
+    if (position.hasAttribute(QGeoPositionInfo::HorizontalAccuracy))
+        tolerance += position.attribute(QGeoPositionInfo::HorizontalAccuracy);
+    tolerance /= metersPerUnit(coordinate.latitude());
+
+    const QDoubleVector2D point = QWebMercator::coordToMercator(coordinate);
+
+    double fraction = 0.0;
+    int edge = -1;
+    if (d_ptr->tracking && !d_ptr->offRoute)
+        edge = d_ptr->searchForward(point, tolerance, &fraction);
+    if (edge < 0)
+        edge = d_ptr->searchIndex(point, tolerance, &fraction);
+
+    if (edge < 0) {
+        if (!d_ptr->offRoute) {
+            d_ptr->offRoute = true;
+            emit offRouteChanged(true);
+        }
+        return;
+    }
+
+    const bool rejoined = d_ptr->offRoute;
+    d_ptr->tracking = true;
+    d_ptr->offRoute = false;
+    d_ptr->edge = edge;
+    d_ptr->fraction = fraction;
+
+    const QDoubleVector2D &from = d_ptr->vertices.at(edge);
+    const QDoubleVector2D &to = d_ptr->vertices.at(edge + 1);
+    d_ptr->matchedCoordinate = QWebMercator::mercatorToCoord(from + (to - from) * fraction);
+
+    const int nextManeuver = d_ptr->maneuverAfter(edge);
+    const bool maneuverChanged = nextManeuver != d_ptr->nextManeuver;
+    d_ptr->nextManeuver = nextManeuver;
+
+    if (rejoined)
+        emit offRouteChanged(false);
+    if (maneuverChanged)
+        emit nextManeuverChanged();
+    emit progressChanged();
+}
+
+/*!
+    Moves the progress back to the start of the route.
+*/
+void QGeoRouteProgressTracker::reset()
+{
+    const bool wasOffRoute = d_ptr->offRoute;
+    const int nextManeuver = d_ptr->maneuvers.isEmpty() ? -1 : 0;
+    const bool maneuverChanged = nextManeuver != d_ptr->nextManeuver;
+
+    d_ptr->tracking = false;
+    d_ptr->offRoute = false;
+    d_ptr->edge = 0;
+    d_ptr->fraction = 0.0;
+    d_ptr->nextManeuver = nextManeuver;
+    d_ptr->matchedCoordinate = QGeoCoordinate();
+
+    if (wasOffRoute)
+        emit offRouteChanged(false);
+    if (maneuverChanged)
+        emit nextManeuverChanged();
+    emit progressChanged();
+}
+
+/*******************************************************************************
+*******************************************************************************/
+
+QGeoRouteProgressTrackerPrivate::QGeoRouteProgressTrackerPrivate()
+    : offRouteThreshold(30.0),
+      searchWindow(32),
+      tracking(false),
+      offRoute(false),
+      edge(0),
+      fraction(0.0),
+      nextManeuver(-1),
+      cellSize(0.0),
+      columns(0),
+      rows(0)
+{
+}
+
+QGeoRouteProgressTrackerPrivate::~QGeoRouteProgressTrackerPrivate()
+{
+}
+
+void QGeoRouteProgressTrackerPrivate::buildGeometry()
+{
+    vertices.clear();
+    distances.clear();
+    times.clear();
+    maneuverVertices.clear();
+    maneuvers.clear();
+    cellStart.clear();
+    cellEdges.clear();
+
+    // Concatenate the segment paths, each segment starting where the previous one ended
+    QVector<QGeoCoordinate> coordinates;
+    QVector<int> segmentStarts;
+    QVector<qreal> segmentTimes;
+    QGeoRouteSegment segment = route.firstRouteSegment();
+    while (segment.isValid()) {
+        const QList<QGeoCoordinate> path = segment.path();
+        int start = coordinates.size();
+        if (!path.isEmpty() && start > 0 && coordinates.last() == path.first())
+            --start;
+        for (const QGeoCoordinate &coordinate : path) {
+            if (coordinates.isEmpty() || coordinates.last() != coordinate)
+                coordinates.append(coordinate);
+        }
+
+        start = qMin(start, qMax(coordinates.size() - 1, 0));
+        if (segment.maneuver().isValid()) {
+            maneuverVertices.append(start);
+            maneuvers.append(segment.maneuver());
+        }
+        segmentStarts.append(start);
+        segmentTimes.append(segment.travelTime());
+
+        segment = segment.nextRouteSegment();
+    }
+
+    if (coordinates.size() < 2) {
+        coordinates = route.path().toVector();
+        segmentStarts = QVector<int>() << 0;
+        segmentTimes = QVector<qreal>() << route.travelTime();
+        maneuverVertices.clear();
+        maneuvers.clear();
+    }
+
+    if (coordinates.size() < 2)
+        return;
+
+    const int count = coordinates.size();
+    vertices.resize(count);
+    QWebMercator::coordToMercator(coordinates.constData(), vertices.data(), count);
+
+    distances.resize(count);
+    distances[0] = 0.0;
+    for (int i = 1; i < count; ++i)
+        distances[i] = distances.at(i - 1) + coordinates.at(i - 1).distanceTo(coordinates.at(i));
+
+    // Spread the travel time of each segment over its edges by length
+    times.fill(0.0, count);
+    for (int s = 0; s < segmentStarts.size(); ++s) {
+        const int from = segmentStarts.at(s);
+        const int to = s + 1 < segmentStarts.size() ? segmentStarts.at(s + 1) : count - 1;
+        const qreal length = distances.at(to) - distances.at(from);
+        const qreal base = times.at(from);
+        for (int v = from + 1; v <= to; ++v) {
+            const qreal ratio = length > 0.0 ? (distances.at(v) - distances.at(from)) / length : 1.0;
+            times[v] = base + segmentTimes.at(s) * ratio;
+        }
+    }
+}
+
+void QGeoRouteProgressTrackerPrivate::buildIndex()
+{
+    if (!cellStart.isEmpty() || vertices.size() < 2)
+        return;
+
+    const int edgeCount = vertices.size() - 1;
+
+    QDoubleVector2D minimum = vertices.first();
+    QDoubleVector2D maximum = vertices.first();
+    double totalLength = 0.0;
+    for (int i = 0; i < vertices.size(); ++i) {
+        const QDoubleVector2D &v = vertices.at(i);
+        minimum.setX(qMin(minimum.x(), v.x()));
+        minimum.setY(qMin(minimum.y(), v.y()));
+        maximum.setX(qMax(maximum.x(), v.x()));
+        maximum.setY(qMax(maximum.y(), v.y()));
+        if (i > 0)
+            totalLength += (v - vertices.at(i - 1)).length();
+    }
+
+    // Cells about as large as an average edge, with no more cells than a few per edge
+    gridOrigin = minimum;
+    cellSize = qMax(totalLength / edgeCount, 1e-12);
+    const qint64 maxCells = 4 * qint64(edgeCount) + 64;
+    forever {
+        columns = int((maximum.x() - minimum.x()) / cellSize) + 1;
+        rows = int((maximum.y() - minimum.y()) / cellSize) + 1;
+        if (qint64(columns) * rows <= maxCells)
+            break;
+        cellSize *= 2.0;
+    }
+
+    // Counting sort of the edges into the cells their bounding box overlaps
+    cellStart.fill(0, columns * rows + 1);
+    for (int pass = 0; pass < 2; ++pass) {
+        QVector<int> next;
+        if (pass == 1) {
+            for (int c = 0; c < columns * rows; ++c)
+                cellStart[c + 1] += cellStart.at(c);
+            cellEdges.resize(cellStart.last());
+            next = cellStart;
+        }
+
+        for (int e = 0; e < edgeCount; ++e) {
+            const QDoubleVector2D &a = vertices.at(e);
+            const QDoubleVector2D &b = vertices.at(e + 1);
+            const int c0 = int((qMin(a.x(), b.x()) - gridOrigin.x()) / cellSize);
+            const int c1 = int((qMax(a.x(), b.x()) - gridOrigin.x()) / cellSize);
+            const int r0 = int((qMin(a.y(), b.y()) - gridOrigin.y()) / cellSize);
+            const int r1 = int((qMax(a.y(), b.y()) - gridOrigin.y()) / cellSize);
+            for (int r = r0; r <= r1; ++r) {
+                for (int c = c0; c <= c1; ++c) {
+                    const int cell = r * columns + c;
+                    if (pass == 0)
+                        ++cellStart[cell + 1];
+                    else
+                        cellEdges[next[cell]++] = e;
+                }
+            }
+        }
+    }
+}
+
+int QGeoRouteProgressTrackerPrivate::searchForward(const QDoubleVector2D &point, double tolerance,
+                                                   double *fraction) const
+{
+    const int last = qMin(edge + searchWindow, vertices.size() - 2);
+
+    // Take the closest edge of the first stretch of the window near the position, so that
+    // a later pass over the same place is not picked up too early
+    int best = -1;
+    double bestDistance = tolerance;
+    for (int i = edge; i <= last; ++i) {
+        double t;
+        const double distance = edgeDistance(i, point, &t);
+        if (best < 0 ? distance <= tolerance : distance < bestDistance) {
+            best = i;
+            bestDistance = distance;
+            *fraction = t;
+        } else if (best >= 0 && distance > tolerance) {
+            break;
+        }
+    }
+    return best;
+}
+
+int QGeoRouteProgressTrackerPrivate::searchIndex(const QDoubleVector2D &point, double tolerance,
+                                                 double *fraction)
+{
+    buildIndex();
+    if (cellStart.isEmpty())
+        return -1;
+
+    // Clamp before converting, a position far away from the route would overflow the cell index
+    const double lastColumn = columns - 1;
+    const double lastRow = rows - 1;
+    const int c0 = int(qBound(0.0, (point.x() - tolerance - gridOrigin.x()) / cellSize, lastColumn));
+    const int c1 = int(qBound(0.0, (point.x() + tolerance - gridOrigin.x()) / cellSize, lastColumn));
+    const int r0 = int(qBound(0.0, (point.y() - tolerance - gridOrigin.y()) / cellSize, lastRow));
+    const int r1 = int(qBound(0.0, (point.y() + tolerance - gridOrigin.y()) / cellSize, lastRow));
+
+    int best = -1;
+    double bestDistance = tolerance;
+    for (int r = r0; r <= r1; ++r) {
+        for (int c = c0; c <= c1; ++c) {
+            const int cell = r * columns + c;
+            for (int k = cellStart.at(cell); k < cellStart.at(cell + 1); ++k) {
+                const int e = cellEdges.at(k);
+                double t;
+                const double distance = edgeDistance(e, point, &t);
+                if (best < 0 ? distance <= tolerance
+                             : distance < bestDistance || (distance == bestDistance && e < best)) {
+                    best = e;
+                    bestDistance = distance;
+                    *fraction = t;
+                }
+            }
+        }
+    }
+    return best;
+}
+
+double QGeoRouteProgressTrackerPrivate::edgeDistance(int edge, const QDoubleVector2D &point,
+                                                     double *fraction) const
+{
+    const QDoubleVector2D &a = vertices.at(edge);
+    const QDoubleVector2D ab = vertices.at(edge + 1) - a;
+    const double lengthSquared = ab.lengthSquared();
+    const double t = lengthSquared > 0.0
+            ? qBound(0.0, QDoubleVector2D::dotProduct(point - a, ab) / lengthSquared, 1.0)
+            : 0.0;
+    *fraction = t;
+    return (a + ab * t - point).length();
+}
+
+// The index of the first maneuver beyond the start of edge, starting from the current one
+// so that following the route advances it by a few steps at most
+int QGeoRouteProgressTrackerPrivate::maneuverAfter(int edge) const
+{
+    const int count = maneuvers.size();
+    int i = qBound(0, nextManeuver, count);
+    if (i > 0 && maneuverVertices.at(i - 1) > edge) {
+        return std::upper_bound(maneuverVertices.constBegin(), maneuverVertices.constEnd(), edge)
+                - maneuverVertices.constBegin();
+    }
+    while (i < count && maneuverVertices.at(i) <= edge)
+        ++i;
+    return i;
+}
+
+qreal QGeoRouteProgressTrackerPrivate::distanceTravelled() const
+{
+    if (distances.isEmpty())
+        return 0.0;
+    return distances.at(edge) + fraction * (distances.at(edge + 1) - distances.at(edge));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,96 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEPROGRESSTRACKER_H
+#define QGEOROUTEPROGRESSTRACKER_H
+
+#include <QtLocation/qlocationglobal.h>
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoManeuver>
+#include <QtPositioning/QGeoPositionInfo>
+
+#include <QtCore/QObject>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoPositionInfoSource;
+class QGeoRouteProgressTrackerPrivate;
+
+class Q_LOCATION_EXPORT QGeoRouteProgressTracker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QGeoRouteProgressTracker(QObject *parent = Q_NULLPTR);
+    ~QGeoRouteProgressTracker();
+
+    void setRoute(const QGeoRoute &route);
+    QGeoRoute route() const;
+
+    void setSource(QGeoPositionInfoSource *source);
+    QGeoPositionInfoSource *source() const;
+
+    // defaults to 30 meters
+    void setOffRouteThreshold(qreal meters);
+    qreal offRouteThreshold() const;
+
+    // defaults to 32 edges
+    void setSearchWindow(int edges);
+    int searchWindow() const;
+
+    bool isOffRoute() const;
+    QGeoCoordinate matchedCoordinate() const;
+    qreal distanceRemaining() const;
+    qreal timeRemaining() const;
+    QGeoManeuver nextManeuver() const;
+    qreal distanceToNextManeuver() const;
+
+public Q_SLOTS:
+    void updatePosition(const QGeoPositionInfo &position);
+    void reset();
+
+Q_SIGNALS:
+    void progressChanged();
+    void nextManeuverChanged();
+    void offRouteChanged(bool offRoute);
+
+private:
+    QGeoRouteProgressTrackerPrivate *d_ptr;
+    Q_DISABLE_COPY(QGeoRouteProgressTracker)
+};
+
+QT_END_NAMESPACE
+
+#endif
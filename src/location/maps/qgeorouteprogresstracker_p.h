@@ -0,0 +1,105 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEPROGRESSTRACKER_P_H
+#define QGEOROUTEPROGRESSTRACKER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include "qgeorouteprogresstracker.h"
+
+#include <QtCore/QPointer>
+#include <QtCore/QVector>
+#include <QtPositioning/QGeoPositionInfoSource>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRouteProgressTrackerPrivate
+{
+public:
+    QGeoRouteProgressTrackerPrivate();
+    ~QGeoRouteProgressTrackerPrivate();
+
+    void buildGeometry();
+    void buildIndex();
+    int searchForward(const QDoubleVector2D &point, double tolerance, double *fraction) const;
+    int searchIndex(const QDoubleVector2D &point, double tolerance, double *fraction);
+    double edgeDistance(int edge, const QDoubleVector2D &point, double *fraction) const;
+    int maneuverAfter(int edge) const;
+    qreal distanceTravelled() const;
+
+    QGeoRoute route;
+    QPointer<QGeoPositionInfoSource> source;
+    qreal offRouteThreshold;
+    int searchWindow;
+
+    // The route geometry in mercator space, with the distance and time from the start at each vertex
+    QVector<QDoubleVector2D> vertices;
+    QVector<qreal> distances;
+    QVector<qreal> times;
+    QVector<int> maneuverVertices;
+    QVector<QGeoManeuver> maneuvers;
+
+    // The cursor, the edge the last position was matched to and how far along it
+    bool tracking;
+    bool offRoute;
+    int edge;
+    double fraction;
+    int nextManeuver;
+    QGeoCoordinate matchedCoordinate;
+
+    // Uniform grid over the edges, only built once a position has to be searched for everywhere
+    QDoubleVector2D gridOrigin;
+    double cellSize;
+    int columns;
+    int rows;
+    QVector<int> cellStart;
+    QVector<int> cellEdges;
+};
+
+QT_END_NAMESPACE
+
+#endif
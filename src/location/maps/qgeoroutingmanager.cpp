@@ -172,6 +172,26 @@ QGeoRoutingManager::QGeoRoutingManager(QGeoRoutingManagerEngine *engine, QObject
                 SIGNAL(error(QGeoRouteReply*,QGeoRouteReply::Error,QString)),
                 this,
                 SIGNAL(error(QGeoRouteReply*,QGeoRouteReply::Error,QString)));
+
+        connect(d_ptr->engine,
+                SIGNAL(matrixFinished(QGeoRouteMatrixReply*)),
+                this,
+                SIGNAL(matrixFinished(QGeoRouteMatrixReply*)));
+
+        connect(d_ptr->engine,
+                SIGNAL(matrixError(QGeoRouteMatrixReply*,QGeoRouteMatrixReply::Error,QString)),
+                this,
+                SIGNAL(matrixError(QGeoRouteMatrixReply*,QGeoRouteMatrixReply::Error,QString)));
+
+        connect(d_ptr->engine,
+                SIGNAL(matchFinished(QGeoRouteMatchReply*)),
+                this,
+                SIGNAL(matchFinished(QGeoRouteMatchReply*)));
+
+        connect(d_ptr->engine,
+                SIGNAL(matchError(QGeoRouteMatchReply*,QGeoRouteMatchReply::Error,QString)),
+                this,
+                SIGNAL(matchError(QGeoRouteMatchReply*,QGeoRouteMatchReply::Error,QString)));
     } else {
         qFatal("The routing manager engine that was set for this routing manager was NULL.");
     }
@@ -267,6 +287,66 @@ QGeoRouteReply *QGeoRoutingManager::updateRoute(const QGeoRoute &route, const QG
     return d_ptr->engine->updateRoute(route, position);
 }
 
+/*!
+    \since 5.9.6
+
+    Begins the calculation of the travel durations and distances between
+    every source and every destination of \a request.
+
+    A QGeoRouteMatrixReply object will be returned, which can be used to
+    manage the operation and to return the results of the operation.
+
+    This manager and the returned QGeoRouteMatrixReply object will emit
+    signals indicating if the operation completes or if errors occur.
+
+    Once the operation has completed, QGeoRouteMatrixReply::durations() and
+    QGeoRouteMatrixReply::distances() can be used to retrieve the results.
+    No QGeoRoute objects are created, which makes this considerably cheaper
+    than calculating each pair with calculateRoute().
+
+    If the service provider cannot calculate matrices, a
+    QGeoRouteMatrixReply::UnsupportedOptionError will occur.
+
+    The user is responsible for deleting the returned reply object, although
+    this can be done in the slot connected to
+    QGeoRoutingManager::matrixFinished(), QGeoRoutingManager::matrixError(),
+    QGeoRouteMatrixReply::finished() or QGeoRouteMatrixReply::error() with
+    deleteLater().
+*/
+QGeoRouteMatrixReply *QGeoRoutingManager::calculateRouteMatrix(const QGeoRouteMatrixRequest &request)
+{
+    return d_ptr->engine->calculateRouteMatrix(request);
+}
+
+/*!
+    \since 5.9.6
+
+    Begins matching the recorded track of \a request onto the road network.
+
+    A QGeoRouteMatchReply object will be returned, which can be used to
+    manage the operation and to return the results of the operation.
+
+    This manager and the returned QGeoRouteMatchReply object will emit
+    signals indicating if the operation completes or if errors occur.
+
+    Once the operation has completed, QGeoRouteMatchReply::path() holds the
+    matched road geometry, and QGeoRouteMatchReply::matchedCoordinates() and
+    QGeoRouteMatchReply::confidences() describe the match of each position.
+
+    If the service provider cannot match tracks, a
+    QGeoRouteMatchReply::UnsupportedOptionError will occur.
+
+    The user is responsible for deleting the returned reply object, although
+    this can be done in the slot connected to
+    QGeoRoutingManager::matchFinished(), QGeoRoutingManager::matchError(),
+    QGeoRouteMatchReply::finished() or QGeoRouteMatchReply::error() with
+    deleteLater().
+*/
+QGeoRouteMatchReply *QGeoRoutingManager::matchRoute(const QGeoRouteMatchRequest &request)
+{
+    return d_ptr->engine->matchRoute(request);
+}
+
 /*!
     Returns the travel modes supported by this manager.
 */
@@ -397,6 +477,66 @@ This signal and QGeoRouteReply::error() will be emitted at the same time.
 Use deleteLater() instead.
 */
 
+/*!
+\fn void QGeoRoutingManager::matrixFinished(QGeoRouteMatrixReply *reply)
+\since 5.9.6
+
+This signal is emitted when \a reply has finished processing.
+
+This signal and QGeoRouteMatrixReply::finished() will be emitted at the same
+time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
+/*!
+\fn void QGeoRoutingManager::matrixError(QGeoRouteMatrixReply *reply, QGeoRouteMatrixReply::Error error, QString errorString)
+\since 5.9.6
+
+This signal is emitted when an error has been detected in the processing of
+\a reply.  The QGeoRoutingManager::matrixFinished() signal will probably
+follow.
+
+The error will be described by the error code \a error.  If \a errorString is
+not empty it will contain a textual description of the error.
+
+This signal and QGeoRouteMatrixReply::error() will be emitted at the same time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
+/*!
+\fn void QGeoRoutingManager::matchFinished(QGeoRouteMatchReply *reply)
+\since 5.9.6
+
+This signal is emitted when \a reply has finished processing.
+
+This signal and QGeoRouteMatchReply::finished() will be emitted at the same
+time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
+/*!
+\fn void QGeoRoutingManager::matchError(QGeoRouteMatchReply *reply, QGeoRouteMatchReply::Error error, QString errorString)
+\since 5.9.6
+
+This signal is emitted when an error has been detected in the processing of
+\a reply.  The QGeoRoutingManager::matchFinished() signal will probably
+follow.
+
+The error will be described by the error code \a error.  If \a errorString is
+not empty it will contain a textual description of the error.
+
+This signal and QGeoRouteMatchReply::error() will be emitted at the same time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
 /*******************************************************************************
 *******************************************************************************/
 
@@ -36,6 +36,7 @@
 
 #include "qgeoroutingmanagerengine.h"
 #include "qgeoroutingmanagerengine_p.h"
+#include "qgeoroutingmanagerengineextension_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -202,6 +203,70 @@ QGeoRouteReply *QGeoRoutingManagerEngine::updateRoute(const QGeoRoute &route, co
                               QLatin1String("The updating of routes is not supported by this service provider."), this);
 }
 
+/*!
+    \since 5.9.6
+
+    Begins the calculation of the travel durations and distances between the
+    sources and destinations of \a request.
+
+    A QGeoRouteMatrixReply object will be returned, which can be used to
+    manage the operation and to return the results of the operation.
+
+    This engine and the returned QGeoRouteMatrixReply object will emit signals
+    indicating if the operation completes or if errors occur.
+
+    Engines whose backend can compute matrices directly implement the
+    private QGeoRoutingManagerEngineExtension interface, so that clients need
+    not issue one calculateRoute() per pair. Other engines return a
+    QGeoRouteMatrixReply object containing a
+    QGeoRouteMatrixReply::UnsupportedOptionError.
+
+    The user is responsible for deleting the returned reply object, although
+    this can be done in the slot connected to
+    QGeoRoutingManagerEngine::matrixFinished(),
+    QGeoRoutingManagerEngine::matrixError(), QGeoRouteMatrixReply::finished()
+    or QGeoRouteMatrixReply::error() with deleteLater().
+*/
+QGeoRouteMatrixReply *QGeoRoutingManagerEngine::calculateRouteMatrix(const QGeoRouteMatrixRequest &request)
+{
+    QGeoRoutingManagerEngineExtension *extension = qobject_cast<QGeoRoutingManagerEngineExtension *>(this);
+    if (extension)
+        return extension->calculateRouteMatrix(request);
+    return new QGeoRouteMatrixReply(QGeoRouteMatrixReply::UnsupportedOptionError,
+                                    QLatin1String("Route matrices are not supported by this service provider."), this);
+}
+
+/*!
+    \since 5.9.6
+
+    Begins matching the recorded track of \a request onto the road network.
+
+    A QGeoRouteMatchReply object will be returned, which can be used to
+    manage the operation and to return the results of the operation.
+
+    This engine and the returned QGeoRouteMatchReply object will emit signals
+    indicating if the operation completes or if errors occur.
+
+    Engines able to match tracks implement the private
+    QGeoRoutingManagerEngineExtension interface. Other engines return a
+    QGeoRouteMatchReply object containing a
+    QGeoRouteMatchReply::UnsupportedOptionError.
+
+    The user is responsible for deleting the returned reply object, although
+    this can be done in the slot connected to
+    QGeoRoutingManagerEngine::matchFinished(),
+    QGeoRoutingManagerEngine::matchError(), QGeoRouteMatchReply::finished()
+    or QGeoRouteMatchReply::error() with deleteLater().
+*/
+QGeoRouteMatchReply *QGeoRoutingManagerEngine::matchRoute(const QGeoRouteMatchRequest &request)
+{
+    QGeoRoutingManagerEngineExtension *extension = qobject_cast<QGeoRoutingManagerEngineExtension *>(this);
+    if (extension)
+        return extension->matchRoute(request);
+    return new QGeoRouteMatchReply(QGeoRouteMatchReply::UnsupportedOptionError,
+                                   QLatin1String("Map matching is not supported by this service provider."), this);
+}
+
 /*!
     Sets the travel modes supported by this engine to \a travelModes.
 
@@ -410,6 +475,66 @@ This signal and QGeoRouteReply::error() will be emitted at the same time.
 Use deleteLater() instead.
 */
 
+/*!
+\fn void QGeoRoutingManagerEngine::matrixFinished(QGeoRouteMatrixReply *reply)
+\since 5.9.6
+
+This signal is emitted when \a reply has finished processing.
+
+This signal and QGeoRouteMatrixReply::finished() will be emitted at the same
+time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
+/*!
+\fn void QGeoRoutingManagerEngine::matrixError(QGeoRouteMatrixReply *reply, QGeoRouteMatrixReply::Error error, QString errorString)
+\since 5.9.6
+
+This signal is emitted when an error has been detected in the processing of
+\a reply.  The QGeoRoutingManagerEngine::matrixFinished() signal will
+probably follow.
+
+The error will be described by the error code \a error.  If \a errorString is
+not empty it will contain a textual description of the error.
+
+This signal and QGeoRouteMatrixReply::error() will be emitted at the same time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
+/*!
+\fn void QGeoRoutingManagerEngine::matchFinished(QGeoRouteMatchReply *reply)
+\since 5.9.6
+
+This signal is emitted when \a reply has finished processing.
+
+This signal and QGeoRouteMatchReply::finished() will be emitted at the same
+time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
+/*!
+\fn void QGeoRoutingManagerEngine::matchError(QGeoRouteMatchReply *reply, QGeoRouteMatchReply::Error error, QString errorString)
+\since 5.9.6
+
+This signal is emitted when an error has been detected in the processing of
+\a reply.  The QGeoRoutingManagerEngine::matchFinished() signal will
+probably follow.
+
+The error will be described by the error code \a error.  If \a errorString is
+not empty it will contain a textual description of the error.
+
+This signal and QGeoRouteMatchReply::error() will be emitted at the same time.
+
+\note Do not delete the \a reply object in the slot connected to this signal.
+Use deleteLater() instead.
+*/
+
 /*******************************************************************************
 *******************************************************************************/
 
@@ -420,4 +545,6 @@ QGeoRoutingManagerEnginePrivate::QGeoRoutingManagerEnginePrivate()
 
 QGeoRoutingManagerEnginePrivate::~QGeoRoutingManagerEnginePrivate() {}
 
+QGeoRoutingManagerEngineExtension::~QGeoRoutingManagerEngineExtension() {}
+
 QT_END_NAMESPACE
@@ -42,6 +42,10 @@
 #include <QtCore/QLocale>
 #include <QtLocation/QGeoRouteRequest>
 #include <QtLocation/QGeoRouteReply>
+#include <QtLocation/QGeoRouteMatrixRequest>
+#include <QtLocation/QGeoRouteMatrixReply>
+#include <QtLocation/QGeoRouteMatchRequest>
+#include <QtLocation/QGeoRouteMatchReply>
 
 QT_BEGIN_NAMESPACE
 
@@ -59,6 +63,8 @@ public:
 
     virtual QGeoRouteReply *calculateRoute(const QGeoRouteRequest &request) = 0;
     virtual QGeoRouteReply *updateRoute(const QGeoRoute &route, const QGeoCoordinate &position);
+    QGeoRouteMatrixReply *calculateRouteMatrix(const QGeoRouteMatrixRequest &request);
+    QGeoRouteMatchReply *matchRoute(const QGeoRouteMatchRequest &request);
 
     QGeoRouteRequest::TravelModes supportedTravelModes() const;
     QGeoRouteRequest::FeatureTypes supportedFeatureTypes() const;
@@ -75,6 +81,10 @@ public:
 Q_SIGNALS:
     void finished(QGeoRouteReply *reply);
     void error(QGeoRouteReply *reply, QGeoRouteReply::Error error, QString errorString = QString());
+    void matrixFinished(QGeoRouteMatrixReply *reply);
+    void matrixError(QGeoRouteMatrixReply *reply, QGeoRouteMatrixReply::Error error, QString errorString = QString());
+    void matchFinished(QGeoRouteMatchReply *reply);
+    void matchError(QGeoRouteMatchReply *reply, QGeoRouteMatchReply::Error error, QString errorString = QString());
 
 protected:
     void setSupportedTravelModes(QGeoRouteRequest::TravelModes travelModes);
@@ -0,0 +1,79 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTINGMANAGERENGINEEXTENSION_P_H
+#define QGEOROUTINGMANAGERENGINEEXTENSION_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/QGeoRouteMatrixRequest>
+#include <QtLocation/QGeoRouteMatrixReply>
+#include <QtLocation/QGeoRouteMatchRequest>
+#include <QtLocation/QGeoRouteMatchReply>
+#include <QtCore/QtPlugin>
+
+QT_BEGIN_NAMESPACE
+
+/* Routing requests added after QGeoRoutingManagerEngine was released. They
+ * are not virtuals of the engine so that its vtable stays compatible; engines
+ * implementing them list this interface in Q_INTERFACES and are found with
+ * qobject_cast. Replies are parented to the engine and reported through its
+ * matrix and match signals. */
+class Q_LOCATION_PRIVATE_EXPORT QGeoRoutingManagerEngineExtension
+{
+public:
+    virtual ~QGeoRoutingManagerEngineExtension();
+
+    virtual QGeoRouteMatrixReply *calculateRouteMatrix(const QGeoRouteMatrixRequest &request) = 0;
+    virtual QGeoRouteMatchReply *matchRoute(const QGeoRouteMatchRequest &request) = 0;
+};
+
+#define QGeoRoutingManagerEngineExtension_iid "org.qt-project.qt.geoservice.routingmanagerengineextension/5.9.6"
+Q_DECLARE_INTERFACE(QGeoRoutingManagerEngineExtension, QGeoRoutingManagerEngineExtension_iid)
+
+QT_END_NAMESPACE
+
+#endif // QGEOROUTINGMANAGERENGINEEXTENSION_P_H
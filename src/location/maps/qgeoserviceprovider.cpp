@@ -51,6 +51,7 @@
 #include <QList>
 #include <QString>
 #include <QVariant>
+#include <QVector>
 
 #include <QDebug>
 #include <QStringList>
@@ -58,6 +59,8 @@
 #include <QObject>
 #include <QMetaObject>
 #include <QMetaEnum>
+#include <QMutex>
+#include <QThread>
 #include <QtCore/private/qfactoryloader_p.h>
 
 QT_BEGIN_NAMESPACE
@@ -335,6 +338,115 @@ template <> QPlaceManagerEngine *createEngine<QPlaceManagerEngine>(QGeoServicePr
     return d_ptr->factory->createPlaceManagerEngine(d_ptr->cleanedParameterMap, &(d_ptr->placeError), &(d_ptr->placeErrorString));
 }
 
+/* A mapping manager owns an engine with its network access manager, tile
+ * fetcher and tile cache. Providers created in the same thread with the same
+ * plugin, parameters and locale share one, so that their maps share these and
+ * the budget of the tile cache. */
+class QGeoMappingManagerRegistry
+{
+public:
+    QGeoMappingManager *acquire(const QString &providerName, const QVariantMap &parameters,
+                                const QLocale &locale)
+    {
+        QMutexLocker locker(&mutex_);
+        for (Entry &entry : entries_) {
+            if (entry.providerName == providerName && entry.parameters == parameters
+                    && entry.manager->locale() == locale
+                    && entry.manager->thread() == QThread::currentThread()) {
+                ++entry.ref;
+                return entry.manager;
+            }
+        }
+        return 0;
+    }
+
+    void insert(const QString &providerName, const QVariantMap &parameters,
+                QGeoMappingManager *manager)
+    {
+        QMutexLocker locker(&mutex_);
+        Entry entry;
+        entry.providerName = providerName;
+        entry.parameters = parameters;
+        entry.manager = manager;
+        entry.ref = 1;
+        entries_.append(entry);
+    }
+
+    bool isShared(QGeoMappingManager *manager)
+    {
+        QMutexLocker locker(&mutex_);
+        for (const Entry &entry : qAsConst(entries_)) {
+            if (entry.manager == manager)
+                return entry.ref > 1;
+        }
+        return false;
+    }
+
+    void release(QGeoMappingManager *manager)
+    {
+        QMutexLocker locker(&mutex_);
+        for (int i = 0; i < entries_.size(); ++i) {
+            if (entries_.at(i).manager != manager)
+                continue;
+            if (--entries_[i].ref > 0)
+                return;
+            entries_.remove(i);
+            break;
+        }
+        locker.unlock();
+        delete manager;
+    }
+
+private:
+    struct Entry
+    {
+        QString providerName;
+        QVariantMap parameters;
+        QGeoMappingManager *manager;
+        int ref;
+    };
+
+    QMutex mutex_;
+    QVector<Entry> entries_;
+};
+
+Q_GLOBAL_STATIC(QGeoMappingManagerRegistry, mappingManagerRegistry)
+
+/* Providers can outlive the registry when they are destroyed during static
+ * destruction. From then on nothing is shared, and the managers that were
+ * shared are left to the end of the process, as the references to them can no
+ * longer be counted. */
+static void releaseMappingManager(QGeoMappingManager *manager)
+{
+    if (QGeoMappingManagerRegistry *registry = mappingManagerRegistry())
+        registry->release(manager);
+}
+
+/* Only mapping managers are shared, the others are cheap to create */
+template <class Manager>
+Manager *acquireManager(QGeoServiceProviderPrivate *)
+{
+    return 0;
+}
+template <> QGeoMappingManager *acquireManager<QGeoMappingManager>(QGeoServiceProviderPrivate *d_ptr)
+{
+    QGeoMappingManagerRegistry *registry = mappingManagerRegistry();
+    if (!registry)
+        return 0;
+    return registry->acquire(d_ptr->providerName, d_ptr->cleanedParameterMap,
+                             d_ptr->localeSet ? d_ptr->locale : QLocale());
+}
+
+template <class Manager>
+void shareManager(QGeoServiceProviderPrivate *, Manager *)
+{
+}
+template <> void shareManager<QGeoMappingManager>(QGeoServiceProviderPrivate *d_ptr, QGeoMappingManager *manager)
+{
+    if (QGeoMappingManagerRegistry *registry = mappingManagerRegistry())
+        registry->insert(d_ptr->providerName, d_ptr->cleanedParameterMap, manager);
+}
+
 /* Template for generating the code for each of the geocodingManager(),
  * mappingManager() etc methods */
 template <class Manager, class Engine>
@@ -354,6 +466,9 @@ Manager *QGeoServiceProviderPrivate::manager(QGeoServiceProvider::Error *_error,
     if (!this->factory || error != QGeoServiceProvider::NoError)
         return 0;
 
+    if (!manager)
+        manager = acquireManager<Manager>(this);
+
     if (!manager) {
         Engine *engine = createEngine<Engine>(this);
 
@@ -379,6 +494,8 @@ Manager *QGeoServiceProviderPrivate::manager(QGeoServiceProvider::Error *_error,
 
         if (manager && this->localeSet)
             manager->setLocale(this->locale);
+        if (manager)
+            shareManager<Manager>(this, manager);
     }
 
     if (manager) {
@@ -433,6 +550,12 @@ QGeoCodingManager *QGeoServiceProvider::geocodingManager() const
     be deleted separately. Users should assume that deleting the
     QGeoServiceProvider renders the pointer returned by this method invalid.
 
+    Service providers of the same thread with the same name, parameters and
+    locale share their QGeoMappingManager, so that the maps they create share
+    the network access, tile fetching and tile cache of one engine. A provider
+    whose locale changes while its manager is shared switches to a manager for
+    the new locale, the other providers keep theirs.
+
     After this function has been called, error() and errorString() will
     report any errors which occurred during the construction of the
     QGeoMappingManager.
@@ -553,6 +676,10 @@ void QGeoServiceProvider::setParameters(const QVariantMap &parameters)
     Sets the locale used by this service provider to \a locale. If the relevant features
     (see LocalizedMappingFeature etc), this will change the languages, units
     and other locale-specific attributes of the provider's data.
+
+    If the mapping manager of the provider is shared with other providers, the
+    next call to mappingManager() returns a different manager, for the new
+    locale. The previous one stays valid until the provider is unloaded.
 */
 void QGeoServiceProvider::setLocale(const QLocale &locale)
 {
@@ -563,8 +690,18 @@ void QGeoServiceProvider::setLocale(const QLocale &locale)
         d_ptr->geocodingManager->setLocale(locale);
     if (d_ptr->routingManager)
         d_ptr->routingManager->setLocale(locale);
-    if (d_ptr->mappingManager)
-        d_ptr->mappingManager->setLocale(locale);
+    if (d_ptr->mappingManager) {
+        QGeoMappingManagerRegistry *registry = mappingManagerRegistry();
+        if (!registry || registry->isShared(d_ptr->mappingManager)) {
+            // Other providers keep the shared manager and its locale, the next call to
+            // mappingManager() acquires one for the new locale. The old one is kept
+            // until unload(), for the maps already created from it.
+            d_ptr->retiredMappingManagers.append(d_ptr->mappingManager);
+            d_ptr->mappingManager = 0;
+        } else {
+            d_ptr->mappingManager->setLocale(locale);
+        }
+    }
     if (d_ptr->placeManager)
         d_ptr->placeManager->setLocale(locale);
 }
@@ -591,10 +728,7 @@ QGeoServiceProviderPrivate::QGeoServiceProviderPrivate()
 
 QGeoServiceProviderPrivate::~QGeoServiceProviderPrivate()
 {
-    delete geocodingManager;
-    delete routingManager;
-    delete mappingManager;
-    delete placeManager;
+    unload();
 }
 
 void QGeoServiceProviderPrivate::unload()
@@ -605,8 +739,12 @@ void QGeoServiceProviderPrivate::unload()
     delete routingManager;
     routingManager = 0;
 
-    delete mappingManager;
+    if (mappingManager)
+        releaseMappingManager(mappingManager);
     mappingManager = 0;
+    for (QGeoMappingManager *manager : qAsConst(retiredMappingManagers))
+        releaseMappingManager(manager);
+    retiredMappingManagers.clear();
 
     delete placeManager;
     placeManager = 0;
@@ -51,6 +51,7 @@
 #include "qgeoserviceprovider.h"
 
 #include <QHash>
+#include <QList>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QLocale>
@@ -93,6 +94,8 @@ public:
     QGeoRoutingManager *routingManager;
     QGeoMappingManager *mappingManager;
     QPlaceManager *placeManager;
+    // Shared mapping managers given up by setLocale(), released on unload()
+    QList<QGeoMappingManager *> retiredMappingManagers;
 
     QGeoServiceProvider::Error geocodeError;
     QGeoServiceProvider::Error routingError;
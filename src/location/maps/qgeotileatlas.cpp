@@ -0,0 +1,332 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotileatlas_p.h"
+
+#include <QtGui/QPainter>
+#include <QtQuick/QSGTexture>
+#if QT_CONFIG(opengl)
+#include <QtGui/QOpenGLContext>
+#include <QtGui/QOpenGLFunctions>
+#endif
+
+#ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
+#define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
+#endif
+#ifndef GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT
+#define GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT 0x84FF
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QGeoTileAtlasAllocator::QGeoTileAtlasAllocator(int slotsPerPage)
+    : m_slotsPerPage(qMax(1, slotsPerPage))
+{
+}
+
+QGeoTileAtlasAllocator::Slot QGeoTileAtlasAllocator::allocate()
+{
+    for (int page = 0; page < m_freeSlots.size(); ++page) {
+        QVector<int> &freeSlots = m_freeSlots[page];
+        if (!freeSlots.isEmpty())
+            return Slot(page, freeSlots.takeLast());
+    }
+
+    QVector<int> freeSlots;
+    freeSlots.reserve(m_slotsPerPage);
+    for (int index = m_slotsPerPage - 1; index > 0; --index)
+        freeSlots.append(index);
+    m_freeSlots.append(freeSlots);
+    return Slot(m_freeSlots.size() - 1, 0);
+}
+
+void QGeoTileAtlasAllocator::release(const Slot &slot)
+{
+    if (slot.page < 0 || slot.page >= m_freeSlots.size()
+            || slot.index < 0 || slot.index >= m_slotsPerPage) {
+        return;
+    }
+
+    m_freeSlots[slot.page].append(slot.index);
+
+    while (!m_freeSlots.isEmpty() && m_freeSlots.last().size() == m_slotsPerPage)
+        m_freeSlots.removeLast();
+}
+
+void QGeoTileAtlasAllocator::clear()
+{
+    m_freeSlots.clear();
+}
+
+int QGeoTileAtlasAllocator::slotsPerPage() const
+{
+    return m_slotsPerPage;
+}
+
+int QGeoTileAtlasAllocator::pageCount() const
+{
+    return m_freeSlots.size();
+}
+
+int QGeoTileAtlasAllocator::usedSlots() const
+{
+    int used = 0;
+    for (int page = 0; page < m_freeSlots.size(); ++page)
+        used += usedSlots(page);
+    return used;
+}
+
+int QGeoTileAtlasAllocator::usedSlots(int page) const
+{
+    if (page < 0 || page >= m_freeSlots.size())
+        return 0;
+    return m_slotsPerPage - m_freeSlots.at(page).size();
+}
+
+// One atlas page. Images are queued and copied into the texture the next time it is bound,
+// on the render thread.
+class QGeoTileAtlasTexture : public QSGTexture
+{
+public:
+    explicit QGeoTileAtlasTexture(const QSize &size)
+        : m_size(size), m_textureId(0), m_allocated(false), m_hasAlphaChannel(false)
+    {
+    }
+
+    ~QGeoTileAtlasTexture()
+    {
+#if QT_CONFIG(opengl)
+        if (m_textureId && QOpenGLContext::currentContext())
+            QOpenGLContext::currentContext()->functions()->glDeleteTextures(1, &m_textureId);
+#endif
+    }
+
+    int textureId() const Q_DECL_OVERRIDE
+    {
+#if QT_CONFIG(opengl)
+        // Materials are told apart by texture id, so hand out a real one before the first bind()
+        if (!m_textureId && QOpenGLContext::currentContext())
+            QOpenGLContext::currentContext()->functions()->glGenTextures(1, &m_textureId);
+#endif
+        return int(m_textureId);
+    }
+
+    QSize textureSize() const Q_DECL_OVERRIDE { return m_size; }
+    bool hasAlphaChannel() const Q_DECL_OVERRIDE { return m_hasAlphaChannel; }
+    bool hasMipmaps() const Q_DECL_OVERRIDE { return false; }
+
+    void upload(const QPoint &position, const QImage &image, bool hasAlphaChannel)
+    {
+        Upload upload;
+        upload.position = position;
+        upload.image = image;
+        m_uploads.append(upload);
+        m_hasAlphaChannel |= hasAlphaChannel;
+    }
+
+    void bind() Q_DECL_OVERRIDE
+    {
+#if QT_CONFIG(opengl)
+        QOpenGLContext *context = QOpenGLContext::currentContext();
+        QOpenGLFunctions *funcs = context->functions();
+        textureId();
+        funcs->glBindTexture(GL_TEXTURE_2D, m_textureId);
+
+        if (!m_allocated) {
+            funcs->glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_size.width(), m_size.height(), 0,
+                                GL_RGBA, GL_UNSIGNED_BYTE, 0);
+            if (context->hasExtension(QByteArrayLiteral("GL_EXT_texture_filter_anisotropic"))) {
+                GLfloat maxAnisotropy = 1.0f;
+                funcs->glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &maxAnisotropy);
+                funcs->glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAX_ANISOTROPY_EXT, qMin(16.0f, maxAnisotropy));
+            }
+            m_allocated = true;
+            updateBindOptions(true);
+        } else {
+            updateBindOptions(false);
+        }
+
+        for (const Upload &upload : qAsConst(m_uploads)) {
+            funcs->glTexSubImage2D(GL_TEXTURE_2D, 0, upload.position.x(), upload.position.y(),
+                                   upload.image.width(), upload.image.height(),
+                                   GL_RGBA, GL_UNSIGNED_BYTE, upload.image.constBits());
+        }
+        m_uploads.clear();
+#endif
+    }
+
+private:
+    struct Upload
+    {
+        QPoint position;
+        QImage image;
+    };
+
+    QSize m_size;
+    mutable uint m_textureId;
+    bool m_allocated;
+    bool m_hasAlphaChannel;
+    QVector<Upload> m_uploads;
+};
+
+// Returns image with a one pixel border repeating its edges, in the layout of GL_RGBA
+static QImage qgeotileatlas_paddedImage(const QImage &image)
+{
+    const int w = image.width();
+    const int h = image.height();
+    QImage padded(w + 2, h + 2, QImage::Format_RGBA8888_Premultiplied);
+
+    QPainter painter(&padded);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(1, 1, image);
+    painter.drawImage(QRect(1, 0, w, 1), image, QRect(0, 0, w, 1));
+    painter.drawImage(QRect(1, h + 1, w, 1), image, QRect(0, h - 1, w, 1));
+    painter.drawImage(QRect(0, 1, 1, h), image, QRect(0, 0, 1, h));
+    painter.drawImage(QRect(w + 1, 1, 1, h), image, QRect(w - 1, 0, 1, h));
+    painter.drawImage(QPoint(0, 0), image, QRect(0, 0, 1, 1));
+    painter.drawImage(QPoint(w + 1, 0), image, QRect(w - 1, 0, 1, 1));
+    painter.drawImage(QPoint(0, h + 1), image, QRect(0, h - 1, 1, 1));
+    painter.drawImage(QPoint(w + 1, h + 1), image, QRect(w - 1, h - 1, 1, 1));
+    painter.end();
+
+    return padded;
+}
+
+QGeoTileAtlas::QGeoTileAtlas(const QSize &slotSize, int pageSize)
+    : m_slotSize(slotSize),
+      m_pageSize(pageSize),
+      m_slotsPerRow(qMax(1, pageSize / (slotSize.width() + 2))),
+      m_allocator(m_slotsPerRow * qMax(1, pageSize / (slotSize.height() + 2)))
+{
+}
+
+QGeoTileAtlas::~QGeoTileAtlas()
+{
+    qDeleteAll(m_pages);
+}
+
+/*
+    Returns whether tiles of \a slotSize can be packed, at least four to a page.
+    Tiny tiles are not worth it.
+*/
+bool QGeoTileAtlas::isSupported(const QSize &slotSize, int pageSize)
+{
+#if QT_CONFIG(opengl)
+    if (slotSize.isEmpty()
+            || 2 * (slotSize.width() + 2) > pageSize
+            || 2 * (slotSize.height() + 2) > pageSize) {
+        return false;
+    }
+    // Each tile takes four vertices, with 16 bit indices
+    const int slots = (pageSize / (slotSize.width() + 2)) * (pageSize / (slotSize.height() + 2));
+    return slots <= 16384;
+#else
+    Q_UNUSED(slotSize)
+    Q_UNUSED(pageSize)
+    return false;
+#endif
+}
+
+QSize QGeoTileAtlas::slotSize() const
+{
+    return m_slotSize;
+}
+
+/*
+    Returns the size of the page textures, no larger than needed to hold their slots.
+*/
+QSize QGeoTileAtlas::pageSize() const
+{
+    const int slotsPerColumn = m_allocator.slotsPerPage() / m_slotsPerRow;
+    return QSize(m_slotsPerRow * (m_slotSize.width() + 2), slotsPerColumn * (m_slotSize.height() + 2));
+}
+
+int QGeoTileAtlas::pageCount() const
+{
+    return m_pages.size();
+}
+
+QSGTexture *QGeoTileAtlas::page(int page) const
+{
+    return m_pages.value(page);
+}
+
+bool QGeoTileAtlas::isEmpty() const
+{
+    return m_allocator.usedSlots() == 0;
+}
+
+/*
+    Copies \a image, which must be of slotSize(), into a free slot and returns it.
+*/
+QGeoTileAtlas::Slot QGeoTileAtlas::insert(const QImage &image)
+{
+    if (image.size() != m_slotSize)
+        return Slot();
+
+    const Slot slot = m_allocator.allocate();
+    while (m_pages.size() < m_allocator.pageCount())
+        m_pages.append(new QGeoTileAtlasTexture(pageSize()));
+
+    const QPoint position = slotRect(slot).topLeft().toPoint() - QPoint(1, 1);
+    m_pages.at(slot.page)->upload(position, qgeotileatlas_paddedImage(image), image.hasAlphaChannel());
+    return slot;
+}
+
+/*
+    Frees \a slot. Pages left empty at the end are deleted.
+*/
+void QGeoTileAtlas::release(const Slot &slot)
+{
+    m_allocator.release(slot);
+    while (m_pages.size() > m_allocator.pageCount())
+        m_pages.takeLast()->deleteLater();
+}
+
+/*
+    Returns the area of its page, in pixels, holding the image of \a slot.
+*/
+QRectF QGeoTileAtlas::slotRect(const Slot &slot) const
+{
+    const int column = slot.index % m_slotsPerRow;
+    const int row = slot.index / m_slotsPerRow;
+    return QRectF(column * (m_slotSize.width() + 2) + 1,
+                  row * (m_slotSize.height() + 2) + 1,
+                  m_slotSize.width(),
+                  m_slotSize.height());
+}
+
+QT_END_NAMESPACE
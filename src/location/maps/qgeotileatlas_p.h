@@ -0,0 +1,132 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+#ifndef QGEOTILEATLAS_P_H
+#define QGEOTILEATLAS_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QVector>
+#include <QtCore/QRectF>
+#include <QtGui/QImage>
+#include <QtLocation/private/qlocationglobal_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QSGTexture;
+class QGeoTileAtlasTexture;
+
+// Hands out the slots of atlas pages holding a fixed number of equally sized tiles.
+// Released slots are reused before a new page is started, lowest pages first, so
+// that the last pages empty out and can be dropped.
+class Q_LOCATION_PRIVATE_EXPORT QGeoTileAtlasAllocator
+{
+public:
+    struct Slot
+    {
+        Slot() : page(-1), index(-1) {}
+        Slot(int page, int index) : page(page), index(index) {}
+
+        bool isValid() const { return page >= 0 && index >= 0; }
+        bool operator==(const Slot &other) const { return page == other.page && index == other.index; }
+        bool operator!=(const Slot &other) const { return !(*this == other); }
+
+        int page;
+        int index;
+    };
+
+    explicit QGeoTileAtlasAllocator(int slotsPerPage);
+
+    Slot allocate();
+    void release(const Slot &slot);
+    void clear();
+
+    int slotsPerPage() const;
+    int pageCount() const;
+    int usedSlots() const;
+    int usedSlots(int page) const;
+
+private:
+    int m_slotsPerPage;
+    QVector<QVector<int> > m_freeSlots; // per page, the next one to hand out at the back
+};
+
+// Tile images packed into a few large textures. Images are copied into their slot
+// with a one pixel border repeating their edges, so that linear filtering does not
+// bleed neighbouring tiles in. Requires an OpenGL scene graph.
+class QGeoTileAtlas
+{
+public:
+    typedef QGeoTileAtlasAllocator::Slot Slot;
+
+    explicit QGeoTileAtlas(const QSize &slotSize, int pageSize = 2048); // pageSize is the upper bound
+    ~QGeoTileAtlas();
+
+    static bool isSupported(const QSize &slotSize, int pageSize = 2048);
+
+    QSize slotSize() const;
+    QSize pageSize() const;
+    int pageCount() const;
+    QSGTexture *page(int page) const;
+    bool isEmpty() const;
+
+    Slot insert(const QImage &image);
+    void release(const Slot &slot);
+    QRectF slotRect(const Slot &slot) const;
+
+private:
+    QSize m_slotSize;
+    int m_pageSize;
+    int m_slotsPerRow;
+    QGeoTileAtlasAllocator m_allocator;
+    QVector<QGeoTileAtlasTexture *> m_pages;
+
+    Q_DISABLE_COPY(QGeoTileAtlas)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEATLAS_P_H
@@ -112,6 +112,12 @@ void QGeoTiledMap::updateTile(const QGeoTileSpec &spec)
     d->updateTile(spec);
 }
 
+void QGeoTiledMap::updateTileFallback(const QGeoTileSpec &spec, const QSharedPointer<QGeoTileTexture> &texture)
+{
+    Q_D(QGeoTiledMap);
+    d->updateTileFallback(spec, texture);
+}
+
 void QGeoTiledMap::setPrefetchStyle(QGeoTiledMap::PrefetchStyle style)
 {
     Q_D(QGeoTiledMap);
@@ -388,8 +394,10 @@ void QGeoTiledMapPrivate::changeViewportSize(const QSize& size)
         texCacheSize *= 3;
         // TODO: move this reasoning into the tilecache
 
-        int newSize = qMax(m_cache->minTextureUsage(), texCacheSize);
-        m_cache->setMinTextureUsage(newSize);
+        // the cache may be shared with other maps, the engine adds up their needs
+        QGeoTiledMappingManagerEngine *engine = qobject_cast<QGeoTiledMappingManagerEngine *>(m_engine);
+        if (engine)
+            engine->setMapTextureUsage(q, texCacheSize);
     }
 
     if (m_copyrightVisible)
@@ -410,6 +418,14 @@ void QGeoTiledMapPrivate::updateTile(const QGeoTileSpec &spec)
     }
 }
 
+void QGeoTiledMapPrivate::updateTileFallback(const QGeoTileSpec &spec, const QSharedPointer<QGeoTileTexture> &texture)
+{
+    Q_Q(QGeoTiledMap);
+    // A stand-in texture must never replace whatever is already shown for the tile
+    if (m_visibleTiles->createTiles().contains(spec) && m_mapScene->addFallbackTile(spec, texture))
+        emit q->sgNodeChanged();
+}
+
 QSGNode *QGeoTiledMapPrivate::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
 {
     return m_mapScene->updateSceneGraph(oldNode, window);
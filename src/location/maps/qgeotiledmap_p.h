@@ -82,6 +82,7 @@ public:
     QAbstractGeoTileCache *tileCache();
     QGeoTileRequestManager *requestManager();
     void updateTile(const QGeoTileSpec &spec);
+    void updateTileFallback(const QGeoTileSpec &spec, const QSharedPointer<QGeoTileTexture> &texture);
     void setPrefetchStyle(PrefetchStyle style);
 
     void prefetchData() Q_DECL_OVERRIDE;
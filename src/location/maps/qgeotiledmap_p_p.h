@@ -78,6 +78,7 @@ public:
     QSGNode *updateSceneGraph(QSGNode *node, QQuickWindow *window);
 
     void updateTile(const QGeoTileSpec &spec);
+    void updateTileFallback(const QGeoTileSpec &spec, const QSharedPointer<QGeoTileTexture> &texture);
     void prefetchTiles();
     QGeoMapType activeMapType();
     void onCameraCapabilitiesChanged(const QGeoCameraCapabilities &oldCameraCapabilities);
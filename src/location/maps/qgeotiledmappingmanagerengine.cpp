@@ -43,12 +43,17 @@
 #include "qgeotilerequestmanager_p.h"
 #include "qgeofiletilecache_p.h"
 #include "qgeotilespec_p.h"
+#include "qgeotileprefetchjob_p.h"
 
 #include <QTimer>
+#include <QMutex>
+#include <QPair>
 #include <QLocale>
 #include <QDir>
 #include <QStandardPaths>
 
+#include <cmath>
+
 QT_BEGIN_NAMESPACE
 
 QGeoTiledMappingManagerEngine::QGeoTiledMappingManagerEngine(QObject *parent)
@@ -63,6 +68,8 @@ QGeoTiledMappingManagerEngine::QGeoTiledMappingManagerEngine(QObject *parent)
 */
 QGeoTiledMappingManagerEngine::~QGeoTiledMappingManagerEngine()
 {
+    for (QGeoTilePrefetchJob *job : qAsConst(d_ptr->prefetchJobs_))
+        job->detach();
     delete d_ptr;
 }
 
@@ -90,6 +97,11 @@ void QGeoTiledMappingManagerEngine::setTileFetcher(QGeoTileFetcher *fetcher)
             this,
             SLOT(engineTileError(QGeoTileSpec,QString)),
             Qt::QueuedConnection);
+    connect(d->fetcher_,
+            SIGNAL(tileFreshnessReceived(QGeoTileSpec,QGeoTileFreshness,bool)),
+            this,
+            SLOT(engineTileFreshnessReceived(QGeoTileSpec,QGeoTileFreshness,bool)),
+            Qt::QueuedConnection);
 
     engineInitialized();
 }
@@ -107,23 +119,56 @@ QGeoMap *QGeoTiledMappingManagerEngine::createMap()
 
 void QGeoTiledMappingManagerEngine::releaseMap(QGeoTiledMap *map)
 {
-    d_ptr->mapHash_.remove(map);
-
-    QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > newTileHash = d_ptr->tileHash_;
-    typedef QHash<QGeoTileSpec, QSet<QGeoTiledMap *> >::const_iterator h_iter;
-    h_iter hi = d_ptr->tileHash_.constBegin();
-    h_iter hend = d_ptr->tileHash_.constEnd();
-    for (; hi != hend; ++hi) {
-        QSet<QGeoTiledMap *> maps = hi.value();
-        if (maps.contains(map)) {
-            maps.remove(map);
-            if (maps.isEmpty())
-                newTileHash.remove(hi.key());
-            else
-                newTileHash.insert(hi.key(), maps);
+    d_ptr->subscriptions_.removeMap(map);
+    setMapTextureUsage(map, 0);
+}
+
+/* The texture cache needed by every map of the process, with the cache it
+ * draws from. Engines shared through the service provider registry, or tile
+ * caches shared by engines, are sized for all the maps using them. */
+class QGeoTileTextureAccounting
+{
+public:
+    // Returns the sum of the needs of the maps using cache
+    int setUsage(const QGeoTiledMap *map, const QAbstractGeoTileCache *cache, int textureUsage)
+    {
+        QMutexLocker locker(&mutex_);
+        if (textureUsage > 0)
+            usage_.insert(map, qMakePair(cache, textureUsage));
+        else
+            usage_.remove(map);
+
+        int total = 0;
+        for (const QPair<const QAbstractGeoTileCache *, int> &usage : qAsConst(usage_)) {
+            if (usage.first == cache)
+                total += usage.second;
         }
+        return total;
     }
-    d_ptr->tileHash_ = newTileHash;
+
+private:
+    QMutex mutex_;
+    QHash<const QGeoTiledMap *, QPair<const QAbstractGeoTileCache *, int> > usage_;
+};
+
+Q_GLOBAL_STATIC(QGeoTileTextureAccounting, textureAccounting)
+
+/*
+    Records the texture cache \a map needs to show a full display of tiles.
+    The minimum size of the tile cache is the sum of the needs of all the maps
+    using it, across the engines of the process.
+*/
+void QGeoTiledMappingManagerEngine::setMapTextureUsage(QGeoTiledMap *map, int textureUsage)
+{
+    // Nothing is accounted for any more when engines are destroyed during static destruction
+    QGeoTileTextureAccounting *accounting = textureAccounting();
+    if (!accounting)
+        return;
+
+    QAbstractGeoTileCache *cache = tileCache();
+    const int total = accounting->setUsage(map, cache, textureUsage);
+    if (cache)
+        cache->setMinTextureUsage(total);
 }
 
 void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
@@ -132,51 +177,18 @@ void QGeoTiledMappingManagerEngine::updateTileRequests(QGeoTiledMap *map,
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
-    typedef QSet<QGeoTileSpec>::const_iterator tile_iter;
-
-    // add and remove tiles from tileset for this map
-
-    QSet<QGeoTileSpec> oldTiles = d->mapHash_.value(map);
-
-    tile_iter rem = tilesRemoved.constBegin();
-    tile_iter remEnd = tilesRemoved.constEnd();
-    for (; rem != remEnd; ++rem) {
-        oldTiles.remove(*rem);
-    }
-
-    tile_iter add = tilesAdded.constBegin();
-    tile_iter addEnd = tilesAdded.constEnd();
-    for (; add != addEnd; ++add) {
-        oldTiles.insert(*add);
-    }
-
-    d->mapHash_.insert(map, oldTiles);
-
-    // add and remove map from mapset for the tiles
-
     QSet<QGeoTileSpec> reqTiles;
     QSet<QGeoTileSpec> cancelTiles;
 
-    rem = tilesRemoved.constBegin();
-    for (; rem != remEnd; ++rem) {
-        QSet<QGeoTiledMap *> mapSet = d->tileHash_.value(*rem);
-        mapSet.remove(map);
-        if (mapSet.isEmpty()) {
-            cancelTiles.insert(*rem);
-            d->tileHash_.remove(*rem);
-        } else {
-            d->tileHash_.insert(*rem, mapSet);
-        }
+    // Tiles still wanted by a prefetch job are left to complete
+    for (const QGeoTileSpec &spec : tilesRemoved) {
+        if (d->subscriptions_.unsubscribe(spec, map) && !d->prefetchHash_.contains(spec))
+            cancelTiles.insert(spec);
     }
 
-    add = tilesAdded.constBegin();
-    for (; add != addEnd; ++add) {
-        QSet<QGeoTiledMap *> mapSet = d->tileHash_.value(*add);
-        if (mapSet.isEmpty()) {
-            reqTiles.insert(*add);
-        }
-        mapSet.insert(map);
-        d->tileHash_.insert(*add, mapSet);
+    for (const QGeoTileSpec &spec : tilesAdded) {
+        if (d->subscriptions_.subscribe(spec, map))
+            reqTiles.insert(spec);
     }
 
     cancelTiles -= reqTiles;
@@ -191,55 +203,89 @@ void QGeoTiledMappingManagerEngine::engineTileFinished(const QGeoTileSpec &spec,
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
-    QSet<QGeoTiledMap *> maps = d->tileHash_.value(spec);
-
-    typedef QSet<QGeoTiledMap *>::const_iterator map_iter;
+    const QGeoTileSubscriptions::Maps maps = d->subscriptions_.take(spec);
 
-    map_iter map = maps.constBegin();
-    map_iter mapEnd = maps.constEnd();
-    for (; map != mapEnd; ++map) {
-        QSet<QGeoTileSpec> tileSet = d->mapHash_.value(*map);
-        tileSet.remove(spec);
-        if (tileSet.isEmpty())
-            d->mapHash_.remove(*map);
+    // Prefetched tiles go to disk, and only to disk unless a map is waiting for them
+    const QSet<QGeoTilePrefetchJob *> jobs = d->prefetchHash_.take(spec);
+    QAbstractGeoTileCache::CacheAreas areas = d->cacheHint_;
+    if (!jobs.isEmpty()) {
+        if (maps.isEmpty())
+            areas = QAbstractGeoTileCache::DiskCache;
         else
-            d->mapHash_.insert(*map, tileSet);
+            areas |= QAbstractGeoTileCache::DiskCache;
     }
+    tileCache()->insert(spec, bytes, format, areas);
+    if (d->receivedFreshness_.contains(spec))
+        tileCache()->setFreshness(spec, d->receivedFreshness_.take(spec));
 
-    d->tileHash_.remove(spec);
-    tileCache()->insert(spec, bytes, format, d->cacheHint_);
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileFetched(spec);
 
-    map = maps.constBegin();
-    mapEnd = maps.constEnd();
-    for (; map != mapEnd; ++map) {
-        (*map)->requestManager()->tileFetched(spec);
-    }
+    for (QGeoTilePrefetchJob *job : jobs)
+        job->tileFinished(spec, true);
 }
 
 void QGeoTiledMappingManagerEngine::engineTileError(const QGeoTileSpec &spec, const QString &errorString)
 {
     Q_D(QGeoTiledMappingManagerEngine);
 
-    QSet<QGeoTiledMap *> maps = d->tileHash_.value(spec);
-    typedef QSet<QGeoTiledMap *>::const_iterator map_iter;
-    map_iter map = maps.constBegin();
-    map_iter mapEnd = maps.constEnd();
-    for (; map != mapEnd; ++map) {
-        QSet<QGeoTileSpec> tileSet = d->mapHash_.value(*map);
+    const QGeoTileSubscriptions::Maps maps = d->subscriptions_.take(spec);
+    d->receivedFreshness_.remove(spec);
 
-        tileSet.remove(spec);
-        if (tileSet.isEmpty())
-            d->mapHash_.remove(*map);
-        else
-            d->mapHash_.insert(*map, tileSet);
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileError(spec, errorString);
+
+    const QSet<QGeoTilePrefetchJob *> jobs = d->prefetchHash_.take(spec);
+    for (QGeoTilePrefetchJob *job : jobs)
+        job->tileFinished(spec, false);
+
+    emit tileError(spec, errorString);
+}
+
+/*
+    Handles the freshness the server sent for \a spec. Along with a new tile
+    it is kept until the tile is stored. When the server confirmed that the
+    cached tile is still current, only its freshness is updated and the tile
+    is handed out from the cache as if it had been downloaded. If the tile
+    left the cache in the meantime, it is requested again.
+*/
+void QGeoTiledMappingManagerEngine::engineTileFreshnessReceived(const QGeoTileSpec &spec,
+                                                                const QGeoTileFreshness &freshness,
+                                                                bool modified)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    if (modified) {
+        d->receivedFreshness_.insert(spec, freshness);
+        return;
     }
-    d->tileHash_.remove(spec);
 
-    for (map = maps.constBegin(); map != mapEnd; ++map) {
-        (*map)->requestManager()->tileError(spec, errorString);
+    if (!tileCache()->contains(spec, QAbstractGeoTileCache::AllCaches)) {
+        // Without a cached copy the request is no longer conditional
+        const QSet<QGeoTileSpec> tiles = QSet<QGeoTileSpec>() << spec;
+        if (d->subscriptions_.contains(spec)) {
+            QMetaObject::invokeMethod(d->fetcher_, "updateTileRequests",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QSet<QGeoTileSpec>, tiles),
+                                      Q_ARG(QSet<QGeoTileSpec>, QSet<QGeoTileSpec>()));
+        } else if (d->prefetchHash_.contains(spec)) {
+            QMetaObject::invokeMethod(d->fetcher_, "updateBackgroundTileRequests",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(QList<QGeoTileSpec>, tiles.toList()),
+                                      Q_ARG(QSet<QGeoTileSpec>, QSet<QGeoTileSpec>()));
+        }
+        return;
     }
 
-    emit tileError(spec, errorString);
+    tileCache()->setFreshness(spec, freshness);
+
+    const QGeoTileSubscriptions::Maps maps = d->subscriptions_.take(spec);
+    for (QGeoTiledMap *map : maps)
+        map->requestManager()->tileFetched(spec);
+
+    const QSet<QGeoTilePrefetchJob *> jobs = d->prefetchHash_.take(spec);
+    for (QGeoTilePrefetchJob *job : jobs)
+        job->tileFinished(spec, true);
 }
 
 void QGeoTiledMappingManagerEngine::setTileSize(const QSize &tileSize)
@@ -311,6 +357,120 @@ QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::getTileTexture(co
     return d_ptr->tileCache_->get(spec);
 }
 
+QSharedPointer<QGeoTileTexture> QGeoTiledMappingManagerEngine::getTileTextureFromMemory(const QGeoTileSpec &spec)
+{
+    return d_ptr->tileCache_->getFromMemory(spec);
+}
+
+QGeoTileFreshness QGeoTiledMappingManagerEngine::tileFreshness(const QGeoTileSpec &spec)
+{
+    return d_ptr->tileCache_->freshness(spec);
+}
+
+/*!
+    Starts downloading into the disk cache the tiles of \a mapId that cover
+    \a region, from \a minimumZoomLevel to \a maximumZoomLevel. At most
+    \a tileBudget tiles are downloaded, lower zoom levels first, unless
+    \a tileBudget is negative. Tiles are only fetched when no tile needed by a
+    map is waiting.
+
+    The caller takes ownership of the returned job. Deleting it cancels the
+    download.
+*/
+QGeoTilePrefetchJob *QGeoTiledMappingManagerEngine::prefetchRegion(const QGeoShape &region, int mapId,
+                                                                   int minimumZoomLevel, int maximumZoomLevel,
+                                                                   int tileBudget)
+{
+    const QGeoCameraCapabilities capabilities = cameraCapabilities(mapId);
+    if (capabilities.isValid()) {
+        minimumZoomLevel = qMax(minimumZoomLevel, int(std::ceil(capabilities.minimumZoomLevel())));
+        maximumZoomLevel = qMin(maximumZoomLevel, int(std::floor(capabilities.maximumZoomLevel())));
+    }
+
+    const QString plugin = managerName() + QLatin1Char('_') + QString::number(managerVersion());
+    QList<QGeoTileSpec> tiles;
+    bool truncated = false;
+    for (int zoom = minimumZoomLevel; zoom <= maximumZoomLevel && !truncated; ++zoom) {
+        const int budget = tileBudget < 0 ? -1 : tileBudget - tiles.size();
+        tiles += QGeoTilePrefetchJob::tilesForShape(region, plugin, mapId, zoom, tileVersion(),
+                                                   budget, &truncated);
+    }
+
+    QGeoTilePrefetchJob *job = new QGeoTilePrefetchJob(this, tiles, truncated);
+    d_ptr->prefetchJobs_.insert(job);
+    job->start();
+    return job;
+}
+
+/*!
+    Starts downloading \a tiles into the disk cache, typically the remaining
+    tiles of a job from a previous session.
+
+    The caller takes ownership of the returned job.
+*/
+QGeoTilePrefetchJob *QGeoTiledMappingManagerEngine::prefetchTiles(const QList<QGeoTileSpec> &tiles)
+{
+    // The tiles may come from another session, with other zoom limits
+    QList<QGeoTileSpec> available;
+    available.reserve(tiles.size());
+    for (const QGeoTileSpec &spec : tiles) {
+        const QGeoCameraCapabilities capabilities = cameraCapabilities(spec.mapId());
+        if (!capabilities.isValid()
+                || (spec.zoom() >= capabilities.minimumZoomLevel() && spec.zoom() <= capabilities.maximumZoomLevel())) {
+            available.append(spec);
+        }
+    }
+
+    QGeoTilePrefetchJob *job = new QGeoTilePrefetchJob(this, available, false);
+    d_ptr->prefetchJobs_.insert(job);
+    job->start();
+    return job;
+}
+
+void QGeoTiledMappingManagerEngine::updatePrefetchRequests(QGeoTilePrefetchJob *job,
+                                                           const QList<QGeoTileSpec> &tilesAdded,
+                                                           const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+
+    QList<QGeoTileSpec> reqTiles;
+    QSet<QGeoTileSpec> cancelTiles;
+
+    for (const QGeoTileSpec &spec : tilesRemoved) {
+        QSet<QGeoTilePrefetchJob *> jobs = d->prefetchHash_.value(spec);
+        jobs.remove(job);
+        if (jobs.isEmpty()) {
+            d->prefetchHash_.remove(spec);
+            if (!d->subscriptions_.contains(spec))
+                cancelTiles.insert(spec);
+        } else {
+            d->prefetchHash_.insert(spec, jobs);
+        }
+    }
+
+    for (const QGeoTileSpec &spec : tilesAdded) {
+        QSet<QGeoTilePrefetchJob *> &jobs = d->prefetchHash_[spec];
+        // Tiles already requested by a map or another job only need to be waited for
+        if (jobs.isEmpty() && !d->subscriptions_.contains(spec))
+            reqTiles.append(spec);
+        jobs.insert(job);
+    }
+
+    if (reqTiles.isEmpty() && cancelTiles.isEmpty())
+        return;
+
+    QMetaObject::invokeMethod(d->fetcher_, "updateBackgroundTileRequests",
+                              Qt::QueuedConnection,
+                              Q_ARG(QList<QGeoTileSpec>, reqTiles),
+                              Q_ARG(QSet<QGeoTileSpec>, cancelTiles));
+}
+
+void QGeoTiledMappingManagerEngine::releasePrefetchJob(QGeoTilePrefetchJob *job)
+{
+    Q_D(QGeoTiledMappingManagerEngine);
+    d->prefetchJobs_.remove(job);
+}
+
 /*******************************************************************************
 *******************************************************************************/
 
@@ -326,4 +486,69 @@ QGeoTiledMappingManagerEnginePrivate::~QGeoTiledMappingManagerEnginePrivate()
 {
 }
 
+/*
+    Adds \a map to the maps waiting for \a spec. Returns true if no map was
+    waiting for it before.
+*/
+bool QGeoTileSubscriptions::subscribe(const QGeoTileSpec &spec, QGeoTiledMap *map)
+{
+    Maps &maps = tiles_[spec];
+    for (QGeoTiledMap *m : qAsConst(maps)) {
+        if (m == map)
+            return false;
+    }
+    maps.append(map);
+    return maps.size() == 1;
+}
+
+/*
+    Removes \a map from the maps waiting for \a spec. Returns true if it was
+    the last one.
+*/
+bool QGeoTileSubscriptions::unsubscribe(const QGeoTileSpec &spec, QGeoTiledMap *map)
+{
+    QHash<QGeoTileSpec, Maps>::iterator it = tiles_.find(spec);
+    if (it == tiles_.end())
+        return false;
+
+    Maps &maps = *it;
+    for (int i = 0; i < maps.size(); ++i) {
+        if (maps.at(i) != map)
+            continue;
+        maps[i] = maps.last();
+        maps.removeLast();
+        if (!maps.isEmpty())
+            return false;
+        tiles_.erase(it);
+        return true;
+    }
+    return false;
+}
+
+/*
+    Forgets which maps wait for \a spec and returns them.
+*/
+QGeoTileSubscriptions::Maps QGeoTileSubscriptions::take(const QGeoTileSpec &spec)
+{
+    return tiles_.take(spec);
+}
+
+void QGeoTileSubscriptions::removeMap(QGeoTiledMap *map)
+{
+    for (QHash<QGeoTileSpec, Maps>::iterator it = tiles_.begin(); it != tiles_.end(); ) {
+        Maps &maps = *it;
+        for (int i = 0; i < maps.size(); ++i) {
+            if (maps.at(i) == map) {
+                maps[i] = maps.last();
+                maps.removeLast();
+                break;
+            }
+        }
+        if (maps.isEmpty())
+            it = tiles_.erase(it);
+        else
+            ++it;
+    }
+}
+
 QT_END_NAMESPACE
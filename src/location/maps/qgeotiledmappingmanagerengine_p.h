@@ -65,6 +65,8 @@ class QGeoTileFetcher;
 class QGeoTileTexture;
 class QGeoTileSpec;
 class QGeoTiledMap;
+class QGeoTilePrefetchJob;
+class QGeoShape;
 
 class Q_LOCATION_PRIVATE_EXPORT QGeoTiledMappingManagerEngine : public QGeoMappingManagerEngine
 {
@@ -78,6 +80,7 @@ public:
 
     QGeoMap *createMap() Q_DECL_OVERRIDE;
     void releaseMap(QGeoTiledMap *map);
+    void setMapTextureUsage(QGeoTiledMap *map, int textureUsage);
 
     QSize tileSize() const;
     int tileVersion() const;
@@ -88,13 +91,21 @@ public:
 
     QAbstractGeoTileCache *tileCache();
     QSharedPointer<QGeoTileTexture> getTileTexture(const QGeoTileSpec &spec);
+    QSharedPointer<QGeoTileTexture> getTileTextureFromMemory(const QGeoTileSpec &spec);
+    QGeoTileFreshness tileFreshness(const QGeoTileSpec &spec);
 
 
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
 
+    QGeoTilePrefetchJob *prefetchRegion(const QGeoShape &region, int mapId,
+                                        int minimumZoomLevel, int maximumZoomLevel,
+                                        int tileBudget = -1);
+    QGeoTilePrefetchJob *prefetchTiles(const QList<QGeoTileSpec> &tiles);
+
 private Q_SLOTS:
     void engineTileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
     void engineTileError(const QGeoTileSpec &spec, const QString &errorString);
+    void engineTileFreshnessReceived(const QGeoTileSpec &spec, const QGeoTileFreshness &freshness, bool modified);
 
 Q_SIGNALS:
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
@@ -109,12 +120,19 @@ protected:
 
     QGeoTiledMap::PrefetchStyle m_prefetchStyle;
 private:
+    void updatePrefetchRequests(QGeoTilePrefetchJob *job,
+                                const QList<QGeoTileSpec> &tilesAdded,
+                                const QSet<QGeoTileSpec> &tilesRemoved);
+    void releasePrefetchJob(QGeoTilePrefetchJob *job);
+
     QGeoTiledMappingManagerEnginePrivate *d_ptr;
 
     Q_DECLARE_PRIVATE(QGeoTiledMappingManagerEngine)
     Q_DISABLE_COPY(QGeoTiledMappingManagerEngine)
 
     friend class QGeoTileFetcher;
+    friend class QGeoTilePrefetchJob;
+    friend class QGeoTilePrefetchJobPrivate;
 };
 
 QT_END_NAMESPACE
@@ -52,6 +52,7 @@
 #include <QSize>
 #include <QHash>
 #include <QSet>
+#include <QVarLengthArray>
 #include "qgeotiledmappingmanagerengine_p.h"
 
 QT_BEGIN_NAMESPACE
@@ -60,6 +61,27 @@ class QGeoTiledMap;
 class QAbstractGeoTileCache;
 class QGeoTileSpec;
 class QGeoTileFetcher;
+class QGeoTilePrefetchJob;
+
+/* Which maps wait for which tiles. Most tiles are wanted by one or two maps,
+ * so the maps of a tile are kept inline, and the tiles of a map are not
+ * indexed at all: only releasing a map needs them. */
+class QGeoTileSubscriptions
+{
+public:
+    typedef QVarLengthArray<QGeoTiledMap *, 4> Maps;
+
+    bool subscribe(const QGeoTileSpec &spec, QGeoTiledMap *map);
+    bool unsubscribe(const QGeoTileSpec &spec, QGeoTiledMap *map);
+    Maps take(const QGeoTileSpec &spec);
+    void removeMap(QGeoTiledMap *map);
+
+    bool contains(const QGeoTileSpec &spec) const { return tiles_.contains(spec); }
+    int size() const { return tiles_.size(); }
+
+private:
+    QHash<QGeoTileSpec, Maps> tiles_;
+};
 
 class QGeoTiledMappingManagerEnginePrivate
 {
@@ -69,8 +91,10 @@ public:
 
     QSize tileSize_;
     int m_tileVersion;
-    QHash<QGeoTiledMap *, QSet<QGeoTileSpec> > mapHash_;
-    QHash<QGeoTileSpec, QSet<QGeoTiledMap *> > tileHash_;
+    QGeoTileSubscriptions subscriptions_;
+    QHash<QGeoTileSpec, QSet<QGeoTilePrefetchJob *> > prefetchHash_;
+    QSet<QGeoTilePrefetchJob *> prefetchJobs_;
+    QHash<QGeoTileSpec, QGeoTileFreshness> receivedFreshness_;
     QAbstractGeoTileCache::CacheAreas cacheHint_;
     QAbstractGeoTileCache *tileCache_;
     QGeoTileFetcher *fetcher_;
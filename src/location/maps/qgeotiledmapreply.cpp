@@ -233,6 +233,41 @@ void QGeoTiledMapReply::setMapImageFormat(const QString &format)
     d_ptr->mapImageFormat = format;
 }
 
+/*!
+    Returns the freshness information the service provider sent along with
+    the tile, used to decide when the cached tile has to be revalidated.
+*/
+QGeoTileFreshness QGeoTiledMapReply::freshness() const
+{
+    return d_ptr->freshness;
+}
+
+/*!
+    Sets the freshness information of the tile to \a freshness.
+*/
+void QGeoTiledMapReply::setFreshness(const QGeoTileFreshness &freshness)
+{
+    d_ptr->freshness = freshness;
+}
+
+/*!
+    Returns whether the service provider answered a conditional request by
+    confirming that the cached tile is still current. Such a reply carries
+    no image data.
+*/
+bool QGeoTiledMapReply::isNotModified() const
+{
+    return d_ptr->isNotModified;
+}
+
+/*!
+    Sets whether the cached tile was confirmed to be current to \a notModified.
+*/
+void QGeoTiledMapReply::setNotModified(bool notModified)
+{
+    d_ptr->isNotModified = notModified;
+}
+
 /*!
     Cancels the operation immediately.
 
@@ -304,13 +339,15 @@ QGeoTiledMapReplyPrivate::QGeoTiledMapReplyPrivate(const QGeoTileSpec &spec)
     : error(QGeoTiledMapReply::NoError),
       isFinished(false),
       isCached(false),
-      spec(spec) {}
+      spec(spec),
+      isNotModified(false) {}
 
 QGeoTiledMapReplyPrivate::QGeoTiledMapReplyPrivate(QGeoTiledMapReply::Error error, const QString &errorString)
     : error(error),
       errorString(errorString),
       isFinished(true),
-      isCached(false) {}
+      isCached(false),
+      isNotModified(false) {}
 
 QGeoTiledMapReplyPrivate::~QGeoTiledMapReplyPrivate() {}
 
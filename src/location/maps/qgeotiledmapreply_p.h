@@ -49,6 +49,7 @@
 //
 
 #include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qabstractgeotilecache_p.h>
 
 #include <QObject>
 
@@ -84,6 +85,9 @@ public:
     QByteArray mapImageData() const;
     QString mapImageFormat() const;
 
+    QGeoTileFreshness freshness() const;
+    bool isNotModified() const;
+
     virtual void abort();
 
 Q_SIGNALS:
@@ -100,6 +104,9 @@ protected:
     void setMapImageData(const QByteArray &data);
     void setMapImageFormat(const QString &format);
 
+    void setFreshness(const QGeoTileFreshness &freshness);
+    void setNotModified(bool notModified);
+
 private:
     QGeoTiledMapReplyPrivate *d_ptr;
     Q_DISABLE_COPY(QGeoTiledMapReply)
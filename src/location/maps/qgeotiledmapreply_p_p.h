@@ -68,6 +68,8 @@ public:
     QGeoTileSpec spec;
     QByteArray mapImageData;
     QString mapImageFormat;
+    QGeoTileFreshness freshness;
+    bool isNotModified;
 };
 
 QT_END_NAMESPACE
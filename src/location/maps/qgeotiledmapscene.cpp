@@ -38,13 +38,18 @@
 #include "qgeocameradata_p.h"
 #include "qabstractgeotilecache_p.h"
 #include "qgeotilespec_p.h"
+#include "qgeotileatlas_p.h"
 #include <QtPositioning/private/qdoublevector3d_p.h>
 #include <QtPositioning/private/qwebmercator_p.h>
 #include <QtCore/private/qobject_p.h>
 #include <QtQuick/QSGImageNode>
+#include <QtQuick/QSGOpacityNode>
+#include <QtQuick/QSGGeometryNode>
+#include <QtQuick/QSGTextureMaterial>
 #include <QtQuick/QQuickWindow>
 #include <QtQuick/private/qsgdefaultimagenode_p.h>
 #include <QtGui/QVector3D>
+#include <QtCore/QElapsedTimer>
 #include <cmath>
 #include <QtPositioning/private/qlocationutils_p.h>
 #include <QtPositioning/private/qdoublematrix4x4_p.h>
@@ -89,6 +94,7 @@ public:
 
     QHash<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > m_textures;
     QVector<QGeoTileSpec> m_updatedTextures;
+    QSet<QGeoTileSpec> m_fadingTiles; // updated tiles that replace a stand-in texture
 
     // tilesToGrid transform
     int m_minTileX; // the minimum tile index, i.e. 0 to sideLength which is 1<< zoomLevel
@@ -102,10 +108,13 @@ public:
     bool m_dropTextures;
 
     void addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
+    bool addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
 
     void setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles);
     void removeTiles(const QSet<QGeoTileSpec> &oldTiles);
-    bool buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming);
+    bool tileGeometry(const QGeoTileSpec &spec, const QRectF &textureRect,
+                      QRectF &rect, QRectF &sourceRect, bool &overzooming) const;
+    bool buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, const QRectF &textureRect, bool &overzooming);
     void updateTileBounds(const QSet<QGeoTileSpec> &tiles);
     void setupCamera();
     inline bool isTiltedOrRotated() { return (m_cameraData.tilt() > 0.0) || (m_cameraData.bearing() > 0.0); }
@@ -171,6 +180,16 @@ void QGeoTiledMapScene::addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTil
     d->addTile(spec, texture);
 }
 
+/*
+    Adds a texture standing in for the tile \a spec, unless the scene already has a texture
+    for it. Returns true if the texture was added.
+*/
+bool QGeoTiledMapScene::addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
+{
+    Q_D(QGeoTiledMapScene);
+    return d->addFallbackTile(spec, texture);
+}
+
 QSet<QGeoTileSpec> QGeoTiledMapScene::texturedTiles()
 {
     Q_D(QGeoTiledMapScene);
@@ -185,6 +204,7 @@ void QGeoTiledMapScene::clearTexturedTiles()
 {
     Q_D(QGeoTiledMapScene);
     d->m_textures.clear();
+    d->m_fadingTiles.clear();
     d->m_dropTextures = true;
 }
 
@@ -208,7 +228,13 @@ QGeoTiledMapScenePrivate::~QGeoTiledMapScenePrivate()
 {
 }
 
-bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode, bool &overzooming)
+/*
+    Computes where the tile spec goes, and which part of textureRect, the area of a texture
+    holding the image of the tile, is mapped onto it. Returns false if the tile is not part
+    of the scene.
+*/
+bool QGeoTiledMapScenePrivate::tileGeometry(const QGeoTileSpec &spec, const QRectF &textureRect,
+                                            QRectF &rect, QRectF &sourceRect, bool &overzooming) const
 {
     overzooming = false;
     int x = spec.x();
@@ -237,41 +263,70 @@ bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageN
     y1 *= edge;
     y2 *= edge;
 
-    imageNode->setRect(QRectF(QPointF(x1, y2), QPointF(x2, y1)));
-    imageNode->setTextureCoordinatesTransform(QSGImageNode::MirrorVertically);
+    rect = QRectF(QPointF(x1, y2), QPointF(x2, y1));
 
     // Calculate the texture mapping, in case we are magnifying some lower ZL tile
-    const auto it = m_textures.find(spec); // This should be always found, but apparently sometimes it isn't, possibly due to memory shortage
-    if (it != m_textures.end()) {
+    const auto it = m_textures.constFind(spec); // This should be always found, but apparently sometimes it isn't, possibly due to memory shortage
+    if (it != m_textures.constEnd()) {
         if (it.value()->spec.zoom() < spec.zoom()) {
             // Currently only using lower ZL tiles for the overzoom.
             const int tilesPerTexture = 1 << (spec.zoom() - it.value()->spec.zoom());
-            const int mappedSize = imageNode->texture()->textureSize().width() / tilesPerTexture;
+            const int mappedSize = int(textureRect.width()) / tilesPerTexture;
             const int x = (spec.x() % tilesPerTexture) * mappedSize;
             const int y = (spec.y() % tilesPerTexture) * mappedSize;
-            imageNode->setSourceRect(QRectF(x, y, mappedSize, mappedSize));
+            sourceRect = QRectF(textureRect.x() + x, textureRect.y() + y, mappedSize, mappedSize);
             overzooming = true;
         } else {
-            imageNode->setSourceRect(QRectF(QPointF(0,0), imageNode->texture()->textureSize()));
+            sourceRect = textureRect;
         }
     } else {
         qWarning() << "!! buildGeometry: tileSpec not present in m_textures !!";
-        imageNode->setSourceRect(QRectF(QPointF(0,0), imageNode->texture()->textureSize()));
+        sourceRect = textureRect;
     }
 
     return true;
 }
 
+bool QGeoTiledMapScenePrivate::buildGeometry(const QGeoTileSpec &spec, QSGImageNode *imageNode,
+                                             const QRectF &textureRect, bool &overzooming)
+{
+    QRectF rect;
+    QRectF sourceRect;
+    if (!tileGeometry(spec, textureRect, rect, sourceRect, overzooming))
+        return false;
+
+    imageNode->setRect(rect);
+    imageNode->setTextureCoordinatesTransform(QSGImageNode::MirrorVertically);
+    imageNode->setSourceRect(sourceRect);
+    return true;
+}
+
 void QGeoTiledMapScenePrivate::addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
 {
     if (!m_visibleTiles.contains(spec)) // Don't add the geometry if it isn't visible
         return;
 
-    if (m_textures.contains(spec))
+    const auto it = m_textures.constFind(spec);
+    if (it != m_textures.constEnd()) {
+        if (it.value() == texture) // e.g. a revalidated tile, nothing to upload
+            return;
         m_updatedTextures.append(spec);
+        // Blend in the proper tile over the texture that was used in its place
+        if (it.value()->spec != spec && texture->spec == spec)
+            m_fadingTiles.insert(spec);
+    }
     m_textures.insert(spec, texture);
 }
 
+bool QGeoTiledMapScenePrivate::addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture)
+{
+    if (!m_visibleTiles.contains(spec) || m_textures.contains(spec))
+        return false;
+
+    m_textures.insert(spec, texture);
+    return true;
+}
+
 void QGeoTiledMapScenePrivate::setVisibleTiles(const QSet<QGeoTileSpec> &visibleTiles)
 {
     // work out the tile bounds for the new scene
@@ -469,15 +524,197 @@ void QGeoTiledMapScenePrivate::setupCamera()
     m_projectionMatrix.frustum(-halfWidth, halfWidth, -halfHeight, halfHeight, nearPlane, farPlane);
 }
 
+// Fades in the tile node it contains over the node that used to be shown in its place.
+// The opacity is advanced in preprocess(), so that the fade does not need the map item
+// to be updated on every frame.
+class QGeoTiledMapTileFadeNode : public QSGOpacityNode
+{
+public:
+    enum { FadeDuration = 250 }; // ms
+
+    QGeoTiledMapTileFadeNode(QQuickWindow *window, QSGImageNode *previousNode)
+        : previous(previousNode)
+        , m_window(window)
+    {
+        setFlag(QSGNode::UsePreprocess);
+        setOpacity(0.0);
+        m_timer.start();
+    }
+
+    void preprocess() Q_DECL_OVERRIDE
+    {
+        const qreal progress = qMin<qreal>(1.0, m_timer.elapsed() / qreal(FadeDuration));
+        setOpacity(progress);
+        if (progress < 1.0)
+            m_window->update();
+    }
+
+    bool isFinished() const
+    {
+        return m_timer.elapsed() >= FadeDuration;
+    }
+
+    QSGImageNode *previous; // sibling of the fade node, drawn underneath it
+
+private:
+    QQuickWindow *m_window;
+    QElapsedTimer m_timer;
+};
+
+// A tile drawn from the tile atlas
+struct QGeoTiledMapBatchedTile
+{
+    QGeoTileAtlasAllocator::Slot slot;
+    QRectF sourceRect; // the area of the atlas page last drawn for the tile
+};
+
 class QGeoTiledMapTileContainerNode : public QSGTransformNode
 {
 public:
     void addChild(const QGeoTileSpec &spec, QSGImageNode *node)
     {
         tiles.insert(spec, node);
-        appendChildNode(node);
+        if (QGeoTiledMapTileFadeNode *fade = fades.value(spec))
+            fade->appendChildNode(node);
+        else
+            appendChildNode(node);
+    }
+
+    void removeChild(const QGeoTileSpec &spec)
+    {
+        delete tiles.take(spec);
+        removeFade(spec);
+    }
+
+    // Keeps the node currently showing spec on screen until its replacement has faded in.
+    // Tiles drawn from the atlas have no node of their own, the caller passes one instead.
+    void startFade(const QGeoTileSpec &spec, QQuickWindow *window, QSGImageNode *previous = 0)
+    {
+        if (!previous)
+            previous = tiles.take(spec);
+        if (previous && !previous->parent()) {
+            appendChildNode(previous);
+        } else if (previous && previous->parent() != this) {
+            previous->parent()->removeChildNode(previous);
+            appendChildNode(previous);
+        }
+        removeFade(spec);
+        if (!previous)
+            return;
+
+        QGeoTiledMapTileFadeNode *fade = new QGeoTiledMapTileFadeNode(window, previous);
+        fades.insert(spec, fade);
+        appendChildNode(fade);
+    }
+
+    // Deletes the fade node of spec together with the node it was fading out.
+    // The faded in node must have been taken out of the fade node beforehand.
+    void removeFade(const QGeoTileSpec &spec)
+    {
+        QGeoTiledMapTileFadeNode *fade = fades.take(spec);
+        if (!fade)
+            return;
+        delete fade->previous;
+        delete fade;
+    }
+
+    // Ends the finished fades. Tiles drawn from the atlas go back to it.
+    void updateFades(const QHash<QGeoTileSpec, QGeoTiledMapBatchedTile> &batchedTiles)
+    {
+        const QList<QGeoTileSpec> specs = fades.keys();
+        for (const QGeoTileSpec &spec : specs) {
+            QGeoTiledMapTileFadeNode *fade = fades.value(spec);
+            QSGImageNode *node = tiles.value(spec);
+            if (node && !fade->isFinished()) {
+                fade->previous->setRect(node->rect());
+                continue;
+            }
+            if (batchedTiles.contains(spec)) {
+                delete tiles.take(spec);
+            } else if (node) {
+                fade->removeChildNode(node);
+                appendChildNode(node);
+            }
+            removeFade(spec);
+        }
     }
+
     QHash<QGeoTileSpec, QSGImageNode *> tiles;
+    QHash<QGeoTileSpec, QGeoTiledMapTileFadeNode *> fades;
+};
+
+// The tiles stored in one atlas page. A single geometry holds them all, drawn by one node
+// in each of the tile containers, so that the wrapped around copies only differ in the
+// transformation of their container.
+class QGeoTiledMapAtlasLayer
+{
+public:
+    explicit QGeoTiledMapAtlasLayer(QSGTexture *texture)
+        : geometry(QSGGeometry::defaultAttributes_TexturedPoint2D(), 0, 0, QSGGeometry::UnsignedShortType)
+        , hasOverzoom(false)
+    {
+        geometry.setDrawingMode(QSGGeometry::DrawTriangles);
+        setTexture(texture);
+        for (int i = 0; i < 3; ++i) {
+            nodes[i] = new QSGGeometryNode();
+            nodes[i]->setGeometry(&geometry);
+            nodes[i]->setMaterial(&material);
+            nodes[i]->setOpaqueMaterial(&opaqueMaterial);
+            attached[i] = false;
+        }
+    }
+
+    ~QGeoTiledMapAtlasLayer()
+    {
+        // The nodes refer to the geometry and materials, so they have to go first
+        for (QSGGeometryNode *node : nodes)
+            delete node;
+    }
+
+    void setTexture(QSGTexture *texture)
+    {
+        const bool blending = texture->hasAlphaChannel();
+        if (material.texture() == texture && bool(material.flags() & QSGMaterial::Blending) == blending)
+            return;
+        material.setTexture(texture);
+        opaqueMaterial.setTexture(texture);
+        material.setFlag(QSGMaterial::Blending, blending);
+        opaqueMaterial.setFlag(QSGMaterial::Blending, blending);
+        markDirty(QSGNode::DirtyMaterial);
+    }
+
+    void setFiltering(QSGTexture::Filtering filtering)
+    {
+        if (material.filtering() == filtering)
+            return;
+        material.setFiltering(filtering);
+        opaqueMaterial.setFiltering(filtering);
+        markDirty(QSGNode::DirtyMaterial);
+    }
+
+    void setAttached(int copy, QSGNode *container, bool attach)
+    {
+        if (attach == attached[copy])
+            return;
+        if (attach)
+            container->prependChildNode(nodes[copy]); // underneath the tiles that have a node of their own
+        else
+            container->removeChildNode(nodes[copy]);
+        attached[copy] = attach;
+    }
+
+    void markDirty(QSGNode::DirtyState bits)
+    {
+        for (QSGGeometryNode *node : nodes)
+            node->markDirty(bits);
+    }
+
+    QSGGeometry geometry;
+    QSGTextureMaterial material;
+    QSGOpaqueTextureMaterial opaqueMaterial;
+    QSGGeometryNode *nodes[3];
+    bool attached[3];
+    bool hasOverzoom;
 };
 
 class QGeoTiledMapRootNode : public QSGClipNode
@@ -490,7 +727,11 @@ public:
         , tiles(new QGeoTiledMapTileContainerNode())
         , wrapLeft(new QGeoTiledMapTileContainerNode())
         , wrapRight(new QGeoTiledMapTileContainerNode())
+        , atlas(0)
+        , layersDirty(false)
     {
+        for (int i = 0; i < 3; ++i)
+            layersVisible[i] = false;
         setIsRectangular(true);
         setGeometry(&geometry);
         root->appendChildNode(tiles);
@@ -501,7 +742,10 @@ public:
 
     ~QGeoTiledMapRootNode()
     {
+        qDeleteAll(layers);
+        delete atlas;
         qDeleteAll(textures);
+        qDeleteAll(fadingTextures);
     }
 
     void setClipRect(const QRect &rect)
@@ -520,6 +764,14 @@ public:
                      QQuickWindow *window,
                      bool ogl);
 
+    QRectF textureRect(const QGeoTileSpec &spec, QSGImageNode *node) const;
+    bool insertBatchedTile(const QGeoTileSpec &spec, const QImage &image);
+    void releaseBatchedTile(const QGeoTileSpec &spec);
+    void fadeBatchedTile(const QGeoTileSpec &spec, QQuickWindow *window);
+    void dropBatchedTiles();
+    void updateLayers(QGeoTiledMapScenePrivate *d, QQuickWindow *window);
+    void rebuildLayers(QGeoTiledMapScenePrivate *d);
+
     bool isTextureLinear;
 
     QSGGeometry geometry;
@@ -532,6 +784,18 @@ public:
     QGeoTiledMapTileContainerNode *wrapRight;    // When zoomed out, the tiles that wrap around on the right
 
     QHash<QGeoTileSpec, QSGTexture *> textures;
+    QHash<QGeoTileSpec, QSGTexture *> fadingTextures; // used by the nodes being faded out
+
+    // Tiles are drawn from an atlas when rendering with OpenGL. The others, and atlas tiles
+    // while they fade in, get a node and a texture of their own.
+    QGeoTileAtlas *atlas;
+    QHash<QGeoTileSpec, QGeoTiledMapBatchedTile> batchedTiles;
+    QHash<QGeoTileSpec, QGeoTileAtlasAllocator::Slot> fadingSlots; // used by the nodes being faded out
+    QVector<QGeoTiledMapAtlasLayer *> layers; // one per atlas page
+    QVector<int> layersLayout; // the scene parameters the layers were built for
+    QRectF layersBounds;
+    bool layersVisible[3]; // in tiles, wrapLeft and wrapRight
+    bool layersDirty;
 };
 
 static bool qgeotiledmapscene_isTileInViewport_Straight(const QRectF &tileRect, const QMatrix4x4 &matrix)
@@ -578,29 +842,40 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
     cameraMatrix.lookAt(toVector3D(eye), toVector3D(center), toVector3D(d->m_cameraUp));
     root->setMatrix(d->m_projectionMatrix * cameraMatrix);
 
+    // Atlas tiles are drawn by the layers, unless they are fading in
+    const int fadeCount = root->fades.size();
+    QSet<QGeoTileSpec> nodeTiles;
+    for (const QGeoTileSpec &s : d->m_visibleTiles) {
+        if (!batchedTiles.contains(s) || root->fades.contains(s))
+            nodeTiles.insert(s);
+    }
+
     const QSet<QGeoTileSpec> tilesInSG = QSet<QGeoTileSpec>::fromList(root->tiles.keys());
-    const QSet<QGeoTileSpec> toRemove = tilesInSG - d->m_visibleTiles;
-    const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - tilesInSG;
+    const QSet<QGeoTileSpec> toRemove = tilesInSG - nodeTiles;
+    const QSet<QGeoTileSpec> toAdd = nodeTiles - tilesInSG;
 
     for (const QGeoTileSpec &s : toRemove)
-        delete root->tiles.take(s);
+        root->removeChild(s);
     bool straight = !d->isTiltedOrRotated();
     bool overzooming;
     qreal pixelRatio = window->effectiveDevicePixelRatio();
     for (QHash<QGeoTileSpec, QSGImageNode *>::iterator it = root->tiles.begin();
          it != root->tiles.end(); ) {
         QSGImageNode *node = it.value();
-        bool ok = d->buildGeometry(it.key(), node, overzooming)
+        const QRectF nodeTextureRect = textureRect(it.key(), node);
+        bool ok = d->buildGeometry(it.key(), node, nodeTextureRect, overzooming)
                 && qgeotiledmapscene_isTileInViewport(node->rect(), root->matrix(), straight);
 
         QSGNode::DirtyState dirtyBits = 0;
 
         if (!ok) {
+            const QGeoTileSpec spec = it.key();
             it = root->tiles.erase(it);
             delete node;
+            root->removeFade(spec);
         } else {
             if (isTextureLinear != d->m_linearScaling) {
-                if (node->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
+                if (nodeTextureRect.width() > d->m_tileSize * pixelRatio) {
                     node->setFiltering(QSGTexture::Linear); // With mipmapping QSGTexture::Nearest generates artifacts
                     node->setMipmapFiltering(QSGTexture::Linear);
                 } else {
@@ -624,12 +899,18 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
         QGeoTileTexture *tileTexture = d->m_textures.value(s).data();
         if (!tileTexture || tileTexture->image.isNull())
             continue;
+        QSGTexture *texture = textures.value(s);
+        if (!texture && batchedTiles.contains(s))
+            texture = atlas->page(batchedTiles.value(s).slot.page);
+        if (!texture)
+            continue;
         QSGImageNode *tileNode = window->createImageNode();
         // note: setTexture will update coordinates so do it here, before we buildGeometry
-        tileNode->setTexture(textures.value(s));
-        if (d->buildGeometry(s, tileNode, overzooming)
+        tileNode->setTexture(texture);
+        const QRectF nodeTextureRect = textureRect(s, tileNode);
+        if (d->buildGeometry(s, tileNode, nodeTextureRect, overzooming)
                 && qgeotiledmapscene_isTileInViewport(tileNode->rect(), root->matrix(), straight)) {
-            if (tileNode->texture()->textureSize().width() > d->m_tileSize * pixelRatio) {
+            if (nodeTextureRect.width() > d->m_tileSize * pixelRatio) {
                 tileNode->setFiltering(QSGTexture::Linear); // with mipmapping QSGTexture::Nearest generates artifacts
                 tileNode->setMipmapFiltering(QSGTexture::Linear);
             } else {
@@ -644,6 +925,202 @@ void QGeoTiledMapRootNode::updateTiles(QGeoTiledMapTileContainerNode *root,
             delete tileNode;
         }
     }
+
+    root->updateFades(batchedTiles);
+    if (root->fades.size() != fadeCount) // the tiles that faded in are drawn by the layers again
+        layersDirty = true;
+}
+
+QRectF QGeoTiledMapRootNode::textureRect(const QGeoTileSpec &spec, QSGImageNode *node) const
+{
+    const auto it = batchedTiles.constFind(spec);
+    if (it != batchedTiles.constEnd() && node->texture() == atlas->page(it->slot.page))
+        return atlas->slotRect(it->slot);
+    return QRectF(QPointF(0, 0), node->texture()->textureSize());
+}
+
+/*
+    Copies the image of spec into the atlas. Returns false if it cannot be drawn
+    from the atlas, leaving it to a texture of its own.
+*/
+bool QGeoTiledMapRootNode::insertBatchedTile(const QGeoTileSpec &spec, const QImage &image)
+{
+    if (atlas && atlas->slotSize() != image.size() && atlas->isEmpty() && fadingSlots.isEmpty()) {
+        // The tiles changed size, e.g. with the map type
+        qDeleteAll(layers);
+        layers.clear();
+        delete atlas;
+        atlas = 0;
+    }
+    if (!atlas) {
+        if (!QGeoTileAtlas::isSupported(image.size()))
+            return false;
+        atlas = new QGeoTileAtlas(image.size());
+    }
+
+    QGeoTiledMapBatchedTile tile;
+    tile.slot = atlas->insert(image);
+    if (!tile.slot.isValid())
+        return false;
+
+    batchedTiles.insert(spec, tile);
+    layersDirty = true;
+    return true;
+}
+
+void QGeoTiledMapRootNode::releaseBatchedTile(const QGeoTileSpec &spec)
+{
+    const auto it = batchedTiles.find(spec);
+    if (it == batchedTiles.end())
+        return;
+    atlas->release(it->slot);
+    batchedTiles.erase(it);
+    layersDirty = true;
+}
+
+/*
+    Takes spec out of the atlas layers, and shows its current image in a node of its
+    own until the new one has faded in over it.
+*/
+void QGeoTiledMapRootNode::fadeBatchedTile(const QGeoTileSpec &spec, QQuickWindow *window)
+{
+    const QGeoTiledMapBatchedTile tile = batchedTiles.take(spec);
+    if (fadingSlots.contains(spec))
+        atlas->release(fadingSlots.take(spec)); // its node goes away with the fade it belongs to
+    fadingSlots.insert(spec, tile.slot);
+
+    const QRectF sourceRect = tile.sourceRect.isEmpty() ? atlas->slotRect(tile.slot) : tile.sourceRect;
+    QGeoTiledMapTileContainerNode *containers[3] = { tiles, wrapLeft, wrapRight };
+    for (int i = 0; i < 3; ++i) {
+        QGeoTiledMapTileContainerNode *container = containers[i];
+        if (container->tiles.contains(spec) || !layersVisible[i]) {
+            container->startFade(spec, window);
+            continue;
+        }
+        QSGImageNode *previous = window->createImageNode();
+        previous->setTexture(atlas->page(tile.slot.page));
+        previous->setSourceRect(sourceRect);
+        previous->setTextureCoordinatesTransform(QSGImageNode::MirrorVertically);
+        previous->setFiltering(QSGTexture::Linear);
+        container->startFade(spec, window, previous);
+    }
+    layersDirty = true;
+}
+
+void QGeoTiledMapRootNode::dropBatchedTiles()
+{
+    qDeleteAll(layers);
+    layers.clear();
+    for (int i = 0; i < 3; ++i)
+        layersVisible[i] = false;
+    batchedTiles.clear();
+    fadingSlots.clear();
+    delete atlas;
+    atlas = 0;
+    layersDirty = true;
+}
+
+/*
+    Rebuilds the atlas layers when the tiles or the scene changed, and shows the wrapped
+    around copies of them that are on screen.
+*/
+void QGeoTiledMapRootNode::updateLayers(QGeoTiledMapScenePrivate *d, QQuickWindow *window)
+{
+    const QVector<int> layout = { d->m_intZoomLevel, d->m_tileSize, d->m_tileXWrapsBelow,
+                                  d->m_minTileX, d->m_minTileY, d->m_maxTileX, d->m_maxTileY };
+    if (layout != layersLayout) {
+        layersLayout = layout;
+        layersDirty = true;
+    }
+    if (layersDirty) {
+        rebuildLayers(d);
+        layersDirty = false;
+    }
+
+    const qreal pixelRatio = window->effectiveDevicePixelRatio();
+    for (QGeoTiledMapAtlasLayer *layer : qAsConst(layers)) {
+        const bool linear = d->m_linearScaling || layer->hasOverzoom
+                || atlas->slotSize().width() > d->m_tileSize * pixelRatio;
+        layer->setFiltering(linear ? QSGTexture::Linear : QSGTexture::Nearest);
+    }
+
+    const bool straight = !d->isTiltedOrRotated();
+    QGeoTiledMapTileContainerNode *containers[3] = { tiles, wrapLeft, wrapRight };
+    for (int i = 0; i < 3; ++i) {
+        layersVisible[i] = !layersBounds.isEmpty()
+                && (i == 0 || qgeotiledmapscene_isTileInViewport(layersBounds, containers[i]->matrix(), straight));
+        for (QGeoTiledMapAtlasLayer *layer : qAsConst(layers))
+            layer->setAttached(i, containers[i], layersVisible[i]);
+    }
+}
+
+void QGeoTiledMapRootNode::rebuildLayers(QGeoTiledMapScenePrivate *d)
+{
+    const int pageCount = atlas ? atlas->pageCount() : 0;
+    while (layers.size() > pageCount)
+        delete layers.takeLast();
+    while (layers.size() < pageCount)
+        layers.append(new QGeoTiledMapAtlasLayer(atlas->page(layers.size())));
+
+    struct Quad
+    {
+        QRectF rect;
+        QRectF sourceRect;
+    };
+    QVector<QVector<Quad> > quads(pageCount);
+    QVector<bool> overzoom(pageCount, false);
+    layersBounds = QRectF();
+
+    for (auto it = batchedTiles.begin(); it != batchedTiles.end(); ++it) {
+        Quad quad;
+        bool overzooming;
+        if (!d->tileGeometry(it.key(), atlas->slotRect(it->slot), quad.rect, quad.sourceRect, overzooming)) {
+            it->sourceRect = QRectF();
+            continue;
+        }
+        it->sourceRect = quad.sourceRect;
+        if (tiles->fades.contains(it.key())) // drawn by a node of its own for now
+            continue;
+        quads[it->slot.page].append(quad);
+        overzoom[it->slot.page] = overzoom.at(it->slot.page) || overzooming;
+        layersBounds |= quad.rect;
+    }
+
+    for (int page = 0; page < pageCount; ++page) {
+        QGeoTiledMapAtlasLayer *layer = layers.at(page);
+        QSGTexture *texture = atlas->page(page);
+        layer->setTexture(texture);
+        layer->hasOverzoom = overzoom.at(page);
+
+        const QVector<Quad> &pageQuads = quads.at(page);
+        layer->geometry.allocate(4 * pageQuads.size(), 6 * pageQuads.size());
+        QSGGeometry::TexturedPoint2D *vertices = layer->geometry.vertexDataAsTexturedPoint2D();
+        quint16 *indices = layer->geometry.indexDataAsUShort();
+        const QSizeF pageSize = texture->textureSize();
+        for (int i = 0; i < pageQuads.size(); ++i) {
+            const QRectF &r = pageQuads.at(i).rect;
+            const QRectF &s = pageQuads.at(i).sourceRect;
+            const float u1 = s.left() / pageSize.width();
+            const float u2 = s.right() / pageSize.width();
+            const float v1 = s.top() / pageSize.height();
+            const float v2 = s.bottom() / pageSize.height();
+
+            // y grows northwards in the scene, so the top of the image goes to the bottom of the rect
+            vertices[4 * i + 0].set(r.left(), r.bottom(), u1, v1);
+            vertices[4 * i + 1].set(r.left(), r.top(), u1, v2);
+            vertices[4 * i + 2].set(r.right(), r.bottom(), u2, v1);
+            vertices[4 * i + 3].set(r.right(), r.top(), u2, v2);
+
+            const quint16 first = quint16(4 * i);
+            indices[6 * i + 0] = first;
+            indices[6 * i + 1] = first + 1;
+            indices[6 * i + 2] = first + 2;
+            indices[6 * i + 3] = first + 2;
+            indices[6 * i + 4] = first + 1;
+            indices[6 * i + 5] = first + 3;
+        }
+        layer->markDirty(QSGNode::DirtyGeometry);
+    }
 }
 
 QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
@@ -671,14 +1148,17 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     mapRoot->root->setMatrix(itemSpaceMatrix);
 
     if (d->m_dropTextures) {
-        for (const QGeoTileSpec &s : mapRoot->tiles->tiles.keys())
-            delete mapRoot->tiles->tiles.take(s);
-        for (const QGeoTileSpec &s : mapRoot->wrapLeft->tiles.keys())
-            delete mapRoot->wrapLeft->tiles.take(s);
-        for (const QGeoTileSpec &s : mapRoot->wrapRight->tiles.keys())
-            delete mapRoot->wrapRight->tiles.take(s);
+        for (const QGeoTileSpec &s : mapRoot->tiles->tiles.keys() + mapRoot->tiles->fades.keys())
+            mapRoot->tiles->removeChild(s);
+        for (const QGeoTileSpec &s : mapRoot->wrapLeft->tiles.keys() + mapRoot->wrapLeft->fades.keys())
+            mapRoot->wrapLeft->removeChild(s);
+        for (const QGeoTileSpec &s : mapRoot->wrapRight->tiles.keys() + mapRoot->wrapRight->fades.keys())
+            mapRoot->wrapRight->removeChild(s);
         for (const QGeoTileSpec &spec : mapRoot->textures.keys())
             mapRoot->textures.take(spec)->deleteLater();
+        for (const QGeoTileSpec &spec : mapRoot->fadingTextures.keys())
+            mapRoot->fadingTextures.take(spec)->deleteLater();
+        mapRoot->dropBatchedTiles();
         d->m_dropTextures = false;
     }
 
@@ -686,31 +1166,50 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     if (d->m_updatedTextures.size()) {
         const QVector<QGeoTileSpec> &toRemove = d->m_updatedTextures;
         for (const QGeoTileSpec &s : toRemove) {
-            if (mapRoot->tiles->tiles.contains(s))
-                delete mapRoot->tiles->tiles.take(s);
-
-            if (mapRoot->wrapLeft->tiles.contains(s))
-                delete mapRoot->wrapLeft->tiles.take(s);
+            if (d->m_fadingTiles.contains(s) && mapRoot->batchedTiles.contains(s)) {
+                mapRoot->fadeBatchedTile(s, window);
+                continue;
+            }
+            if (d->m_fadingTiles.contains(s)) {
+                mapRoot->tiles->startFade(s, window);
+                mapRoot->wrapLeft->startFade(s, window);
+                mapRoot->wrapRight->startFade(s, window);
+                if (mapRoot->fadingTextures.contains(s))
+                    mapRoot->fadingTextures.take(s)->deleteLater();
+                if (mapRoot->textures.contains(s))
+                    mapRoot->fadingTextures.insert(s, mapRoot->textures.take(s));
+                continue;
+            }
 
-            if (mapRoot->wrapRight->tiles.contains(s))
-                delete mapRoot->wrapRight->tiles.take(s);
+            mapRoot->tiles->removeChild(s);
+            mapRoot->wrapLeft->removeChild(s);
+            mapRoot->wrapRight->removeChild(s);
 
             if (mapRoot->textures.contains(s))
                 mapRoot->textures.take(s)->deleteLater();
+            mapRoot->releaseBatchedTile(s);
         }
         d->m_updatedTextures.clear();
+        d->m_fadingTiles.clear();
     }
 
-    const QSet<QGeoTileSpec> textures = QSet<QGeoTileSpec>::fromList(mapRoot->textures.keys());
+    const QSet<QGeoTileSpec> textures = QSet<QGeoTileSpec>::fromList(mapRoot->textures.keys())
+            + QSet<QGeoTileSpec>::fromList(mapRoot->batchedTiles.keys());
     const QSet<QGeoTileSpec> toRemove = textures - d->m_visibleTiles;
     const QSet<QGeoTileSpec> toAdd = d->m_visibleTiles - textures;
 
-    for (const QGeoTileSpec &spec : toRemove)
-        mapRoot->textures.take(spec)->deleteLater();
+    for (const QGeoTileSpec &spec : toRemove) {
+        if (mapRoot->textures.contains(spec))
+            mapRoot->textures.take(spec)->deleteLater();
+        else
+            mapRoot->releaseBatchedTile(spec);
+    }
     for (const QGeoTileSpec &spec : toAdd) {
         QGeoTileTexture *tileTexture = d->m_textures.value(spec).data();
         if (!tileTexture || tileTexture->image.isNull())
             continue;
+        if (isOpenGL && mapRoot->insertBatchedTile(spec, tileTexture->image))
+            continue;
         mapRoot->textures.insert(spec, window->createTextureFromImage(tileTexture->image));
     }
 
@@ -719,6 +1218,31 @@ QSGNode *QGeoTiledMapScene::updateSceneGraph(QSGNode *oldNode, QQuickWindow *win
     mapRoot->updateTiles(mapRoot->wrapLeft, d, +sideLength, window, isOpenGL);
     mapRoot->updateTiles(mapRoot->wrapRight, d, -sideLength, window, isOpenGL);
 
+    // Release the textures of the stand-in tiles once they are no longer on screen
+    for (auto it = mapRoot->fadingTextures.begin(); it != mapRoot->fadingTextures.end(); ) {
+        if (mapRoot->tiles->fades.contains(it.key())
+                || mapRoot->wrapLeft->fades.contains(it.key())
+                || mapRoot->wrapRight->fades.contains(it.key())) {
+            ++it;
+        } else {
+            it.value()->deleteLater();
+            it = mapRoot->fadingTextures.erase(it);
+        }
+    }
+    for (auto it = mapRoot->fadingSlots.begin(); it != mapRoot->fadingSlots.end(); ) {
+        if (mapRoot->tiles->fades.contains(it.key())
+                || mapRoot->wrapLeft->fades.contains(it.key())
+                || mapRoot->wrapRight->fades.contains(it.key())) {
+            ++it;
+        } else {
+            mapRoot->atlas->release(it.value());
+            it = mapRoot->fadingSlots.erase(it);
+            mapRoot->layersDirty = true;
+        }
+    }
+
+    mapRoot->updateLayers(d, window);
+
     mapRoot->isTextureLinear = d->m_linearScaling;
 
     return mapRoot;
@@ -77,6 +77,7 @@ public:
     const QSet<QGeoTileSpec> &visibleTiles() const;
 
     void addTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
+    bool addFallbackTile(const QGeoTileSpec &spec, QSharedPointer<QGeoTileTexture> texture);
 
     QSGNode *updateSceneGraph(QSGNode *oldNode, QQuickWindow *window);
 
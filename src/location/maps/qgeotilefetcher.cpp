@@ -81,12 +81,49 @@ void QGeoTileFetcher::updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded,
 
     cancelTileRequests(tilesRemoved);
 
+    // Tiles needed on screen are no longer only prefetched
+    if (!d->backgroundQueue_.isEmpty()) {
+        for (auto it = d->backgroundQueue_.begin(); it != d->backgroundQueue_.end(); ) {
+            if (tilesAdded.contains(*it))
+                it = d->backgroundQueue_.erase(it);
+            else
+                ++it;
+        }
+    }
+
     d->queue_ += tilesAdded.toList();
 
     if (d->enabled_ && initialized() && !d->queue_.isEmpty() && !d->timer_.isActive())
         d->timer_.start(0, this);
 }
 
+/*
+    Queues \a tilesAdded for fetching whenever no other tile is waiting, with
+    at most a few of them in flight at a time, and drops \a tilesRemoved from
+    that queue. Used for prefetching, which must not delay what is on screen.
+*/
+void QGeoTileFetcher::updateBackgroundTileRequests(const QList<QGeoTileSpec> &tilesAdded,
+                                                   const QSet<QGeoTileSpec> &tilesRemoved)
+{
+    Q_D(QGeoTileFetcher);
+
+    QMutexLocker ml(&d->queueMutex_);
+
+    if (!tilesRemoved.isEmpty()) {
+        for (auto it = d->backgroundQueue_.begin(); it != d->backgroundQueue_.end(); ) {
+            if (tilesRemoved.contains(*it))
+                it = d->backgroundQueue_.erase(it);
+            else
+                ++it;
+        }
+    }
+
+    d->backgroundQueue_ += tilesAdded;
+
+    if (d->enabled_ && initialized() && !d->backgroundQueue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
+}
+
 void QGeoTileFetcher::cancelTileRequests(const QSet<QGeoTileSpec> &tiles)
 {
     Q_D(QGeoTileFetcher);
@@ -115,23 +152,41 @@ void QGeoTileFetcher::requestNextTile()
     if (!d->enabled_)
         return;
 
-    if (d->queue_.isEmpty())
-        return;
-
-    QGeoTileSpec ts = d->queue_.takeFirst();
-    if (d->queue_.isEmpty())
+    QGeoTileSpec ts;
+    bool background = false;
+    if (!d->queue_.isEmpty()) {
+        ts = d->queue_.takeFirst();
+    } else {
+        // Background requests wait for a free slot, see finished()
+        if (d->backgroundQueue_.isEmpty() || d->invmap_.size() >= d->maxBackgroundRequests_) {
+            d->timer_.stop();
+            return;
+        }
+        ts = d->backgroundQueue_.takeFirst();
+        if (d->invmap_.contains(ts))
+            return;
+        background = true;
+    }
+    if (d->queue_.isEmpty() && d->backgroundQueue_.isEmpty())
         d->timer_.stop();
 
     // Check against min/max zoom to prevent sending requests for not existing objects
     const QGeoCameraCapabilities & cameraCaps = d->engine_->cameraCapabilities(ts.mapId());
     // the ZL in QGeoTileSpec is relative to the native tile size of the provider.
     // It gets denormalized in QGeoTiledMap.
-    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel())
+    // A prefetch job waits for every one of its tiles, so it is told about the ones dropped here
+    if (ts.zoom() < cameraCaps.minimumZoomLevel() || ts.zoom() > cameraCaps.maximumZoomLevel()) {
+        if (background)
+            emit tileError(ts, QStringLiteral("Zoom level out of range"));
         return;
+    }
 
     QGeoTiledMapReply *reply = getTileImage(ts);
-    if (!reply)
+    if (!reply) {
+        if (background)
+            emit tileError(ts, QStringLiteral("Tile not available"));
         return;
+    }
 
     if (reply->isFinished()) {
         handleReply(reply, ts);
@@ -166,6 +221,9 @@ void QGeoTileFetcher::finished()
     d->invmap_.remove(spec);
 
     handleReply(reply, spec);
+
+    if (d->enabled_ && !d->backgroundQueue_.isEmpty() && !d->timer_.isActive())
+        d->timer_.start(0, this);
 }
 
 void QGeoTileFetcher::timerEvent(QTimerEvent *event)
@@ -176,7 +234,7 @@ void QGeoTileFetcher::timerEvent(QTimerEvent *event)
         return;
     }
 
-    if (d->queue_.isEmpty() || !initialized()) {
+    if ((d->queue_.isEmpty() && d->backgroundQueue_.isEmpty()) || !initialized()) {
         d->timer_.stop();
         return;
     }
@@ -189,6 +247,19 @@ bool QGeoTileFetcher::initialized() const
     return true;
 }
 
+/*
+    Returns the freshness of the cached copy of \a spec, so that subclasses can
+    turn the request for a stale tile into a conditional one.
+*/
+QGeoTileFreshness QGeoTileFetcher::tileFreshness(const QGeoTileSpec &spec) const
+{
+    Q_D(const QGeoTileFetcher);
+    QGeoTiledMappingManagerEngine *engine = qobject_cast<QGeoTiledMappingManagerEngine *>(d->engine_);
+    if (!engine)
+        return QGeoTileFreshness();
+    return engine->tileFreshness(spec);
+}
+
 void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &spec)
 {
     Q_D(QGeoTileFetcher);
@@ -199,7 +270,14 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
     }
 
     if (reply->error() == QGeoTiledMapReply::NoError) {
-        emit tileFinished(spec, reply->mapImageData(), reply->mapImageFormat());
+        if (reply->isNotModified()) {
+            // The cached tile is still current, only its freshness changed
+            emit tileFreshnessReceived(spec, reply->freshness(), false);
+        } else {
+            if (reply->freshness().isValid())
+                emit tileFreshnessReceived(spec, reply->freshness(), true);
+            emit tileFinished(spec, reply->mapImageData(), reply->mapImageFormat());
+        }
     } else {
         emit tileError(spec, reply->errorString());
     }
@@ -211,7 +289,7 @@ void QGeoTileFetcher::handleReply(QGeoTiledMapReply *reply, const QGeoTileSpec &
 *******************************************************************************/
 
 QGeoTileFetcherPrivate::QGeoTileFetcherPrivate()
-:   QObjectPrivate(), enabled_(false), engine_(0)
+:   QObjectPrivate(), enabled_(false), maxBackgroundRequests_(2), engine_(0)
 {
 }
 
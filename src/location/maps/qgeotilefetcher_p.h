@@ -73,6 +73,7 @@ public:
 
 public Q_SLOTS:
     void updateTileRequests(const QSet<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved);
+    void updateBackgroundTileRequests(const QList<QGeoTileSpec> &tilesAdded, const QSet<QGeoTileSpec> &tilesRemoved);
 
 private Q_SLOTS:
     void cancelTileRequests(const QSet<QGeoTileSpec> &tiles);
@@ -82,6 +83,7 @@ private Q_SLOTS:
 Q_SIGNALS:
     void tileFinished(const QGeoTileSpec &spec, const QByteArray &bytes, const QString &format);
     void tileError(const QGeoTileSpec &spec, const QString &errorString);
+    void tileFreshnessReceived(const QGeoTileSpec &spec, const QGeoTileFreshness &freshness, bool modified);
 
 protected:
     QGeoTileFetcher(QGeoTileFetcherPrivate &dd, QGeoMappingManagerEngine *parent);
@@ -89,6 +91,7 @@ protected:
     void timerEvent(QTimerEvent *event);
     QAbstractGeoTileCache::CacheAreas cacheHint() const;
     virtual bool initialized() const;
+    QGeoTileFreshness tileFreshness(const QGeoTileSpec &spec) const;
 
 private:
 
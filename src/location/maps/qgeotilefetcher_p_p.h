@@ -78,6 +78,8 @@ public:
     QBasicTimer timer_;
     QMutex queueMutex_;
     QList<QGeoTileSpec> queue_;
+    QList<QGeoTileSpec> backgroundQueue_; // served only when queue_ is empty
+    int maxBackgroundRequests_;
     QHash<QGeoTileSpec, QGeoTiledMapReply *> invmap_;
     QGeoMappingManagerEngine *engine_;
 
@@ -0,0 +1,525 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotileprefetchjob_p.h"
+#include "qgeotiledmappingmanagerengine_p.h"
+#include "qabstractgeotilecache_p.h"
+
+#include <QtCore/private/qobject_p.h>
+#include <QtCore/QMap>
+#include <QtCore/QVector>
+#include <QtCore/qmath.h>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+
+#include <algorithm>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+typedef QVector<QDoubleVector2D> Ring;
+typedef QVector<QPair<int, int> > Spans;
+
+// Number of tiles a job keeps queued in the fetcher at a time
+static const int prefetchWindow = 16;
+
+static const double earthCircumference = 2.0 * M_PI * 6378137.0; // meters, at the equator
+
+// Makes consecutive vertices less than half a world apart, so that shapes crossing the
+// dateline end up with x values outside of [0, 1] instead of spanning the whole map.
+static void unwrapRing(Ring &ring)
+{
+    for (int i = 1; i < ring.size(); ++i) {
+        const double previous = ring.at(i - 1).x();
+        double x = ring.at(i).x();
+        while (x - previous > 0.5)
+            x -= 1.0;
+        while (previous - x > 0.5)
+            x += 1.0;
+        ring[i].setX(x);
+    }
+}
+
+static Ring squareRing(const QDoubleVector2D &center, double halfSide)
+{
+    Ring ring;
+    ring << QDoubleVector2D(center.x() - halfSide, center.y() - halfSide)
+         << QDoubleVector2D(center.x() + halfSide, center.y() - halfSide)
+         << QDoubleVector2D(center.x() + halfSide, center.y() + halfSide)
+         << QDoubleVector2D(center.x() - halfSide, center.y() + halfSide);
+    return ring;
+}
+
+// Converts the shape into closed rings in mercator space, whose union covers the shape.
+static QVector<Ring> shapeToRings(const QGeoShape &shape)
+{
+    QVector<Ring> rings;
+    if (!shape.isValid())
+        return rings;
+
+    switch (shape.type()) {
+    case QGeoShape::RectangleType: {
+        const QGeoRectangle rect(shape);
+        const QDoubleVector2D topLeft = QWebMercator::coordToMercator(rect.topLeft());
+        const QDoubleVector2D bottomRight = QWebMercator::coordToMercator(rect.bottomRight());
+        const double right = topLeft.x() + rect.width() / 360.0;
+        Ring ring;
+        ring << topLeft
+             << QDoubleVector2D(right, topLeft.y())
+             << QDoubleVector2D(right, bottomRight.y())
+             << QDoubleVector2D(topLeft.x(), bottomRight.y());
+        rings.append(ring);
+        break;
+    }
+    case QGeoShape::CircleType: {
+        const QGeoCircle circle(shape);
+        const int steps = 64;
+        // Circumscribe the circle, so that the polygon does not miss tiles along its border
+        const qreal radius = circle.radius() / std::cos(M_PI / steps);
+        Ring ring;
+        ring.reserve(steps);
+        for (int i = 0; i < steps; ++i) {
+            const QGeoCoordinate c = circle.center().atDistanceAndAzimuth(radius, i * 360.0 / steps);
+            ring.append(QWebMercator::coordToMercator(c));
+        }
+        unwrapRing(ring);
+        rings.append(ring);
+        break;
+    }
+    case QGeoShape::PathType: {
+        // A corridor: every segment becomes a quad of the path width, and every vertex a square
+        // patching the joints.
+        const QGeoPath path(shape);
+        Ring vertices;
+        for (const QGeoCoordinate &c : path.path())
+            vertices.append(QWebMercator::coordToMercator(c));
+        unwrapRing(vertices);
+
+        const double halfWidth = path.width() * 0.5;
+        const auto mercatorDistance = [halfWidth](double mercatorY) {
+            const double lat = QWebMercator::mercatorToCoord(QDoubleVector2D(0.5, mercatorY)).latitude();
+            const double scale = qMax(0.01, std::cos(lat * M_PI / 180.0));
+            return halfWidth / (earthCircumference * scale);
+        };
+
+        for (int i = 0; i < vertices.size(); ++i) {
+            const QDoubleVector2D &a = vertices.at(i);
+            rings.append(squareRing(a, mercatorDistance(a.y())));
+            if (i + 1 == vertices.size())
+                break;
+
+            const QDoubleVector2D &b = vertices.at(i + 1);
+            const QDoubleVector2D direction = b - a;
+            const double length = direction.length();
+            if (length <= 0.0)
+                continue;
+            const double d = mercatorDistance((a.y() + b.y()) * 0.5);
+            const QDoubleVector2D normal = QDoubleVector2D(-direction.y(), direction.x()) * (d / length);
+            Ring quad;
+            quad << a + normal << b + normal << b - normal << a - normal;
+            rings.append(quad);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return rings;
+}
+
+static inline int tileRow(double y, int side)
+{
+    return qBound(0, int(std::floor(y)), side - 1);
+}
+
+static inline void addSpan(QMap<int, Spans> &rows, int row, double x0, double x1)
+{
+    if (x1 < x0)
+        std::swap(x0, x1);
+    rows[row].append(qMakePair(int(std::floor(x0)), int(std::floor(x1))));
+}
+
+// Adds the columns crossed by the segment in every row it spans. Coordinates are in tiles.
+static void rasterizeSegment(QDoubleVector2D a, QDoubleVector2D b, int side, QMap<int, Spans> &rows)
+{
+    if (a.y() > b.y())
+        std::swap(a, b);
+
+    const int firstRow = tileRow(a.y(), side);
+    const int lastRow = tileRow(b.y(), side);
+    const double dy = b.y() - a.y();
+    for (int row = firstRow; row <= lastRow; ++row) {
+        if (dy <= 0.0) {
+            addSpan(rows, row, a.x(), b.x());
+            continue;
+        }
+        const double y0 = qMax(a.y(), double(row));
+        const double y1 = qMin(b.y(), double(row + 1));
+        const double x0 = a.x() + (y0 - a.y()) * (b.x() - a.x()) / dy;
+        const double x1 = a.x() + (y1 - a.y()) * (b.x() - a.x()) / dy;
+        addSpan(rows, row, x0, x1);
+    }
+}
+
+// Tiles touched by the outline, plus the ones whose center is inside the ring. Together they
+// are all the tiles the ring intersects.
+static void rasterizeRing(const Ring &mercatorRing, int side, QMap<int, Spans> &rows)
+{
+    const int n = mercatorRing.size();
+    if (n == 0)
+        return;
+
+    Ring ring(mercatorRing);
+    double minY = ring.first().y() * side;
+    double maxY = minY;
+    for (QDoubleVector2D &p : ring) {
+        p *= side;
+        minY = qMin(minY, p.y());
+        maxY = qMax(maxY, p.y());
+    }
+
+    if (n == 1) {
+        addSpan(rows, tileRow(ring.first().y(), side), ring.first().x(), ring.first().x());
+        return;
+    }
+
+    for (int i = 0; i < n; ++i)
+        rasterizeSegment(ring.at(i), ring.at((i + 1) % n), side, rows);
+
+    QVector<double> crossings;
+    const int firstRow = tileRow(minY, side);
+    const int lastRow = tileRow(maxY, side);
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const double y = row + 0.5;
+        crossings.clear();
+        for (int i = 0; i < n; ++i) {
+            const QDoubleVector2D &a = ring.at(i);
+            const QDoubleVector2D &b = ring.at((i + 1) % n);
+            if ((a.y() <= y) != (b.y() <= y))
+                crossings.append(a.x() + (y - a.y()) * (b.x() - a.x()) / (b.y() - a.y()));
+        }
+        std::sort(crossings.begin(), crossings.end());
+        for (int i = 0; i + 1 < crossings.size(); i += 2)
+            addSpan(rows, row, crossings.at(i), crossings.at(i + 1));
+    }
+}
+
+// Wraps the spans of a row into [0, side) and merges them.
+static Spans normalizeSpans(const Spans &spans, int side)
+{
+    Spans wrapped;
+    wrapped.reserve(spans.size() + 1);
+    for (const auto &span : spans) {
+        if (span.second - span.first + 1 >= side)
+            return Spans() << qMakePair(0, side - 1);
+        int first = span.first % side;
+        if (first < 0)
+            first += side;
+        const int last = first + span.second - span.first;
+        if (last < side) {
+            wrapped.append(qMakePair(first, last));
+        } else {
+            wrapped.append(qMakePair(first, side - 1));
+            wrapped.append(qMakePair(0, last - side));
+        }
+    }
+    std::sort(wrapped.begin(), wrapped.end());
+
+    Spans merged;
+    for (const auto &span : qAsConst(wrapped)) {
+        if (!merged.isEmpty() && span.first <= merged.last().second + 1)
+            merged.last().second = qMax(merged.last().second, span.second);
+        else
+            merged.append(span);
+    }
+    return merged;
+}
+
+} // namespace
+
+class QGeoTilePrefetchJobPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QGeoTilePrefetchJob)
+public:
+    QGeoTilePrefetchJobPrivate();
+
+    void submit();
+    void withdraw();
+    void setState(QGeoTilePrefetchJob::State state);
+
+    QGeoTiledMappingManagerEngine *m_engine;
+    QList<QGeoTileSpec> m_pending;
+    QSet<QGeoTileSpec> m_inFlight;
+    int m_total;
+    int m_completed;
+    int m_failed;
+    bool m_truncated;
+    QGeoTilePrefetchJob::State m_state;
+};
+
+QGeoTilePrefetchJobPrivate::QGeoTilePrefetchJobPrivate()
+    : m_engine(0), m_total(0), m_completed(0), m_failed(0), m_truncated(false),
+      m_state(QGeoTilePrefetchJob::Running)
+{
+}
+
+// Tops up the requests of this job queued in the fetcher
+void QGeoTilePrefetchJobPrivate::submit()
+{
+    Q_Q(QGeoTilePrefetchJob);
+    if (m_state != QGeoTilePrefetchJob::Running || !m_engine)
+        return;
+
+    QAbstractGeoTileCache *cache = m_engine->tileCache();
+    QList<QGeoTileSpec> batch;
+    int skipped = 0;
+    while (m_inFlight.size() < prefetchWindow && !m_pending.isEmpty()) {
+        const QGeoTileSpec spec = m_pending.takeFirst();
+        if (cache->contains(spec, QAbstractGeoTileCache::DiskCache)) {
+            ++skipped;
+            continue;
+        }
+        if (!m_inFlight.contains(spec)) {
+            m_inFlight.insert(spec);
+            batch.append(spec);
+        }
+    }
+
+    if (!batch.isEmpty())
+        m_engine->updatePrefetchRequests(q, batch, QSet<QGeoTileSpec>());
+
+    if (skipped) {
+        m_completed += skipped;
+        emit q->progress(m_completed + m_failed, m_total);
+    }
+
+    if (m_pending.isEmpty() && m_inFlight.isEmpty())
+        setState(QGeoTilePrefetchJob::Finished);
+}
+
+// Takes the requests of this job back from the fetcher, keeping them for a later resume
+void QGeoTilePrefetchJobPrivate::withdraw()
+{
+    Q_Q(QGeoTilePrefetchJob);
+    if (m_inFlight.isEmpty())
+        return;
+
+    if (m_engine)
+        m_engine->updatePrefetchRequests(q, QList<QGeoTileSpec>(), m_inFlight);
+    m_pending = m_inFlight.toList() + m_pending;
+    m_inFlight.clear();
+}
+
+void QGeoTilePrefetchJobPrivate::setState(QGeoTilePrefetchJob::State state)
+{
+    Q_Q(QGeoTilePrefetchJob);
+    if (m_state == state)
+        return;
+    m_state = state;
+    emit q->stateChanged(state);
+}
+
+/*
+    \class QGeoTilePrefetchJob
+    \internal
+
+    A job downloading a fixed set of tiles into the disk cache of a
+    QGeoTiledMappingManagerEngine, through the background queue of its fetcher.
+    Tiles already on disk are skipped. The tiles not yet downloaded can be
+    obtained with remainingTiles(), to continue the job in a later session via
+    QGeoTiledMappingManagerEngine::prefetchTiles().
+*/
+QGeoTilePrefetchJob::QGeoTilePrefetchJob(QGeoTiledMappingManagerEngine *engine,
+                                         const QList<QGeoTileSpec> &tiles, bool truncated)
+    : QObject(*new QGeoTilePrefetchJobPrivate(), 0)
+{
+    Q_D(QGeoTilePrefetchJob);
+    d->m_engine = engine;
+    d->m_pending = tiles;
+    d->m_total = tiles.size();
+    d->m_truncated = truncated;
+}
+
+QGeoTilePrefetchJob::~QGeoTilePrefetchJob()
+{
+    Q_D(QGeoTilePrefetchJob);
+    d->withdraw();
+    if (d->m_engine)
+        d->m_engine->releasePrefetchJob(this);
+}
+
+QGeoTilePrefetchJob::State QGeoTilePrefetchJob::state() const
+{
+    Q_D(const QGeoTilePrefetchJob);
+    return d->m_state;
+}
+
+int QGeoTilePrefetchJob::totalTiles() const
+{
+    Q_D(const QGeoTilePrefetchJob);
+    return d->m_total;
+}
+
+int QGeoTilePrefetchJob::completedTiles() const
+{
+    Q_D(const QGeoTilePrefetchJob);
+    return d->m_completed;
+}
+
+int QGeoTilePrefetchJob::failedTiles() const
+{
+    Q_D(const QGeoTilePrefetchJob);
+    return d->m_failed;
+}
+
+/*
+    Returns true if the region had more tiles than the budget of the job allowed.
+*/
+bool QGeoTilePrefetchJob::isTruncated() const
+{
+    Q_D(const QGeoTilePrefetchJob);
+    return d->m_truncated;
+}
+
+QList<QGeoTileSpec> QGeoTilePrefetchJob::remainingTiles() const
+{
+    Q_D(const QGeoTilePrefetchJob);
+    return d->m_inFlight.toList() + d->m_pending;
+}
+
+void QGeoTilePrefetchJob::pause()
+{
+    Q_D(QGeoTilePrefetchJob);
+    if (d->m_state != Running)
+        return;
+    d->withdraw();
+    d->setState(Paused);
+}
+
+void QGeoTilePrefetchJob::resume()
+{
+    Q_D(QGeoTilePrefetchJob);
+    if (d->m_state != Paused || !d->m_engine)
+        return;
+    d->setState(Running);
+    d->submit();
+}
+
+void QGeoTilePrefetchJob::cancel()
+{
+    Q_D(QGeoTilePrefetchJob);
+    if (d->m_state != Running && d->m_state != Paused)
+        return;
+    d->withdraw();
+    d->setState(Canceled);
+}
+
+void QGeoTilePrefetchJob::start()
+{
+    Q_D(QGeoTilePrefetchJob);
+    d->submit();
+}
+
+void QGeoTilePrefetchJob::tileFinished(const QGeoTileSpec &spec, bool success)
+{
+    Q_D(QGeoTilePrefetchJob);
+    if (!d->m_inFlight.remove(spec))
+        return;
+
+    if (success)
+        ++d->m_completed;
+    else
+        ++d->m_failed;
+    emit progress(d->m_completed + d->m_failed, d->m_total);
+
+    d->submit();
+}
+
+// Called when the engine goes away before the job
+void QGeoTilePrefetchJob::detach()
+{
+    Q_D(QGeoTilePrefetchJob);
+    d->m_engine = 0;
+    d->m_pending = d->m_inFlight.toList() + d->m_pending;
+    d->m_inFlight.clear();
+    if (d->m_state == Running || d->m_state == Paused)
+        d->setState(Canceled);
+}
+
+/*
+    Returns the tiles at \a zoom that intersect \a shape, row by row from the
+    north. Rectangles, circles and paths are supported; a path covers the
+    corridor of its width. If \a maxTiles is not negative, at most that many
+    tiles are returned, and \a truncated is set if some had to be left out.
+*/
+QList<QGeoTileSpec> QGeoTilePrefetchJob::tilesForShape(const QGeoShape &shape, const QString &plugin,
+                                                       int mapId, int zoom, int version,
+                                                       int maxTiles, bool *truncated)
+{
+    QList<QGeoTileSpec> tiles;
+    if (truncated)
+        *truncated = false;
+    if (zoom < 0 || zoom > 30)
+        return tiles;
+
+    const int side = 1 << zoom;
+    QMap<int, Spans> rows;
+    const QVector<Ring> rings = shapeToRings(shape);
+    for (const Ring &ring : rings)
+        rasterizeRing(ring, side, rows);
+
+    for (auto it = rows.cbegin(); it != rows.cend(); ++it) {
+        const Spans spans = normalizeSpans(it.value(), side);
+        for (const auto &span : spans) {
+            for (int x = span.first; x <= span.second; ++x) {
+                if (maxTiles >= 0 && tiles.size() >= maxTiles) {
+                    if (truncated)
+                        *truncated = true;
+                    return tiles;
+                }
+                tiles.append(QGeoTileSpec(plugin, mapId, zoom, x, it.key(), version));
+            }
+        }
+    }
+    return tiles;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,110 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILEPREFETCHJOB_P_H
+#define QGEOTILEPREFETCHJOB_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtLocation/private/qlocationglobal_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoShape;
+class QGeoTiledMappingManagerEngine;
+class QGeoTilePrefetchJobPrivate;
+
+class Q_LOCATION_PRIVATE_EXPORT QGeoTilePrefetchJob : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QGeoTilePrefetchJob)
+
+public:
+    enum State {
+        Running,
+        Paused,
+        Finished,
+        Canceled
+    };
+
+    ~QGeoTilePrefetchJob();
+
+    State state() const;
+    int totalTiles() const;
+    int completedTiles() const;
+    int failedTiles() const;
+    bool isTruncated() const;
+    QList<QGeoTileSpec> remainingTiles() const;
+
+    void pause();
+    void resume();
+    void cancel();
+
+    static QList<QGeoTileSpec> tilesForShape(const QGeoShape &shape, const QString &plugin,
+                                             int mapId, int zoom, int version,
+                                             int maxTiles = -1, bool *truncated = 0);
+
+Q_SIGNALS:
+    void progress(int completedTiles, int totalTiles);
+    void stateChanged(QGeoTilePrefetchJob::State state);
+
+private:
+    QGeoTilePrefetchJob(QGeoTiledMappingManagerEngine *engine,
+                        const QList<QGeoTileSpec> &tiles, bool truncated);
+
+    void start();
+    void tileFinished(const QGeoTileSpec &spec, bool success);
+    void detach();
+
+    Q_DISABLE_COPY(QGeoTilePrefetchJob)
+    friend class QGeoTiledMappingManagerEngine;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEPREFETCHJOB_P_H
@@ -39,6 +39,9 @@
 #include "qgeotiledmappingmanagerengine_p.h"
 #include "qabstractgeotilecache_p.h"
 #include <QtCore/QPointer>
+#include <QtCore/QTimer>
+#include <QtCore/QMetaObject>
+#include <QtGui/QPainter>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,9 +59,16 @@ public:
     QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > requestTiles(const QSet<QGeoTileSpec> &tiles);
     void tileError(const QGeoTileSpec &tile, const QString &errorString);
 
+    QSharedPointer<QGeoTileTexture> fallbackTexture(const QGeoTileSpec &tile);
+    QSharedPointer<QGeoTileTexture> mosaicTexture(const QGeoTileSpec &tile, int levels);
+    void probeDiskFallback(const QGeoTileSpec &tile);
+    void diskFallbackLoaded(const QGeoTileSpec &tile, const QSharedPointer<QGeoTileTexture> &texture);
+
     QHash<QGeoTileSpec, int> m_retries;
     QHash<QGeoTileSpec, QSharedPointer<RetryFuture> > m_futures;
     QSet<QGeoTileSpec> m_requested;
+    QSet<QGeoTileSpec> m_diskProbes;
+    QMetaObject::Connection m_diskProbeConnection;
 
     void tileFetched(const QGeoTileSpec &spec);
 };
@@ -101,10 +111,17 @@ QGeoTileRequestManagerPrivate::QGeoTileRequestManagerPrivate(QGeoTiledMap *map,Q
     : m_map(map),
       m_engine(engine)
 {
+    if (m_engine) {
+        m_diskProbeConnection = QObject::connect(m_engine->tileCache(), &QAbstractGeoTileCache::loadedFromDisk,
+                                                 [this](const QGeoTileSpec &tile, const QSharedPointer<QGeoTileTexture> &texture) {
+            diskFallbackLoaded(tile, texture);
+        });
+    }
 }
 
 QGeoTileRequestManagerPrivate::~QGeoTileRequestManagerPrivate()
 {
+    QObject::disconnect(m_diskProbeConnection);
 }
 
 QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPrivate::requestTiles(const QSet<QGeoTileSpec> &tiles)
@@ -129,22 +146,18 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
             if (tex) {
                 if (!tex->image.isNull())
                     cachedTex.insert(tile, tex);
-                cached.insert(tile);
+                // A stale tile is shown right away, and requested again so that
+                // the fetcher can revalidate it
+                if (!m_engine->tileFreshness(tile).isStale())
+                    cached.insert(tile);
             } else {
-                // Try to use textures from lower zoom levels, but still request the proper tile
-                QGeoTileSpec spec = tile;
-                const int endRange = qMax(0, tile.zoom() - 4); // Using up to 4 zoom levels up. 4 is arbitrary.
-                for (int z = tile.zoom() - 1; z >= endRange; z--) {
-                    int denominator = 1 << (tile.zoom() - z);
-                    spec.setZoom(z);
-                    spec.setX(tile.x() / denominator);
-                    spec.setY(tile.y() / denominator);
-                    QSharedPointer<QGeoTileTexture> t = m_engine->getTileTexture(spec);
-                    if (t && !t->image.isNull()) {
-                        cachedTex.insert(tile, t);
-                        break;
-                    }
-                }
+                // Use whatever is already in memory in place of the missing tile, but still
+                // request the proper one. Lower zoom levels on disk are looked up in the background.
+                QSharedPointer<QGeoTileTexture> fallback = fallbackTexture(tile);
+                if (fallback)
+                    cachedTex.insert(tile, fallback);
+                else
+                    probeDiskFallback(tile);
             }
         }
     }
@@ -175,6 +188,101 @@ QMap<QGeoTileSpec, QSharedPointer<QGeoTileTexture> > QGeoTileRequestManagerPriva
     return cachedTex;
 }
 
+QSharedPointer<QGeoTileTexture> QGeoTileRequestManagerPrivate::fallbackTexture(const QGeoTileSpec &tile)
+{
+    // Finer tiles are usually still in memory when zooming out, and give a sharper result
+    for (int levels = 1; levels <= 2; ++levels) {
+        QSharedPointer<QGeoTileTexture> mosaic = mosaicTexture(tile, levels);
+        if (mosaic)
+            return mosaic;
+    }
+
+    QGeoTileSpec spec = tile;
+    const int endRange = qMax(0, tile.zoom() - 4); // Using up to 4 zoom levels up. 4 is arbitrary.
+    for (int z = tile.zoom() - 1; z >= endRange; z--) {
+        int denominator = 1 << (tile.zoom() - z);
+        spec.setZoom(z);
+        spec.setX(tile.x() / denominator);
+        spec.setY(tile.y() / denominator);
+        QSharedPointer<QGeoTileTexture> t = m_engine->getTileTextureFromMemory(spec);
+        if (t && !t->image.isNull())
+            return t;
+    }
+    return QSharedPointer<QGeoTileTexture>();
+}
+
+// Composes the 2^levels x 2^levels descendants of tile into a single image, if all of them are
+// in memory. The resulting texture carries the spec of the top-left descendant, so that its zoom
+// level reflects where the pixels come from.
+QSharedPointer<QGeoTileTexture> QGeoTileRequestManagerPrivate::mosaicTexture(const QGeoTileSpec &tile, int levels)
+{
+    const int side = 1 << levels;
+    QVector<QSharedPointer<QGeoTileTexture> > parts;
+    parts.reserve(side * side);
+
+    QGeoTileSpec spec = tile;
+    spec.setZoom(tile.zoom() + levels);
+    for (int dy = 0; dy < side; ++dy) {
+        for (int dx = 0; dx < side; ++dx) {
+            spec.setX(tile.x() * side + dx);
+            spec.setY(tile.y() * side + dy);
+            QSharedPointer<QGeoTileTexture> t = m_engine->getTileTextureFromMemory(spec);
+            if (!t || t->image.isNull())
+                return QSharedPointer<QGeoTileTexture>();
+            parts.append(t);
+        }
+    }
+
+    const QSize size = parts.first()->image.size();
+    QImage mosaic(size, QImage::Format_ARGB32_Premultiplied);
+    mosaic.fill(Qt::transparent);
+
+    QPainter painter(&mosaic);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    const qreal partWidth = qreal(size.width()) / side;
+    const qreal partHeight = qreal(size.height()) / side;
+    for (int i = 0; i < parts.size(); ++i) {
+        const QRectF target((i % side) * partWidth, (i / side) * partHeight, partWidth, partHeight);
+        painter.drawImage(target, parts.at(i)->image);
+    }
+    painter.end();
+
+    QSharedPointer<QGeoTileTexture> texture(new QGeoTileTexture);
+    texture->spec = parts.first()->spec;
+    texture->image = mosaic;
+    return texture;
+}
+
+void QGeoTileRequestManagerPrivate::probeDiskFallback(const QGeoTileSpec &tile)
+{
+    if (m_diskProbes.contains(tile))
+        return;
+
+    QList<QGeoTileSpec> ancestors;
+    QGeoTileSpec spec = tile;
+    const int endRange = qMax(0, tile.zoom() - 4);
+    for (int z = tile.zoom() - 1; z >= endRange; z--) {
+        int denominator = 1 << (tile.zoom() - z);
+        spec.setZoom(z);
+        spec.setX(tile.x() / denominator);
+        spec.setY(tile.y() / denominator);
+        ancestors.append(spec);
+    }
+
+    // The cache reads and decodes on its own thread, the result arrives with loadedFromDisk()
+    if (m_engine->tileCache()->loadFromDisk(tile, ancestors))
+        m_diskProbes.insert(tile);
+}
+
+void QGeoTileRequestManagerPrivate::diskFallbackLoaded(const QGeoTileSpec &tile, const QSharedPointer<QGeoTileTexture> &texture)
+{
+    // The cache is shared between maps, only answer the lookups made here
+    if (!m_diskProbes.remove(tile))
+        return;
+    if (texture && !texture->image.isNull() && m_requested.contains(tile))
+        m_map->updateTileFallback(tile, texture);
+}
+
 void QGeoTileRequestManagerPrivate::tileFetched(const QGeoTileSpec &spec)
 {
     m_map->updateTile(spec);
@@ -216,7 +216,7 @@ void QGeoMapMapboxGLPrivate::addMapItem(QDeclarativeGeoMapItemBase *item)
         QObject::connect(mapItem, &QQuickItem::visibleChanged, q, &QGeoMapMapboxGL::onMapItemPropertyChanged);
         QObject::connect(mapItem, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged, q, &QGeoMapMapboxGL::onMapItemPropertyChanged);
         QObject::connect(mapItem, &QDeclarativePolygonMapItem::pathChanged, q, &QGeoMapMapboxGL::onMapItemGeometryChanged);
-        QObject::connect(mapItem, &QDeclarativePolygonMapItem::colorChanged, q, &QGeoMapMapboxGL::onMapItemGeometryChanged);
+        QObject::connect(mapItem, &QDeclarativePolygonMapItem::colorChanged, q, &QGeoMapMapboxGL::onMapItemPropertyChanged);
         QObject::connect(mapItem->border(), &QDeclarativeMapLineProperties::colorChanged, q, &QGeoMapMapboxGL::onMapItemSubPropertyChanged);
         QObject::connect(mapItem->border(), &QDeclarativeMapLineProperties::widthChanged, q, &QGeoMapMapboxGL::onMapItemUnsupportedPropertyChanged);
     } break;
@@ -232,7 +232,10 @@ void QGeoMapMapboxGLPrivate::addMapItem(QDeclarativeGeoMapItemBase *item)
 
     QObject::connect(item, &QDeclarativeGeoMapItemBase::mapItemOpacityChanged, q, &QGeoMapMapboxGL::onMapItemPropertyChanged);
 
-    m_styleChanges << QMapboxGLStyleChange::addMapItem(item, m_mapItemsBefore);
+    if (m_batchMapItems)
+        m_mapItemBatcher.addMapItem(item);
+    else
+        m_styleChanges << QMapboxGLStyleChange::addMapItem(item, m_mapItemsBefore);
 
     emit q->sgNodeChanged();
 }
@@ -262,7 +265,10 @@ void QGeoMapMapboxGLPrivate::removeMapItem(QDeclarativeGeoMapItemBase *item)
 
     q->disconnect(item);
 
-    m_styleChanges << QMapboxGLStyleChange::removeMapItem(item);
+    if (m_batchMapItems)
+        m_mapItemBatcher.removeMapItem(item);
+    else
+        m_styleChanges << QMapboxGLStyleChange::removeMapItem(item);
 
     emit q->sgNodeChanged();
 }
@@ -293,6 +299,11 @@ void QGeoMapMapboxGLPrivate::changeActiveMapType(const QGeoMapType)
 
 void QGeoMapMapboxGLPrivate::syncStyleChanges(QMapboxGL *map)
 {
+    // All the changes to the batched items since the last frame are
+    // coalesced into one source update per affected batch.
+    if (m_batchMapItems)
+        m_styleChanges << m_mapItemBatcher.takeStyleChanges();
+
     for (const auto& change : m_styleChanges) {
         change->apply(map);
     }
@@ -370,6 +381,13 @@ void QGeoMapMapboxGL::setMapItemsBefore(const QString &before)
 {
     Q_D(QGeoMapMapboxGL);
     d->m_mapItemsBefore = before;
+    d->m_mapItemBatcher.setBefore(before);
+}
+
+void QGeoMapMapboxGL::setBatchMapItems(bool batch)
+{
+    Q_D(QGeoMapMapboxGL);
+    d->m_batchMapItems = batch;
 }
 
 QSGNode *QGeoMapMapboxGL::updateSceneGraph(QSGNode *oldNode, QQuickWindow *window)
@@ -388,8 +406,12 @@ void QGeoMapMapboxGL::onMapChanged(QMapboxGL::MapChange change)
         d->m_styleLoaded = false;
         d->m_styleChanges.clear();
 
-        for (QDeclarativeGeoMapItemBase *item : d->m_mapItems)
-            d->m_styleChanges << QMapboxGLStyleChange::addMapItem(item, d->m_mapItemsBefore);
+        if (d->m_batchMapItems) {
+            d->m_mapItemBatcher.reset();
+        } else {
+            for (QDeclarativeGeoMapItemBase *item : d->m_mapItems)
+                d->m_styleChanges << QMapboxGLStyleChange::addMapItem(item, d->m_mapItemsBefore);
+        }
 
         for (QGeoMapParameter *param : d->m_mapParameters)
             d->m_styleChanges << QMapboxGLStyleChange::addMapParameter(param);
@@ -401,8 +423,12 @@ void QGeoMapMapboxGL::onMapItemPropertyChanged()
     Q_D(QGeoMapMapboxGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender());
-    d->m_styleChanges << QMapboxGLStyleSetPaintProperty::fromMapItem(item);
-    d->m_styleChanges << QMapboxGLStyleSetLayoutProperty::fromMapItem(item);
+    if (d->m_batchMapItems) {
+        d->m_mapItemBatcher.updateMapItem(item);
+    } else {
+        d->m_styleChanges << QMapboxGLStyleSetPaintProperty::fromMapItem(item);
+        d->m_styleChanges << QMapboxGLStyleSetLayoutProperty::fromMapItem(item);
+    }
 
     emit sgNodeChanged();
 }
@@ -412,7 +438,10 @@ void QGeoMapMapboxGL::onMapItemSubPropertyChanged()
     Q_D(QGeoMapMapboxGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender()->parent());
-    d->m_styleChanges << QMapboxGLStyleSetPaintProperty::fromMapItem(item);
+    if (d->m_batchMapItems)
+        d->m_mapItemBatcher.updateMapItem(item);
+    else
+        d->m_styleChanges << QMapboxGLStyleSetPaintProperty::fromMapItem(item);
 
     emit sgNodeChanged();
 }
@@ -428,7 +457,10 @@ void QGeoMapMapboxGL::onMapItemGeometryChanged()
     Q_D(QGeoMapMapboxGL);
 
     QDeclarativeGeoMapItemBase *item = static_cast<QDeclarativeGeoMapItemBase *>(sender());
-    d->m_styleChanges << QMapboxGLStyleAddSource::fromMapItem(item);
+    if (d->m_batchMapItems)
+        d->m_mapItemBatcher.updateMapItemGeometry(item);
+    else
+        d->m_styleChanges << QMapboxGLStyleAddSource::fromMapItem(item);
 
     emit sgNodeChanged();
 }
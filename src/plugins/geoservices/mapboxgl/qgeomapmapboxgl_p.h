@@ -46,8 +46,9 @@
 #include <QtLocation/private/qgeomap_p_p.h>
 #include <QtLocation/private/qgeomapparameter_p.h>
 
+#include "qmapboxglstylechange_p.h"
+
 class QMapboxGL;
-class QMapboxGLStyleChange;
 
 class QGeoMapMapboxGLPrivate : public QGeoMapPrivate
 {
@@ -80,6 +81,8 @@ public:
     bool m_useFBO = true;
     bool m_developmentMode = false;
     QString m_mapItemsBefore;
+    bool m_batchMapItems = false;
+    QMapboxGLMapItemBatcher m_mapItemBatcher;
 
     QTimer m_refresh;
     bool m_shouldRefresh = true;
@@ -142,6 +142,10 @@ QGeoMappingManagerEngineMapboxGL::QGeoMappingManagerEngineMapboxGL(const QVarian
         m_mapItemsBefore = parameters.value(QStringLiteral("mapboxgl.mapping.items.insert_before")).toString();
     }
 
+    if (parameters.contains(QStringLiteral("mapboxgl.mapping.items.batch"))) {
+        m_batchMapItems = parameters.value(QStringLiteral("mapboxgl.mapping.items.batch")).toBool();
+    }
+
     engineInitialized();
 }
 
@@ -155,6 +159,7 @@ QGeoMap *QGeoMappingManagerEngineMapboxGL::createMap()
     map->setMapboxGLSettings(m_settings);
     map->setUseFBO(m_useFBO);
     map->setMapItemsBefore(m_mapItemsBefore);
+    map->setBatchMapItems(m_batchMapItems);
 
     return map;
 }
@@ -60,6 +60,7 @@ private:
     QMapboxGLSettings m_settings;
     bool m_useFBO = true;
     QString m_mapItemsBefore;
+    bool m_batchMapItems = false;
 };
 
 QT_END_NAMESPACE
@@ -40,6 +40,7 @@
 #include <QtCore/QMetaProperty>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QStringList>
+#include <QtGui/QColor>
 #include <QtPositioning/QGeoPath>
 #include <QtQml/QJSValue>
 
@@ -90,10 +91,11 @@ QMapbox::Feature featureFromMapCircle(QDeclarativeCircleMapItem *mapItem)
 {
     static const int circleSamples = 128;
 
-    QList<QGeoCoordinate> path;
+    QVector<QGeoCoordinate> path;
     QGeoCoordinate leftBound;
     QDeclarativeCircleMapItem::calculatePeripheralPoints(path, mapItem->center(), mapItem->radius(), circleSamples, leftBound);
-    QList<QDoubleVector2D> pathProjected;
+    QVector<QDoubleVector2D> pathProjected;
+    pathProjected.reserve(path.size());
     for (const QGeoCoordinate &c : qAsConst(path))
         pathProjected << mapItem->map()->geoProjection().geoToMapProjection(c);
     if (QDeclarativeCircleMapItem::crossEarthPole(mapItem->center(), mapItem->radius()))
@@ -167,6 +169,102 @@ QMapbox::Feature featureFromMapItem(QDeclarativeGeoMapItemBase *item)
     }
 }
 
+void appendGeoJsonCoordinates(QByteArray *json, const QMapbox::Coordinates &coordinates)
+{
+    json->append('[');
+    for (int i = 0; i < coordinates.size(); ++i) {
+        if (i)
+            json->append(',');
+        json->append('[');
+        json->append(QByteArray::number(coordinates.at(i).second, 'g', 12));
+        json->append(',');
+        json->append(QByteArray::number(coordinates.at(i).first, 'g', 12));
+        json->append(']');
+    }
+    json->append(']');
+}
+
+QByteArray geoJsonGeometryFromFeature(const QMapbox::Feature &feature)
+{
+    QByteArray json;
+
+    if (feature.geometry.isEmpty() || feature.geometry.first().isEmpty())
+        return json;
+
+    const QMapbox::CoordinatesCollection &rings = feature.geometry.first();
+    if (rings.first().isEmpty())
+        return json;
+
+    switch (feature.type) {
+    case QMapbox::Feature::PointType:
+        json = "{\"type\":\"Point\",\"coordinates\":[";
+        json += QByteArray::number(rings.first().first().second, 'g', 12);
+        json += ',';
+        json += QByteArray::number(rings.first().first().first, 'g', 12);
+        json += "]}";
+        break;
+    case QMapbox::Feature::LineStringType:
+        json = "{\"type\":\"LineString\",\"coordinates\":";
+        appendGeoJsonCoordinates(&json, rings.first());
+        json += '}';
+        break;
+    case QMapbox::Feature::PolygonType:
+        json = "{\"type\":\"Polygon\",\"coordinates\":[";
+        for (int i = 0; i < rings.size(); ++i) {
+            if (i)
+                json += ',';
+            appendGeoJsonCoordinates(&json, rings.at(i));
+        }
+        json += "]}";
+        break;
+    }
+
+    return json;
+}
+
+QByteArray geoJsonPropertiesFromMapItem(QDeclarativeGeoMapItemBase *item)
+{
+    QColor color;
+    QColor outlineColor;
+
+    switch (item->itemType()) {
+    case QGeoMap::MapRectangle:
+        color = static_cast<QDeclarativeRectangleMapItem *>(item)->color();
+        outlineColor = static_cast<QDeclarativeRectangleMapItem *>(item)->border()->color();
+        break;
+    case QGeoMap::MapCircle:
+        color = static_cast<QDeclarativeCircleMapItem *>(item)->color();
+        outlineColor = static_cast<QDeclarativeCircleMapItem *>(item)->border()->color();
+        break;
+    case QGeoMap::MapPolygon:
+        color = static_cast<QDeclarativePolygonMapItem *>(item)->color();
+        outlineColor = static_cast<QDeclarativePolygonMapItem *>(item)->border()->color();
+        break;
+    case QGeoMap::MapPolyline:
+        color = static_cast<QDeclarativePolylineMapItem *>(item)->line()->color();
+        break;
+    default:
+        break;
+    }
+
+    QByteArray json = "{\"color\":\"" + color.name().toLatin1() + "\",\"opacity\":"
+            + QByteArray::number(color.alphaF() * item->mapItemOpacity());
+    if (outlineColor.isValid())
+        json += ",\"outline-color\":\"" + outlineColor.name().toLatin1() + '"';
+    json += '}';
+
+    return json;
+}
+
+QVariantMap identityFunction(const QString &property)
+{
+    QVariantMap function;
+    function[QStringLiteral("type")] = QStringLiteral("identity");
+    function[QStringLiteral("property")] = property;
+
+    return function;
+}
+
 } // namespace
 
 
@@ -485,12 +583,17 @@ QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddLayer::fromMapParameter(QG
 }
 
 QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddLayer::fromFeature(const QMapbox::Feature &feature, const QString &before)
+{
+    return fromSource(feature.id.toString(), feature.type, before);
+}
+
+QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddLayer::fromSource(const QString &source, QMapbox::Feature::Type type, const QString &before)
 {
     auto layer = new QMapboxGLStyleAddLayer();
-    layer->m_params[QStringLiteral("id")] = feature.id;
-    layer->m_params[QStringLiteral("source")] = feature.id;
+    layer->m_params[QStringLiteral("id")] = source;
+    layer->m_params[QStringLiteral("source")] = source;
 
-    switch (feature.type) {
+    switch (type) {
     case QMapbox::Feature::PointType:
         layer->m_params[QStringLiteral("type")] = QStringLiteral("circle");
         break;
@@ -579,6 +682,17 @@ QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddSource::fromMapItem(QDecla
     return fromFeature(featureFromMapItem(item));
 }
 
+QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddSource::fromGeoJson(const QString &id, const QByteArray &data)
+{
+    auto source = new QMapboxGLStyleAddSource();
+
+    source->m_id = id;
+    source->m_params[QStringLiteral("type")] = QStringLiteral("geojson");
+    source->m_params[QStringLiteral("data")] = data;
+
+    return QSharedPointer<QMapboxGLStyleChange>(source);
+}
+
 
 // QMapboxGLStyleRemoveSource
 
@@ -628,3 +742,219 @@ QSharedPointer<QMapboxGLStyleChange> QMapboxGLStyleAddImage::fromMapParameter(QG
 
     return QSharedPointer<QMapboxGLStyleChange>(image);
 }
+
+
+// QMapboxGLMapItemBatcher
+
+void QMapboxGLMapItemBatcher::setBefore(const QString &before)
+{
+    m_before = before;
+}
+
+void QMapboxGLMapItemBatcher::addMapItem(QDeclarativeGeoMapItemBase *item)
+{
+    switch (item->itemType()) {
+    case QGeoMap::MapRectangle:
+    case QGeoMap::MapCircle:
+    case QGeoMap::MapPolygon:
+    case QGeoMap::MapPolyline:
+        break;
+    default:
+        qWarning() << "Unsupported QGeoMap item type: " << item->itemType();
+        return;
+    }
+
+    if (m_entries.contains(item))
+        return;
+
+    Entry &entry = m_entries[item];
+    entry.serial = ++m_serial;
+    entry.geometry = geoJsonGeometryFromFeature(featureFromMapItem(item));
+
+    updateMapItem(item);
+}
+
+void QMapboxGLMapItemBatcher::removeMapItem(QDeclarativeGeoMapItemBase *item)
+{
+    auto it = m_entries.find(item);
+    if (it == m_entries.end())
+        return;
+
+    detach(*it);
+    m_entries.erase(it);
+}
+
+void QMapboxGLMapItemBatcher::updateMapItem(QDeclarativeGeoMapItemBase *item)
+{
+    auto it = m_entries.find(item);
+    if (it == m_entries.end())
+        return;
+
+    Entry &entry = *it;
+    entry.properties = geoJsonPropertiesFromMapItem(item);
+
+    // Everything but the line width can be expressed as data driven
+    // styling, so it is the only paint property splitting the batches.
+    QMapbox::Feature::Type type = QMapbox::Feature::PolygonType;
+    qreal lineWidth = 0.0;
+    QByteArray key = QByteArrayLiteral("fill");
+    if (item->itemType() == QGeoMap::MapPolyline) {
+        type = QMapbox::Feature::LineStringType;
+        lineWidth = static_cast<QDeclarativePolylineMapItem *>(item)->line()->width();
+        key = QByteArrayLiteral("line:") + QByteArray::number(lineWidth);
+    }
+
+    if (entry.batch >= 0 && m_batches.at(entry.batch).key == key) {
+        m_batches[entry.batch].dirty = true;
+        return;
+    }
+
+    detach(entry);
+    entry.batch = batchFor(key, type, lineWidth);
+
+    Batch &batch = m_batches[entry.batch];
+    batch.items.insert(entry.serial, item);
+    batch.dirty = true;
+}
+
+void QMapboxGLMapItemBatcher::updateMapItemGeometry(QDeclarativeGeoMapItemBase *item)
+{
+    auto it = m_entries.find(item);
+    if (it == m_entries.end())
+        return;
+
+    it->geometry = geoJsonGeometryFromFeature(featureFromMapItem(item));
+    if (it->batch >= 0)
+        m_batches[it->batch].dirty = true;
+}
+
+void QMapboxGLMapItemBatcher::reset()
+{
+    for (Batch &batch : m_batches) {
+        batch.added = false;
+        batch.dirty = !batch.items.isEmpty();
+    }
+}
+
+int QMapboxGLMapItemBatcher::batchCount() const
+{
+    int count = 0;
+    for (const Batch &batch : m_batches)
+        count += batch.items.isEmpty() ? 0 : 1;
+
+    return count;
+}
+
+QList<QSharedPointer<QMapboxGLStyleChange>> QMapboxGLMapItemBatcher::takeStyleChanges()
+{
+    QList<QSharedPointer<QMapboxGLStyleChange>> changes;
+
+    for (Batch &batch : m_batches) {
+        if (!batch.dirty)
+            continue;
+
+        batch.dirty = false;
+
+        if (batch.items.isEmpty()) {
+            if (batch.added) {
+                changes << QSharedPointer<QMapboxGLStyleChange>(new QMapboxGLStyleRemoveLayer(batch.id));
+                changes << QSharedPointer<QMapboxGLStyleChange>(new QMapboxGLStyleRemoveSource(batch.id));
+                batch.added = false;
+            }
+            continue;
+        }
+
+        changes << QMapboxGLStyleAddSource::fromGeoJson(batch.id, sourceData(batch));
+
+        if (batch.added)
+            continue;
+
+        changes << QMapboxGLStyleAddLayer::fromSource(batch.id, batch.type, m_before);
+
+        if (batch.type == QMapbox::Feature::LineStringType) {
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetPaintProperty(batch.id, QStringLiteral("line-opacity"), identityFunction(QStringLiteral("opacity"))));
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetPaintProperty(batch.id, QStringLiteral("line-color"), identityFunction(QStringLiteral("color"))));
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetPaintProperty(batch.id, QStringLiteral("line-width"), batch.lineWidth));
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetLayoutProperty(batch.id, QStringLiteral("line-cap"), QStringLiteral("square")));
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetLayoutProperty(batch.id, QStringLiteral("line-join"), QStringLiteral("bevel")));
+        } else {
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetPaintProperty(batch.id, QStringLiteral("fill-opacity"), identityFunction(QStringLiteral("opacity"))));
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetPaintProperty(batch.id, QStringLiteral("fill-color"), identityFunction(QStringLiteral("color"))));
+            changes << QSharedPointer<QMapboxGLStyleChange>(
+                new QMapboxGLStyleSetPaintProperty(batch.id, QStringLiteral("fill-outline-color"), identityFunction(QStringLiteral("outline-color"))));
+        }
+
+        batch.added = true;
+    }
+
+    return changes;
+}
+
+int QMapboxGLMapItemBatcher::batchFor(const QByteArray &key, QMapbox::Feature::Type type, qreal lineWidth)
+{
+    int unused = -1;
+
+    for (int i = 0; i < m_batches.size(); ++i) {
+        const Batch &batch = m_batches.at(i);
+        if (batch.key == key && batch.items.size() < MaxFeaturesPerBatch)
+            return i;
+        if (unused < 0 && batch.items.isEmpty() && !batch.added && !batch.dirty)
+            unused = i;
+    }
+
+    if (unused < 0) {
+        unused = m_batches.size();
+        m_batches.append(Batch());
+        m_batches.last().id = QStringLiteral("QtLocation-batch-") + QString::number(unused);
+    }
+
+    Batch &batch = m_batches[unused];
+    batch.key = key;
+    batch.type = type;
+    batch.lineWidth = lineWidth;
+
+    return unused;
+}
+
+void QMapboxGLMapItemBatcher::detach(const Entry &entry)
+{
+    if (entry.batch < 0)
+        return;
+
+    Batch &batch = m_batches[entry.batch];
+    batch.items.remove(entry.serial);
+    batch.dirty = true;
+}
+
+QByteArray QMapboxGLMapItemBatcher::sourceData(const Batch &batch) const
+{
+    QByteArray json = "{\"type\":\"FeatureCollection\",\"features\":[";
+    bool first = true;
+
+    for (QDeclarativeGeoMapItemBase *item : batch.items) {
+        const Entry &entry = *m_entries.constFind(item);
+        if (entry.geometry.isEmpty() || !item->isVisible())
+            continue;
+
+        if (!first)
+            json += ',';
+        first = false;
+
+        json += "{\"type\":\"Feature\",\"properties\":";
+        json += entry.properties;
+        json += ",\"geometry\":";
+        json += entry.geometry;
+        json += '}';
+    }
+
+    json += "]}";
+
+    return json;
+}
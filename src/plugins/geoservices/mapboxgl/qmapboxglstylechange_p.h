@@ -37,7 +37,10 @@
 #ifndef QQMAPBOXGLSTYLECHANGE_P_H
 #define QQMAPBOXGLSTYLECHANGE_P_H
 
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
 #include <QtCore/QList>
+#include <QtCore/QMap>
 #include <QtCore/QSharedPointer>
 #include <QtCore/QString>
 #include <QtCore/QVariant>
@@ -70,13 +73,14 @@ public:
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapParameter(QGeoMapParameter *);
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItem(QDeclarativeGeoMapItemBase *);
 
+    QMapboxGLStyleSetLayoutProperty(const QString &layer, const QString &property, const QVariant &value);
+
     void apply(QMapboxGL *map) Q_DECL_OVERRIDE;
 
 private:
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItem(QDeclarativePolylineMapItem *);
 
     QMapboxGLStyleSetLayoutProperty() = default;
-    QMapboxGLStyleSetLayoutProperty(const QString &layer, const QString &property, const QVariant &value);
 
     QString m_layer;
     QString m_property;
@@ -89,6 +93,8 @@ public:
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapParameter(QGeoMapParameter *);
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItem(QDeclarativeGeoMapItemBase *);
 
+    QMapboxGLStyleSetPaintProperty(const QString &layer, const QString &property, const QVariant &value);
+
     void apply(QMapboxGL *map) Q_DECL_OVERRIDE;
 
 private:
@@ -98,7 +104,6 @@ private:
     static QList<QSharedPointer<QMapboxGLStyleChange>> fromMapItem(QDeclarativePolylineMapItem *);
 
     QMapboxGLStyleSetPaintProperty() = default;
-    QMapboxGLStyleSetPaintProperty(const QString &layer, const QString &property, const QVariant &value);
 
     QString m_layer;
     QString m_property;
@@ -110,6 +115,7 @@ class QMapboxGLStyleAddLayer : public QMapboxGLStyleChange
 public:
     static QSharedPointer<QMapboxGLStyleChange> fromMapParameter(QGeoMapParameter *);
     static QSharedPointer<QMapboxGLStyleChange> fromFeature(const QMapbox::Feature &feature, const QString &before);
+    static QSharedPointer<QMapboxGLStyleChange> fromSource(const QString &source, QMapbox::Feature::Type type, const QString &before);
 
     void apply(QMapboxGL *map) Q_DECL_OVERRIDE;
 
@@ -139,6 +145,7 @@ public:
     static QSharedPointer<QMapboxGLStyleChange> fromMapParameter(QGeoMapParameter *);
     static QSharedPointer<QMapboxGLStyleChange> fromFeature(const QMapbox::Feature &feature);
     static QSharedPointer<QMapboxGLStyleChange> fromMapItem(QDeclarativeGeoMapItemBase *);
+    static QSharedPointer<QMapboxGLStyleChange> fromGeoJson(const QString &id, const QByteArray &data);
 
     void apply(QMapboxGL *map) Q_DECL_OVERRIDE;
 
@@ -190,4 +197,54 @@ private:
     QImage m_sprite;
 };
 
+// Groups map items with compatible paint properties into shared GeoJSON
+// sources and layers, using data driven styling for the per item colors.
+// Every batch holds a bounded number of features, so an update of a single
+// item only re-uploads the source of the batch it belongs to.
+class QMapboxGLMapItemBatcher
+{
+public:
+    enum { MaxFeaturesPerBatch = 256 };
+
+    void setBefore(const QString &before);
+
+    void addMapItem(QDeclarativeGeoMapItemBase *item);
+    void removeMapItem(QDeclarativeGeoMapItemBase *item);
+    void updateMapItem(QDeclarativeGeoMapItemBase *item);
+    void updateMapItemGeometry(QDeclarativeGeoMapItemBase *item);
+
+    // The style was reloaded, all the batches have to be added again.
+    void reset();
+
+    int batchCount() const;
+    QList<QSharedPointer<QMapboxGLStyleChange>> takeStyleChanges();
+
+private:
+    struct Entry {
+        int batch = -1;
+        quint64 serial = 0;
+        QByteArray geometry;
+        QByteArray properties;
+    };
+
+    struct Batch {
+        QString id;
+        QByteArray key;
+        QMapbox::Feature::Type type = QMapbox::Feature::PolygonType;
+        qreal lineWidth = 0.0;
+        QMap<quint64, QDeclarativeGeoMapItemBase *> items;
+        bool added = false;
+        bool dirty = false;
+    };
+
+    int batchFor(const QByteArray &key, QMapbox::Feature::Type type, qreal lineWidth);
+    void detach(const Entry &entry);
+    QByteArray sourceData(const Batch &batch) const;
+
+    QString m_before;
+    QHash<QDeclarativeGeoMapItemBase *, Entry> m_entries;
+    QList<Batch> m_batches;
+    quint64 m_serial = 0;
+};
+
 #endif // QQMAPBOXGLSTYLECHANGE_P_H
@@ -0,0 +1,22 @@
+TARGET = qtgeoservices_offline
+
+QT += location-private positioning-private concurrent
+
+HEADERS += \
+    qgeoserviceproviderpluginoffline.h \
+    qgeoroutingmanagerengineoffline.h \
+    qgeoroutereplyoffline.h \
+    qgeoroutinggraphoffline.h
+
+SOURCES += \
+    qgeoserviceproviderpluginoffline.cpp \
+    qgeoroutingmanagerengineoffline.cpp \
+    qgeoroutereplyoffline.cpp \
+    qgeoroutinggraphoffline.cpp
+
+OTHER_FILES += \
+    offline_plugin.json
+
+PLUGIN_TYPE = geoservices
+PLUGIN_CLASS_NAME = QGeoServiceProviderFactoryOffline
+load(qt_plugin)
@@ -0,0 +1,382 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutereplyoffline.h"
+#include "qgeoroutinggraphoffline.h"
+#include "QtLocation/private/qgeorouteparserosrmv5_p.h"
+
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QGeoRoutingGraphFormat;
+
+namespace {
+
+bool selectProfile(QGeoRouteRequest::TravelModes modes, Profile *profile,
+                   QGeoRouteRequest::TravelMode *mode, QString *modeName)
+{
+    if (modes & QGeoRouteRequest::CarTravel) {
+        *profile = CarProfile;
+        *mode = QGeoRouteRequest::CarTravel;
+        *modeName = QStringLiteral("driving");
+    } else if (modes & QGeoRouteRequest::BicycleTravel) {
+        *profile = BicycleProfile;
+        *mode = QGeoRouteRequest::BicycleTravel;
+        *modeName = QStringLiteral("cycling");
+    } else if (modes & QGeoRouteRequest::PedestrianTravel) {
+        *profile = FootProfile;
+        *mode = QGeoRouteRequest::PedestrianTravel;
+        *modeName = QStringLiteral("walking");
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void appendPolylineValue(QByteArray *polyline, int value)
+{
+    quint32 v = value < 0 ? ~(quint32(value) << 1) : quint32(value) << 1;
+    while (v >= 0x20) {
+        polyline->append(char((0x20 | (v & 0x1f)) + 63));
+        v >>= 5;
+    }
+    polyline->append(char(v + 63));
+}
+
+// Precision 5 polyline, the "polyline" geometry format of OSRM.
+QString encodePolyline(const QGeoRoutingGraphOffline &graph, const QVector<quint32> &nodes,
+                       int begin, int end)
+{
+    QByteArray polyline;
+    int latitude = 0;
+    int longitude = 0;
+    for (int i = begin; i <= end; ++i) {
+        const QGeoCoordinate c = graph.coordinate(nodes.at(i));
+        const int lat = qRound(c.latitude() * 1e5);
+        const int lon = qRound(c.longitude() * 1e5);
+        appendPolylineValue(&polyline, lat - latitude);
+        appendPolylineValue(&polyline, lon - longitude);
+        latitude = lat;
+        longitude = lon;
+    }
+    return QString::fromLatin1(polyline);
+}
+
+QJsonArray location(const QGeoRoutingGraphOffline &graph, quint32 node)
+{
+    const QGeoCoordinate c = graph.coordinate(node);
+    return QJsonArray() << c.longitude() << c.latitude();
+}
+
+// Turn angle in degrees, positive to the right.
+QString turnModifier(double angle)
+{
+    const double a = qAbs(angle);
+    const QString side = angle > 0 ? QStringLiteral("right") : QStringLiteral("left");
+    if (a < 20.0)
+        return QStringLiteral("straight");
+    if (a < 45.0)
+        return QStringLiteral("slight ") + side;
+    if (a < 135.0)
+        return side;
+    if (a < 170.0)
+        return QStringLiteral("sharp ") + side;
+    return QStringLiteral("uturn");
+}
+
+double turnAngle(double bearingBefore, double bearingAfter)
+{
+    double angle = bearingAfter - bearingBefore;
+    while (angle > 180.0)
+        angle -= 360.0;
+    while (angle <= -180.0)
+        angle += 360.0;
+    return angle;
+}
+
+QJsonObject osrmStep(const QGeoRoutingGraphOffline &graph, const QVector<quint32> &nodes,
+                     int begin, int end, const QString &type, const QString &modifier,
+                     double bearingBefore, double bearingAfter, const QString &name,
+                     const QString &mode, double distance, double duration)
+{
+    QJsonObject maneuver;
+    maneuver.insert(QStringLiteral("location"), location(graph, nodes.at(begin)));
+    maneuver.insert(QStringLiteral("bearing_before"), qRound(bearingBefore));
+    maneuver.insert(QStringLiteral("bearing_after"), qRound(bearingAfter));
+    maneuver.insert(QStringLiteral("type"), type);
+    if (!modifier.isEmpty())
+        maneuver.insert(QStringLiteral("modifier"), modifier);
+
+    QJsonObject intersection;
+    intersection.insert(QStringLiteral("location"), location(graph, nodes.at(begin)));
+    intersection.insert(QStringLiteral("bearings"), QJsonArray() << qRound(bearingAfter));
+    intersection.insert(QStringLiteral("entry"), QJsonArray() << true);
+    intersection.insert(QStringLiteral("out"), 0);
+
+    QJsonObject step;
+    step.insert(QStringLiteral("maneuver"), maneuver);
+    step.insert(QStringLiteral("intersections"), QJsonArray() << intersection);
+    step.insert(QStringLiteral("geometry"), encodePolyline(graph, nodes, begin, end));
+    step.insert(QStringLiteral("name"), name);
+    step.insert(QStringLiteral("mode"), mode);
+    step.insert(QStringLiteral("distance"), distance);
+    step.insert(QStringLiteral("duration"), duration);
+    step.insert(QStringLiteral("weight"), duration);
+    return step;
+}
+
+// Splits a leg into steps where the road name changes or the road turns,
+// and describes each step the way OSRM v5 does.
+QJsonObject osrmLeg(const QGeoRoutingGraphOffline &graph, Profile profile, const QString &mode,
+                    const QGeoRoutingGraphOffline::Path &path, double *distance, double *duration)
+{
+    const int count = path.arcs.size();
+    QVector<quint32> nodes;
+    nodes.reserve(count + 1);
+    nodes.append(path.source);
+    QVector<double> bearings;
+    bearings.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const quint32 target = graph.arc(path.arcs.at(i)).target;
+        bearings.append(graph.coordinate(nodes.last()).azimuthTo(graph.coordinate(target)));
+        nodes.append(target);
+    }
+
+    QJsonArray steps;
+    double legDistance = 0.0;
+    double legDuration = 0.0;
+    int begin = 0;
+    QString type = QStringLiteral("depart");
+    QString modifier;
+    do {
+        int end = begin + 1;
+        double stepDistance = 0.0;
+        double stepDuration = 0.0;
+        QString nextType;
+        QString nextModifier;
+        for (; end <= count; ++end) {
+            const Arc &arc = graph.arc(path.arcs.at(end - 1));
+            stepDistance += arc.length / 10.0;
+            stepDuration += arcDuration(profile, arc) / 1000.0;
+            if (end == count)
+                break;
+            const Arc &next = graph.arc(path.arcs.at(end));
+            const double angle = turnAngle(bearings.at(end - 1), bearings.at(end));
+            const QString m = turnModifier(angle);
+            if (next.name != arc.name) {
+                nextType = m == QLatin1String("straight") ? QStringLiteral("new name") : QStringLiteral("turn");
+                nextModifier = m;
+                break;
+            }
+            if (qAbs(angle) >= 45.0) {
+                nextType = QStringLiteral("continue");
+                nextModifier = m;
+                break;
+            }
+        }
+
+        const quint32 nameIndex = count ? graph.arc(path.arcs.at(begin)).name : 0;
+        end = qMin(end, count);
+        steps.append(osrmStep(graph, nodes, begin, end, type, modifier,
+                              begin > 0 ? bearings.at(begin - 1) : 0.0,
+                              count ? bearings.at(begin) : 0.0,
+                              graph.name(nameIndex), mode, stepDistance, stepDuration));
+        legDistance += stepDistance;
+        legDuration += stepDuration;
+        begin = end;
+        type = nextType;
+        modifier = nextModifier;
+    } while (begin < count);
+
+    const quint32 lastName = count ? graph.arc(path.arcs.last()).name : 0;
+    steps.append(osrmStep(graph, nodes, count, count, QStringLiteral("arrive"), QString(),
+                          count ? bearings.last() : 0.0, 0.0, graph.name(lastName), mode, 0.0, 0.0));
+
+    QJsonObject leg;
+    leg.insert(QStringLiteral("steps"), steps);
+    leg.insert(QStringLiteral("summary"), QString());
+    leg.insert(QStringLiteral("distance"), legDistance);
+    leg.insert(QStringLiteral("duration"), legDuration);
+    leg.insert(QStringLiteral("weight"), legDuration);
+    *distance += legDistance;
+    *duration += legDuration;
+    return leg;
+}
+
+QByteArray osrmError(const QString &code, const QString &message)
+{
+    QJsonObject response;
+    response.insert(QStringLiteral("code"), code);
+    response.insert(QStringLiteral("message"), message);
+    return QJsonDocument(response).toJson(QJsonDocument::Compact);
+}
+
+} // namespace
+
+QGeoRouteReplyOffline::QGeoRouteReplyOffline(const QSharedPointer<const QGeoRoutingGraphOffline> &graph,
+                                             const QGeoRouteRequest &request, QObject *parent)
+:   QGeoRouteReply(request, parent)
+{
+    connect(&m_watcher, SIGNAL(finished()), this, SLOT(calculationFinished()));
+    connect(this, SIGNAL(aborted()), this, SLOT(calculationAborted()));
+    m_watcher.setFuture(QtConcurrent::run(&QGeoRouteReplyOffline::calculateRoutes, graph, request));
+}
+
+QGeoRouteReplyOffline::~QGeoRouteReplyOffline()
+{
+}
+
+/*
+    Answers \a request the way an OSRM v5 server would, so that the routes can
+    be read by QGeoRouteParserOsrmV5 and carry the same maneuvers and
+    instructions as the ones of the osm plugin.
+*/
+QByteArray QGeoRouteReplyOffline::osrmResponse(const QGeoRoutingGraphOffline &graph,
+                                               const QGeoRouteRequest &request)
+{
+    Profile profile;
+    QGeoRouteRequest::TravelMode travelMode;
+    QString mode;
+    if (!selectProfile(request.travelModes(), &profile, &travelMode, &mode))
+        return osrmError(QStringLiteral("InvalidOptions"), QStringLiteral("Unsupported travel mode"));
+
+    const QList<QGeoCoordinate> waypoints = request.waypoints();
+    if (waypoints.size() < 2)
+        return osrmError(QStringLiteral("InvalidQuery"), QStringLiteral("At least two waypoints are required"));
+
+    QVector<quint32> nodes;
+    QJsonArray osrmWaypoints;
+    for (const QGeoCoordinate &waypoint : waypoints) {
+        const quint32 node = graph.nearestNode(waypoint, profile);
+        if (node == NoNode)
+            return osrmError(QStringLiteral("NoSegment"), QStringLiteral("Could not find a matching segment"));
+        nodes.append(node);
+
+        QJsonObject w;
+        w.insert(QStringLiteral("location"), location(graph, node));
+        w.insert(QStringLiteral("name"), QString());
+        osrmWaypoints.append(w);
+    }
+
+    const QGeoRouteRequest::RouteOptimizations optimization = request.routeOptimization();
+    const bool shortest = (optimization & QGeoRouteRequest::ShortestRoute)
+            && !(optimization & QGeoRouteRequest::FastestRoute);
+    const QList<QGeoRectangle> excludeAreas = request.excludeAreas();
+
+    QJsonArray legs;
+    QVector<quint32> routeNodes;
+    double distance = 0.0;
+    double duration = 0.0;
+    for (int i = 0; i + 1 < nodes.size(); ++i) {
+        QGeoRoutingGraphOffline::Path path;
+        bool found;
+        if (shortest) {
+            found = graph.searchPath(nodes.at(i), nodes.at(i + 1), profile,
+                                     QGeoRoutingGraphOffline::DistanceMetric, excludeAreas, &path);
+        } else {
+            // The hierarchy knows nothing about excluded areas, but its route is
+            // still the fastest one whenever it stays clear of them.
+            found = graph.contractedPath(nodes.at(i), nodes.at(i + 1), profile, &path);
+            if (found && graph.crossesAreas(path, excludeAreas)) {
+                found = graph.searchPath(nodes.at(i), nodes.at(i + 1), profile,
+                                         QGeoRoutingGraphOffline::TimeMetric, excludeAreas, &path);
+            }
+        }
+        if (!found)
+            return osrmError(QStringLiteral("NoRoute"), QStringLiteral("No route found"));
+
+        if (routeNodes.isEmpty())
+            routeNodes.append(path.source);
+        for (quint32 arc : path.arcs)
+            routeNodes.append(graph.arc(arc).target);
+        legs.append(osrmLeg(graph, profile, mode, path, &distance, &duration));
+    }
+
+    QJsonObject route;
+    route.insert(QStringLiteral("legs"), legs);
+    route.insert(QStringLiteral("geometry"), encodePolyline(graph, routeNodes, 0, routeNodes.size() - 1));
+    route.insert(QStringLiteral("distance"), distance);
+    route.insert(QStringLiteral("duration"), duration);
+    route.insert(QStringLiteral("weight_name"), QStringLiteral("duration"));
+    route.insert(QStringLiteral("weight"), duration);
+
+    QJsonObject response;
+    response.insert(QStringLiteral("code"), QStringLiteral("Ok"));
+    response.insert(QStringLiteral("routes"), QJsonArray() << route);
+    response.insert(QStringLiteral("waypoints"), osrmWaypoints);
+    return QJsonDocument(response).toJson(QJsonDocument::Compact);
+}
+
+QGeoRouteReplyOffline::Result QGeoRouteReplyOffline::calculateRoutes(QSharedPointer<const QGeoRoutingGraphOffline> graph,
+                                                                     QGeoRouteRequest request)
+{
+    Result result;
+    QGeoRouteParserOsrmV5 parser;
+    result.error = parser.parseReply(result.routes, result.errorString, osrmResponse(*graph, request));
+
+    Profile profile;
+    QGeoRouteRequest::TravelMode travelMode;
+    QString mode;
+    if (selectProfile(request.travelModes(), &profile, &travelMode, &mode)) {
+        for (QGeoRoute &route : result.routes) {
+            route.setRequest(request);
+            route.setTravelMode(travelMode);
+        }
+    }
+    return result;
+}
+
+void QGeoRouteReplyOffline::calculationFinished()
+{
+    const Result result = m_watcher.result();
+    if (result.error == QGeoRouteReply::NoError) {
+        setRoutes(result.routes);
+        setFinished(true);
+    } else {
+        setError(result.error, result.errorString);
+    }
+}
+
+void QGeoRouteReplyOffline::calculationAborted()
+{
+    m_watcher.disconnect(this);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,80 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEREPLYOFFLINE_H
+#define QGEOROUTEREPLYOFFLINE_H
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QSharedPointer>
+#include <QtLocation/QGeoRouteReply>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoRoutingGraphOffline;
+
+class QGeoRouteReplyOffline : public QGeoRouteReply
+{
+    Q_OBJECT
+
+public:
+    struct Result {
+        Result() : error(QGeoRouteReply::NoError) {}
+
+        QGeoRouteReply::Error error;
+        QString errorString;
+        QList<QGeoRoute> routes;
+    };
+
+    QGeoRouteReplyOffline(const QSharedPointer<const QGeoRoutingGraphOffline> &graph,
+                          const QGeoRouteRequest &request, QObject *parent = 0);
+    ~QGeoRouteReplyOffline();
+
+    static QByteArray osrmResponse(const QGeoRoutingGraphOffline &graph,
+                                   const QGeoRouteRequest &request);
+    static Result calculateRoutes(QSharedPointer<const QGeoRoutingGraphOffline> graph,
+                                  QGeoRouteRequest request);
+
+private Q_SLOTS:
+    void calculationFinished();
+    void calculationAborted();
+
+private:
+    QFutureWatcher<Result> m_watcher;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOROUTEREPLYOFFLINE_H
@@ -0,0 +1,545 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutinggraphbuilderoffline.h"
+
+#include <QtCore/QSaveFile>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QGeoRoutingGraphFormat;
+
+namespace {
+
+// Builds a contraction hierarchy: nodes are contracted in order of importance,
+// adding shortcuts wherever a local witness search finds no path that is at
+// least as short as the one through the contracted node.
+class Contractor
+{
+public:
+    struct Edge {
+        quint32 source;
+        quint32 target;
+        quint32 weight;
+        quint32 first;
+        quint32 second;
+        bool alive;
+    };
+
+    explicit Contractor(quint32 nodeCount)
+        : m_out(nodeCount), m_in(nodeCount), m_rank(nodeCount, NoNode),
+          m_level(nodeCount, 0), m_deleted(nodeCount, 0),
+          m_distance(nodeCount, 0), m_stamp(nodeCount, 0), m_currentStamp(0)
+    {
+    }
+
+    void addEdge(quint32 source, quint32 target, quint32 weight, quint32 arc)
+    {
+        if (source != target)
+            insertEdge(source, target, weight, arc, ChEdge::NoEdge);
+    }
+
+    void contract()
+    {
+        typedef std::pair<int, quint32> Item;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item> > queue;
+        for (quint32 v = 0; v < quint32(m_rank.size()); ++v)
+            queue.push(Item(priority(v), v));
+
+        quint32 next = 0;
+        std::vector<Shortcut> shortcuts;
+        while (!queue.empty()) {
+            const quint32 v = queue.top().second;
+            queue.pop();
+            if (m_rank[v] != NoNode)
+                continue;
+
+            // Lazy update: priorities of neighbours change as nodes get contracted.
+            const int p = priority(v);
+            if (!queue.empty() && p > queue.top().first) {
+                queue.push(Item(p, v));
+                continue;
+            }
+
+            shortcuts.clear();
+            findShortcuts(v, ContractionSettleLimit, &shortcuts);
+            for (const Shortcut &s : shortcuts)
+                insertEdge(s.source, s.target, s.weight, s.first, s.second);
+
+            for (const Adjacent &a : m_out[v]) {
+                detach(&m_in[a.node], v);
+                touch(a.node, v);
+            }
+            for (const Adjacent &a : m_in[v]) {
+                detach(&m_out[a.node], v);
+                touch(a.node, v);
+            }
+            std::vector<Adjacent>().swap(m_out[v]);
+            std::vector<Adjacent>().swap(m_in[v]);
+            m_rank[v] = next++;
+        }
+    }
+
+    const std::vector<Edge> &edges() const { return m_edges; }
+    const std::vector<quint32> &ranks() const { return m_rank; }
+
+private:
+    enum {
+        PrioritySettleLimit = 50,
+        ContractionSettleLimit = 1000
+    };
+
+    struct Adjacent {
+        quint32 node;
+        quint32 weight;
+        quint32 edge;
+    };
+
+    struct Shortcut {
+        quint32 source;
+        quint32 target;
+        quint32 weight;
+        quint32 first;
+        quint32 second;
+    };
+
+    // Keeps at most one edge per direction between two nodes, the lightest.
+    void insertEdge(quint32 source, quint32 target, quint32 weight, quint32 first, quint32 second)
+    {
+        const Edge edge = { source, target, weight, first, second, true };
+        for (Adjacent &a : m_out[source]) {
+            if (a.node != target)
+                continue;
+            if (a.weight <= weight)
+                return;
+            m_edges[a.edge].alive = false;
+            a.weight = weight;
+            a.edge = quint32(m_edges.size());
+            for (Adjacent &b : m_in[target]) {
+                if (b.node == source) {
+                    b.weight = weight;
+                    b.edge = a.edge;
+                    break;
+                }
+            }
+            m_edges.push_back(edge);
+            return;
+        }
+
+        const Adjacent out = { target, weight, quint32(m_edges.size()) };
+        const Adjacent in = { source, weight, quint32(m_edges.size()) };
+        m_out[source].push_back(out);
+        m_in[target].push_back(in);
+        m_edges.push_back(edge);
+    }
+
+    static void detach(std::vector<Adjacent> *list, quint32 node)
+    {
+        for (size_t i = 0; i < list->size(); ++i) {
+            if ((*list)[i].node == node) {
+                (*list)[i] = list->back();
+                list->pop_back();
+                return;
+            }
+        }
+    }
+
+    void touch(quint32 node, quint32 contracted)
+    {
+        ++m_deleted[node];
+        m_level[node] = qMax(m_level[node], m_level[contracted] + 1);
+    }
+
+    void witnessSearch(quint32 source, quint32 via, quint32 maxWeight, int settleLimit)
+    {
+        typedef std::pair<quint32, quint32> Item;
+        if (++m_currentStamp == 0) {
+            std::fill(m_stamp.begin(), m_stamp.end(), 0);
+            m_currentStamp = 1;
+        }
+        m_heap.clear();
+        m_stamp[source] = m_currentStamp;
+        m_distance[source] = 0;
+        m_heap.push_back(Item(0, source));
+
+        int settled = 0;
+        while (!m_heap.empty()) {
+            std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<Item>());
+            const Item item = m_heap.back();
+            m_heap.pop_back();
+            if (item.first != m_distance[item.second])
+                continue;
+            if (item.first > maxWeight || ++settled > settleLimit)
+                break;
+            for (const Adjacent &a : m_out[item.second]) {
+                if (a.node == via)
+                    continue;
+                const quint64 distance = quint64(item.first) + a.weight;
+                if (distance > maxWeight)
+                    continue;
+                if (m_stamp[a.node] != m_currentStamp || distance < m_distance[a.node]) {
+                    m_stamp[a.node] = m_currentStamp;
+                    m_distance[a.node] = quint32(distance);
+                    m_heap.push_back(Item(quint32(distance), a.node));
+                    std::push_heap(m_heap.begin(), m_heap.end(), std::greater<Item>());
+                }
+            }
+        }
+    }
+
+    void findShortcuts(quint32 node, int settleLimit, std::vector<Shortcut> *shortcuts)
+    {
+        for (const Adjacent &in : m_in[node]) {
+            quint64 maxWeight = 0;
+            for (const Adjacent &out : m_out[node]) {
+                if (out.node != in.node)
+                    maxWeight = qMax(maxWeight, quint64(in.weight) + out.weight);
+            }
+            if (maxWeight == 0 || maxWeight >= std::numeric_limits<quint32>::max())
+                continue;
+
+            witnessSearch(in.node, node, quint32(maxWeight), settleLimit);
+            for (const Adjacent &out : m_out[node]) {
+                if (out.node == in.node)
+                    continue;
+                const quint32 weight = in.weight + out.weight;
+                if (m_stamp[out.node] == m_currentStamp && m_distance[out.node] <= weight)
+                    continue;
+                const Shortcut s = { in.node, out.node, weight, in.edge, out.edge };
+                shortcuts->push_back(s);
+            }
+        }
+    }
+
+    int priority(quint32 node)
+    {
+        m_shortcuts.clear();
+        findShortcuts(node, PrioritySettleLimit, &m_shortcuts);
+        const int edgeDifference = int(m_shortcuts.size()) - int(m_in[node].size() + m_out[node].size());
+        return 4 * edgeDifference + 2 * int(m_deleted[node]) + int(m_level[node]);
+    }
+
+    std::vector<std::vector<Adjacent> > m_out;
+    std::vector<std::vector<Adjacent> > m_in;
+    std::vector<Edge> m_edges;
+    std::vector<quint32> m_rank;
+    std::vector<quint32> m_level;
+    std::vector<quint32> m_deleted;
+
+    std::vector<quint32> m_distance;
+    std::vector<quint32> m_stamp;
+    quint32 m_currentStamp;
+    std::vector<std::pair<quint32, quint32> > m_heap;
+    std::vector<Shortcut> m_shortcuts;
+};
+
+struct SectionData {
+    SectionId id;
+    const void *data;
+    quint64 size;
+};
+
+template <typename T>
+SectionData sectionData(SectionId id, const std::vector<T> &data)
+{
+    const SectionData s = { id, data.data(), quint64(data.size()) * sizeof(T) };
+    return s;
+}
+
+} // namespace
+
+QGeoRoutingGraphBuilderOffline::QGeoRoutingGraphBuilderOffline()
+{
+    addName(QString());
+}
+
+quint32 QGeoRoutingGraphBuilderOffline::addNode(double latitude, double longitude)
+{
+    const Node node = { toFixed(latitude), toFixed(longitude) };
+    m_nodes.append(node);
+    return quint32(m_nodes.size() - 1);
+}
+
+quint32 QGeoRoutingGraphBuilderOffline::addName(const QString &name)
+{
+    QHash<QString, quint32>::const_iterator it = m_nameIds.constFind(name);
+    if (it != m_nameIds.constEnd())
+        return it.value();
+    const quint32 id = quint32(m_names.size());
+    m_names.append(name);
+    m_nameIds.insert(name, id);
+    return id;
+}
+
+void QGeoRoutingGraphBuilderOffline::addArc(quint32 source, quint32 target, int roadClass,
+                                            int access, quint32 name)
+{
+    Q_ASSERT(source < quint32(m_nodes.size()) && target < quint32(m_nodes.size()));
+    Q_ASSERT(name < quint32(m_names.size()));
+    const Node &a = m_nodes.at(int(source));
+    const Node &b = m_nodes.at(int(target));
+    const double meters = distance(fromFixed(a.latitude), fromFixed(a.longitude),
+                                   fromFixed(b.latitude), fromFixed(b.longitude));
+
+    BuildArc arc;
+    arc.source = source;
+    arc.arc.target = target;
+    arc.arc.length = quint32(qMin(qRound64(meters * 10.0), qint64(std::numeric_limits<quint32>::max())));
+    arc.arc.name = name;
+    arc.arc.roadClass = quint8(roadClass);
+    arc.arc.access = quint8(access);
+    arc.arc.reserved = 0;
+    m_arcs.append(arc);
+}
+
+int QGeoRoutingGraphBuilderOffline::nodeCount() const
+{
+    return m_nodes.size();
+}
+
+int QGeoRoutingGraphBuilderOffline::arcCount() const
+{
+    return m_arcs.size();
+}
+
+bool QGeoRoutingGraphBuilderOffline::write(const QString &fileName, QString *errorString) const
+{
+    const quint32 nodeCount = quint32(m_nodes.size());
+    const quint32 arcCount = quint32(m_arcs.size());
+    if (nodeCount > ChEdge::TargetMask) {
+        if (errorString)
+            *errorString = QStringLiteral("Too many nodes");
+        return false;
+    }
+
+    // Spatial grid, sized for a few nodes per cell. Nodes are renumbered in
+    // cell order so that nearby nodes share pages of the mapped file.
+    qint32 minLatitude = 0, maxLatitude = 0, minLongitude = 0, maxLongitude = 0;
+    for (quint32 i = 0; i < nodeCount; ++i) {
+        const Node &n = m_nodes.at(int(i));
+        if (i == 0 || n.latitude < minLatitude)
+            minLatitude = n.latitude;
+        if (i == 0 || n.latitude > maxLatitude)
+            maxLatitude = n.latitude;
+        if (i == 0 || n.longitude < minLongitude)
+            minLongitude = n.longitude;
+        if (i == 0 || n.longitude > maxLongitude)
+            maxLongitude = n.longitude;
+    }
+    const double latitudeSpan = qMax(fromFixed(maxLatitude - minLatitude), 1e-3);
+    const double longitudeSpan = qMax(fromFixed(maxLongitude - minLongitude), 1e-3);
+    const double cellSize = qBound(1e-3, qSqrt(latitudeSpan * longitudeSpan * 4.0 / qMax(1u, nodeCount)), 1.0);
+    const qint32 cell = toFixed(cellSize);
+    const quint32 columns = quint32((qint64(maxLongitude) - minLongitude) / cell) + 1;
+    const quint32 rows = quint32((qint64(maxLatitude) - minLatitude) / cell) + 1;
+    const quint32 cellCount = columns * rows;
+
+    std::vector<quint32> cellOf(nodeCount);
+    std::vector<quint32> gridIndex(cellCount + 1, 0);
+    for (quint32 i = 0; i < nodeCount; ++i) {
+        const Node &n = m_nodes.at(int(i));
+        const quint32 x = quint32((qint64(n.longitude) - minLongitude) / cell);
+        const quint32 y = quint32((qint64(n.latitude) - minLatitude) / cell);
+        cellOf[i] = y * columns + x;
+        ++gridIndex[cellOf[i] + 1];
+    }
+    for (quint32 c = 0; c < cellCount; ++c)
+        gridIndex[c + 1] += gridIndex[c];
+
+    std::vector<quint32> renumbered(nodeCount);
+    std::vector<Node> nodes(nodeCount);
+    std::vector<quint32> gridNodes(nodeCount);
+    {
+        std::vector<quint32> fill(gridIndex.begin(), gridIndex.end() - 1);
+        for (quint32 i = 0; i < nodeCount; ++i) {
+            const quint32 id = fill[cellOf[i]]++;
+            renumbered[i] = id;
+            nodes[id] = m_nodes.at(int(i));
+            gridNodes[id] = id;
+        }
+    }
+
+    // Arcs grouped by source.
+    std::vector<quint32> arcIndex(nodeCount + 1, 0);
+    for (const BuildArc &a : m_arcs)
+        ++arcIndex[renumbered[a.source] + 1];
+    for (quint32 i = 0; i < nodeCount; ++i)
+        arcIndex[i + 1] += arcIndex[i];
+    std::vector<Arc> arcs(arcCount);
+    std::vector<quint8> nodeProfiles(nodeCount, 0);
+    {
+        std::vector<quint32> fill(arcIndex.begin(), arcIndex.end() - 1);
+        std::vector<quint8> outgoing(nodeCount, 0);
+        std::vector<quint8> incoming(nodeCount, 0);
+        for (const BuildArc &a : m_arcs) {
+            const quint32 source = renumbered[a.source];
+            Arc &arc = arcs[fill[source]++];
+            arc = a.arc;
+            arc.target = renumbered[a.arc.target];
+            outgoing[source] |= arc.access;
+            incoming[arc.target] |= arc.access;
+        }
+        // Waypoints snap only to nodes that can be both left and reached.
+        for (quint32 i = 0; i < nodeCount; ++i)
+            nodeProfiles[i] = outgoing[i] & incoming[i];
+    }
+
+    std::vector<quint32> nameIndex(1, 0);
+    std::vector<char> nameData;
+    for (const QString &name : m_names) {
+        const QByteArray utf8 = name.toUtf8();
+        nameData.insert(nameData.end(), utf8.constBegin(), utf8.constEnd());
+        nameIndex.push_back(quint32(nameData.size()));
+    }
+
+    std::vector<quint32> chIndex[ProfileCount];
+    std::vector<ChEdge> chEdges[ProfileCount];
+    for (int p = 0; p < ProfileCount; ++p) {
+        const Profile profile = Profile(p);
+        Contractor contractor(nodeCount);
+        for (quint32 source = 0; source < nodeCount; ++source) {
+            for (quint32 i = arcIndex[source]; i < arcIndex[source + 1]; ++i) {
+                if (arcs[i].access & (1 << p))
+                    contractor.addEdge(source, arcs[i].target, arcDuration(profile, arcs[i]), i);
+            }
+        }
+        contractor.contract();
+
+        const std::vector<Contractor::Edge> &edges = contractor.edges();
+        const std::vector<quint32> &rank = contractor.ranks();
+        std::vector<quint32> &index = chIndex[p];
+        index.assign(nodeCount + 1, 0);
+        for (const Contractor::Edge &e : edges) {
+            if (e.alive)
+                ++index[(rank[e.source] < rank[e.target] ? e.source : e.target) + 1];
+        }
+        for (quint32 i = 0; i < nodeCount; ++i)
+            index[i + 1] += index[i];
+
+        std::vector<quint32> position(edges.size(), ChEdge::NoEdge);
+        std::vector<quint32> fill(index.begin(), index.end() - 1);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const Contractor::Edge &e = edges[i];
+            if (e.alive)
+                position[i] = fill[rank[e.source] < rank[e.target] ? e.source : e.target]++;
+        }
+
+        chEdges[p].resize(index[nodeCount]);
+        for (size_t i = 0; i < edges.size(); ++i) {
+            const Contractor::Edge &e = edges[i];
+            if (!e.alive)
+                continue;
+            ChEdge &edge = chEdges[p][position[i]];
+            edge.target = rank[e.source] < rank[e.target] ? e.target : e.source | ChEdge::BackwardFlag;
+            edge.weight = e.weight;
+            if (e.second == ChEdge::NoEdge) {
+                edge.first = e.first;
+                edge.second = ChEdge::NoEdge;
+            } else {
+                edge.first = position[e.first];
+                edge.second = position[e.second];
+            }
+        }
+    }
+
+    QVector<SectionData> sections;
+    sections << sectionData(NodeSection, nodes)
+             << sectionData(NodeProfileSection, nodeProfiles)
+             << sectionData(ArcIndexSection, arcIndex)
+             << sectionData(ArcSection, arcs)
+             << sectionData(NameIndexSection, nameIndex)
+             << sectionData(NameDataSection, nameData)
+             << sectionData(GridIndexSection, gridIndex)
+             << sectionData(GridNodeSection, gridNodes);
+    for (int p = 0; p < ProfileCount; ++p)
+        sections << sectionData(SectionId(ChIndexSection + p), chIndex[p]);
+    for (int p = 0; p < ProfileCount; ++p)
+        sections << sectionData(SectionId(ChEdgeSection + p), chEdges[p]);
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = Version;
+    header.sectionCount = quint32(sections.size());
+    header.nodeCount = nodeCount;
+    header.arcCount = arcCount;
+    header.nameCount = quint32(m_names.size());
+    header.gridLatitude = minLatitude;
+    header.gridLongitude = minLongitude;
+    header.gridCellSize = cell;
+    header.gridColumns = columns;
+    header.gridRows = rows;
+
+    QVector<Section> table;
+    quint64 offset = (sizeof(Header) + sections.size() * sizeof(Section) + 7) & ~quint64(7);
+    for (const SectionData &s : sections) {
+        const Section entry = { quint32(s.id), 0, offset, s.size };
+        table.append(entry);
+        offset = (offset + s.size + 7) & ~quint64(7);
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+    static const char padding[8] = { 0 };
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(table.constData()), table.size() * sizeof(Section));
+    file.write(padding, table.first().offset - file.pos());
+    for (int i = 0; i < sections.size(); ++i) {
+        file.write(static_cast<const char *>(sections.at(i).data), qint64(sections.at(i).size));
+        const quint64 end = i + 1 < table.size() ? table.at(i + 1).offset : (file.pos() + 7) & ~qint64(7);
+        file.write(padding, qint64(end) - file.pos());
+    }
+    if (!file.commit()) {
+        if (errorString)
+            *errorString = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,78 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTINGGRAPHBUILDEROFFLINE_H
+#define QGEOROUTINGGRAPHBUILDEROFFLINE_H
+
+#include "qgeoroutinggraphoffline.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+QT_BEGIN_NAMESPACE
+
+// Collects a road network and writes it, together with one contraction
+// hierarchy per profile, in the format read by QGeoRoutingGraphOffline.
+class QGeoRoutingGraphBuilderOffline
+{
+public:
+    QGeoRoutingGraphBuilderOffline();
+
+    quint32 addNode(double latitude, double longitude);
+    quint32 addName(const QString &name);
+    void addArc(quint32 source, quint32 target, int roadClass, int access, quint32 name = 0);
+
+    int nodeCount() const;
+    int arcCount() const;
+
+    bool write(const QString &fileName, QString *errorString = 0) const;
+
+private:
+    struct BuildArc {
+        quint32 source;
+        QGeoRoutingGraphFormat::Arc arc;
+    };
+
+    QVector<QGeoRoutingGraphFormat::Node> m_nodes;
+    QVector<BuildArc> m_arcs;
+    QStringList m_names;
+    QHash<QString, quint32> m_nameIds;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOROUTINGGRAPHBUILDEROFFLINE_H
@@ -0,0 +1,740 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutinggraphoffline.h"
+
+#include <QtPositioning/private/qlocationutils_p.h>
+
+#include <QtCore/QVarLengthArray>
+#include <QtCore/qmath.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QGeoRoutingGraphFormat;
+
+namespace QGeoRoutingGraphFormat
+{
+
+int defaultSpeed(Profile profile, int roadClass)
+{
+    static const quint8 speeds[ProfileCount][RoadClassCount] = {
+        // Motorway ...  TertiaryLink, Unclassified ... Service, Track ... Steps
+        { 110, 60, 90, 50, 70, 40, 60, 40, 50, 30, 40, 30, 10, 15, 10,  0,  0, 0, 0, 0 },
+        {   0,  0,  0,  0, 18, 18, 18, 18, 18, 18, 18, 18, 10, 15, 12, 18, 12, 0, 0, 0 },
+        {   0,  0,  0,  0,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5,  5, 5, 5, 3 }
+    };
+
+    if (profile < 0 || profile >= ProfileCount || roadClass < 0 || roadClass >= RoadClassCount)
+        return 0;
+    return speeds[profile][roadClass];
+}
+
+int defaultAccess(int roadClass)
+{
+    int access = 0;
+    for (int p = 0; p < ProfileCount; ++p) {
+        if (defaultSpeed(Profile(p), roadClass) > 0)
+            access |= 1 << p;
+    }
+    return access;
+}
+
+double distance(double lat1, double lon1, double lat2, double lon2)
+{
+    // Haversine, as in QGeoCoordinate::distanceTo()
+    const double dlat = qDegreesToRadians(lat2 - lat1);
+    const double dlon = qDegreesToRadians(lon2 - lon1);
+    const double sinLat = qSin(dlat / 2);
+    const double sinLon = qSin(dlon / 2);
+    const double a = sinLat * sinLat
+            + qCos(qDegreesToRadians(lat1)) * qCos(qDegreesToRadians(lat2)) * sinLon * sinLon;
+    return 2 * QLocationUtils::earthMeanRadius() * qAsin(qSqrt(qMin(1.0, a)));
+}
+
+quint32 arcDuration(Profile profile, const Arc &arc)
+{
+    // Roads opened to a profile by explicit access tags are taken at walking pace.
+    int speed = defaultSpeed(profile, arc.roadClass);
+    if (speed <= 0)
+        speed = 5;
+    const quint64 ms = (quint64(arc.length) * 360 + speed / 2) / speed;
+    return quint32(qBound<quint64>(1, ms, std::numeric_limits<quint32>::max()));
+}
+
+} // namespace QGeoRoutingGraphFormat
+
+namespace {
+
+int maximumSpeed(Profile profile)
+{
+    int speed = 5;
+    for (int c = 0; c < RoadClassCount; ++c)
+        speed = qMax(speed, defaultSpeed(profile, c));
+    return speed;
+}
+
+// Liang-Barsky test of a segment against a box in degrees.
+bool segmentIntersectsBox(double left, double right, double bottom, double top,
+                          double x1, double y1, double x2, double y2)
+{
+    double t0 = 0.0;
+    double t1 = 1.0;
+    const double dx = x2 - x1;
+    const double dy = y2 - y1;
+    const double p[4] = { -dx, dx, -dy, dy };
+    const double q[4] = { x1 - left, right - x1, y1 - bottom, top - y1 };
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0) {
+            if (q[i] < 0.0)
+                return false;
+            continue;
+        }
+        const double t = q[i] / p[i];
+        if (p[i] < 0.0) {
+            if (t > t1)
+                return false;
+            t0 = qMax(t0, t);
+        } else {
+            if (t < t0)
+                return false;
+            t1 = qMin(t1, t);
+        }
+    }
+    return true;
+}
+
+bool segmentIntersects(const QGeoRectangle &area, double lat1, double lon1, double lat2, double lon2)
+{
+    const double left = area.topLeft().longitude();
+    const double right = area.bottomRight().longitude();
+    const double bottom = area.bottomRight().latitude();
+    const double top = area.topLeft().latitude();
+    if (left <= right)
+        return segmentIntersectsBox(left, right, bottom, top, lon1, lat1, lon2, lat2);
+    return segmentIntersectsBox(left, 180.0, bottom, top, lon1, lat1, lon2, lat2)
+            || segmentIntersectsBox(-180.0, right, bottom, top, lon1, lat1, lon2, lat2);
+}
+
+} // namespace
+
+struct QGeoRoutingGraphOffline::SearchSpace
+{
+    struct Label {
+        quint32 stamp;
+        quint32 distance;
+        quint32 estimate;
+        quint32 parentNode;
+        quint32 parentEdge;
+    };
+
+    struct Entry {
+        quint32 key;
+        quint32 node;
+        bool operator>(const Entry &other) const { return key > other.key; }
+    };
+
+    class Heap
+    {
+    public:
+        bool isEmpty() const { return m_entries.empty(); }
+        quint32 topKey() const
+        {
+            return m_entries.empty() ? std::numeric_limits<quint32>::max() : m_entries.front().key;
+        }
+        void clear() { m_entries.clear(); }
+        void push(quint32 key, quint32 node)
+        {
+            const Entry entry = { key, node };
+            m_entries.push_back(entry);
+            std::push_heap(m_entries.begin(), m_entries.end(), std::greater<Entry>());
+        }
+        Entry pop()
+        {
+            std::pop_heap(m_entries.begin(), m_entries.end(), std::greater<Entry>());
+            const Entry entry = m_entries.back();
+            m_entries.pop_back();
+            return entry;
+        }
+
+    private:
+        std::vector<Entry> m_entries;
+    };
+
+    explicit SearchSpace(quint32 nodeCount)
+        : forward(nodeCount), backward(nodeCount), m_stamp(0)
+    {
+    }
+
+    // Labels are valid for the current search only when they carry its stamp,
+    // which saves clearing the arrays between queries.
+    quint32 nextStamp()
+    {
+        forwardHeap.clear();
+        backwardHeap.clear();
+        if (++m_stamp == 0) {
+            std::fill(forward.begin(), forward.end(), Label());
+            std::fill(backward.begin(), backward.end(), Label());
+            m_stamp = 1;
+        }
+        return m_stamp;
+    }
+
+    std::vector<Label> forward;
+    std::vector<Label> backward;
+    Heap forwardHeap;
+    Heap backwardHeap;
+
+private:
+    quint32 m_stamp;
+};
+
+QGeoRoutingGraphOffline::QGeoRoutingGraphOffline()
+:   m_data(0), m_size(0), m_header(0), m_nodes(0), m_nodeProfiles(0), m_arcIndex(0), m_arcs(0),
+    m_nameIndex(0), m_nameData(0), m_gridIndex(0), m_gridNodes(0)
+{
+    for (int p = 0; p < ProfileCount; ++p) {
+        m_chIndex[p] = 0;
+        m_chEdges[p] = 0;
+        m_chEdgeCount[p] = 0;
+    }
+}
+
+QGeoRoutingGraphOffline::~QGeoRoutingGraphOffline()
+{
+    qDeleteAll(m_searchSpaces);
+}
+
+bool QGeoRoutingGraphOffline::load(const QString &fileName)
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    Q_UNUSED(fileName)
+    m_errorString = QStringLiteral("Routing graphs can only be used on little endian hosts");
+    return false;
+#else
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = m_size > 0 ? m_file.map(0, m_size) : 0;
+    if (!m_data) {
+        m_errorString = QStringLiteral("Unable to map routing graph %1").arg(fileName);
+        m_file.close();
+        return false;
+    }
+
+    if (!validate()) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_file.close();
+        m_data = 0;
+        m_header = 0;
+        return false;
+    }
+    return true;
+#endif
+}
+
+QString QGeoRoutingGraphOffline::errorString() const
+{
+    return m_errorString;
+}
+
+template <typename T>
+const T *QGeoRoutingGraphOffline::section(SectionId id) const
+{
+    const Section *sections = reinterpret_cast<const Section *>(m_data + sizeof(Header));
+    for (quint32 i = 0; i < m_header->sectionCount; ++i) {
+        const Section &s = sections[i];
+        if (s.id != quint32(id))
+            continue;
+        if (s.offset % 8 != 0 || s.size % sizeof(T) != 0
+                || s.offset > quint64(m_size) || s.size > quint64(m_size) - s.offset) {
+            return 0;
+        }
+        return reinterpret_cast<const T *>(m_data + s.offset);
+    }
+    return 0;
+}
+
+static quint64 sectionSize(const uchar *data, SectionId id)
+{
+    const Header *header = reinterpret_cast<const Header *>(data);
+    const Section *sections = reinterpret_cast<const Section *>(data + sizeof(Header));
+    for (quint32 i = 0; i < header->sectionCount; ++i) {
+        if (sections[i].id == quint32(id))
+            return sections[i].size;
+    }
+    return 0;
+}
+
+static bool checkIndex(const quint32 *index, quint32 count, quint32 total)
+{
+    if (index[0] != 0 || index[count] != total)
+        return false;
+    for (quint32 i = 0; i < count; ++i) {
+        if (index[i] > index[i + 1])
+            return false;
+    }
+    return true;
+}
+
+bool QGeoRoutingGraphOffline::validate()
+{
+    m_errorString = QStringLiteral("Invalid routing graph %1").arg(m_file.fileName());
+
+    if (quint64(m_size) < sizeof(Header))
+        return false;
+    m_header = reinterpret_cast<const Header *>(m_data);
+    if (memcmp(m_header->magic, Magic, sizeof(Magic)) != 0)
+        return false;
+    if (m_header->version != Version) {
+        m_errorString = QStringLiteral("Unsupported routing graph version %1").arg(m_header->version);
+        return false;
+    }
+    if (m_header->sectionCount > (quint64(m_size) - sizeof(Header)) / sizeof(Section))
+        return false;
+
+    const Header &h = *m_header;
+    if (h.nodeCount > ChEdge::TargetMask || h.nameCount == 0
+            || h.gridColumns == 0 || h.gridRows == 0 || h.gridCellSize <= 0
+            || quint64(h.gridColumns) * h.gridRows >= std::numeric_limits<quint32>::max()) {
+        return false;
+    }
+
+    m_nodes = section<Node>(NodeSection);
+    m_nodeProfiles = section<quint8>(NodeProfileSection);
+    m_arcIndex = section<quint32>(ArcIndexSection);
+    m_arcs = section<Arc>(ArcSection);
+    m_nameIndex = section<quint32>(NameIndexSection);
+    m_nameData = section<char>(NameDataSection);
+    m_gridIndex = section<quint32>(GridIndexSection);
+    m_gridNodes = section<quint32>(GridNodeSection);
+    if (!m_nodes || !m_nodeProfiles || !m_arcIndex || !m_arcs || !m_nameIndex
+            || !m_nameData || !m_gridIndex || !m_gridNodes) {
+        return false;
+    }
+
+    const quint32 cellCount = h.gridColumns * h.gridRows;
+    if (sectionSize(m_data, NodeSection) != quint64(h.nodeCount) * sizeof(Node)
+            || sectionSize(m_data, NodeProfileSection) != h.nodeCount
+            || sectionSize(m_data, ArcIndexSection) != (quint64(h.nodeCount) + 1) * sizeof(quint32)
+            || sectionSize(m_data, ArcSection) != quint64(h.arcCount) * sizeof(Arc)
+            || sectionSize(m_data, NameIndexSection) != (quint64(h.nameCount) + 1) * sizeof(quint32)
+            || sectionSize(m_data, GridIndexSection) != (quint64(cellCount) + 1) * sizeof(quint32)
+            || sectionSize(m_data, GridNodeSection) != quint64(h.nodeCount) * sizeof(quint32)) {
+        return false;
+    }
+
+    if (!checkIndex(m_arcIndex, h.nodeCount, h.arcCount)
+            || !checkIndex(m_nameIndex, h.nameCount, m_nameIndex[h.nameCount])
+            || m_nameIndex[h.nameCount] > sectionSize(m_data, NameDataSection)
+            || !checkIndex(m_gridIndex, cellCount, h.nodeCount)) {
+        return false;
+    }
+    for (quint32 i = 0; i < h.arcCount; ++i) {
+        if (m_arcs[i].target >= h.nodeCount || m_arcs[i].name >= h.nameCount)
+            return false;
+    }
+    for (quint32 i = 0; i < h.nodeCount; ++i) {
+        if (m_gridNodes[i] >= h.nodeCount)
+            return false;
+    }
+
+    for (int p = 0; p < ProfileCount; ++p) {
+        m_chIndex[p] = section<quint32>(SectionId(ChIndexSection + p));
+        m_chEdges[p] = section<ChEdge>(SectionId(ChEdgeSection + p));
+        if (!m_chIndex[p] || (!m_chEdges[p] && sectionSize(m_data, SectionId(ChEdgeSection + p))))
+            return false;
+        if (sectionSize(m_data, SectionId(ChIndexSection + p)) != (quint64(h.nodeCount) + 1) * sizeof(quint32))
+            return false;
+        m_chEdgeCount[p] = quint32(sectionSize(m_data, SectionId(ChEdgeSection + p)) / sizeof(ChEdge));
+        if (!checkIndex(m_chIndex[p], h.nodeCount, m_chEdgeCount[p]))
+            return false;
+        for (quint32 i = 0; i < m_chEdgeCount[p]; ++i) {
+            const ChEdge &e = m_chEdges[p][i];
+            if ((e.target & ChEdge::TargetMask) >= h.nodeCount)
+                return false;
+            if (e.second == ChEdge::NoEdge ? e.first >= h.arcCount
+                                           : e.first >= m_chEdgeCount[p] || e.second >= m_chEdgeCount[p]) {
+                return false;
+            }
+        }
+    }
+
+    m_errorString.clear();
+    return true;
+}
+
+quint32 QGeoRoutingGraphOffline::nodeCount() const
+{
+    return m_header ? m_header->nodeCount : 0;
+}
+
+quint32 QGeoRoutingGraphOffline::arcCount() const
+{
+    return m_header ? m_header->arcCount : 0;
+}
+
+QGeoCoordinate QGeoRoutingGraphOffline::coordinate(quint32 node) const
+{
+    if (node >= nodeCount())
+        return QGeoCoordinate();
+    return QGeoCoordinate(fromFixed(m_nodes[node].latitude), fromFixed(m_nodes[node].longitude));
+}
+
+const Arc &QGeoRoutingGraphOffline::arc(quint32 index) const
+{
+    Q_ASSERT(index < arcCount());
+    return m_arcs[index];
+}
+
+QString QGeoRoutingGraphOffline::name(quint32 index) const
+{
+    if (!m_header || index >= m_header->nameCount)
+        return QString();
+    return QString::fromUtf8(m_nameData + m_nameIndex[index],
+                             int(m_nameIndex[index + 1] - m_nameIndex[index]));
+}
+
+quint32 QGeoRoutingGraphOffline::nearestNode(const QGeoCoordinate &coordinate, Profile profile) const
+{
+    if (!m_header || !coordinate.isValid() || nodeCount() == 0)
+        return NoNode;
+
+    const Header &h = *m_header;
+    const double latitude = coordinate.latitude();
+    const double longitude = coordinate.longitude();
+    const double cellSize = fromFixed(h.gridCellSize);
+    const int columns = int(h.gridColumns);
+    const int rows = int(h.gridRows);
+    const int cx = qBound(0, int(qFloor((longitude - fromFixed(h.gridLongitude)) / cellSize)), columns - 1);
+    const int cy = qBound(0, int(qFloor((latitude - fromFixed(h.gridLatitude)) / cellSize)), rows - 1);
+    const double cosLatitude = qMax(0.01, qCos(qDegreesToRadians(latitude)));
+    const quint8 mask = quint8(1 << profile);
+
+    // Distances are compared in an equirectangular projection around the query,
+    // scanning rings of grid cells until no closer node can exist.
+    quint32 best = NoNode;
+    double bestDistance = std::numeric_limits<double>::max();
+    const int maxRing = qMax(columns, rows);
+    for (int r = 0; r <= maxRing; ++r) {
+        if (best != NoNode && r > 1) {
+            const double bound = (r - 1) * cellSize * cosLatitude;
+            if (bound * bound > bestDistance)
+                break;
+        }
+        for (int y = cy - r; y <= cy + r; ++y) {
+            if (y < 0 || y >= rows)
+                continue;
+            const bool fullRow = (y == cy - r || y == cy + r);
+            const int step = fullRow ? 1 : 2 * r;
+            for (int x = cx - r; x <= cx + r; x += step) {
+                if (x >= 0 && x < columns) {
+                    const quint32 cell = quint32(y) * h.gridColumns + quint32(x);
+                    for (quint32 i = m_gridIndex[cell]; i < m_gridIndex[cell + 1]; ++i) {
+                        const quint32 node = m_gridNodes[i];
+                        if (!(m_nodeProfiles[node] & mask))
+                            continue;
+                        const double dy = fromFixed(m_nodes[node].latitude) - latitude;
+                        const double dx = (fromFixed(m_nodes[node].longitude) - longitude) * cosLatitude;
+                        const double distance = dx * dx + dy * dy;
+                        if (distance < bestDistance) {
+                            bestDistance = distance;
+                            best = node;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return best;
+}
+
+QGeoRoutingGraphOffline::SearchSpace *QGeoRoutingGraphOffline::acquireSearchSpace() const
+{
+    {
+        QMutexLocker locker(&m_searchSpaceMutex);
+        if (!m_searchSpaces.isEmpty()) {
+            SearchSpace *space = m_searchSpaces.last();
+            m_searchSpaces.removeLast();
+            return space;
+        }
+    }
+    return new SearchSpace(nodeCount());
+}
+
+void QGeoRoutingGraphOffline::releaseSearchSpace(SearchSpace *space) const
+{
+    QMutexLocker locker(&m_searchSpaceMutex);
+    m_searchSpaces.append(space);
+}
+
+void QGeoRoutingGraphOffline::unpackEdge(Profile profile, quint32 edge, QVector<quint32> *arcs) const
+{
+    const ChEdge *edges = m_chEdges[profile];
+    QVarLengthArray<quint32, 64> stack;
+    stack.append(edge);
+    // A valid hierarchy visits every edge at most once per unpacking.
+    quint32 budget = 2 * m_chEdgeCount[profile] + 1;
+    while (!stack.isEmpty() && budget--) {
+        const ChEdge &e = edges[stack.last()];
+        stack.removeLast();
+        if (e.second == ChEdge::NoEdge) {
+            arcs->append(e.first);
+        } else {
+            stack.append(e.second);
+            stack.append(e.first);
+        }
+    }
+}
+
+bool QGeoRoutingGraphOffline::contractedPath(quint32 source, quint32 target, Profile profile,
+                                             Path *path) const
+{
+    path->source = source;
+    path->arcs.clear();
+    path->weight = 0;
+    if (source >= nodeCount() || target >= nodeCount())
+        return false;
+    if (source == target)
+        return true;
+
+    typedef SearchSpace::Label Label;
+    const quint32 *index = m_chIndex[profile];
+    const ChEdge *edges = m_chEdges[profile];
+
+    SearchSpace *space = acquireSearchSpace();
+    const quint32 stamp = space->nextStamp();
+    Label *labels[2] = { space->forward.data(), space->backward.data() };
+    SearchSpace::Heap *heaps[2] = { &space->forwardHeap, &space->backwardHeap };
+    const Label start = { stamp, 0, 0, NoNode, ChEdge::NoEdge };
+    labels[0][source] = start;
+    labels[1][target] = start;
+    heaps[0]->push(0, source);
+    heaps[1]->push(0, target);
+
+    // Bidirectional upward search: the forward search relaxes edges leaving a
+    // node, the backward search edges entering it.
+    quint32 best = std::numeric_limits<quint32>::max();
+    quint32 meeting = NoNode;
+    for (;;) {
+        const quint32 forwardKey = heaps[0]->topKey();
+        const quint32 backwardKey = heaps[1]->topKey();
+        if (qMin(forwardKey, backwardKey) >= best)
+            break;
+        const int dir = forwardKey <= backwardKey ? 0 : 1;
+        const SearchSpace::Entry entry = heaps[dir]->pop();
+        const quint32 node = entry.node;
+        const Label &label = labels[dir][node];
+        if (entry.key != label.distance)
+            continue;
+
+        const Label &opposite = labels[1 - dir][node];
+        if (opposite.stamp == stamp && quint64(label.distance) + opposite.distance < best) {
+            best = label.distance + opposite.distance;
+            meeting = node;
+        }
+
+        const quint32 relaxed = dir == 0 ? 0 : quint32(ChEdge::BackwardFlag);
+        const quint32 begin = index[node];
+        const quint32 end = index[node + 1];
+
+        // Stall on demand: skip nodes that a higher node reaches more cheaply.
+        bool stalled = false;
+        for (quint32 i = begin; i < end; ++i) {
+            const ChEdge &edge = edges[i];
+            if ((edge.target & ChEdge::BackwardFlag) == relaxed)
+                continue;
+            const Label &other = labels[dir][edge.target & ChEdge::TargetMask];
+            if (other.stamp == stamp && quint64(other.distance) + edge.weight < label.distance) {
+                stalled = true;
+                break;
+            }
+        }
+        if (stalled)
+            continue;
+
+        for (quint32 i = begin; i < end; ++i) {
+            const ChEdge &edge = edges[i];
+            if ((edge.target & ChEdge::BackwardFlag) != relaxed)
+                continue;
+            const quint64 distance = quint64(label.distance) + edge.weight;
+            if (distance >= best)
+                continue;
+            const quint32 next = edge.target & ChEdge::TargetMask;
+            Label &nextLabel = labels[dir][next];
+            if (nextLabel.stamp != stamp || distance < nextLabel.distance) {
+                const Label reached = { stamp, quint32(distance), 0, node, i };
+                nextLabel = reached;
+                heaps[dir]->push(quint32(distance), next);
+            }
+        }
+    }
+
+    if (meeting == NoNode) {
+        releaseSearchSpace(space);
+        return false;
+    }
+
+    QVarLengthArray<quint32, 256> chain;
+    for (quint32 n = meeting; n != source; n = labels[0][n].parentNode)
+        chain.append(labels[0][n].parentEdge);
+    std::reverse(chain.begin(), chain.end());
+    for (quint32 n = meeting; n != target; n = labels[1][n].parentNode)
+        chain.append(labels[1][n].parentEdge);
+    releaseSearchSpace(space);
+
+    for (int i = 0; i < chain.size(); ++i)
+        unpackEdge(profile, chain.at(i), &path->arcs);
+    path->weight = best;
+    return true;
+}
+
+bool QGeoRoutingGraphOffline::arcExcluded(quint32 source, const Arc &arc,
+                                          const QList<QGeoRectangle> &areas) const
+{
+    const double lat1 = fromFixed(m_nodes[source].latitude);
+    const double lon1 = fromFixed(m_nodes[source].longitude);
+    const double lat2 = fromFixed(m_nodes[arc.target].latitude);
+    const double lon2 = fromFixed(m_nodes[arc.target].longitude);
+    for (const QGeoRectangle &area : areas) {
+        if (segmentIntersects(area, lat1, lon1, lat2, lon2))
+            return true;
+    }
+    return false;
+}
+
+bool QGeoRoutingGraphOffline::crossesAreas(const Path &path, const QList<QGeoRectangle> &areas) const
+{
+    if (areas.isEmpty() || path.source >= nodeCount())
+        return false;
+    quint32 node = path.source;
+    for (quint32 a : path.arcs) {
+        if (arcExcluded(node, m_arcs[a], areas))
+            return true;
+        node = m_arcs[a].target;
+    }
+    return false;
+}
+
+bool QGeoRoutingGraphOffline::searchPath(quint32 source, quint32 target, Profile profile,
+                                         Metric metric, const QList<QGeoRectangle> &excludeAreas,
+                                         Path *path) const
+{
+    path->source = source;
+    path->arcs.clear();
+    path->weight = 0;
+    if (source >= nodeCount() || target >= nodeCount())
+        return false;
+    if (source == target)
+        return true;
+
+    typedef SearchSpace::Label Label;
+    const quint8 mask = quint8(1 << profile);
+    const double targetLatitude = fromFixed(m_nodes[target].latitude);
+    const double targetLongitude = fromFixed(m_nodes[target].longitude);
+    // Lower bound of the remaining weight per meter, slightly reduced to stay
+    // admissible despite arc lengths being rounded to decimeters.
+    const double factor = 0.999 * (metric == TimeMetric ? 3600.0 / maximumSpeed(profile) : 10.0);
+    auto estimate = [&](quint32 node) {
+        const Node &n = m_nodes[node];
+        return quint32(factor * QGeoRoutingGraphFormat::distance(fromFixed(n.latitude),
+                                                                 fromFixed(n.longitude),
+                                                                 targetLatitude, targetLongitude));
+    };
+
+    SearchSpace *space = acquireSearchSpace();
+    const quint32 stamp = space->nextStamp();
+    Label *labels = space->forward.data();
+    SearchSpace::Heap &heap = space->forwardHeap;
+    const Label start = { stamp, 0, estimate(source), NoNode, ChEdge::NoEdge };
+    labels[source] = start;
+    heap.push(start.estimate, source);
+
+    bool found = false;
+    while (!heap.isEmpty()) {
+        const SearchSpace::Entry entry = heap.pop();
+        const quint32 node = entry.node;
+        const Label &label = labels[node];
+        if (entry.key != qMin<quint64>(quint64(label.distance) + label.estimate,
+                                       std::numeric_limits<quint32>::max())) {
+            continue;
+        }
+        if (node == target) {
+            found = true;
+            break;
+        }
+
+        for (quint32 i = m_arcIndex[node]; i < m_arcIndex[node + 1]; ++i) {
+            const Arc &arc = m_arcs[i];
+            if (!(arc.access & mask))
+                continue;
+            const quint64 distance = quint64(label.distance)
+                    + (metric == TimeMetric ? arcDuration(profile, arc) : arc.length);
+            if (distance >= std::numeric_limits<quint32>::max())
+                continue;
+            Label &next = labels[arc.target];
+            if (next.stamp == stamp && distance >= next.distance)
+                continue;
+            if (!excludeAreas.isEmpty() && arcExcluded(node, arc, excludeAreas))
+                continue;
+            const quint32 h = next.stamp == stamp ? next.estimate : estimate(arc.target);
+            const Label reached = { stamp, quint32(distance), h, node, i };
+            next = reached;
+            heap.push(quint32(qMin<quint64>(distance + h, std::numeric_limits<quint32>::max())),
+                      arc.target);
+        }
+    }
+
+    if (found) {
+        for (quint32 n = target; n != source; n = labels[n].parentNode)
+            path->arcs.append(labels[n].parentEdge);
+        std::reverse(path->arcs.begin(), path->arcs.end());
+        path->weight = labels[target].distance;
+    }
+    releaseSearchSpace(space);
+    return found;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,250 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTINGGRAPHOFFLINE_H
+#define QGEOROUTINGGRAPHOFFLINE_H
+
+#include <QtCore/QFile>
+#include <QtCore/QList>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+#include <QtPositioning/QGeoCoordinate>
+#include <QtPositioning/QGeoRectangle>
+
+QT_BEGIN_NAMESPACE
+
+namespace QGeoRoutingGraphFormat
+{
+    // The graph file is a little endian image that is mapped into memory as is.
+    // It starts with a Header, followed by Header::sectionCount Section entries.
+    // Every section is 8 byte aligned and holds a packed array of one of the
+    // structures below.
+    enum { Version = 1 };
+
+    enum Profile {
+        CarProfile = 0,
+        BicycleProfile,
+        FootProfile,
+        ProfileCount
+    };
+
+    enum Access {
+        CarAccess = 1 << CarProfile,
+        BicycleAccess = 1 << BicycleProfile,
+        FootAccess = 1 << FootProfile
+    };
+
+    enum RoadClass {
+        Motorway = 0,
+        MotorwayLink,
+        Trunk,
+        TrunkLink,
+        Primary,
+        PrimaryLink,
+        Secondary,
+        SecondaryLink,
+        Tertiary,
+        TertiaryLink,
+        Unclassified,
+        Residential,
+        LivingStreet,
+        Service,
+        Track,
+        Cycleway,
+        Path,
+        Footway,
+        Pedestrian,
+        Steps,
+        RoadClassCount
+    };
+
+    enum SectionId {
+        NodeSection = 0,        // Node[nodeCount]
+        NodeProfileSection,     // quint8[nodeCount], Access bits of the profiles a node can be snapped for
+        ArcIndexSection,        // quint32[nodeCount + 1], first outgoing arc of a node
+        ArcSection,             // Arc[arcCount]
+        NameIndexSection,       // quint32[nameCount + 1], offsets into the name data
+        NameDataSection,        // UTF-8 names
+        GridIndexSection,       // quint32[gridColumns * gridRows + 1], first node of a cell
+        GridNodeSection,        // quint32[nodeCount], nodes sorted by cell
+        ChIndexSection,         // quint32[nodeCount + 1] per profile, first upward edge of a node
+        ChEdgeSection = ChIndexSection + ProfileCount, // ChEdge[] per profile
+        SectionCount = ChEdgeSection + ProfileCount
+    };
+
+    struct Header {
+        char magic[8];
+        quint32 version;
+        quint32 sectionCount;
+        quint32 nodeCount;
+        quint32 arcCount;
+        quint32 nameCount;
+        qint32 gridLatitude;    // south west corner of the grid, in 1e-7 degrees
+        qint32 gridLongitude;
+        qint32 gridCellSize;    // in 1e-7 degrees
+        quint32 gridColumns;
+        quint32 gridRows;
+    };
+
+    struct Section {
+        quint32 id;
+        quint32 reserved;
+        quint64 offset;
+        quint64 size;
+    };
+
+    struct Node {
+        qint32 latitude;        // in 1e-7 degrees
+        qint32 longitude;
+    };
+
+    struct Arc {
+        quint32 target;
+        quint32 length;         // in decimeters
+        quint32 name;
+        quint8 roadClass;
+        quint8 access;
+        quint16 reserved;
+    };
+
+    // Contraction hierarchy edge, stored with the lower ranked of its two end
+    // points. Original edges reference the arc they represent in first, shortcuts
+    // reference the two edges they bypass, in travel order.
+    struct ChEdge {
+        enum {
+            BackwardFlag = 0x80000000u,   // travels from target to the owning node
+            TargetMask = 0x7fffffffu,
+            NoEdge = 0xffffffffu
+        };
+
+        quint32 target;
+        quint32 weight;         // in milliseconds
+        quint32 first;
+        quint32 second;
+    };
+
+    static const char Magic[8] = { 'Q', 'G', 'R', 'O', 'U', 'T', 'E', 'G' };
+    static const quint32 NoNode = 0xffffffffu;
+
+    inline qint32 toFixed(double degrees) { return qint32(qRound64(degrees * 1e7)); }
+    inline double fromFixed(qint32 value) { return value * 1e-7; }
+
+    // Speed in km/h, or 0 when the profile may not use the road class by default.
+    int defaultSpeed(Profile profile, int roadClass);
+    int defaultAccess(int roadClass);
+    quint32 arcDuration(Profile profile, const Arc &arc);
+    double distance(double lat1, double lon1, double lat2, double lon2);
+}
+
+class QGeoRoutingGraphOffline
+{
+public:
+    enum Metric {
+        TimeMetric,
+        DistanceMetric
+    };
+
+    struct Path {
+        Path() : source(QGeoRoutingGraphFormat::NoNode), weight(0) {}
+
+        quint32 source;
+        QVector<quint32> arcs;
+        quint32 weight;
+    };
+
+    QGeoRoutingGraphOffline();
+    ~QGeoRoutingGraphOffline();
+
+    bool load(const QString &fileName);
+    QString errorString() const;
+
+    quint32 nodeCount() const;
+    quint32 arcCount() const;
+    QGeoCoordinate coordinate(quint32 node) const;
+    const QGeoRoutingGraphFormat::Arc &arc(quint32 index) const;
+    QString name(quint32 index) const;
+
+    quint32 nearestNode(const QGeoCoordinate &coordinate,
+                        QGeoRoutingGraphFormat::Profile profile) const;
+
+    bool contractedPath(quint32 source, quint32 target,
+                        QGeoRoutingGraphFormat::Profile profile, Path *path) const;
+    bool searchPath(quint32 source, quint32 target,
+                    QGeoRoutingGraphFormat::Profile profile, Metric metric,
+                    const QList<QGeoRectangle> &excludeAreas, Path *path) const;
+    bool crossesAreas(const Path &path, const QList<QGeoRectangle> &areas) const;
+
+private:
+    struct SearchSpace;
+
+    template <typename T>
+    const T *section(QGeoRoutingGraphFormat::SectionId id) const;
+    bool validate();
+    bool arcExcluded(quint32 source, const QGeoRoutingGraphFormat::Arc &arc,
+                     const QList<QGeoRectangle> &areas) const;
+    void unpackEdge(QGeoRoutingGraphFormat::Profile profile, quint32 edge,
+                    QVector<quint32> *arcs) const;
+    SearchSpace *acquireSearchSpace() const;
+    void releaseSearchSpace(SearchSpace *space) const;
+
+    QFile m_file;
+    const uchar *m_data;
+    qint64 m_size;
+    QString m_errorString;
+
+    const QGeoRoutingGraphFormat::Header *m_header;
+    const QGeoRoutingGraphFormat::Node *m_nodes;
+    const quint8 *m_nodeProfiles;
+    const quint32 *m_arcIndex;
+    const QGeoRoutingGraphFormat::Arc *m_arcs;
+    const quint32 *m_nameIndex;
+    const char *m_nameData;
+    const quint32 *m_gridIndex;
+    const quint32 *m_gridNodes;
+    const quint32 *m_chIndex[QGeoRoutingGraphFormat::ProfileCount];
+    const QGeoRoutingGraphFormat::ChEdge *m_chEdges[QGeoRoutingGraphFormat::ProfileCount];
+    quint32 m_chEdgeCount[QGeoRoutingGraphFormat::ProfileCount];
+
+    mutable QMutex m_searchSpaceMutex;
+    mutable QVector<SearchSpace *> m_searchSpaces;
+
+    Q_DISABLE_COPY(QGeoRoutingGraphOffline)
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOROUTINGGRAPHOFFLINE_H
@@ -0,0 +1,107 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutingmanagerengineoffline.h"
+#include "qgeoroutereplyoffline.h"
+#include "qgeoroutinggraphoffline.h"
+
+QT_BEGIN_NAMESPACE
+
+QGeoRoutingManagerEngineOffline::QGeoRoutingManagerEngineOffline(const QVariantMap &parameters,
+                                                                 QGeoServiceProvider::Error *error,
+                                                                 QString *errorString)
+:   QGeoRoutingManagerEngine(parameters)
+{
+    const QString fileName = parameters.value(QStringLiteral("offline.graph")).toString();
+    if (fileName.isEmpty()) {
+        *error = QGeoServiceProvider::MissingRequiredParameterError;
+        *errorString = QStringLiteral("The offline.graph parameter is required");
+        return;
+    }
+
+    QSharedPointer<QGeoRoutingGraphOffline> graph(new QGeoRoutingGraphOffline);
+    if (!graph->load(fileName)) {
+        // Nothing is connected to, the configured graph is unusable
+        *error = QGeoServiceProvider::NotSupportedError;
+        *errorString = graph->errorString();
+        return;
+    }
+    m_graph = graph;
+
+    setSupportedTravelModes(QGeoRouteRequest::CarTravel
+                            | QGeoRouteRequest::BicycleTravel
+                            | QGeoRouteRequest::PedestrianTravel);
+    setSupportedRouteOptimizations(QGeoRouteRequest::FastestRoute | QGeoRouteRequest::ShortestRoute);
+    setSupportedFeatureTypes(QGeoRouteRequest::NoFeature);
+    setSupportedFeatureWeights(QGeoRouteRequest::NeutralFeatureWeight);
+    setSupportedSegmentDetails(QGeoRouteRequest::BasicSegmentData);
+    setSupportedManeuverDetails(QGeoRouteRequest::BasicManeuvers);
+
+    *error = QGeoServiceProvider::NoError;
+    errorString->clear();
+}
+
+QGeoRoutingManagerEngineOffline::~QGeoRoutingManagerEngineOffline()
+{
+}
+
+QGeoRouteReply *QGeoRoutingManagerEngineOffline::calculateRoute(const QGeoRouteRequest &request)
+{
+    QGeoRouteReplyOffline *routeReply = new QGeoRouteReplyOffline(m_graph, request, this);
+
+    connect(routeReply, SIGNAL(finished()), this, SLOT(replyFinished()));
+    connect(routeReply, SIGNAL(error(QGeoRouteReply::Error,QString)),
+            this, SLOT(replyError(QGeoRouteReply::Error,QString)));
+
+    return routeReply;
+}
+
+void QGeoRoutingManagerEngineOffline::replyFinished()
+{
+    QGeoRouteReply *reply = qobject_cast<QGeoRouteReply *>(sender());
+    if (reply)
+        emit finished(reply);
+}
+
+void QGeoRoutingManagerEngineOffline::replyError(QGeoRouteReply::Error errorCode,
+                                                 const QString &errorString)
+{
+    QGeoRouteReply *reply = qobject_cast<QGeoRouteReply *>(sender());
+    if (reply)
+        emit error(reply, errorCode, errorString);
+}
+
+QT_END_NAMESPACE
@@ -11,6 +11,8 @@ HEADERS += \
     qgeocodereplyosm.h \
     qgeoroutingmanagerengineosm.h \
     qgeoroutereplyosm.h \
+    qgeoroutematrixreplyosm.h \
+    qgeoroutematchreplyosm.h \
     qplacemanagerengineosm.h \
     qplacesearchreplyosm.h \
     qplacecategoriesreplyosm.h \
@@ -27,6 +29,8 @@ SOURCES += \
     qgeocodereplyosm.cpp \
     qgeoroutingmanagerengineosm.cpp \
     qgeoroutereplyosm.cpp \
+    qgeoroutematrixreplyosm.cpp \
+    qgeoroutematchreplyosm.cpp \
     qplacemanagerengineosm.cpp \
     qplacesearchreplyosm.cpp \
     qplacecategoriesreplyosm.cpp \
@@ -34,6 +38,13 @@ SOURCES += \
     qgeofiletilecacheosm.cpp \
     qgeotileproviderosm.cpp
 
+# Offline tiles can also be read from MBTiles archives
+qtHaveModule(sql) {
+    QT += sql
+    DEFINES += QT_OSM_MBTILES
+    HEADERS += qgeotilearchiveosm.h
+    SOURCES += qgeotilearchiveosm.cpp
+}
 
 OTHER_FILES += \
     osm_plugin.json
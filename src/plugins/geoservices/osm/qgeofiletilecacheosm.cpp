@@ -36,6 +36,7 @@
 
 #include "qgeofiletilecacheosm.h"
 #include <QtLocation/private/qgeotilespec_p.h>
+#include <QtLocation/private/qgeofiletilecachewriter_p.h>
 #include <QDir>
 #include <QDirIterator>
 #include <QPair>
@@ -100,8 +101,8 @@ void QGeoFileTileCacheOsm::onProviderResolutionFinished(const QGeoTileProviderOs
             dropTiles(mapId);
             loadTiles(mapId);
 
-            // reload offline registry for mapId i
-            if (!m_offlineDirectory.isEmpty())
+            // reload offline archive or registry for mapId i
+            if (!m_offlineDirectory.isEmpty() && !openOfflineArchive(mapId))
                 m_mapIdFutures[mapId] = QtConcurrent::run(this, &QGeoFileTileCacheOsm::initOfflineRegistry, mapId);
 
             // send signal to clear scene in all maps created through this provider that use the reloaded tiles
@@ -154,22 +155,34 @@ void QGeoFileTileCacheOsm::init()
 
     for (QGeoTileProviderOsm * p: m_providers) {
         clearObsoleteTiles(p);
-        if (!m_offlineDirectory.isEmpty())
+        // A tile archive makes scanning the offline directory unnecessary
+        if (!m_offlineDirectory.isEmpty() && !openOfflineArchive(p->mapType().mapId()))
             m_mapIdFutures[p->mapType().mapId()] = QtConcurrent::run(this, &QGeoFileTileCacheOsm::initOfflineRegistry, p->mapType().mapId());
     }
 }
 
 QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(const QGeoTileSpec &spec)
 {
+    QByteArray bytes;
+
     QMutexLocker locker(&storageLock);
+#ifdef QT_OSM_MBTILES
+    const QSharedPointer<QGeoTileArchiveOsm> archive = m_offlineArchives.value(spec.mapId());
+    if (archive) {
+        locker.unlock();
+        bytes = archive->tileData(spec);
+    } else
+#endif
     if (m_tilespecToOfflineFilepath.contains(spec)) {
         const QString fileName = m_tilespecToOfflineFilepath[spec];
         locker.unlock();
         QFile file(fileName);
         file.open(QIODevice::ReadOnly);
-        QByteArray bytes = file.readAll();
+        bytes = file.readAll();
         file.close();
+    }
 
+    if (!bytes.isEmpty()) {
         QImage image;
         if (!image.loadFromData(bytes)) {
             handleError(spec, QLatin1String("Problem with tile image"));
@@ -185,6 +198,47 @@ QSharedPointer<QGeoTileTexture> QGeoFileTileCacheOsm::getFromOfflineStorage(cons
     return QSharedPointer<QGeoTileTexture>();
 }
 
+QString QGeoFileTileCacheOsm::offlineArchiveFilename(int mapId) const
+{
+    int providerId = mapId - 1;
+    if (providerId < 0 || providerId >= m_providers.size())
+        return QString();
+
+    // Same naming as the tiles, without the tile coordinates: osm-l-1.mbtiles
+    QString filename = QStringLiteral("osm-");
+    filename += (m_providers[providerId]->isHighDpi()) ? QLatin1Char('h') : QLatin1Char('l');
+    filename += QLatin1String("-");
+    filename += QString::number(mapId);
+    filename += QLatin1String(".mbtiles");
+
+    return QDir(m_offlineDirectory).filePath(filename);
+}
+
+bool QGeoFileTileCacheOsm::openOfflineArchive(int mapId)
+{
+#ifndef QT_OSM_MBTILES
+    Q_UNUSED(mapId)
+    return false;
+#else
+    QSharedPointer<QGeoTileArchiveOsm> archive;
+
+    const QString fileName = offlineArchiveFilename(mapId);
+    if (!fileName.isEmpty() && QFile::exists(fileName)) {
+        archive.reset(new QGeoTileArchiveOsm(fileName));
+        if (!archive->isValid())
+            archive.reset();
+    }
+
+    QMutexLocker locker(&storageLock);
+    if (archive)
+        m_offlineArchives.insert(mapId, archive);
+    else
+        m_offlineArchives.remove(mapId);
+
+    return !archive.isNull();
+#endif
+}
+
 void QGeoFileTileCacheOsm::dropTiles(int mapId)
 {
     QList<QGeoTileSpec> keys;
@@ -211,6 +265,8 @@ void QGeoFileTileCacheOsm::dropTiles(int mapId)
 
 void QGeoFileTileCacheOsm::loadTiles(int mapId)
 {
+    writer_->flush(); // tiles still being written are not listed yet
+
     QStringList formats;
     formats << QLatin1String("*.*");
 
@@ -38,6 +38,9 @@
 #define QGEOFILETILECACHEOSM_H
 
 #include "qgeotileproviderosm.h"
+#ifdef QT_OSM_MBTILES
+#include "qgeotilearchiveosm.h"
+#endif
 #include <QtLocation/private/qgeofiletilecache_p.h>
 #include <QHash>
 #include <QtConcurrent>
@@ -69,6 +72,8 @@ protected:
     QString tileSpecToFilename(const QGeoTileSpec &spec, const QString &format, const QString &directory) const Q_DECL_OVERRIDE;
     QGeoTileSpec filenameToTileSpec(const QString &filename) const Q_DECL_OVERRIDE;
     QSharedPointer<QGeoTileTexture> getFromOfflineStorage(const QGeoTileSpec &spec);
+    QString offlineArchiveFilename(int mapId) const;
+    bool openOfflineArchive(int mapId);
     void dropTiles(int mapId);
     void loadTiles(int mapId);
 
@@ -77,6 +82,9 @@ protected:
 
     QString m_offlineDirectory;
     QHash<QGeoTileSpec, QString> m_tilespecToOfflineFilepath;
+#ifdef QT_OSM_MBTILES
+    QHash<int, QSharedPointer<QGeoTileArchiveOsm>> m_offlineArchives;
+#endif
     QMap<int, QAtomicInt> m_requestCancel;
     QMap<int, QFuture<void>> m_mapIdFutures;
     QMutex storageLock;
@@ -71,9 +71,11 @@ void QGeoMapReplyOsm::networkReplyFinished()
     if (reply->error() != QNetworkReply::NoError) // Already handled in networkReplyError
         return;
 
-    QByteArray a = reply->readAll();
-
-    setMapImageData(a);
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304)
+        setNotModified(true);
+    else
+        setMapImageData(reply->readAll());
+    setFreshness(QGeoTileFreshness::fromHttpHeaders(reply->rawHeaderPairs()));
     setFinished(true);
 }
 
@@ -0,0 +1,179 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutematchreplyosm.h"
+#include "qgeoroutingmanagerengineosm.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtNetwork/QNetworkAccessManager>
+#include <QtLocation/QGeoRouteMatchRequest>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    Long tracks exceed the coordinate limit of an OSRM match request, so they
+    are split into windows of at most windowSize positions. Consecutive windows
+    overlap by one position to keep the matched path connected. Up to
+    maxRequests windows are in flight at once, and the results are stitched
+    together in track order when the last one arrives.
+*/
+QGeoRouteMatchReplyOsm::QGeoRouteMatchReplyOsm(QNetworkAccessManager *networkManager,
+                                               const QNetworkRequest &networkRequest,
+                                               const QString &urlPrefix, int windowSize, int maxRequests,
+                                               const QGeoRouteMatchRequest &request,
+                                               QGeoRoutingManagerEngineOsm *engine)
+:   QGeoRouteMatchReply(request, engine), m_networkManager(networkManager),
+    m_networkRequest(networkRequest), m_urlPrefix(urlPrefix), m_maxRequests(qMax(1, maxRequests)),
+    m_nextWindow(0), m_pendingWindows(0)
+{
+    const int positionCount = request.positions().size();
+    windowSize = qMax(2, windowSize);
+    for (int first = 0; first < positionCount - 1; first += windowSize - 1) {
+        Window window;
+        window.first = first;
+        window.count = qMin(windowSize, positionCount - first);
+        window.reply = 0;
+        m_windows.append(window);
+    }
+    m_pendingWindows = m_windows.size();
+    sendWindows();
+}
+
+QGeoRouteMatchReplyOsm::~QGeoRouteMatchReplyOsm()
+{
+    cancelWindows();
+}
+
+void QGeoRouteMatchReplyOsm::abort()
+{
+    cancelWindows();
+    QGeoRouteMatchReply::abort();
+}
+
+void QGeoRouteMatchReplyOsm::sendWindows()
+{
+    const QGeoRouteParser *parser = qobject_cast<QGeoRoutingManagerEngineOsm *>(parent())->routeParser();
+    const QList<QGeoPositionInfo> positions = request().positions();
+
+    int inFlight = m_nextWindow - (m_windows.size() - m_pendingWindows);
+    for (; inFlight < m_maxRequests && m_nextWindow < m_windows.size(); ++inFlight, ++m_nextWindow) {
+        Window &window = m_windows[m_nextWindow];
+        QNetworkRequest networkRequest = m_networkRequest;
+        networkRequest.setUrl(parser->matchRequestUrl(positions.mid(window.first, window.count), m_urlPrefix));
+        window.reply = m_networkManager->get(networkRequest);
+        window.reply->setProperty("window", m_nextWindow);
+        connect(window.reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
+    }
+}
+
+void QGeoRouteMatchReplyOsm::cancelWindows()
+{
+    for (int i = 0; i < m_windows.size(); ++i) {
+        QNetworkReply *reply = m_windows.at(i).reply;
+        if (!reply)
+            continue;
+        m_windows[i].reply = 0;
+        reply->disconnect(this);
+        reply->abort();
+        reply->deleteLater();
+    }
+}
+
+void QGeoRouteMatchReplyOsm::networkReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    Window &window = m_windows[reply->property("window").toInt()];
+    window.reply = 0;
+
+    const QByteArray body = reply->readAll();
+    if (reply->error() != QNetworkReply::NoError) {
+        // OSRM answers NoMatch and invalid requests with a 4xx status and a code in the body
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status < 400 || status >= 500 || !QJsonDocument::fromJson(body).isObject()) {
+            cancelWindows();
+            setError(QGeoRouteMatchReply::CommunicationError, reply->errorString());
+            return;
+        }
+    }
+
+    const QGeoRouteParser *parser = qobject_cast<QGeoRoutingManagerEngineOsm *>(parent())->routeParser();
+    QString errorString;
+    QGeoRouteMatchReply::Error error = parser->parseMatchReply(window.path, window.matchedCoordinates,
+                                                               window.confidences, errorString,
+                                                               body, window.count);
+    if (error != QGeoRouteMatchReply::NoError) {
+        cancelWindows();
+        setError(error, errorString);
+        return;
+    }
+
+    if (--m_pendingWindows > 0) {
+        sendWindows();
+        return;
+    }
+
+    assemble();
+    setFinished(true);
+}
+
+void QGeoRouteMatchReplyOsm::assemble()
+{
+    QList<QGeoCoordinate> path;
+    QList<QGeoCoordinate> matchedCoordinates;
+    QVector<qreal> confidences;
+    confidences.reserve(request().positions().size());
+
+    for (int i = 0; i < m_windows.size(); ++i) {
+        const Window &window = m_windows.at(i);
+        // The shared first position was already matched by the previous window
+        const int skip = i > 0 ? 1 : 0;
+        matchedCoordinates.append(window.matchedCoordinates.mid(skip));
+        confidences += window.confidences.mid(skip);
+
+        int from = 0;
+        if (!path.isEmpty() && !window.path.isEmpty() && path.last() == window.path.first())
+            from = 1;
+        path.append(window.path.mid(from));
+    }
+
+    setPath(QGeoPath(path));
+    setMatchedCoordinates(matchedCoordinates);
+    setConfidences(confidences);
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,91 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOROUTEMATCHREPLYOSM_H
+#define QGEOROUTEMATCHREPLYOSM_H
+
+#include <QtNetwork/QNetworkReply>
+#include <QtNetwork/QNetworkRequest>
+#include <QtLocation/QGeoRouteMatchReply>
+
+QT_BEGIN_NAMESPACE
+
+class QNetworkAccessManager;
+class QGeoRoutingManagerEngineOsm;
+
+class QGeoRouteMatchReplyOsm : public QGeoRouteMatchReply
+{
+    Q_OBJECT
+
+public:
+    QGeoRouteMatchReplyOsm(QNetworkAccessManager *networkManager, const QNetworkRequest &networkRequest,
+                           const QString &urlPrefix, int windowSize, int maxRequests,
+                           const QGeoRouteMatchRequest &request, QGeoRoutingManagerEngineOsm *engine);
+    ~QGeoRouteMatchReplyOsm();
+
+    void abort() Q_DECL_OVERRIDE;
+
+private Q_SLOTS:
+    void networkReplyFinished();
+
+private:
+    // A contiguous slice of the track, sharing its first position with the previous window
+    struct Window
+    {
+        int first;
+        int count;
+        QNetworkReply *reply;
+        QList<QGeoCoordinate> path;
+        QList<QGeoCoordinate> matchedCoordinates;
+        QVector<qreal> confidences;
+    };
+
+    void sendWindows();
+    void cancelWindows();
+    void assemble();
+
+    QNetworkAccessManager *m_networkManager;
+    QNetworkRequest m_networkRequest;
+    QString m_urlPrefix;
+    int m_maxRequests;
+    QVector<Window> m_windows;
+    int m_nextWindow;
+    int m_pendingWindows;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOROUTEMATCHREPLYOSM_H
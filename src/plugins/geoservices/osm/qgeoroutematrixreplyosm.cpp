@@ -0,0 +1,95 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutematrixreplyosm.h"
+#include "qgeoroutingmanagerengineosm.h"
+
+#include <QtCore/QJsonDocument>
+#include <QtLocation/QGeoRouteMatrixRequest>
+
+QT_BEGIN_NAMESPACE
+
+QGeoRouteMatrixReplyOsm::QGeoRouteMatrixReplyOsm(QNetworkReply *reply, const QGeoRouteMatrixRequest &request,
+                                                 QObject *parent)
+:   QGeoRouteMatrixReply(request, parent)
+{
+    if (!reply) {
+        setError(UnknownError, QStringLiteral("Null reply"));
+        return;
+    }
+    connect(reply, SIGNAL(finished()), this, SLOT(networkReplyFinished()));
+    connect(this, &QGeoRouteMatrixReply::aborted, reply, &QNetworkReply::abort);
+    connect(this, &QObject::destroyed, reply, &QObject::deleteLater);
+}
+
+QGeoRouteMatrixReplyOsm::~QGeoRouteMatrixReplyOsm()
+{
+}
+
+void QGeoRouteMatrixReplyOsm::networkReplyFinished()
+{
+    QNetworkReply *reply = static_cast<QNetworkReply *>(sender());
+    reply->deleteLater();
+
+    const QByteArray body = reply->readAll();
+    if (reply->error() != QNetworkReply::NoError) {
+        // OSRM answers invalid requests with a 4xx status and a code in the body
+        const int status = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status < 400 || status >= 500 || !QJsonDocument::fromJson(body).isObject()) {
+            setError(QGeoRouteMatrixReply::CommunicationError, reply->errorString());
+            return;
+        }
+    }
+
+    QGeoRoutingManagerEngineOsm *engine = qobject_cast<QGeoRoutingManagerEngineOsm *>(parent());
+    const QGeoRouteParser *parser = engine->routeParser();
+
+    QVector<qreal> durations;
+    QVector<qreal> distances;
+    QString errorString;
+    QGeoRouteMatrixReply::Error error = parser->parseMatrixReply(durations, distances, errorString,
+                                                                 body, request());
+
+    if (error == QGeoRouteMatrixReply::NoError) {
+        setDurations(durations);
+        setDistances(distances);
+        setFinished(true);
+    } else {
+        setError(error, errorString);
+    }
+}
+
+QT_END_NAMESPACE
@@ -39,6 +39,8 @@
 
 #include "qgeoroutingmanagerengineosm.h"
 #include "qgeoroutereplyosm.h"
+#include "qgeoroutematrixreplyosm.h"
+#include "qgeoroutematchreplyosm.h"
 #include "QtLocation/private/qgeorouteparserosrmv4_p.h"
 #include "QtLocation/private/qgeorouteparserosrmv5_p.h"
 
@@ -49,7 +51,8 @@
 QGeoRoutingManagerEngineOsm::QGeoRoutingManagerEngineOsm(const QVariantMap &parameters,
                                                          QGeoServiceProvider::Error *error,
                                                          QString *errorString)
-:   QGeoRoutingManagerEngine(parameters), m_networkManager(new QNetworkAccessManager(this))
+:   QGeoRoutingManagerEngine(parameters), m_networkManager(new QNetworkAccessManager(this)),
+    m_matchWindowSize(100), m_matchRequests(4)
 {
     if (parameters.contains(QStringLiteral("osm.useragent")))
         m_userAgent = parameters.value(QStringLiteral("osm.useragent")).toString().toLatin1();
@@ -62,11 +65,38 @@ QGeoRoutingManagerEngineOsm::QGeoRoutingManagerEngineOsm(const QVariantMap &para
         m_urlPrefix = QStringLiteral("http://router.project-osrm.org/route/v1/driving/");
         // for v4 it was "http://router.project-osrm.org/viaroute"
 
+    if (parameters.contains(QStringLiteral("osm.routing.table.host"))) {
+        m_tableUrlPrefix = parameters.value(QStringLiteral("osm.routing.table.host")).toString();
+    } else {
+        // Table and route services share the host and profile, only the service name differs
+        m_tableUrlPrefix = m_urlPrefix;
+        m_tableUrlPrefix.replace(QStringLiteral("/route/v1/"), QStringLiteral("/table/v1/"));
+    }
+
+    if (parameters.contains(QStringLiteral("osm.routing.match.host"))) {
+        m_matchUrlPrefix = parameters.value(QStringLiteral("osm.routing.match.host")).toString();
+    } else {
+        m_matchUrlPrefix = m_urlPrefix;
+        m_matchUrlPrefix.replace(QStringLiteral("/route/v1/"), QStringLiteral("/match/v1/"));
+    }
+    // The public OSRM server accepts up to 100 coordinates per match request
+    if (parameters.contains(QStringLiteral("osm.routing.match.window")))
+        m_matchWindowSize = qMax(2, parameters.value(QStringLiteral("osm.routing.match.window")).toInt());
+    if (parameters.contains(QStringLiteral("osm.routing.match.requests")))
+        m_matchRequests = qMax(1, parameters.value(QStringLiteral("osm.routing.match.requests")).toInt());
+
     if (parameters.contains(QStringLiteral("osm.routing.apiversion"))
-            && (parameters.value(QStringLiteral("osm.routing.apiversion")).toString().toLatin1() == QByteArray("v4")))
+            && (parameters.value(QStringLiteral("osm.routing.apiversion")).toString().toLatin1() == QByteArray("v4"))) {
         m_routeParser = new QGeoRouteParserOsrmV4(this);
-    else
-        m_routeParser = new QGeoRouteParserOsrmV5(this);
+    } else {
+        QGeoRouteParserOsrmV5 *parser = new QGeoRouteParserOsrmV5(this);
+        const QString geometries = parameters.value(QStringLiteral("osm.routing.geometries")).toString();
+        if (geometries == QLatin1String("polyline6"))
+            parser->setGeometryFormat(QGeoRouteParserOsrmV5::Polyline6Geometry);
+        else if (geometries == QLatin1String("geojson"))
+            parser->setGeometryFormat(QGeoRouteParserOsrmV5::GeoJsonGeometry);
+        m_routeParser = parser;
+    }
 
     *error = QGeoServiceProvider::NoError;
     errorString->clear();
@@ -94,6 +124,59 @@ QGeoRouteReply* QGeoRoutingManagerEngineOsm::calculateRoute(const QGeoRouteReque
     return routeReply;
 }
 
+QGeoRouteMatrixReply *QGeoRoutingManagerEngineOsm::calculateRouteMatrix(const QGeoRouteMatrixRequest &request)
+{
+    if (request.sources().isEmpty()) {
+        return new QGeoRouteMatrixReply(QGeoRouteMatrixReply::UnsupportedOptionError,
+                                        QStringLiteral("A route matrix needs at least one source."), this);
+    }
+
+    const QUrl url = routeParser()->matrixRequestUrl(request, m_tableUrlPrefix);
+    if (!url.isValid()) {
+        return new QGeoRouteMatrixReply(QGeoRouteMatrixReply::UnsupportedOptionError,
+                                        QStringLiteral("Route matrices are not supported by this API version."), this);
+    }
+
+    QNetworkRequest networkRequest;
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
+    networkRequest.setUrl(url);
+
+    QNetworkReply *reply = m_networkManager->get(networkRequest);
+
+    QGeoRouteMatrixReplyOsm *matrixReply = new QGeoRouteMatrixReplyOsm(reply, request, this);
+
+    connect(matrixReply, SIGNAL(finished()), this, SLOT(matrixReplyFinished()));
+    connect(matrixReply, SIGNAL(error(QGeoRouteMatrixReply::Error,QString)),
+            this, SLOT(matrixReplyError(QGeoRouteMatrixReply::Error,QString)));
+
+    return matrixReply;
+}
+
+QGeoRouteMatchReply *QGeoRoutingManagerEngineOsm::matchRoute(const QGeoRouteMatchRequest &request)
+{
+    if (request.positions().size() < 2) {
+        return new QGeoRouteMatchReply(QGeoRouteMatchReply::UnsupportedOptionError,
+                                       QStringLiteral("Map matching needs at least two positions."), this);
+    }
+
+    if (!routeParser()->matchRequestUrl(request.positions().mid(0, 2), m_matchUrlPrefix).isValid()) {
+        return new QGeoRouteMatchReply(QGeoRouteMatchReply::UnsupportedOptionError,
+                                       QStringLiteral("Map matching is not supported by this API version."), this);
+    }
+
+    QNetworkRequest networkRequest;
+    networkRequest.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
+
+    QGeoRouteMatchReplyOsm *matchReply = new QGeoRouteMatchReplyOsm(m_networkManager, networkRequest, m_matchUrlPrefix,
+                                                                    m_matchWindowSize, m_matchRequests, request, this);
+
+    connect(matchReply, SIGNAL(finished()), this, SLOT(matchReplyFinished()));
+    connect(matchReply, SIGNAL(error(QGeoRouteMatchReply::Error,QString)),
+            this, SLOT(matchReplyError(QGeoRouteMatchReply::Error,QString)));
+
+    return matchReply;
+}
+
 const QGeoRouteParser *QGeoRoutingManagerEngineOsm::routeParser() const
 {
     return m_routeParser;
@@ -113,3 +196,33 @@ void QGeoRoutingManagerEngineOsm::replyError(QGeoRouteReply::Error errorCode,
     if (reply)
         emit error(reply, errorCode, errorString);
 }
+
+void QGeoRoutingManagerEngineOsm::matrixReplyFinished()
+{
+    QGeoRouteMatrixReply *reply = qobject_cast<QGeoRouteMatrixReply *>(sender());
+    if (reply)
+        emit matrixFinished(reply);
+}
+
+void QGeoRoutingManagerEngineOsm::matrixReplyError(QGeoRouteMatrixReply::Error errorCode,
+                                                   const QString &errorString)
+{
+    QGeoRouteMatrixReply *reply = qobject_cast<QGeoRouteMatrixReply *>(sender());
+    if (reply)
+        emit matrixError(reply, errorCode, errorString);
+}
+
+void QGeoRoutingManagerEngineOsm::matchReplyFinished()
+{
+    QGeoRouteMatchReply *reply = qobject_cast<QGeoRouteMatchReply *>(sender());
+    if (reply)
+        emit matchFinished(reply);
+}
+
+void QGeoRoutingManagerEngineOsm::matchReplyError(QGeoRouteMatchReply::Error errorCode,
+                                                  const QString &errorString)
+{
+    QGeoRouteMatchReply *reply = qobject_cast<QGeoRouteMatchReply *>(sender());
+    if (reply)
+        emit matchError(reply, errorCode, errorString);
+}
@@ -43,14 +43,16 @@
 #include <QtLocation/QGeoServiceProvider>
 #include <QtLocation/QGeoRoutingManagerEngine>
 #include <QtLocation/private/qgeorouteparser_p.h>
+#include <QtLocation/private/qgeoroutingmanagerengineextension_p.h>
 
 QT_BEGIN_NAMESPACE
 
 class QNetworkAccessManager;
 
-class QGeoRoutingManagerEngineOsm : public QGeoRoutingManagerEngine
+class QGeoRoutingManagerEngineOsm : public QGeoRoutingManagerEngine, public QGeoRoutingManagerEngineExtension
 {
     Q_OBJECT
+    Q_INTERFACES(QGeoRoutingManagerEngineExtension)
 
 public:
     QGeoRoutingManagerEngineOsm(const QVariantMap &parameters,
@@ -58,18 +60,28 @@ public:
                                 QString *errorString);
     ~QGeoRoutingManagerEngineOsm();
 
-    QGeoRouteReply *calculateRoute(const QGeoRouteRequest &request);
+    QGeoRouteReply *calculateRoute(const QGeoRouteRequest &request) Q_DECL_OVERRIDE;
+    QGeoRouteMatrixReply *calculateRouteMatrix(const QGeoRouteMatrixRequest &request) Q_DECL_OVERRIDE;
+    QGeoRouteMatchReply *matchRoute(const QGeoRouteMatchRequest &request) Q_DECL_OVERRIDE;
     const QGeoRouteParser *routeParser() const;
 
 private Q_SLOTS:
     void replyFinished();
     void replyError(QGeoRouteReply::Error errorCode, const QString &errorString);
+    void matrixReplyFinished();
+    void matrixReplyError(QGeoRouteMatrixReply::Error errorCode, const QString &errorString);
+    void matchReplyFinished();
+    void matchReplyError(QGeoRouteMatchReply::Error errorCode, const QString &errorString);
 
 private:
     QNetworkAccessManager *m_networkManager;
     QGeoRouteParser *m_routeParser;
     QByteArray m_userAgent;
     QString m_urlPrefix;
+    QString m_tableUrlPrefix;
+    QString m_matchUrlPrefix;
+    int m_matchWindowSize;
+    int m_matchRequests;
 };
 
 QT_END_NAMESPACE
@@ -0,0 +1,170 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotilearchiveosm.h"
+
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtCore/QDebug>
+#include <QtCore/QThread>
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+
+QT_BEGIN_NAMESPACE
+
+QGeoTileArchiveOsm::QGeoTileArchiveOsm(const QString &fileName, QObject *parent)
+:   QObject(parent), m_fileName(fileName), m_valid(false)
+{
+    QThread *thread = QThread::currentThread();
+    if (!tileQuery(thread))
+        return;
+
+    QSqlDatabase db = QSqlDatabase::database(connectionName(thread), false);
+
+    // The metadata table is optional, the format can also be detected from the tile data.
+    QSqlQuery query(db);
+    if (query.exec(QStringLiteral("SELECT value FROM metadata WHERE name = 'format'")) && query.next())
+        m_format = query.value(0).toString();
+
+    m_valid = true;
+}
+
+QGeoTileArchiveOsm::~QGeoTileArchiveOsm()
+{
+    QMutexLocker locker(&m_connectionsLock);
+    const QList<QThread *> threads = m_tileQueries.keys();
+    // The queries have to be gone before their connections are removed
+    m_tileQueries.clear();
+    locker.unlock();
+
+    for (QThread *thread : threads)
+        QSqlDatabase::removeDatabase(connectionName(thread));
+}
+
+bool QGeoTileArchiveOsm::isValid() const
+{
+    return m_valid;
+}
+
+QString QGeoTileArchiveOsm::fileName() const
+{
+    return m_fileName;
+}
+
+QString QGeoTileArchiveOsm::format() const
+{
+    return m_format;
+}
+
+QByteArray QGeoTileArchiveOsm::tileData(const QGeoTileSpec &spec) const
+{
+    if (!m_valid || spec.zoom() < 0 || spec.zoom() > 30)
+        return QByteArray();
+
+    const QSharedPointer<QSqlQuery> query = tileQuery(QThread::currentThread());
+    if (!query)
+        return QByteArray();
+
+    query->bindValue(0, spec.zoom());
+    query->bindValue(1, spec.x());
+    // MBTiles use the TMS tiling scheme, with the y axis pointing north.
+    query->bindValue(2, (1 << spec.zoom()) - 1 - spec.y());
+
+    QByteArray data;
+    if (query->exec() && query->next())
+        data = query->value(0).toByteArray();
+    query->finish(); // keeps the query prepared for the next lookup
+
+    return data;
+}
+
+QString QGeoTileArchiveOsm::connectionName(QThread *thread) const
+{
+    return QStringLiteral("qtlocation-osm-archive-%1-%2").arg(quintptr(this)).arg(quintptr(thread));
+}
+
+// Returns the lookup query of thread, opening a connection for it on first use
+QSharedPointer<QSqlQuery> QGeoTileArchiveOsm::tileQuery(QThread *thread) const
+{
+    QMutexLocker locker(&m_connectionsLock);
+    QSharedPointer<QSqlQuery> query = m_tileQueries.value(thread);
+    if (query)
+        return query;
+
+    const QString name = connectionName(thread);
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
+        db.setDatabaseName(m_fileName);
+        db.setConnectOptions(QStringLiteral("QSQLITE_OPEN_READONLY"));
+        if (db.open()) {
+            query.reset(new QSqlQuery(db));
+            query->setForwardOnly(true);
+            if (!query->prepare(QStringLiteral("SELECT tile_data FROM tiles WHERE zoom_level = ? AND tile_column = ? AND tile_row = ?"))) {
+                qWarning() << "No tiles table in map tile archive" << m_fileName;
+                query.reset();
+            }
+        } else {
+            qWarning() << "Unable to open map tile archive" << m_fileName;
+        }
+        if (!query) {
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(name);
+            return query;
+        }
+    }
+    m_tileQueries.insert(thread, query);
+    locker.unlock();
+
+    // Connections can only be used by the thread that created them,
+    // release them together with the thread.
+    QGeoTileArchiveOsm *self = const_cast<QGeoTileArchiveOsm *>(this);
+    connect(thread, &QThread::finished, self, [self, thread]() {
+        self->closeConnection(thread);
+    }, Qt::DirectConnection);
+
+    return query;
+}
+
+void QGeoTileArchiveOsm::closeConnection(QThread *thread)
+{
+    QMutexLocker locker(&m_connectionsLock);
+    if (!m_tileQueries.remove(thread))
+        return;
+    locker.unlock();
+
+    QSqlDatabase::removeDatabase(connectionName(thread));
+}
+
+QT_END_NAMESPACE
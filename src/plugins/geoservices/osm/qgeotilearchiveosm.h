@@ -0,0 +1,87 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QGEOTILEARCHIVEOSM_H
+#define QGEOTILEARCHIVEOSM_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QSharedPointer>
+#include <QtCore/QString>
+
+QT_BEGIN_NAMESPACE
+
+class QGeoTileSpec;
+class QSqlQuery;
+class QThread;
+
+/*
+    Read-only access to map tiles stored in a single MBTiles (SQLite) file.
+    Tiles are looked up through the z/x/y index of the archive, without
+    scanning the content of the file. Every thread reading from the archive
+    gets its own database connection and prepared lookup query, so lookups
+    can run concurrently.
+*/
+class QGeoTileArchiveOsm : public QObject
+{
+    Q_OBJECT
+public:
+    explicit QGeoTileArchiveOsm(const QString &fileName, QObject *parent = 0);
+    ~QGeoTileArchiveOsm();
+
+    bool isValid() const;
+    QString fileName() const;
+    QString format() const;
+
+    QByteArray tileData(const QGeoTileSpec &spec) const;
+
+private:
+    QString connectionName(QThread *thread) const;
+    QSharedPointer<QSqlQuery> tileQuery(QThread *thread) const;
+    void closeConnection(QThread *thread);
+
+    QString m_fileName;
+    QString m_format;
+    bool m_valid;
+    mutable QMutex m_connectionsLock;
+    mutable QHash<QThread *, QSharedPointer<QSqlQuery> > m_tileQueries;
+};
+
+QT_END_NAMESPACE
+
+#endif // QGEOTILEARCHIVEOSM_H
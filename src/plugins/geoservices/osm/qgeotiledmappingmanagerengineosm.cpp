@@ -302,6 +302,16 @@ QGeoTiledMappingManagerEngineOsm::QGeoTiledMappingManagerEngineOsm(const QVarian
             tileCache->setExtraTextureUsage(cacheSize);
     }
 
+    /*
+     * Decoded tile cache setup -- disabled unless a size is given, uses the memory cost strategy
+     */
+    if (parameters.contains(QStringLiteral("osm.mapping.cache.decoded.size"))) {
+        bool ok = false;
+        int cacheSize = parameters.value(QStringLiteral("osm.mapping.cache.decoded.size")).toString().toInt(&ok);
+        if (ok)
+            tileCache->setMaxDecodedUsage(cacheSize);
+    }
+
 
     setTileCache(tileCache);
 
@@ -136,7 +136,7 @@ void QGeoTileFetcherOsm::restartTimer()
 {
     Q_D(QGeoTileFetcherOsm);
 
-    if (!d->queue_.isEmpty())
+    if (!d->queue_.isEmpty() || !d->backgroundQueue_.isEmpty())
         d->timer_.start(0, this);
 }
 
@@ -159,6 +159,10 @@ QGeoTiledMapReply *QGeoTileFetcherOsm::getTileImage(const QGeoTileSpec &spec)
     QNetworkRequest request;
     request.setHeader(QNetworkRequest::UserAgentHeader, m_userAgent);
     request.setUrl(url);
+    // Revalidate stale cached tiles instead of downloading them again
+    const QList<QGeoTileFreshness::RawHeaderPair> conditions = tileFreshness(spec).conditionalHeaders();
+    for (const QGeoTileFreshness::RawHeaderPair &header : conditions)
+        request.setRawHeader(header.first, header.second);
     QNetworkReply *reply = m_nm->get(request);
     return new QGeoMapReplyOsm(reply, spec, m_providers[id]->format());
 }
@@ -60,7 +60,8 @@ PRIVATE_HEADERS += \
                     qdoublematrix4x4_p.h \
                     qgeopath_p.h \
                     qgeopositioninfo_p.h \
-                    qclipperutils_p.h
+                    qclipperutils_p.h \
+                    qworldpoint_p.h
 
 SOURCES += \
             qgeoaddress.cpp \
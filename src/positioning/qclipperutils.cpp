@@ -97,4 +97,84 @@ Paths QClipperUtils::qListToPaths(const QList<QList<QDoubleVector2D> > &lists)
     return res;
 }
 
+QVector<QDoubleVector2D> QClipperUtils::pathToQVector(const Path &path)
+{
+    QVector<QDoubleVector2D> res;
+    pathToQVector(path, &res);
+    return res;
+}
+
+void QClipperUtils::pathToQVector(const Path &path, QVector<QDoubleVector2D> *out)
+{
+    const int size = int(path.size());
+    out->resize(size);
+    QDoubleVector2D *dst = out->data();
+    const IntPoint *src = path.data();
+    for (int i = 0; i < size; ++i)
+        dst[i] = QDoubleVector2D(double(src[i].X) * kClipperScaleFactorInv,
+                                 double(src[i].Y) * kClipperScaleFactorInv);
+}
+
+QVector<QVector<QDoubleVector2D> > QClipperUtils::pathsToQVector(const Paths &paths)
+{
+    QVector<QVector<QDoubleVector2D> > res;
+    pathsToQVector(paths, &res);
+    return res;
+}
+
+void QClipperUtils::pathsToQVector(const Paths &paths, QVector<QVector<QDoubleVector2D> > *out)
+{
+    out->resize(int(paths.size()));
+    for (int i = 0; i < out->size(); ++i)
+        pathToQVector(paths[i], &(*out)[i]);
+}
+
+Path QClipperUtils::qVectorToPath(const QVector<QDoubleVector2D> &points)
+{
+    Path res;
+    qVectorToPath(points, &res);
+    return res;
+}
+
+void QClipperUtils::qVectorToPath(const QVector<QDoubleVector2D> &points, Path *out)
+{
+    const int size = points.size();
+    out->resize(size_t(size));
+    IntPoint *dst = out->data();
+    const QDoubleVector2D *src = points.constData();
+    for (int i = 0; i < size; ++i)
+        dst[i] = IntPoint(cInt(src[i].x() * kClipperScaleFactor), cInt(src[i].y() * kClipperScaleFactor));
+}
+
+Paths QClipperUtils::qVectorToPaths(const QVector<QVector<QDoubleVector2D> > &paths)
+{
+    Paths res(size_t(paths.size()));
+    for (int i = 0; i < paths.size(); ++i)
+        qVectorToPath(paths.at(i), &res[size_t(i)]);
+    return res;
+}
+
+void QClipperUtils::worldPathToPath(const QVector<QWorldPoint> &points, Path *out)
+{
+    Q_ASSERT(kClipperScaleFactor == double(QWorldPoint::worldSize()));
+    const int size = points.size();
+    out->resize(size_t(size));
+    IntPoint *dst = out->data();
+    const QWorldPoint *src = points.constData();
+    for (int i = 0; i < size; ++i)
+        dst[i] = IntPoint(src[i].x(), src[i].y());
+}
+
+void QClipperUtils::pathsToWorldPaths(const Paths &paths, QVector<QVector<QWorldPoint> > *out)
+{
+    out->resize(int(paths.size()));
+    for (int i = 0; i < out->size(); ++i) {
+        const Path &path = paths[size_t(i)];
+        QVector<QWorldPoint> &world = (*out)[i];
+        world.resize(int(path.size()));
+        for (int j = 0; j < world.size(); ++j)
+            world[j] = QWorldPoint(path[size_t(j)].X, path[size_t(j)].Y);
+    }
+}
+
 QT_END_NAMESPACE
@@ -59,10 +59,12 @@
 #include <QtPositioning/private/qpositioningglobal_p.h>
 #include <QtCore/QtGlobal>
 #include <QtCore/QList>
+#include <QtCore/QVector>
 #include <cmath>
 /* clip2tri triangulator includes */
 #include <clip2tri.h>
 #include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qworldpoint_p.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -79,6 +81,21 @@ public:
 
     static Path  qListToPath(const QList<QDoubleVector2D> &list);
     static Paths qListToPaths(const QList<QList<QDoubleVector2D> > &lists);
+
+    // Contiguous variants, converting whole paths at once. The overloads taking
+    // an output argument reuse its storage.
+    static QVector<QDoubleVector2D> pathToQVector(const Path &path);
+    static void pathToQVector(const Path &path, QVector<QDoubleVector2D> *out);
+    static QVector<QVector<QDoubleVector2D> > pathsToQVector(const Paths &paths);
+    static void pathsToQVector(const Paths &paths, QVector<QVector<QDoubleVector2D> > *out);
+
+    static Path  qVectorToPath(const QVector<QDoubleVector2D> &points);
+    static void  qVectorToPath(const QVector<QDoubleVector2D> &points, Path *out);
+    static Paths qVectorToPaths(const QVector<QVector<QDoubleVector2D> > &paths);
+
+    // World points share the Clipper scale, these only copy the integers
+    static void worldPathToPath(const QVector<QWorldPoint> &points, Path *out);
+    static void pathsToWorldPaths(const Paths &paths, QVector<QVector<QWorldPoint> > *out);
 };
 
 QT_END_NAMESPACE
@@ -46,8 +46,140 @@
 #include "qdoublevector2d_p.h"
 #include "qdoublevector3d_p.h"
 
+#include <QtCore/private/qsimd_p.h>
+
 QT_BEGIN_NAMESPACE
 
+#ifdef __SSE2__
+namespace {
+
+/*
+    Approximations of the transcendental functions needed by the batch conversions. They
+    only use additions, multiplications, divisions and bit operations, which lets SSE2
+    convert two points at once. Over the input ranges used below, the results stay within
+    1e-14 of the exact mercator y and within 1e-13 degrees of the exact latitude.
+*/
+
+const double ln2High = 0.6931471805599453;
+const double ln2Low = 2.3190468138462996e-17;
+const double roundingBias = 6755399441055744.0; // 1.5 * 2^52, rounds to an integer when added
+const double maximumLatitude = 89.0; // well outside of the mercator y range [0, 1]
+
+// 2 / (2k + 1), ln(m) = 2 atanh(s) with s = (m - 1) / (m + 1)
+const double logCoefficients[] = { 2.0 / 17, 2.0 / 15, 2.0 / 13, 2.0 / 11, 2.0 / 9, 2.0 / 7, 2.0 / 5, 2.0 / 3, 2.0 };
+// (-1)^k / (2k + 1)!
+const double sinCoefficients[] = { 1.0 / 51090942171709440000.0, -1.0 / 121645100408832000.0, 1.0 / 355687428096000.0,
+                                   -1.0 / 1307674368000.0, 1.0 / 6227020800.0, -1.0 / 39916800.0, 1.0 / 362880.0,
+                                   -1.0 / 5040.0, 1.0 / 120.0, -1.0 / 6.0, 1.0 };
+// 1 / k!
+const double expCoefficients[] = { 1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0,
+                                   1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0,
+                                   1.0 / 24.0, 1.0 / 6.0, 1.0 / 2.0, 1.0, 1.0 };
+// (-1)^k / (2k + 1)
+const double atanCoefficients[] = { 1.0 / 17, -1.0 / 15, 1.0 / 13, -1.0 / 11, 1.0 / 9, -1.0 / 7, 1.0 / 5, -1.0 / 3, 1.0 };
+// atan(k / 4)
+const double atanQuarters[] = { 0.0, 0.24497866312686414, 0.4636476090008061, 0.6435011087932844, 0.7853981633974483 };
+
+inline __m128d select(__m128d mask, __m128d a, __m128d b)
+{
+    return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+}
+
+template <int N>
+inline __m128d horner(const double (&coefficients)[N], __m128d x)
+{
+    __m128d p = _mm_set1_pd(coefficients[0]);
+    for (int i = 1; i < N; ++i)
+        p = _mm_add_pd(_mm_mul_pd(p, x), _mm_set1_pd(coefficients[i]));
+    return p;
+}
+
+// ln(x) for finite x > 0, with x = m * 2^e and m in [sqrt(1/2), sqrt(2))
+inline __m128d fastLog(__m128d x)
+{
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d twoPow52 = _mm_set1_pd(4503599627370496.0);
+    const __m128i bits = _mm_castpd_si128(x);
+    const __m128i mantissaMask = _mm_set_epi32(0x000fffff, -1, 0x000fffff, -1);
+
+    // The biased exponent, read back as the low bits of 2^52
+    __m128d e = _mm_castsi128_pd(_mm_or_si128(_mm_srli_epi64(bits, 52), _mm_castpd_si128(twoPow52)));
+    e = _mm_sub_pd(e, _mm_add_pd(twoPow52, _mm_set1_pd(1023.0)));
+    __m128d m = _mm_or_pd(_mm_castsi128_pd(_mm_and_si128(bits, mantissaMask)), one);
+    const __m128d large = _mm_cmpgt_pd(m, _mm_set1_pd(M_SQRT2));
+    m = select(large, _mm_mul_pd(m, _mm_set1_pd(0.5)), m);
+    e = _mm_add_pd(e, _mm_and_pd(large, one));
+
+    const __m128d s = _mm_div_pd(_mm_sub_pd(m, one), _mm_add_pd(m, one));
+    return _mm_add_pd(_mm_mul_pd(e, _mm_set1_pd(ln2High)),
+                      _mm_mul_pd(s, horner(logCoefficients, _mm_mul_pd(s, s))));
+}
+
+// sin(x) for |x| <= pi / 2
+inline __m128d fastSin(__m128d x)
+{
+    return _mm_mul_pd(x, horner(sinCoefficients, _mm_mul_pd(x, x)));
+}
+
+// exp(x) for |x| <= pi, with x = n ln(2) + r and |r| <= ln(2) / 2
+inline __m128d fastExp(__m128d x)
+{
+    const __m128d bias = _mm_set1_pd(roundingBias);
+    const __m128d shifted = _mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(M_LOG2E)), bias);
+    const __m128d n = _mm_sub_pd(shifted, bias);
+    const __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(n, _mm_set1_pd(ln2High))),
+                                 _mm_mul_pd(n, _mm_set1_pd(ln2Low)));
+    // 2^n, from n held in the low bits of shifted
+    const __m128i scale = _mm_slli_epi64(_mm_add_epi64(_mm_castpd_si128(shifted),
+                                                       _mm_set_epi32(0, 1023, 0, 1023)), 52);
+    return _mm_mul_pd(horner(expCoefficients, r), _mm_castsi128_pd(scale));
+}
+
+// atan(t) for |t| <= 1, with atan(t) = atan(c) + atan((t - c) / (1 + t c)) and c = k / 4
+inline __m128d fastAtan(__m128d t)
+{
+    const __m128d signMask = _mm_set1_pd(-0.0);
+    const __m128d bias = _mm_set1_pd(roundingBias);
+    const __m128d a = _mm_andnot_pd(signMask, t);
+    const __m128d k = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(a, _mm_set1_pd(4.0)), bias), bias);
+    const __m128d c = _mm_mul_pd(k, _mm_set1_pd(0.25));
+    const __m128d r = _mm_div_pd(_mm_sub_pd(a, c), _mm_add_pd(_mm_set1_pd(1.0), _mm_mul_pd(a, c)));
+
+    __m128d base = _mm_setzero_pd();
+    for (int i = 1; i < 5; ++i)
+        base = select(_mm_cmpeq_pd(k, _mm_set1_pd(i)), _mm_set1_pd(atanQuarters[i]), base);
+    const __m128d result = _mm_add_pd(base, _mm_mul_pd(r, horner(atanCoefficients, _mm_mul_pd(r, r))));
+    return _mm_or_pd(result, _mm_and_pd(signMask, t));
+}
+
+// y = 0.5 - ln(tan(pi / 4 + lat / 2)) / (2 pi), using ln(tan(pi / 4 + lat / 2)) = atanh(sin(lat))
+inline __m128d latitudeToMercatorY(__m128d latitude)
+{
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d invalid = _mm_cmpunord_pd(latitude, latitude);
+    latitude = _mm_min_pd(_mm_max_pd(latitude, _mm_set1_pd(-maximumLatitude)), _mm_set1_pd(maximumLatitude));
+    const __m128d s = fastSin(_mm_mul_pd(latitude, _mm_set1_pd(M_PI / 180.0)));
+    const __m128d l = fastLog(_mm_div_pd(_mm_add_pd(one, s), _mm_sub_pd(one, s)));
+    const __m128d y = _mm_sub_pd(_mm_set1_pd(0.5), _mm_mul_pd(l, _mm_set1_pd(0.25 / M_PI)));
+    // A NaN latitude maps to 0, like in coordToMercator()
+    return _mm_andnot_pd(invalid, _mm_min_pd(_mm_max_pd(y, _mm_setzero_pd()), one));
+}
+
+// lat = 2 atan(exp(z)) - pi / 2 = 2 atan(tanh(z / 2)), with z = pi (1 - 2y)
+inline __m128d mercatorYToLatitude(__m128d y)
+{
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d invalid = _mm_cmpunord_pd(y, y);
+    y = _mm_min_pd(_mm_max_pd(y, _mm_setzero_pd()), one);
+    const __m128d w = fastExp(_mm_mul_pd(_mm_set1_pd(M_PI), _mm_sub_pd(one, _mm_add_pd(y, y))));
+    const __m128d t = _mm_div_pd(_mm_sub_pd(w, one), _mm_add_pd(w, one));
+    // All bits set is a NaN, which keeps an invalid y invalid
+    return _mm_or_pd(invalid, _mm_mul_pd(_mm_set1_pd(360.0 / M_PI), fastAtan(t)));
+}
+
+} // namespace
+#endif
+
 QDoubleVector2D QWebMercator::coordToMercator(const QGeoCoordinate &coord)
 {
     const double pi = M_PI;
@@ -124,6 +256,57 @@ QGeoCoordinate QWebMercator::mercatorToCoordClamped(const QDoubleVector2D &merca
     return QGeoCoordinate(lat, lng, 0.0);
 }
 
+void QWebMercator::coordToMercator(const QGeoCoordinate *coords, QDoubleVector2D *mercator, int count)
+{
+#ifdef __SSE2__
+    for (int i = 0; i < count; i += 2) {
+        const int n = qMin(2, count - i);
+        const __m128d latitudes = n == 2 ? _mm_set_pd(coords[i + 1].latitude(), coords[i].latitude())
+                                         : _mm_set_sd(coords[i].latitude());
+        double y[2];
+        _mm_storeu_pd(y, latitudeToMercatorY(latitudes));
+        for (int j = 0; j < n; ++j)
+            mercator[i + j] = QDoubleVector2D(coords[i + j].longitude() / 360.0 + 0.5, y[j]);
+    }
+#else
+    for (int i = 0; i < count; ++i)
+        mercator[i] = coordToMercator(coords[i]);
+#endif
+}
+
+void QWebMercator::mercatorToCoord(const QDoubleVector2D *mercator, QGeoCoordinate *coords, int count)
+{
+#ifdef __SSE2__
+    for (int i = 0; i < count; i += 2) {
+        const int n = qMin(2, count - i);
+        const __m128d ys = n == 2 ? _mm_set_pd(mercator[i + 1].y(), mercator[i].y())
+                                  : _mm_set_sd(mercator[i].y());
+        double latitudes[2];
+        _mm_storeu_pd(latitudes, mercatorYToLatitude(ys));
+        for (int j = 0; j < n; ++j) {
+            const double fy = mercator[i + j].y();
+            double lat = latitudes[j];
+            if (fy <= 0.0)
+                lat = 90.0;
+            else if (fy >= 1.0)
+                lat = -90.0;
+
+            const double fx = mercator[i + j].x();
+            double lng;
+            if (fx >= 0)
+                lng = realmod(fx, 1.0);
+            else
+                lng = realmod(1.0 - realmod(-1.0 * fx, 1.0), 1.0);
+
+            coords[i + j] = QGeoCoordinate(lat, lng * 360.0 - 180.0, 0.0);
+        }
+    }
+#else
+    for (int i = 0; i < count; ++i)
+        coords[i] = mercatorToCoord(mercator[i]);
+#endif
+}
+
 QGeoCoordinate QWebMercator::coordinateInterpolation(const QGeoCoordinate &from, const QGeoCoordinate &to, qreal progress)
 {
     QDoubleVector2D s = QWebMercator::coordToMercator(from);
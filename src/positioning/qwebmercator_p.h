@@ -67,6 +67,11 @@ public:
     static QGeoCoordinate mercatorToCoordClamped(const QDoubleVector2D &mercator);
     static QGeoCoordinate coordinateInterpolation(const QGeoCoordinate &from, const QGeoCoordinate &to, qreal progress);
 
+    // Batch conversions of count points. With SSE2 the latitude is converted through
+    // polynomial approximations, within 1e-14 of the exact mercator y and 1e-13 degrees.
+    static void coordToMercator(const QGeoCoordinate *coords, QDoubleVector2D *mercator, int count);
+    static void mercatorToCoord(const QDoubleVector2D *mercator, QGeoCoordinate *coords, int count);
+
 private:
     static double realmod(const double a, const double b);
 };
@@ -0,0 +1,129 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtPositioning module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#ifndef QWORLDPOINT_P_H
+#define QWORLDPOINT_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtPositioning/private/qpositioningglobal_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtCore/QVector>
+#include <cmath>
+#include <limits>
+
+QT_BEGIN_NAMESPACE
+
+/*
+ * A point of the web mercator space in 64-bit fixed point, the map being
+ * worldSize() units wide. This is the scale used by Clipper, so that world
+ * paths go through it unconverted, and leaves about 4e-6 pixels per unit at
+ * zoom level 22.
+ */
+class QWorldPoint
+{
+public:
+    static Q_DECL_CONSTEXPR inline qint64 worldSize() { return Q_INT64_C(1) << 48; }
+
+    Q_DECL_CONSTEXPR inline QWorldPoint() : xp(0), yp(0) {}
+    Q_DECL_CONSTEXPR inline QWorldPoint(qint64 x, qint64 y) : xp(x), yp(y) {}
+
+    // The result of projecting an invalid coordinate, like NaN for QDoubleVector2D
+    static Q_DECL_CONSTEXPR inline QWorldPoint invalid()
+    {
+        return QWorldPoint(std::numeric_limits<qint64>::min(), std::numeric_limits<qint64>::min());
+    }
+    Q_DECL_CONSTEXPR inline bool isValid() const
+    {
+        return xp != std::numeric_limits<qint64>::min();
+    }
+
+    static inline QWorldPoint fromMercator(const QDoubleVector2D &mercator)
+    {
+        const double scale = double(worldSize());
+        if (!qIsFinite(mercator.x()) || !qIsFinite(mercator.y()))
+            return invalid();
+        return QWorldPoint(std::llround(mercator.x() * scale), std::llround(mercator.y() * scale));
+    }
+    inline QDoubleVector2D toMercator() const
+    {
+        const double scale = 1.0 / double(worldSize());
+        if (!isValid())
+            return QDoubleVector2D(qQNaN(), qQNaN());
+        return QDoubleVector2D(double(xp) * scale, double(yp) * scale);
+    }
+
+    static inline void fromMercator(const QVector<QDoubleVector2D> &mercator, QVector<QWorldPoint> *world)
+    {
+        world->resize(mercator.size());
+        QWorldPoint *dst = world->data();
+        for (int i = 0; i < mercator.size(); ++i)
+            dst[i] = fromMercator(mercator.at(i));
+    }
+
+    Q_DECL_CONSTEXPR inline qint64 x() const { return xp; }
+    Q_DECL_CONSTEXPR inline qint64 y() const { return yp; }
+    inline void setX(qint64 x) { xp = x; }
+    inline void setY(qint64 y) { yp = y; }
+
+    Q_DECL_CONSTEXPR inline bool operator==(const QWorldPoint &other) const
+    {
+        return xp == other.xp && yp == other.yp;
+    }
+    Q_DECL_CONSTEXPR inline bool operator!=(const QWorldPoint &other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    qint64 xp;
+    qint64 yp;
+};
+
+Q_DECLARE_TYPEINFO(QWorldPoint, Q_PRIMITIVE_TYPE);
+
+QT_END_NAMESPACE
+
+#endif // QWORLDPOINT_P_H
@@ -20,6 +20,10 @@ qtHaveModule(quick) {
     imports.depends += positioning location
 }
 
+# the tools only need QtCore and QtPositioning
+SUBDIRS += tools
+tools.depends += positioning
+
 plugins.depends += positioning
 SUBDIRS += plugins
 
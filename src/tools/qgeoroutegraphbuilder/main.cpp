@@ -0,0 +1,248 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: http://www.qt.io/licensing/
+**
+** This file is part of the QtLocation module of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:LGPL3$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see http://www.qt.io/terms-conditions. For further
+** information use the contact form at http://www.qt.io/contact-us.
+**
+** GNU Lesser General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU Lesser
+** General Public License version 3 as published by the Free Software
+** Foundation and appearing in the file LICENSE.LGPLv3 included in the
+** packaging of this file. Please review the following information to
+** ensure the GNU Lesser General Public License version 3 requirements
+** will be met: https://www.gnu.org/licenses/lgpl.html.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 2.0 or later as published by the Free
+** Software Foundation and appearing in the file LICENSE.GPL included in
+** the packaging of this file. Please review the following information to
+** ensure the GNU General Public License version 2.0 requirements will be
+** met: http://www.gnu.org/licenses/gpl-2.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeoroutinggraphbuilderoffline.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QFile>
+#include <QtCore/QHash>
+#include <QtCore/QTextStream>
+#include <QtCore/QXmlStreamReader>
+
+using namespace QGeoRoutingGraphFormat;
+
+namespace {
+
+int roadClass(const QString &highway)
+{
+    static const char *const classes[RoadClassCount] = {
+        "motorway", "motorway_link", "trunk", "trunk_link", "primary", "primary_link",
+        "secondary", "secondary_link", "tertiary", "tertiary_link", "unclassified",
+        "residential", "living_street", "service", "track", "cycleway", "path",
+        "footway", "pedestrian", "steps"
+    };
+    for (int c = 0; c < RoadClassCount; ++c) {
+        if (highway == QLatin1String(classes[c]))
+            return c;
+    }
+    if (highway == QLatin1String("road"))
+        return Unclassified;
+    if (highway == QLatin1String("bridleway"))
+        return Path;
+    return -1;
+}
+
+bool isYes(const QString &value)
+{
+    return value == QLatin1String("yes") || value == QLatin1String("true")
+            || value == QLatin1String("1") || value == QLatin1String("designated")
+            || value == QLatin1String("permissive");
+}
+
+bool isNo(const QString &value)
+{
+    return value == QLatin1String("no") || value == QLatin1String("false")
+            || value == QLatin1String("0") || value == QLatin1String("private");
+}
+
+void applyAccess(const QHash<QString, QString> &tags, const char *key, int mask, int *access)
+{
+    const QString value = tags.value(QLatin1String(key));
+    if (isNo(value))
+        *access &= ~mask;
+    else if (isYes(value))
+        *access |= mask;
+}
+
+class OsmReader
+{
+public:
+    explicit OsmReader(QGeoRoutingGraphBuilderOffline *builder) : m_builder(builder) {}
+
+    bool read(QIODevice *device, QString *errorString);
+
+private:
+    void addWay(const QVector<qint64> &refs, const QHash<QString, QString> &tags);
+    quint32 graphNode(qint64 id);
+
+    QGeoRoutingGraphBuilderOffline *m_builder;
+    QHash<qint64, Node> m_osmNodes;
+    QHash<qint64, quint32> m_graphNodes;
+};
+
+bool OsmReader::read(QIODevice *device, QString *errorString)
+{
+    QXmlStreamReader xml(device);
+    QVector<qint64> refs;
+    QHash<QString, QString> tags;
+    bool inWay = false;
+
+    while (!xml.atEnd()) {
+        const QXmlStreamReader::TokenType token = xml.readNext();
+        if (token == QXmlStreamReader::StartElement) {
+            const QStringRef name = xml.name();
+            const QXmlStreamAttributes attributes = xml.attributes();
+            if (name == QLatin1String("node")) {
+                const Node node = { toFixed(attributes.value(QLatin1String("lat")).toDouble()),
+                                    toFixed(attributes.value(QLatin1String("lon")).toDouble()) };
+                m_osmNodes.insert(attributes.value(QLatin1String("id")).toLongLong(), node);
+            } else if (name == QLatin1String("way")) {
+                inWay = true;
+                refs.clear();
+                tags.clear();
+            } else if (inWay && name == QLatin1String("nd")) {
+                refs.append(attributes.value(QLatin1String("ref")).toLongLong());
+            } else if (inWay && name == QLatin1String("tag")) {
+                tags.insert(attributes.value(QLatin1String("k")).toString(),
+                            attributes.value(QLatin1String("v")).toString());
+            }
+        } else if (token == QXmlStreamReader::EndElement && xml.name() == QLatin1String("way")) {
+            addWay(refs, tags);
+            inWay = false;
+        }
+    }
+
+    if (xml.hasError()) {
+        *errorString = xml.errorString();
+        return false;
+    }
+    return true;
+}
+
+quint32 OsmReader::graphNode(qint64 id)
+{
+    QHash<qint64, quint32>::const_iterator it = m_graphNodes.constFind(id);
+    if (it != m_graphNodes.constEnd())
+        return it.value();
+    const Node &node = m_osmNodes[id];
+    const quint32 index = m_builder->addNode(fromFixed(node.latitude), fromFixed(node.longitude));
+    m_graphNodes.insert(id, index);
+    return index;
+}
+
+void OsmReader::addWay(const QVector<qint64> &refs, const QHash<QString, QString> &tags)
+{
+    const int roadClass = ::roadClass(tags.value(QLatin1String("highway")));
+    if (roadClass < 0 || tags.value(QLatin1String("area")) == QLatin1String("yes"))
+        return;
+
+    int access = defaultAccess(roadClass);
+    if (isNo(tags.value(QLatin1String("access"))))
+        access = 0;
+    applyAccess(tags, "vehicle", CarAccess | BicycleAccess, &access);
+    applyAccess(tags, "motor_vehicle", CarAccess, &access);
+    applyAccess(tags, "motorcar", CarAccess, &access);
+    applyAccess(tags, "bicycle", BicycleAccess, &access);
+    applyAccess(tags, "foot", FootAccess, &access);
+    if (!access)
+        return;
+
+    // Pedestrians ignore one way restrictions, cyclists only when told so.
+    const QString oneway = tags.value(QLatin1String("oneway"));
+    int direction = 0;
+    if (oneway == QLatin1String("-1") || oneway == QLatin1String("reverse"))
+        direction = -1;
+    else if (isYes(oneway))
+        direction = 1;
+    else if (oneway.isEmpty() && (roadClass == Motorway
+                                  || tags.value(QLatin1String("junction")) == QLatin1String("roundabout")))
+        direction = 1;
+    int exempt = FootAccess;
+    if (isNo(tags.value(QLatin1String("oneway:bicycle"))))
+        exempt |= BicycleAccess;
+    const int forward = direction < 0 ? access & exempt : access;
+    const int backward = direction > 0 ? access & exempt : access;
+
+    QString name = tags.value(QLatin1String("name"));
+    if (name.isEmpty())
+        name = tags.value(QLatin1String("ref"));
+    const quint32 nameIndex = m_builder->addName(name);
+
+    // Ways of clipped extracts may reference nodes outside of the extract.
+    for (int i = 0; i + 1 < refs.size(); ++i) {
+        if (!m_osmNodes.contains(refs.at(i)) || !m_osmNodes.contains(refs.at(i + 1)))
+            continue;
+        const quint32 from = graphNode(refs.at(i));
+        const quint32 to = graphNode(refs.at(i + 1));
+        if (forward)
+            m_builder->addArc(from, to, roadClass, forward, nameIndex);
+        if (backward)
+            m_builder->addArc(to, from, roadClass, backward, nameIndex);
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("qgeoroutegraphbuilder"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+        "Builds a routing graph for the offline geo services plugin from an OpenStreetMap XML extract."));
+    parser.addHelpOption();
+    parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("OpenStreetMap XML file (.osm)."));
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Routing graph file to write."));
+    parser.process(app);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 2)
+        parser.showHelp(1);
+
+    QTextStream err(stderr);
+    QFile input(arguments.at(0));
+    if (!input.open(QIODevice::ReadOnly)) {
+        err << input.fileName() << ": " << input.errorString() << endl;
+        return 1;
+    }
+
+    QGeoRoutingGraphBuilderOffline builder;
+    QString errorString;
+    OsmReader reader(&builder);
+    if (!reader.read(&input, &errorString)) {
+        err << input.fileName() << ": " << errorString << endl;
+        return 1;
+    }
+    err << "Read " << builder.nodeCount() << " nodes and " << builder.arcCount() << " arcs" << endl;
+
+    if (!builder.write(arguments.at(1), &errorString)) {
+        err << arguments.at(1) << ": " << errorString << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,16 @@
+QT = core positioning-private
+
+OFFLINE_PLUGIN = $$PWD/../../plugins/geoservices/offline
+INCLUDEPATH += $$OFFLINE_PLUGIN
+
+HEADERS += \
+    $$OFFLINE_PLUGIN/qgeoroutinggraphoffline.h \
+    $$OFFLINE_PLUGIN/qgeoroutinggraphbuilderoffline.h
+
+SOURCES += \
+    main.cpp \
+    $$OFFLINE_PLUGIN/qgeoroutinggraphoffline.cpp \
+    $$OFFLINE_PLUGIN/qgeoroutinggraphbuilderoffline.cpp
+
+QMAKE_TARGET_DESCRIPTION = "Qt Location Offline Routing Graph Builder"
+load(qt_tool)
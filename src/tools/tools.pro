@@ -0,0 +1,5 @@
+TEMPLATE = subdirs
+
+QT_FOR_CONFIG += location-private
+
+qtConfig(geoservices_offline): SUBDIRS += qgeoroutegraphbuilder
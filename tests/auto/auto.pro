@@ -32,7 +32,8 @@ qtHaveModule(location) {
     #misc tests
     SUBDIRS +=  qmlinterface \
            cmake \
-           doublevectors
+           doublevectors \
+           qwebmercator
 
     #Map and Navigation tests
     SUBDIRS += geotestplugin \
@@ -43,7 +44,17 @@ qtHaveModule(location) {
            qgeocodingmanager \
            qgeomaneuver \
            qgeotiledmapscene \
+           qgeotileprefetchjob \
+           qgeotilefreshness \
+           qgeofiletilecachewriter \
+           qgeofiletilecache \
+           qgeotileatlas \
+           qgeoclipregion \
            qgeoroute \
+           qgeoroutematch \
+           qgeoroutematrix \
+           qgeorouteparserosrmv5 \
+           qgeorouteprogresstracker \
            qgeoroutereply \
            qgeorouterequest \
            qgeoroutesegment \
@@ -57,9 +68,13 @@ qtHaveModule(location) {
            nokia_services \
            qgeocameratiles
 
+    qtHaveModule(concurrent): SUBDIRS += qgeoroutinggraphoffline \
+                                         qgeofiletilecacheosm
+
     qtHaveModule(quick) {
         SUBDIRS += declarative_core \
-                declarative_geoshape
+                declarative_geoshape \
+                qgeomappolylinegeometry
 
         !mac: SUBDIRS += declarative_ui
 
@@ -64,6 +64,14 @@ Item {
              coordinateList[coordinateCount] = {'latitude': center.latitude, 'longitude': center.longitude}
              coordinateCount++
          }
+
+         MapQuickItem {
+             id: movingItem
+             property var positions: []
+             anchorPoint: Qt.point(5, 5)
+             sourceItem: Rectangle { width: 10; height: 10 }
+             onXChanged: positions.push(x)
+         }
     }
 
     function toMercator(coord) {
@@ -133,5 +141,48 @@ Item {
                 lastLatitude = coordinate.latitude
             }
         }
+
+        function waitForX(item, x) {
+            tryVerify(function() { return Math.abs(item.x - x) <= 0.5 }, 2000)
+        }
+
+        function test_quick_item_coordinate_animation() {
+            centerBehavior.enabled = false
+            map.center = QtPositioning.coordinate(10, 10)
+            movingItem.coordinateAnimationDuration = 0
+            movingItem.coordinate = map.center
+            waitForX(movingItem, 45)
+
+            // The coordinate changes right away, the item follows
+            movingItem.coordinateAnimationDuration = 500
+            movingItem.positions = []
+            var target = map.toCoordinate(Qt.point(90, 50))
+            movingItem.coordinate = target
+            compare(movingItem.coordinate.latitude, target.latitude)
+            compare(movingItem.coordinate.longitude, target.longitude)
+            verify(Math.abs(movingItem.x - 45) <= 0.5)
+            waitForX(movingItem, 85)
+            verify(Math.abs(movingItem.y - 45) <= 0.5)
+
+            verify(movingItem.positions.length > 2)
+            for (var i = 1; i < movingItem.positions.length; ++i)
+                verify(movingItem.positions[i] > movingItem.positions[i - 1])
+
+            // A new coordinate set on the way starts from where the item is
+            movingItem.coordinateAnimationDuration = 2000
+            movingItem.coordinate = map.toCoordinate(Qt.point(10, 50))
+            tryVerify(function() { return movingItem.x < 80 })
+            var x = movingItem.x
+            verify(x < 85 && x > 5)
+            movingItem.positions = []
+            movingItem.coordinate = map.toCoordinate(Qt.point(90, 50))
+            tryVerify(function() { return movingItem.positions.length > 0 })
+            verify(movingItem.positions[0] >= x - 0.5)
+
+            // Without a duration the item jumps
+            movingItem.coordinateAnimationDuration = 0
+            movingItem.coordinate = map.toCoordinate(Qt.point(20, 50))
+            waitForX(movingItem, 15)
+        }
     }
 }
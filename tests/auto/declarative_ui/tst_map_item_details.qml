@@ -89,6 +89,43 @@ Item {
         SignalSpy {id: extMapPolylinePathChanged; target: parent; signalName: "pathChanged"}
     }
 
+    MapPolyline {
+        id: extMapPolylineTrack
+    }
+
+    MapPolyline {
+        id: extMapPolylinePacked
+        SignalSpy {id: extMapPolylinePackedPathChanged; target: parent; signalName: "pathChanged"}
+    }
+
+    MapPolyline {
+        id: extMapPolylineShared
+        geoPath: extMapPolylinePacked.geoPath
+    }
+
+    MapPolygon {
+        id: extMapPolygonSync
+        color: 'darkgrey'
+        border.width: 2
+        path: [
+            { latitude: 25, longitude: 5 },
+            { latitude: 20, longitude: 10 },
+            { latitude: 15, longitude: 5 }
+        ]
+    }
+
+    MapPolygon {
+        id: extMapPolygonAsync
+        asynchronous: true
+        color: 'darkgrey'
+        border.width: 2
+        path: [
+            { latitude: 25, longitude: 5 },
+            { latitude: 20, longitude: 10 },
+            { latitude: 15, longitude: 5 }
+        ]
+    }
+
     MapRectangle {
         id: extMapRectDateline
         color: 'darkcyan'
@@ -197,6 +234,16 @@ Item {
         }
     }
 
+    MapCircle {
+        id: extMapCircleSmall
+        color: 'darkmagenta'
+        center {
+            latitude: 10
+            longitude: 10
+        }
+        radius: 20000
+    }
+
     MapCircle {
         id: extMapCircleEdge
         color: 'darkmagenta'
@@ -360,6 +407,112 @@ Item {
             verify(extMapPolygon.path.length == 0)
         }
 
+        function test_polygon_asynchronous()
+        {
+            compare(extMapPolygonSync.asynchronous, false)
+            compare(extMapPolygonAsync.asynchronous, true)
+            map.center = extMapPolygonSync.path[1]
+            map.addMapItem(extMapPolygonSync)
+            map.addMapItem(extMapPolygonAsync)
+            verify(LocationTestHelper.waitForPolished(map))
+            verify(extMapPolygonSync.width > 0)
+
+            // The geometry built on a worker thread matches the one built in place
+            tryCompare(extMapPolygonAsync, "width", extMapPolygonSync.width)
+            compare(extMapPolygonAsync.height, extMapPolygonSync.height)
+            compare(extMapPolygonAsync.x, extMapPolygonSync.x)
+            compare(extMapPolygonAsync.y, extMapPolygonSync.y)
+
+            extMapPolygonSync.addCoordinate(QtPositioning.coordinate(15, 15))
+            extMapPolygonAsync.addCoordinate(QtPositioning.coordinate(15, 15))
+            verify(LocationTestHelper.waitForPolished(map))
+            tryCompare(extMapPolygonAsync, "width", extMapPolygonSync.width)
+            compare(extMapPolygonAsync.height, extMapPolygonSync.height)
+
+            // Results built for a previous zoom level are not shown
+            map.zoomLevel = map.zoomLevel + 1
+            verify(LocationTestHelper.waitForPolished(map))
+            tryCompare(extMapPolygonAsync, "width", extMapPolygonSync.width)
+            compare(extMapPolygonAsync.x, extMapPolygonSync.x)
+
+            map.zoomLevel = map.zoomLevel - 1
+            map.removeMapItem(extMapPolygonAsync)
+            map.removeMapItem(extMapPolygonSync)
+        }
+
+        function test_circle_small()
+        {
+            map.center = extMapCircleSmall.center
+            map.zoomLevel = 7
+            map.addMapItem(extMapCircleSmall)
+            verify(LocationTestHelper.waitForPolished(map))
+
+            // Laid out in map projection, a small circle is still round on screen
+            var center = map.fromCoordinate(extMapCircleSmall.center, false)
+            var east = map.fromCoordinate(extMapCircleSmall.center.atDistanceAndAzimuth(extMapCircleSmall.radius, 90), false)
+            var diameter = 2 * (east.x - center.x)
+            verify(diameter > 20)
+            fuzzyCompare(extMapCircleSmall.width, diameter, 2)
+            fuzzyCompare(extMapCircleSmall.height, diameter, 2)
+            fuzzyCompare(extMapCircleSmall.x + extMapCircleSmall.width / 2, center.x, 2)
+            fuzzyCompare(extMapCircleSmall.y + extMapCircleSmall.height / 2, center.y, 2)
+
+            // Triangulated when batched, with the same bounds
+            map.batchMapItems = true
+            verify(LocationTestHelper.waitForPolished(map))
+            fuzzyCompare(extMapCircleSmall.width, diameter, 2)
+            fuzzyCompare(extMapCircleSmall.height, diameter, 2)
+            map.batchMapItems = false
+
+            // Fewer samples once zoomed out, but still round
+            map.zoomLevel = 5
+            verify(LocationTestHelper.waitForPolished(map))
+            fuzzyCompare(extMapCircleSmall.width, extMapCircleSmall.height, 1)
+
+            map.removeMapItem(extMapCircleSmall)
+            map.center = mapDefaultCenter
+        }
+
+        function test_batch_map_items()
+        {
+            compare(map.batchMapItems, false)
+            map.center = extMapPolygonSync.path[1]
+            map.addMapItem(extMapPolygonSync)
+            verify(LocationTestHelper.waitForPolished(map))
+            var width = extMapPolygonSync.width
+            var height = extMapPolygonSync.height
+            var x = extMapPolygonSync.x
+            var y = extMapPolygonSync.y
+
+            // Batching changes where the item is drawn, not its geometry
+            map.batchMapItems = true
+            compare(map.batchMapItems, true)
+            wait(50)
+            compare(extMapPolygonSync.width, width)
+            compare(extMapPolygonSync.height, height)
+            compare(extMapPolygonSync.x, x)
+            compare(extMapPolygonSync.y, y)
+
+            // Batched items still follow the camera, and can come and go
+            map.zoomLevel = map.zoomLevel + 1
+            verify(LocationTestHelper.waitForPolished(map))
+            verify(extMapPolygonSync.width > width)
+            extMapPolygonSync.visible = false
+            wait(50)
+            extMapPolygonSync.visible = true
+            map.removeMapItem(extMapPolygonSync)
+            wait(50)
+            map.addMapItem(extMapPolygonSync)
+            verify(LocationTestHelper.waitForPolished(map))
+
+            map.batchMapItems = false
+            map.zoomLevel = map.zoomLevel - 1
+            verify(LocationTestHelper.waitForPolished(map))
+            compare(extMapPolygonSync.width, width)
+            compare(extMapPolygonSync.x, x)
+            map.removeMapItem(extMapPolygonSync)
+        }
+
         function test_polyline()
         {
             compare (extMapPolyline.line.width, 1.0)
@@ -395,6 +548,67 @@ Item {
             verify(extMapPolyline.path.length == 0)
         }
 
+        function test_polyline_maximum_path_length()
+        {
+            map.addMapItem(extMapPolylineTrack)
+            compare(extMapPolylineTrack.maximumPathLength, 0)
+            for (var i = 0; i < 10; ++i)
+                extMapPolylineTrack.addCoordinate(QtPositioning.coordinate(10 + i, 10 + i))
+            compare(extMapPolylineTrack.pathLength(), 10)
+
+            extMapPolylineTrack.maximumPathLength = 4
+            compare(extMapPolylineTrack.pathLength(), 4)
+            compare(extMapPolylineTrack.coordinateAt(0).latitude, 16)
+
+            extMapPolylineTrack.addCoordinate(QtPositioning.coordinate(20, 20))
+            extMapPolylineTrack.addCoordinate(QtPositioning.coordinate(21, 21))
+            compare(extMapPolylineTrack.pathLength(), 4)
+            compare(extMapPolylineTrack.coordinateAt(0).latitude, 18)
+            compare(extMapPolylineTrack.coordinateAt(3).latitude, 21)
+
+            // assigned paths are shortened too
+            extMapPolylineTrack.path = [{ latitude: 1, longitude: 1 }, { latitude: 2, longitude: 2 },
+                                        { latitude: 3, longitude: 3 }, { latitude: 4, longitude: 4 },
+                                        { latitude: 5, longitude: 5 }]
+            compare(extMapPolylineTrack.pathLength(), 4)
+            compare(extMapPolylineTrack.coordinateAt(0).latitude, 2)
+            extMapPolylineTrack.insertCoordinate(0, QtPositioning.coordinate(0, 0))
+            compare(extMapPolylineTrack.pathLength(), 4)
+            compare(extMapPolylineTrack.coordinateAt(0).latitude, 2)
+
+            extMapPolylineTrack.maximumPathLength = -1
+            compare(extMapPolylineTrack.maximumPathLength, 0)
+            extMapPolylineTrack.addCoordinate(QtPositioning.coordinate(22, 22))
+            compare(extMapPolylineTrack.pathLength(), 5)
+            map.removeMapItem(extMapPolylineTrack)
+        }
+
+        function test_polyline_packed_path()
+        {
+            var latLon = new Float64Array([10, 20, 11, 21, 12, 22])
+            extMapPolylinePacked.path = latLon
+            compare(extMapPolylinePackedPathChanged.count, 1)
+            compare(extMapPolylinePacked.pathLength(), 3)
+            compare(extMapPolylinePacked.coordinateAt(1).latitude, 11)
+            compare(extMapPolylinePacked.coordinateAt(1).longitude, 21)
+            compare(extMapPolylineShared.pathLength(), 3)
+
+            var packed = new Float64Array(extMapPolylinePacked.packedPath())
+            compare(packed.length, 6)
+            compare(packed[4], 12)
+            compare(packed[5], 22)
+
+            // an ArrayBuffer works as well, the same path is not an update
+            extMapPolylinePacked.path = latLon.buffer
+            compare(extMapPolylinePackedPathChanged.count, 1)
+
+            // odd number of values or out of range latitudes are rejected
+            extMapPolylinePacked.path = new Float64Array([10, 20, 11])
+            extMapPolylinePacked.path = new Float64Array([100, 20])
+            compare(extMapPolylinePacked.pathLength(), 3)
+            compare(extMapPolylinePackedPathChanged.count, 1)
+        }
+
     /*
 
      (0,0)   ---------------------------------------------------- (600,0)
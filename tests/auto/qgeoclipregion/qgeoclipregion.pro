@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgeoclipregion
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeoclipregion.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,311 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+
+//TESTED_COMPONENT=src/location/maps
+
+#include "qgeoclipregion_p.h"
+
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+typedef QVector<QDoubleVector2D> Points;
+typedef QVector<QWorldPoint> WorldPoints;
+
+static double area(const Points &polygon)
+{
+    double a = 0.0;
+    for (int i = 0; i < polygon.size(); ++i) {
+        const QDoubleVector2D &p = polygon.at(i);
+        const QDoubleVector2D &q = polygon.at((i + 1) % polygon.size());
+        a += p.x() * q.y() - q.x() * p.y();
+    }
+    return qAbs(a) * 0.5;
+}
+
+static bool fuzzyEqual(const QDoubleVector2D &a, const QDoubleVector2D &b)
+{
+    return qAbs(a.x() - b.x()) < 1e-12 && qAbs(a.y() - b.y()) < 1e-12;
+}
+
+static WorldPoints toWorld(const Points &points)
+{
+    WorldPoints world;
+    QWorldPoint::fromMercator(points, &world);
+    return world;
+}
+
+// Crossings are rounded to the nearest world point
+static bool closeEnough(const QWorldPoint &a, const QWorldPoint &b)
+{
+    return qAbs(a.x() - b.x()) <= 1 && qAbs(a.y() - b.y()) <= 1;
+}
+
+class tst_QGeoClipRegion : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void convexity();
+    void contains();
+    void classifyBox();
+    void classifyPoints();
+    void clipPolygon();
+    void clipPolyline();
+    void nonConvex();
+    void worldPoints();
+    void worldPointsAtHighZoom();
+
+private:
+    // A tilted diamond, as the projectable region of a rotated camera may be
+    QGeoClipRegion diamond(bool clockwise = false) const;
+};
+
+QGeoClipRegion tst_QGeoClipRegion::diamond(bool clockwise) const
+{
+    Points region;
+    region << QDoubleVector2D(0.5, 0.0) << QDoubleVector2D(1.0, 0.5)
+           << QDoubleVector2D(0.5, 1.0) << QDoubleVector2D(0.0, 0.5);
+    if (clockwise)
+        std::reverse(region.begin(), region.end());
+    QGeoClipRegion clipRegion;
+    clipRegion.setRegion(region);
+    return clipRegion;
+}
+
+void tst_QGeoClipRegion::convexity()
+{
+    QGeoClipRegion empty;
+    QVERIFY(empty.isEmpty());
+    QVERIFY(!empty.isConvex());
+
+    QVERIFY(diamond().isConvex());
+    QVERIFY(diamond(true).isConvex());
+
+    QGeoClipRegion notch;
+    notch.setRegion(Points() << QDoubleVector2D(0, 0) << QDoubleVector2D(1, 0) << QDoubleVector2D(1, 1)
+                             << QDoubleVector2D(0.5, 0.5) << QDoubleVector2D(0, 1));
+    QVERIFY(!notch.isEmpty());
+    QVERIFY(!notch.isConvex());
+
+    // Fewer than three points cannot clip anything
+    QGeoClipRegion line;
+    line.setRegion(Points() << QDoubleVector2D(0, 0) << QDoubleVector2D(1, 1));
+    QVERIFY(line.isEmpty());
+}
+
+void tst_QGeoClipRegion::contains()
+{
+    for (bool clockwise : { false, true }) {
+        const QGeoClipRegion region = diamond(clockwise);
+        QVERIFY(region.contains(QDoubleVector2D(0.5, 0.5)));
+        QVERIFY(region.contains(QDoubleVector2D(0.7, 0.6)));
+        QVERIFY(!region.contains(QDoubleVector2D(0.1, 0.1)));
+        QVERIFY(!region.contains(QDoubleVector2D(2.0, 0.5)));
+        // The border is left to the clipper
+        QVERIFY(!region.contains(QDoubleVector2D(0.75, 0.25)));
+    }
+}
+
+void tst_QGeoClipRegion::classifyBox()
+{
+    const QGeoClipRegion region = diamond();
+    QCOMPARE(region.classify(QDoubleVector2D(0.4, 0.4), QDoubleVector2D(0.6, 0.6)), QGeoClipRegion::Inside);
+    QCOMPARE(region.classify(QDoubleVector2D(2.0, 2.0), QDoubleVector2D(3.0, 3.0)), QGeoClipRegion::Outside);
+    // Overlaps the bounds of the region, but lies beyond one of its edges
+    QCOMPARE(region.classify(QDoubleVector2D(0.0, 0.0), QDoubleVector2D(0.2, 0.2)), QGeoClipRegion::Outside);
+    QCOMPARE(region.classify(QDoubleVector2D(0.0, 0.0), QDoubleVector2D(0.5, 0.5)), QGeoClipRegion::Intersecting);
+    QCOMPARE(region.classify(QDoubleVector2D(-1.0, -1.0), QDoubleVector2D(2.0, 2.0)), QGeoClipRegion::Intersecting);
+
+    // Nothing is clipped by an empty region
+    QCOMPARE(QGeoClipRegion().classify(QDoubleVector2D(2.0, 2.0), QDoubleVector2D(3.0, 3.0)), QGeoClipRegion::Inside);
+}
+
+void tst_QGeoClipRegion::classifyPoints()
+{
+    const QGeoClipRegion region = diamond();
+    QCOMPARE(region.classify(Points()), QGeoClipRegion::Outside);
+
+    // The bounding box crosses the border, the points do not
+    const Points inside = Points() << QDoubleVector2D(0.1, 0.5) << QDoubleVector2D(0.5, 0.1)
+                                   << QDoubleVector2D(0.9, 0.5) << QDoubleVector2D(0.5, 0.9);
+    QCOMPARE(region.classify(inside), QGeoClipRegion::Inside);
+
+    // Beyond two different edges, but no single edge separates all of them
+    const Points around = Points() << QDoubleVector2D(0.1, 0.1) << QDoubleVector2D(0.9, 0.1);
+    QCOMPARE(region.classify(around), QGeoClipRegion::Intersecting);
+
+    const Points corner = Points() << QDoubleVector2D(0.05, 0.1) << QDoubleVector2D(0.1, 0.05)
+                                   << QDoubleVector2D(0.2, 0.2);
+    QCOMPARE(region.classify(corner), QGeoClipRegion::Outside);
+}
+
+void tst_QGeoClipRegion::clipPolygon()
+{
+    const QGeoClipRegion region = diamond();
+    QVector<Points> clipped;
+
+    // A square over the right half of the diamond keeps a triangle
+    region.clipPolygon(Points() << QDoubleVector2D(0.5, -1.0) << QDoubleVector2D(2.0, -1.0)
+                                << QDoubleVector2D(2.0, 2.0) << QDoubleVector2D(0.5, 2.0), &clipped);
+    QCOMPARE(clipped.size(), 1);
+    QCOMPARE(area(clipped.first()), 0.25);
+
+    // Covering everything gives the region back
+    region.clipPolygon(Points() << QDoubleVector2D(-1.0, -1.0) << QDoubleVector2D(2.0, -1.0)
+                                << QDoubleVector2D(2.0, 2.0) << QDoubleVector2D(-1.0, 2.0), &clipped);
+    QCOMPARE(clipped.size(), 1);
+    QCOMPARE(area(clipped.first()), 0.5);
+
+    region.clipPolygon(Points() << QDoubleVector2D(0.0, 0.0) << QDoubleVector2D(0.2, 0.0)
+                                << QDoubleVector2D(0.0, 0.2), &clipped);
+    QVERIFY(clipped.isEmpty());
+}
+
+void tst_QGeoClipRegion::clipPolyline()
+{
+    const QGeoClipRegion region = diamond();
+    QVector<Points> clipped;
+
+    // Crossing the whole region
+    region.clipPolyline(Points() << QDoubleVector2D(-1.0, 0.5) << QDoubleVector2D(2.0, 0.5), &clipped);
+    QCOMPARE(clipped.size(), 1);
+    QCOMPARE(clipped.first().size(), 2);
+    QVERIFY(fuzzyEqual(clipped.first().first(), QDoubleVector2D(0.0, 0.5)));
+    QVERIFY(fuzzyEqual(clipped.first().last(), QDoubleVector2D(1.0, 0.5)));
+
+    // Leaving and entering again splits the line, consecutive inner segments stay joined
+    const Points zigzag = Points() << QDoubleVector2D(0.5, 0.4) << QDoubleVector2D(0.5, 0.6)
+                                   << QDoubleVector2D(0.5, 2.0) << QDoubleVector2D(0.4, 0.5)
+                                   << QDoubleVector2D(0.6, 0.5);
+    region.clipPolyline(zigzag, &clipped);
+    QCOMPARE(clipped.size(), 2);
+    QCOMPARE(clipped.at(0).size(), 3);
+    QCOMPARE(clipped.at(0).at(1), QDoubleVector2D(0.5, 0.6));
+    QVERIFY(fuzzyEqual(clipped.at(0).last(), QDoubleVector2D(0.5, 1.0)));
+    QCOMPARE(clipped.at(1).size(), 3);
+    QCOMPARE(clipped.at(1).last(), QDoubleVector2D(0.6, 0.5));
+
+    region.clipPolyline(Points() << QDoubleVector2D(0.0, 0.0) << QDoubleVector2D(0.2, 0.1), &clipped);
+    QVERIFY(clipped.isEmpty());
+}
+
+void tst_QGeoClipRegion::nonConvex()
+{
+    // A U shape: the polyline across its opening is split in two
+    QGeoClipRegion region;
+    region.setRegion(Points() << QDoubleVector2D(0.0, 0.0) << QDoubleVector2D(0.25, 0.0)
+                              << QDoubleVector2D(0.25, 0.75) << QDoubleVector2D(0.75, 0.75)
+                              << QDoubleVector2D(0.75, 0.0) << QDoubleVector2D(1.0, 0.0)
+                              << QDoubleVector2D(1.0, 1.0) << QDoubleVector2D(0.0, 1.0));
+    QVERIFY(!region.isConvex());
+    QVERIFY(region.contains(QDoubleVector2D(0.1, 0.5)));
+    QVERIFY(!region.contains(QDoubleVector2D(0.5, 0.5)));
+    QCOMPARE(region.classify(QDoubleVector2D(0.4, 0.1), QDoubleVector2D(0.6, 0.2)), QGeoClipRegion::Intersecting);
+
+    QVector<Points> clipped;
+    region.clipPolyline(Points() << QDoubleVector2D(-1.0, 0.5) << QDoubleVector2D(2.0, 0.5), &clipped);
+    QCOMPARE(clipped.size(), 2);
+}
+
+void tst_QGeoClipRegion::worldPoints()
+{
+    const QGeoClipRegion region = diamond();
+    const qint64 world = QWorldPoint::worldSize();
+    QVERIFY(region.contains(QWorldPoint(world / 2, world / 2)));
+    QVERIFY(!region.contains(QWorldPoint(world / 10, world / 10)));
+    QCOMPARE(region.classify(toWorld(Points() << QDoubleVector2D(0.1, 0.5) << QDoubleVector2D(0.5, 0.1)
+                                              << QDoubleVector2D(0.9, 0.5) << QDoubleVector2D(0.5, 0.9))),
+             QGeoClipRegion::Inside);
+    QCOMPARE(region.classify(toWorld(Points() << QDoubleVector2D(0.05, 0.1) << QDoubleVector2D(0.1, 0.05))),
+             QGeoClipRegion::Outside);
+
+    QVector<WorldPoints> clipped;
+    region.clipPolyline(toWorld(Points() << QDoubleVector2D(-1.0, 0.5) << QDoubleVector2D(2.0, 0.5)), &clipped);
+    QCOMPARE(clipped.size(), 1);
+    QCOMPARE(clipped.first().size(), 2);
+    QVERIFY(closeEnough(clipped.first().first(), QWorldPoint(0, world / 2)));
+    QVERIFY(closeEnough(clipped.first().last(), QWorldPoint(world, world / 2)));
+
+    // Points inside the region are kept as they are
+    const WorldPoints zigzag = toWorld(Points() << QDoubleVector2D(0.5, 0.4) << QDoubleVector2D(0.5, 0.6)
+                                                << QDoubleVector2D(0.5, 2.0) << QDoubleVector2D(0.4, 0.5)
+                                                << QDoubleVector2D(0.6, 0.5));
+    region.clipPolyline(zigzag, &clipped);
+    QCOMPARE(clipped.size(), 2);
+    QCOMPARE(clipped.at(0).at(1), zigzag.at(1));
+    QCOMPARE(clipped.at(1).last(), zigzag.last());
+
+    region.clipPolygon(toWorld(Points() << QDoubleVector2D(0.5, -1.0) << QDoubleVector2D(2.0, -1.0)
+                                        << QDoubleVector2D(2.0, 2.0) << QDoubleVector2D(0.5, 2.0)), &clipped);
+    QCOMPARE(clipped.size(), 1);
+    Points triangle;
+    for (const QWorldPoint &p : clipped.first())
+        triangle << p.toMercator();
+    QVERIFY(qAbs(area(triangle) - 0.25) < 1e-12);
+
+    // Non-convex regions go through Clipper without leaving fixed point
+    QGeoClipRegion u;
+    u.setRegion(Points() << QDoubleVector2D(0.0, 0.0) << QDoubleVector2D(0.25, 0.0)
+                         << QDoubleVector2D(0.25, 0.75) << QDoubleVector2D(0.75, 0.75)
+                         << QDoubleVector2D(0.75, 0.0) << QDoubleVector2D(1.0, 0.0)
+                         << QDoubleVector2D(1.0, 1.0) << QDoubleVector2D(0.0, 1.0));
+    QVERIFY(u.contains(QWorldPoint(world / 10, world / 2)));
+    QVERIFY(!u.contains(QWorldPoint(world / 2, world / 2)));
+    u.clipPolyline(toWorld(Points() << QDoubleVector2D(-1.0, 0.5) << QDoubleVector2D(2.0, 0.5)), &clipped);
+    QCOMPARE(clipped.size(), 2);
+}
+
+void tst_QGeoClipRegion::worldPointsAtHighZoom()
+{
+    // A region of 1024 pixels at zoom level 22, where the map is 2^30 pixels wide
+    const double pixel = 1.0 / (1 << 30);
+    const QDoubleVector2D center(0.53720, 0.33970);
+    QGeoClipRegion region;
+    region.setRegion(Points() << center + QDoubleVector2D(0.0, -512.0) * pixel
+                              << center + QDoubleVector2D(512.0, 0.0) * pixel
+                              << center + QDoubleVector2D(0.0, 512.0) * pixel
+                              << center + QDoubleVector2D(-512.0, 0.0) * pixel);
+
+    // A line a thousandth of a pixel away from a vertex of the region is still told apart
+    QVector<WorldPoints> clipped;
+    const WorldPoints line = toWorld(Points() << center + QDoubleVector2D(-1000.0, 0.001) * pixel
+                                              << center + QDoubleVector2D(1000.0, 0.001) * pixel);
+    region.clipPolyline(line, &clipped);
+    QCOMPARE(clipped.size(), 1);
+    const QDoubleVector2D first = (clipped.first().first().toMercator() - center) / pixel;
+    const QDoubleVector2D last = (clipped.first().last().toMercator() - center) / pixel;
+    QVERIFY2(qAbs(first.x() + 511.999) < 1e-4, qPrintable(QString::number(first.x(), 'g', 12)));
+    QVERIFY2(qAbs(last.x() - 511.999) < 1e-4, qPrintable(QString::number(last.x(), 'g', 12)));
+    QVERIFY(qAbs(first.y() - 0.001) < 1e-4);
+}
+
+QTEST_APPLESS_MAIN(tst_QGeoClipRegion)
+
+#include "tst_qgeoclipregion.moc"
@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgeofiletilecache
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeofiletilecache.cpp
+
+QT += location-private positioning-private testlib
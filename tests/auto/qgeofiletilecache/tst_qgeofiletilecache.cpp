@@ -0,0 +1,225 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include "qgeofiletilecache_p.h"
+#include "qgeofiletilecachewriter_p.h"
+#include "qgeotilespec_p.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+class TileCache : public QGeoFileTileCache
+{
+public:
+    explicit TileCache(const QString &directory)
+        : QGeoFileTileCache(directory)
+    {
+    }
+
+    using QGeoFileTileCache::init;
+
+    void flush()
+    {
+        writer_->flush();
+    }
+};
+
+class tst_QGeoFileTileCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void decodedWritten();
+    void decodedDisabled();
+    void decodedRestartBudget();
+    void decodedEviction();
+    void decodedEvictionWhenDisabled();
+    void clearMapIdSidecars();
+
+private:
+    void storeDecoded();
+
+    QScopedPointer<QTemporaryDir> dir_;
+    QByteArray png_;
+    QGeoTileSpec spec_;
+    QString tileFilename_;
+    QString decodedFilename_;
+};
+
+void tst_QGeoFileTileCache::initTestCase()
+{
+    QImage image(256, 256, QImage::Format_RGB32);
+    image.fill(Qt::gray);
+    QBuffer buffer(&png_);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(image.save(&buffer, "PNG"));
+
+    spec_ = QGeoTileSpec(QStringLiteral("test"), 1, 2, 1, 1);
+}
+
+void tst_QGeoFileTileCache::init()
+{
+    dir_.reset(new QTemporaryDir);
+    QVERIFY(dir_->isValid());
+    tileFilename_ = QGeoFileTileCache::tileSpecToFilenameDefault(spec_, QStringLiteral("png"), dir_->path());
+    decodedFilename_ = tileFilename_ + QStringLiteral(".decoded");
+}
+
+// Leaves the tile and its decoded copy on disk
+void tst_QGeoFileTileCache::storeDecoded()
+{
+    TileCache cache(dir_->path());
+    cache.init();
+    cache.setMaxDecodedUsage(1024 * 1024);
+    cache.insert(spec_, png_, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    QVERIFY(!cache.get(spec_).isNull());
+    cache.flush();
+    QVERIFY(QFileInfo::exists(tileFilename_));
+    QVERIFY(QFileInfo::exists(decodedFilename_));
+}
+
+void tst_QGeoFileTileCache::decodedWritten()
+{
+    TileCache cache(dir_->path());
+    cache.init();
+    cache.setMaxDecodedUsage(1024 * 1024);
+    cache.insert(spec_, png_, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    QCOMPARE(cache.diskUsage(), png_.size());
+
+    // Loading the tile from disk stores its decoded copy next to it
+    QVERIFY(!cache.get(spec_).isNull());
+    QVERIFY(cache.decodedUsage() > 0);
+    cache.flush();
+    QVERIFY(QFileInfo::exists(decodedFilename_));
+    QCOMPARE(qint64(cache.diskUsage()), png_.size() + QFileInfo(decodedFilename_).size());
+}
+
+void tst_QGeoFileTileCache::decodedDisabled()
+{
+    TileCache cache(dir_->path());
+    cache.init();
+    QCOMPARE(cache.maxDecodedUsage(), 0);
+    cache.insert(spec_, png_, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+
+    QVERIFY(!cache.get(spec_).isNull());
+    QCOMPARE(cache.decodedUsage(), 0);
+    cache.flush();
+    QVERIFY(QFileInfo::exists(tileFilename_));
+    QVERIFY(!QFileInfo::exists(decodedFilename_));
+    QCOMPARE(cache.diskUsage(), png_.size());
+}
+
+void tst_QGeoFileTileCache::decodedRestartBudget()
+{
+    storeDecoded();
+    if (QTest::currentTestFailed())
+        return;
+    const qint64 expected = QFileInfo(tileFilename_).size() + QFileInfo(decodedFilename_).size();
+
+    // The decoded copy is counted when the tiles are loaded, with or without decoding
+    {
+        TileCache cache(dir_->path());
+        cache.init();
+        QCOMPARE(qint64(cache.diskUsage()), expected);
+    }
+    {
+        TileCache cache(dir_->path());
+        cache.setMaxDecodedUsage(1024 * 1024);
+        cache.init();
+        QCOMPARE(qint64(cache.diskUsage()), expected);
+    }
+}
+
+void tst_QGeoFileTileCache::decodedEviction()
+{
+    TileCache cache(dir_->path());
+    cache.init();
+    cache.setMaxDecodedUsage(1024 * 1024);
+    cache.insert(spec_, png_, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+    QVERIFY(!cache.get(spec_).isNull());
+    cache.flush();
+    QVERIFY(QFileInfo::exists(decodedFilename_));
+
+    cache.setMaxDiskUsage(1);
+    QCOMPARE(cache.diskUsage(), 0);
+    cache.flush();
+    QVERIFY(!QFileInfo::exists(tileFilename_));
+    QVERIFY(!QFileInfo::exists(decodedFilename_));
+}
+
+void tst_QGeoFileTileCache::decodedEvictionWhenDisabled()
+{
+    storeDecoded();
+    if (QTest::currentTestFailed())
+        return;
+
+    // A decoded copy left by an earlier run goes with its tile
+    TileCache cache(dir_->path());
+    cache.init();
+    QCOMPARE(cache.maxDecodedUsage(), 0);
+    QVERIFY(cache.diskUsage() > png_.size());
+    cache.setMaxDiskUsage(1);
+    QCOMPARE(cache.diskUsage(), 0);
+    cache.flush();
+    QVERIFY(!QFileInfo::exists(tileFilename_));
+    QVERIFY(!QFileInfo::exists(decodedFilename_));
+}
+
+void tst_QGeoFileTileCache::clearMapIdSidecars()
+{
+    storeDecoded();
+    if (QTest::currentTestFailed())
+        return;
+
+    TileCache cache(dir_->path());
+    cache.init();
+    QGeoTileFreshness freshness;
+    freshness.etag = "\"1\"";
+    cache.setFreshness(spec_, freshness);
+    cache.flush();
+    const QString freshnessFilename = tileFilename_ + QStringLiteral(".freshness");
+    QVERIFY(QFileInfo::exists(freshnessFilename));
+
+    cache.clearMapId(spec_.mapId());
+    QVERIFY(!QFileInfo::exists(tileFilename_));
+    QVERIFY(!QFileInfo::exists(freshnessFilename));
+    QVERIFY(!QFileInfo::exists(decodedFilename_));
+}
+
+QTEST_MAIN(tst_QGeoFileTileCache)
+
+#include "tst_qgeofiletilecache.moc"
@@ -0,0 +1,20 @@
+CONFIG += testcase
+TARGET = tst_qgeofiletilecacheosm
+
+plugin.path = ../../../src/plugins/geoservices/osm/
+
+SOURCES += tst_qgeofiletilecacheosm.cpp \
+           $$plugin.path/qgeofiletilecacheosm.cpp \
+           $$plugin.path/qgeotileproviderosm.cpp
+HEADERS += $$plugin.path/qgeofiletilecacheosm.h \
+           $$plugin.path/qgeotileproviderosm.h
+INCLUDEPATH += $$plugin.path
+
+qtHaveModule(sql) {
+    QT += sql
+    DEFINES += QT_OSM_MBTILES
+    HEADERS += $$plugin.path/qgeotilearchiveosm.h
+    SOURCES += $$plugin.path/qgeotilearchiveosm.cpp
+}
+
+QT += location-private positioning-private network concurrent testlib
@@ -0,0 +1,176 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeofiletilecacheosm.h"
+#include "qgeotileproviderosm.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtTest/QtTest>
+#ifdef QT_OSM_MBTILES
+#include <QtSql/QSqlDatabase>
+#include <QtSql/QSqlQuery>
+#endif
+
+QT_USE_NAMESPACE
+
+class TileCacheOsm : public QGeoFileTileCacheOsm
+{
+public:
+    TileCacheOsm(const QString &offlineDirectory, const QString &directory)
+    :   QGeoFileTileCacheOsm(QVector<QGeoTileProviderOsm *>() << provider(), offlineDirectory, directory)
+    {
+        init();
+    }
+
+    // Waits for the offline directory scan of the map
+    void waitForOfflineRegistry()
+    {
+        m_mapIdFutures[1].waitForFinished();
+    }
+
+private:
+    static QGeoTileProviderOsm *provider()
+    {
+        TileProvider *tileProvider = new TileProvider(QStringLiteral("http://localhost/%z/%x/%y.png"),
+                                                      QStringLiteral("png"),
+                                                      QStringLiteral("map"),
+                                                      QStringLiteral("data"));
+        return new QGeoTileProviderOsm(0,
+                                       QGeoMapType(QGeoMapType::StreetMap, QStringLiteral("Street Map"),
+                                                   QStringLiteral("Street map"), false, false, 1,
+                                                   QByteArrayLiteral("osm")),
+                                       QVector<TileProvider *>() << tileProvider,
+                                       QGeoCameraCapabilities());
+    }
+};
+
+class tst_QGeoFileTileCacheOsm : public QObject
+{
+    Q_OBJECT
+
+private slots:
+#ifdef QT_OSM_MBTILES
+    void archiveTmsFlip();
+#endif
+    void directoryScanFallback();
+
+private:
+    static QByteArray tileImage(const QColor &color);
+    static QColor tileColor(const QSharedPointer<QGeoTileTexture> &texture);
+};
+
+QByteArray tst_QGeoFileTileCacheOsm::tileImage(const QColor &color)
+{
+    QImage image(256, 256, QImage::Format_RGB32);
+    image.fill(color);
+
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+    return bytes;
+}
+
+QColor tst_QGeoFileTileCacheOsm::tileColor(const QSharedPointer<QGeoTileTexture> &texture)
+{
+    if (!texture || texture->image.isNull())
+        return QColor();
+    return texture->image.pixelColor(0, 0);
+}
+
+#ifdef QT_OSM_MBTILES
+void tst_QGeoFileTileCacheOsm::archiveTmsFlip()
+{
+    QTemporaryDir offlineDir;
+    QTemporaryDir cacheDir;
+    QVERIFY(offlineDir.isValid() && cacheDir.isValid());
+
+    // At zoom 2 the tile rows of the archive run from 3 in the north to 0 in the south
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), QStringLiteral("archive"));
+        db.setDatabaseName(QDir(offlineDir.path()).filePath(QStringLiteral("osm-l-1.mbtiles")));
+        QVERIFY(db.open());
+        QSqlQuery query(db);
+        QVERIFY(query.exec(QStringLiteral("CREATE TABLE metadata (name TEXT, value TEXT)")));
+        QVERIFY(query.exec(QStringLiteral("INSERT INTO metadata VALUES ('format', 'png')")));
+        QVERIFY(query.exec(QStringLiteral("CREATE TABLE tiles (zoom_level INTEGER, tile_column INTEGER, tile_row INTEGER, tile_data BLOB)")));
+        QVERIFY(query.prepare(QStringLiteral("INSERT INTO tiles VALUES (?, ?, ?, ?)")));
+        query.addBindValue(2);
+        query.addBindValue(1);
+        query.addBindValue(3);
+        query.addBindValue(tileImage(Qt::red));
+        QVERIFY(query.exec());
+        query.addBindValue(2);
+        query.addBindValue(1);
+        query.addBindValue(0);
+        query.addBindValue(tileImage(Qt::blue));
+        QVERIFY(query.exec());
+        query.finish();
+        db.close();
+    }
+    QSqlDatabase::removeDatabase(QStringLiteral("archive"));
+
+    TileCacheOsm cache(offlineDir.path(), cacheDir.path());
+    QCOMPARE(tileColor(cache.get(QGeoTileSpec(QStringLiteral("osm"), 1, 2, 1, 0))), QColor(Qt::red));
+    QCOMPARE(tileColor(cache.get(QGeoTileSpec(QStringLiteral("osm"), 1, 2, 1, 3))), QColor(Qt::blue));
+    QVERIFY(!cache.get(QGeoTileSpec(QStringLiteral("osm"), 1, 2, 0, 0)));
+}
+#endif
+
+void tst_QGeoFileTileCacheOsm::directoryScanFallback()
+{
+    QTemporaryDir offlineDir;
+    QTemporaryDir cacheDir;
+    QVERIFY(offlineDir.isValid() && cacheDir.isValid());
+
+    // Not a database, the cache has to fall back to the tiles found in the directory
+    QFile archive(QDir(offlineDir.path()).filePath(QStringLiteral("osm-l-1.mbtiles")));
+    QVERIFY(archive.open(QIODevice::WriteOnly));
+    archive.write("not an archive");
+    archive.close();
+
+    QVERIFY(QDir(offlineDir.path()).mkpath(QStringLiteral("2/1")));
+    QFile tile(QDir(offlineDir.path()).filePath(QStringLiteral("2/1/osm-l-1-2-1-0.png")));
+    QVERIFY(tile.open(QIODevice::WriteOnly));
+    tile.write(tileImage(Qt::green));
+    tile.close();
+
+    TileCacheOsm cache(offlineDir.path(), cacheDir.path());
+    cache.waitForOfflineRegistry();
+    QCOMPARE(tileColor(cache.get(QGeoTileSpec(QStringLiteral("osm"), 1, 2, 1, 0))), QColor(Qt::green));
+    QVERIFY(!cache.get(QGeoTileSpec(QStringLiteral("osm"), 1, 2, 1, 3)));
+}
+
+QTEST_MAIN(tst_QGeoFileTileCacheOsm)
+
+#include "tst_qgeofiletilecacheosm.moc"
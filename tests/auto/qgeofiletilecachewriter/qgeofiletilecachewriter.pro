@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgeofiletilecachewriter
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeofiletilecachewriter.cpp
+
+QT += location-private testlib
@@ -0,0 +1,214 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include "qgeofiletilecachewriter_p.h"
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+static QByteArray readFile(const QString &filename)
+{
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+static void writeFile(const QString &filename, const QByteArray &bytes)
+{
+    QFile file(filename);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(bytes);
+}
+
+class tst_QGeoFileTileCacheWriter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void coalescing();
+    void queuedRead();
+    void discard();
+    void flush();
+    void flushRunning();
+    void syncWrites();
+
+private:
+    QScopedPointer<QTemporaryDir> dir_;
+    QString path(const QString &name) const { return dir_->path() + QLatin1Char('/') + name; }
+};
+
+void tst_QGeoFileTileCacheWriter::init()
+{
+    dir_.reset(new QTemporaryDir);
+    QVERIFY(dir_->isValid());
+}
+
+// The writer thread is not started, so operations stay queued until flush()
+void tst_QGeoFileTileCacheWriter::coalescing()
+{
+    QGeoFileTileCacheWriter writer;
+    const QString a = path(QStringLiteral("a.png"));
+    const QString b = path(QStringLiteral("b.png"));
+
+    writer.write(a, QByteArray(100, 'x'));
+    writer.write(b, QByteArray(10, 'y'));
+    QCOMPARE(writer.queuedBytes(), qint64(110));
+
+    // Only the last operation on a file is kept
+    writer.write(a, QByteArray(30, 'z'));
+    QCOMPARE(writer.queuedBytes(), qint64(40));
+    writer.remove(b);
+    QCOMPARE(writer.queuedBytes(), qint64(30));
+    writer.write(b, QByteArray("last"));
+    QCOMPARE(writer.queuedBytes(), qint64(34));
+
+    writer.flush();
+    QCOMPARE(writer.queuedBytes(), qint64(0));
+    QCOMPARE(readFile(a), QByteArray(30, 'z'));
+    QCOMPARE(readFile(b), QByteArray("last"));
+}
+
+void tst_QGeoFileTileCacheWriter::queuedRead()
+{
+    QGeoFileTileCacheWriter writer;
+    const QString a = path(QStringLiteral("a.png"));
+    const QString b = path(QStringLiteral("b.png"));
+    writeFile(b, QByteArray("on disk"));
+
+    QByteArray bytes("unchanged");
+    QVERIFY(!writer.queued(a, &bytes));
+    QCOMPARE(bytes, QByteArray("unchanged"));
+
+    writer.write(a, QByteArray("pending"));
+    QVERIFY(writer.queued(a, &bytes));
+    QCOMPARE(bytes, QByteArray("pending"));
+    QVERIFY(writer.queued(a, 0));
+    QVERIFY(!QFile::exists(a));
+
+    // A pending removal is reported with empty bytes, the file is still there meanwhile
+    writer.remove(b);
+    QVERIFY(writer.queued(b, &bytes));
+    QVERIFY(bytes.isEmpty());
+    QVERIFY(QFile::exists(b));
+
+    writer.flush();
+    QVERIFY(!writer.queued(a, &bytes));
+    QVERIFY(!writer.queued(b, &bytes));
+    QCOMPARE(readFile(a), QByteArray("pending"));
+    QVERIFY(!QFile::exists(b));
+}
+
+void tst_QGeoFileTileCacheWriter::discard()
+{
+    QGeoFileTileCacheWriter writer;
+    const QString a = path(QStringLiteral("a.png"));
+    const QString b = path(QStringLiteral("b.png"));
+    writeFile(b, QByteArray("on disk"));
+
+    writer.write(a, QByteArray(50, 'x'));
+    writer.remove(b);
+    writer.discard();
+    QCOMPARE(writer.queuedBytes(), qint64(0));
+    QVERIFY(!writer.queued(a, 0));
+    QVERIFY(!writer.queued(b, 0));
+
+    writer.flush();
+    QVERIFY(!QFile::exists(a));
+    QCOMPARE(readFile(b), QByteArray("on disk"));
+}
+
+void tst_QGeoFileTileCacheWriter::flush()
+{
+    const QString a = path(QStringLiteral("a.png"));
+    const QString b = path(QStringLiteral("b.png"));
+    writeFile(b, QByteArray("on disk"));
+    {
+        QGeoFileTileCacheWriter writer;
+        writer.write(a, QByteArray("written"));
+        writer.remove(b);
+        writer.flush();
+        QCOMPARE(readFile(a), QByteArray("written"));
+        QVERIFY(!QFile::exists(b));
+
+        // Stopping flushes what is left, even if the thread never ran
+        writer.write(b, QByteArray("again"));
+    }
+    QCOMPARE(readFile(b), QByteArray("again"));
+}
+
+void tst_QGeoFileTileCacheWriter::flushRunning()
+{
+    QGeoFileTileCacheWriter writer;
+    // Small enough for producers to wait for the disk
+    writer.setMaxQueuedBytes(1024);
+    writer.start();
+
+    const int count = 200;
+    for (int i = 0; i < count; ++i)
+        writer.write(path(QString::number(i % 50) + QStringLiteral(".png")), QByteArray(100, char('a' + i / 50)));
+    writer.flush();
+    QCOMPARE(writer.queuedBytes(), qint64(0));
+    for (int i = 0; i < 50; ++i) {
+        const QString filename = path(QString::number(i) + QStringLiteral(".png"));
+        QVERIFY(!writer.queued(filename, 0));
+        QCOMPARE(readFile(filename), QByteArray(100, 'd'));
+    }
+
+    writer.stop();
+    QVERIFY(writer.isFinished());
+}
+
+void tst_QGeoFileTileCacheWriter::syncWrites()
+{
+    QGeoFileTileCacheWriter writer;
+    QVERIFY(!writer.syncWrites());
+    writer.setSyncWrites(true);
+    QVERIFY(writer.syncWrites());
+
+    QDir(dir_->path()).mkpath(QStringLiteral("sub"));
+    const QString a = path(QStringLiteral("a.png"));
+    const QString b = path(QStringLiteral("sub/b.png"));
+    writer.start();
+    writer.write(a, QByteArray("a"));
+    writer.write(b, QByteArray("b"));
+    writer.flush();
+    QCOMPARE(readFile(a), QByteArray("a"));
+    QCOMPARE(readFile(b), QByteArray("b"));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoFileTileCacheWriter)
+
+#include "tst_qgeofiletilecachewriter.moc"
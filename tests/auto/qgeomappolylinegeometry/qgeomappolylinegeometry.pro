@@ -0,0 +1,8 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeomappolylinegeometry
+INCLUDEPATH += ../geotestplugin
+
+SOURCES += tst_qgeomappolylinegeometry.cpp
+
+QT += location-private positioning-private quick testlib
@@ -0,0 +1,241 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qgeotiledmap_test.h"
+#include <QtCore/QString>
+#include <QtGui/QImage>
+#include <QtGui/QPainter>
+#include <QtTest/QtTest>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/private/qworldpoint_p.h>
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/private/qgeomappingmanager_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qdeclarativepolylinemapitem_p.h>
+
+QT_USE_NAMESPACE
+
+static const qreal lineWidth = 12.0;
+
+class tst_QGeoMapPolylineGeometry : public QObject
+{
+    Q_OBJECT
+
+public:
+    tst_QGeoMapPolylineGeometry();
+
+private Q_SLOTS:
+    void initTestCase();
+    void appendEqualsRebuild_data();
+    void appendEqualsRebuild();
+    void trimEqualsRebuild();
+
+private:
+    QVector<QWorldPoint> project(const QList<QGeoCoordinate> &path) const;
+    void rebuild(QGeoMapPolylineGeometry &geometry, const QList<QGeoCoordinate> &path) const;
+    void update(QGeoMapPolylineGeometry &geometry, const QList<QGeoCoordinate> &path,
+                int removed, int added, bool *incremental) const;
+    QImage render(const QGeoMapPolylineGeometry &geometry) const;
+    static QList<QGeoCoordinate> zigzag(int count);
+
+    QScopedPointer<QGeoTiledMapTest> m_map;
+};
+
+tst_QGeoMapPolylineGeometry::tst_QGeoMapPolylineGeometry()
+{
+}
+
+void tst_QGeoMapPolylineGeometry::initTestCase()
+{
+#if QT_CONFIG(library)
+    // Set custom path since CI doesn't install test plugins
+#ifdef Q_OS_WIN
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../../plugins"));
+#else
+    QCoreApplication::addLibraryPath(QCoreApplication::applicationDirPath() +
+                                     QStringLiteral("/../../../plugins"));
+#endif
+#endif
+    QVariantMap parameters;
+    parameters["tileSize"] = 256;
+    QGeoServiceProvider *provider = new QGeoServiceProvider("qmlgeo.test.plugin", parameters);
+    provider->setAllowExperimental(true);
+    QGeoMappingManager *mappingManager = provider->mappingManager();
+    QVERIFY2(provider->error() == QGeoServiceProvider::NoError, "Could not load plugin: " + provider->errorString().toLatin1());
+    m_map.reset(static_cast<QGeoTiledMapTest *>(mappingManager->createMap(this)));
+    QVERIFY(m_map);
+    m_map->setViewportSize(QSize(1024, 1024));
+
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(0.0, 0.0));
+    camera.setZoomLevel(4.0);
+    m_map->setCameraData(camera);
+}
+
+// A line turning sharply at every point, about 45 pixels high with 2 pixels per step at
+// zoom level 4, so that no point is decimated and every seam between chunks is at a turn
+QList<QGeoCoordinate> tst_QGeoMapPolylineGeometry::zigzag(int count)
+{
+    QList<QGeoCoordinate> path;
+    for (int i = 0; i < count; ++i)
+        path << QGeoCoordinate(i % 2 ? 2.0 : -2.0, -40.0 + 0.2 * i);
+    return path;
+}
+
+QVector<QWorldPoint> tst_QGeoMapPolylineGeometry::project(const QList<QGeoCoordinate> &path) const
+{
+    const QVector<QGeoCoordinate> coordinates = path.toVector();
+    QVector<QDoubleVector2D> projected(coordinates.size());
+    m_map->geoProjection().geoToMapProjection(coordinates.constData(), projected.data(), coordinates.size());
+    QVector<QWorldPoint> world;
+    QWorldPoint::fromMercator(projected, &world);
+    return world;
+}
+
+void tst_QGeoMapPolylineGeometry::rebuild(QGeoMapPolylineGeometry &geometry, const QList<QGeoCoordinate> &path) const
+{
+    // Same steps as QDeclarativePolylineMapItem::updatePolish()
+    geometry.setPreserveGeometry(true, QGeoPath(path).boundingGeoRectangle().topLeft());
+    geometry.markSourceDirty();
+    geometry.updateSourcePoints(*m_map, project(path), QGeoPath(path).boundingGeoRectangle().topLeft());
+    geometry.updateScreenPoints(*m_map, lineWidth);
+    geometry.markClean();
+}
+
+void tst_QGeoMapPolylineGeometry::update(QGeoMapPolylineGeometry &geometry, const QList<QGeoCoordinate> &path,
+                                         int removed, int added, bool *incremental) const
+{
+    *incremental = geometry.updateSourcePointsIncrementally(*m_map, project(path), removed, added);
+    if (!*incremental) {
+        rebuild(geometry, path);
+        return;
+    }
+    geometry.updateScreenPoints(*m_map, lineWidth);
+    geometry.markClean();
+}
+
+QImage tst_QGeoMapPolylineGeometry::render(const QGeoMapPolylineGeometry &geometry) const
+{
+    QImage image(m_map->viewportWidth(), m_map->viewportHeight(), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::white);
+
+    QPainter painter(&image);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::black);
+    // The vertices are relative to the item, placed at the top left of the source bounds
+    const QPointF position = m_map->geoProjection().coordinateToItemPosition(geometry.origin(), false).toPointF()
+            + geometry.sourceBoundingBox().topLeft();
+    painter.translate(position);
+    const QVector<QPointF> vertices = geometry.vertices();
+    for (int i = 2; i < vertices.size(); ++i) {
+        QPolygonF triangle;
+        triangle << vertices.at(i - 2) << vertices.at(i - 1) << vertices.at(i);
+        painter.drawPolygon(triangle);
+    }
+    return image;
+}
+
+void tst_QGeoMapPolylineGeometry::appendEqualsRebuild_data()
+{
+    QTest::addColumn<int>("initial");
+    QTest::addColumn<int>("step");
+
+    QTest::newRow("one by one") << 2 << 1;
+    QTest::newRow("across chunks") << 120 << 5;
+    QTest::newRow("on a chunk boundary") << 128 << 127;
+}
+
+void tst_QGeoMapPolylineGeometry::appendEqualsRebuild()
+{
+    QFETCH(int, initial);
+    QFETCH(int, step);
+
+    const QList<QGeoCoordinate> path = zigzag(400);
+
+    QGeoMapPolylineGeometry geometry;
+    rebuild(geometry, path.mid(0, initial));
+
+    for (int size = initial + step; size <= path.size(); size += step) {
+        const QList<QGeoCoordinate> current = path.mid(0, size);
+        bool incremental = false;
+        update(geometry, current, 0, step, &incremental);
+        QVERIFY(incremental);
+
+        QGeoMapPolylineGeometry expected;
+        rebuild(expected, current);
+
+        const QVector<QPointF> vertices = geometry.vertices();
+        const QVector<QPointF> expectedVertices = expected.vertices();
+        QCOMPARE(vertices.size(), expectedVertices.size());
+        for (int i = 0; i < vertices.size(); ++i) {
+            QVERIFY2(qAbs(vertices.at(i).x() - expectedVertices.at(i).x()) < 1e-3
+                     && qAbs(vertices.at(i).y() - expectedVertices.at(i).y()) < 1e-3,
+                     qPrintable(QStringLiteral("vertex %1 of %2 points").arg(i).arg(size)));
+        }
+    }
+}
+
+void tst_QGeoMapPolylineGeometry::trimEqualsRebuild()
+{
+    // A rolling track longer than a stroke chunk, so trimming moves the chunk seams
+    const QList<QGeoCoordinate> path = zigzag(400);
+    const int length = 200;
+    const int step = 37;
+
+    QGeoMapPolylineGeometry geometry;
+    rebuild(geometry, path.mid(0, length));
+
+    for (int first = step; first + length <= path.size(); first += step) {
+        const QList<QGeoCoordinate> current = path.mid(first, length);
+        bool incremental = false;
+        update(geometry, current, step, step, &incremental);
+        QVERIFY(incremental);
+
+        QGeoMapPolylineGeometry expected;
+        rebuild(expected, current);
+
+        // The seams of the chunks differ, the covered pixels must not
+        const QImage image = render(geometry);
+        const QImage expectedImage = render(expected);
+        int different = 0;
+        for (int y = 0; y < image.height(); ++y) {
+            for (int x = 0; x < image.width(); ++x) {
+                if (image.pixel(x, y) != expectedImage.pixel(x, y))
+                    ++different;
+            }
+        }
+        QVERIFY2(different <= 16, qPrintable(QStringLiteral("%1 pixels differ").arg(different)));
+    }
+}
+
+QTEST_MAIN(tst_QGeoMapPolylineGeometry)
+
+#include "tst_qgeomappolylinegeometry.moc"
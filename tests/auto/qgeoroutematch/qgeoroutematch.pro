@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoroutematch
+
+SOURCES += tst_qgeoroutematch.cpp
+
+CONFIG -= app_bundle
+
+QT += location-private positioning network testlib
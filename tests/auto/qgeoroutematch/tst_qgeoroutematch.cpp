@@ -0,0 +1,329 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/QGeoRoutingManager>
+#include <QtLocation/QGeoRouteMatchRequest>
+#include <QtLocation/QGeoRouteMatchReply>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtCore/QUrlQuery>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+/*
+    A stand-in for the OSRM match service: every position is snapped 0.001
+    degrees north, and each request becomes one matching with a confidence
+    of 0.5 plus a tenth of the index of its first longitude. Requests starting
+    at noMatchLongitude are answered like osrm-routed does when nothing
+    matches, with a 400 status.
+*/
+class MatchServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    MatchServer() : maxConcurrent(0), noMatchLongitude(-1), m_concurrent(0)
+    {
+        connect(this, &QTcpServer::newConnection, this, &MatchServer::serve);
+    }
+
+    QStringList targets;
+    int maxConcurrent;
+    double noMatchLongitude;
+
+private Q_SLOTS:
+    void serve()
+    {
+        while (QTcpSocket *socket = nextPendingConnection()) {
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+                QByteArray request = socket->property("request").toByteArray() + socket->readAll();
+                socket->setProperty("request", request);
+                if (!request.contains("\r\n\r\n"))
+                    return;
+                maxConcurrent = qMax(maxConcurrent, ++m_concurrent);
+                const QString target = QString::fromLatin1(request.split(' ').value(1));
+                targets.append(target);
+                // Answer late so that the client has the chance to send its next windows
+                QTimer::singleShot(50, socket, [this, socket, target]() {
+                    --m_concurrent;
+                    QByteArray status;
+                    const QByteArray body = reply(target, &status);
+                    socket->write("HTTP/1.1 " + status + "\r\nContent-Type: application/json\r\nConnection: close\r\n");
+                    socket->write("Content-Length: " + QByteArray::number(body.size()) + "\r\n\r\n");
+                    socket->write(body);
+                    socket->disconnectFromHost();
+                });
+            });
+        }
+    }
+
+private:
+    QByteArray reply(const QString &target, QByteArray *status) const
+    {
+        const QString coordinates = QUrl(target).path().section(QLatin1Char('/'), -1);
+        QByteArray tracepoints;
+        QByteArray geometry;
+        double firstLongitude = -1;
+        foreach (const QString &c, coordinates.split(QLatin1Char(';'))) {
+            const double longitude = c.section(QLatin1Char(','), 0, 0).toDouble();
+            const double latitude = c.section(QLatin1Char(','), 1, 1).toDouble() + 0.001;
+            if (firstLongitude < 0)
+                firstLongitude = longitude;
+            const QByteArray location = '[' + QByteArray::number(longitude, 'f', 6) + ',' + QByteArray::number(latitude, 'f', 6) + ']';
+            if (!tracepoints.isEmpty()) {
+                tracepoints.append(',');
+                geometry.append(',');
+            }
+            tracepoints.append("{\"location\":" + location + ",\"matchings_index\":0,\"waypoint_index\":0}");
+            geometry.append(location);
+        }
+        if (firstLongitude == noMatchLongitude) {
+            *status = "400 Bad Request";
+            return "{\"code\":\"NoMatch\",\"message\":\"Could not match the trace.\"}";
+        }
+        *status = "200 OK";
+        return "{\"code\":\"Ok\",\"tracepoints\":[" + tracepoints + "],\"matchings\":[{\"confidence\":"
+                + QByteArray::number(0.5 + firstLongitude / 10) + ",\"geometry\":{\"type\":\"LineString\",\"coordinates\":["
+                + geometry + "]}}]}";
+    }
+
+    int m_concurrent;
+};
+
+class tst_QGeoRouteMatch : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void request();
+    void requestUrl();
+    void parseReply();
+    void noMatch();
+    void osmWindows();
+    void osmNoMatchWindow();
+    void tooShort();
+
+private:
+    static QList<QGeoPositionInfo> track(int count);
+};
+
+// Positions one degree of longitude apart, so the index is the longitude
+QList<QGeoPositionInfo> tst_QGeoRouteMatch::track(int count)
+{
+    QList<QGeoPositionInfo> positions;
+    const QDateTime start = QDateTime::fromMSecsSinceEpoch(Q_INT64_C(1500000000000), Qt::UTC);
+    for (int i = 0; i < count; ++i)
+        positions.append(QGeoPositionInfo(QGeoCoordinate(10, i), start.addSecs(i)));
+    return positions;
+}
+
+void tst_QGeoRouteMatch::request()
+{
+    QGeoRouteMatchRequest request(track(3));
+    QCOMPARE(request.positions().size(), 3);
+    QCOMPARE(request.travelModes(), QGeoRouteRequest::TravelModes(QGeoRouteRequest::CarTravel));
+
+    QGeoRouteMatchRequest copy = request;
+    QCOMPARE(copy, request);
+    copy.setTravelModes(QGeoRouteRequest::BicycleTravel);
+    QVERIFY(copy != request);
+    QCOMPARE(request.travelModes(), QGeoRouteRequest::TravelModes(QGeoRouteRequest::CarTravel));
+}
+
+void tst_QGeoRouteMatch::requestUrl()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoPositionInfo> positions = track(3);
+    positions[1].setAttribute(QGeoPositionInfo::HorizontalAccuracy, 12);
+
+    QUrl url = parser.matchRequestUrl(positions, QStringLiteral("http://localhost/match/v1/driving"));
+    QCOMPARE(url.path(), QStringLiteral("/match/v1/driving/0.0000000,10.0000000;1.0000000,10.0000000;2.0000000,10.0000000"));
+    QUrlQuery query(url);
+    QCOMPARE(query.queryItemValue(QStringLiteral("overview")), QStringLiteral("full"));
+    QCOMPARE(query.queryItemValue(QStringLiteral("timestamps")), QStringLiteral("1500000000;1500000001;1500000002"));
+    QCOMPARE(query.queryItemValue(QStringLiteral("radiuses")), QStringLiteral("5;12;5"));
+
+    // Timestamps are all or nothing, radiuses are only sent when any accuracy is known
+    positions = track(3);
+    positions[2].setTimestamp(QDateTime());
+    query = QUrlQuery(parser.matchRequestUrl(positions, QStringLiteral("http://localhost/match/v1/driving/")));
+    QVERIFY(!query.hasQueryItem(QStringLiteral("timestamps")));
+    QVERIFY(!query.hasQueryItem(QStringLiteral("radiuses")));
+}
+
+void tst_QGeoRouteMatch::parseReply()
+{
+    QGeoRouteParserOsrmV5 parser;
+    const QByteArray reply = "{\"code\":\"Ok\",\"tracepoints\":["
+                             "{\"location\":[1.5,10.5],\"matchings_index\":0},"
+                             "null,"
+                             "{\"location\":[3.5,10.5],\"matchings_index\":1}],"
+                             "\"matchings\":["
+                             "{\"confidence\":0.8,\"geometry\":\"_qo]_ibE\"},"
+                             "{\"confidence\":0.25,\"geometry\":\"_qo]_rjT\"}]}";
+    QList<QGeoCoordinate> path;
+    QList<QGeoCoordinate> matched;
+    QVector<qreal> confidences;
+    QString errorString;
+    QCOMPARE(parser.parseMatchReply(path, matched, confidences, errorString, reply, 3), QGeoRouteMatchReply::NoError);
+
+    QCOMPARE(path, QList<QGeoCoordinate>() << QGeoCoordinate(5, 1) << QGeoCoordinate(5, 3.5));
+    QCOMPARE(matched.size(), 3);
+    QCOMPARE(matched.at(0), QGeoCoordinate(10.5, 1.5));
+    QVERIFY(!matched.at(1).isValid());
+    QCOMPARE(matched.at(2), QGeoCoordinate(10.5, 3.5));
+    QCOMPARE(confidences, QVector<qreal>() << 0.8 << 0 << 0.25);
+
+    QCOMPARE(parser.parseMatchReply(path, matched, confidences, errorString, reply, 4), QGeoRouteMatchReply::ParseError);
+    QCOMPARE(parser.parseMatchReply(path, matched, confidences, errorString,
+                                    "{\"code\":\"InvalidValue\"}", 3), QGeoRouteMatchReply::UnknownError);
+    QCOMPARE(errorString, QStringLiteral("InvalidValue"));
+}
+
+void tst_QGeoRouteMatch::noMatch()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoCoordinate> path;
+    QList<QGeoCoordinate> matched;
+    QVector<qreal> confidences;
+    QString errorString;
+    QCOMPARE(parser.parseMatchReply(path, matched, confidences, errorString,
+                                    "{\"code\":\"NoMatch\",\"message\":\"Could not match the trace.\"}", 2),
+             QGeoRouteMatchReply::NoError);
+    QVERIFY(path.isEmpty());
+    QCOMPARE(matched.size(), 2);
+    QVERIFY(!matched.first().isValid());
+    QCOMPARE(confidences, QVector<qreal>() << 0 << 0);
+}
+
+void tst_QGeoRouteMatch::osmWindows()
+{
+    MatchServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.mapping.providersrepository.disabled"), true);
+    parameters.insert(QStringLiteral("osm.routing.host"),
+                      QStringLiteral("http://127.0.0.1:%1/route/v1/driving/").arg(server.serverPort()));
+    parameters.insert(QStringLiteral("osm.routing.geometries"), QStringLiteral("geojson"));
+    parameters.insert(QStringLiteral("osm.routing.match.window"), 3);
+    parameters.insert(QStringLiteral("osm.routing.match.requests"), 2);
+    QGeoServiceProvider provider(QStringLiteral("osm"), parameters);
+    QGeoRoutingManager *manager = provider.routingManager();
+    QVERIFY(manager);
+
+    // Windows [0, 2], [2, 4], [4, 6] and [6, 7], two at a time
+    const int count = 8;
+    QSignalSpy managerSpy(manager, SIGNAL(matchFinished(QGeoRouteMatchReply*)));
+    QScopedPointer<QGeoRouteMatchReply> reply(manager->matchRoute(QGeoRouteMatchRequest(track(count))));
+    QVERIFY(reply);
+    QSignalSpy finishedSpy(reply.data(), SIGNAL(finished()));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(managerSpy.count(), 1);
+    QCOMPARE(reply->error(), QGeoRouteMatchReply::NoError);
+
+    QCOMPARE(server.targets.size(), 4);
+    QCOMPARE(server.maxConcurrent, 2);
+    foreach (const QString &target, server.targets)
+        QVERIFY(target.startsWith(QStringLiteral("/match/v1/driving/")));
+
+    const QList<QGeoCoordinate> matched = reply->matchedCoordinates();
+    const QVector<qreal> confidences = reply->confidences();
+    QCOMPARE(matched.size(), count);
+    QCOMPARE(confidences.size(), count);
+    for (int i = 0; i < count; ++i) {
+        QCOMPARE(matched.at(i), QGeoCoordinate(10.001, i));
+        // A shared position is reported from the earlier window
+        const int window = i == 0 ? 0 : (i - 1) / 2;
+        QCOMPARE(confidences.at(i), 0.5 + window * 0.2);
+    }
+
+    // The windows are stitched without repeating the shared positions
+    QCOMPARE(reply->path().path().size(), count);
+    QCOMPARE(reply->path().path().last(), QGeoCoordinate(10.001, count - 1));
+}
+
+void tst_QGeoRouteMatch::osmNoMatchWindow()
+{
+    MatchServer server;
+    server.noMatchLongitude = 2;
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.mapping.providersrepository.disabled"), true);
+    parameters.insert(QStringLiteral("osm.routing.host"),
+                      QStringLiteral("http://127.0.0.1:%1/route/v1/driving/").arg(server.serverPort()));
+    parameters.insert(QStringLiteral("osm.routing.geometries"), QStringLiteral("geojson"));
+    parameters.insert(QStringLiteral("osm.routing.match.window"), 3);
+    QGeoServiceProvider provider(QStringLiteral("osm"), parameters);
+    QGeoRoutingManager *manager = provider.routingManager();
+    QVERIFY(manager);
+
+    // Window [2, 4] matches nothing, the rest of the track still does
+    const int count = 8;
+    QScopedPointer<QGeoRouteMatchReply> reply(manager->matchRoute(QGeoRouteMatchRequest(track(count))));
+    QVERIFY(reply);
+    QSignalSpy finishedSpy(reply.data(), SIGNAL(finished()));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(reply->error(), QGeoRouteMatchReply::NoError);
+    QCOMPARE(server.targets.size(), 4);
+
+    const QList<QGeoCoordinate> matched = reply->matchedCoordinates();
+    const QVector<qreal> confidences = reply->confidences();
+    QCOMPARE(matched.size(), count);
+    QCOMPARE(confidences.size(), count);
+    for (int i = 0; i < count; ++i) {
+        if (i == 3 || i == 4) {
+            QVERIFY(!matched.at(i).isValid());
+            QCOMPARE(confidences.at(i), qreal(0));
+        } else {
+            QCOMPARE(matched.at(i), QGeoCoordinate(10.001, i));
+        }
+    }
+    QCOMPARE(reply->path().path().size(), count - 1);
+}
+
+void tst_QGeoRouteMatch::tooShort()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.mapping.providersrepository.disabled"), true);
+    QGeoServiceProvider provider(QStringLiteral("osm"), parameters);
+    QVERIFY(provider.routingManager());
+
+    QScopedPointer<QGeoRouteMatchReply> reply(provider.routingManager()->matchRoute(QGeoRouteMatchRequest(track(1))));
+    QVERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QGeoRouteMatchReply::UnsupportedOptionError);
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteMatch)
+
+#include "tst_qgeoroutematch.moc"
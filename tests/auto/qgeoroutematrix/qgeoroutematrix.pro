@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeoroutematrix
+
+SOURCES += tst_qgeoroutematrix.cpp
+
+CONFIG -= app_bundle
+
+QT += location-private positioning network testlib
@@ -0,0 +1,320 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/QGeoServiceProvider>
+#include <QtLocation/QGeoRoutingManager>
+#include <QtLocation/QGeoRoutingManagerEngine>
+#include <QtLocation/QGeoRouteMatrixRequest>
+#include <QtLocation/QGeoRouteMatrixReply>
+#include <QtLocation/private/qgeorouteparserosrmv4_p.h>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+#include <QtNetwork/QTcpServer>
+#include <QtNetwork/QTcpSocket>
+#include <QtCore/QUrlQuery>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+// Answers every HTTP request with a canned status and body, and remembers the request target.
+class StubServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit StubServer(const QByteArray &body, const QByteArray &status = "200 OK")
+        : m_body(body), m_status(status)
+    {
+        connect(this, &QTcpServer::newConnection, this, &StubServer::serve);
+    }
+
+    QString target;
+
+private Q_SLOTS:
+    void serve()
+    {
+        QTcpSocket *socket = nextPendingConnection();
+        connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() {
+            m_request += socket->readAll();
+            if (!m_request.contains("\r\n\r\n"))
+                return;
+            target = QString::fromLatin1(m_request.split(' ').value(1));
+            socket->write("HTTP/1.1 " + m_status + "\r\nContent-Type: application/json\r\nConnection: close\r\n");
+            socket->write("Content-Length: " + QByteArray::number(m_body.size()) + "\r\n\r\n");
+            socket->write(m_body);
+            socket->disconnectFromHost();
+        });
+    }
+
+private:
+    QByteArray m_body;
+    QByteArray m_status;
+    QByteArray m_request;
+};
+
+// Only implements calculateRoute, to check the default matrix implementation.
+class RouteOnlyEngine : public QGeoRoutingManagerEngine
+{
+public:
+    RouteOnlyEngine() : QGeoRoutingManagerEngine(QVariantMap()) {}
+    QGeoRouteReply *calculateRoute(const QGeoRouteRequest &) Q_DECL_OVERRIDE { return 0; }
+};
+
+class tst_QGeoRouteMatrix : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void request();
+    void requestUrl();
+    void parseReply_data();
+    void parseReply();
+    void unsupported();
+    void osmStubServer();
+    void osmStubServerCode();
+
+private:
+    static QList<QGeoCoordinate> coordinates(int count, double offset);
+    static QGeoServiceProvider *osmProvider(const StubServer &server);
+};
+
+QList<QGeoCoordinate> tst_QGeoRouteMatrix::coordinates(int count, double offset)
+{
+    QList<QGeoCoordinate> result;
+    for (int i = 0; i < count; ++i)
+        result.append(QGeoCoordinate(52.5 + offset + 0.01 * i, 13.4 + 0.01 * i));
+    return result;
+}
+
+void tst_QGeoRouteMatrix::request()
+{
+    QGeoRouteMatrixRequest request(coordinates(3, 0));
+    QCOMPARE(request.travelModes(), QGeoRouteRequest::TravelModes(QGeoRouteRequest::CarTravel));
+    QCOMPARE(request.annotations(), QGeoRouteMatrixRequest::Annotations(QGeoRouteMatrixRequest::DurationAnnotation));
+    QCOMPARE(request.rowCount(), 3);
+    QCOMPARE(request.columnCount(), 3);
+
+    QGeoRouteMatrixRequest copy = request;
+    QCOMPARE(copy, request);
+    copy.setDestinations(coordinates(2, 1));
+    QVERIFY(copy != request);
+    QCOMPARE(request.destinations().size(), 0);
+    QCOMPARE(copy.rowCount(), 3);
+    QCOMPARE(copy.columnCount(), 2);
+
+    QGeoRouteMatrixRequest other(coordinates(3, 0), coordinates(2, 1));
+    QCOMPARE(other, copy);
+    other.setAnnotations(QGeoRouteMatrixRequest::DurationAnnotation | QGeoRouteMatrixRequest::DistanceAnnotation);
+    QVERIFY(other != copy);
+}
+
+void tst_QGeoRouteMatrix::requestUrl()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QGeoRouteMatrixRequest request(QList<QGeoCoordinate>() << QGeoCoordinate(1, 2),
+                                   QList<QGeoCoordinate>() << QGeoCoordinate(3, 4) << QGeoCoordinate(5, 6));
+    request.setAnnotations(QGeoRouteMatrixRequest::DurationAnnotation | QGeoRouteMatrixRequest::DistanceAnnotation);
+
+    QUrl url = parser.matrixRequestUrl(request, QStringLiteral("http://localhost/table/v1/driving/"));
+    QCOMPARE(url.path(), QStringLiteral("/table/v1/driving/2.0000000,1.0000000;4.0000000,3.0000000;6.0000000,5.0000000"));
+    QUrlQuery query(url);
+    QCOMPARE(query.queryItemValue(QStringLiteral("sources")), QStringLiteral("0"));
+    QCOMPARE(query.queryItemValue(QStringLiteral("destinations")), QStringLiteral("1;2"));
+    QCOMPARE(query.queryItemValue(QStringLiteral("annotations")), QStringLiteral("duration,distance"));
+
+    // Square matrices let the server use every coordinate both ways
+    url = parser.matrixRequestUrl(QGeoRouteMatrixRequest(request.destinations()), QStringLiteral("http://localhost/table/v1/driving"));
+    QCOMPARE(url.path(), QStringLiteral("/table/v1/driving/4.0000000,3.0000000;6.0000000,5.0000000"));
+    query = QUrlQuery(url);
+    QVERIFY(!query.hasQueryItem(QStringLiteral("sources")));
+    QVERIFY(!query.hasQueryItem(QStringLiteral("destinations")));
+    QCOMPARE(query.queryItemValue(QStringLiteral("annotations")), QStringLiteral("duration"));
+}
+
+void tst_QGeoRouteMatrix::parseReply_data()
+{
+    QTest::addColumn<QByteArray>("reply");
+    QTest::addColumn<int>("annotations");
+    QTest::addColumn<int>("error");
+    QTest::addColumn<QString>("errorString");
+    QTest::addColumn<QVector<qreal> >("expectedDurations");
+    QTest::addColumn<QVector<qreal> >("expectedDistances");
+
+    const int both = QGeoRouteMatrixRequest::DurationAnnotation | QGeoRouteMatrixRequest::DistanceAnnotation;
+    const qreal nan = qQNaN();
+
+    QTest::newRow("durations")
+            << QByteArray("{\"code\":\"Ok\",\"durations\":[[10.5,20],[30,40]]}")
+            << int(QGeoRouteMatrixRequest::DurationAnnotation) << int(QGeoRouteMatrixReply::NoError) << QString()
+            << (QVector<qreal>() << 10.5 << 20 << 30 << 40) << QVector<qreal>();
+    QTest::newRow("both")
+            << QByteArray("{\"code\":\"Ok\",\"durations\":[[0,20],[null,0]],\"distances\":[[0,250.2],[null,0]],\"sources\":[]}")
+            << both << int(QGeoRouteMatrixReply::NoError) << QString()
+            << (QVector<qreal>() << 0 << 20 << nan << 0) << (QVector<qreal>() << 0 << 250.2 << nan << 0);
+    QTest::newRow("code")
+            << QByteArray("{\"code\":\"TooBig\",\"message\":\"Too many table coordinates\"}")
+            << both << int(QGeoRouteMatrixReply::UnknownError) << QStringLiteral("TooBig")
+            << QVector<qreal>() << QVector<qreal>();
+    QTest::newRow("missing distances")
+            << QByteArray("{\"code\":\"Ok\",\"durations\":[[0,20],[30,0]]}")
+            << both << int(QGeoRouteMatrixReply::ParseError) << QStringLiteral("Invalid distances table")
+            << QVector<qreal>() << QVector<qreal>();
+    QTest::newRow("short row")
+            << QByteArray("{\"code\":\"Ok\",\"durations\":[[0,20],[30]]}")
+            << int(QGeoRouteMatrixRequest::DurationAnnotation) << int(QGeoRouteMatrixReply::ParseError)
+            << QStringLiteral("Invalid durations table") << QVector<qreal>() << QVector<qreal>();
+    QTest::newRow("not a number")
+            << QByteArray("{\"code\":\"Ok\",\"durations\":[[0,\"20\"],[30,0]]}")
+            << int(QGeoRouteMatrixRequest::DurationAnnotation) << int(QGeoRouteMatrixReply::ParseError)
+            << QStringLiteral("Invalid durations table") << QVector<qreal>() << QVector<qreal>();
+    QTest::newRow("garbage")
+            << QByteArray("<html>")
+            << int(QGeoRouteMatrixRequest::DurationAnnotation) << int(QGeoRouteMatrixReply::ParseError)
+            << QStringLiteral("Couldn't parse json.") << QVector<qreal>() << QVector<qreal>();
+}
+
+static bool sameTable(const QVector<qreal> &a, const QVector<qreal> &b)
+{
+    if (a.size() != b.size())
+        return false;
+    for (int i = 0; i < a.size(); ++i) {
+        if (qIsNaN(a.at(i)) != qIsNaN(b.at(i)))
+            return false;
+        if (!qIsNaN(a.at(i)) && !qFuzzyCompare(a.at(i), b.at(i)))
+            return false;
+    }
+    return true;
+}
+
+void tst_QGeoRouteMatrix::parseReply()
+{
+    QFETCH(QByteArray, reply);
+    QFETCH(int, annotations);
+    QFETCH(int, error);
+    QFETCH(QString, errorString);
+
+    QGeoRouteMatrixRequest request(coordinates(2, 0));
+    request.setAnnotations(QGeoRouteMatrixRequest::Annotations(annotations));
+
+    QGeoRouteParserOsrmV5 parser;
+    QVector<qreal> durations;
+    QVector<qreal> distances;
+    QString parsedError;
+    QCOMPARE(int(parser.parseMatrixReply(durations, distances, parsedError, reply, request)), error);
+    QCOMPARE(parsedError, errorString);
+    if (error == QGeoRouteMatrixReply::NoError) {
+        QFETCH(QVector<qreal>, expectedDurations);
+        QFETCH(QVector<qreal>, expectedDistances);
+        QVERIFY(sameTable(durations, expectedDurations));
+        QVERIFY(sameTable(distances, expectedDistances));
+    }
+}
+
+void tst_QGeoRouteMatrix::unsupported()
+{
+    RouteOnlyEngine engine;
+    QScopedPointer<QGeoRouteMatrixReply> reply(engine.calculateRouteMatrix(QGeoRouteMatrixRequest(coordinates(2, 0))));
+    QVERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QGeoRouteMatrixReply::UnsupportedOptionError);
+    QCOMPARE(reply->rowCount(), 0);
+    QVERIFY(qIsNaN(reply->duration(0, 0)));
+
+    QGeoRouteParserOsrmV4 parser;
+    QVERIFY(!parser.matrixRequestUrl(QGeoRouteMatrixRequest(coordinates(2, 0)), QStringLiteral("http://localhost/")).isValid());
+}
+
+QGeoServiceProvider *tst_QGeoRouteMatrix::osmProvider(const StubServer &server)
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.mapping.providersrepository.disabled"), true);
+    parameters.insert(QStringLiteral("osm.routing.host"),
+                      QStringLiteral("http://127.0.0.1:%1/route/v1/driving/").arg(server.serverPort()));
+    return new QGeoServiceProvider(QStringLiteral("osm"), parameters);
+}
+
+void tst_QGeoRouteMatrix::osmStubServer()
+{
+    StubServer server("{\"code\":\"Ok\","
+                      "\"durations\":[[100,200,null],[400,500,600]],"
+                      "\"distances\":[[1000,2000,null],[4000,5000,6000]]}");
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QScopedPointer<QGeoServiceProvider> provider(osmProvider(server));
+    QGeoRoutingManager *manager = provider->routingManager();
+    QVERIFY(manager);
+
+    QGeoRouteMatrixRequest request(coordinates(2, 0), coordinates(3, 1));
+    request.setAnnotations(QGeoRouteMatrixRequest::DurationAnnotation | QGeoRouteMatrixRequest::DistanceAnnotation);
+
+    QSignalSpy managerSpy(manager, SIGNAL(matrixFinished(QGeoRouteMatrixReply*)));
+    QScopedPointer<QGeoRouteMatrixReply> reply(manager->calculateRouteMatrix(request));
+    QVERIFY(reply);
+    QSignalSpy finishedSpy(reply.data(), SIGNAL(finished()));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(managerSpy.count(), 1);
+
+    QCOMPARE(reply->error(), QGeoRouteMatrixReply::NoError);
+    QVERIFY(server.target.startsWith(QStringLiteral("/table/v1/driving/")));
+    QUrlQuery query(QUrl(server.target));
+    QCOMPARE(query.queryItemValue(QStringLiteral("sources")), QStringLiteral("0;1"));
+    QCOMPARE(query.queryItemValue(QStringLiteral("destinations")), QStringLiteral("2;3;4"));
+
+    QCOMPARE(reply->rowCount(), 2);
+    QCOMPARE(reply->columnCount(), 3);
+    QCOMPARE(reply->durations().size(), 6);
+    QCOMPARE(reply->duration(0, 1), qreal(200));
+    QCOMPARE(reply->duration(1, 2), qreal(600));
+    QCOMPARE(reply->distance(1, 0), qreal(4000));
+    QVERIFY(qIsNaN(reply->duration(0, 2)));
+    QVERIFY(qIsNaN(reply->distance(0, 2)));
+    QVERIFY(qIsNaN(reply->duration(2, 0)));
+}
+
+void tst_QGeoRouteMatrix::osmStubServerCode()
+{
+    // The code OSRM sends along with a 4xx status is reported, not the HTTP error
+    StubServer server("{\"code\":\"TooBig\",\"message\":\"Too many table coordinates\"}",
+                      "400 Bad Request");
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QScopedPointer<QGeoServiceProvider> provider(osmProvider(server));
+    QGeoRoutingManager *manager = provider->routingManager();
+    QVERIFY(manager);
+
+    QScopedPointer<QGeoRouteMatrixReply> reply(manager->calculateRouteMatrix(
+            QGeoRouteMatrixRequest(coordinates(2, 0))));
+    QVERIFY(reply);
+    QSignalSpy finishedSpy(reply.data(), SIGNAL(finished()));
+    QTRY_COMPARE(finishedSpy.count(), 1);
+    QCOMPARE(reply->error(), QGeoRouteMatrixReply::UnknownError);
+    QCOMPARE(reply->errorString(), QStringLiteral("TooBig"));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteMatrix)
+
+#include "tst_qgeoroutematrix.moc"
@@ -0,0 +1,9 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qgeorouteparserosrmv5
+
+SOURCES += tst_qgeorouteparserosrmv5.cpp
+
+CONFIG -= app_bundle
+
+QT += location-private positioning testlib
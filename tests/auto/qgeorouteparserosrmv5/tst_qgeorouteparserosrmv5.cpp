@@ -0,0 +1,174 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+#include <QtCore/QUrlQuery>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoRouteParserOsrmV5::GeometryFormat)
+
+class tst_QGeoRouteParserOsrmV5 : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void requestUrl_data();
+    void requestUrl();
+    void geometry_data();
+    void geometry();
+    void overview();
+    void malformedPolyline_data();
+    void malformedPolyline();
+
+private:
+    static QByteArray reply(const QByteArray &geometry);
+};
+
+// One route with a depart and an arrive step, the first one carrying the geometry
+QByteArray tst_QGeoRouteParserOsrmV5::reply(const QByteArray &geometry)
+{
+    return "{\"code\":\"Ok\",\"routes\":[{\"distance\":500,\"duration\":60,\"legs\":[{\"steps\":["
+           "{\"distance\":500,\"duration\":60,\"name\":\"A\",\"intersections\":[],\"geometry\":" + geometry + ","
+           "\"maneuver\":{\"type\":\"depart\",\"location\":[-120.2,38.5]}},"
+           "{\"distance\":0,\"duration\":0,\"name\":\"A\",\"intersections\":[],\"geometry\":\"\","
+           "\"maneuver\":{\"type\":\"arrive\",\"location\":[-126.453,43.252]}}]}]}]}";
+}
+
+void tst_QGeoRouteParserOsrmV5::requestUrl_data()
+{
+    QTest::addColumn<QGeoRouteParserOsrmV5::GeometryFormat>("format");
+    QTest::addColumn<bool>("segments");
+    QTest::addColumn<QString>("geometries");
+
+    QTest::newRow("polyline") << QGeoRouteParserOsrmV5::PolylineGeometry << true << QStringLiteral("polyline");
+    QTest::newRow("polyline6") << QGeoRouteParserOsrmV5::Polyline6Geometry << true << QStringLiteral("polyline6");
+    QTest::newRow("geojson") << QGeoRouteParserOsrmV5::GeoJsonGeometry << true << QStringLiteral("geojson");
+    QTest::newRow("overview only") << QGeoRouteParserOsrmV5::PolylineGeometry << false << QStringLiteral("polyline");
+}
+
+void tst_QGeoRouteParserOsrmV5::requestUrl()
+{
+    QFETCH(QGeoRouteParserOsrmV5::GeometryFormat, format);
+    QFETCH(bool, segments);
+    QFETCH(QString, geometries);
+
+    QGeoRouteParserOsrmV5 parser;
+    parser.setGeometryFormat(format);
+    QCOMPARE(parser.geometryFormat(), format);
+
+    QGeoRouteRequest request(QGeoCoordinate(38.5, -120.2), QGeoCoordinate(43.252, -126.453));
+    if (!segments) {
+        request.setSegmentDetail(QGeoRouteRequest::NoSegmentData);
+        request.setManeuverDetail(QGeoRouteRequest::NoManeuvers);
+    }
+    QUrlQuery query(parser.requestUrl(request, QStringLiteral("http://localhost/route/v1/driving/")));
+    QCOMPARE(query.queryItemValue(QStringLiteral("geometries")), geometries);
+    QCOMPARE(query.queryItemValue(QStringLiteral("steps")), segments ? QStringLiteral("true") : QStringLiteral("false"));
+    QCOMPARE(query.queryItemValue(QStringLiteral("overview")), segments ? QStringLiteral("false") : QStringLiteral("full"));
+}
+
+void tst_QGeoRouteParserOsrmV5::geometry_data()
+{
+    QTest::addColumn<QGeoRouteParserOsrmV5::GeometryFormat>("format");
+    QTest::addColumn<QByteArray>("geometry");
+
+    // The reference example of the encoded polyline algorithm, and the same points with 6 digits
+    QTest::newRow("polyline") << QGeoRouteParserOsrmV5::PolylineGeometry
+                              << QByteArray("\"_p~iF~ps|U_ulLnnqC_mqNvxq`@\"");
+    QTest::newRow("polyline6") << QGeoRouteParserOsrmV5::Polyline6Geometry
+                               << QByteArray("\"_izlhA~rlgdF_{geC~ywl@_kwzCn`{nI\"");
+    QTest::newRow("geojson") << QGeoRouteParserOsrmV5::GeoJsonGeometry
+                             << QByteArray("{\"type\":\"LineString\",\"coordinates\":"
+                                           "[[-120.2,38.5],[-120.95,40.7],[-126.453,43.252]]}");
+}
+
+void tst_QGeoRouteParserOsrmV5::geometry()
+{
+    QFETCH(QGeoRouteParserOsrmV5::GeometryFormat, format);
+    QFETCH(QByteArray, geometry);
+
+    QGeoRouteParserOsrmV5 parser;
+    parser.setGeometryFormat(format);
+    QList<QGeoRoute> routes;
+    QString errorString;
+    QCOMPARE(parser.parseReply(routes, errorString, reply(geometry)), QGeoRouteReply::NoError);
+    QCOMPARE(routes.size(), 1);
+
+    const QList<QGeoCoordinate> path = routes.first().firstRouteSegment().path();
+    QCOMPARE(path.size(), 3);
+    QCOMPARE(path.at(0), QGeoCoordinate(38.5, -120.2));
+    QCOMPARE(path.at(1), QGeoCoordinate(40.7, -120.95));
+    QCOMPARE(path.at(2), QGeoCoordinate(43.252, -126.453));
+    QCOMPARE(routes.first().path(), path);
+}
+
+void tst_QGeoRouteParserOsrmV5::overview()
+{
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoRoute> routes;
+    QString errorString;
+    const QByteArray overviewReply = "{\"code\":\"Ok\",\"routes\":[{\"distance\":500,\"duration\":60,"
+                                     "\"geometry\":\"_p~iF~ps|U_ulLnnqC_mqNvxq`@\",\"legs\":[{\"steps\":[]}]}]}";
+    QCOMPARE(parser.parseReply(routes, errorString, overviewReply), QGeoRouteReply::NoError);
+    QCOMPARE(routes.size(), 1);
+    QCOMPARE(routes.first().path().size(), 3);
+    QCOMPARE(routes.first().path().last(), QGeoCoordinate(43.252, -126.453));
+    QVERIFY(!routes.first().firstRouteSegment().isValid());
+    QCOMPARE(routes.first().distance(), qreal(500));
+}
+
+void tst_QGeoRouteParserOsrmV5::malformedPolyline_data()
+{
+    QTest::addColumn<QByteArray>("geometry");
+
+    // A space is not part of the encoding
+    QTest::newRow("invalid character") << QByteArray("\"_p~iF ~ps|U\"");
+    QTest::newRow("truncated value") << QByteArray("\"_p~iF~ps|\"");
+    QTest::newRow("unpaired latitude") << QByteArray("\"_p~iF~ps|U_ulL\"");
+}
+
+void tst_QGeoRouteParserOsrmV5::malformedPolyline()
+{
+    QFETCH(QByteArray, geometry);
+
+    // The step keeps no half decoded path
+    QGeoRouteParserOsrmV5 parser;
+    QList<QGeoRoute> routes;
+    QString errorString;
+    QCOMPARE(parser.parseReply(routes, errorString, reply(geometry)), QGeoRouteReply::NoError);
+    QCOMPARE(routes.size(), 1);
+    QVERIFY(routes.first().firstRouteSegment().path().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteParserOsrmV5)
+
+#include "tst_qgeorouteparserosrmv5.moc"
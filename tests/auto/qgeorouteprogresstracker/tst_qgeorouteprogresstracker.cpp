@@ -0,0 +1,275 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/QGeoRouteProgressTracker>
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtLocation/QGeoManeuver>
+#include <QtPositioning/QGeoPositionInfoSource>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+class PushSource : public QGeoPositionInfoSource
+{
+    Q_OBJECT
+
+public:
+    PushSource() : QGeoPositionInfoSource(0) {}
+
+    void push(const QGeoPositionInfo &info) { emit positionUpdated(info); }
+
+    QGeoPositionInfo lastKnownPosition(bool = false) const Q_DECL_OVERRIDE { return QGeoPositionInfo(); }
+    PositioningMethods supportedPositioningMethods() const Q_DECL_OVERRIDE { return AllPositioningMethods; }
+    int minimumUpdateInterval() const Q_DECL_OVERRIDE { return 0; }
+    Error error() const Q_DECL_OVERRIDE { return NoError; }
+    void startUpdates() Q_DECL_OVERRIDE {}
+    void stopUpdates() Q_DECL_OVERRIDE {}
+    void requestUpdate(int = 0) Q_DECL_OVERRIDE {}
+};
+
+class tst_QGeoRouteProgressTracker : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void defaults();
+    void progress();
+    void offRoute();
+    void rejoinBeyondWindow();
+    void horizontalAccuracy();
+    void source();
+
+private:
+    static QGeoPositionInfo fix(double latitude, double longitude);
+
+    QGeoRoute m_route;
+    qreal m_unit;
+};
+
+QGeoPositionInfo tst_QGeoRouteProgressTracker::fix(double latitude, double longitude)
+{
+    return QGeoPositionInfo(QGeoCoordinate(latitude, longitude), QDateTime::currentDateTimeUtc());
+}
+
+/*
+    Five segments of two 0.001 degree edges eastwards along the equator, each
+    taking 20 seconds and starting with a maneuver named after its index.
+*/
+void tst_QGeoRouteProgressTracker::initTestCase()
+{
+    m_unit = QGeoCoordinate(0.0, 0.0).distanceTo(QGeoCoordinate(0.0, 0.001));
+
+    QList<QGeoCoordinate> routePath;
+    QGeoRouteSegment first;
+    QGeoRouteSegment previous;
+    for (int s = 0; s < 5; ++s) {
+        QList<QGeoCoordinate> path;
+        for (int v = 2 * s; v <= 2 * s + 2; ++v)
+            path << QGeoCoordinate(0.0, 0.001 * v);
+
+        QGeoManeuver maneuver;
+        maneuver.setPosition(path.first());
+        maneuver.setInstructionText(QStringLiteral("m%1").arg(s));
+
+        QGeoRouteSegment segment;
+        segment.setPath(path);
+        segment.setDistance(2 * m_unit);
+        segment.setTravelTime(20);
+        segment.setManeuver(maneuver);
+
+        if (s == 0)
+            first = segment;
+        else
+            previous.setNextRouteSegment(segment);
+        previous = segment;
+        routePath << (s == 0 ? path : path.mid(1));
+    }
+
+    m_route.setFirstRouteSegment(first);
+    m_route.setPath(routePath);
+    m_route.setTravelTime(100);
+    m_route.setDistance(10 * m_unit);
+}
+
+void tst_QGeoRouteProgressTracker::defaults()
+{
+    QGeoRouteProgressTracker tracker;
+    QCOMPARE(tracker.offRouteThreshold(), qreal(30.0));
+    QCOMPARE(tracker.searchWindow(), 32);
+    QVERIFY(!tracker.isOffRoute());
+    QVERIFY(!tracker.matchedCoordinate().isValid());
+    QCOMPARE(tracker.distanceRemaining(), qreal(0.0));
+    QVERIFY(!tracker.nextManeuver().isValid());
+
+    tracker.setRoute(m_route);
+    QVERIFY(qAbs(tracker.distanceRemaining() - 10 * m_unit) < 0.01);
+    QVERIFY(qAbs(tracker.timeRemaining() - 100.0) < 0.01);
+    QCOMPARE(tracker.nextManeuver().instructionText(), QStringLiteral("m0"));
+}
+
+void tst_QGeoRouteProgressTracker::progress()
+{
+    QGeoRouteProgressTracker tracker;
+    tracker.setRoute(m_route);
+
+    QSignalSpy progressSpy(&tracker, SIGNAL(progressChanged()));
+    QSignalSpy maneuverSpy(&tracker, SIGNAL(nextManeuverChanged()));
+    QSignalSpy offRouteSpy(&tracker, SIGNAL(offRouteChanged(bool)));
+
+    tracker.updatePosition(fix(0.0001, 0.0035));
+    QCOMPARE(progressSpy.count(), 1);
+    QCOMPARE(maneuverSpy.count(), 1);
+    QCOMPARE(offRouteSpy.count(), 0);
+    QVERIFY(!tracker.isOffRoute());
+    QVERIFY(qAbs(tracker.matchedCoordinate().latitude()) < 1e-9);
+    QVERIFY(qAbs(tracker.matchedCoordinate().longitude() - 0.0035) < 1e-9);
+    QVERIFY(qAbs(tracker.distanceRemaining() - 6.5 * m_unit) < 0.01);
+    QVERIFY(qAbs(tracker.timeRemaining() - 65.0) < 0.01);
+    QCOMPARE(tracker.nextManeuver().instructionText(), QStringLiteral("m2"));
+    QVERIFY(qAbs(tracker.distanceToNextManeuver() - 0.5 * m_unit) < 0.01);
+
+    // Still heading for the same maneuver
+    tracker.updatePosition(fix(-0.0001, 0.0038));
+    QCOMPARE(progressSpy.count(), 2);
+    QCOMPARE(maneuverSpy.count(), 1);
+    QVERIFY(qAbs(tracker.distanceToNextManeuver() - 0.2 * m_unit) < 0.01);
+
+    // Past the last maneuver the rest of the route is what is left
+    tracker.updatePosition(fix(0.0, 0.0095));
+    QCOMPARE(maneuverSpy.count(), 2);
+    QVERIFY(!tracker.nextManeuver().isValid());
+    QVERIFY(qAbs(tracker.distanceToNextManeuver() - tracker.distanceRemaining()) < 1e-9);
+    QVERIFY(qAbs(tracker.distanceRemaining() - 0.5 * m_unit) < 0.01);
+
+    tracker.reset();
+    QVERIFY(!tracker.matchedCoordinate().isValid());
+    QCOMPARE(tracker.nextManeuver().instructionText(), QStringLiteral("m0"));
+    QVERIFY(qAbs(tracker.distanceRemaining() - 10 * m_unit) < 0.01);
+}
+
+void tst_QGeoRouteProgressTracker::offRoute()
+{
+    QGeoRouteProgressTracker tracker;
+    tracker.setRoute(m_route);
+    QSignalSpy progressSpy(&tracker, SIGNAL(progressChanged()));
+    QSignalSpy offRouteSpy(&tracker, SIGNAL(offRouteChanged(bool)));
+
+    tracker.updatePosition(fix(0.0, 0.0025));
+    QVERIFY(!tracker.isOffRoute());
+
+    // Around 110 meters away from the route
+    tracker.updatePosition(fix(0.001, 0.003));
+    QVERIFY(tracker.isOffRoute());
+    QCOMPARE(offRouteSpy.count(), 1);
+    QCOMPARE(offRouteSpy.at(0).at(0).toBool(), true);
+    QCOMPARE(progressSpy.count(), 1);
+
+    // The progress stays where the route was left
+    QVERIFY(qAbs(tracker.distanceRemaining() - 7.5 * m_unit) < 0.01);
+
+    tracker.updatePosition(fix(0.002, 0.004));
+    QCOMPARE(offRouteSpy.count(), 1);
+
+    tracker.updatePosition(fix(0.0, 0.005));
+    QVERIFY(!tracker.isOffRoute());
+    QCOMPARE(offRouteSpy.count(), 2);
+    QCOMPARE(offRouteSpy.at(1).at(0).toBool(), false);
+    QCOMPARE(progressSpy.count(), 2);
+    QVERIFY(qAbs(tracker.distanceRemaining() - 5 * m_unit) < 0.01);
+}
+
+void tst_QGeoRouteProgressTracker::rejoinBeyondWindow()
+{
+    QGeoRouteProgressTracker tracker;
+    tracker.setSearchWindow(2);
+    tracker.setRoute(m_route);
+    QSignalSpy offRouteSpy(&tracker, SIGNAL(offRouteChanged(bool)));
+
+    tracker.updatePosition(fix(0.0, 0.0005));
+    QCOMPARE(tracker.nextManeuver().instructionText(), QStringLiteral("m1"));
+
+    // Seven edges ahead, found through the index rather than reported off the route
+    tracker.updatePosition(fix(0.0, 0.0075));
+    QVERIFY(!tracker.isOffRoute());
+    QCOMPARE(offRouteSpy.count(), 0);
+    QCOMPARE(tracker.nextManeuver().instructionText(), QStringLiteral("m4"));
+    QVERIFY(qAbs(tracker.distanceRemaining() - 2.5 * m_unit) < 0.01);
+
+    // Jumping back finds the earlier maneuver again
+    tracker.updatePosition(fix(0.0, 0.0015));
+    QCOMPARE(tracker.nextManeuver().instructionText(), QStringLiteral("m1"));
+    QVERIFY(qAbs(tracker.distanceToNextManeuver() - 0.5 * m_unit) < 0.01);
+}
+
+void tst_QGeoRouteProgressTracker::horizontalAccuracy()
+{
+    QGeoRouteProgressTracker tracker;
+    tracker.setRoute(m_route);
+
+    // Around 55 meters away, within the threshold only with the accuracy added
+    QGeoPositionInfo position = fix(0.0005, 0.002);
+    tracker.updatePosition(position);
+    QVERIFY(tracker.isOffRoute());
+
+    position.setAttribute(QGeoPositionInfo::HorizontalAccuracy, 40.0);
+    tracker.updatePosition(position);
+    QVERIFY(!tracker.isOffRoute());
+
+    tracker.setOffRouteThreshold(60.0);
+    tracker.updatePosition(fix(0.0005, 0.003));
+    QVERIFY(!tracker.isOffRoute());
+}
+
+void tst_QGeoRouteProgressTracker::source()
+{
+    QGeoRouteProgressTracker tracker;
+    tracker.setRoute(m_route);
+    QSignalSpy progressSpy(&tracker, SIGNAL(progressChanged()));
+
+    PushSource *source = new PushSource;
+    tracker.setSource(source);
+    QCOMPARE(tracker.source(), static_cast<QGeoPositionInfoSource *>(source));
+
+    source->push(fix(0.0, 0.001));
+    QCOMPARE(progressSpy.count(), 1);
+    QVERIFY(qAbs(tracker.distanceRemaining() - 9 * m_unit) < 0.01);
+
+    tracker.setSource(0);
+    source->push(fix(0.0, 0.002));
+    QCOMPARE(progressSpy.count(), 1);
+
+    tracker.setSource(source);
+    delete source;
+    QVERIFY(!tracker.source());
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRouteProgressTracker)
+
+#include "tst_qgeorouteprogresstracker.moc"
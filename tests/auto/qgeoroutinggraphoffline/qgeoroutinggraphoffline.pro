@@ -0,0 +1,17 @@
+CONFIG += testcase
+TARGET = tst_qgeoroutinggraphoffline
+
+plugin.path = ../../../src/plugins/geoservices/offline/
+
+SOURCES += tst_qgeoroutinggraphoffline.cpp \
+           $$plugin.path/qgeoroutinggraphoffline.cpp \
+           $$plugin.path/qgeoroutinggraphbuilderoffline.cpp \
+           $$plugin.path/qgeoroutereplyoffline.cpp \
+           $$plugin.path/qgeoroutingmanagerengineoffline.cpp
+HEADERS += $$plugin.path/qgeoroutinggraphoffline.h \
+           $$plugin.path/qgeoroutinggraphbuilderoffline.h \
+           $$plugin.path/qgeoroutereplyoffline.h \
+           $$plugin.path/qgeoroutingmanagerengineoffline.h
+INCLUDEPATH += $$plugin.path
+
+QT += location-private positioning-private concurrent testlib
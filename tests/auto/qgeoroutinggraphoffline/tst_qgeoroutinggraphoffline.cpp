@@ -0,0 +1,385 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qgeoroutinggraphbuilderoffline.h>
+#include <qgeoroutinggraphoffline.h>
+#include <qgeoroutereplyoffline.h>
+#include <qgeoroutingmanagerengineoffline.h>
+
+#include <QtCore/QTemporaryDir>
+#include <QtLocation/QGeoManeuver>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+using namespace QGeoRoutingGraphFormat;
+
+class tst_QGeoRoutingGraphOffline : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void invalidFile();
+    void nearestNode();
+    void contractedPathMatchesSearch();
+    void oneway();
+    void profileAccess();
+    void excludeAreas();
+    void maneuvers();
+    void noRoute();
+    void engine();
+
+private:
+    QString write(const QGeoRoutingGraphBuilderOffline &builder, const QString &name);
+    QSharedPointer<QGeoRoutingGraphOffline> load(const QString &fileName);
+
+    QTemporaryDir m_dir;
+    QString m_streets;
+};
+
+QString tst_QGeoRoutingGraphOffline::write(const QGeoRoutingGraphBuilderOffline &builder,
+                                           const QString &name)
+{
+    const QString fileName = m_dir.filePath(name);
+    QString errorString;
+    if (!builder.write(fileName, &errorString))
+        qWarning() << errorString;
+    return fileName;
+}
+
+QSharedPointer<QGeoRoutingGraphOffline> tst_QGeoRoutingGraphOffline::load(const QString &fileName)
+{
+    QSharedPointer<QGeoRoutingGraphOffline> graph(new QGeoRoutingGraphOffline);
+    if (!graph->load(fileName))
+        qWarning() << graph->errorString();
+    return graph;
+}
+
+/*
+    Two residential streets at the equator: Main runs east from A to B, Side
+    runs north from B to C. A footway joins A and C directly, and a slower
+    service road bypasses B through D.
+*/
+void tst_QGeoRoutingGraphOffline::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    QGeoRoutingGraphBuilderOffline builder;
+    const quint32 a = builder.addNode(0.0, 0.0);
+    const quint32 b = builder.addNode(0.0, 0.01);
+    const quint32 c = builder.addNode(0.01, 0.01);
+    const quint32 d = builder.addNode(-0.002, 0.012);
+    const quint32 main = builder.addName(QStringLiteral("Main"));
+    const quint32 side = builder.addName(QStringLiteral("Side"));
+    const int access = defaultAccess(Residential);
+    builder.addArc(a, b, Residential, access, main);
+    builder.addArc(b, a, Residential, access, main);
+    builder.addArc(b, c, Residential, access, side);
+    builder.addArc(c, b, Residential, access, side);
+    builder.addArc(a, c, Footway, defaultAccess(Footway));
+    builder.addArc(c, a, Footway, defaultAccess(Footway));
+    builder.addArc(a, d, Service, defaultAccess(Service));
+    builder.addArc(d, a, Service, defaultAccess(Service));
+    builder.addArc(d, c, Service, defaultAccess(Service));
+    builder.addArc(c, d, Service, defaultAccess(Service));
+    m_streets = write(builder, QStringLiteral("streets.graph"));
+}
+
+void tst_QGeoRoutingGraphOffline::invalidFile()
+{
+    QGeoRoutingGraphOffline missing;
+    QVERIFY(!missing.load(m_dir.filePath(QStringLiteral("missing.graph"))));
+    QVERIFY(!missing.errorString().isEmpty());
+
+    QFile valid(m_streets);
+    QVERIFY(valid.open(QIODevice::ReadOnly));
+    const QByteArray data = valid.readAll();
+
+    QFile truncated(m_dir.filePath(QStringLiteral("truncated.graph")));
+    QVERIFY(truncated.open(QIODevice::WriteOnly));
+    truncated.write(data.left(data.size() - 16));
+    truncated.close();
+    QGeoRoutingGraphOffline graph;
+    QVERIFY(!graph.load(truncated.fileName()));
+    QVERIFY(!graph.errorString().isEmpty());
+
+    QFile garbage(m_dir.filePath(QStringLiteral("garbage.graph")));
+    QVERIFY(garbage.open(QIODevice::WriteOnly));
+    garbage.write(QByteArray(data.size(), 'x'));
+    garbage.close();
+    QGeoRoutingGraphOffline other;
+    QVERIFY(!other.load(garbage.fileName()));
+}
+
+void tst_QGeoRoutingGraphOffline::nearestNode()
+{
+    QSharedPointer<QGeoRoutingGraphOffline> graph = load(m_streets);
+    QCOMPARE(graph->nodeCount(), 4u);
+
+    const quint32 b = graph->nearestNode(QGeoCoordinate(0.0005, 0.0098), CarProfile);
+    QVERIFY(b != NoNode);
+    QCOMPARE(graph->coordinate(b), QGeoCoordinate(0.0, 0.01));
+
+    // Far outside of the grid, still the closest node.
+    const quint32 c = graph->nearestNode(QGeoCoordinate(5.0, 0.01), FootProfile);
+    QCOMPARE(graph->coordinate(c), QGeoCoordinate(0.01, 0.01));
+
+    QCOMPARE(graph->nearestNode(QGeoCoordinate(), CarProfile), NoNode);
+}
+
+void tst_QGeoRoutingGraphOffline::contractedPathMatchesSearch()
+{
+    // Perturbed grid with random road classes and one way streets.
+    const int size = 30;
+    quint32 seed = 1;
+    auto random = [&seed]() { seed = seed * 1103515245u + 12345u; return (seed >> 16) & 0x7fff; };
+
+    QGeoRoutingGraphBuilderOffline builder;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x)
+            builder.addNode(50.0 + y * 0.001 + random() % 100 * 1e-6, 8.0 + x * 0.0015);
+    }
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            for (int d = 0; d < 2; ++d) {
+                const int nx = x + (d == 0 ? 1 : 0);
+                const int ny = y + (d == 1 ? 1 : 0);
+                if (nx >= size || ny >= size || random() % 10 == 0)
+                    continue;
+                const int roadClass = random() % RoadClassCount;
+                const int access = defaultAccess(roadClass) ? defaultAccess(roadClass) : int(FootAccess);
+                const int oneway = random() % 8;
+                const quint32 from = quint32(y * size + x);
+                const quint32 to = quint32(ny * size + nx);
+                if (oneway != 0)
+                    builder.addArc(from, to, roadClass, access);
+                if (oneway != 1)
+                    builder.addArc(to, from, roadClass, access);
+            }
+        }
+    }
+    QSharedPointer<QGeoRoutingGraphOffline> graph = load(write(builder, QStringLiteral("grid.graph")));
+    QCOMPARE(graph->nodeCount(), quint32(size * size));
+
+    int found = 0;
+    for (int i = 0; i < 150; ++i) {
+        const Profile profile = Profile(i % ProfileCount);
+        const quint32 source = random() % graph->nodeCount();
+        const quint32 target = random() % graph->nodeCount();
+
+        QGeoRoutingGraphOffline::Path contracted;
+        QGeoRoutingGraphOffline::Path searched;
+        const bool reachable = graph->contractedPath(source, target, profile, &contracted);
+        QCOMPARE(graph->searchPath(source, target, profile, QGeoRoutingGraphOffline::TimeMetric,
+                                   QList<QGeoRectangle>(), &searched), reachable);
+        if (!reachable)
+            continue;
+        ++found;
+        QCOMPARE(contracted.weight, searched.weight);
+
+        // The unpacked arcs form a connected path of the same weight.
+        quint32 weight = 0;
+        quint32 node = source;
+        for (quint32 index : contracted.arcs) {
+            const Arc &arc = graph->arc(index);
+            QVERIFY(arc.access & (1 << profile));
+            QVERIFY(qAbs(graph->coordinate(node).distanceTo(graph->coordinate(arc.target)) * 10 - arc.length) < 1.0);
+            weight += arcDuration(profile, arc);
+            node = arc.target;
+        }
+        QCOMPARE(node, target);
+        QCOMPARE(weight, contracted.weight);
+    }
+    QVERIFY(found > 50);
+}
+
+void tst_QGeoRoutingGraphOffline::oneway()
+{
+    QGeoRoutingGraphBuilderOffline builder;
+    const quint32 a = builder.addNode(0.0, 0.0);
+    const quint32 b = builder.addNode(0.0, 0.001);
+    builder.addArc(a, b, Primary, CarAccess | FootAccess);
+    builder.addArc(b, a, Primary, FootAccess);
+    QSharedPointer<QGeoRoutingGraphOffline> graph = load(write(builder, QStringLiteral("oneway.graph")));
+
+    QGeoRoutingGraphOffline::Path path;
+    QVERIFY(graph->contractedPath(a, b, CarProfile, &path));
+    QCOMPARE(path.arcs.size(), 1);
+    QVERIFY(!graph->contractedPath(b, a, CarProfile, &path));
+    QVERIFY(graph->contractedPath(b, a, FootProfile, &path));
+    QVERIFY(!graph->searchPath(b, a, CarProfile, QGeoRoutingGraphOffline::TimeMetric,
+                               QList<QGeoRectangle>(), &path));
+}
+
+void tst_QGeoRoutingGraphOffline::profileAccess()
+{
+    QSharedPointer<QGeoRoutingGraphOffline> graph = load(m_streets);
+    const quint32 a = graph->nearestNode(QGeoCoordinate(0.0, 0.0), CarProfile);
+    const quint32 c = graph->nearestNode(QGeoCoordinate(0.01, 0.01), CarProfile);
+
+    // Pedestrians take the footway, cars the streets.
+    QGeoRoutingGraphOffline::Path path;
+    QVERIFY(graph->contractedPath(a, c, FootProfile, &path));
+    QCOMPARE(path.arcs.size(), 1);
+    QCOMPARE(int(graph->arc(path.arcs.first()).roadClass), int(Footway));
+
+    QVERIFY(graph->contractedPath(a, c, CarProfile, &path));
+    QCOMPARE(path.arcs.size(), 2);
+    for (quint32 arc : path.arcs)
+        QCOMPARE(int(graph->arc(arc).roadClass), int(Residential));
+
+    // The shortest route for pedestrians is the footway as well.
+    QVERIFY(graph->searchPath(a, c, FootProfile, QGeoRoutingGraphOffline::DistanceMetric,
+                              QList<QGeoRectangle>(), &path));
+    QCOMPARE(path.arcs.size(), 1);
+}
+
+void tst_QGeoRoutingGraphOffline::excludeAreas()
+{
+    QSharedPointer<QGeoRoutingGraphOffline> graph = load(m_streets);
+    const quint32 a = graph->nearestNode(QGeoCoordinate(0.0, 0.0), CarProfile);
+    const quint32 c = graph->nearestNode(QGeoCoordinate(0.01, 0.01), CarProfile);
+
+    QList<QGeoRectangle> areas;
+    areas << QGeoRectangle(QGeoCoordinate(0.001, 0.009), QGeoCoordinate(-0.001, 0.0105));
+
+    QGeoRoutingGraphOffline::Path path;
+    QVERIFY(graph->contractedPath(a, c, CarProfile, &path));
+    QVERIFY(graph->crossesAreas(path, areas));
+
+    QVERIFY(graph->searchPath(a, c, CarProfile, QGeoRoutingGraphOffline::TimeMetric, areas, &path));
+    QVERIFY(!graph->crossesAreas(path, areas));
+    QCOMPARE(path.arcs.size(), 2);
+    for (quint32 arc : path.arcs)
+        QCOMPARE(int(graph->arc(arc).roadClass), int(Service));
+
+    // Through a request, the route goes around the area as well.
+    QGeoRouteRequest request(QGeoCoordinate(0.0, 0.0), QGeoCoordinate(0.01, 0.01));
+    request.setExcludeAreas(areas);
+    const QGeoRouteReplyOffline::Result result = QGeoRouteReplyOffline::calculateRoutes(graph, request);
+    QCOMPARE(result.error, QGeoRouteReply::NoError);
+    QCOMPARE(result.routes.size(), 1);
+    for (const QGeoCoordinate &c : result.routes.first().path())
+        QVERIFY(!areas.first().contains(c));
+}
+
+void tst_QGeoRoutingGraphOffline::maneuvers()
+{
+    QSharedPointer<QGeoRoutingGraphOffline> graph = load(m_streets);
+    QGeoRouteRequest request(QGeoCoordinate(0.0001, 0.0), QGeoCoordinate(0.01, 0.0101));
+    const QGeoRouteReplyOffline::Result result = QGeoRouteReplyOffline::calculateRoutes(graph, request);
+    QCOMPARE(result.error, QGeoRouteReply::NoError);
+    QCOMPARE(result.routes.size(), 1);
+
+    const QGeoRoute route = result.routes.first();
+    const double length = QGeoCoordinate(0.0, 0.0).distanceTo(QGeoCoordinate(0.0, 0.01));
+    QVERIFY(qAbs(route.distance() - 2 * length) < 1.0);
+    QVERIFY(qAbs(route.travelTime() - 2 * length / (30 / 3.6)) <= 1.0);
+    QCOMPARE(route.travelMode(), QGeoRouteRequest::CarTravel);
+    QCOMPARE(route.path().first(), QGeoCoordinate(0.0, 0.0));
+    QCOMPARE(route.path().last(), QGeoCoordinate(0.01, 0.01));
+
+    // Depart on Main, turn left onto Side, arrive.
+    QGeoRouteSegment segment = route.firstRouteSegment();
+    QVERIFY(segment.isValid());
+    QCOMPARE(segment.maneuver().direction(), QGeoManeuver::NoDirection);
+    QVERIFY(segment.maneuver().instructionText().contains(QStringLiteral("Main")));
+    QVERIFY(qAbs(segment.distance() - length) < 1.0);
+    QCOMPARE(segment.path().size(), 2);
+
+    segment = segment.nextRouteSegment();
+    QVERIFY(segment.isValid());
+    QCOMPARE(segment.maneuver().direction(), QGeoManeuver::DirectionLeft);
+    QVERIFY(segment.maneuver().instructionText().contains(QStringLiteral("Side")));
+    QCOMPARE(segment.maneuver().position(), QGeoCoordinate(0.0, 0.01));
+
+    segment = segment.nextRouteSegment();
+    QVERIFY(segment.isValid());
+    QCOMPARE(segment.distance(), 0.0);
+    QCOMPARE(segment.maneuver().position(), QGeoCoordinate(0.01, 0.01));
+    QVERIFY(!segment.nextRouteSegment().isValid());
+}
+
+void tst_QGeoRoutingGraphOffline::noRoute()
+{
+    QSharedPointer<QGeoRoutingGraphOffline> graph = load(m_streets);
+
+    QGeoRouteRequest request(QList<QGeoCoordinate>() << QGeoCoordinate(0.0, 0.0));
+    QGeoRouteReplyOffline::Result result = QGeoRouteReplyOffline::calculateRoutes(graph, request);
+    QCOMPARE(result.error, QGeoRouteReply::UnknownError);
+    QCOMPARE(result.errorString, QStringLiteral("InvalidQuery"));
+
+    request = QGeoRouteRequest(QGeoCoordinate(0.0, 0.0), QGeoCoordinate(0.01, 0.01));
+    request.setTravelModes(QGeoRouteRequest::PublicTransitTravel);
+    result = QGeoRouteReplyOffline::calculateRoutes(graph, request);
+    QCOMPARE(result.error, QGeoRouteReply::UnknownError);
+
+    // Every way out of A is excluded.
+    request.setTravelModes(QGeoRouteRequest::CarTravel);
+    request.setExcludeAreas(QList<QGeoRectangle>()
+                            << QGeoRectangle(QGeoCoordinate(0.0005, -0.0005), QGeoCoordinate(-0.0005, 0.0005)));
+    result = QGeoRouteReplyOffline::calculateRoutes(graph, request);
+    QCOMPARE(result.error, QGeoRouteReply::UnknownError);
+    QCOMPARE(result.errorString, QStringLiteral("NoRoute"));
+}
+
+void tst_QGeoRoutingGraphOffline::engine()
+{
+    QVariantMap parameters;
+    QGeoServiceProvider::Error error;
+    QString errorString;
+    QGeoRoutingManagerEngineOffline missing(parameters, &error, &errorString);
+    QCOMPARE(error, QGeoServiceProvider::MissingRequiredParameterError);
+
+    parameters.insert(QStringLiteral("offline.graph"), m_streets + QStringLiteral(".missing"));
+    QGeoRoutingManagerEngineOffline unreadable(parameters, &error, &errorString);
+    QCOMPARE(error, QGeoServiceProvider::NotSupportedError);
+    QVERIFY(!errorString.isEmpty());
+
+    parameters.insert(QStringLiteral("offline.graph"), m_streets);
+    QGeoRoutingManagerEngineOffline engine(parameters, &error, &errorString);
+    QCOMPARE(error, QGeoServiceProvider::NoError);
+    QVERIFY(engine.supportedTravelModes() & QGeoRouteRequest::PedestrianTravel);
+
+    QGeoRouteRequest request(QGeoCoordinate(0.0, 0.0), QGeoCoordinate(0.01, 0.01));
+    request.setTravelModes(QGeoRouteRequest::PedestrianTravel);
+    QSignalSpy spy(&engine, SIGNAL(finished(QGeoRouteReply*)));
+    QGeoRouteReply *reply = engine.calculateRoute(request);
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(reply->error(), QGeoRouteReply::NoError);
+    QCOMPARE(reply->routes().size(), 1);
+    QCOMPARE(reply->routes().first().travelMode(), QGeoRouteRequest::PedestrianTravel);
+    QCOMPARE(reply->routes().first().path().size(), 2);
+    delete reply;
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoRoutingGraphOffline)
+
+#include "tst_qgeoroutinggraphoffline.moc"
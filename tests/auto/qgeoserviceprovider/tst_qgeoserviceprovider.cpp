@@ -44,6 +44,7 @@ private slots:
     void tst_features();
     void tst_misc();
     void tst_nokiaRename();
+    void tst_sharedMappingManager();
 };
 
 void tst_QGeoServiceProvider::initTestCase()
@@ -222,6 +223,51 @@ void tst_QGeoServiceProvider::tst_nokiaRename()
 
 }
 
+void tst_QGeoServiceProvider::tst_sharedMappingManager()
+{
+    QVariantMap parameters;
+    parameters.insert(QStringLiteral("osm.mapping.providersrepository.disabled"), true);
+
+    QGeoServiceProvider first(QStringLiteral("osm"), parameters);
+    QGeoServiceProvider second(QStringLiteral("osm"), parameters);
+    QVERIFY(first.mappingManager());
+    QCOMPARE(second.mappingManager(), first.mappingManager());
+
+    // parameters of other plugins do not matter
+    QVariantMap otherParameters = parameters;
+    otherParameters.insert(QStringLiteral("here.app_id"), QStringLiteral("id"));
+    QGeoServiceProvider third(QStringLiteral("osm"), otherParameters);
+    QCOMPARE(third.mappingManager(), first.mappingManager());
+
+    QVariantMap differentParameters = parameters;
+    differentParameters.insert(QStringLiteral("osm.mapping.highdpi_tiles"), true);
+    QGeoServiceProvider different(QStringLiteral("osm"), differentParameters);
+    QVERIFY(different.mappingManager());
+    QVERIFY(different.mappingManager() != first.mappingManager());
+
+    const QLocale finnish(QLocale::Finnish, QLocale::Finland);
+    QGeoServiceProvider otherLocale(QStringLiteral("osm"), parameters);
+    otherLocale.setLocale(finnish);
+    if (QLocale() != finnish)
+        QVERIFY(otherLocale.mappingManager() != first.mappingManager());
+
+    // deleting one of the providers leaves the manager to the others
+    QGeoServiceProvider *provider = new QGeoServiceProvider(QStringLiteral("osm"), parameters);
+    QCOMPARE(provider->mappingManager(), first.mappingManager());
+    delete provider;
+    QGeoServiceProvider last(QStringLiteral("osm"), parameters);
+    QCOMPARE(last.mappingManager(), first.mappingManager());
+
+    // a shared manager is not relocalized for the other providers
+    if (QLocale() != finnish) {
+        QGeoMappingManager *shared = first.mappingManager();
+        last.setLocale(finnish);
+        QCOMPARE(first.mappingManager(), shared);
+        QVERIFY(last.mappingManager() != shared);
+        QCOMPARE(last.mappingManager(), otherLocale.mappingManager());
+    }
+}
+
 QTEST_GUILESS_MAIN(tst_QGeoServiceProvider)
 
 #include "tst_qgeoserviceprovider.moc"
@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgeotileatlas
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotileatlas.cpp
+
+QT += location-private positioning-private testlib
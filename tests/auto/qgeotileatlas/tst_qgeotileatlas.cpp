@@ -0,0 +1,120 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include "qgeotileatlas_p.h"
+
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+typedef QGeoTileAtlasAllocator::Slot Slot;
+
+class tst_QGeoTileAtlas : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void allocate();
+    void recycle();
+    void dropEmptyPages();
+    void isSupported();
+};
+
+void tst_QGeoTileAtlas::allocate()
+{
+    QGeoTileAtlasAllocator allocator(4);
+    QCOMPARE(allocator.pageCount(), 0);
+
+    for (int i = 0; i < 4; ++i)
+        QCOMPARE(allocator.allocate(), Slot(0, i));
+    QCOMPARE(allocator.pageCount(), 1);
+    QCOMPARE(allocator.usedSlots(0), 4);
+
+    QCOMPARE(allocator.allocate(), Slot(1, 0));
+    QCOMPARE(allocator.pageCount(), 2);
+    QCOMPARE(allocator.usedSlots(), 5);
+}
+
+void tst_QGeoTileAtlas::recycle()
+{
+    QGeoTileAtlasAllocator allocator(4);
+    for (int i = 0; i < 6; ++i)
+        allocator.allocate();
+
+    // Free slots of the first pages are handed out before those of later ones
+    allocator.release(Slot(1, 0));
+    allocator.release(Slot(0, 2));
+    QCOMPARE(allocator.allocate(), Slot(0, 2));
+    QCOMPARE(allocator.allocate(), Slot(1, 0));
+    QCOMPARE(allocator.allocate(), Slot(1, 2));
+    QCOMPARE(allocator.usedSlots(), 7);
+
+    // Invalid slots are ignored
+    allocator.release(Slot());
+    allocator.release(Slot(5, 0));
+    allocator.release(Slot(0, 4));
+    QCOMPARE(allocator.usedSlots(), 7);
+}
+
+void tst_QGeoTileAtlas::dropEmptyPages()
+{
+    QGeoTileAtlasAllocator allocator(2);
+    for (int i = 0; i < 6; ++i)
+        allocator.allocate();
+    QCOMPARE(allocator.pageCount(), 3);
+
+    // An empty page in the middle is kept
+    allocator.release(Slot(1, 0));
+    allocator.release(Slot(1, 1));
+    QCOMPARE(allocator.pageCount(), 3);
+
+    allocator.release(Slot(2, 1));
+    allocator.release(Slot(2, 0));
+    QCOMPARE(allocator.pageCount(), 1);
+    QCOMPARE(allocator.usedSlots(), 2);
+
+    allocator.clear();
+    QCOMPARE(allocator.pageCount(), 0);
+    QCOMPARE(allocator.allocate(), Slot(0, 0));
+}
+
+void tst_QGeoTileAtlas::isSupported()
+{
+#if QT_CONFIG(opengl)
+    QVERIFY(QGeoTileAtlas::isSupported(QSize(256, 256)));
+    QVERIFY(QGeoTileAtlas::isSupported(QSize(512, 512)));
+    QVERIFY(!QGeoTileAtlas::isSupported(QSize(1024, 1024)));
+    QVERIFY(!QGeoTileAtlas::isSupported(QSize(8, 8)));
+#endif
+    QVERIFY(!QGeoTileAtlas::isSupported(QSize()));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTileAtlas)
+#include "tst_qgeotileatlas.moc"
@@ -394,6 +394,51 @@ class tst_QGeoTiledMapScene : public QObject
             populateScreenMercatorData();
         }
 
+        void fallbackTiles()
+        {
+            QGeoCameraData camera;
+            camera.setZoomLevel(4);
+            camera.setCenter(QGeoCoordinate(0.0, 0.0));
+
+            QGeoCameraTiles ct;
+            ct.setTileSize(256);
+            ct.setCameraData(camera);
+            ct.setScreenSize(QSize(512, 512));
+
+            QGeoTiledMapScene scene;
+            scene.setTileSize(256);
+            scene.setScreenSize(QSize(512, 512));
+            scene.setCameraData(camera);
+            scene.setVisibleTiles(ct.createTiles());
+
+            const QGeoTileSpec tile = *scene.visibleTiles().cbegin();
+
+            QSharedPointer<QGeoTileTexture> ancestor(new QGeoTileTexture);
+            ancestor->spec = QGeoTileSpec(tile.plugin(), tile.mapId(), tile.zoom() - 1,
+                                          tile.x() / 2, tile.y() / 2, tile.version());
+            ancestor->image = QImage(256, 256, QImage::Format_ARGB32_Premultiplied);
+
+            QSharedPointer<QGeoTileTexture> exact(new QGeoTileTexture);
+            exact->spec = tile;
+            exact->image = QImage(256, 256, QImage::Format_ARGB32_Premultiplied);
+
+            // Tiles shown through a stand-in texture are still to be requested
+            QVERIFY(scene.addFallbackTile(tile, ancestor));
+            QVERIFY(!scene.texturedTiles().contains(tile));
+            QVERIFY(!scene.addFallbackTile(tile, ancestor));
+
+            scene.addTile(tile, exact);
+            QVERIFY(scene.texturedTiles().contains(tile));
+
+            // A stand-in texture never replaces the proper one
+            QVERIFY(!scene.addFallbackTile(tile, ancestor));
+            QVERIFY(scene.texturedTiles().contains(tile));
+
+            QGeoTileSpec hidden = tile;
+            hidden.setZoom(tile.zoom() + 1);
+            QVERIFY(!scene.addFallbackTile(hidden, ancestor));
+        }
+
 };
 
 QTEST_GUILESS_MAIN(tst_QGeoTiledMapScene)
@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgeotilefreshness
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotilefreshness.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,182 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include "qabstractgeotilecache_p.h"
+#include "qgeofiletilecache_p.h"
+#include "qgeotilespec_p.h"
+
+#include <QtCore/QBuffer>
+#include <QtCore/QTemporaryDir>
+#include <QtGui/QImage>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+typedef QList<QGeoTileFreshness::RawHeaderPair> RawHeaders;
+
+class tst_QGeoTileFreshness : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void httpDate();
+    void fromHttpHeaders_data();
+    void fromHttpHeaders();
+    void validators();
+    void conditionalHeaders();
+    void cachedFreshness();
+
+private:
+    static QDateTime received();
+};
+
+QDateTime tst_QGeoTileFreshness::received()
+{
+    return QDateTime(QDate(2017, 3, 1), QTime(12, 0), Qt::UTC);
+}
+
+void tst_QGeoTileFreshness::httpDate()
+{
+    const QByteArray date("Wed, 01 Mar 2017 12:00:00 GMT");
+    QCOMPARE(QGeoTileFreshness::fromHttpDate(date), received());
+    QCOMPARE(QGeoTileFreshness::toHttpDate(received()), date);
+    QVERIFY(!QGeoTileFreshness::fromHttpDate("0").isValid());
+}
+
+void tst_QGeoTileFreshness::fromHttpHeaders_data()
+{
+    QTest::addColumn<RawHeaders>("headers");
+    QTest::addColumn<qint64>("lifetime");
+
+    QTest::newRow("max-age")
+            << (RawHeaders() << qMakePair(QByteArray("Cache-Control"), QByteArray("public, max-age=3600"))
+                             << qMakePair(QByteArray("Age"), QByteArray("600")))
+            << qint64(3000);
+    QTest::newRow("max-age overrides expires")
+            << (RawHeaders() << qMakePair(QByteArray("Expires"), QByteArray("Wed, 01 Mar 2017 13:00:00 GMT"))
+                             << qMakePair(QByteArray("cache-control"), QByteArray("max-age=60")))
+            << qint64(60);
+    QTest::newRow("expires relative to date")
+            << (RawHeaders() << qMakePair(QByteArray("Date"), QByteArray("Wed, 01 Mar 2017 11:00:00 GMT"))
+                             << qMakePair(QByteArray("Expires"), QByteArray("Wed, 01 Mar 2017 13:00:00 GMT")))
+            << qint64(7200);
+    QTest::newRow("invalid expires")
+            << (RawHeaders() << qMakePair(QByteArray("Expires"), QByteArray("0")))
+            << qint64(0);
+    QTest::newRow("no-cache")
+            << (RawHeaders() << qMakePair(QByteArray("Cache-Control"), QByteArray("max-age=60, no-cache")))
+            << qint64(0);
+    QTest::newRow("heuristic")
+            << (RawHeaders() << qMakePair(QByteArray("Last-Modified"), QByteArray("Sun, 19 Feb 2017 12:00:00 GMT")))
+            << qint64(86400);
+    QTest::newRow("heuristic capped")
+            << (RawHeaders() << qMakePair(QByteArray("Last-Modified"), QByteArray("Tue, 01 Mar 2016 12:00:00 GMT")))
+            << qint64(7 * 86400);
+}
+
+void tst_QGeoTileFreshness::fromHttpHeaders()
+{
+    QFETCH(RawHeaders, headers);
+    QFETCH(qint64, lifetime);
+
+    const QGeoTileFreshness freshness = QGeoTileFreshness::fromHttpHeaders(headers, received());
+    QVERIFY(freshness.isValid());
+    QCOMPARE(freshness.expires, received().addSecs(lifetime));
+    QCOMPARE(freshness.isStale(received().addSecs(lifetime)), true);
+    QCOMPARE(freshness.isStale(received().addSecs(lifetime - 1)), false);
+}
+
+void tst_QGeoTileFreshness::validators()
+{
+    const RawHeaders headers = RawHeaders()
+            << qMakePair(QByteArray("etag"), QByteArray(" \"33a64df5\" "))
+            << qMakePair(QByteArray("Last-Modified"), QByteArray("Sun, 19 Feb 2017 12:00:00 GMT"));
+    const QGeoTileFreshness freshness = QGeoTileFreshness::fromHttpHeaders(headers, received());
+    QCOMPARE(freshness.etag, QByteArray("\"33a64df5\""));
+    QCOMPARE(freshness.lastModified, QDateTime(QDate(2017, 2, 19), QTime(12, 0), Qt::UTC));
+
+    // Without any caching information a tile is kept as it is
+    const QGeoTileFreshness none = QGeoTileFreshness::fromHttpHeaders(RawHeaders(), received());
+    QVERIFY(!none.isValid());
+    QVERIFY(!none.isStale(received().addYears(10)));
+    QVERIFY(none != freshness);
+}
+
+void tst_QGeoTileFreshness::conditionalHeaders()
+{
+    QGeoTileFreshness freshness;
+    QVERIFY(freshness.conditionalHeaders().isEmpty());
+
+    freshness.etag = "\"33a64df5\"";
+    freshness.lastModified = received();
+    const RawHeaders headers = freshness.conditionalHeaders();
+    QCOMPARE(headers.size(), 2);
+    QCOMPARE(headers.at(0), qMakePair(QByteArray("If-None-Match"), QByteArray("\"33a64df5\"")));
+    QCOMPARE(headers.at(1), qMakePair(QByteArray("If-Modified-Since"), QByteArray("Wed, 01 Mar 2017 12:00:00 GMT")));
+}
+
+void tst_QGeoTileFreshness::cachedFreshness()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QImage image(256, 256, QImage::Format_RGB32);
+    image.fill(Qt::gray);
+    QByteArray bytes;
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, "PNG");
+
+    const QGeoTileSpec spec(QStringLiteral("test"), 1, 2, 1, 1);
+    QGeoTileFreshness freshness;
+    freshness.etag = "\"33a64df5\"";
+    freshness.expires = received();
+
+    {
+        QScopedPointer<QAbstractGeoTileCache> cache(new QGeoFileTileCache(dir.path()));
+        cache->init();
+        cache->insert(spec, bytes, QStringLiteral("png"), QAbstractGeoTileCache::DiskCache);
+        QVERIFY(!cache->freshness(spec).isValid());
+        cache->setFreshness(spec, freshness);
+        QCOMPARE(cache->freshness(spec), freshness);
+    }
+
+    // After a restart the freshness is read together with the tile, not on its own
+    QScopedPointer<QAbstractGeoTileCache> cache(new QGeoFileTileCache(dir.path()));
+    cache->init();
+    QVERIFY(cache->contains(spec, QAbstractGeoTileCache::DiskCache));
+    QVERIFY(!cache->freshness(spec).isValid());
+    QVERIFY(cache->get(spec));
+    QCOMPARE(cache->freshness(spec), freshness);
+    QVERIFY(cache->freshness(spec).isStale(received()));
+}
+
+QTEST_GUILESS_MAIN(tst_QGeoTileFreshness)
+#include "tst_qgeotilefreshness.moc"
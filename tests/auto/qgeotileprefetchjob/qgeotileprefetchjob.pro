@@ -0,0 +1,8 @@
+CONFIG += testcase
+TARGET = tst_qgeotileprefetchjob
+
+INCLUDEPATH += ../../../src/location/maps
+
+SOURCES += tst_qgeotileprefetchjob.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,386 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/location/maps
+
+#include "qgeotileprefetchjob_p.h"
+#include "qgeotilespec_p.h"
+#include "qgeotiledmappingmanagerengine_p.h"
+#include "qgeotilefetcher_p.h"
+#include "qgeotiledmapreply_p.h"
+#include "qgeofiletilecache_p.h"
+#include "qgeocameracapabilities_p.h"
+#include <QtPositioning/QGeoRectangle>
+#include <QtPositioning/QGeoCircle>
+#include <QtPositioning/QGeoPath>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+#include <QtTest/QSignalSpy>
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoTilePrefetchJob::State)
+
+class PrefetchTileReply : public QGeoTiledMapReply
+{
+    Q_OBJECT
+public:
+    PrefetchTileReply(const QGeoTileSpec &spec, QObject *parent)
+    :   QGeoTiledMapReply(spec, parent)
+    {
+        setMapImageData(QByteArrayLiteral("tile"));
+        setMapImageFormat(QStringLiteral("png"));
+    }
+
+    void finish(bool success)
+    {
+        if (success)
+            setFinished(true);
+        else
+            setError(QGeoTiledMapReply::CommunicationError, QStringLiteral("failed"));
+    }
+};
+
+// Keeps the replies open until the test finishes them
+class PrefetchTileFetcher : public QGeoTileFetcher
+{
+    Q_OBJECT
+public:
+    explicit PrefetchTileFetcher(QGeoMappingManagerEngine *parent)
+    :   QGeoTileFetcher(parent)
+    {
+    }
+
+    QList<QGeoTileSpec> requestedTiles() const
+    {
+        return m_replies.keys();
+    }
+
+    void finish(const QGeoTileSpec &spec, bool success = true)
+    {
+        PrefetchTileReply *reply = m_replies.take(spec);
+        if (reply)
+            reply->finish(success);
+    }
+
+private:
+    QGeoTiledMapReply *getTileImage(const QGeoTileSpec &spec) Q_DECL_OVERRIDE
+    {
+        PrefetchTileReply *reply = new PrefetchTileReply(spec, this);
+        m_replies.insert(spec, reply);
+        return reply;
+    }
+
+    QMap<QGeoTileSpec, PrefetchTileReply *> m_replies;
+};
+
+class PrefetchEngine : public QGeoTiledMappingManagerEngine
+{
+    Q_OBJECT
+public:
+    explicit PrefetchEngine(const QString &cacheDirectory)
+    {
+        QGeoCameraCapabilities capabilities;
+        capabilities.setMinimumZoomLevel(0.0);
+        capabilities.setMaximumZoomLevel(10.0);
+        setCameraCapabilities(capabilities);
+        setTileSize(QSize(256, 256));
+        setTileCache(new QGeoFileTileCache(cacheDirectory));
+        m_fetcher = new PrefetchTileFetcher(this);
+        setTileFetcher(m_fetcher);
+    }
+
+    PrefetchTileFetcher *fetcher() const
+    {
+        return m_fetcher;
+    }
+
+private:
+    PrefetchTileFetcher *m_fetcher;
+};
+
+class tst_QGeoTilePrefetchJob : public QObject
+{
+    Q_OBJECT
+
+private:
+    static QSet<QPair<int, int> > columnsAndRows(const QList<QGeoTileSpec> &tiles)
+    {
+        QSet<QPair<int, int> > result;
+        for (const QGeoTileSpec &tile : tiles)
+            result.insert(qMakePair(tile.x(), tile.y()));
+        return result;
+    }
+
+    static QList<QGeoTileSpec> tiles(const QGeoShape &shape, int zoom, int maxTiles = -1, bool *truncated = 0)
+    {
+        return QGeoTilePrefetchJob::tilesForShape(shape, QStringLiteral("test"), 1, zoom, -1,
+                                                 maxTiles, truncated);
+    }
+
+private slots:
+    void rectangle()
+    {
+        const QGeoRectangle rect(QGeoCoordinate(10.0, -10.0), QGeoCoordinate(-10.0, 10.0));
+        const QList<QGeoTileSpec> result = tiles(rect, 2);
+
+        QSet<QPair<int, int> > expected;
+        expected << qMakePair(1, 1) << qMakePair(2, 1) << qMakePair(1, 2) << qMakePair(2, 2);
+        QCOMPARE(result.size(), 4);
+        QCOMPARE(columnsAndRows(result), expected);
+
+        for (const QGeoTileSpec &tile : result) {
+            QCOMPARE(tile.zoom(), 2);
+            QCOMPARE(tile.mapId(), 1);
+            QCOMPARE(tile.plugin(), QStringLiteral("test"));
+        }
+
+        // Row by row, from the north
+        QCOMPARE(result.first().y(), 1);
+        QCOMPARE(result.last().y(), 2);
+    }
+
+    void rectangleAcrossDateline()
+    {
+        const QGeoRectangle rect(QGeoCoordinate(10.0, 170.0), QGeoCoordinate(-10.0, -170.0));
+        const QList<QGeoTileSpec> result = tiles(rect, 2);
+
+        QSet<QPair<int, int> > expected;
+        expected << qMakePair(3, 1) << qMakePair(0, 1) << qMakePair(3, 2) << qMakePair(0, 2);
+        QCOMPARE(result.size(), 4);
+        QCOMPARE(columnsAndRows(result), expected);
+    }
+
+    void wholeWorld()
+    {
+        const QGeoRectangle rect(QGeoCoordinate(85.0, -180.0), QGeoCoordinate(-85.0, 180.0));
+        QCOMPARE(tiles(rect, 0).size(), 1);
+        QCOMPARE(tiles(rect, 1).size(), 4);
+        QCOMPARE(tiles(rect, 3).size(), 64);
+    }
+
+    void circle()
+    {
+        const QGeoCoordinate center(1.0, 1.0);
+        const QGeoCircle circle(center, 1000.0);
+        const int zoom = 10;
+        const QList<QGeoTileSpec> result = tiles(circle, zoom);
+
+        const QDoubleVector2D mercator = QWebMercator::coordToMercator(center) * (1 << zoom);
+        QVERIFY(columnsAndRows(result).contains(qMakePair(int(mercator.x()), int(mercator.y()))));
+        // A tile is about 39 km wide at this zoom level
+        QVERIFY(result.size() >= 1);
+        QVERIFY(result.size() <= 4);
+        QCOMPARE(columnsAndRows(result).size(), result.size());
+    }
+
+    void corridor()
+    {
+        QList<QGeoCoordinate> coordinates;
+        coordinates << QGeoCoordinate(0.5, 0.5) << QGeoCoordinate(0.5, 20.5);
+
+        const QList<QGeoTileSpec> line = tiles(QGeoPath(coordinates), 6);
+        QSet<QPair<int, int> > expected;
+        expected << qMakePair(32, 31) << qMakePair(33, 31) << qMakePair(34, 31) << qMakePair(35, 31);
+        QCOMPARE(columnsAndRows(line), expected);
+
+        const QList<QGeoTileSpec> corridor = tiles(QGeoPath(coordinates, 2000000.0), 6);
+        QVERIFY(corridor.size() > line.size());
+        QVERIFY(columnsAndRows(corridor).contains(columnsAndRows(line)));
+    }
+
+    void budget()
+    {
+        const QGeoRectangle rect(QGeoCoordinate(10.0, -10.0), QGeoCoordinate(-10.0, 10.0));
+
+        bool truncated = false;
+        QCOMPARE(tiles(rect, 2, 3, &truncated).size(), 3);
+        QVERIFY(truncated);
+
+        QCOMPARE(tiles(rect, 2, 4, &truncated).size(), 4);
+        QVERIFY(!truncated);
+
+        // Nothing fits, but the shape covers tiles
+        QCOMPARE(tiles(rect, 2, 0, &truncated).size(), 0);
+        QVERIFY(truncated);
+
+        QCOMPARE(tiles(QGeoRectangle(), 2, 0, &truncated).size(), 0);
+        QVERIFY(!truncated);
+    }
+
+    void prefetchRegionBudget()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        PrefetchEngine engine(cacheDir.path());
+
+        // 1 tile at zoom 0, 4 at zoom 1 and 4 at zoom 2
+        const QGeoRectangle rect(QGeoCoordinate(10.0, -10.0), QGeoCoordinate(-10.0, 10.0));
+
+        QScopedPointer<QGeoTilePrefetchJob> job(engine.prefetchRegion(rect, 1, 0, 2, 9));
+        QCOMPARE(job->totalTiles(), 9);
+        QVERIFY(!job->isTruncated());
+        job->cancel();
+
+        // The budget runs out exactly at the end of zoom level 1
+        job.reset(engine.prefetchRegion(rect, 1, 0, 2, 5));
+        QCOMPARE(job->totalTiles(), 5);
+        QVERIFY(job->isTruncated());
+        job->cancel();
+
+        job.reset(engine.prefetchRegion(rect, 1, 0, 2, 7));
+        QCOMPARE(job->totalTiles(), 7);
+        QVERIFY(job->isTruncated());
+        for (const QGeoTileSpec &tile : job->remainingTiles())
+            QVERIFY(tile.zoom() <= 2);
+        job->cancel();
+
+        // Zoom levels out of the camera capabilities are skipped
+        job.reset(engine.prefetchRegion(rect, 1, 9, 12));
+        QCOMPARE(job->totalTiles(), tiles(rect, 9).size() + tiles(rect, 10).size());
+        QVERIFY(!job->isTruncated());
+    }
+
+    void jobFinishes()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        PrefetchEngine engine(cacheDir.path());
+
+        const QList<QGeoTileSpec> specs = tiles(QGeoRectangle(QGeoCoordinate(10.0, -10.0), QGeoCoordinate(-10.0, 10.0)), 2);
+        QCOMPARE(specs.size(), 4);
+
+        // Tiles already on disk are not downloaded again
+        engine.tileCache()->insert(specs.at(0), QByteArrayLiteral("tile"), QStringLiteral("png"),
+                                   QAbstractGeoTileCache::DiskCache);
+
+        qRegisterMetaType<QGeoTilePrefetchJob::State>();
+        QScopedPointer<QGeoTilePrefetchJob> job(engine.prefetchTiles(specs));
+        QSignalSpy progressSpy(job.data(), SIGNAL(progress(int,int)));
+        QSignalSpy stateSpy(job.data(), SIGNAL(stateChanged(QGeoTilePrefetchJob::State)));
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Running);
+        QCOMPARE(job->completedTiles(), 1);
+        QCOMPARE(job->totalTiles(), 4);
+
+        // Background requests are limited, the other tiles wait in the fetcher
+        QTRY_COMPARE(engine.fetcher()->requestedTiles().size(), 2);
+        QVERIFY(!engine.fetcher()->requestedTiles().contains(specs.at(0)));
+
+        engine.fetcher()->finish(engine.fetcher()->requestedTiles().first(), false);
+        QTRY_COMPARE(job->failedTiles(), 1);
+        QTRY_COMPARE(engine.fetcher()->requestedTiles().size(), 2);
+
+        while (!engine.fetcher()->requestedTiles().isEmpty()) {
+            engine.fetcher()->finish(engine.fetcher()->requestedTiles().first());
+            QTest::qWait(0);
+        }
+
+        QTRY_COMPARE(job->state(), QGeoTilePrefetchJob::Finished);
+        QCOMPARE(job->completedTiles(), 3);
+        QCOMPARE(job->failedTiles(), 1);
+        QVERIFY(job->remainingTiles().isEmpty());
+        QCOMPARE(stateSpy.count(), 1);
+        QCOMPARE(progressSpy.last().at(0).toInt(), 4);
+        QCOMPARE(progressSpy.last().at(1).toInt(), 4);
+    }
+
+    void jobPauseResumeCancel()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        PrefetchEngine engine(cacheDir.path());
+
+        const QList<QGeoTileSpec> specs = tiles(QGeoRectangle(QGeoCoordinate(10.0, -10.0), QGeoCoordinate(-10.0, 10.0)), 2);
+        QScopedPointer<QGeoTilePrefetchJob> job(engine.prefetchTiles(specs));
+        QTRY_COMPARE(engine.fetcher()->requestedTiles().size(), 2);
+
+        job->pause();
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Paused);
+        QCOMPARE(job->remainingTiles().size(), 4);
+
+        // Tiles finishing while paused do not count for the job
+        const QGeoTileSpec early = engine.fetcher()->requestedTiles().first();
+        engine.fetcher()->finish(early);
+        QTest::qWait(50);
+        QCOMPARE(job->completedTiles(), 0);
+        QCOMPARE(engine.fetcher()->requestedTiles().size(), 1);
+
+        // Resuming skips the tile that reached the disk cache meanwhile
+        job->resume();
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Running);
+        QCOMPARE(job->completedTiles(), 1);
+        QTRY_COMPARE(engine.fetcher()->requestedTiles().size(), 2);
+
+        job->cancel();
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Canceled);
+        QCOMPARE(job->remainingTiles().size(), 3);
+        QVERIFY(!job->remainingTiles().contains(early));
+
+        // Canceled jobs stay canceled
+        job->resume();
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Canceled);
+        job->pause();
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Canceled);
+
+        // and ignore the tiles still arriving
+        for (const QGeoTileSpec &spec : engine.fetcher()->requestedTiles())
+            engine.fetcher()->finish(spec);
+        QTest::qWait(50);
+        QCOMPARE(job->completedTiles(), 1);
+        QCOMPARE(job->remainingTiles().size(), 3);
+    }
+
+    void jobOutlivesEngine()
+    {
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        QScopedPointer<PrefetchEngine> engine(new PrefetchEngine(cacheDir.path()));
+
+        const QList<QGeoTileSpec> specs = tiles(QGeoRectangle(QGeoCoordinate(10.0, -10.0), QGeoCoordinate(-10.0, 10.0)), 2);
+        QScopedPointer<QGeoTilePrefetchJob> job(engine->prefetchTiles(specs));
+        QTRY_COMPARE(engine->fetcher()->requestedTiles().size(), 2);
+
+        engine.reset();
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Canceled);
+        QCOMPARE(job->remainingTiles().size(), 4);
+        job->resume();
+        QCOMPARE(job->state(), QGeoTilePrefetchJob::Canceled);
+    }
+
+    void invalidShape()
+    {
+        QCOMPARE(tiles(QGeoRectangle(), 4).size(), 0);
+        QCOMPARE(tiles(QGeoCircle(), 4).size(), 0);
+    }
+};
+
+QTEST_GUILESS_MAIN(tst_QGeoTilePrefetchJob)
+#include "tst_qgeotileprefetchjob.moc"
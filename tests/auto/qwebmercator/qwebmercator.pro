@@ -0,0 +1,7 @@
+TEMPLATE = app
+CONFIG += testcase
+TARGET = tst_qwebmercator
+
+SOURCES += tst_qwebmercator.cpp
+
+QT += location-private positioning-private testlib
@@ -0,0 +1,310 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+//TESTED_COMPONENT=src/positioning
+
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtPositioning/private/qworldpoint_p.h>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QDoubleVector2D)
+
+/* The bounds documented for the batch conversions. */
+static const double mercatorTolerance = 1e-14;
+static const double degreeTolerance = 1e-13;
+
+class tst_QWebMercator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void coordToMercatorBatch_data();
+    void coordToMercatorBatch();
+    void coordToMercatorBatchRandom();
+    void mercatorToCoordBatch_data();
+    void mercatorToCoordBatch();
+    void mercatorToCoordBatchRandom();
+    void batchIndependentOfCount();
+    void itemPositionBatch_data();
+    void itemPositionBatch();
+    void worldPointItemPositions_data();
+    void worldPointItemPositions();
+    void worldPointWrap();
+};
+
+void tst_QWebMercator::coordToMercatorBatch_data()
+{
+    QTest::addColumn<QGeoCoordinate>("coordinate");
+
+    QTest::newRow("origin") << QGeoCoordinate(0.0, 0.0);
+    QTest::newRow("helsinki") << QGeoCoordinate(60.1699, 24.9384);
+    QTest::newRow("sydney") << QGeoCoordinate(-33.8688, 151.2093);
+    QTest::newRow("dateline") << QGeoCoordinate(12.5, 180.0);
+    QTest::newRow("antimeridian") << QGeoCoordinate(-12.5, -180.0);
+    QTest::newRow("tiny latitude") << QGeoCoordinate(1e-12, 0.0);
+    QTest::newRow("mercator limit") << QGeoCoordinate(85.05112877980659, 10.0);
+    QTest::newRow("negative mercator limit") << QGeoCoordinate(-85.05112877980659, 10.0);
+    QTest::newRow("beyond limit") << QGeoCoordinate(87.0, 10.0);
+    QTest::newRow("north pole") << QGeoCoordinate(90.0, 0.0);
+    QTest::newRow("south pole") << QGeoCoordinate(-90.0, 0.0);
+}
+
+void tst_QWebMercator::coordToMercatorBatch()
+{
+    QFETCH(QGeoCoordinate, coordinate);
+
+    const QDoubleVector2D expected = QWebMercator::coordToMercator(coordinate);
+    QDoubleVector2D result;
+    QWebMercator::coordToMercator(&coordinate, &result, 1);
+
+    QCOMPARE(result.x(), expected.x());
+    QVERIFY2(qAbs(result.y() - expected.y()) <= mercatorTolerance,
+             qPrintable(QString::number(result.y() - expected.y())));
+    QVERIFY(result.y() >= 0.0 && result.y() <= 1.0);
+}
+
+void tst_QWebMercator::coordToMercatorBatchRandom()
+{
+    qsrand(1);
+    QVector<QGeoCoordinate> coordinates(100000);
+    for (QGeoCoordinate &c : coordinates)
+        c = QGeoCoordinate(qrand() * 180.0 / RAND_MAX - 90.0, qrand() * 360.0 / RAND_MAX - 180.0);
+
+    QVector<QDoubleVector2D> result(coordinates.size());
+    QWebMercator::coordToMercator(coordinates.constData(), result.data(), coordinates.size());
+
+    // At zoom level 22 the map is 2^30 pixels wide, the bound is about 1e-5 pixels
+    double maxError = 0.0;
+    for (int i = 0; i < coordinates.size(); ++i) {
+        const QDoubleVector2D expected = QWebMercator::coordToMercator(coordinates.at(i));
+        QCOMPARE(result.at(i).x(), expected.x());
+        maxError = qMax(maxError, qAbs(result.at(i).y() - expected.y()));
+    }
+    QVERIFY2(maxError <= mercatorTolerance, qPrintable(QString::number(maxError)));
+}
+
+void tst_QWebMercator::mercatorToCoordBatch_data()
+{
+    QTest::addColumn<QDoubleVector2D>("mercator");
+
+    QTest::newRow("center") << QDoubleVector2D(0.5, 0.5);
+    QTest::newRow("north edge") << QDoubleVector2D(0.25, 0.0);
+    QTest::newRow("south edge") << QDoubleVector2D(0.75, 1.0);
+    QTest::newRow("above") << QDoubleVector2D(0.25, -0.5);
+    QTest::newRow("below") << QDoubleVector2D(0.25, 1.5);
+    QTest::newRow("near north edge") << QDoubleVector2D(0.1, 1e-9);
+    QTest::newRow("wrapped west") << QDoubleVector2D(-0.25, 0.3);
+    QTest::newRow("wrapped east") << QDoubleVector2D(1.75, 0.7);
+}
+
+void tst_QWebMercator::mercatorToCoordBatch()
+{
+    QFETCH(QDoubleVector2D, mercator);
+
+    const QGeoCoordinate expected = QWebMercator::mercatorToCoord(mercator);
+    QGeoCoordinate result;
+    QWebMercator::mercatorToCoord(&mercator, &result, 1);
+
+    QCOMPARE(result.longitude(), expected.longitude());
+    QVERIFY2(qAbs(result.latitude() - expected.latitude()) <= degreeTolerance,
+             qPrintable(QString::number(result.latitude() - expected.latitude())));
+}
+
+void tst_QWebMercator::mercatorToCoordBatchRandom()
+{
+    qsrand(2);
+    QVector<QDoubleVector2D> mercator(100000);
+    for (QDoubleVector2D &p : mercator)
+        p = QDoubleVector2D(qrand() * 1.0 / RAND_MAX, qrand() * 1.0 / RAND_MAX);
+
+    QVector<QGeoCoordinate> result(mercator.size());
+    QWebMercator::mercatorToCoord(mercator.constData(), result.data(), mercator.size());
+
+    double maxError = 0.0;
+    for (int i = 0; i < mercator.size(); ++i) {
+        const QGeoCoordinate expected = QWebMercator::mercatorToCoord(mercator.at(i));
+        QCOMPARE(result.at(i).longitude(), expected.longitude());
+        maxError = qMax(maxError, qAbs(result.at(i).latitude() - expected.latitude()));
+    }
+    QVERIFY2(maxError <= degreeTolerance, qPrintable(QString::number(maxError)));
+}
+
+void tst_QWebMercator::batchIndependentOfCount()
+{
+    // Points converted in pairs and the odd one at the end must agree
+    const QGeoCoordinate coordinates[] = { QGeoCoordinate(48.8566, 2.3522), QGeoCoordinate(-22.9068, -43.1729),
+                                           QGeoCoordinate(35.6762, 139.6503) };
+    QDoubleVector2D all[3];
+    QWebMercator::coordToMercator(coordinates, all, 3);
+    for (int i = 0; i < 3; ++i) {
+        QDoubleVector2D single;
+        QWebMercator::coordToMercator(coordinates + i, &single, 1);
+        QCOMPARE(single.x(), all[i].x());
+        QCOMPARE(single.y(), all[i].y());
+    }
+
+    QGeoCoordinate back[3];
+    QWebMercator::mercatorToCoord(all, back, 3);
+    for (int i = 0; i < 3; ++i) {
+        QGeoCoordinate single;
+        QWebMercator::mercatorToCoord(all + i, &single, 1);
+        QCOMPARE(single.latitude(), back[i].latitude());
+        QCOMPARE(single.longitude(), back[i].longitude());
+        QVERIFY(qAbs(back[i].latitude() - coordinates[i].latitude()) < 1e-9);
+    }
+}
+
+void tst_QWebMercator::itemPositionBatch_data()
+{
+    QTest::addColumn<qreal>("tilt");
+    QTest::addColumn<qreal>("bearing");
+
+    QTest::newRow("flat") << qreal(0.0) << qreal(0.0);
+    QTest::newRow("rotated") << qreal(0.0) << qreal(30.0);
+    QTest::newRow("tilted") << qreal(45.0) << qreal(0.0);
+    QTest::newRow("tilted and rotated") << qreal(60.0) << qreal(210.0);
+}
+
+void tst_QWebMercator::itemPositionBatch()
+{
+    QFETCH(qreal, tilt);
+    QFETCH(qreal, bearing);
+
+    QGeoProjectionWebMercator projection;
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(52.52, 13.405));
+    camera.setZoomLevel(22);
+    camera.setTilt(tilt);
+    camera.setBearing(bearing);
+    projection.setViewportSize(QSize(1024, 768));
+    projection.setCameraData(camera);
+
+    QVector<QDoubleVector2D> wrapped;
+    for (int i = 0; i < 101; ++i) {
+        const QGeoCoordinate c = camera.center().atDistanceAndAzimuth(i * 0.5, i * 7.0);
+        wrapped << projection.geoToWrappedMapProjection(c);
+    }
+
+    QVector<QDoubleVector2D> positions(wrapped.size());
+    projection.wrappedMapProjectionToItemPosition(wrapped.constData(), positions.data(), wrapped.size());
+    for (int i = 0; i < wrapped.size(); ++i) {
+        const QDoubleVector2D expected = projection.wrappedMapProjectionToItemPosition(wrapped.at(i));
+        QVERIFY(qAbs(positions.at(i).x() - expected.x()) < 1e-6);
+        QVERIFY(qAbs(positions.at(i).y() - expected.y()) < 1e-6);
+    }
+}
+
+void tst_QWebMercator::worldPointItemPositions_data()
+{
+    itemPositionBatch_data();
+}
+
+void tst_QWebMercator::worldPointItemPositions()
+{
+    QFETCH(qreal, tilt);
+    QFETCH(qreal, bearing);
+
+    QGeoProjectionWebMercator projection;
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(52.52, 13.405));
+    camera.setZoomLevel(22);
+    camera.setTilt(tilt);
+    camera.setBearing(bearing);
+    projection.setViewportSize(QSize(1024, 768));
+    projection.setCameraData(camera);
+
+    // Points a centimeter apart, less than half a pixel at this zoom level
+    QVector<QGeoCoordinate> coordinates;
+    for (int i = 0; i < 101; ++i)
+        coordinates << camera.center().atDistanceAndAzimuth(i * 0.01, 60.0);
+    QVector<QDoubleVector2D> mercator(coordinates.size());
+    projection.geoToMapProjection(coordinates.constData(), mercator.data(), coordinates.size());
+    QVector<QWorldPoint> world;
+    QWorldPoint::fromMercator(mercator, &world);
+
+    QVector<QWorldPoint> wrapped(world.size());
+    projection.wrapMapProjection(world.constData(), wrapped.data(), world.size());
+    QVector<QDoubleVector2D> positions(wrapped.size());
+    projection.wrappedMapProjectionToItemPosition(wrapped.constData(), positions.data(), wrapped.size());
+
+    QVector<QDoubleVector2D> expected(coordinates.size());
+    for (int i = 0; i < coordinates.size(); ++i) {
+        expected[i] = projection.coordinateToItemPosition(coordinates.at(i), false);
+        QVERIFY2(qAbs(positions.at(i).x() - expected.at(i).x()) < 1e-3
+                 && qAbs(positions.at(i).y() - expected.at(i).y()) < 1e-3,
+                 qPrintable(QString::number(i)));
+    }
+
+    // Neighbouring points are told apart as precisely as in floating point
+    for (int i = 1; i < coordinates.size(); ++i) {
+        const QDoubleVector2D step = positions.at(i) - positions.at(i - 1);
+        const QDoubleVector2D expectedStep = expected.at(i) - expected.at(i - 1);
+        QVERIFY(step.manhattanLength() > 0.1);
+        QVERIFY(qAbs(step.x() - expectedStep.x()) < 1e-4);
+        QVERIFY(qAbs(step.y() - expectedStep.y()) < 1e-4);
+    }
+}
+
+void tst_QWebMercator::worldPointWrap()
+{
+    QGeoProjectionWebMercator projection;
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(0.0, 179.9999));
+    camera.setZoomLevel(22);
+    projection.setViewportSize(QSize(1024, 768));
+    projection.setCameraData(camera);
+
+    // Across the date line, the point wraps to the east of the camera as in floating point
+    const QGeoCoordinate east(0.0, -179.9999);
+    const QDoubleVector2D wrapped = projection.geoToWrappedMapProjection(east);
+    QVERIFY(wrapped.x() > 1.0);
+
+    const QWorldPoint world[2] = { QWorldPoint::fromMercator(projection.geoToMapProjection(east)),
+                                   QWorldPoint::invalid() };
+    QWorldPoint wrappedWorld[2];
+    projection.wrapMapProjection(world, wrappedWorld, 2);
+    const QWorldPoint expectedWorld = QWorldPoint::fromMercator(wrapped);
+    QVERIFY(qAbs(wrappedWorld[0].x() - expectedWorld.x()) <= 1);
+    QCOMPARE(wrappedWorld[0].y(), expectedWorld.y());
+    QVERIFY(!wrappedWorld[1].isValid());
+
+    QDoubleVector2D position;
+    projection.wrappedMapProjectionToItemPosition(wrappedWorld, &position, 1);
+    const QDoubleVector2D expected = projection.coordinateToItemPosition(east, false);
+    QVERIFY(qAbs(position.x() - expected.x()) < 1e-3);
+    QVERIFY(qAbs(position.y() - expected.y()) < 1e-3);
+}
+
+QTEST_APPLESS_MAIN(tst_QWebMercator)
+
+#include "tst_qwebmercator.moc"
@@ -0,0 +1,22 @@
+TEMPLATE = subdirs
+
+QT_FOR_CONFIG += location-private
+
+qtHaveModule(location) {
+    SUBDIRS += geometryclipping \
+               mercatorprojection \
+               osrmparsing \
+               routeprogress \
+               tilecacheburst \
+               tilerequests
+
+    qtConfig(geoservices_offline): SUBDIRS += offlinerouting
+}
+
+qtHaveModule(location):qtHaveModule(quick) {
+    SUBDIRS += mapitemgeometry
+
+    qtConfig(geoservices_mapboxgl):exists(../../src/3rdparty/mapbox-gl-native/mapbox-gl-native.pro) {
+        SUBDIRS += mapboxglstylechanges
+    }
+}
@@ -0,0 +1,11 @@
+TARGET = tst_bench_geometryclipping
+
+INCLUDEPATH += ../../../src/3rdparty/clipper \
+               ../../../src/3rdparty/clip2tri
+
+SOURCES += tst_bench_geometryclipping.cpp
+
+QT += location-private positioning-private testlib
+
+load(qt_build_paths)
+LIBS_PRIVATE += -L$$MODULE_BASE_OUTDIR/lib -lclip2tri$$qtPlatformTargetSuffix()
@@ -0,0 +1,238 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtPositioning/private/qclipperutils_p.h>
+#include <QtTest/QtTest>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/* Counts every heap allocation of the process, the stages report the difference. */
+static std::atomic<qint64> allocationCount(0);
+
+void *operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) Q_DECL_NOTHROW
+{
+    std::free(p);
+}
+
+QT_USE_NAMESPACE
+
+class tst_bench_GeometryClipping : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Stage { Wrap, ToClipper, Clip, FromClipper };
+
+private slots:
+    void initTestCase();
+
+    void allocationsPerStage_data();
+    void allocationsPerStage();
+    void stageTime_data();
+    void stageTime();
+
+private:
+    /* Keeps the output of each stage across runs, like the map item geometries do. */
+    template <typename Points>
+    struct Pipeline
+    {
+        Points wrapped;
+        Path subject;
+        Paths clipped;
+        QList<Points> listResult;
+        QVector<Points> vectorResult;
+    };
+    typedef Pipeline<QList<QDoubleVector2D> > ListPipeline;
+    typedef Pipeline<QVector<QDoubleVector2D> > VectorPipeline;
+
+    void prepare(int pointCount);
+    void runStage(Stage stage, ListPipeline &p);
+    void runStage(Stage stage, VectorPipeline &p);
+    void clip(const Path &subject, Paths &clipped);
+
+    QGeoProjectionWebMercator m_projection;
+    QVector<QDoubleVector2D> m_path;
+    ListPipeline m_list;
+    VectorPipeline m_vector;
+};
+
+Q_DECLARE_METATYPE(QT_PREPEND_NAMESPACE(tst_bench_GeometryClipping)::Stage)
+
+void tst_bench_GeometryClipping::initTestCase()
+{
+    /* A tilted camera, so that the projectable region is not the whole map. */
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(52.52, 13.405));
+    camera.setZoomLevel(4);
+    camera.setTilt(60);
+    m_projection.setViewportSize(QSize(1024, 768));
+    m_projection.setCameraData(camera);
+    QVERIFY(m_projection.projectableRegion().size() > 2);
+}
+
+void tst_bench_GeometryClipping::allocationsPerStage_data()
+{
+    QTest::addColumn<Stage>("stage");
+    QTest::addColumn<bool>("contiguous");
+    QTest::addColumn<int>("pointCount");
+
+    static const struct { Stage stage; const char *name; } stages[] = {
+        { Wrap, "wrap" }, { ToClipper, "to clipper" }, { Clip, "clip" }, { FromClipper, "from clipper" }
+    };
+    for (const auto &s : stages) {
+        for (int pointCount : { 1000, 10000 }) {
+            QTest::newRow(QByteArray(s.name) + ", QList, " + QByteArray::number(pointCount))
+                    << s.stage << false << pointCount;
+            QTest::newRow(QByteArray(s.name) + ", QVector, " + QByteArray::number(pointCount))
+                    << s.stage << true << pointCount;
+        }
+    }
+}
+
+/* A zigzag line crossing the whole world, partly outside of the tilted view. Runs
+   every stage once so that the buffers have been used for a frame. */
+void tst_bench_GeometryClipping::prepare(int pointCount)
+{
+    m_path.clear();
+    m_path.reserve(pointCount);
+    for (int i = 0; i < pointCount; ++i)
+        m_path.append(QDoubleVector2D(double(i) / pointCount, (i % 2) ? 0.3 : 0.4));
+
+    m_list = ListPipeline();
+    m_vector = VectorPipeline();
+    for (Stage s : { Wrap, ToClipper, Clip, FromClipper }) {
+        runStage(s, m_list);
+        runStage(s, m_vector);
+    }
+}
+
+void tst_bench_GeometryClipping::clip(const Path &subject, Paths &clipped)
+{
+    c2t::clip2tri clipper;
+    clipper.addSubjectPath(subject, false);
+    clipper.addClipPolygon(QClipperUtils::qVectorToPath(m_projection.projectableRegion()));
+    clipped = clipper.execute(c2t::clip2tri::Intersection);
+}
+
+void tst_bench_GeometryClipping::runStage(Stage stage, ListPipeline &p)
+{
+    switch (stage) {
+    case Wrap:
+        p.wrapped.clear();
+        for (const QDoubleVector2D &point : qAsConst(m_path))
+            p.wrapped.append(m_projection.wrapMapProjection(point));
+        break;
+    case ToClipper:
+        p.subject = QClipperUtils::qListToPath(p.wrapped);
+        break;
+    case Clip:
+        clip(p.subject, p.clipped);
+        break;
+    case FromClipper:
+        p.listResult = QClipperUtils::pathsToQList(p.clipped);
+        break;
+    }
+}
+
+void tst_bench_GeometryClipping::runStage(Stage stage, VectorPipeline &p)
+{
+    switch (stage) {
+    case Wrap:
+        p.wrapped.reserve(m_path.size());
+        p.wrapped.resize(0);
+        for (const QDoubleVector2D &point : qAsConst(m_path))
+            p.wrapped.append(m_projection.wrapMapProjection(point));
+        break;
+    case ToClipper:
+        QClipperUtils::qVectorToPath(p.wrapped, &p.subject);
+        break;
+    case Clip:
+        clip(p.subject, p.clipped);
+        break;
+    case FromClipper:
+        QClipperUtils::pathsToQVector(p.clipped, &p.vectorResult);
+        break;
+    }
+}
+
+/* Reports the heap allocations of one stage in steady state. */
+void tst_bench_GeometryClipping::allocationsPerStage()
+{
+    QFETCH(Stage, stage);
+    QFETCH(bool, contiguous);
+    QFETCH(int, pointCount);
+
+    prepare(pointCount);
+
+    const qint64 before = allocationCount;
+    if (contiguous)
+        runStage(stage, m_vector);
+    else
+        runStage(stage, m_list);
+    QTest::setBenchmarkResult(allocationCount - before, QTest::Events);
+}
+
+void tst_bench_GeometryClipping::stageTime_data()
+{
+    allocationsPerStage_data();
+}
+
+void tst_bench_GeometryClipping::stageTime()
+{
+    QFETCH(Stage, stage);
+    QFETCH(bool, contiguous);
+    QFETCH(int, pointCount);
+
+    prepare(pointCount);
+
+    if (contiguous) {
+        QBENCHMARK {
+            runStage(stage, m_vector);
+        }
+    } else {
+        QBENCHMARK {
+            runStage(stage, m_list);
+        }
+    }
+}
+
+QTEST_MAIN(tst_bench_GeometryClipping)
+
+#include "tst_bench_geometryclipping.moc"
@@ -0,0 +1,14 @@
+TARGET = tst_bench_mapboxglstylechanges
+
+INCLUDEPATH += ../../../src/plugins/geoservices/mapboxgl \
+               ../../../src/3rdparty/mapbox-gl-native/platform/qt/include
+
+HEADERS += ../../../src/plugins/geoservices/mapboxgl/qmapboxglstylechange_p.h
+
+SOURCES += tst_bench_mapboxglstylechanges.cpp \
+           ../../../src/plugins/geoservices/mapboxgl/qmapboxglstylechange.cpp
+
+QT += location-private positioning-private quick-private testlib
+
+load(qt_build_paths)
+LIBS_PRIVATE += -L$$MODULE_BASE_OUTDIR/lib -lqmapboxgl$$qtPlatformTargetSuffix()
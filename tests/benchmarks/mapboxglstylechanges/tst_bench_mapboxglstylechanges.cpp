@@ -0,0 +1,189 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include "qmapboxglstylechange_p.h"
+
+#include <QtLocation/private/qdeclarativerectanglemapitem_p.h>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+class tst_bench_MapboxGLStyleChanges : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanup();
+
+    void styleChangesPerFrame_data();
+    void styleChangesPerFrame();
+    void frameTime_data();
+    void frameTime();
+
+private:
+    void createItems(int count);
+    void moveItems(int count);
+
+    QList<QDeclarativeRectangleMapItem *> m_items;
+    int m_frame = 0;
+};
+
+void tst_bench_MapboxGLStyleChanges::cleanup()
+{
+    qDeleteAll(m_items);
+    m_items.clear();
+    m_frame = 0;
+}
+
+void tst_bench_MapboxGLStyleChanges::createItems(int count)
+{
+    for (int i = 0; i < count; ++i) {
+        auto rect = new QDeclarativeRectangleMapItem;
+        const double lat = -60.0 + (i % 120);
+        const double lon = -170.0 + (i / 120) % 340;
+        rect->setTopLeft(QGeoCoordinate(lat + 0.5, lon));
+        rect->setBottomRight(QGeoCoordinate(lat, lon + 0.5));
+        rect->setColor(QColor::fromHsv(i % 360, 200, 200, 128));
+        m_items << rect;
+    }
+}
+
+// Moves the first count items, simulating the animated items of one frame.
+void tst_bench_MapboxGLStyleChanges::moveItems(int count)
+{
+    const double offset = (++m_frame % 2) ? 0.01 : -0.01;
+    for (int i = 0; i < count && i < m_items.size(); ++i) {
+        QDeclarativeRectangleMapItem *rect = m_items.at(i);
+        rect->setTopLeft(QGeoCoordinate(rect->topLeft().latitude() + offset, rect->topLeft().longitude()));
+    }
+}
+
+void tst_bench_MapboxGLStyleChanges::styleChangesPerFrame_data()
+{
+    QTest::addColumn<bool>("batched");
+    QTest::addColumn<int>("itemCount");
+    QTest::addColumn<int>("movedCount");
+
+    QTest::newRow("separate, 5000 items, 0 moved") << false << 5000 << 0;
+    QTest::newRow("batched, 5000 items, 0 moved") << true << 5000 << 0;
+    QTest::newRow("separate, 5000 items, 50 moved") << false << 5000 << 50;
+    QTest::newRow("batched, 5000 items, 50 moved") << true << 5000 << 50;
+}
+
+// Reports the number of style changes handed to QMapboxGL for the first
+// frame (all the items added) and, when items move, for the next frame.
+void tst_bench_MapboxGLStyleChanges::styleChangesPerFrame()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, itemCount);
+    QFETCH(int, movedCount);
+
+    createItems(itemCount);
+
+    QMapboxGLMapItemBatcher batcher;
+    QList<QSharedPointer<QMapboxGLStyleChange>> changes;
+
+    for (QDeclarativeRectangleMapItem *item : qAsConst(m_items)) {
+        if (batched)
+            batcher.addMapItem(item);
+        else
+            changes << QMapboxGLStyleChange::addMapItem(item, QString());
+    }
+    if (batched)
+        changes = batcher.takeStyleChanges();
+
+    if (movedCount) {
+        changes.clear();
+        moveItems(movedCount);
+        for (int i = 0; i < movedCount; ++i) {
+            if (batched)
+                batcher.updateMapItemGeometry(m_items.at(i));
+            else
+                changes << QMapboxGLStyleAddSource::fromMapItem(m_items.at(i));
+        }
+        if (batched)
+            changes = batcher.takeStyleChanges();
+    }
+
+    QTest::setBenchmarkResult(changes.size(), QTest::Events);
+}
+
+void tst_bench_MapboxGLStyleChanges::frameTime_data()
+{
+    styleChangesPerFrame_data();
+}
+
+// Measures the CPU time spent generating the style changes of one frame.
+void tst_bench_MapboxGLStyleChanges::frameTime()
+{
+    QFETCH(bool, batched);
+    QFETCH(int, itemCount);
+    QFETCH(int, movedCount);
+
+    createItems(itemCount);
+
+    if (!movedCount) {
+        QBENCHMARK {
+            QMapboxGLMapItemBatcher batcher;
+            QList<QSharedPointer<QMapboxGLStyleChange>> changes;
+            for (QDeclarativeRectangleMapItem *item : qAsConst(m_items)) {
+                if (batched)
+                    batcher.addMapItem(item);
+                else
+                    changes << QMapboxGLStyleChange::addMapItem(item, QString());
+            }
+            if (batched)
+                changes = batcher.takeStyleChanges();
+        }
+        return;
+    }
+
+    QMapboxGLMapItemBatcher batcher;
+    if (batched) {
+        for (QDeclarativeRectangleMapItem *item : qAsConst(m_items))
+            batcher.addMapItem(item);
+        batcher.takeStyleChanges();
+    }
+
+    QBENCHMARK {
+        QList<QSharedPointer<QMapboxGLStyleChange>> changes;
+        moveItems(movedCount);
+        for (int i = 0; i < movedCount; ++i) {
+            if (batched)
+                batcher.updateMapItemGeometry(m_items.at(i));
+            else
+                changes << QMapboxGLStyleAddSource::fromMapItem(m_items.at(i));
+        }
+        if (batched)
+            changes = batcher.takeStyleChanges();
+    }
+}
+
+QTEST_MAIN(tst_bench_MapboxGLStyleChanges)
+
+#include "tst_bench_mapboxglstylechanges.moc"
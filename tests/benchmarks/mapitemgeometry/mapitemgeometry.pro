@@ -0,0 +1,5 @@
+TARGET = tst_bench_mapitemgeometry
+
+SOURCES += tst_bench_mapitemgeometry.cpp
+
+QT += location-private positioning-private quick-private testlib
@@ -0,0 +1,157 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/private/qdeclarativepolygonmapitem_p.h>
+#include <QtLocation/private/qgeomapitemgeometrybuilder_p.h>
+#include <QtTest/QtTest>
+
+#include <cmath>
+
+QT_USE_NAMESPACE
+
+/* Exposes build() so that the same work can be timed on the calling thread */
+class PolygonTask : public QGeoMapPolygonGeometryTask
+{
+public:
+    using QGeoMapPolygonGeometryTask::QGeoMapPolygonGeometryTask;
+    void buildHere() { build(); }
+};
+
+class tst_bench_MapItemGeometry : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void guiThreadTime_data();
+    void guiThreadTime();
+    void completionTime_data();
+    void completionTime();
+
+private:
+    QVector<QSharedPointer<PolygonTask> > createTasks(int polygonCount, double tilt);
+    qint64 runFrame(bool asynchronous, int polygonCount, double tilt, qint64 *completion);
+};
+
+/* Star shaped polygons of 64 vertices, spread over the visible area */
+QVector<QSharedPointer<PolygonTask> > tst_bench_MapItemGeometry::createTasks(int polygonCount, double tilt)
+{
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(48.0, 11.0));
+    camera.setZoomLevel(6);
+    camera.setTilt(tilt);
+    QSharedPointer<QGeoMapSnapshot> snapshot(new QGeoMapSnapshot(camera, QSize(1024, 768)));
+
+    QVector<QSharedPointer<PolygonTask> > tasks;
+    tasks.reserve(polygonCount);
+    for (int i = 0; i < polygonCount; ++i) {
+        const QGeoCoordinate center(43.0 + (i % 100) * 0.1, 4.0 + (i / 100) % 140 * 0.1);
+        QVector<QWorldPoint> path;
+        QGeoCoordinate leftBound(center.latitude(), 180.0);
+        for (int v = 0; v < 64; ++v) {
+            const double angle = 2 * M_PI * v / 64;
+            const double radius = (v % 2) ? 0.05 : 0.02;
+            const QGeoCoordinate c(center.latitude() + radius * std::sin(angle),
+                                   center.longitude() + radius * std::cos(angle));
+            if (c.longitude() < leftBound.longitude())
+                leftBound = QGeoCoordinate(center.latitude() + 0.05, c.longitude());
+            path << QWorldPoint::fromMercator(snapshot->geoProjection().geoToMapProjection(c));
+        }
+        tasks << QSharedPointer<PolygonTask>(new PolygonTask(snapshot, path, leftBound, 1.0));
+    }
+    return tasks;
+}
+
+/* Returns the time the GUI thread spent on the frame, and in completion the
+   time until all the geometry was built */
+qint64 tst_bench_MapItemGeometry::runFrame(bool asynchronous, int polygonCount, double tilt, qint64 *completion)
+{
+    const QVector<QSharedPointer<PolygonTask> > tasks = createTasks(polygonCount, tilt);
+    QGeoMapItemGeometryBuilder *builder = QGeoMapItemGeometryBuilder::instance();
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QSharedPointer<PolygonTask> &task : tasks) {
+        if (asynchronous)
+            builder->start(task);
+        else
+            task->buildHere();
+    }
+    const qint64 guiThread = timer.elapsed();
+    builder->waitForDone();
+    *completion = timer.elapsed();
+    return guiThread;
+}
+
+void tst_bench_MapItemGeometry::guiThreadTime_data()
+{
+    QTest::addColumn<bool>("asynchronous");
+    QTest::addColumn<int>("polygonCount");
+    QTest::addColumn<double>("tilt");
+
+    for (int polygonCount : { 1000, 5000 }) {
+        for (double tilt : { 0.0, 45.0 }) {
+            const QByteArray suffix = ", " + QByteArray::number(polygonCount) + " polygons, tilt "
+                    + QByteArray::number(tilt);
+            QTest::newRow("synchronous" + suffix) << false << polygonCount << tilt;
+            QTest::newRow("asynchronous" + suffix) << true << polygonCount << tilt;
+        }
+    }
+}
+
+/* How long the GUI thread is blocked by the polish of all the polygons */
+void tst_bench_MapItemGeometry::guiThreadTime()
+{
+    QFETCH(bool, asynchronous);
+    QFETCH(int, polygonCount);
+    QFETCH(double, tilt);
+
+    qint64 completion = 0;
+    QTest::setBenchmarkResult(runFrame(asynchronous, polygonCount, tilt, &completion),
+                              QTest::WalltimeMilliseconds);
+}
+
+void tst_bench_MapItemGeometry::completionTime_data()
+{
+    guiThreadTime_data();
+}
+
+/* How long until all the polygons can be drawn */
+void tst_bench_MapItemGeometry::completionTime()
+{
+    QFETCH(bool, asynchronous);
+    QFETCH(int, polygonCount);
+    QFETCH(double, tilt);
+
+    qint64 completion = 0;
+    runFrame(asynchronous, polygonCount, tilt, &completion);
+    QTest::setBenchmarkResult(completion, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_bench_MapItemGeometry)
+
+#include "tst_bench_mapitemgeometry.moc"
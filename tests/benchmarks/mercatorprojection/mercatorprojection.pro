@@ -0,0 +1,5 @@
+TARGET = tst_bench_mercatorprojection
+
+SOURCES += tst_bench_mercatorprojection.cpp
+
+QT += location-private positioning-private testlib
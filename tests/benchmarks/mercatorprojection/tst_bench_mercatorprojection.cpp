@@ -0,0 +1,156 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/private/qgeocameradata_p.h>
+#include <QtLocation/private/qgeoprojection_p.h>
+#include <QtPositioning/private/qwebmercator_p.h>
+#include <QtPositioning/private/qdoublevector2d_p.h>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+class tst_bench_MercatorProjection : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Conversion { ToMercator, ToCoordinate, ToItemPosition };
+
+private slots:
+    void initTestCase();
+
+    void throughput_data();
+    void throughput();
+
+private:
+    void convert(Conversion conversion, bool batch);
+
+    QGeoProjectionWebMercator m_projection;
+    QVector<QGeoCoordinate> m_coordinates;
+    QVector<QDoubleVector2D> m_mercator;
+    QVector<QDoubleVector2D> m_positions;
+};
+
+Q_DECLARE_METATYPE(QT_PREPEND_NAMESPACE(tst_bench_MercatorProjection)::Conversion)
+
+void tst_bench_MercatorProjection::initTestCase()
+{
+    /* A tilted and rotated camera, so that the item positions need the full matrix. */
+    QGeoCameraData camera;
+    camera.setCenter(QGeoCoordinate(52.52, 13.405));
+    camera.setZoomLevel(12);
+    camera.setTilt(45);
+    camera.setBearing(30);
+    m_projection.setViewportSize(QSize(1024, 768));
+    m_projection.setCameraData(camera);
+}
+
+void tst_bench_MercatorProjection::throughput_data()
+{
+    QTest::addColumn<Conversion>("conversion");
+    QTest::addColumn<bool>("batch");
+    QTest::addColumn<int>("pointCount");
+
+    const struct { Conversion conversion; const char *name; } conversions[] = {
+        { ToMercator, "toMercator" },
+        { ToCoordinate, "toCoordinate" },
+        { ToItemPosition, "toItemPosition" }
+    };
+    for (const auto &c : conversions) {
+        for (int pointCount : { 64, 4096, 262144 }) {
+            QTest::addRow("%s single %d", c.name, pointCount) << c.conversion << false << pointCount;
+            QTest::addRow("%s batch %d", c.name, pointCount) << c.conversion << true << pointCount;
+        }
+    }
+}
+
+/* Reported as events: points converted per second. */
+void tst_bench_MercatorProjection::throughput()
+{
+    QFETCH(Conversion, conversion);
+    QFETCH(bool, batch);
+    QFETCH(int, pointCount);
+
+    /* A random walk around the camera center, like a long track. */
+    qsrand(pointCount);
+    m_coordinates.resize(pointCount);
+    QGeoCoordinate c(52.52, 13.405);
+    for (int i = 0; i < pointCount; ++i) {
+        c = c.atDistanceAndAzimuth(qrand() % 100, qrand() % 360);
+        m_coordinates[i] = c;
+    }
+    m_mercator.resize(pointCount);
+    m_projection.geoToMapProjection(m_coordinates.constData(), m_mercator.data(), pointCount);
+    for (QDoubleVector2D &p : m_mercator)
+        p = m_projection.wrapMapProjection(p);
+    m_positions.resize(pointCount);
+
+    qint64 points = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        convert(conversion, batch);
+        points += pointCount;
+    } while (timer.elapsed() < 200);
+    QTest::setBenchmarkResult(points * 1e9 / timer.nsecsElapsed(), QTest::Events);
+}
+
+void tst_bench_MercatorProjection::convert(Conversion conversion, bool batch)
+{
+    const int count = m_coordinates.size();
+    switch (conversion) {
+    case ToMercator:
+        if (batch) {
+            m_projection.geoToMapProjection(m_coordinates.constData(), m_positions.data(), count);
+        } else {
+            for (int i = 0; i < count; ++i)
+                m_positions[i] = m_projection.geoToMapProjection(m_coordinates.at(i));
+        }
+        break;
+    case ToCoordinate:
+        if (batch) {
+            QWebMercator::mercatorToCoord(m_mercator.constData(), m_coordinates.data(), count);
+        } else {
+            for (int i = 0; i < count; ++i)
+                m_coordinates[i] = QWebMercator::mercatorToCoord(m_mercator.at(i));
+        }
+        break;
+    case ToItemPosition:
+        if (batch) {
+            m_projection.wrappedMapProjectionToItemPosition(m_mercator.constData(), m_positions.data(), count);
+        } else {
+            for (int i = 0; i < count; ++i)
+                m_positions[i] = m_projection.wrappedMapProjectionToItemPosition(m_mercator.at(i));
+        }
+        break;
+    }
+}
+
+QTEST_MAIN(tst_bench_MercatorProjection)
+
+#include "tst_bench_mercatorprojection.moc"
@@ -0,0 +1,14 @@
+TARGET = tst_bench_offlinerouting
+
+INCLUDEPATH += ../../../src/plugins/geoservices/offline
+
+HEADERS += ../../../src/plugins/geoservices/offline/qgeoroutinggraphoffline.h \
+           ../../../src/plugins/geoservices/offline/qgeoroutinggraphbuilderoffline.h \
+           ../../../src/plugins/geoservices/offline/qgeoroutereplyoffline.h
+
+SOURCES += tst_bench_offlinerouting.cpp \
+           ../../../src/plugins/geoservices/offline/qgeoroutinggraphoffline.cpp \
+           ../../../src/plugins/geoservices/offline/qgeoroutinggraphbuilderoffline.cpp \
+           ../../../src/plugins/geoservices/offline/qgeoroutereplyoffline.cpp
+
+QT += location-private positioning-private concurrent testlib
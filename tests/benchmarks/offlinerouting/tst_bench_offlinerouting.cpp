@@ -0,0 +1,185 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <qgeoroutinggraphbuilderoffline.h>
+#include <qgeoroutinggraphoffline.h>
+#include <qgeoroutereplyoffline.h>
+
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QTemporaryDir>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+using namespace QGeoRoutingGraphFormat;
+
+class tst_bench_OfflineRouting : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Query {
+        ContractedQuery,
+        ExcludedAreaQuery,
+        ShortestQuery,
+        RouteReplyQuery
+    };
+
+private slots:
+    void initTestCase();
+    void queriesPerSecond_data();
+    void queriesPerSecond();
+
+private:
+    bool run(Query query, const QPair<quint32, quint32> &pair) const;
+
+    QTemporaryDir m_dir;
+    QSharedPointer<QGeoRoutingGraphOffline> m_graph;
+    QVector<QPair<quint32, quint32> > m_pairs;
+    QList<QGeoRectangle> m_excludeAreas;
+};
+
+Q_DECLARE_METATYPE(tst_bench_OfflineRouting::Query)
+
+/*
+    A city sized street grid of 250 x 250 intersections, about 25 km across,
+    with arterial roads every tenth street and one way streets in between.
+*/
+void tst_bench_OfflineRouting::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    const int size = 250;
+    const double spacing = 0.001;
+    QGeoRoutingGraphBuilderOffline builder;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x)
+            builder.addNode(48.0 + y * spacing, 11.0 + x * spacing * 1.5);
+    }
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const quint32 node = quint32(y * size + x);
+            if (x + 1 < size) {
+                const int roadClass = y % 10 == 0 ? Primary : Residential;
+                const quint32 name = builder.addName(QStringLiteral("Street %1").arg(y));
+                builder.addArc(node, node + 1, roadClass, defaultAccess(roadClass), name);
+                if (roadClass == Primary || y % 2 == 0)
+                    builder.addArc(node + 1, node, roadClass, defaultAccess(roadClass), name);
+                else
+                    builder.addArc(node + 1, node, roadClass, FootAccess | BicycleAccess, name);
+            }
+            if (y + 1 < size) {
+                const int roadClass = x % 10 == 0 ? Secondary : Residential;
+                const quint32 name = builder.addName(QStringLiteral("Avenue %1").arg(x));
+                builder.addArc(node, node + size, roadClass, defaultAccess(roadClass), name);
+                builder.addArc(node + size, node, roadClass, defaultAccess(roadClass), name);
+            }
+        }
+    }
+    const QString fileName = m_dir.filePath(QStringLiteral("grid.graph"));
+    QString errorString;
+    QVERIFY2(builder.write(fileName, &errorString), qPrintable(errorString));
+
+    m_graph.reset(new QGeoRoutingGraphOffline);
+    QVERIFY2(m_graph->load(fileName), qPrintable(m_graph->errorString()));
+
+    qsrand(42);
+    for (int i = 0; i < 1000; ++i)
+        m_pairs.append(qMakePair(quint32(qrand()) % m_graph->nodeCount(), quint32(qrand()) % m_graph->nodeCount()));
+
+    // A closed district of about 4 km in the middle of the grid.
+    const QGeoCoordinate center(48.0 + size * spacing / 2, 11.0 + size * spacing * 0.75);
+    m_excludeAreas << QGeoRectangle(center, 0.054, 0.036);
+}
+
+bool tst_bench_OfflineRouting::run(Query query, const QPair<quint32, quint32> &pair) const
+{
+    QGeoRoutingGraphOffline::Path path;
+    switch (query) {
+    case ContractedQuery:
+        return m_graph->contractedPath(pair.first, pair.second, CarProfile, &path);
+    case ExcludedAreaQuery:
+        if (m_graph->contractedPath(pair.first, pair.second, CarProfile, &path)
+                && !m_graph->crossesAreas(path, m_excludeAreas)) {
+            return true;
+        }
+        return m_graph->searchPath(pair.first, pair.second, CarProfile,
+                                   QGeoRoutingGraphOffline::TimeMetric, m_excludeAreas, &path);
+    case ShortestQuery:
+        return m_graph->searchPath(pair.first, pair.second, CarProfile,
+                                   QGeoRoutingGraphOffline::DistanceMetric,
+                                   QList<QGeoRectangle>(), &path);
+    case RouteReplyQuery: {
+        const QGeoRouteRequest request(m_graph->coordinate(pair.first), m_graph->coordinate(pair.second));
+        return QGeoRouteReplyOffline::calculateRoutes(m_graph, request).error == QGeoRouteReply::NoError;
+    }
+    }
+    return false;
+}
+
+void tst_bench_OfflineRouting::queriesPerSecond_data()
+{
+    QTest::addColumn<Query>("query");
+    QTest::addColumn<int>("queryCount");
+    QTest::addColumn<bool>("concurrent");
+
+    QTest::newRow("contracted hierarchy") << ContractedQuery << 1000 << false;
+    QTest::newRow("contracted hierarchy, thread pool") << ContractedQuery << 1000 << true;
+    QTest::newRow("excluded area") << ExcludedAreaQuery << 200 << false;
+    QTest::newRow("shortest distance") << ShortestQuery << 100 << false;
+    QTest::newRow("route reply") << RouteReplyQuery << 200 << false;
+    QTest::newRow("route reply, thread pool") << RouteReplyQuery << 200 << true;
+}
+
+void tst_bench_OfflineRouting::queriesPerSecond()
+{
+    QFETCH(Query, query);
+    QFETCH(int, queryCount);
+    QFETCH(bool, concurrent);
+
+    // Queries per second, as replies are computed on the global thread pool.
+    QVector<QPair<quint32, quint32> > pairs = m_pairs.mid(0, queryCount);
+    QElapsedTimer timer;
+    timer.start();
+    if (concurrent) {
+        QtConcurrent::blockingMap(pairs, [this, query](const QPair<quint32, quint32> &pair) {
+            run(query, pair);
+        });
+    } else {
+        for (const QPair<quint32, quint32> &pair : qAsConst(pairs))
+            run(query, pair);
+    }
+    const qint64 elapsed = qMax<qint64>(1, timer.nsecsElapsed());
+
+    QTest::setBenchmarkResult(qreal(pairs.size()) * 1e9 / elapsed, QTest::Events);
+}
+
+QTEST_MAIN(tst_bench_OfflineRouting)
+
+#include "tst_bench_offlinerouting.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_osrmparsing
+
+SOURCES += tst_bench_osrmparsing.cpp
+
+QT += location-private positioning testlib
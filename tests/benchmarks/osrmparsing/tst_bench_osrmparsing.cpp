@@ -0,0 +1,164 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/private/qgeorouteparserosrmv5_p.h>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+Q_DECLARE_METATYPE(QGeoRouteParserOsrmV5::GeometryFormat)
+
+class tst_bench_OsrmParsing : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseReply_data();
+    void parseReply();
+
+private:
+    static QByteArray encode(const QList<QGeoCoordinate> &path, QGeoRouteParserOsrmV5::GeometryFormat format);
+    static QByteArray reply(int stepCount, int pointsPerStep, QGeoRouteParserOsrmV5::GeometryFormat format, bool steps);
+};
+
+static void encodeValue(QByteArray &out, int value)
+{
+    quint32 v = value < 0 ? ~(quint32(value) << 1) : quint32(value) << 1;
+    while (v >= 0x20) {
+        out.append(char((0x20 | (v & 0x1f)) + 63));
+        v >>= 5;
+    }
+    out.append(char(v + 63));
+}
+
+QByteArray tst_bench_OsrmParsing::encode(const QList<QGeoCoordinate> &path, QGeoRouteParserOsrmV5::GeometryFormat format)
+{
+    QByteArray out;
+    if (format == QGeoRouteParserOsrmV5::GeoJsonGeometry) {
+        out = "{\"type\":\"LineString\",\"coordinates\":[";
+        for (int i = 0; i < path.size(); ++i) {
+            if (i)
+                out.append(',');
+            out.append('[').append(QByteArray::number(path.at(i).longitude(), 'f', 6)).append(',')
+               .append(QByteArray::number(path.at(i).latitude(), 'f', 6)).append(']');
+        }
+        return out.append("]}");
+    }
+
+    const double scale = format == QGeoRouteParserOsrmV5::Polyline6Geometry ? 1e6 : 1e5;
+    int latitude = 0;
+    int longitude = 0;
+    out.append('"');
+    foreach (const QGeoCoordinate &c, path) {
+        const int lat = qRound(c.latitude() * scale);
+        const int lon = qRound(c.longitude() * scale);
+        encodeValue(out, lat - latitude);
+        encodeValue(out, lon - longitude);
+        latitude = lat;
+        longitude = lon;
+    }
+    return out.append('"');
+}
+
+// A single route along a wiggly line, split into equally long steps.
+// Without steps only the overview geometry of the whole route is sent, as for NoSegmentData requests.
+QByteArray tst_bench_OsrmParsing::reply(int stepCount, int pointsPerStep, QGeoRouteParserOsrmV5::GeometryFormat format, bool steps)
+{
+    QList<QGeoCoordinate> route;
+    for (int i = 0; i < stepCount * pointsPerStep; ++i)
+        route.append(QGeoCoordinate(52.5 + i * 1e-4 + (i % 7) * 3e-6, 13.4 + i * 1.3e-4 - (i % 5) * 4e-6));
+
+    QByteArray out = "{\"code\":\"Ok\",\"waypoints\":[],\"routes\":[{\"distance\":100000,\"duration\":3600,\"weight\":3600,";
+    if (!steps)
+        out.append("\"geometry\":").append(encode(route, format)).append(',');
+    out.append("\"legs\":[{\"distance\":100000,\"duration\":3600,\"summary\":\"\",\"steps\":[");
+    for (int s = 0; steps && s < stepCount; ++s) {
+        const QList<QGeoCoordinate> path = route.mid(s * pointsPerStep, pointsPerStep);
+        const char *type = s == 0 ? "depart" : (s == stepCount - 1 ? "arrive" : "turn");
+        if (s)
+            out.append(',');
+        out.append("{\"distance\":500,\"duration\":18,\"name\":\"Street ").append(QByteArray::number(s))
+           .append("\",\"mode\":\"driving\",\"intersections\":[{\"location\":[13.4,52.5],\"bearings\":[0,90,180],"
+                   "\"entry\":[true,true,false],\"in\":2,\"out\":0}],\"geometry\":")
+           .append(encode(path, format))
+           .append(",\"maneuver\":{\"type\":\"").append(type)
+           .append("\",\"modifier\":\"left\",\"bearing_before\":0,\"bearing_after\":270,\"location\":[")
+           .append(QByteArray::number(path.first().longitude(), 'f', 6)).append(',')
+           .append(QByteArray::number(path.first().latitude(), 'f', 6)).append("]}}");
+    }
+    return out.append("]}]}]}");
+}
+
+void tst_bench_OsrmParsing::parseReply_data()
+{
+    QTest::addColumn<QGeoRouteParserOsrmV5::GeometryFormat>("format");
+    QTest::addColumn<bool>("steps");
+    QTest::addColumn<int>("stepCount");
+
+    static const struct { QGeoRouteParserOsrmV5::GeometryFormat format; const char *name; } formats[] = {
+        { QGeoRouteParserOsrmV5::PolylineGeometry, "polyline" },
+        { QGeoRouteParserOsrmV5::Polyline6Geometry, "polyline6" },
+        { QGeoRouteParserOsrmV5::GeoJsonGeometry, "geojson" }
+    };
+    for (const auto &f : formats) {
+        for (int stepCount : { 20, 200 }) {
+            QTest::addRow("%s, %d steps", f.name, stepCount) << f.format << true << stepCount;
+            QTest::addRow("%s, %d steps, overview only", f.name, stepCount) << f.format << false << stepCount;
+        }
+    }
+}
+
+void tst_bench_OsrmParsing::parseReply()
+{
+    QFETCH(QGeoRouteParserOsrmV5::GeometryFormat, format);
+    QFETCH(bool, steps);
+    QFETCH(int, stepCount);
+
+    const int pointsPerStep = 50;
+    const QByteArray data = reply(stepCount, pointsPerStep, format, steps);
+
+    QGeoRouteParserOsrmV5 parser;
+    parser.setGeometryFormat(format);
+
+    QList<QGeoRoute> routes;
+    QString errorString;
+    QCOMPARE(parser.parseReply(routes, errorString, data), QGeoRouteReply::NoError);
+    QCOMPARE(routes.size(), 1);
+    QCOMPARE(routes.first().path().size(), stepCount * pointsPerStep);
+    QVERIFY(qAbs(routes.first().path().last().latitude() - (52.5 + (stepCount * pointsPerStep - 1) * 1e-4)) < 1e-4);
+
+    QBENCHMARK {
+        routes.clear();
+        parser.parseReply(routes, errorString, data);
+    }
+}
+
+QTEST_MAIN(tst_bench_OsrmParsing)
+
+#include "tst_bench_osrmparsing.moc"
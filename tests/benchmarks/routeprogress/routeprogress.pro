@@ -0,0 +1,8 @@
+TARGET = tst_bench_routeprogress
+
+SOURCES += tst_bench_routeprogress.cpp
+
+# Shares the log recorded for the flickrmobile example
+RESOURCES += routeprogress.qrc
+
+QT += location positioning testlib
@@ -0,0 +1,184 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/QGeoRouteProgressTracker>
+#include <QtLocation/QGeoRoute>
+#include <QtLocation/QGeoRouteSegment>
+#include <QtLocation/QGeoManeuver>
+#include <QtPositioning/QNmeaPositionInfoSource>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+// Exposes the sentence parser, so that the fixes do not depend on timers
+class NmeaReader : public QNmeaPositionInfoSource
+{
+public:
+    NmeaReader() : QNmeaPositionInfoSource(SimulationMode) {}
+
+    bool parse(const QByteArray &sentence, QGeoPositionInfo *info)
+    {
+        bool hasFix = false;
+        return parsePosInfoFromNmeaData(sentence.constData(), sentence.size(), info, &hasFix)
+                && hasFix && info->coordinate().isValid();
+    }
+};
+
+class tst_bench_RouteProgress : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void updatePosition_data();
+    void updatePosition();
+
+private:
+    QGeoRoute route(int subdivisions) const;
+
+    QList<QGeoPositionInfo> m_fixes;
+};
+
+void tst_bench_RouteProgress::initTestCase()
+{
+    QFile file(QStringLiteral(":/nmealog.txt"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+
+    NmeaReader reader;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        QGeoPositionInfo info;
+        if (line.startsWith("$GPRMC") && reader.parse(line, &info))
+            m_fixes << info;
+    }
+    QVERIFY(m_fixes.size() > 100);
+}
+
+/*
+    The route runs through the recorded fixes, each gap split into
+    subdivisions edges, with a segment and maneuver every ten fixes.
+*/
+QGeoRoute tst_bench_RouteProgress::route(int subdivisions) const
+{
+    QGeoRouteSegment first;
+    QGeoRouteSegment previous;
+    QList<QGeoCoordinate> path;
+    for (int i = 0; i < m_fixes.size(); ++i) {
+        const QGeoCoordinate c = m_fixes.at(i).coordinate();
+        if (path.isEmpty() || path.last() != c) {
+            if (!path.isEmpty()) {
+                const QGeoCoordinate from = path.last();
+                for (int s = 1; s < subdivisions; ++s) {
+                    const double t = double(s) / subdivisions;
+                    path << QGeoCoordinate(from.latitude() + t * (c.latitude() - from.latitude()),
+                                           from.longitude() + t * (c.longitude() - from.longitude()));
+                }
+            }
+            path << c;
+        }
+
+        if ((i % 10 == 9 || i == m_fixes.size() - 1) && path.size() > 1) {
+            QGeoManeuver maneuver;
+            maneuver.setPosition(path.first());
+            maneuver.setInstructionText(QString::number(i));
+
+            QGeoRouteSegment segment;
+            segment.setPath(path);
+            segment.setTravelTime(10);
+            segment.setManeuver(maneuver);
+            if (!first.isValid())
+                first = segment;
+            else
+                previous.setNextRouteSegment(segment);
+            previous = segment;
+
+            path = QList<QGeoCoordinate>() << path.last();
+        }
+    }
+
+    QGeoRoute route;
+    route.setFirstRouteSegment(first);
+    return route;
+}
+
+void tst_bench_RouteProgress::updatePosition_data()
+{
+    QTest::addColumn<int>("subdivisions");
+    QTest::addColumn<int>("window");
+    QTest::addColumn<int>("offRouteEvery");
+
+    // With more edges between two fixes than the window holds, every fix falls back to the index
+    QTest::addRow("fixes only") << 1 << 32 << 0;
+    QTest::addRow("8 edges per fix") << 8 << 32 << 0;
+    QTest::addRow("64 edges per fix") << 64 << 128 << 0;
+    QTest::addRow("64 edges per fix, index") << 64 << 16 << 0;
+    QTest::addRow("8 edges per fix, off route every 10th") << 8 << 32 << 10;
+}
+
+void tst_bench_RouteProgress::updatePosition()
+{
+    QFETCH(int, subdivisions);
+    QFETCH(int, window);
+    QFETCH(int, offRouteEvery);
+
+    // A few meters of deterministic noise, and a 330 meter detour south on every offRouteEvery-th fix
+    QList<QGeoPositionInfo> fixes = m_fixes;
+    for (int i = 0; i < fixes.size(); ++i) {
+        QGeoCoordinate c = fixes.at(i).coordinate();
+        c.setLatitude(c.latitude() + ((i % 3) - 1) * 0.00003);
+        if (offRouteEvery && i % offRouteEvery == offRouteEvery - 1)
+            c.setLatitude(c.latitude() - 0.003);
+        fixes[i].setCoordinate(c);
+    }
+
+    QGeoRouteProgressTracker tracker;
+    tracker.setSearchWindow(window);
+    tracker.setRoute(route(subdivisions));
+
+    int offRoute = 0;
+    QBENCHMARK {
+        tracker.reset();
+        offRoute = 0;
+        foreach (const QGeoPositionInfo &fix, fixes) {
+            tracker.updatePosition(fix);
+            if (tracker.isOffRoute())
+                ++offRoute;
+        }
+    }
+
+    QVERIFY(!tracker.isOffRoute() || offRouteEvery);
+    QVERIFY(tracker.distanceRemaining() < 50.0);
+    if (offRouteEvery)
+        QCOMPARE(offRoute, fixes.size() / offRouteEvery);
+    else
+        QCOMPARE(offRoute, 0);
+}
+
+QTEST_MAIN(tst_bench_RouteProgress)
+
+#include "tst_bench_routeprogress.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_tilecacheburst
+
+SOURCES += tst_bench_tilecacheburst.cpp
+
+QT += location-private positioning-private testlib
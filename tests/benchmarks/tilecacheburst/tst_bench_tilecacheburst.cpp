@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/private/qgeofiletilecache_p.h>
+#include <QtLocation/private/qgeofiletilecachewriter_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+/* Exposes the protected setup and the writer of the cache */
+class BurstTileCache : public QGeoFileTileCache
+{
+public:
+    explicit BurstTileCache(const QString &directory) : QGeoFileTileCache(directory) {}
+    void initialize() { init(); }
+    void waitForWrites() { writer_->flush(); }
+};
+
+class tst_bench_TileCacheBurst : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void burstLatency_data();
+    void burstLatency();
+    void drainTime_data();
+    void drainTime();
+
+private:
+    qint64 runBurst(bool inlineWrites, int tileCount, int tileSize, bool evicting, qint64 *drained);
+};
+
+/* Returns the time spent inserting the tiles, and in drained the time until
+   they are all on disk. inlineWrites writes each tile where it arrives, as
+   the cache used to. */
+qint64 tst_bench_TileCacheBurst::runBurst(bool inlineWrites, int tileCount, int tileSize, bool evicting, qint64 *drained)
+{
+    QTemporaryDir directory;
+    BurstTileCache cache(directory.path());
+    if (evicting)
+        cache.setMaxDiskUsage(tileCount * tileSize / 4);
+    cache.initialize();
+
+    const QByteArray bytes(tileSize, 'x');
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < tileCount; ++i) {
+        const QGeoTileSpec spec(QStringLiteral("burst"), 1, 16, i % 256, i / 256);
+        if (inlineWrites) {
+            QFile file(QGeoFileTileCache::tileSpecToFilenameDefault(spec, QStringLiteral("png"), directory.path()));
+            file.open(QIODevice::WriteOnly);
+            file.write(bytes);
+            file.close();
+            cache.insert(spec, bytes, QStringLiteral("png"), QAbstractGeoTileCache::MemoryCache);
+        } else {
+            cache.insert(spec, bytes, QStringLiteral("png"));
+        }
+    }
+    const qint64 burst = timer.elapsed();
+    cache.waitForWrites();
+    *drained = timer.elapsed();
+    return burst;
+}
+
+void tst_bench_TileCacheBurst::burstLatency_data()
+{
+    QTest::addColumn<bool>("inlineWrites");
+    QTest::addColumn<int>("tileCount");
+    QTest::addColumn<int>("tileSize");
+    QTest::addColumn<bool>("evicting");
+
+    for (int tileSize : { 16 * 1024, 64 * 1024 }) {
+        const QByteArray suffix = ", 200 tiles of " + QByteArray::number(tileSize / 1024) + " KiB";
+        QTest::newRow("inline" + suffix) << true << 200 << tileSize << false;
+        QTest::newRow("writer" + suffix) << false << 200 << tileSize << false;
+        QTest::newRow("writer, evicting" + suffix) << false << 200 << tileSize << true;
+    }
+}
+
+/* How long the thread delivering the tiles is blocked by the burst */
+void tst_bench_TileCacheBurst::burstLatency()
+{
+    QFETCH(bool, inlineWrites);
+    QFETCH(int, tileCount);
+    QFETCH(int, tileSize);
+    QFETCH(bool, evicting);
+
+    qint64 drained = 0;
+    QTest::setBenchmarkResult(runBurst(inlineWrites, tileCount, tileSize, evicting, &drained),
+                              QTest::WalltimeMilliseconds);
+}
+
+void tst_bench_TileCacheBurst::drainTime_data()
+{
+    burstLatency_data();
+}
+
+/* How long until the burst is on disk */
+void tst_bench_TileCacheBurst::drainTime()
+{
+    QFETCH(bool, inlineWrites);
+    QFETCH(int, tileCount);
+    QFETCH(int, tileSize);
+    QFETCH(bool, evicting);
+
+    qint64 drained = 0;
+    runBurst(inlineWrites, tileCount, tileSize, evicting, &drained);
+    QTest::setBenchmarkResult(drained, QTest::WalltimeMilliseconds);
+}
+
+QTEST_MAIN(tst_bench_TileCacheBurst)
+
+#include "tst_bench_tilecacheburst.moc"
@@ -0,0 +1,5 @@
+TARGET = tst_bench_tilerequests
+
+SOURCES += tst_bench_tilerequests.cpp
+
+QT += location-private positioning-private testlib
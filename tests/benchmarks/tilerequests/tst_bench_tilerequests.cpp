@@ -0,0 +1,139 @@
+/****************************************************************************
+**
+** Copyright (C) 2017 The Qt Company Ltd.
+** Contact: https://www.qt.io/licensing/
+**
+** This file is part of the test suite of the Qt Toolkit.
+**
+** $QT_BEGIN_LICENSE:GPL-EXCEPT$
+** Commercial License Usage
+** Licensees holding valid commercial Qt licenses may use this file in
+** accordance with the commercial license agreement provided with the
+** Software or, alternatively, in accordance with the terms contained in
+** a written agreement between you and The Qt Company. For licensing terms
+** and conditions see https://www.qt.io/terms-conditions. For further
+** information use the contact form at https://www.qt.io/contact-us.
+**
+** GNU General Public License Usage
+** Alternatively, this file may be used under the terms of the GNU
+** General Public License version 3 as published by the Free Software
+** Foundation with exceptions as appearing in the file LICENSE.GPL3-EXCEPT
+** included in the packaging of this file. Please review the following
+** information to ensure the GNU General Public License requirements will
+** be met: https://www.gnu.org/licenses/gpl-3.0.html.
+**
+** $QT_END_LICENSE$
+**
+****************************************************************************/
+
+#include <QtLocation/private/qgeotiledmappingmanagerengine_p.h>
+#include <QtLocation/private/qgeotilespec_p.h>
+#include <QtTest/QtTest>
+
+QT_USE_NAMESPACE
+
+typedef QPair<QSet<QGeoTileSpec>, QSet<QGeoTileSpec> > TileDelta; // added, removed
+
+class tst_bench_TileRequests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void updateTileRequests_data();
+    void updateTileRequests();
+    void releaseMap_data();
+    void releaseMap();
+
+private:
+    static QSet<QGeoTileSpec> window(int x, int y);
+    static QVector<TileDelta> panCycle(int x, int y, int dx, int dy, int steps);
+};
+
+/* The tiles of a 1024x768 view with a border of one tile, at zoom 14 */
+QSet<QGeoTileSpec> tst_bench_TileRequests::window(int x, int y)
+{
+    QSet<QGeoTileSpec> tiles;
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 5; ++j)
+            tiles.insert(QGeoTileSpec(QStringLiteral("bench"), 1, 14, x + i, y + j));
+    }
+    return tiles;
+}
+
+/* Pans away by steps tiles and back, so that the cycle can be repeated */
+QVector<TileDelta> tst_bench_TileRequests::panCycle(int x, int y, int dx, int dy, int steps)
+{
+    QVector<TileDelta> deltas;
+    QSet<QGeoTileSpec> current = window(x, y);
+    for (int step = 1; step <= 2 * steps; ++step) {
+        const int offset = step <= steps ? step : 2 * steps - step;
+        const QSet<QGeoTileSpec> next = window(x + offset * dx, y + offset * dy);
+        deltas.append(TileDelta(next - current, current - next));
+        current = next;
+    }
+    return deltas;
+}
+
+/* The maps are only used as keys by the engine, so fake ones do */
+static QGeoTiledMap *fakeMap(int index)
+{
+    return reinterpret_cast<QGeoTiledMap *>(quintptr(index + 1) * 64);
+}
+
+void tst_bench_TileRequests::updateTileRequests_data()
+{
+    QTest::addColumn<int>("mapCount");
+
+    for (int mapCount : { 1, 2, 4, 8 })
+        QTest::newRow(QByteArray::number(mapCount) + " maps") << mapCount;
+}
+
+/* All the maps pan at once, over partly overlapping areas */
+void tst_bench_TileRequests::updateTileRequests()
+{
+    QFETCH(int, mapCount);
+
+    QGeoTiledMappingManagerEngine engine;
+    QVector<QVector<TileDelta> > cycles;
+    for (int m = 0; m < mapCount; ++m) {
+        const int x = 8000 + (m % 4) * 2;
+        const int y = 5000 + (m / 4) * 2;
+        engine.updateTileRequests(fakeMap(m), window(x, y), QSet<QGeoTileSpec>());
+        cycles.append(panCycle(x, y, (m % 2) ? -1 : 1, (m % 3) - 1, 16));
+    }
+
+    QBENCHMARK {
+        for (int step = 0; step < cycles.first().size(); ++step) {
+            for (int m = 0; m < mapCount; ++m) {
+                const TileDelta &delta = cycles.at(m).at(step);
+                engine.updateTileRequests(fakeMap(m), delta.first, delta.second);
+            }
+        }
+    }
+
+    for (int m = 0; m < mapCount; ++m)
+        engine.releaseMap(fakeMap(m));
+}
+
+void tst_bench_TileRequests::releaseMap_data()
+{
+    updateTileRequests_data();
+}
+
+/* Releasing a map while the others keep their tiles requested */
+void tst_bench_TileRequests::releaseMap()
+{
+    QFETCH(int, mapCount);
+
+    QGeoTiledMappingManagerEngine engine;
+    QBENCHMARK {
+        for (int m = 0; m < mapCount; ++m)
+            engine.updateTileRequests(fakeMap(m), window(8000 + m * 3, 5000), QSet<QGeoTileSpec>());
+        for (int m = 0; m < mapCount; ++m)
+            engine.releaseMap(fakeMap(m));
+    }
+}
+
+QTEST_MAIN(tst_bench_TileRequests)
+
+#include "tst_bench_tilerequests.moc"